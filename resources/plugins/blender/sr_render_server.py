@@ -0,0 +1,53 @@
+# sr_render_server.py — Persistent render bootstrap for Blender
+# Launched by sr-agent via: blender -b scene.blend ... --python sr_render_server.py
+#
+# Keeps the scene loaded and renders one chunk per request read from stdin:
+#   {"cmd": "render", "frame_start": 1, "frame_end": 10}
+#   {"cmd": "quit"}
+# and answers each render with "SR_CHUNK_DONE ok" or "SR_CHUNK_DONE error <msg>".
+
+import bpy
+import json
+import sys
+import traceback
+
+
+def reply(status):
+    print("SR_CHUNK_DONE " + status, flush=True)
+
+
+def render_chunk(frame_start, frame_end):
+    scene = bpy.context.scene
+    scene.frame_start = frame_start
+    scene.frame_end = frame_end
+    bpy.ops.render.render(animation=True)
+
+
+def main():
+    for line in sys.stdin:
+        line = line.strip()
+        if not line:
+            continue
+        try:
+            req = json.loads(line)
+        except ValueError:
+            reply("error bad request: " + line[:200])
+            continue
+
+        cmd = req.get("cmd")
+        if cmd == "quit":
+            break
+        if cmd != "render":
+            reply("error unknown command: " + str(cmd))
+            continue
+
+        try:
+            render_chunk(int(req["frame_start"]), int(req["frame_end"]))
+            sys.stdout.flush()
+            reply("ok")
+        except Exception as e:
+            traceback.print_exc()
+            reply("error " + " ".join(str(e).split()))
+
+
+main()
@@ -6,7 +6,9 @@ use std::thread::{self, JoinHandle};
 use std::time::{Duration, Instant};
 
 use crate::messages::TaskMessage;
-use crate::parser::{CompletionParser, OutputParser, ProgressParser};
+use crate::parser::LineParser;
+use crate::placement;
+use crate::server::{self, RenderServer};
 
 pub enum RenderEvent {
     Started,
@@ -17,6 +19,7 @@ pub enum RenderEvent {
         elapsed_ms: u64,
         exit_code: i32,
         output_file: Option<String>,
+        peak_memory_mb: Option<u64>,
     },
     Failed {
         exit_code: i32,
@@ -28,13 +31,16 @@ pub struct RenderExecutor {
     event_rx: mpsc::Receiver<RenderEvent>,
     abort_flag: Arc<AtomicBool>,
     worker: Option<JoinHandle<()>>,
+    server_rx: Option<mpsc::Receiver<RenderServer>>,
     pub job_id: String,
     pub frame_start: u32,
     pub frame_end: u32,
+    pub trace_id: Option<String>,
+    pub spawn_ms: u64,
 }
 
-const STDOUT_FLUSH_LINES: usize = 50;
-const STDOUT_FLUSH_INTERVAL: Duration = Duration::from_secs(5);
+pub(crate) const STDOUT_FLUSH_LINES: usize = 50;
+pub(crate) const STDOUT_FLUSH_INTERVAL: Duration = Duration::from_secs(5);
 
 impl RenderExecutor {
     pub fn start(task: TaskMessage) -> Result<Self, String> {
@@ -57,28 +63,28 @@ impl RenderExecutor {
             cmd.env(k, v);
         }
 
+        let pin = task.placement.as_ref().and_then(|p| placement::configure(&mut cmd, p));
+
         let mut child = cmd
             .spawn()
             .map_err(|e| format!("Failed to spawn process: {}", e))?;
+        if let Some(mask) = pin {
+            placement::apply(&child, mask);
+        }
 
         let (event_tx, event_rx) = mpsc::channel::<RenderEvent>();
         let abort_flag = Arc::new(AtomicBool::new(false));
         let abort_clone = abort_flag.clone();
 
-        // Build completion parser early — shared between stdout loop and stderr thread
-        let completion_parser = Arc::new(
-            task.progress
-                .as_ref()
-                .and_then(|spec| spec.completion_pattern.as_ref())
-                .and_then(|def| CompletionParser::new(def)),
-        );
+        // Shared between the stdout loop and the stderr thread
+        let parser = Arc::new(LineParser::new(&task));
         let completion_counter = Arc::new(AtomicU32::new(0));
 
         // Take stderr handle and read on a mini-thread
         let stderr_lines: Arc<Mutex<Vec<String>>> = Arc::new(Mutex::new(Vec::new()));
         let stderr_clone = stderr_lines.clone();
         if let Some(stderr) = child.stderr.take() {
-            let cp = completion_parser.clone();
+            let cp = parser.clone();
             let cc = completion_counter.clone();
             let tx = event_tx.clone();
             let fs = frame_start;
@@ -89,13 +95,11 @@ impl RenderExecutor {
                     match line {
                         Ok(l) => {
                             // Check completion pattern on stderr lines
-                            if let Some(ref parser) = *cp {
-                                if parser.matches(&l) {
-                                    let count = cc.fetch_add(1, Ordering::SeqCst);
-                                    let frame = fs + count;
-                                    if frame <= fe {
-                                        let _ = tx.send(RenderEvent::FrameCompleted { frame });
-                                    }
+                            if cp.counts_frames() && cp.scan(&l, false).frame_completed {
+                                let count = cc.fetch_add(1, Ordering::SeqCst);
+                                let frame = fs + count;
+                                if frame <= fe {
+                                    let _ = tx.send(RenderEvent::FrameCompleted { frame });
                                 }
                             }
                             if let Ok(mut buf) = stderr_clone.lock() {
@@ -108,17 +112,6 @@ impl RenderExecutor {
             });
         }
 
-        // Build other parsers
-        let progress_parser = task
-            .progress
-            .as_ref()
-            .map(|spec| ProgressParser::new(spec));
-
-        let output_parser = task
-            .output_detection
-            .as_ref()
-            .and_then(|cfg| OutputParser::new(cfg));
-
         let timeout = task.timeout_seconds.map(Duration::from_secs);
 
         let worker = thread::spawn(move || {
@@ -126,9 +119,7 @@ impl RenderExecutor {
                 child,
                 event_tx,
                 abort_clone,
-                progress_parser,
-                output_parser,
-                completion_parser,
+                parser,
                 completion_counter,
                 stderr_lines,
                 timeout,
@@ -142,12 +133,55 @@ impl RenderExecutor {
             event_rx,
             abort_flag,
             worker: Some(worker),
+            server_rx: None,
             job_id: task.job_id,
             frame_start: task.frame_start,
             frame_end: task.frame_end,
+            trace_id: task.trace_id,
+            spawn_ms: 0,
         })
     }
 
+    /// Render the task's chunk on an already running persistent process.
+    /// The server comes back through take_server() if it is fit for reuse.
+    pub fn start_persistent(task: TaskMessage, mut server: RenderServer) -> Self {
+        let (event_tx, event_rx) = mpsc::channel::<RenderEvent>();
+        let (server_tx, server_rx) = mpsc::channel::<RenderServer>();
+        let abort_flag = Arc::new(AtomicBool::new(false));
+        let abort_clone = abort_flag.clone();
+
+        let job_id = task.job_id.clone();
+        let frame_start = task.frame_start;
+        let frame_end = task.frame_end;
+        let trace_id = task.trace_id.clone();
+
+        let worker = thread::spawn(move || {
+            if server.run_chunk(&task, &event_tx, &abort_clone) {
+                let _ = server_tx.send(server);
+            }
+        });
+
+        Self {
+            event_rx,
+            abort_flag,
+            worker: Some(worker),
+            server_rx: Some(server_rx),
+            job_id,
+            frame_start,
+            frame_end,
+            trace_id,
+            spawn_ms: 0,
+        }
+    }
+
+    /// The persistent process, once the chunk is done and if it survived.
+    pub fn take_server(&mut self) -> Option<RenderServer> {
+        if let Some(w) = self.worker.take() {
+            let _ = w.join();
+        }
+        self.server_rx.take()?.try_recv().ok()
+    }
+
     /// Non-blocking poll for render events.
     pub fn poll_events(&self) -> Vec<RenderEvent> {
         let mut events = Vec::new();
@@ -175,13 +209,11 @@ fn worker_func(
     mut child: Child,
     tx: mpsc::Sender<RenderEvent>,
     abort_flag: Arc<AtomicBool>,
-    progress_parser: Option<ProgressParser>,
-    output_parser: Option<OutputParser>,
-    completion_parser: Arc<Option<CompletionParser>>,
+    parser: Arc<LineParser>,
     completion_counter: Arc<AtomicU32>,
     stderr_lines: Arc<Mutex<Vec<String>>>,
     timeout: Option<Duration>,
-    _job_id: String,
+    job_id: String,
     frame_start: u32,
     frame_end: u32,
 ) {
@@ -203,6 +235,7 @@ fn worker_func(
     let mut stdout_buf: Vec<String> = Vec::new();
     let mut last_flush = Instant::now();
     let mut last_output_file: Option<String> = None;
+    let mut peak_mb: Option<u64> = None;
 
     for line in reader.lines() {
         // Check abort
@@ -236,31 +269,23 @@ fn worker_func(
             Err(_) => break,
         };
 
-        // Parse progress
-        if let Some(ref parser) = progress_parser {
-            if let Some(pct) = parser.parse_line(&line) {
-                let _ = tx.send(RenderEvent::Progress {
-                    pct,
-                    elapsed_ms: start_time.elapsed().as_millis() as u64,
-                });
-            }
+        // Progress, output file and per-frame completion (stdout — stderr
+        // is checked by its own thread)
+        let hits = parser.scan(&line, true);
+        if let Some(pct) = hits.progress {
+            let _ = tx.send(RenderEvent::Progress {
+                pct,
+                elapsed_ms: start_time.elapsed().as_millis() as u64,
+            });
         }
-
-        // Parse output file
-        if let Some(ref parser) = output_parser {
-            if let Some(path) = parser.parse_line(&line) {
-                last_output_file = Some(path);
-            }
+        if let Some(path) = hits.output_file {
+            last_output_file = Some(path);
         }
-
-        // Parse per-frame completion (stdout — stderr is checked by its own thread)
-        if let Some(ref parser) = *completion_parser {
-            if parser.matches(&line) {
-                let count = completion_counter.fetch_add(1, Ordering::SeqCst);
-                let frame = frame_start + count;
-                if frame <= frame_end {
-                    let _ = tx.send(RenderEvent::FrameCompleted { frame });
-                }
+        if hits.frame_completed {
+            let count = completion_counter.fetch_add(1, Ordering::SeqCst);
+            let frame = frame_start + count;
+            if frame <= frame_end {
+                let _ = tx.send(RenderEvent::FrameCompleted { frame });
             }
         }
 
@@ -272,11 +297,14 @@ fn worker_func(
         {
             flush_stdout(&tx, &mut stdout_buf, &stderr_lines);
             last_flush = Instant::now();
+            peak_mb = peak_mb.max(server::peak_mb(&child));
         }
     }
 
     // Flush remaining stdout + stderr
     flush_stdout(&tx, &mut stdout_buf, &stderr_lines);
+    parser.log_throughput(&job_id, start_time.elapsed());
+    peak_mb = peak_mb.max(server::peak_mb(&child));
 
     // Wait for process to exit
     let status = match child.wait() {
@@ -292,12 +320,15 @@ fn worker_func(
 
     let elapsed_ms = start_time.elapsed().as_millis() as u64;
     let exit_code = status.code().unwrap_or(-1);
+    // Windows still answers for the exited process; /proc is gone once reaped
+    peak_mb = peak_mb.max(server::peak_mb(&child));
 
     if status.success() {
         let _ = tx.send(RenderEvent::Completed {
             elapsed_ms,
             exit_code,
             output_file: last_output_file,
+            peak_memory_mb: peak_mb,
         });
     } else {
         let _ = tx.send(RenderEvent::Failed {
@@ -321,6 +352,10 @@ fn flush_stdout(
         }
     }
 
+    flush_lines(tx, stdout_buf);
+}
+
+pub(crate) fn flush_lines(tx: &mpsc::Sender<RenderEvent>, stdout_buf: &mut Vec<String>) {
     if stdout_buf.is_empty() {
         return;
     }
@@ -2,6 +2,8 @@ mod executor;
 mod ipc;
 mod messages;
 mod parser;
+mod placement;
+mod server;
 mod watchdog;
 
 use clap::Parser;
@@ -10,9 +12,13 @@ use messages::{
     AckMessage, AgentToMonitor, CompletedMessage, FailedMessage, FrameCompletedMessage,
     MonitorToAgent, ProgressMessage, StatusMessage, StdoutMessage,
 };
+use server::RenderServer;
 use std::process;
 use std::thread;
-use std::time::Duration;
+use std::time::{Duration, Instant};
+
+/// A persistent render process left without work this long is shut down.
+const SERVER_IDLE_TIMEOUT: Duration = Duration::from_secs(300);
 
 #[derive(Parser)]
 #[command(name = "sr-agent", about = "SmallRender headless render agent", version)]
@@ -94,6 +100,7 @@ fn main() {
     log::info!("Sent initial status (pid={})", process::id());
 
     let mut active_render: Option<RenderExecutor> = None;
+    let mut idle_server: Option<RenderServer> = None;
 
     loop {
         if let Some(ref executor) = active_render {
@@ -116,6 +123,8 @@ fn main() {
                                 job_id: executor.job_id.clone(),
                                 frame_start: executor.frame_start,
                                 frame_end: executor.frame_end,
+                                trace_id: executor.trace_id.clone(),
+                                spawn_ms: executor.spawn_ms,
                             }),
                         );
                     }
@@ -139,6 +148,7 @@ fn main() {
                                 frame_end: executor.frame_end,
                                 progress_pct: pct,
                                 elapsed_ms,
+                                trace_id: executor.trace_id.clone(),
                             }),
                         );
                     }
@@ -155,14 +165,16 @@ fn main() {
                         elapsed_ms,
                         exit_code,
                         output_file,
+                        peak_memory_mb,
                     } => {
                         log::info!(
-                            "Render completed: job={} chunk={}-{} exit_code={} elapsed={}ms",
+                            "Render completed: job={} chunk={}-{} exit_code={} elapsed={}ms peak={}MB",
                             executor.job_id,
                             executor.frame_start,
                             executor.frame_end,
                             exit_code,
                             elapsed_ms,
+                            peak_memory_mb.map_or_else(|| "?".to_string(), |mb| mb.to_string()),
                         );
                         let _ = send_message(
                             &mut pipe,
@@ -173,6 +185,8 @@ fn main() {
                                 elapsed_ms,
                                 exit_code,
                                 output_file,
+                                peak_memory_mb,
+                                trace_id: executor.trace_id.clone(),
                             }),
                         );
                         done = true;
@@ -194,6 +208,7 @@ fn main() {
                                 frame_end: executor.frame_end,
                                 exit_code,
                                 error,
+                                trace_id: executor.trace_id.clone(),
                             }),
                         );
                         done = true;
@@ -202,7 +217,11 @@ fn main() {
             }
 
             if done {
-                active_render = None;
+                idle_server = active_render.take().and_then(|mut e| e.take_server());
+                if let Some(reason) = idle_server.as_mut().and_then(|s| s.recycle_reason()) {
+                    log::info!("Recycling render server: {}", reason);
+                    idle_server = None;
+                }
                 let _ = send_message(
                     &mut pipe,
                     &AgentToMonitor::Status(StatusMessage {
@@ -257,6 +276,23 @@ fn main() {
             thread::sleep(Duration::from_millis(100));
         } else {
             // === IDLE MODE === (blocking read)
+            if let Some(ref mut srv) = idle_server {
+                // Poll instead, so a lingering render server can be retired
+                if pipe.peek_available().unwrap_or(0) == 0 {
+                    let reason = if srv.idle_since.elapsed() >= SERVER_IDLE_TIMEOUT {
+                        Some("idle timeout".to_string())
+                    } else {
+                        srv.recycle_reason()
+                    };
+                    if let Some(reason) = reason {
+                        log::info!("Stopping render server: {}", reason);
+                        idle_server = None;
+                    }
+                    thread::sleep(Duration::from_millis(100));
+                    continue;
+                }
+            }
+
             let payload = match ipc::read_message(&mut pipe) {
                 Ok(data) => data,
                 Err(e) => {
@@ -287,14 +323,35 @@ fn main() {
                 }
                 MonitorToAgent::Task(task) => {
                     log::info!(
-                        "Received task: job={} chunk={}-{} cmd={}",
+                        "Received task: job={} chunk={}-{} cmd={} trace={}",
                         task.job_id,
                         task.frame_start,
                         task.frame_end,
                         task.command.executable,
+                        task.trace_id.as_deref().unwrap_or("-"),
                     );
-                    match RenderExecutor::start(task) {
-                        Ok(executor) => {
+                    let received = Instant::now();
+                    let started = if task.persistent.is_some() {
+                        // Same job reuses the live process; anything else gets a fresh one
+                        let server = match idle_server.take() {
+                            Some(srv) if srv.accepts(&task) => Ok(srv),
+                            previous => {
+                                if let Some(old) = previous {
+                                    log::info!("Recycling render server: job changed (was {})", old.key);
+                                }
+                                RenderServer::spawn(&task)
+                            }
+                        };
+                        server.map(|srv| RenderExecutor::start_persistent(task, srv))
+                    } else {
+                        if idle_server.take().is_some() {
+                            log::info!("Stopping render server: next task is not persistent");
+                        }
+                        RenderExecutor::start(task)
+                    };
+                    match started {
+                        Ok(mut executor) => {
+                            executor.spawn_ms = received.elapsed().as_millis() as u64;
                             let _ = send_message(
                                 &mut pipe,
                                 &AgentToMonitor::Status(StatusMessage {
@@ -17,6 +17,9 @@ pub struct TaskMessage {
     pub job_id: String,
     pub frame_start: u32,
     pub frame_end: u32,
+    /// The coordinator's chunk trace id; echoed on every reply about this chunk.
+    #[serde(default)]
+    pub trace_id: Option<String>,
     pub command: CommandSpec,
     #[serde(default)]
     pub working_dir: Option<String>,
@@ -25,6 +28,32 @@ pub struct TaskMessage {
     pub progress: Option<ProgressSpec>,
     pub output_detection: Option<OutputConfig>,
     pub timeout_seconds: Option<u64>,
+    #[serde(default)]
+    pub persistent: Option<PersistentSpec>,
+    #[serde(default)]
+    pub placement: Option<PlacementSpec>,
+}
+
+/// Priority class and CPU placement for the render process (see placement.rs).
+#[derive(Debug, Default, Deserialize)]
+pub struct PlacementSpec {
+    #[serde(default)]
+    pub priority: Option<String>,    // idle | below_normal | normal | above_normal | high
+    #[serde(default)]
+    pub cpu_set: Option<String>,     // "0-15,32-47"
+    #[serde(default)]
+    pub numa_node: Option<i32>,
+}
+
+/// Keep one render process alive across chunks. `command` then holds the
+/// launch args; each chunk is sent to the process on stdin.
+#[derive(Debug, Deserialize)]
+pub struct PersistentSpec {
+    pub key: String,                 // a live process is reused only for the same key
+    #[serde(default)]
+    pub max_chunks: u32,             // recycle after this many chunks (0 = no limit)
+    #[serde(default)]
+    pub max_memory_mb: u64,          // recycle once resident memory passes this (0 = no limit)
 }
 
 #[derive(Debug, Deserialize)]
@@ -113,6 +142,9 @@ pub struct AckMessage {
     pub job_id: String,
     pub frame_start: u32,
     pub frame_end: u32,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub trace_id: Option<String>,
+    pub spawn_ms: u64,               // task received -> render process started (or server reused)
 }
 
 #[derive(Debug, Serialize)]
@@ -122,6 +154,8 @@ pub struct ProgressMessage {
     pub frame_end: u32,
     pub progress_pct: f32,
     pub elapsed_ms: u64,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub trace_id: Option<String>,
 }
 
 #[derive(Debug, Serialize)]
@@ -140,6 +174,10 @@ pub struct CompletedMessage {
     pub elapsed_ms: u64,
     pub exit_code: i32,
     pub output_file: Option<String>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub peak_memory_mb: Option<u64>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub trace_id: Option<String>,
 }
 
 #[derive(Debug, Serialize)]
@@ -149,6 +187,8 @@ pub struct FailedMessage {
     pub frame_end: u32,
     pub exit_code: i32,
     pub error: String,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub trace_id: Option<String>,
 }
 
 #[derive(Debug, Serialize)]
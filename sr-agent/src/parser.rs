@@ -1,6 +1,11 @@
-use regex::Regex;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Duration;
 
-use crate::messages::{CompletionPatternDef, OutputConfig, ProgressSpec};
+use aho_corasick::AhoCorasick;
+use regex::{Regex, RegexSet};
+use regex_syntax::hir::literal::{ExtractKind, Extractor};
+
+use crate::messages::{CompletionPatternDef, OutputConfig, ProgressPatternDef, TaskMessage};
 
 enum CompiledPattern {
     Fraction {
@@ -14,122 +19,235 @@ enum CompiledPattern {
     },
 }
 
-pub struct ProgressParser {
-    patterns: Vec<CompiledPattern>,
+impl CompiledPattern {
+    fn new(def: &ProgressPatternDef) -> Option<Self> {
+        let regex = compile(&def.regex, "progress")?;
+        match def.pattern_type.as_str() {
+            "fraction" => Some(CompiledPattern::Fraction {
+                regex,
+                num_group: def.numerator_group as usize,
+                den_group: def.denominator_group as usize,
+            }),
+            "percentage" => Some(CompiledPattern::Percentage {
+                regex,
+                group: def.group as usize,
+            }),
+            other => {
+                log::warn!("Unknown progress pattern type: '{}'", other);
+                None
+            }
+        }
+    }
+
+    fn regex(&self) -> &Regex {
+        match self {
+            CompiledPattern::Fraction { regex, .. } | CompiledPattern::Percentage { regex, .. } => regex,
+        }
+    }
+
+    /// 0.0-100.0 if the line carries a usable value.
+    fn parse(&self, line: &str) -> Option<f32> {
+        match self {
+            CompiledPattern::Fraction {
+                regex,
+                num_group,
+                den_group,
+            } => {
+                let caps = regex.captures(line)?;
+                let num: f32 = caps.get(*num_group)?.as_str().parse().ok()?;
+                let den: f32 = caps.get(*den_group)?.as_str().parse().ok()?;
+                (den > 0.0).then(|| (num / den) * 100.0)
+            }
+            CompiledPattern::Percentage { regex, group } => {
+                let caps = regex.captures(line)?;
+                caps.get(*group)?.as_str().parse().ok()
+            }
+        }
+    }
+}
+
+enum Slot {
+    Progress(CompiledPattern),
+    Output { regex: Regex, group: usize },
+    Completion(Regex),
 }
 
-impl ProgressParser {
-    pub fn new(spec: &ProgressSpec) -> Self {
-        let mut patterns = Vec::new();
-        for def in &spec.patterns {
-            let regex = match Regex::new(&def.regex) {
-                Ok(r) => r,
+impl Slot {
+    fn regex(&self) -> &Regex {
+        match self {
+            Slot::Progress(p) => p.regex(),
+            Slot::Output { regex, .. } | Slot::Completion(regex) => regex,
+        }
+    }
+}
+
+/// What one line of render output told us.
+#[derive(Default)]
+pub struct LineHits {
+    pub progress: Option<f32>,
+    pub output_file: Option<String>,
+    pub frame_completed: bool,
+}
+
+/// All of a task's stdout patterns (progress, output file, per-frame
+/// completion) behind one RegexSet. Most lines match nothing: when every
+/// pattern has a literal prefix or suffix, one Aho-Corasick scan for those
+/// rejects them, and the set runs only on lines containing one. The capture
+/// regexes run only for the patterns the set reports.
+pub struct LineParser {
+    slots: Vec<Slot>,
+    literals: Option<AhoCorasick>,  // None: some pattern has no required literal
+    set: Option<RegexSet>,          // None: too large to combine, each slot is tried in turn
+    lines: AtomicU64,
+    candidates: AtomicU64,          // lines that got past the literal scan
+}
+
+impl LineParser {
+    pub fn new(task: &TaskMessage) -> Self {
+        let mut slots = Vec::new();
+        if let Some(ref spec) = task.progress {
+            slots.extend(spec.patterns.iter().filter_map(CompiledPattern::new).map(Slot::Progress));
+        }
+        if let Some(ref cfg) = task.output_detection {
+            if let Some(slot) = output_slot(cfg) {
+                slots.push(slot);
+            }
+        }
+        if let Some(def) = task.progress.as_ref().and_then(|s| s.completion_pattern.as_ref()) {
+            if let Some(slot) = completion_slot(def) {
+                slots.push(slot);
+            }
+        }
+
+        let set = if slots.is_empty() {
+            None
+        } else {
+            match RegexSet::new(slots.iter().map(|s| s.regex().as_str())) {
+                Ok(set) => Some(set),
                 Err(e) => {
-                    log::warn!("Invalid progress regex '{}': {}", def.regex, e);
-                    continue;
-                }
-            };
-            match def.pattern_type.as_str() {
-                "fraction" => {
-                    patterns.push(CompiledPattern::Fraction {
-                        regex,
-                        num_group: def.numerator_group as usize,
-                        den_group: def.denominator_group as usize,
-                    });
-                }
-                "percentage" => {
-                    patterns.push(CompiledPattern::Percentage {
-                        regex,
-                        group: def.group as usize,
-                    });
-                }
-                other => {
-                    log::warn!("Unknown progress pattern type: '{}'", other);
+                    log::warn!("Output patterns not combined, matching one by one: {}", e);
+                    None
                 }
             }
+        };
+        let literals = slots
+            .iter()
+            .map(|s| required_literals(s.regex().as_str()))
+            .collect::<Option<Vec<_>>>()
+            .and_then(|lits| AhoCorasick::new(lits.concat()).ok());
+        Self {
+            slots,
+            literals,
+            set,
+            lines: AtomicU64::new(0),
+            candidates: AtomicU64::new(0),
         }
-        Self { patterns }
     }
 
-    /// Parse a line of stdout for progress. Returns 0.0-100.0 on match.
-    pub fn parse_line(&self, line: &str) -> Option<f32> {
-        for pat in &self.patterns {
-            match pat {
-                CompiledPattern::Fraction {
-                    regex,
-                    num_group,
-                    den_group,
-                } => {
-                    if let Some(caps) = regex.captures(line) {
-                        let num: f32 = caps.get(*num_group)?.as_str().parse().ok()?;
-                        let den: f32 = caps.get(*den_group)?.as_str().parse().ok()?;
-                        if den > 0.0 {
-                            return Some((num / den) * 100.0);
-                        }
-                    }
+    /// Whether a completion pattern is configured (stderr needs no other parsing).
+    pub fn counts_frames(&self) -> bool {
+        self.slots.iter().any(|s| matches!(s, Slot::Completion(_)))
+    }
+
+    /// Scan one line. Progress and output paths are only read from stdout;
+    /// frame completion is counted on either stream.
+    pub fn scan(&self, line: &str, stdout: bool) -> LineHits {
+        self.lines.fetch_add(1, Ordering::Relaxed);
+        let mut hits = LineHits::default();
+        if self.slots.is_empty() {
+            return hits;
+        }
+        if let Some(ref literals) = self.literals {
+            if !literals.is_match(line) {
+                return hits;
+            }
+        }
+        self.candidates.fetch_add(1, Ordering::Relaxed);
+
+        // `known`: the set already matched this slot's regex
+        let mut visit = |slot: &Slot, known: bool| match slot {
+            Slot::Progress(p) if stdout && hits.progress.is_none() => hits.progress = p.parse(line),
+            Slot::Output { regex, group } if stdout => {
+                if let Some(m) = regex.captures(line).and_then(|c| c.get(*group)) {
+                    hits.output_file = Some(m.as_str().to_string());
                 }
-                CompiledPattern::Percentage { regex, group } => {
-                    if let Some(caps) = regex.captures(line) {
-                        let pct: f32 = caps.get(*group)?.as_str().parse().ok()?;
-                        return Some(pct);
+            }
+            Slot::Completion(regex) => hits.frame_completed |= known || regex.is_match(line),
+            _ => {}
+        };
+
+        match self.set {
+            Some(ref set) => {
+                // is_match stops at the first hit; matches() only runs when there is one
+                if set.is_match(line) {
+                    for i in set.matches(line).iter() {
+                        visit(&self.slots[i], true);
                     }
                 }
             }
+            None => self.slots.iter().for_each(|s| visit(s, false)),
         }
-        None
+        hits
     }
-}
-
-pub struct OutputParser {
-    regex: Regex,
-    group: usize,
-}
 
-impl OutputParser {
-    pub fn new(config: &OutputConfig) -> Option<Self> {
-        let pattern = config.regex.as_ref()?;
-        if pattern.is_empty() {
-            return None;
-        }
-        let regex = match Regex::new(pattern) {
-            Ok(r) => r,
-            Err(e) => {
-                log::warn!("Invalid output regex '{}': {}", pattern, e);
-                return None;
-            }
-        };
-        Some(Self {
-            regex,
-            group: config.capture_group as usize,
-        })
+    pub fn lines_parsed(&self) -> u64 {
+        self.lines.load(Ordering::Relaxed)
     }
 
-    pub fn parse_line(&self, line: &str) -> Option<String> {
-        let caps = self.regex.captures(line)?;
-        Some(caps.get(self.group)?.as_str().to_string())
+    pub fn log_throughput(&self, job_id: &str, elapsed: Duration) {
+        let lines = self.lines_parsed();
+        let secs = elapsed.as_secs_f64();
+        if lines > 0 && secs > 0.0 {
+            log::info!(
+                "Parsed {} output lines for job={} in {:.1}s ({:.0} lines/s, {} past the literal scan)",
+                lines,
+                job_id,
+                secs,
+                lines as f64 / secs,
+                self.candidates.load(Ordering::Relaxed)
+            );
+        }
     }
 }
 
-pub struct CompletionParser {
-    regex: Regex,
+/// Literals one of which every match of `pattern` starts (or ends) with —
+/// whichever side gives the longer shortest literal. None if a match can
+/// contain no fixed text, e.g. `\d+`.
+fn required_literals(pattern: &str) -> Option<Vec<Vec<u8>>> {
+    let hir = regex_syntax::Parser::new().parse(pattern).ok()?;
+    [ExtractKind::Prefix, ExtractKind::Suffix]
+        .into_iter()
+        .filter_map(|kind| {
+            let seq = Extractor::new().kind(kind).extract(&hir);
+            let lits = seq.literals()?;
+            let shortest = lits.iter().map(|l| l.as_bytes().len()).min()?;
+            (shortest > 0).then(|| (shortest, lits.iter().map(|l| l.as_bytes().to_vec()).collect()))
+        })
+        .max_by_key(|(shortest, _)| *shortest)
+        .map(|(_, lits)| lits)
 }
 
-impl CompletionParser {
-    pub fn new(def: &CompletionPatternDef) -> Option<Self> {
-        if def.regex.is_empty() {
-            return None;
+fn compile(pattern: &str, what: &str) -> Option<Regex> {
+    match Regex::new(pattern) {
+        Ok(r) => Some(r),
+        Err(e) => {
+            log::warn!("Invalid {} regex '{}': {}", what, pattern, e);
+            None
         }
-        let regex = match Regex::new(&def.regex) {
-            Ok(r) => r,
-            Err(e) => {
-                log::warn!("Invalid completion regex '{}': {}", def.regex, e);
-                return None;
-            }
-        };
-        Some(Self { regex })
     }
+}
+
+fn output_slot(config: &OutputConfig) -> Option<Slot> {
+    let pattern = config.regex.as_ref().filter(|p| !p.is_empty())?;
+    Some(Slot::Output {
+        regex: compile(pattern, "output")?,
+        group: config.capture_group as usize,
+    })
+}
 
-    pub fn matches(&self, line: &str) -> bool {
-        self.regex.is_match(line)
+fn completion_slot(def: &CompletionPatternDef) -> Option<Slot> {
+    if def.regex.is_empty() {
+        return None;
     }
+    Some(Slot::Completion(compile(&def.regex, "completion")?))
 }
@@ -0,0 +1,253 @@
+use std::process::{Child, Command};
+
+use crate::messages::PlacementSpec;
+
+// Where a render process runs: priority class, CPU set and NUMA node.
+//
+// The agent is already restricted to its slot's CPU set (the monitor applies
+// the slot pin when it spawns us), so a requested set is intersected with our
+// own affinity; if nothing is left, the render just inherits the slot's.
+//
+// Windows: the process is created suspended, pinned, then resumed, so neither
+// it nor anything it launches ever runs outside the set.
+
+/// Prepare `cmd` before spawn. Returns the affinity still to be applied by
+/// `apply` once the child exists (Windows only).
+pub fn configure(cmd: &mut Command, spec: &PlacementSpec) -> Option<usize> {
+    imp::configure(cmd, spec)
+}
+
+/// Pin and resume the spawned, suspended child.
+pub fn apply(child: &Child, mask: usize) {
+    imp::apply(child, mask)
+}
+
+/// "0-15,32-47" -> CPU indices (capped well above any real machine).
+fn parse_cpu_set(spec: &str) -> Vec<usize> {
+    let mut cpus = Vec::new();
+    for part in spec.split(',').map(str::trim).filter(|p| !p.is_empty()) {
+        let (lo, hi) = match part.split_once('-') {
+            Some((a, b)) => (a.trim().parse::<usize>(), b.trim().parse::<usize>()),
+            None => (part.parse::<usize>(), part.parse::<usize>()),
+        };
+        if let (Ok(lo), Ok(hi)) = (lo, hi) {
+            cpus.extend(lo..=hi.min(4095));
+        }
+    }
+    cpus
+}
+
+#[cfg(windows)]
+mod imp {
+    use super::parse_cpu_set;
+    use crate::messages::PlacementSpec;
+    use std::os::windows::io::AsRawHandle;
+    use std::os::windows::process::CommandExt;
+    use std::process::{Child, Command};
+    use windows::Win32::Foundation::{CloseHandle, HANDLE};
+    use windows::Win32::System::Diagnostics::ToolHelp::{
+        CreateToolhelp32Snapshot, Thread32First, Thread32Next, TH32CS_SNAPTHREAD, THREADENTRY32,
+    };
+    use windows::Win32::System::SystemInformation::{GetNumaNodeProcessorMaskEx, GROUP_AFFINITY};
+    use windows::Win32::System::Threading::{
+        GetCurrentProcess, GetProcessAffinityMask, OpenThread, ResumeThread,
+        SetProcessAffinityMask, ABOVE_NORMAL_PRIORITY_CLASS, BELOW_NORMAL_PRIORITY_CLASS,
+        CREATE_SUSPENDED, HIGH_PRIORITY_CLASS, IDLE_PRIORITY_CLASS, NORMAL_PRIORITY_CLASS,
+        THREAD_SUSPEND_RESUME,
+    };
+
+    pub fn configure(cmd: &mut Command, spec: &PlacementSpec) -> Option<usize> {
+        let mut flags = match spec.priority.as_deref() {
+            Some("idle") => IDLE_PRIORITY_CLASS.0,
+            Some("below_normal") => BELOW_NORMAL_PRIORITY_CLASS.0,
+            Some("normal") => NORMAL_PRIORITY_CLASS.0,
+            Some("above_normal") => ABOVE_NORMAL_PRIORITY_CLASS.0,
+            Some("high") => HIGH_PRIORITY_CLASS.0,
+            Some("") | None => 0,
+            Some(other) => {
+                log::warn!("Unknown priority class '{}', inheriting", other);
+                0
+            }
+        };
+        let mask = target_mask(spec);
+        if mask.is_some() {
+            flags |= CREATE_SUSPENDED.0;
+        }
+        if flags != 0 {
+            cmd.creation_flags(flags);
+        }
+        mask
+    }
+
+    pub fn apply(child: &Child, mask: usize) {
+        let handle = HANDLE(child.as_raw_handle());
+        if let Err(e) = unsafe { SetProcessAffinityMask(handle, mask) } {
+            log::warn!("Failed to set render affinity {:#x}: {}", mask, e);
+        }
+        resume_threads(child.id());
+    }
+
+    /// Requested CPUs within our own affinity, or None to inherit.
+    fn target_mask(spec: &PlacementSpec) -> Option<usize> {
+        let mut wanted: Option<usize> = None;
+        if let Some(ref set) = spec.cpu_set {
+            let cpus = parse_cpu_set(set);
+            if !cpus.is_empty() {
+                // SetProcessAffinityMask only reaches the first processor group
+                wanted = Some(cpus.iter().filter(|&&c| c < 64).fold(0usize, |m, &c| m | (1usize << c)));
+            }
+        }
+        if let Some(node) = spec.numa_node.filter(|&n| n >= 0) {
+            let mut affinity = GROUP_AFFINITY::default();
+            match unsafe { GetNumaNodeProcessorMaskEx(node as u16, &mut affinity) } {
+                Ok(()) if affinity.Group == 0 => {
+                    wanted = Some(wanted.map_or(affinity.Mask, |m| m & affinity.Mask));
+                }
+                Ok(()) => log::warn!("NUMA node {} is outside processor group 0, not pinning", node),
+                Err(e) => log::warn!("NUMA node {} unavailable: {}", node, e),
+            }
+        }
+
+        let mut own: usize = 0;
+        let mut system: usize = 0;
+        unsafe { GetProcessAffinityMask(GetCurrentProcess(), &mut own, &mut system) }.ok()?;
+        let mask = wanted? & own;
+        if mask == 0 {
+            log::warn!("Requested CPUs are outside this slot's set, inheriting");
+            return None;
+        }
+        (mask != own).then_some(mask)
+    }
+
+    /// std::process::Child doesn't expose the main thread handle; a
+    /// suspended process has only that thread, found via a snapshot.
+    fn resume_threads(pid: u32) {
+        let snapshot = match unsafe { CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0) } {
+            Ok(h) => h,
+            Err(e) => {
+                log::error!("Thread snapshot failed, render stays suspended: {}", e);
+                return;
+            }
+        };
+        let mut entry = THREADENTRY32 {
+            dwSize: std::mem::size_of::<THREADENTRY32>() as u32,
+            ..Default::default()
+        };
+        let mut more = unsafe { Thread32First(snapshot, &mut entry) }.is_ok();
+        while more {
+            if entry.th32OwnerProcessID == pid {
+                if let Ok(thread) = unsafe { OpenThread(THREAD_SUSPEND_RESUME, false, entry.th32ThreadID) } {
+                    unsafe {
+                        ResumeThread(thread);
+                        let _ = CloseHandle(thread);
+                    }
+                }
+            }
+            more = unsafe { Thread32Next(snapshot, &mut entry) }.is_ok();
+        }
+        unsafe {
+            let _ = CloseHandle(snapshot);
+        }
+    }
+}
+
+#[cfg(unix)]
+mod imp {
+    use crate::messages::PlacementSpec;
+    use std::os::unix::process::CommandExt;
+    use std::process::{Child, Command};
+
+    pub fn configure(cmd: &mut Command, spec: &PlacementSpec) -> Option<usize> {
+        let nice: Option<libc::c_int> = match spec.priority.as_deref() {
+            Some("idle") => Some(19),
+            Some("below_normal") => Some(10),
+            Some("normal") => Some(0),
+            Some("above_normal") => Some(-5),   // raising needs privileges; best effort
+            Some("high") => Some(-10),
+            Some("") | None => None,
+            Some(other) => {
+                log::warn!("Unknown priority class '{}', inheriting", other);
+                None
+            }
+        };
+
+        #[cfg(target_os = "linux")]
+        let cpus = linux::target_set(spec);
+        #[cfg(not(target_os = "linux"))]
+        let cpus: Option<()> = {
+            if spec.cpu_set.is_some() || spec.numa_node.is_some() {
+                log::warn!("CPU affinity isn't supported on this platform");
+            }
+            None
+        };
+
+        if nice.is_none() && cpus.is_none() {
+            return None;
+        }
+        // Runs in the child between fork and exec: no allocation, errors ignored
+        unsafe {
+            cmd.pre_exec(move || {
+                if let Some(n) = nice {
+                    libc::setpriority(libc::PRIO_PROCESS, 0, n);
+                }
+                #[cfg(target_os = "linux")]
+                if let Some(ref set) = cpus {
+                    libc::sched_setaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), set);
+                }
+                Ok(())
+            });
+        }
+        None
+    }
+
+    pub fn apply(_child: &Child, _mask: usize) {}
+
+    #[cfg(target_os = "linux")]
+    mod linux {
+        use super::super::parse_cpu_set;
+        use crate::messages::PlacementSpec;
+
+        /// Requested CPUs within our own affinity, or None to inherit.
+        pub fn target_set(spec: &PlacementSpec) -> Option<libc::cpu_set_t> {
+            let mut wanted: Option<Vec<usize>> = spec
+                .cpu_set
+                .as_deref()
+                .map(parse_cpu_set)
+                .filter(|c| !c.is_empty());
+            if let Some(node) = spec.numa_node.filter(|&n| n >= 0) {
+                let path = format!("/sys/devices/system/node/node{}/cpulist", node);
+                match std::fs::read_to_string(&path) {
+                    Ok(list) => {
+                        let on_node = parse_cpu_set(list.trim());
+                        wanted = Some(match wanted {
+                            Some(w) => w.into_iter().filter(|c| on_node.contains(c)).collect(),
+                            None => on_node,
+                        });
+                    }
+                    Err(e) => log::warn!("NUMA node {} unavailable: {}", node, e),
+                }
+            }
+            let wanted = wanted?;
+
+            unsafe {
+                let mut own: libc::cpu_set_t = std::mem::zeroed();
+                if libc::sched_getaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), &mut own) != 0 {
+                    return None;
+                }
+                let mut set: libc::cpu_set_t = std::mem::zeroed();
+                let mut any = false;
+                for &cpu in &wanted {
+                    if cpu < libc::CPU_SETSIZE as usize && libc::CPU_ISSET(cpu, &own) {
+                        libc::CPU_SET(cpu, &mut set);
+                        any = true;
+                    }
+                }
+                if !any {
+                    log::warn!("Requested CPUs are outside this slot's set, inheriting");
+                    return None;
+                }
+                Some(set)
+            }
+        }
+    }
+}
@@ -0,0 +1,376 @@
+use std::io::{BufRead, Write};
+use std::process::{Child, ChildStdin, Command, Stdio};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::mpsc::{self, RecvTimeoutError};
+use std::thread;
+use std::time::{Duration, Instant};
+
+use crate::executor::{flush_lines, RenderEvent, STDOUT_FLUSH_INTERVAL, STDOUT_FLUSH_LINES};
+use crate::messages::TaskMessage;
+use crate::parser::LineParser;
+use crate::placement;
+
+// Persistent render process: the DCC is launched once and loads the scene,
+// then renders successive chunks sent to it on stdin.
+//
+// One line each way per chunk:
+//   agent   → stdin:   {"cmd":"render","frame_start":1,"frame_end":10}
+//                      {"cmd":"quit"}
+//   process → stdout:  SR_CHUNK_DONE ok
+//                      SR_CHUNK_DONE error <message>
+// Everything else it prints goes through the task's parsers as usual.
+
+const CHUNK_DONE: &str = "SR_CHUNK_DONE";
+const QUIT_GRACE: Duration = Duration::from_secs(5);
+const LINE_POLL: Duration = Duration::from_millis(200);
+
+enum ServerLine {
+    Out(String),
+    Err(String),
+    Closed,
+}
+
+pub struct RenderServer {
+    pub key: String,
+    child: Child,
+    stdin: Option<ChildStdin>,
+    lines: mpsc::Receiver<ServerLine>,
+    chunks: u32,
+    max_chunks: u32,
+    max_memory_mb: u64,
+    pub idle_since: Instant,
+}
+
+impl RenderServer {
+    pub fn spawn(task: &TaskMessage) -> Result<Self, String> {
+        let spec = task
+            .persistent
+            .as_ref()
+            .ok_or_else(|| "Task is not persistent".to_string())?;
+
+        let mut cmd = Command::new(&task.command.executable);
+        cmd.args(&task.command.args);
+        cmd.stdin(Stdio::piped());
+        cmd.stdout(Stdio::piped());
+        cmd.stderr(Stdio::piped());
+
+        if let Some(ref wd) = task.working_dir {
+            if !wd.is_empty() {
+                cmd.current_dir(wd);
+            }
+        }
+
+        for (k, v) in &task.environment {
+            cmd.env(k, v);
+        }
+
+        let pin = task.placement.as_ref().and_then(|p| placement::configure(&mut cmd, p));
+
+        let mut child = cmd
+            .spawn()
+            .map_err(|e| format!("Failed to spawn render server: {}", e))?;
+        if let Some(mask) = pin {
+            placement::apply(&child, mask);
+        }
+
+        // Both streams feed one channel, so a chunk reads them in order
+        let (line_tx, lines) = mpsc::channel::<ServerLine>();
+        if let Some(stdout) = child.stdout.take() {
+            let tx = line_tx.clone();
+            thread::spawn(move || {
+                for line in std::io::BufReader::new(stdout).lines() {
+                    match line {
+                        Ok(l) => {
+                            if tx.send(ServerLine::Out(l)).is_err() {
+                                return;
+                            }
+                        }
+                        Err(_) => break,
+                    }
+                }
+                let _ = tx.send(ServerLine::Closed);
+            });
+        }
+        if let Some(stderr) = child.stderr.take() {
+            let tx = line_tx;
+            thread::spawn(move || {
+                for line in std::io::BufReader::new(stderr).lines() {
+                    match line {
+                        Ok(l) => {
+                            if tx.send(ServerLine::Err(l)).is_err() {
+                                return;
+                            }
+                        }
+                        Err(_) => break,
+                    }
+                }
+            });
+        }
+
+        log::info!("Render server started: key={} pid={}", spec.key, child.id());
+
+        Ok(Self {
+            key: spec.key.clone(),
+            stdin: child.stdin.take(),
+            child,
+            lines,
+            chunks: 0,
+            max_chunks: spec.max_chunks,
+            max_memory_mb: spec.max_memory_mb,
+            idle_since: Instant::now(),
+        })
+    }
+
+    /// Whether this process can take the task's chunk.
+    pub fn accepts(&self, task: &TaskMessage) -> bool {
+        task.persistent.as_ref().map_or(false, |p| p.key == self.key)
+    }
+
+    /// Why the process should be replaced before its next chunk, if it should.
+    pub fn recycle_reason(&mut self) -> Option<String> {
+        if let Ok(Some(status)) = self.child.try_wait() {
+            return Some(format!("exited with code {}", status.code().unwrap_or(-1)));
+        }
+        if self.max_chunks > 0 && self.chunks >= self.max_chunks {
+            return Some(format!("{} chunks rendered", self.chunks));
+        }
+        if self.max_memory_mb > 0 {
+            if let Some(mb) = resident_mb(&self.child) {
+                if mb >= self.max_memory_mb {
+                    return Some(format!("{} MB resident (limit {} MB)", mb, self.max_memory_mb));
+                }
+            }
+        }
+        None
+    }
+
+    /// Render one chunk. Returns true if the process is still fit for the
+    /// next one; on failure, abort or timeout it has been (or should be) dropped.
+    pub fn run_chunk(
+        &mut self,
+        task: &TaskMessage,
+        tx: &mpsc::Sender<RenderEvent>,
+        abort_flag: &AtomicBool,
+    ) -> bool {
+        let start_time = Instant::now();
+        let parser = LineParser::new(task);
+        let timeout = task.timeout_seconds.map(Duration::from_secs);
+
+        let _ = tx.send(RenderEvent::Started);
+
+        // Whatever the process printed while idle belongs to no chunk
+        while let Ok(line) = self.lines.try_recv() {
+            if let ServerLine::Closed = line {
+                self.fail_exited(tx, &mut Vec::new());
+                return false;
+            }
+        }
+
+        let request = format!(
+            "{{\"cmd\":\"render\",\"frame_start\":{},\"frame_end\":{}}}",
+            task.frame_start, task.frame_end
+        );
+        let sent = match self.stdin.as_mut() {
+            Some(stdin) => writeln!(stdin, "{}", request).and_then(|_| stdin.flush()).is_ok(),
+            None => false,
+        };
+        if !sent {
+            let _ = tx.send(RenderEvent::Failed {
+                exit_code: -1,
+                error: "Render server is not accepting chunks".into(),
+            });
+            return false;
+        }
+
+        let mut stdout_buf: Vec<String> = Vec::new();
+        let mut last_flush = Instant::now();
+        let mut last_output_file: Option<String> = None;
+        let mut frames_done: u32 = 0;
+        // The process outlives the chunk, so its own peak says nothing about
+        // this one; sample what's resident while it renders instead
+        let mut peak_mb: Option<u64> = None;
+
+        loop {
+            // A chunk can't be interrupted inside the DCC, so abort and
+            // timeout take the whole process down
+            if abort_flag.load(Ordering::SeqCst) {
+                self.kill();
+                flush_lines(tx, &mut stdout_buf);
+                let _ = tx.send(RenderEvent::Failed {
+                    exit_code: -1,
+                    error: "Aborted by monitor".into(),
+                });
+                return false;
+            }
+            if let Some(t) = timeout {
+                if start_time.elapsed() > t {
+                    self.kill();
+                    flush_lines(tx, &mut stdout_buf);
+                    let _ = tx.send(RenderEvent::Failed {
+                        exit_code: -1,
+                        error: format!("Timeout after {}s", t.as_secs()),
+                    });
+                    return false;
+                }
+            }
+
+            let line = match self.lines.recv_timeout(LINE_POLL) {
+                Ok(l) => l,
+                Err(RecvTimeoutError::Timeout) => {
+                    if last_flush.elapsed() >= STDOUT_FLUSH_INTERVAL {
+                        flush_lines(tx, &mut stdout_buf);
+                        last_flush = Instant::now();
+                        peak_mb = peak_mb.max(resident_mb(&self.child));
+                    }
+                    continue;
+                }
+                Err(RecvTimeoutError::Disconnected) => ServerLine::Closed,
+            };
+
+            let (line, from_stderr) = match line {
+                ServerLine::Out(l) => (l, false),
+                ServerLine::Err(l) => (l, true),
+                ServerLine::Closed => {
+                    self.fail_exited(tx, &mut stdout_buf);
+                    return false;
+                }
+            };
+
+            if !from_stderr {
+                if let Some(rest) = line.strip_prefix(CHUNK_DONE) {
+                    flush_lines(tx, &mut stdout_buf);
+                    parser.log_throughput(&task.job_id, start_time.elapsed());
+                    peak_mb = peak_mb.max(resident_mb(&self.child));
+                    self.chunks += 1;
+                    self.idle_since = Instant::now();
+                    let rest = rest.trim();
+                    if rest == "ok" {
+                        let _ = tx.send(RenderEvent::Completed {
+                            elapsed_ms: start_time.elapsed().as_millis() as u64,
+                            exit_code: 0,
+                            output_file: last_output_file,
+                            peak_memory_mb: peak_mb,
+                        });
+                        return true;
+                    }
+                    let error = rest
+                        .strip_prefix("error")
+                        .map(str::trim)
+                        .filter(|e| !e.is_empty())
+                        .unwrap_or("Chunk failed in render server");
+                    let _ = tx.send(RenderEvent::Failed {
+                        exit_code: 1,
+                        error: error.to_string(),
+                    });
+                    return false;
+                }
+
+            }
+
+            let hits = parser.scan(&line, !from_stderr);
+            if let Some(pct) = hits.progress {
+                let _ = tx.send(RenderEvent::Progress {
+                    pct,
+                    elapsed_ms: start_time.elapsed().as_millis() as u64,
+                });
+            }
+            if let Some(path) = hits.output_file {
+                last_output_file = Some(path);
+            }
+
+            // Per-frame completion counts from this chunk's first frame
+            if hits.frame_completed {
+                let frame = task.frame_start + frames_done;
+                frames_done += 1;
+                if frame <= task.frame_end {
+                    let _ = tx.send(RenderEvent::FrameCompleted { frame });
+                }
+            }
+
+            stdout_buf.push(if from_stderr { format!("[stderr] {}", line) } else { line });
+
+            if stdout_buf.len() >= STDOUT_FLUSH_LINES || last_flush.elapsed() >= STDOUT_FLUSH_INTERVAL {
+                flush_lines(tx, &mut stdout_buf);
+                last_flush = Instant::now();
+                peak_mb = peak_mb.max(resident_mb(&self.child));
+            }
+        }
+    }
+
+    fn fail_exited(&mut self, tx: &mpsc::Sender<RenderEvent>, stdout_buf: &mut Vec<String>) {
+        flush_lines(tx, stdout_buf);
+        let exit_code = self.child.wait().ok().and_then(|s| s.code()).unwrap_or(-1);
+        let _ = tx.send(RenderEvent::Failed {
+            exit_code,
+            error: format!("Render server exited with code {}", exit_code),
+        });
+    }
+
+    fn kill(&mut self) {
+        let _ = self.child.kill();
+        let _ = self.child.wait();
+    }
+}
+
+impl Drop for RenderServer {
+    // Ask the process to quit (closing stdin too), then kill it if it lingers
+    fn drop(&mut self) {
+        if let Ok(Some(_)) = self.child.try_wait() {
+            return;
+        }
+        if let Some(mut stdin) = self.stdin.take() {
+            let _ = writeln!(stdin, "{{\"cmd\":\"quit\"}}");
+        }
+        let deadline = Instant::now() + QUIT_GRACE;
+        while Instant::now() < deadline {
+            match self.child.try_wait() {
+                Ok(Some(_)) => {
+                    log::info!("Render server stopped: key={}", self.key);
+                    return;
+                }
+                Ok(None) => thread::sleep(Duration::from_millis(100)),
+                Err(_) => break,
+            }
+        }
+        log::warn!("Render server did not quit, killing: key={}", self.key);
+        self.kill();
+    }
+}
+
+/// Current working set of a process, in MB.
+pub(crate) fn resident_mb(child: &Child) -> Option<u64> {
+    memory_mb(child, false)
+}
+
+/// Largest working set a process has had so far, in MB.
+pub(crate) fn peak_mb(child: &Child) -> Option<u64> {
+    memory_mb(child, true)
+}
+
+#[cfg(windows)]
+fn memory_mb(child: &Child, peak: bool) -> Option<u64> {
+    use std::os::windows::io::AsRawHandle;
+    use windows::Win32::Foundation::HANDLE;
+    use windows::Win32::System::ProcessStatus::{GetProcessMemoryInfo, PROCESS_MEMORY_COUNTERS};
+
+    let mut counters = PROCESS_MEMORY_COUNTERS::default();
+    let size = std::mem::size_of::<PROCESS_MEMORY_COUNTERS>() as u32;
+    unsafe { GetProcessMemoryInfo(HANDLE(child.as_raw_handle()), &mut counters, size) }.ok()?;
+    let bytes = if peak { counters.PeakWorkingSetSize } else { counters.WorkingSetSize };
+    Some(bytes as u64 / (1024 * 1024))
+}
+
+#[cfg(not(windows))]
+fn memory_mb(child: &Child, peak: bool) -> Option<u64> {
+    let status = std::fs::read_to_string(format!("/proc/{}/status", child.id())).ok()?;
+    let field = if peak { "VmHWM:" } else { "VmRSS:" };
+    let kb: u64 = status
+        .lines()
+        .find_map(|l| l.strip_prefix(field))?
+        .trim()
+        .trim_end_matches("kB")
+        .trim()
+        .parse()
+        .ok()?;
+    Some(kb / 1024)
+}
@@ -0,0 +1,362 @@
+// sr_bench — microbenchmarks for the core hot paths: JSON round trips of the
+// farm file types, chunk computation, atomic file I/O, message dedup and
+// task token rendering.
+//
+// Google Benchmark drives the runs; for regression tracking write JSON:
+//   sr_bench --benchmark_out=bench.json --benchmark_out_format=json
+// File I/O runs against the system temp dir, and also against a share when
+// given one:
+//   sr_bench --net-dir=\\nas\farm\bench
+
+#include "core/atomic_file_io.h"
+#include "core/heartbeat.h"
+#include "core/job_types.h"
+#include "core/message_dedup.h"
+#include "core/token_template.h"
+
+#include <benchmark/benchmark.h>
+
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace SR;
+namespace fs = std::filesystem;
+
+namespace {
+
+// ─── Fixtures ───────────────────────────────────────────────────────────────
+
+// A table the size of a long animation job: chunks of 5, a mix of states
+DispatchTable makeTable(int chunks)
+{
+    DispatchTable dt;
+    dt.coordinator_id = "node-coordinator-01";
+    dt.updated_at_ms = 1760000000000;
+    dt.journal_seq = 4242;
+    dt.chunks.reserve(chunks);
+    for (int i = 0; i < chunks; ++i)
+    {
+        DispatchChunk c;
+        c.frame_start = 1 + i * 5;
+        c.frame_end = c.frame_start + 4;
+        switch (i % 4)
+        {
+        case 0:
+            c.state = DispatchState::Completed;
+            c.assigned_to = "node-" + std::to_string(i % 50);
+            c.assigned_at_ms = 1760000000000 + i * 1000;
+            c.completed_at_ms = c.assigned_at_ms + 150000;
+            break;
+        case 1:
+            c.state = DispatchState::Assigned;
+            c.assigned_to = "node-" + std::to_string(i % 50);
+            c.assigned_at_ms = 1760000000000 + i * 1000;
+            break;
+        default:
+            break;
+        }
+        c.retry_count = (i % 17 == 0) ? 1 : 0;
+        dt.chunks.push_back(std::move(c));
+    }
+    return dt;
+}
+
+JobManifest makeManifest()
+{
+    JobManifest m;
+    m.job_id = "shot-042-lighting-v12";
+    m.template_id = "blender-cycles";
+    m.submitted_by = "node-artist-07";
+    m.submitted_os = "windows";
+    m.submitted_at_ms = 1760000000000;
+    m.cmd = {
+        {"windows", "C:/Program Files/Blender Foundation/Blender 4.2/blender.exe"},
+        {"linux", "/opt/blender/blender"},
+        {"macos", "/Applications/Blender.app/Contents/MacOS/Blender"},
+    };
+    m.flags = {
+        {"-b", std::string("//nas/projects/show/shot_042/lighting/shot_042_v12.blend"), true, false},
+        {"-o", std::string("//nas/projects/show/shot_042/render/v12/shot_042_####"), false, true},
+        {"-F", std::string("OPEN_EXR_MULTILAYER"), false, false},
+        {"-s", std::string("{chunk_start}"), false, false},
+        {"-e", std::string("{chunk_end}"), false, false},
+        {"-a", std::nullopt, false, false},
+    };
+    m.frame_start = 1001;
+    m.frame_end = 1240;
+    m.chunk_size = 5;
+    m.timeout_seconds = 3600;
+    m.output_dir = "//nas/projects/show/shot_042/render/v12";
+    m.environment = {{"OCIO", "//nas/config/aces/config.ocio"}, {"BLENDER_USER_SCRIPTS", "//nas/pipeline/blender"}};
+    m.tags_required = {"gpu", "blender-4.2"};
+    return m;
+}
+
+Heartbeat makeHeartbeat()
+{
+    Heartbeat h;
+    h.node_id = "node-render-017";
+    h.hostname = "RENDER-017";
+    h.os = "windows";
+    h.app_version = "0.1.4";
+    h.seq = 123456;
+    h.timestamp_ms = 1760000000000;
+    h.render_state = "rendering";
+    h.active_job = "shot-042-lighting-v12";
+    h.active_frames = "1101-1105";
+    h.active_jobs = {"shot-042-lighting-v12", "shot-043-fx-v3"};
+    h.render_slots = 2;
+    h.free_slots = 0;
+    h.gpu_name = "NVIDIA GeForce RTX 4090";
+    h.cpu_cores = 32;
+    h.ram_gb = 128;
+    h.tags = {"gpu", "blender-4.2", "houdini-20"};
+    h.load = {45, 65536, 98, 2048, 24564, 812};
+    h.tcp_port = 4712;
+    return h;
+}
+
+std::string g_netDir;
+
+// ─── Serialization ──────────────────────────────────────────────────────────
+
+void BM_DispatchTableToJson(benchmark::State& state)
+{
+    auto dt = makeTable(int(state.range(0)));
+    for (auto _ : state)
+    {
+        nlohmann::json j = dt;
+        benchmark::DoNotOptimize(j);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DispatchTableToJson)->Arg(50)->Arg(2000)->Arg(20000);
+
+void BM_DispatchTableFromJson(benchmark::State& state)
+{
+    nlohmann::json j = makeTable(int(state.range(0)));
+    for (auto _ : state)
+    {
+        auto dt = j.get<DispatchTable>();
+        benchmark::DoNotOptimize(dt);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DispatchTableFromJson)->Arg(50)->Arg(2000)->Arg(20000);
+
+// Text round trip, as read from and written to dispatch.json
+void BM_DispatchTableDumpParse(benchmark::State& state)
+{
+    std::string text = nlohmann::json(makeTable(int(state.range(0)))).dump();
+    for (auto _ : state)
+    {
+        auto dt = nlohmann::json::parse(text).get<DispatchTable>();
+        benchmark::DoNotOptimize(nlohmann::json(dt).dump());
+    }
+    state.SetBytesProcessed(state.iterations() * int64_t(text.size()) * 2);
+}
+BENCHMARK(BM_DispatchTableDumpParse)->Arg(2000);
+
+void BM_ManifestRoundTrip(benchmark::State& state)
+{
+    auto m = makeManifest();
+    for (auto _ : state)
+    {
+        nlohmann::json j = m;
+        auto back = j.get<JobManifest>();
+        benchmark::DoNotOptimize(back);
+    }
+}
+BENCHMARK(BM_ManifestRoundTrip);
+
+void BM_HeartbeatRoundTrip(benchmark::State& state)
+{
+    auto h = makeHeartbeat();
+    for (auto _ : state)
+    {
+        nlohmann::json j = h;
+        auto back = j.get<Heartbeat>();
+        benchmark::DoNotOptimize(back);
+    }
+}
+BENCHMARK(BM_HeartbeatRoundTrip);
+
+// ─── Chunking ───────────────────────────────────────────────────────────────
+
+void BM_ComputeChunks(benchmark::State& state)
+{
+    int chunkSize = int(state.range(0));
+    for (auto _ : state)
+    {
+        auto chunks = computeChunks(1, 100000, chunkSize);
+        benchmark::DoNotOptimize(chunks);
+    }
+    state.SetItemsProcessed(state.iterations() * ((100000 + chunkSize - 1) / chunkSize));
+}
+BENCHMARK(BM_ComputeChunks)->Arg(1)->Arg(10)->Arg(100);
+
+// ─── File I/O ───────────────────────────────────────────────────────────────
+
+void fileWrite(benchmark::State& state, const fs::path& dir, JsonEncoding enc)
+{
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    auto path = dir / "sr_bench_dispatch.json";
+    nlohmann::json j = makeTable(2000);
+    for (auto _ : state)
+    {
+        if (!AtomicFileIO::writeJson(path, j, enc))
+        {
+            state.SkipWithError(("cannot write " + path.string()).c_str());
+            break;
+        }
+    }
+    fs::remove(path, ec);
+}
+
+void fileRead(benchmark::State& state, const fs::path& dir, JsonEncoding enc)
+{
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    auto path = dir / "sr_bench_dispatch.json";
+    if (!AtomicFileIO::writeJson(path, makeTable(2000), enc))
+    {
+        state.SkipWithError(("cannot write " + path.string()).c_str());
+        return;
+    }
+    for (auto _ : state)
+    {
+        auto j = AtomicFileIO::safeReadJson(path);
+        if (!j)
+        {
+            state.SkipWithError(("cannot read " + path.string()).c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(j);
+    }
+    fs::remove(path, ec);
+}
+
+// Registered from main: the directories are only known at run time
+void registerFileBenchmarks(const std::string& label, const fs::path& dir)
+{
+    const std::pair<const char*, JsonEncoding> encodings[] = {
+        {"compact", JsonEncoding::Compact},
+        {"cbor", JsonEncoding::Cbor},
+    };
+    for (const auto& [name, enc] : encodings)
+    {
+        benchmark::RegisterBenchmark(("BM_WriteJson/" + label + "/" + name).c_str(),
+            [dir, enc = enc](benchmark::State& s) { fileWrite(s, dir, enc); })
+            ->Unit(benchmark::kMicrosecond)->UseRealTime();
+        benchmark::RegisterBenchmark(("BM_SafeReadJson/" + label + "/" + name).c_str(),
+            [dir, enc = enc](benchmark::State& s) { fileRead(s, dir, enc); })
+            ->Unit(benchmark::kMicrosecond)->UseRealTime();
+    }
+}
+
+// ─── Message dedup ──────────────────────────────────────────────────────────
+
+// Fresh ids at the steady rate a large farm produces, every third one a
+// repeat (the same message over UDP, TCP and the inbox)
+void BM_MessageDedup(benchmark::State& state)
+{
+    std::vector<std::string> ids;
+    ids.reserve(3000);
+    for (int i = 0; i < 3000; ++i)
+        ids.push_back("1760000000000.node-" + std::to_string(i % 200) + "." + std::to_string(i));
+
+    MessageDedup dedup;
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto& id = ids[i % ids.size()];
+        benchmark::DoNotOptimize(dedup.isDuplicate(id));
+        if (i % 3 == 0)
+            benchmark::DoNotOptimize(dedup.isDuplicate(id));
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MessageDedup);
+
+// ─── Token rendering ────────────────────────────────────────────────────────
+
+// Task arguments as RenderCoordinator renders them per chunk (its compileTask
+// token list; substitution itself is private to the coordinator)
+void BM_TaskTokens(benchmark::State& state)
+{
+    enum { TokFrame, TokChunkStart, TokChunkEnd, TokOutputPath };
+    std::vector<TokenTemplate> args;
+    for (const char* text : {"-b", "//nas/projects/show/shot_042/lighting/shot_042_v12.blend",
+                             "-o", "{output_path}/shot_042_####", "-s", "{chunk_start}",
+                             "-e", "{chunk_end}", "--frame={frame}", "-a"})
+    {
+        args.emplace_back(text, std::initializer_list<std::string_view>{
+            "frame", "chunk_start", "chunk_end", "output_path"});
+    }
+
+    const std::string outputPath = "//nas/projects/show/shot_042/render/v12";
+    auto appendInt = [](std::string& out, int v)
+    {
+        char buf[16];
+        auto res = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, res.ptr);
+    };
+
+    int chunk = 0;
+    std::string out;
+    for (auto _ : state)
+    {
+        int start = 1001 + (chunk++ % 48) * 5;
+        out.clear();
+        for (const auto& a : args)
+        {
+            a.renderTo(out, [&](int id, std::string_view, std::string& o)
+            {
+                switch (id)
+                {
+                case TokFrame:
+                case TokChunkStart: appendInt(o, start); return true;
+                case TokChunkEnd:   appendInt(o, start + 4); return true;
+                case TokOutputPath: o += outputPath; return true;
+                default:            return false;
+                }
+            });
+            out += '\0';
+        }
+        benchmark::DoNotOptimize(out);
+    }
+}
+BENCHMARK(BM_TaskTokens);
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    // Strip our own flag before Google Benchmark sees the rest
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--net-dir=", 10) == 0)
+            g_netDir = argv[i] + 10;
+        else
+            args.push_back(argv[i]);
+    }
+    int count = int(args.size());
+
+    registerFileBenchmarks("local", fs::temp_directory_path() / "sr_bench");
+    if (!g_netDir.empty())
+        registerFileBenchmarks("net", fs::path(g_netDir));
+
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
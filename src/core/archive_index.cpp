@@ -0,0 +1,81 @@
+#include "core/archive_index.h"
+#include "core/farm_storage.h"
+
+#include <iostream>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+fs::path ArchiveIndex::dir(const fs::path& farmPath)
+{
+    return farmPath / "archive";
+}
+
+fs::path ArchiveIndex::indexPath(const fs::path& farmPath)
+{
+    return dir(farmPath) / "index.jsonl";
+}
+
+bool ArchiveIndex::append(const fs::path& farmPath, const ArchiveRecord& record)
+{
+    auto& storage = FarmStorage::current();
+    storage.createDirectories(dir(farmPath));
+
+    nlohmann::json j = record;
+    std::string line = j.dump();
+    line += '\n';
+
+    // One write per record so a reader sees either nothing or the whole line
+    if (!storage.append(indexPath(farmPath), line))
+    {
+        std::cerr << "[ArchiveIndex] Failed to append to " << indexPath(farmPath) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+size_t ArchiveIndex::readSince(const fs::path& farmPath, uint64_t& offset,
+                               const std::function<void(const ArchiveRecord&)>& fn)
+{
+    auto& storage = FarmStorage::current();
+    auto st = storage.stat(indexPath(farmPath));
+    if (!st.exists)
+        return 0;
+    if (st.size < offset)
+        offset = 0;     // replaced by a shorter file: start over
+    if (st.size <= offset)
+        return 0;
+
+    auto read = storage.read(indexPath(farmPath), offset);
+    if (!read)
+        return 0;
+    const std::string& data = *read;
+
+    size_t delivered = 0;
+    size_t start = 0;
+    while (true)
+    {
+        auto nl = data.find('\n', start);
+        if (nl == std::string::npos)
+            break;
+        if (nl > start)
+        {
+            try
+            {
+                auto j = nlohmann::json::parse(data.begin() + start, data.begin() + nl);
+                fn(j.get<ArchiveRecord>());
+                ++delivered;
+            }
+            catch (const std::exception&)
+            {
+                // Torn or foreign line: skip it, the rest still reads
+            }
+        }
+        start = nl + 1;
+    }
+    offset += start;
+    return delivered;
+}
+
+} // namespace SR
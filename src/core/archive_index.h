@@ -0,0 +1,90 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+namespace SR {
+
+// A finished job moved from jobs/{id} to archive/{id}: everything the UI
+// lists it by, so browsing the archive never opens the job directories
+struct ArchiveRecord
+{
+    std::string job_id;
+    std::string template_id;
+    std::string state;              // "completed" | "cancelled"
+    int frames = 0;                 // frame (or tile) units in the job
+    int completed = 0;
+    int failed = 0;
+    std::string submitted_by;       // node_id
+    int64_t submitted_at_ms = 0;
+    int64_t finished_at_ms = 0;     // the final state entry's timestamp
+    int64_t archived_at_ms = 0;
+    std::string output_dir;
+    bool removed = false;           // archive/{id} was deleted; drops the job from the listing
+};
+
+// JSON serialization (removal lines carry only the id)
+inline void to_json(nlohmann::json& j, const ArchiveRecord& r)
+{
+    if (r.removed)
+    {
+        j = nlohmann::json{{"job_id", r.job_id}, {"removed", true}};
+        return;
+    }
+    j = nlohmann::json{
+        {"job_id", r.job_id},
+        {"template_id", r.template_id},
+        {"state", r.state},
+        {"frames", r.frames},
+        {"completed", r.completed},
+        {"failed", r.failed},
+        {"submitted_by", r.submitted_by},
+        {"submitted_at_ms", r.submitted_at_ms},
+        {"finished_at_ms", r.finished_at_ms},
+        {"archived_at_ms", r.archived_at_ms},
+        {"output_dir", r.output_dir},
+    };
+}
+
+inline void from_json(const nlohmann::json& j, ArchiveRecord& r)
+{
+    j.at("job_id").get_to(r.job_id);
+    r.removed = j.value("removed", false);
+    r.template_id = j.value("template_id", std::string());
+    r.state = j.value("state", std::string());
+    r.frames = j.value("frames", 0);
+    r.completed = j.value("completed", 0);
+    r.failed = j.value("failed", 0);
+    r.submitted_by = j.value("submitted_by", std::string());
+    r.submitted_at_ms = j.value("submitted_at_ms", int64_t(0));
+    r.finished_at_ms = j.value("finished_at_ms", int64_t(0));
+    r.archived_at_ms = j.value("archived_at_ms", int64_t(0));
+    r.output_dir = j.value("output_dir", std::string());
+}
+
+// Archive tier of the farm:
+//   archive/{id}/        — job directories moved out of jobs/, unchanged
+//   archive/index.jsonl  — append-only, one compact ArchiveRecord per line
+//
+// A later line for a job replaces an earlier one. Each line is appended in
+// one write; one without its trailing newline is still being written (or
+// synced) and is left for later.
+class ArchiveIndex
+{
+public:
+    static std::filesystem::path dir(const std::filesystem::path& farmPath);
+    static std::filesystem::path indexPath(const std::filesystem::path& farmPath);
+
+    static bool append(const std::filesystem::path& farmPath, const ArchiveRecord& record);
+
+    // Deliver every complete record after offset (bytes), advancing it.
+    // Returns the number of records delivered.
+    static size_t readSince(const std::filesystem::path& farmPath, uint64_t& offset,
+                            const std::function<void(const ArchiveRecord&)>& fn);
+};
+
+} // namespace SR
@@ -1,158 +1,170 @@
 #include "core/atomic_file_io.h"
+#include "core/farm_storage.h"
+#include "core/perf_counters.h"
 
-#include <fstream>
+#include <atomic>
 #include <iostream>
 
-#ifdef _WIN32
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
-#endif
-
 namespace SR {
 
-bool AtomicFileIO::writeJson(const std::filesystem::path& path, const nlohmann::json& data)
-{
-    auto tmpPath = path;
-    tmpPath += ".tmp";
-
-    try
-    {
-        std::ofstream file(tmpPath);
-        if (!file.is_open())
-        {
-            std::cerr << "[AtomicFileIO] Failed to open temp file: " << tmpPath << std::endl;
-            return false;
-        }
+namespace {
 
-        file << data.dump(2);
-        file.flush();
+// Indexed by FileClass; Default stays Pretty regardless of setEncoding()
+std::atomic<uint8_t> s_encodings[static_cast<size_t>(FileClass::Count)] = {
+    static_cast<uint8_t>(JsonEncoding::Pretty),     // Default
+    static_cast<uint8_t>(JsonEncoding::Compact),    // Heartbeat
+    static_cast<uint8_t>(JsonEncoding::Compact),    // Dispatch
+    static_cast<uint8_t>(JsonEncoding::Compact),    // Command
+    static_cast<uint8_t>(JsonEncoding::Compact),    // State
+    static_cast<uint8_t>(JsonEncoding::Compact),    // Event
+};
 
-        if (!file.good())
-        {
-            std::cerr << "[AtomicFileIO] Write failed for: " << tmpPath << std::endl;
-            file.close();
-            return false;
-        }
-        file.close();
+} // namespace
 
-        flushToDisk(tmpPath);
-        std::filesystem::rename(tmpPath, path);
-        return true;
-    }
-    catch (const std::exception& e)
+const char* jsonEncodingName(JsonEncoding enc)
+{
+    switch (enc)
     {
-        std::cerr << "[AtomicFileIO] writeJson error: " << e.what() << std::endl;
-        // Clean up temp file on failure
-        std::error_code ec;
-        std::filesystem::remove(tmpPath, ec);
-        return false;
+        case JsonEncoding::Pretty:  return "pretty";
+        case JsonEncoding::Compact: return "compact";
+        case JsonEncoding::Cbor:    return "cbor";
+        case JsonEncoding::MsgPack: return "msgpack";
     }
+    return "pretty";
 }
 
-std::optional<nlohmann::json> AtomicFileIO::safeReadJson(const std::filesystem::path& path)
+std::optional<JsonEncoding> jsonEncodingFromString(const std::string& name)
 {
-    try
-    {
-        if (!std::filesystem::exists(path))
-            return std::nullopt;
-
-        std::ifstream file(path);
-        if (!file.is_open())
-            return std::nullopt;
+    if (name == "pretty")  return JsonEncoding::Pretty;
+    if (name == "compact") return JsonEncoding::Compact;
+    if (name == "cbor")    return JsonEncoding::Cbor;
+    if (name == "msgpack") return JsonEncoding::MsgPack;
+    return std::nullopt;
+}
 
-        nlohmann::json data = nlohmann::json::parse(file);
-        return data;
-    }
-    catch (const std::exception& e)
+const char* fileClassName(FileClass cls)
+{
+    switch (cls)
     {
-        std::cerr << "[AtomicFileIO] safeReadJson error for " << path << ": " << e.what() << std::endl;
-        return std::nullopt;
+        case FileClass::Default:   return "default";
+        case FileClass::Heartbeat: return "heartbeat";
+        case FileClass::Dispatch:  return "dispatch";
+        case FileClass::Command:   return "command";
+        case FileClass::State:     return "state";
+        case FileClass::Event:     return "event";
+        case FileClass::Count:     break;
     }
+    return "default";
 }
 
-bool AtomicFileIO::writeText(const std::filesystem::path& path, const std::string& content)
+void AtomicFileIO::setEncoding(FileClass cls, JsonEncoding encoding)
 {
-    auto tmpPath = path;
-    tmpPath += ".tmp";
+    if (cls == FileClass::Default || cls >= FileClass::Count)
+        return;
+    s_encodings[static_cast<size_t>(cls)].store(static_cast<uint8_t>(encoding));
+}
 
-    try
-    {
-        std::ofstream file(tmpPath);
-        if (!file.is_open())
-        {
-            std::cerr << "[AtomicFileIO] Failed to open temp file: " << tmpPath << std::endl;
-            return false;
-        }
+JsonEncoding AtomicFileIO::encodingFor(FileClass cls)
+{
+    if (cls >= FileClass::Count)
+        return JsonEncoding::Pretty;
+    return static_cast<JsonEncoding>(s_encodings[static_cast<size_t>(cls)].load());
+}
 
-        file << content;
-        file.flush();
+bool AtomicFileIO::writeJson(const std::filesystem::path& path, const nlohmann::json& data,
+                             FileClass cls)
+{
+    return writeJson(path, data, encodingFor(cls));
+}
 
-        if (!file.good())
+bool AtomicFileIO::writeJson(const std::filesystem::path& path, const nlohmann::json& data,
+                             JsonEncoding encoding)
+{
+    std::string bytes;
+    try
+    {
+        switch (encoding)
         {
-            std::cerr << "[AtomicFileIO] Write failed for: " << tmpPath << std::endl;
-            file.close();
-            return false;
+            case JsonEncoding::Pretty:
+                bytes = data.dump(2);
+                break;
+            case JsonEncoding::Compact:
+                bytes = data.dump();
+                break;
+            case JsonEncoding::Cbor:
+            {
+                // Self-describe tag marks the file as CBOR for the reader
+                bytes = { char(0xD9), char(0xD9), char(0xF7) };
+                nlohmann::json::to_cbor(data, bytes);
+                break;
+            }
+            case JsonEncoding::MsgPack:
+                nlohmann::json::to_msgpack(data, bytes);
+                break;
         }
-        file.close();
-
-        flushToDisk(tmpPath);
-        std::filesystem::rename(tmpPath, path);
-        return true;
     }
     catch (const std::exception& e)
     {
-        std::cerr << "[AtomicFileIO] writeText error: " << e.what() << std::endl;
-        std::error_code ec;
-        std::filesystem::remove(tmpPath, ec);
+        std::cerr << "[AtomicFileIO] writeJson error: " << e.what() << std::endl;
         return false;
     }
+
+    if (!FarmStorage::current().writeAtomic(path, bytes))
+        return false;
+    PerfCounters::instance().countWrite(bytes.size());
+    return true;
 }
 
-std::optional<std::string> AtomicFileIO::safeReadText(const std::filesystem::path& path)
+std::optional<nlohmann::json> AtomicFileIO::safeReadJson(const std::filesystem::path& path)
 {
     try
     {
-        if (!std::filesystem::exists(path))
+        auto raw = FarmStorage::current().read(path);
+        if (!raw)
             return std::nullopt;
-
-        std::ifstream file(path);
-        if (!file.is_open())
+        PerfCounters::instance().countRead(raw->size());
+        if (raw->empty())
             return std::nullopt;
 
-        std::string content((std::istreambuf_iterator<char>(file)),
-                             std::istreambuf_iterator<char>());
-        return content;
+        // Text JSON documents start with '{', '[' or whitespace (or a UTF-8 BOM).
+        // Binary: CBOR self-describe tag or map (0xA0-0xBF), MessagePack map
+        // (fixmap 0x80-0x8F, map16 0xDE, map32 0xDF).
+        auto b0 = static_cast<uint8_t>((*raw)[0]);
+        if (raw->size() >= 3 && b0 == 0xD9 && uint8_t((*raw)[1]) == 0xD9 && uint8_t((*raw)[2]) == 0xF7)
+            return nlohmann::json::from_cbor(raw->begin() + 3, raw->end());
+        if (b0 >= 0xA0 && b0 <= 0xBF)
+            return nlohmann::json::from_cbor(*raw);
+        if ((b0 >= 0x80 && b0 <= 0x8F) || b0 == 0xDE || b0 == 0xDF)
+            return nlohmann::json::from_msgpack(*raw);
+
+        nlohmann::json data = nlohmann::json::parse(*raw);
+        return data;
     }
     catch (const std::exception& e)
     {
-        std::cerr << "[AtomicFileIO] safeReadText error for " << path << ": " << e.what() << std::endl;
+        std::cerr << "[AtomicFileIO] safeReadJson error for " << path << ": " << e.what() << std::endl;
         return std::nullopt;
     }
 }
 
-void AtomicFileIO::flushToDisk(const std::filesystem::path& path)
+bool AtomicFileIO::writeText(const std::filesystem::path& path, const std::string& content)
 {
-#ifdef _WIN32
-    HANDLE hFile = CreateFileW(
-        path.c_str(),
-        GENERIC_READ,
-        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-        nullptr,
-        OPEN_EXISTING,
-        0,
-        nullptr
-    );
-
-    if (hFile != INVALID_HANDLE_VALUE)
-    {
-        if (!FlushFileBuffers(hFile))
-        {
-            std::cerr << "[AtomicFileIO] Warning: FlushFileBuffers failed" << std::endl;
-        }
-        CloseHandle(hFile);
-    }
-#endif
-    // On Linux/macOS, fsync would go here
+    if (!FarmStorage::current().writeAtomic(path, content))
+        return false;
+    PerfCounters::instance().countWrite(content.size());
+    return true;
+}
+
+std::optional<std::string> AtomicFileIO::safeReadText(const std::filesystem::path& path)
+{
+    auto content = FarmStorage::current().read(path);
+    if (!content)
+        return std::nullopt;
+
+    // Files written in text mode by older builds may carry CRLF
+    std::erase(*content, '\r');
+    PerfCounters::instance().countRead(content->size());
+    return content;
 }
 
 } // namespace SR
@@ -3,28 +3,60 @@
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 
 namespace SR {
 
+// On-disk encoding for JSON documents. Readers auto-detect all of these, so
+// the encoding can change per file class without breaking existing files.
+enum class JsonEncoding : uint8_t
+{
+    Pretty,     // dump(2) — human-edited files (config, manifests, templates)
+    Compact,    // dump() — machine files; still readable by older nodes
+    Cbor,       // RFC 8949, written with the self-describe tag (D9 D9 F7)
+    MsgPack
+};
+
+// Farm file classes with a selectable encoding (see setEncoding)
+enum class FileClass : uint8_t
+{
+    Default,    // always Pretty
+    Heartbeat,  // nodes/{id}/heartbeat.json
+    Dispatch,   // jobs/{id}/dispatch.json snapshots
+    Command,    // nodes/{id}/inbox/*.json
+    State,      // jobs/{id}/state/*.json
+    Event,      // jobs/{id}/events/*.json
+    Count
+};
+
+const char* jsonEncodingName(JsonEncoding enc);
+std::optional<JsonEncoding> jsonEncodingFromString(const std::string& name);
+const char* fileClassName(FileClass cls);
+
+// All I/O goes through FarmStorage::current()
 class AtomicFileIO
 {
 public:
     // Write JSON atomically: serialize → write .tmp → flush → rename
-    static bool writeJson(const std::filesystem::path& path, const nlohmann::json& data);
+    static bool writeJson(const std::filesystem::path& path, const nlohmann::json& data,
+                          FileClass cls = FileClass::Default);
+    static bool writeJson(const std::filesystem::path& path, const nlohmann::json& data,
+                          JsonEncoding encoding);
 
-    // Read and parse JSON. Returns nullopt on missing file or parse error.
+    // Read and parse JSON (text, CBOR or MessagePack — detected from the first bytes).
+    // Returns nullopt on missing file or parse error.
     static std::optional<nlohmann::json> safeReadJson(const std::filesystem::path& path);
 
+    // Per-class write encoding (thread-safe). Machine classes default to Compact.
+    static void setEncoding(FileClass cls, JsonEncoding encoding);
+    static JsonEncoding encodingFor(FileClass cls);
+
     // Write plain text atomically: write .tmp → flush → rename
     static bool writeText(const std::filesystem::path& path, const std::string& content);
 
     // Read plain text. Returns nullopt on missing file or read error.
     static std::optional<std::string> safeReadText(const std::filesystem::path& path);
-
-private:
-    // Flush file buffers to disk (Windows: FlushFileBuffers)
-    static void flushToDisk(const std::filesystem::path& path);
 };
 
 } // namespace SR
@@ -0,0 +1,236 @@
+#include "core/chunk_trace.h"
+#include "core/farm_storage.h"
+#include "core/monitor_log.h"
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+ChunkTrace& ChunkTrace::instance()
+{
+    static ChunkTrace s_instance;
+    return s_instance;
+}
+
+int64_t ChunkTrace::nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void ChunkTrace::start(const fs::path& farmPath, const std::string& nodeId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_farmPath = farmPath;
+    m_nodeId = nodeId;
+    m_pending.clear();
+    m_pendingCount = 0;
+    m_dropped = 0;
+    m_createdDirs.clear();
+}
+
+void ChunkTrace::stop()
+{
+    flush(true);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_farmPath.clear();
+    m_pending.clear();
+    m_pendingCount = 0;
+}
+
+void ChunkTrace::record(const std::string& jobId, const std::string& traceId, const ChunkRange& chunk,
+                        const char* name, int64_t startUs, int64_t endUs, const nlohmann::json& args)
+{
+    if (!enabled() || traceId.empty() || jobId.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_farmPath.empty())
+        return;
+    if (m_pendingCount >= MAX_BUFFERED)
+    {
+        ++m_dropped;
+        return;
+    }
+
+    nlohmann::json span = {
+        {"trace", traceId},
+        {"name", name},
+        {"node", m_nodeId},
+        {"chunk", chunk.rangeStr()},
+        {"ts", startUs},
+        {"dur", (std::max<int64_t>)(endUs - startUs, 0)},
+    };
+    if (!args.empty())
+        span["args"] = args;
+
+    auto& lines = m_pending[jobId];
+    lines += span.dump();
+    lines += '\n';
+    ++m_pendingCount;
+}
+
+void ChunkTrace::flush(bool force)
+{
+    auto now = std::chrono::steady_clock::now();
+    std::map<std::string, std::string> pending;
+    fs::path farmPath;
+    std::string nodeId;
+    size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pending.empty() || m_farmPath.empty())
+            return;
+        if (!force && now - m_lastFlush < std::chrono::milliseconds(FLUSH_INTERVAL_MS))
+            return;
+        m_lastFlush = now;
+        pending.swap(m_pending);
+        m_pendingCount = 0;
+        dropped = std::exchange(m_dropped, 0);
+        farmPath = m_farmPath;
+        nodeId = m_nodeId;
+    }
+
+    auto& storage = FarmStorage::current();
+    for (const auto& [jobId, lines] : pending)
+    {
+        auto dir = farmPath / "jobs" / jobId / "trace";
+        if (!m_createdDirs.count(jobId))
+        {
+            // A job deleted since its spans were recorded has no dir to come back to
+            if (!storage.isDirectory(farmPath / "jobs" / jobId) || !storage.createDirectories(dir))
+                continue;
+            m_createdDirs.insert(jobId);
+        }
+        if (!storage.append(dir / (nodeId + ".jsonl"), lines))
+            m_createdDirs.erase(jobId);
+    }
+
+    if (dropped > 0)
+        MonitorLog::instance().warn("trace", "Dropped " + std::to_string(dropped) +
+                                    " chunk trace span(s): buffer full");
+}
+
+// ─── Export ─────────────────────────────────────────────────────────────────
+
+nlohmann::json ChunkTrace::exportJob(const fs::path& farmPath, const std::string& jobId)
+{
+    struct Span
+    {
+        std::string trace;
+        std::string name;
+        std::string node;
+        std::string chunk;
+        int64_t ts = 0;
+        int64_t dur = 0;
+        nlohmann::json args;
+        int pid = 0;
+        int tid = 0;
+    };
+
+    auto& storage = FarmStorage::current();
+    auto dir = farmPath / "jobs" / jobId / "trace";
+
+    std::vector<Span> spans;
+    for (const auto& entry : storage.list(dir))
+    {
+        if (entry.isDir || !entry.name.ends_with(".jsonl"))
+            continue;
+        auto data = storage.read(dir / entry.name);
+        if (!data)
+            continue;
+
+        // A line without its newline is still being appended (or synced)
+        std::string_view text = *data;
+        size_t pos = 0;
+        for (size_t nl = text.find('\n'); nl != std::string_view::npos; nl = text.find('\n', pos))
+        {
+            auto line = text.substr(pos, nl - pos);
+            pos = nl + 1;
+            auto j = nlohmann::json::parse(line.begin(), line.end(), nullptr, false);
+            if (!j.is_object())
+                continue;
+
+            Span s;
+            s.trace = j.value("trace", "");
+            s.name = j.value("name", "");
+            s.node = j.value("node", "");
+            s.chunk = j.value("chunk", "");
+            s.ts = j.value("ts", int64_t(0));
+            s.dur = j.value("dur", int64_t(0));
+            s.args = j.contains("args") ? j.at("args") : nlohmann::json::object();
+            if (!s.trace.empty() && !s.name.empty())
+                spans.push_back(std::move(s));
+        }
+    }
+    if (spans.empty())
+        return nullptr;
+
+    std::stable_sort(spans.begin(), spans.end(),
+                     [](const Span& a, const Span& b) { return a.ts < b.ts; });
+
+    nlohmann::json events = nlohmann::json::array();
+
+    // Processes and rows numbered in order of first appearance, so the
+    // coordinator comes first and each node's rows run in dispatch order
+    std::map<std::string, int> pids;
+    std::map<std::pair<int, std::string>, int> tids;
+    for (auto& s : spans)
+    {
+        auto [pit, newNode] = pids.emplace(s.node, int(pids.size()) + 1);
+        s.pid = pit->second;
+        if (newNode)
+        {
+            events.push_back({{"ph", "M"}, {"name", "process_name"}, {"pid", s.pid},
+                              {"args", {{"name", s.node}}}});
+            events.push_back({{"ph", "M"}, {"name", "process_sort_index"}, {"pid", s.pid},
+                              {"args", {{"sort_index", s.pid}}}});
+        }
+
+        auto [tit, newRow] = tids.emplace(std::make_pair(s.pid, s.trace), int(tids.size()) + 1);
+        s.tid = tit->second;
+        if (newRow)
+        {
+            events.push_back({{"ph", "M"}, {"name", "thread_name"}, {"pid", s.pid}, {"tid", s.tid},
+                              {"args", {{"name", "chunk " + s.chunk}}}});
+        }
+    }
+
+    std::map<std::string, const Span*> lastByTrace;
+    uint64_t flowId = 0;
+    for (const auto& s : spans)
+    {
+        nlohmann::json args = s.args;
+        args["trace"] = s.trace;
+        args["chunk"] = s.chunk;
+        events.push_back({
+            {"ph", "X"}, {"cat", "chunk"}, {"name", s.name},
+            {"pid", s.pid}, {"tid", s.tid}, {"ts", s.ts}, {"dur", s.dur},
+            {"args", std::move(args)},
+        });
+
+        // The hop to another node, as a flow arrow between the two slices
+        auto& last = lastByTrace[s.trace];
+        if (last && last->pid != s.pid)
+        {
+            ++flowId;
+            events.push_back({{"ph", "s"}, {"cat", "chunk"}, {"name", "hop"}, {"id", flowId},
+                              {"pid", last->pid}, {"tid", last->tid}, {"ts", last->ts}});
+            events.push_back({{"ph", "f"}, {"bp", "e"}, {"cat", "chunk"}, {"name", "hop"}, {"id", flowId},
+                              {"pid", s.pid}, {"tid", s.tid}, {"ts", s.ts}});
+        }
+        last = &s;
+    }
+
+    return {
+        {"traceEvents", std::move(events)},
+        {"displayTimeUnit", "ms"},
+        {"otherData", {{"job_id", jobId}, {"spans", spans.size()}}},
+    };
+}
+
+} // namespace SR
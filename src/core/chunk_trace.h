@@ -0,0 +1,74 @@
+#pragma once
+
+#include "core/job_types.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace SR {
+
+// Chunk lifecycle tracing. The coordinator mints a trace id per assignment;
+// it rides the assign_chunk command, the agent's task and the agent's
+// replies, and every node records the hops it saw as spans in
+// {farm}/jobs/{id}/trace/{nodeId}.jsonl (one compact JSON span per line).
+// exportJob() merges all nodes' files into Chrome trace JSON for
+// chrome://tracing or Perfetto: a process per node, a row per chunk, and
+// flow arrows where a chunk's next hop is on another node.
+//
+// Timestamps are wall-clock microseconds. A span that starts on one node and
+// ends on another (command propagation) includes the clock offset between them.
+class ChunkTrace
+{
+public:
+    static ChunkTrace& instance();
+
+    void start(const std::filesystem::path& farmPath, const std::string& nodeId);
+    void stop();    // flushes what's buffered
+
+    // Recording is per node (Config::chunk_tracing); trace ids propagate regardless
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    static int64_t nowUs();
+
+    // Thread-safe; buffered until flush(). Ignored while disabled or without
+    // a trace id. endUs before startUs (clock skew) records a zero-length span.
+    void record(const std::string& jobId, const std::string& traceId, const ChunkRange& chunk,
+                const char* name, int64_t startUs, int64_t endUs,
+                const nlohmann::json& args = nlohmann::json::object());
+
+    // Append the buffer, one write per job file. Throttled to FLUSH_INTERVAL_MS
+    // unless forced.
+    void flush(bool force = false);
+
+    // Every node's spans for a job as Chrome trace JSON; null if it has none
+    static nlohmann::json exportJob(const std::filesystem::path& farmPath, const std::string& jobId);
+
+    static constexpr int FLUSH_INTERVAL_MS = 2000;
+    static constexpr size_t MAX_BUFFERED = 20000;   // spans past this are dropped until the next flush
+
+private:
+    ChunkTrace() = default;
+
+    std::filesystem::path m_farmPath;
+    std::string m_nodeId;
+    std::atomic<bool> m_enabled{false};
+
+    std::mutex m_mutex;
+    std::map<std::string, std::string> m_pending;   // job id -> lines to append
+    size_t m_pendingCount = 0;
+    size_t m_dropped = 0;
+    std::set<std::string> m_createdDirs;            // job ids whose trace/ dir exists
+    std::chrono::steady_clock::time_point m_lastFlush{};
+};
+
+} // namespace SR
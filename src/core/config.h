@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <vector>
+#include <map>
 #include <cstdint>
 #include <nlohmann/json.hpp>
 
@@ -49,6 +51,128 @@ inline TimingConfig timingForPreset(TimingPreset p)
     }
 }
 
+// --- Scheduling Policies ---
+
+enum class SchedulingPolicy
+{
+    Priority,           // Strict priority, then submission order (one job drains at a time)
+    FairShare,          // Within a priority, the job with the fewest running chunks goes first
+    FairShareSubmitter  // As FairShare, but balance across submitters before jobs
+};
+
+inline const char* schedulingPolicyName(SchedulingPolicy p)
+{
+    switch (p)
+    {
+        case SchedulingPolicy::Priority:           return "Priority (FIFO)";
+        case SchedulingPolicy::FairShare:          return "Fair share (per job)";
+        case SchedulingPolicy::FairShareSubmitter: return "Fair share (per submitter)";
+    }
+    return "Unknown";
+}
+
+// --- Preemption ---
+
+// Pending work that has waited wait_s without a chunk takes render slots
+// from chunks at least min_priority_gap points lower: the lowest priority,
+// then the most recently started, is aborted and requeued without counting
+// a retry (frames its node already finished are kept). Budgets keep the
+// farm from thrashing.
+struct PreemptionPolicy
+{
+    int wait_s = 0;                 // 0 = off
+    int min_priority_gap = 20;
+    int max_per_cycle = 2;          // chunks preempted per dispatch cycle
+    int max_per_hour = 30;          // farm-wide
+    int node_cooldown_s = 900;      // a preempted node keeps its next chunk at least this long
+
+    bool enabled() const { return wait_s > 0; }
+};
+
+inline void to_json(nlohmann::json& j, const PreemptionPolicy& p)
+{
+    j = nlohmann::json{
+        {"wait_s", p.wait_s},
+        {"min_priority_gap", p.min_priority_gap},
+        {"max_per_cycle", p.max_per_cycle},
+        {"max_per_hour", p.max_per_hour},
+        {"node_cooldown_s", p.node_cooldown_s},
+    };
+}
+
+inline void from_json(const nlohmann::json& j, PreemptionPolicy& p)
+{
+    if (j.contains("wait_s"))           j.at("wait_s").get_to(p.wait_s);
+    if (j.contains("min_priority_gap")) j.at("min_priority_gap").get_to(p.min_priority_gap);
+    if (j.contains("max_per_cycle"))    j.at("max_per_cycle").get_to(p.max_per_cycle);
+    if (j.contains("max_per_hour"))     j.at("max_per_hour").get_to(p.max_per_hour);
+    if (j.contains("node_cooldown_s"))  j.at("node_cooldown_s").get_to(p.node_cooldown_s);
+}
+
+// --- Power management ---
+
+// Coordinator: wake sleeping nodes (Wake-on-LAN to the MAC in their
+// heartbeat) when ready chunks outnumber what the awake nodes will take, one
+// node per wake_pending_chunks; and ask idle nodes that allow it to sleep
+// once the farm's queue is empty and they've been idle for idle_sleep_min.
+struct PowerPolicy
+{
+    bool wake_on_lan = false;
+    int wake_pending_chunks = 4;        // ready chunks left over per node woken
+    int wake_timeout_s = 300;           // not back by then: send again
+    std::string wake_broadcast = "255.255.255.255";
+    int idle_sleep_min = 0;             // 0 = never send sleep
+
+    bool enabled() const { return wake_on_lan || idle_sleep_min > 0; }
+};
+
+inline void to_json(nlohmann::json& j, const PowerPolicy& p)
+{
+    j = nlohmann::json{
+        {"wake_on_lan", p.wake_on_lan},
+        {"wake_pending_chunks", p.wake_pending_chunks},
+        {"wake_timeout_s", p.wake_timeout_s},
+        {"wake_broadcast", p.wake_broadcast},
+        {"idle_sleep_min", p.idle_sleep_min},
+    };
+}
+
+inline void from_json(const nlohmann::json& j, PowerPolicy& p)
+{
+    if (j.contains("wake_on_lan"))         j.at("wake_on_lan").get_to(p.wake_on_lan);
+    if (j.contains("wake_pending_chunks")) j.at("wake_pending_chunks").get_to(p.wake_pending_chunks);
+    if (j.contains("wake_timeout_s"))      j.at("wake_timeout_s").get_to(p.wake_timeout_s);
+    if (j.contains("wake_broadcast"))      j.at("wake_broadcast").get_to(p.wake_broadcast);
+    if (j.contains("idle_sleep_min"))      j.at("idle_sleep_min").get_to(p.idle_sleep_min);
+}
+
+// --- Render Slots ---
+
+// Pinning for one render slot (one sr-agent process). Applied when the agent
+// is spawned and inherited by every render it launches.
+struct RenderSlotPin
+{
+    std::string env;        // "NAME=value" pairs, ';'-separated (e.g. "CUDA_VISIBLE_DEVICES=1")
+    std::string cpu_set;    // logical processors, e.g. "0-15,32-47" (empty = all)
+    int numa_node = -1;     // renders placed on this NUMA node (-1 = template's / any)
+
+    bool empty() const { return env.empty() && cpu_set.empty() && numa_node < 0; }
+};
+
+inline void to_json(nlohmann::json& j, const RenderSlotPin& p)
+{
+    j = nlohmann::json{{"env", p.env}, {"cpu_set", p.cpu_set}, {"numa_node", p.numa_node}};
+}
+
+inline void from_json(const nlohmann::json& j, RenderSlotPin& p)
+{
+    if (j.contains("env"))       j.at("env").get_to(p.env);
+    if (j.contains("cpu_set"))   j.at("cpu_set").get_to(p.cpu_set);
+    if (j.contains("numa_node")) j.at("numa_node").get_to(p.numa_node);
+}
+
+constexpr int MAX_RENDER_SLOTS = 16;
+
 // --- Main Config ---
 
 struct Config
@@ -65,17 +189,60 @@ struct Config
 
     // Coordinator
     bool is_coordinator = false;
+    bool standby_coordinator = false;   // worker that takes over if the coordinator dies
+    bool coordinator_shard = false;     // coordinator sharing the farm with other shards (coordinators.json)
+    int prefetch_depth = 1;     // chunks assigned ahead of a worker's active chunk (0 = off)
+    SchedulingPolicy scheduling_policy = SchedulingPolicy::Priority;
+    bool job_affinity = true;   // keep workers on the job they're warm on (starvation-guarded)
+    PreemptionPolicy preemption;
+    PowerPolicy power;
+    int archive_after_days = 14;    // completed/cancelled jobs move to archive/ after this (0 = never)
+
+    // Sleep when the coordinator asks (idle, nothing queued); advertised in the heartbeat
+    bool allow_remote_sleep = false;
 
     // Agent settings
     bool auto_start_agent = true;
+    int render_slots = 1;                           // concurrent agents (each renders one chunk)
+    std::vector<RenderSlotPin> render_slot_pins;    // by slot index; missing = unpinned
+    std::string render_priority;        // process priority class for renders ("" = per template)
+    bool stdout_compress = true;        // gzip render logs when the chunk ends
+    bool stdout_stage_local = false;    // write logs locally, upload at chunk end (no live tail)
+
+    // Node-local copies of job input files ("file" flags)
+    bool input_cache_enabled = false;
+    int input_cache_gb = 50;            // disk budget, least recently used evicted first
+    std::string input_cache_dir;        // empty = {app data}/input_cache
+
+    // Render into a local dir and upload finished frames in the background
+    bool output_staging = false;
+    std::string output_staging_dir;     // empty = {app data}/output_staging
 
     // UDP multicast fast path
     bool udp_enabled = true;
     uint16_t udp_port = 4242;
 
+    // Direct TCP link between workers and the coordinator (LAN presets only)
+    bool tcp_link_enabled = true;
+    uint16_t tcp_port = 4243;
+
+    // Metrics for external monitoring, rewritten locally every interval:
+    // Prometheus text (textfile collector), or JSON for a ".json" path. Empty = off.
+    std::string metrics_export_path;
+    int metrics_export_interval_sec = 15;
+
+    // Record chunk lifecycle spans in jobs/{id}/trace/ for the job panel's trace export
+    bool chunk_tracing = false;
+
+    // Farm file encodings: class ("heartbeat", "dispatch", "command", "state", "event")
+    // -> "compact" | "pretty" | "cbor" | "msgpack". Unlisted classes write compact JSON.
+    // Binary encodings need every node on a build that can read them.
+    std::map<std::string, std::string> file_encodings;
+
     // UI preferences
     bool show_notifications = true;
     float font_scale = 1.0f;
+    bool low_power_ui = true;           // redraw only on input or farm changes; never while hidden
 };
 
 // JSON serialization
@@ -92,11 +259,37 @@ inline void to_json(nlohmann::json& j, const Config& c)
         }},
         {"tags", c.tags},
         {"is_coordinator", c.is_coordinator},
+        {"standby_coordinator", c.standby_coordinator},
+        {"coordinator_shard", c.coordinator_shard},
+        {"prefetch_depth", c.prefetch_depth},
+        {"scheduling_policy", static_cast<int>(c.scheduling_policy)},
+        {"job_affinity", c.job_affinity},
+        {"preemption", c.preemption},
+        {"power", c.power},
+        {"archive_after_days", c.archive_after_days},
+        {"allow_remote_sleep", c.allow_remote_sleep},
         {"auto_start_agent", c.auto_start_agent},
+        {"render_slots", c.render_slots},
+        {"render_slot_pins", c.render_slot_pins},
+        {"render_priority", c.render_priority},
+        {"stdout_compress", c.stdout_compress},
+        {"stdout_stage_local", c.stdout_stage_local},
+        {"input_cache_enabled", c.input_cache_enabled},
+        {"input_cache_gb", c.input_cache_gb},
+        {"input_cache_dir", c.input_cache_dir},
+        {"output_staging", c.output_staging},
+        {"output_staging_dir", c.output_staging_dir},
         {"udp_enabled", c.udp_enabled},
         {"udp_port", c.udp_port},
+        {"tcp_link_enabled", c.tcp_link_enabled},
+        {"tcp_port", c.tcp_port},
+        {"metrics_export_path", c.metrics_export_path},
+        {"metrics_export_interval_sec", c.metrics_export_interval_sec},
+        {"chunk_tracing", c.chunk_tracing},
+        {"file_encodings", c.file_encodings},
         {"show_notifications", c.show_notifications},
         {"font_scale", c.font_scale},
+        {"low_power_ui", c.low_power_ui},
     };
 }
 
@@ -115,11 +308,59 @@ inline void from_json(const nlohmann::json& j, Config& c)
     }
     if (j.contains("tags"))              j.at("tags").get_to(c.tags);
     if (j.contains("is_coordinator"))   j.at("is_coordinator").get_to(c.is_coordinator);
+    if (j.contains("standby_coordinator")) j.at("standby_coordinator").get_to(c.standby_coordinator);
+    if (j.contains("coordinator_shard")) j.at("coordinator_shard").get_to(c.coordinator_shard);
+    if (j.contains("prefetch_depth"))   j.at("prefetch_depth").get_to(c.prefetch_depth);
+    if (j.contains("scheduling_policy")) c.scheduling_policy = static_cast<SchedulingPolicy>(j.at("scheduling_policy").get<int>());
+    if (j.contains("job_affinity"))     j.at("job_affinity").get_to(c.job_affinity);
+    if (j.contains("preemption") && j.at("preemption").is_object())
+        j.at("preemption").get_to(c.preemption);
+    if (j.contains("power") && j.at("power").is_object())
+        j.at("power").get_to(c.power);
+    if (j.contains("archive_after_days")) j.at("archive_after_days").get_to(c.archive_after_days);
+    if (j.contains("allow_remote_sleep")) j.at("allow_remote_sleep").get_to(c.allow_remote_sleep);
     if (j.contains("auto_start_agent")) j.at("auto_start_agent").get_to(c.auto_start_agent);
+    if (j.contains("render_slots"))     j.at("render_slots").get_to(c.render_slots);
+    if (j.contains("render_slot_pins")) j.at("render_slot_pins").get_to(c.render_slot_pins);
+    if (j.contains("render_priority"))  j.at("render_priority").get_to(c.render_priority);
+    if (j.contains("stdout_compress"))  j.at("stdout_compress").get_to(c.stdout_compress);
+    if (j.contains("stdout_stage_local")) j.at("stdout_stage_local").get_to(c.stdout_stage_local);
+    if (j.contains("input_cache_enabled")) j.at("input_cache_enabled").get_to(c.input_cache_enabled);
+    if (j.contains("input_cache_gb"))    j.at("input_cache_gb").get_to(c.input_cache_gb);
+    if (j.contains("input_cache_dir"))   j.at("input_cache_dir").get_to(c.input_cache_dir);
+    if (j.contains("output_staging"))    j.at("output_staging").get_to(c.output_staging);
+    if (j.contains("output_staging_dir")) j.at("output_staging_dir").get_to(c.output_staging_dir);
     if (j.contains("udp_enabled"))       j.at("udp_enabled").get_to(c.udp_enabled);
     if (j.contains("udp_port"))          c.udp_port = j.at("udp_port").get<uint16_t>();
+    if (j.contains("tcp_link_enabled"))  j.at("tcp_link_enabled").get_to(c.tcp_link_enabled);
+    if (j.contains("tcp_port"))          c.tcp_port = j.at("tcp_port").get<uint16_t>();
+    if (j.contains("metrics_export_path")) j.at("metrics_export_path").get_to(c.metrics_export_path);
+    if (j.contains("metrics_export_interval_sec")) j.at("metrics_export_interval_sec").get_to(c.metrics_export_interval_sec);
+    if (j.contains("chunk_tracing"))     j.at("chunk_tracing").get_to(c.chunk_tracing);
+    if (j.contains("file_encodings"))    j.at("file_encodings").get_to(c.file_encodings);
     if (j.contains("show_notifications")) j.at("show_notifications").get_to(c.show_notifications);
     if (j.contains("font_scale"))         j.at("font_scale").get_to(c.font_scale);
+    if (j.contains("low_power_ui"))       j.at("low_power_ui").get_to(c.low_power_ui);
+}
+
+// Cloud filesystems usually mean nodes that can't reach each other directly
+inline bool tcpLinkActive(const Config& c)
+{
+    return c.tcp_link_enabled && c.timing_preset != TimingPreset::CloudFS;
+}
+
+inline int renderSlotCount(const Config& c)
+{
+    return (std::max)(1, (std::min)(c.render_slots, MAX_RENDER_SLOTS));
+}
+
+// NUMA node per render slot, -1 where the slot leaves it to the template
+inline std::vector<int> slotNumaNodes(const Config& c)
+{
+    std::vector<int> numa;
+    for (const auto& pin : c.render_slot_pins)
+        numa.push_back(pin.numa_node);
+    return numa;
 }
 
 // --- Constants ---
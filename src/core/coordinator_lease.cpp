@@ -0,0 +1,64 @@
+#include "core/coordinator_lease.h"
+#include "core/atomic_file_io.h"
+#include "core/read_cache.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::optional<CoordinatorLease> fromJson(const nlohmann::json& j)
+{
+    if (!j.is_object())
+        return std::nullopt;
+    CoordinatorLease lease;
+    lease.node_id = j.value("node_id", "");
+    lease.epoch = j.value("epoch", uint64_t(0));
+    lease.since_ms = j.value("since_ms", int64_t(0));
+    return lease;
+}
+
+} // namespace
+
+std::optional<CoordinatorLease> CoordinatorLease::read(const fs::path& farmPath)
+{
+    auto data = AtomicFileIO::safeReadJson(farmPath / FILE_NAME);
+    if (!data.has_value())
+        return std::nullopt;
+    return fromJson(data.value());
+}
+
+std::optional<CoordinatorLease> CoordinatorLease::peek(const fs::path& farmPath)
+{
+    auto data = ReadCache::instance().readJson(farmPath / FILE_NAME);
+    if (!data)
+        return std::nullopt;
+    return fromJson(*data);
+}
+
+uint64_t CoordinatorLease::claim(const fs::path& farmPath, const std::string& nodeId,
+                                 uint64_t minEpoch)
+{
+    uint64_t epoch = minEpoch;
+    if (auto current = read(farmPath))
+        epoch = (std::max)(epoch, current->epoch);
+    ++epoch;
+
+    nlohmann::json j = {
+        {"node_id", nodeId},
+        {"epoch", epoch},
+        {"since_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()},
+    };
+    if (!AtomicFileIO::writeJson(farmPath / FILE_NAME, j))
+        return 0;
+
+    ReadCache::instance().invalidate(farmPath / FILE_NAME);
+    return epoch;
+}
+
+} // namespace SR
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace SR {
+
+// Farm-wide coordinator fencing record, {farm}/coordinator.json.
+//
+// Every node that becomes coordinator (configured at start, or a standby
+// taking over) claims the next epoch and advertises it in its heartbeat.
+// A coordinator that finds a higher epoch in the file, or on a live peer,
+// has been superseded: it stops writing dispatch tables and steps down, and
+// workers ignore its commands. Shared filesystems have no compare-and-swap,
+// so two claims racing to the same epoch are settled by the lower node_id.
+struct CoordinatorLease
+{
+    std::string node_id;
+    uint64_t epoch = 0;
+    int64_t since_ms = 0;
+
+    static constexpr const char* FILE_NAME = "coordinator.json";
+
+    // Fresh read (bypasses ReadCache); nullopt if missing or unreadable
+    static std::optional<CoordinatorLease> read(const std::filesystem::path& farmPath);
+
+    // Cached read for periodic fence checks: a stat while the file is unchanged
+    static std::optional<CoordinatorLease> peek(const std::filesystem::path& farmPath);
+
+    // Write max(file epoch, minEpoch) + 1 for nodeId. Returns the epoch, 0 on failure.
+    static uint64_t claim(const std::filesystem::path& farmPath, const std::string& nodeId,
+                          uint64_t minEpoch);
+
+    // (epoch, node_id) ordering used everywhere two coordinators meet
+    static bool outranks(uint64_t epochA, const std::string& nodeA,
+                         uint64_t epochB, const std::string& nodeB)
+    {
+        if (epochA != epochB)
+            return epochA > epochB;
+        return nodeA < nodeB;
+    }
+};
+
+} // namespace SR
@@ -0,0 +1,172 @@
+#include "core/coordinator_shards.h"
+#include "core/atomic_file_io.h"
+#include "core/read_cache.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// FNV-1a over "key\0member", finished with a splitmix64 round so that
+// similar ids (job-001, job-002) still spread evenly
+uint64_t rendezvousWeight(const std::string& key, const std::string& member)
+{
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](unsigned char c) { h ^= c; h *= 1099511628211ull; };
+    for (unsigned char c : key) mix(c);
+    mix(0);
+    for (unsigned char c : member) mix(c);
+
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27; h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return h;
+}
+
+std::string highestWeight(const std::vector<CoordinatorShards::Member>& members, const std::string& key)
+{
+    const CoordinatorShards::Member* best = nullptr;
+    uint64_t bestWeight = 0;
+    for (const auto& m : members)
+    {
+        uint64_t w = rendezvousWeight(key, m.node_id);
+        if (!best || w > bestWeight || (w == bestWeight && m.node_id < best->node_id))
+        {
+            best = &m;
+            bestWeight = w;
+        }
+    }
+    return best ? best->node_id : std::string();
+}
+
+std::optional<CoordinatorShards> fromJson(const nlohmann::json& j)
+{
+    if (!j.is_object())
+        return std::nullopt;
+    try
+    {
+        CoordinatorShards shards;
+        shards.epoch = j.value("epoch", uint64_t(0));
+        if (j.contains("members") && j.at("members").is_array())
+        {
+            for (const auto& e : j.at("members"))
+            {
+                CoordinatorShards::Member m;
+                m.node_id = e.value("node_id", "");
+                m.epoch = e.value("epoch", uint64_t(0));
+                m.since_ms = e.value("since_ms", int64_t(0));
+                if (!m.node_id.empty())
+                    shards.members.push_back(std::move(m));
+            }
+        }
+        std::sort(shards.members.begin(), shards.members.end(),
+                  [](const auto& a, const auto& b) { return a.node_id < b.node_id; });
+        return shards;
+    }
+    catch (const std::exception&)
+    {
+        return std::nullopt;
+    }
+}
+
+bool write(const fs::path& farmPath, const CoordinatorShards& shards)
+{
+    nlohmann::json members = nlohmann::json::array();
+    for (const auto& m : shards.members)
+        members.push_back({{"node_id", m.node_id}, {"epoch", m.epoch}, {"since_ms", m.since_ms}});
+
+    nlohmann::json j = {
+        {"epoch", shards.epoch},
+        {"members", std::move(members)},
+    };
+    if (!AtomicFileIO::writeJson(farmPath / CoordinatorShards::FILE_NAME, j))
+        return false;
+
+    ReadCache::instance().invalidate(farmPath / CoordinatorShards::FILE_NAME);
+    return true;
+}
+
+} // namespace
+
+std::optional<CoordinatorShards> CoordinatorShards::read(const fs::path& farmPath)
+{
+    auto data = AtomicFileIO::safeReadJson(farmPath / FILE_NAME);
+    if (!data.has_value())
+        return std::nullopt;
+    return fromJson(data.value());
+}
+
+std::optional<CoordinatorShards> CoordinatorShards::peek(const fs::path& farmPath)
+{
+    auto data = ReadCache::instance().readJson(farmPath / FILE_NAME);
+    if (!data)
+        return std::nullopt;
+    return fromJson(*data);
+}
+
+uint64_t CoordinatorShards::join(const fs::path& farmPath, const std::string& nodeId,
+                                 uint64_t minEpoch)
+{
+    // Read-modify-write without compare-and-swap: two members joining at once
+    // can drop one another, which the loser sees on its next check and repeats
+    CoordinatorShards shards = read(farmPath).value_or(CoordinatorShards{});
+    shards.epoch = (std::max)(shards.epoch, minEpoch) + 1;
+
+    std::erase_if(shards.members, [&](const Member& m) { return m.node_id == nodeId; });
+    Member self;
+    self.node_id = nodeId;
+    self.epoch = shards.epoch;
+    self.since_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    shards.members.push_back(std::move(self));
+    std::sort(shards.members.begin(), shards.members.end(),
+              [](const auto& a, const auto& b) { return a.node_id < b.node_id; });
+
+    return write(farmPath, shards) ? shards.epoch : 0;
+}
+
+bool CoordinatorShards::leave(const fs::path& farmPath, const std::string& nodeId)
+{
+    auto shards = read(farmPath);
+    if (!shards || !shards->contains(nodeId))
+        return true;
+
+    std::erase_if(shards->members, [&](const Member& m) { return m.node_id == nodeId; });
+    ++shards->epoch;
+    return write(farmPath, *shards);
+}
+
+const CoordinatorShards::Member* CoordinatorShards::find(const std::string& nodeId) const
+{
+    for (const auto& m : members)
+    {
+        if (m.node_id == nodeId)
+            return &m;
+    }
+    return nullptr;
+}
+
+std::string CoordinatorShards::ownerOf(const std::string& jobId) const
+{
+    return highestWeight(members, "job:" + jobId);
+}
+
+std::string CoordinatorShards::homeOf(const std::string& nodeId) const
+{
+    if (contains(nodeId))
+        return nodeId;
+    return highestWeight(members, "node:" + nodeId);
+}
+
+std::string CoordinatorShards::dispatcherFor(const Heartbeat& hb) const
+{
+    if (!hb.work_for.empty() && !contains(hb.node_id) && contains(hb.work_for))
+        return hb.work_for;
+    return homeOf(hb.node_id);
+}
+
+} // namespace SR
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/heartbeat.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace SR {
+
+// Sharded coordinator membership, {farm}/coordinators.json.
+//
+// With coordinator_shard set, several coordinator nodes split the farm
+// instead of one owning it: each job belongs to one member by rendezvous
+// hash of its id, and only that member dispatches it and writes its table.
+// Workers have a home member the same way and are dispatched by it, unless
+// their heartbeat lends them to another member (work_for) whose backlog
+// outlasts their home's. Removing a member moves only its own jobs and
+// workers. Every join or removal bumps the file epoch; a member that finds
+// itself missing rejoins, and owns nothing until it has.
+struct CoordinatorShards
+{
+    struct Member
+    {
+        std::string node_id;
+        uint64_t epoch = 0;         // the file epoch this member joined at
+        int64_t since_ms = 0;
+    };
+
+    uint64_t epoch = 0;
+    std::vector<Member> members;    // sorted by node_id
+
+    static constexpr const char* FILE_NAME = "coordinators.json";
+
+    // Fresh read (bypasses ReadCache); nullopt if missing or unreadable
+    static std::optional<CoordinatorShards> read(const std::filesystem::path& farmPath);
+
+    // Cached read for periodic checks: a stat while the file is unchanged
+    static std::optional<CoordinatorShards> peek(const std::filesystem::path& farmPath);
+
+    // Add (or re-add) nodeId at max(file epoch, minEpoch) + 1. Returns the
+    // member epoch, 0 on failure.
+    static uint64_t join(const std::filesystem::path& farmPath, const std::string& nodeId,
+                         uint64_t minEpoch);
+
+    // Drop nodeId (stopping, or found dead by a peer). True if it's gone.
+    static bool leave(const std::filesystem::path& farmPath, const std::string& nodeId);
+
+    bool isSharded() const { return !members.empty(); }
+    const Member* find(const std::string& nodeId) const;
+    bool contains(const std::string& nodeId) const { return find(nodeId) != nullptr; }
+
+    // Member owning a job's dispatch ("" when there are no members)
+    std::string ownerOf(const std::string& jobId) const;
+
+    // Member doing the farm-wide chores a single coordinator would (the DCC
+    // submission inbox, archiving, state compaction): the lowest node_id
+    std::string primary() const { return members.empty() ? std::string() : members.front().node_id; }
+
+    // Member that dispatches to a node: a member dispatches to itself, a
+    // worker to the member it's lent to (if that's still a member), else home
+    std::string homeOf(const std::string& nodeId) const;
+    std::string dispatcherFor(const Heartbeat& hb) const;
+};
+
+} // namespace SR
@@ -0,0 +1,152 @@
+#include "core/dir_watcher.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#endif
+
+namespace SR {
+
+DirWatcher::~DirWatcher()
+{
+    stop();
+}
+
+#ifdef _WIN32
+
+bool DirWatcher::start(const std::filesystem::path& dir, bool recursive, Callback onChange)
+{
+    stop();
+
+    HANDLE hDir = CreateFileW(
+        dir.c_str(),
+        FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+        nullptr
+    );
+    if (hDir == INVALID_HANDLE_VALUE)
+        return false;
+
+    m_dirHandle = hDir;
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_callback = std::move(onChange);
+    m_active.store(true);
+    m_thread = std::thread(&DirWatcher::threadFunc, this, dir, recursive);
+    return true;
+}
+
+void DirWatcher::stop()
+{
+    if (m_stopEvent)
+        SetEvent(static_cast<HANDLE>(m_stopEvent));
+    if (m_thread.joinable())
+        m_thread.join();
+
+    if (m_dirHandle)
+        CloseHandle(static_cast<HANDLE>(m_dirHandle));
+    if (m_stopEvent)
+        CloseHandle(static_cast<HANDLE>(m_stopEvent));
+    m_dirHandle = nullptr;
+    m_stopEvent = nullptr;
+    m_active.store(false);
+}
+
+void DirWatcher::threadFunc(std::filesystem::path dir, bool recursive)
+{
+    HANDLE hDir = static_cast<HANDLE>(m_dirHandle);
+    HANDLE hStop = static_cast<HANDLE>(m_stopEvent);
+
+    // FILE_NOTIFY_INFORMATION records must be DWORD-aligned
+    std::vector<DWORD> buffer(BUFFER_SIZE / sizeof(DWORD));
+
+    OVERLAPPED ov{};
+    ov.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+    const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                         FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+    while (true)
+    {
+        ResetEvent(ov.hEvent);
+        if (!ReadDirectoryChangesW(hDir, buffer.data(), BUFFER_SIZE, recursive ? TRUE : FALSE,
+                                   filter, nullptr, &ov, nullptr))
+        {
+            std::cerr << "[DirWatcher] ReadDirectoryChangesW failed for " << dir
+                      << ": " << GetLastError() << std::endl;
+            break;
+        }
+
+        HANDLE handles[2] = { ov.hEvent, hStop };
+        DWORD waitResult = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        if (waitResult != WAIT_OBJECT_0)
+        {
+            DWORD ignored = 0;
+            CancelIoEx(hDir, &ov);
+            GetOverlappedResult(hDir, &ov, &ignored, TRUE);
+            break;
+        }
+
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(hDir, &ov, &bytes, FALSE))
+        {
+            DWORD err = GetLastError();
+            if (err == ERROR_NOTIFY_ENUM_DIR)
+            {
+                m_callback({});
+                continue;
+            }
+            // Share went away, handle invalidated, etc. — caller falls back to polling
+            std::cerr << "[DirWatcher] Watch ended for " << dir << ": " << err << std::endl;
+            break;
+        }
+
+        // Zero bytes: the change buffer overflowed and individual events were dropped
+        if (bytes == 0)
+        {
+            m_callback({});
+            continue;
+        }
+
+        auto* base = reinterpret_cast<const uint8_t*>(buffer.data());
+        size_t offset = 0;
+        while (true)
+        {
+            auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(base + offset);
+            std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+            m_callback(std::filesystem::path(name));
+
+            if (info->NextEntryOffset == 0)
+                break;
+            offset += info->NextEntryOffset;
+        }
+    }
+
+    CloseHandle(ov.hEvent);
+    m_active.store(false);
+}
+
+#else
+
+// No inotify / FSEvents backend yet: callers stay on their poll interval
+bool DirWatcher::start(const std::filesystem::path&, bool, Callback)
+{
+    return false;
+}
+
+void DirWatcher::stop()
+{
+    m_active.store(false);
+}
+
+void DirWatcher::threadFunc(std::filesystem::path, bool) {}
+
+#endif
+
+} // namespace SR
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+namespace SR {
+
+// Directory change notifications (ReadDirectoryChangesW on Windows). Used to
+// wake pollers immediately; it is never the only trigger, since sync services
+// and some SMB servers don't deliver events. Other platforms have no backend
+// yet and start() returns false, leaving the caller on plain polling.
+class DirWatcher
+{
+public:
+    // relPath is relative to the watched directory. An empty path means events
+    // were lost (buffer overflow) and the caller should rescan everything.
+    using Callback = std::function<void(const std::filesystem::path& relPath)>;
+
+    DirWatcher() = default;
+    ~DirWatcher();
+
+    DirWatcher(const DirWatcher&) = delete;
+    DirWatcher& operator=(const DirWatcher&) = delete;
+
+    // Callback runs on the watcher's own thread. Returns false if the directory
+    // can't be watched; the caller keeps its normal poll interval then.
+    bool start(const std::filesystem::path& dir, bool recursive, Callback onChange);
+    void stop();
+
+    bool isActive() const { return m_active.load(); }
+
+    // Safety-net poll interval for callers while a watch is active
+    static constexpr int FALLBACK_POLL_MS = 15000;
+
+private:
+    void threadFunc(std::filesystem::path dir, bool recursive);
+
+    Callback m_callback;
+    std::thread m_thread;
+    std::atomic<bool> m_active{false};
+    void* m_dirHandle = nullptr;    // Windows HANDLEs
+    void* m_stopEvent = nullptr;
+
+    static constexpr unsigned BUFFER_SIZE = 64 * 1024;  // network shares cap at 64 KB
+};
+
+} // namespace SR
@@ -0,0 +1,123 @@
+#include "core/dispatch_journal.h"
+#include "core/atomic_file_io.h"
+#include "core/farm_storage.h"
+#include "core/read_cache.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+std::optional<DispatchTable> DispatchJournal::load(const fs::path& jobDir)
+{
+    // Snapshots only change at compaction; finished jobs' never do
+    auto snapshot = ReadCache::instance().read<DispatchTable>(jobDir / "dispatch.json");
+    if (!snapshot)
+        return std::nullopt;
+
+    DispatchTable dt = *snapshot;
+
+    std::sort(dt.chunks.begin(), dt.chunks.end(),
+        [](const DispatchChunk& a, const DispatchChunk& b) { return a.frame_start < b.frame_start; });
+
+    auto journal = FarmStorage::current().read(jobDir / "dispatch.journal");
+    if (!journal)
+        return dt;
+
+    std::istringstream lines(*journal);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (line.empty())
+            continue;
+
+        // A torn last line (writer mid-append or sync in progress) just gets skipped
+        auto j = nlohmann::json::parse(line, nullptr, false);
+        if (j.is_discarded() || !j.is_object())
+            continue;
+
+        uint64_t seq = j.value("seq", uint64_t(0));
+        if (seq <= dt.journal_seq)
+            continue;
+
+        try
+        {
+            applyRecord(dt, j.get<DispatchChunk>());
+            dt.journal_seq = seq;
+        }
+        catch (...) {}
+    }
+
+    return dt;
+}
+
+bool DispatchJournal::append(const fs::path& jobDir,
+                             const std::vector<DispatchChunk>& chunks, uint64_t& nextSeq)
+{
+    if (chunks.empty())
+        return true;
+
+    // Build the whole batch first so it lands in a single write
+    std::string batch;
+    uint64_t seq = nextSeq;
+    for (const auto& chunk : chunks)
+    {
+        nlohmann::json j = chunk;
+        j["seq"] = seq++;
+        batch += j.dump();
+        batch += '\n';
+    }
+
+    if (!FarmStorage::current().append(jobDir / "dispatch.journal", batch))
+        return false;
+
+    nextSeq = seq;
+    return true;
+}
+
+bool DispatchJournal::writeSnapshot(const fs::path& jobDir, const DispatchTable& dt)
+{
+    nlohmann::json j = dt;
+    if (!AtomicFileIO::writeJson(jobDir / "dispatch.json", j, FileClass::Dispatch))
+        return false;
+
+    // Snapshot is durable; anything left in the journal is now <= journal_seq
+    FarmStorage::current().writeAtomic(jobDir / "dispatch.journal", {});
+    return true;
+}
+
+void DispatchJournal::applyRecord(DispatchTable& dt, const DispatchChunk& rec)
+{
+    auto& chunks = dt.chunks;
+
+    // First chunk that ends at or after the record's start
+    auto first = std::lower_bound(chunks.begin(), chunks.end(), rec.frame_start,
+        [](const DispatchChunk& c, int frame) { return c.frame_end < frame; });
+
+    auto last = first;
+    while (last != chunks.end() && last->frame_start <= rec.frame_end)
+        ++last;
+
+    // Keep the parts of overlapped chunks that fall outside the record
+    std::vector<DispatchChunk> replacement;
+    if (first != last && first->frame_start < rec.frame_start)
+    {
+        DispatchChunk left = *first;
+        left.frame_end = rec.frame_start - 1;
+        replacement.push_back(left);
+    }
+    replacement.push_back(rec);
+    if (first != last && std::prev(last)->frame_end > rec.frame_end)
+    {
+        DispatchChunk right = *std::prev(last);
+        right.frame_start = rec.frame_end + 1;
+        replacement.push_back(right);
+    }
+
+    auto pos = chunks.erase(first, last);
+    chunks.insert(pos, replacement.begin(), replacement.end());
+}
+
+} // namespace SR
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "core/job_types.h"
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace SR {
+
+// Journaled storage for a job's dispatch table, under jobs/{id}/:
+//   dispatch.json     — snapshot (DispatchTable schema; journal_seq = last record folded in)
+//   dispatch.journal  — append-only, one compact JSON chunk record per line
+//
+// A record replaces whatever its frame range overlaps (trimming partial
+// overlaps), so split/merged adaptive ranges replay correctly. Records with
+// seq <= the snapshot's journal_seq are leftovers from before a compaction.
+class DispatchJournal
+{
+public:
+    // Snapshot + journal replay. Returns nullopt if there is no readable snapshot.
+    static std::optional<DispatchTable> load(const std::filesystem::path& jobDir);
+
+    // Append chunk records, numbering them from nextSeq (advanced past the last one written)
+    static bool append(const std::filesystem::path& jobDir,
+                       const std::vector<DispatchChunk>& chunks, uint64_t& nextSeq);
+
+    // Compaction: write the full snapshot atomically, then truncate the journal
+    static bool writeSnapshot(const std::filesystem::path& jobDir, const DispatchTable& dt);
+
+    // Apply one record to a table whose chunks are sorted by frame_start
+    static void applyRecord(DispatchTable& dt, const DispatchChunk& rec);
+};
+
+} // namespace SR
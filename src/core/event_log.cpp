@@ -0,0 +1,194 @@
+#include "core/event_log.h"
+#include "core/atomic_file_io.h"
+#include "core/farm_storage.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Scan a segment from offset; calls fn per complete line. Returns bytes consumed
+// (up to and including the last newline).
+uint64_t scanLines(const fs::path& path, uint64_t offset,
+                   const std::function<void(const std::string&)>& fn)
+{
+    auto read = FarmStorage::current().read(path, offset);
+    if (!read || read->empty())
+        return 0;
+    const std::string& data = *read;
+
+    uint64_t consumed = 0;
+    size_t start = 0;
+    while (true)
+    {
+        auto nl = data.find('\n', start);
+        if (nl == std::string::npos)
+            break;
+        if (nl > start)
+            fn(data.substr(start, nl - start));
+        start = nl + 1;
+        consumed = start;
+    }
+    return consumed;
+}
+
+} // namespace
+
+// ─── Writer ─────────────────────────────────────────────────────────────────
+
+EventLogWriter::~EventLogWriter()
+{
+    close();
+}
+
+bool EventLogWriter::open(const fs::path& dir)
+{
+    close();
+
+    FarmStorage::current().createDirectories(dir);
+    m_dir = dir;
+    m_segment = 0;
+    m_seq = 0;
+
+    EventLogCursor cursor;
+    if (auto data = AtomicFileIO::safeReadJson(dir / "cursor.json"))
+    {
+        cursor.segment = data->value("segment", 0u);
+        cursor.offset = data->value("offset", uint64_t(0));
+        m_seq = data->value("seq", uint64_t(0));
+    }
+
+    // Anything appended after the checkpoint (crash, or no clean close)
+    EventLogReader::readSince(dir, cursor, [this](const nlohmann::json& ev) {
+        m_seq = std::max(m_seq, ev.value("seq", uint64_t(0)));
+    });
+
+    // readSince stops at the last existing segment
+    return openSegment(cursor.segment);
+}
+
+void EventLogWriter::close()
+{
+    if (!m_open)
+        return;
+
+    m_open = false;
+    writeCursor();
+}
+
+uint64_t EventLogWriter::append(nlohmann::json& event)
+{
+    if (!m_open)
+        return 0;
+
+    if (m_segmentBytes >= SEGMENT_MAX_BYTES)
+    {
+        m_open = false;
+        writeCursor();
+        if (!openSegment(m_segment + 1))
+            return 0;
+    }
+
+    event["seq"] = ++m_seq;
+    std::string line = event.dump();
+    line += '\n';
+
+    // One write per event so a reader sees either nothing or the whole line
+    if (!FarmStorage::current().append(m_segmentPath, line))
+    {
+        std::cerr << "[EventLog] Append failed in " << m_dir << std::endl;
+        return 0;
+    }
+
+    m_segmentBytes += line.size();
+    return m_seq;
+}
+
+bool EventLogWriter::openSegment(uint32_t segment)
+{
+    auto& storage = FarmStorage::current();
+    auto path = EventLogReader::segmentPath(m_dir, segment);
+    uint64_t size = storage.stat(path).size;
+
+    // A torn last line (crash mid-write) must not swallow the next event
+    if (size > 0)
+    {
+        auto last = storage.read(path, size - 1);
+        if (last && !last->empty() && last->back() != '\n')
+        {
+            if (!storage.append(path, "\n"))
+            {
+                std::cerr << "[EventLog] Failed to open segment: " << path << std::endl;
+                return false;
+            }
+            ++size;
+        }
+    }
+
+    m_segmentPath = path;
+    m_open = true;
+    m_segment = segment;
+    m_segmentBytes = size;
+    return true;
+}
+
+void EventLogWriter::writeCursor()
+{
+    nlohmann::json j = {
+        {"_version", 1},
+        {"segment", m_segment},
+        {"offset", m_segmentBytes},
+        {"seq", m_seq},
+    };
+    AtomicFileIO::writeJson(m_dir / "cursor.json", j, FileClass::Event);
+}
+
+// ─── Reader ─────────────────────────────────────────────────────────────────
+
+fs::path EventLogReader::segmentPath(const fs::path& dir, uint32_t segment)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "events-%06u.jsonl", segment);
+    return dir / name;
+}
+
+bool EventLogReader::exists(const fs::path& dir)
+{
+    return FarmStorage::current().exists(segmentPath(dir, 0));
+}
+
+size_t EventLogReader::readSince(const fs::path& dir, EventLogCursor& cursor,
+                                 const std::function<void(const nlohmann::json&)>& fn)
+{
+    size_t delivered = 0;
+    auto onLine = [&](const std::string& line) {
+        auto j = nlohmann::json::parse(line, nullptr, false);
+        if (j.is_discarded() || !j.is_object())
+            return;
+        fn(j);
+        ++delivered;
+    };
+
+    while (true)
+    {
+        cursor.offset += scanLines(segmentPath(dir, cursor.segment), cursor.offset, onLine);
+
+        // The writer only rolls after finishing a segment, so once the next one
+        // exists this one is final
+        if (!FarmStorage::current().exists(segmentPath(dir, cursor.segment + 1)))
+            break;
+
+        // Pick up whatever landed between the scan and the check
+        cursor.offset += scanLines(segmentPath(dir, cursor.segment), cursor.offset, onLine);
+        ++cursor.segment;
+        cursor.offset = 0;
+    }
+    return delivered;
+}
+
+} // namespace SR
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+namespace SR {
+
+// Append-only event log for one node in one job: jobs/{id}/events/{nodeId}/
+//   events-000000.jsonl, events-000001.jsonl, ...  — one compact JSON event per line
+//   cursor.json                                     — {segment, offset, seq} checkpoint
+//
+// Segments roll at SEGMENT_MAX_BYTES. Only the owning node writes; readers
+// keep an EventLogCursor and pick up from its byte offset. A line without its
+// trailing newline is still being written (or synced) and is left for later.
+struct EventLogCursor
+{
+    uint32_t segment = 0;
+    uint64_t offset = 0;        // bytes consumed in that segment
+};
+
+class EventLogWriter
+{
+public:
+    EventLogWriter() = default;
+    ~EventLogWriter();
+
+    EventLogWriter(const EventLogWriter&) = delete;
+    EventLogWriter& operator=(const EventLogWriter&) = delete;
+
+    // Open (or reopen) the log in dir, recovering the sequence number from the
+    // cursor checkpoint plus whatever was appended after it
+    bool open(const std::filesystem::path& dir);
+    void close();
+
+    bool isOpen() const { return m_open; }
+    const std::filesystem::path& dir() const { return m_dir; }
+
+    // Stamps event["seq"] and appends it. Returns the seq, or 0 on failure.
+    uint64_t append(nlohmann::json& event);
+
+    static constexpr uint64_t SEGMENT_MAX_BYTES = 1024 * 1024;
+
+private:
+    bool openSegment(uint32_t segment);
+    void writeCursor();
+
+    std::filesystem::path m_dir;
+    std::filesystem::path m_segmentPath;
+    bool m_open = false;
+    uint32_t m_segment = 0;
+    uint64_t m_segmentBytes = 0;
+    uint64_t m_seq = 0;
+};
+
+class EventLogReader
+{
+public:
+    static std::filesystem::path segmentPath(const std::filesystem::path& dir, uint32_t segment);
+
+    // Does dir hold a segmented log (as opposed to legacy one-file-per-event)?
+    static bool exists(const std::filesystem::path& dir);
+
+    // Deliver every complete event after cursor, advancing it (across segment
+    // rolls). Returns the number of events delivered.
+    static size_t readSince(const std::filesystem::path& dir, EventLogCursor& cursor,
+                            const std::function<void(const nlohmann::json&)>& fn);
+};
+
+} // namespace SR
@@ -0,0 +1,662 @@
+#include "core/farm_storage.h"
+#include "core/dir_watcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+// ─── Installed backend ──────────────────────────────────────────────────────
+
+namespace {
+
+std::mutex s_installMutex;
+std::shared_ptr<FarmStorage> s_storage;
+std::vector<std::shared_ptr<FarmStorage>> s_retired;    // references handed out stay valid
+std::atomic<FarmStorage*> s_current{nullptr};
+
+// Flush file buffers to disk (Windows: FlushFileBuffers)
+void flushToDisk(const fs::path& path)
+{
+#ifdef _WIN32
+    HANDLE hFile = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        0,
+        nullptr
+    );
+
+    if (hFile != INVALID_HANDLE_VALUE)
+    {
+        if (!FlushFileBuffers(hFile))
+        {
+            std::cerr << "[FarmStorage] Warning: FlushFileBuffers failed" << std::endl;
+        }
+        CloseHandle(hFile);
+    }
+#else
+    (void)path;     // On Linux/macOS, fsync would go here
+#endif
+}
+
+} // namespace
+
+FarmStorage& FarmStorage::current()
+{
+    if (auto* s = s_current.load(std::memory_order_acquire))
+        return *s;
+
+    std::lock_guard<std::mutex> lock(s_installMutex);
+    if (!s_storage)
+    {
+        s_storage = std::make_shared<LocalStorage>();
+        s_current.store(s_storage.get(), std::memory_order_release);
+    }
+    return *s_storage;
+}
+
+void FarmStorage::install(std::shared_ptr<FarmStorage> storage)
+{
+    if (!storage)
+        storage = std::make_shared<LocalStorage>();
+
+    std::lock_guard<std::mutex> lock(s_installMutex);
+    if (s_storage)
+        s_retired.push_back(std::move(s_storage));
+    s_storage = std::move(storage);
+    s_current.store(s_storage.get(), std::memory_order_release);
+}
+
+// ─── LocalStorage ───────────────────────────────────────────────────────────
+
+std::optional<std::string> LocalStorage::read(const fs::path& path, uint64_t offset)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return std::nullopt;
+
+    file.seekg(0, std::ios::end);
+    auto size = static_cast<uint64_t>(file.tellg());
+    if (!file.good())
+        return std::nullopt;
+    if (size <= offset)
+        return std::string();
+
+    std::string data(size - offset, '\0');
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(data.data(), static_cast<std::streamsize>(data.size()));
+    data.resize(static_cast<size_t>(file.gcount()));
+    return data;
+}
+
+bool LocalStorage::writeAtomic(const fs::path& path, std::string_view bytes)
+{
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+
+    try
+    {
+        std::ofstream file(tmpPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            std::cerr << "[FarmStorage] Failed to open temp file: " << tmpPath << std::endl;
+            return false;
+        }
+
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        file.flush();
+        if (!file.good())
+        {
+            std::cerr << "[FarmStorage] Write failed for: " << tmpPath << std::endl;
+            file.close();
+            std::error_code ec;
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+        file.close();
+
+        flushToDisk(tmpPath);
+        fs::rename(tmpPath, path);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[FarmStorage] writeAtomic error: " << e.what() << std::endl;
+        std::error_code ec;
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+}
+
+bool LocalStorage::append(const fs::path& path, std::string_view bytes)
+{
+    std::ofstream file(path, std::ios::app | std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.flush();
+    return file.good();
+}
+
+bool LocalStorage::rename(const fs::path& from, const fs::path& to, std::error_code& ec)
+{
+    fs::rename(from, to, ec);
+    return !ec;
+}
+
+bool LocalStorage::remove(const fs::path& path)
+{
+    std::error_code ec;
+    return fs::remove(path, ec);
+}
+
+bool LocalStorage::removeAll(const fs::path& path)
+{
+    std::error_code ec;
+    fs::remove_all(path, ec);
+    return !ec;
+}
+
+bool LocalStorage::createDirectories(const fs::path& dir)
+{
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    return !ec;
+}
+
+StorageStat LocalStorage::stat(const fs::path& path)
+{
+    StorageStat out;
+#ifdef _WIN32
+    // Attribute query only — no handle, so one round-trip on SMB
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data))
+        return out;
+
+    out.exists = true;
+    out.isDir = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    out.size = (uint64_t(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    // FILETIME ticks, the same clock as MSVC's file_time_type
+    out.mtime = int64_t((uint64_t(data.ftLastWriteTime.dwHighDateTime) << 32)
+                        | data.ftLastWriteTime.dwLowDateTime);
+    // The file ID needs an open handle; creation time changes on every
+    // tmp+rename write and is free here, so it stands in
+    out.fileId = (uint64_t(data.ftCreationTime.dwHighDateTime) << 32)
+                 | data.ftCreationTime.dwLowDateTime;
+#else
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0)
+        return out;
+
+    out.exists = true;
+    out.isDir = S_ISDIR(st.st_mode);
+    out.size = uint64_t(st.st_size);
+#ifdef __APPLE__
+    out.mtime = int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    out.mtime = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    out.fileId = uint64_t(st.st_ino);
+#endif
+    return out;
+}
+
+std::vector<StorageEntry> LocalStorage::list(const fs::path& dir)
+{
+    std::vector<StorageEntry> out;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec))
+    {
+        std::error_code tec;
+        out.push_back({entry.path().filename().string(), entry.is_directory(tec)});
+    }
+    return out;
+}
+
+namespace {
+
+class LocalWatch : public FarmStorage::Watch
+{
+public:
+    bool start(const fs::path& dir, bool recursive, FarmStorage::WatchCallback onChange)
+    {
+        return m_watcher.start(dir, recursive, std::move(onChange));
+    }
+    bool isActive() const override { return m_watcher.isActive(); }
+
+private:
+    DirWatcher m_watcher;
+};
+
+} // namespace
+
+std::unique_ptr<FarmStorage::Watch> LocalStorage::watch(const fs::path& dir, bool recursive,
+                                                        WatchCallback onChange)
+{
+    auto w = std::make_unique<LocalWatch>();
+    if (!w->start(dir, recursive, std::move(onChange)))
+        return nullptr;
+    return w;
+}
+
+// ─── MemoryStorage ──────────────────────────────────────────────────────────
+
+struct MemoryStorage::Watcher
+{
+    std::string dir;        // key, with trailing '/'
+    bool recursive = false;
+    WatchCallback callback;
+    std::atomic<bool> active{true};
+};
+
+class MemoryStorage::MemoryWatch : public FarmStorage::Watch
+{
+public:
+    MemoryWatch(MemoryStorage& owner, std::shared_ptr<Watcher> w) : m_owner(owner), m_watcher(std::move(w)) {}
+    ~MemoryWatch() override
+    {
+        m_watcher->active.store(false);
+        std::lock_guard<std::mutex> lock(m_owner.m_watchMutex);
+        std::erase(m_owner.m_watchers, m_watcher);
+    }
+    bool isActive() const override { return true; }
+
+private:
+    MemoryStorage& m_owner;
+    std::shared_ptr<Watcher> m_watcher;
+};
+
+std::string MemoryStorage::key(const fs::path& path)
+{
+    auto k = path.lexically_normal().generic_string();
+    while (k.size() > 1 && k.back() == '/')
+        k.pop_back();
+    return k;
+}
+
+void MemoryStorage::ensureParentsLocked(const std::string& k)
+{
+    for (auto pos = k.rfind('/'); pos != std::string::npos && pos > 0; pos = k.rfind('/', pos - 1))
+    {
+        auto& n = m_nodes[k.substr(0, pos)];
+        if (n.isDir)
+            break;      // the rest of the chain exists already
+        n.isDir = true;
+        n.mtime = m_clock;
+    }
+}
+
+void MemoryStorage::touchLocked(const std::string& k)
+{
+    ++m_clock;
+    auto pos = k.rfind('/');
+    if (pos != std::string::npos && pos > 0)
+    {
+        auto it = m_nodes.find(k.substr(0, pos));
+        if (it != m_nodes.end())
+            it->second.mtime = m_clock;
+    }
+}
+
+void MemoryStorage::notify(const std::string& k)
+{
+    std::vector<std::shared_ptr<Watcher>> hits;
+    {
+        std::lock_guard<std::mutex> lock(m_watchMutex);
+        for (const auto& w : m_watchers)
+        {
+            if (k.compare(0, w->dir.size(), w->dir) != 0)
+                continue;
+            if (!w->recursive && k.find('/', w->dir.size()) != std::string::npos)
+                continue;
+            hits.push_back(w);
+        }
+    }
+    for (const auto& w : hits)
+    {
+        if (w->active.load())
+            w->callback(fs::path(k.substr(w->dir.size())));
+    }
+}
+
+std::optional<std::string> MemoryStorage::read(const fs::path& path, uint64_t offset)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_nodes.find(key(path));
+    if (it == m_nodes.end() || it->second.isDir)
+        return std::nullopt;
+    const auto& data = it->second.data;
+    if (offset >= data.size())
+        return std::string();
+    return data.substr(size_t(offset));
+}
+
+bool MemoryStorage::writeAtomic(const fs::path& path, std::string_view bytes)
+{
+    auto k = key(path);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& n = m_nodes[k];
+        if (n.isDir)
+            return false;
+        ensureParentsLocked(k);
+        touchLocked(k);
+        n.data.assign(bytes);
+        n.mtime = m_clock;
+        n.fileId = m_nextId++;
+    }
+    notify(k);
+    return true;
+}
+
+bool MemoryStorage::append(const fs::path& path, std::string_view bytes)
+{
+    auto k = key(path);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& n = m_nodes[k];
+        if (n.isDir)
+            return false;
+        ensureParentsLocked(k);
+        touchLocked(k);
+        if (n.fileId == 0)
+            n.fileId = m_nextId++;
+        n.data.append(bytes);
+        n.mtime = m_clock;
+    }
+    notify(k);
+    return true;
+}
+
+bool MemoryStorage::rename(const fs::path& from, const fs::path& to, std::error_code& ec)
+{
+    auto src = key(from);
+    auto dst = key(to);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_nodes.find(src);
+        if (it == m_nodes.end())
+        {
+            ec = std::make_error_code(std::errc::no_such_file_or_directory);
+            return false;
+        }
+
+        // Move the node and, for a directory, everything under it
+        std::vector<std::pair<std::string, Node>> moved;
+        auto prefix = src + "/";
+        moved.emplace_back(dst, std::move(it->second));
+        m_nodes.erase(it);
+        for (auto c = m_nodes.lower_bound(prefix); c != m_nodes.end() && c->first.compare(0, prefix.size(), prefix) == 0; )
+        {
+            moved.emplace_back(dst + c->first.substr(src.size()), std::move(c->second));
+            c = m_nodes.erase(c);
+        }
+
+        touchLocked(src);
+        ensureParentsLocked(dst);
+        touchLocked(dst);
+        for (auto& [k, n] : moved)
+            m_nodes[k] = std::move(n);
+    }
+    ec.clear();
+    notify(src);
+    notify(dst);
+    return true;
+}
+
+bool MemoryStorage::remove(const fs::path& path)
+{
+    auto k = key(path);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_nodes.find(k);
+        if (it == m_nodes.end())
+            return false;
+        auto next = std::next(it);
+        if (it->second.isDir && next != m_nodes.end() && next->first.compare(0, k.size() + 1, k + "/") == 0)
+            return false;       // not empty
+        m_nodes.erase(it);
+        touchLocked(k);
+    }
+    notify(k);
+    return true;
+}
+
+bool MemoryStorage::removeAll(const fs::path& path)
+{
+    auto k = key(path);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto prefix = k + "/";
+        m_nodes.erase(k);
+        auto first = m_nodes.lower_bound(prefix);
+        auto last = first;
+        while (last != m_nodes.end() && last->first.compare(0, prefix.size(), prefix) == 0)
+            ++last;
+        m_nodes.erase(first, last);
+        touchLocked(k);
+    }
+    notify(k);
+    return true;
+}
+
+bool MemoryStorage::createDirectories(const fs::path& dir)
+{
+    auto k = key(dir);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& n = m_nodes[k];
+    if (!n.isDir && (n.fileId != 0 || !n.data.empty()))
+        return false;   // a file is in the way
+    if (!n.isDir)
+    {
+        n.isDir = true;
+        ensureParentsLocked(k);
+        touchLocked(k);
+        n.mtime = m_clock;
+    }
+    return true;
+}
+
+StorageStat MemoryStorage::stat(const fs::path& path)
+{
+    StorageStat out;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_nodes.find(key(path));
+    if (it == m_nodes.end())
+        return out;
+    out.exists = true;
+    out.isDir = it->second.isDir;
+    out.size = it->second.data.size();
+    out.mtime = it->second.mtime;
+    out.fileId = it->second.fileId;
+    return out;
+}
+
+std::vector<StorageEntry> MemoryStorage::list(const fs::path& dir)
+{
+    std::vector<StorageEntry> out;
+    auto prefix = key(dir) + "/";
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_nodes.lower_bound(prefix);
+         it != m_nodes.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+    {
+        auto rest = std::string_view(it->first).substr(prefix.size());
+        if (rest.find('/') != std::string_view::npos)
+            continue;   // grandchild
+        out.push_back({std::string(rest), it->second.isDir});
+    }
+    return out;
+}
+
+std::unique_ptr<FarmStorage::Watch> MemoryStorage::watch(const fs::path& dir, bool recursive,
+                                                         WatchCallback onChange)
+{
+    auto w = std::make_shared<Watcher>();
+    w->dir = key(dir) + "/";
+    w->recursive = recursive;
+    w->callback = std::move(onChange);
+    {
+        std::lock_guard<std::mutex> lock(m_watchMutex);
+        m_watchers.push_back(w);
+    }
+    return std::make_unique<MemoryWatch>(*this, std::move(w));
+}
+
+uint64_t MemoryStorage::totalBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t total = 0;
+    for (const auto& [k, n] : m_nodes)
+        total += n.data.size();
+    return total;
+}
+
+// ─── LatencyStorage ─────────────────────────────────────────────────────────
+
+LatencyStorage::LatencyStorage(std::shared_ptr<FarmStorage> inner, Profile profile)
+    : m_inner(std::move(inner)), m_profile(profile)
+{
+}
+
+void LatencyStorage::setProfile(const Profile& profile)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_profile = profile;
+}
+
+LatencyStorage::Profile LatencyStorage::profile() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_profile;
+}
+
+void LatencyStorage::setDelayFn(DelayFn fn)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_delayFn = std::move(fn);
+}
+
+const char* LatencyStorage::opName(Op op)
+{
+    switch (op)
+    {
+        case Op::Read:   return "read";
+        case Op::Write:  return "write";
+        case Op::Append: return "append";
+        case Op::Rename: return "rename";
+        case Op::Remove: return "remove";
+        case Op::Mkdir:  return "mkdir";
+        case Op::Stat:   return "stat";
+        case Op::List:   return "list";
+        case Op::Count:  break;
+    }
+    return "?";
+}
+
+void LatencyStorage::delay(Op op)
+{
+    double ms = 0.0;
+    DelayFn fn;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        switch (op)
+        {
+            case Op::Read:   ms = m_profile.readMs; break;
+            case Op::Write:
+            case Op::Append: ms = m_profile.writeMs; break;
+            default:         ms = m_profile.metaMs; break;
+        }
+        if (m_profile.jitterMs > 0.0)
+            ms += std::uniform_real_distribution<double>(0.0, m_profile.jitterMs)(m_rng);
+        fn = m_delayFn;
+    }
+
+    m_counts[size_t(op)].fetch_add(1, std::memory_order_relaxed);
+    m_delayUs[size_t(op)].fetch_add(uint64_t(ms * 1000.0), std::memory_order_relaxed);
+    if (ms <= 0.0)
+        return;
+    if (fn)
+        fn(ms);
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(int64_t(ms * 1000.0)));
+}
+
+std::optional<std::string> LatencyStorage::read(const fs::path& path, uint64_t offset)
+{
+    delay(Op::Read);
+    return m_inner->read(path, offset);
+}
+
+bool LatencyStorage::writeAtomic(const fs::path& path, std::string_view bytes)
+{
+    delay(Op::Write);
+    return m_inner->writeAtomic(path, bytes);
+}
+
+bool LatencyStorage::append(const fs::path& path, std::string_view bytes)
+{
+    delay(Op::Append);
+    return m_inner->append(path, bytes);
+}
+
+bool LatencyStorage::rename(const fs::path& from, const fs::path& to, std::error_code& ec)
+{
+    delay(Op::Rename);
+    return m_inner->rename(from, to, ec);
+}
+
+bool LatencyStorage::remove(const fs::path& path)
+{
+    delay(Op::Remove);
+    return m_inner->remove(path);
+}
+
+bool LatencyStorage::removeAll(const fs::path& path)
+{
+    delay(Op::Remove);
+    return m_inner->removeAll(path);
+}
+
+bool LatencyStorage::createDirectories(const fs::path& dir)
+{
+    delay(Op::Mkdir);
+    return m_inner->createDirectories(dir);
+}
+
+StorageStat LatencyStorage::stat(const fs::path& path)
+{
+    delay(Op::Stat);
+    return m_inner->stat(path);
+}
+
+std::vector<StorageEntry> LatencyStorage::list(const fs::path& dir)
+{
+    delay(Op::List);
+    return m_inner->list(dir);
+}
+
+std::unique_ptr<FarmStorage::Watch> LatencyStorage::watch(const fs::path& dir, bool recursive,
+                                                          WatchCallback onChange)
+{
+    // Notifications arrive when they arrive; only the ops they trigger pay
+    return m_inner->watch(dir, recursive, std::move(onChange));
+}
+
+} // namespace SR
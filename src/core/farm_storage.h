@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace SR {
+
+// Farm share I/O. Everything the managers do to {farm}/ (jobs, nodes,
+// commands, submissions, templates, archive) goes through the installed
+// backend, so the share can be swapped for an in-memory tree in the
+// simulator or wrapped to inject latency. AtomicFileIO and ReadCache sit on
+// top of it, so the few app-data files they handle ride along. Streamed
+// render logs (StdoutWriter), local caches, staging and render output stay
+// on std::filesystem.
+//
+// Paths are the same absolute paths the managers already build from
+// m_farmPath; a backend decides what they mean.
+struct StorageStat
+{
+    bool exists = false;
+    bool isDir = false;
+    uint64_t size = 0;
+    int64_t mtime = 0;          // backend ticks; compare only against the same backend
+    uint64_t fileId = 0;        // changes on every tmp+rename write; 0 where unknown
+};
+
+struct StorageEntry
+{
+    std::string name;           // filename only
+    bool isDir = false;
+};
+
+class FarmStorage
+{
+public:
+    virtual ~FarmStorage() = default;
+
+    // Whole file, or from offset to the end. nullopt if missing or unreadable.
+    virtual std::optional<std::string> read(const std::filesystem::path& path, uint64_t offset = 0) = 0;
+
+    // Write .tmp, flush, rename over path, so readers see old or new, never half
+    virtual bool writeAtomic(const std::filesystem::path& path, std::string_view bytes) = 0;
+
+    // Append in a single write (journals and event logs: one writer per file)
+    virtual bool append(const std::filesystem::path& path, std::string_view bytes) = 0;
+
+    virtual bool rename(const std::filesystem::path& from, const std::filesystem::path& to,
+                        std::error_code& ec) = 0;
+    virtual bool remove(const std::filesystem::path& path) = 0;
+    virtual bool removeAll(const std::filesystem::path& path) = 0;
+    virtual bool createDirectories(const std::filesystem::path& dir) = 0;
+
+    virtual StorageStat stat(const std::filesystem::path& path) = 0;
+
+    // Immediate children; empty if dir is missing
+    virtual std::vector<StorageEntry> list(const std::filesystem::path& dir) = 0;
+
+    // Change notifications (see DirWatcher for the contract). nullptr if the
+    // backend can't watch dir; the caller polls at its normal interval then.
+    class Watch
+    {
+    public:
+        virtual ~Watch() = default;
+        virtual bool isActive() const = 0;
+    };
+    using WatchCallback = std::function<void(const std::filesystem::path& relPath)>;
+    virtual std::unique_ptr<Watch> watch(const std::filesystem::path& dir, bool recursive,
+                                         WatchCallback onChange) = 0;
+
+    bool exists(const std::filesystem::path& path) { return stat(path).exists; }
+    bool isDirectory(const std::filesystem::path& path) { return stat(path).isDir; }
+
+    // Process-wide backend; LocalStorage until something else is installed.
+    // Install before any manager starts: a swap isn't synchronized with I/O
+    // already in flight on other threads.
+    static FarmStorage& current();
+    static void install(std::shared_ptr<FarmStorage> storage);
+};
+
+// The share as a mounted path (local disk, SMB, a sync client's folder)
+class LocalStorage : public FarmStorage
+{
+public:
+    std::optional<std::string> read(const std::filesystem::path& path, uint64_t offset = 0) override;
+    bool writeAtomic(const std::filesystem::path& path, std::string_view bytes) override;
+    bool append(const std::filesystem::path& path, std::string_view bytes) override;
+    bool rename(const std::filesystem::path& from, const std::filesystem::path& to,
+                std::error_code& ec) override;
+    bool remove(const std::filesystem::path& path) override;
+    bool removeAll(const std::filesystem::path& path) override;
+    bool createDirectories(const std::filesystem::path& dir) override;
+    StorageStat stat(const std::filesystem::path& path) override;
+    std::vector<StorageEntry> list(const std::filesystem::path& dir) override;
+    std::unique_ptr<Watch> watch(const std::filesystem::path& dir, bool recursive,
+                                 WatchCallback onChange) override;
+};
+
+// A tree in memory, for the simulator. Directories exist implicitly above
+// any file and explicitly once created; mtime is a change counter. Watches
+// fire synchronously on the writing thread.
+class MemoryStorage : public FarmStorage
+{
+public:
+    std::optional<std::string> read(const std::filesystem::path& path, uint64_t offset = 0) override;
+    bool writeAtomic(const std::filesystem::path& path, std::string_view bytes) override;
+    bool append(const std::filesystem::path& path, std::string_view bytes) override;
+    bool rename(const std::filesystem::path& from, const std::filesystem::path& to,
+                std::error_code& ec) override;
+    bool remove(const std::filesystem::path& path) override;
+    bool removeAll(const std::filesystem::path& path) override;
+    bool createDirectories(const std::filesystem::path& dir) override;
+    StorageStat stat(const std::filesystem::path& path) override;
+    std::vector<StorageEntry> list(const std::filesystem::path& dir) override;
+    std::unique_ptr<Watch> watch(const std::filesystem::path& dir, bool recursive,
+                                 WatchCallback onChange) override;
+
+    uint64_t totalBytes() const;
+
+private:
+    struct Node
+    {
+        bool isDir = false;
+        std::string data;
+        int64_t mtime = 0;
+        uint64_t fileId = 0;
+    };
+    struct Watcher;
+    class MemoryWatch;
+
+    static std::string key(const std::filesystem::path& path);
+    void touchLocked(const std::string& key);           // the file and its parent dir
+    void ensureParentsLocked(const std::string& key);
+    void notify(const std::string& key);
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Node> m_nodes;                // generic paths, sorted so children are contiguous
+    int64_t m_clock = 0;
+    uint64_t m_nextId = 1;
+
+    std::mutex m_watchMutex;
+    std::vector<std::shared_ptr<Watcher>> m_watchers;
+};
+
+// Wraps another backend, sleeping before each op and counting ops, to try
+// the farm against a slow share (cloud FS, WAN SMB) on a fast one
+class LatencyStorage : public FarmStorage
+{
+public:
+    enum class Op : uint8_t { Read, Write, Append, Rename, Remove, Mkdir, Stat, List, Count };
+
+    struct Profile
+    {
+        double readMs = 0.0;
+        double writeMs = 0.0;       // writeAtomic and append
+        double metaMs = 0.0;        // rename, remove, mkdir, stat, list
+        double jitterMs = 0.0;      // uniform 0..jitterMs on top of each
+    };
+
+    LatencyStorage(std::shared_ptr<FarmStorage> inner, Profile profile);
+
+    void setProfile(const Profile& profile);
+    Profile profile() const;
+
+    uint64_t count(Op op) const { return m_counts[size_t(op)].load(std::memory_order_relaxed); }
+    double delayMs(Op op) const { return double(m_delayUs[size_t(op)].load(std::memory_order_relaxed)) / 1000.0; }
+    static const char* opName(Op op);
+
+    std::optional<std::string> read(const std::filesystem::path& path, uint64_t offset = 0) override;
+    bool writeAtomic(const std::filesystem::path& path, std::string_view bytes) override;
+    bool append(const std::filesystem::path& path, std::string_view bytes) override;
+    bool rename(const std::filesystem::path& from, const std::filesystem::path& to,
+                std::error_code& ec) override;
+    bool remove(const std::filesystem::path& path) override;
+    bool removeAll(const std::filesystem::path& path) override;
+    bool createDirectories(const std::filesystem::path& dir) override;
+    StorageStat stat(const std::filesystem::path& path) override;
+    std::vector<StorageEntry> list(const std::filesystem::path& dir) override;
+    std::unique_ptr<Watch> watch(const std::filesystem::path& dir, bool recursive,
+                                 WatchCallback onChange) override;
+
+    // Sleeps by default; the simulator swaps in its virtual clock
+    using DelayFn = std::function<void(double ms)>;
+    void setDelayFn(DelayFn fn);
+
+private:
+    void delay(Op op);
+
+    std::shared_ptr<FarmStorage> m_inner;
+
+    mutable std::mutex m_mutex;
+    Profile m_profile;
+    std::mt19937 m_rng{0x5EED};
+    DelayFn m_delayFn;
+
+    std::atomic<uint64_t> m_counts[size_t(Op::Count)] = {};
+    std::atomic<uint64_t> m_delayUs[size_t(Op::Count)] = {};
+};
+
+} // namespace SR
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -7,6 +8,40 @@
 
 namespace SR {
 
+// Live resource load, sampled on the heartbeat thread. -1 / 0 = not known
+// (no sample yet, or not measurable on this platform).
+struct NodeLoad
+{
+    int      cpu_pct = -1;
+    uint32_t ram_free_mb = 0;
+    int      gpu_pct = -1;
+    uint32_t vram_free_mb = 0;
+    uint32_t vram_total_mb = 0;
+    uint32_t disk_free_gb = 0;      // the node's local data disk (caches, staging)
+};
+
+inline void to_json(nlohmann::json& j, const NodeLoad& l)
+{
+    j = nlohmann::json{
+        {"cpu", l.cpu_pct},
+        {"ram", l.ram_free_mb},
+        {"gpu", l.gpu_pct},
+        {"vram", l.vram_free_mb},
+        {"vram_total", l.vram_total_mb},
+        {"disk", l.disk_free_gb},
+    };
+}
+
+inline void from_json(const nlohmann::json& j, NodeLoad& l)
+{
+    l.cpu_pct       = j.value("cpu", -1);
+    l.ram_free_mb   = j.value("ram", uint32_t(0));
+    l.gpu_pct       = j.value("gpu", -1);
+    l.vram_free_mb  = j.value("vram", uint32_t(0));
+    l.vram_total_mb = j.value("vram_total", uint32_t(0));
+    l.disk_free_gb  = j.value("disk", uint32_t(0));
+}
+
 // On-disk heartbeat JSON schema — written atomically to {nodes}/{node_id}/heartbeat.json
 struct Heartbeat
 {
@@ -18,16 +53,28 @@ struct Heartbeat
     uint32_t    protocol_version = 1;
     uint64_t    seq = 0;
     int64_t     timestamp_ms = 0;
-    std::string node_state = "active";    // active | stopped | draining
+    std::string node_state = "active";    // active | stopped | draining | sleeping
     std::string render_state = "idle";    // idle | rendering
     std::string active_job;               // empty = null
     std::string active_frames;            // empty = null
+    std::vector<std::string> active_jobs; // every job a render slot is on (active_job is the first)
+    int         render_slots = 1;         // concurrent agents on this node
+    int         free_slots = 1;           // slots with a connected agent and nothing rendering
     std::string gpu_name;
     int         cpu_cores = 0;
     uint64_t    ram_gb = 0;
+    NodeLoad    load;
     std::vector<std::string> tags;
     bool        is_coordinator = false;
+    bool        is_standby = false;           // takes over dispatch if the coordinator dies
+    uint64_t    coord_epoch = 0;              // coordinator fencing epoch (coordinator.json)
     int64_t     last_cmd_timestamp_ms = 0;
+    uint16_t    tcp_port = 0;                 // coordinator control link (0 = none)
+    bool        is_shard = false;             // coordinator sharing the farm (coordinators.json)
+    int         shard_pending = 0;            // shard: pending chunks of its jobs
+    std::string work_for;                     // worker: shard it's lent to (empty = home shard)
+    std::string mac_address;                  // for Wake-on-LAN ("" = unknown)
+    bool        allow_sleep = false;          // honours the coordinator's sleep command
 };
 
 inline void to_json(nlohmann::json& j, const Heartbeat& h)
@@ -45,12 +92,24 @@ inline void to_json(nlohmann::json& j, const Heartbeat& h)
         {"render_state", h.render_state},
         {"active_job", h.active_job.empty() ? nlohmann::json(nullptr) : nlohmann::json(h.active_job)},
         {"active_frames", h.active_frames.empty() ? nlohmann::json(nullptr) : nlohmann::json(h.active_frames)},
+        {"active_jobs", h.active_jobs},
+        {"render_slots", h.render_slots},
+        {"free_slots", h.free_slots},
         {"gpu_name", h.gpu_name},
         {"cpu_cores", h.cpu_cores},
         {"ram_gb", h.ram_gb},
+        {"load", h.load},
         {"tags", h.tags},
         {"is_coordinator", h.is_coordinator},
+        {"is_standby", h.is_standby},
+        {"coord_epoch", h.coord_epoch},
         {"last_cmd_timestamp_ms", h.last_cmd_timestamp_ms},
+        {"tcp_port", h.tcp_port},
+        {"is_shard", h.is_shard},
+        {"shard_pending", h.shard_pending},
+        {"work_for", h.work_for},
+        {"mac_address", h.mac_address},
+        {"allow_sleep", h.allow_sleep},
     };
 }
 
@@ -70,12 +129,25 @@ inline void from_json(const nlohmann::json& j, Heartbeat& h)
         j.at("active_job").get_to(h.active_job);
     if (j.contains("active_frames") && !j.at("active_frames").is_null())
         j.at("active_frames").get_to(h.active_frames);
+    if (j.contains("active_jobs"))        j.at("active_jobs").get_to(h.active_jobs);
+    if (j.contains("render_slots"))       j.at("render_slots").get_to(h.render_slots);
+    if (j.contains("free_slots"))         j.at("free_slots").get_to(h.free_slots);
+    else                                  h.free_slots = (h.render_state == "idle") ? h.render_slots : 0;   // pre-slot nodes
     if (j.contains("gpu_name"))           j.at("gpu_name").get_to(h.gpu_name);
     if (j.contains("cpu_cores"))          j.at("cpu_cores").get_to(h.cpu_cores);
     if (j.contains("ram_gb"))             j.at("ram_gb").get_to(h.ram_gb);
+    if (j.contains("load") && j.at("load").is_object()) j.at("load").get_to(h.load);
     if (j.contains("tags"))               j.at("tags").get_to(h.tags);
     if (j.contains("is_coordinator"))   j.at("is_coordinator").get_to(h.is_coordinator);
+    if (j.contains("is_standby"))         j.at("is_standby").get_to(h.is_standby);
+    if (j.contains("coord_epoch"))        j.at("coord_epoch").get_to(h.coord_epoch);
     if (j.contains("last_cmd_timestamp_ms")) j.at("last_cmd_timestamp_ms").get_to(h.last_cmd_timestamp_ms);
+    if (j.contains("tcp_port"))           j.at("tcp_port").get_to(h.tcp_port);
+    if (j.contains("is_shard"))           j.at("is_shard").get_to(h.is_shard);
+    if (j.contains("shard_pending"))      j.at("shard_pending").get_to(h.shard_pending);
+    if (j.contains("work_for"))           j.at("work_for").get_to(h.work_for);
+    if (j.contains("mac_address"))        j.at("mac_address").get_to(h.mac_address);
+    if (j.contains("allow_sleep"))        j.at("allow_sleep").get_to(h.allow_sleep);
 }
 
 // In-memory node info: heartbeat + derived staleness state (used by UI)
@@ -89,10 +161,25 @@ struct NodeInfo
     bool      clockSkewWarning = false;
     int64_t   skewAmountMs = 0;
     bool      reclaimEligible = true;   // dead nodes are reclaimable
+    bool      lastKnown = false;        // heartbeat file too slow / unreadable on the last scan
+    uint32_t  lastKnownScans = 0;       // consecutive scans it was skipped
 
     // UDP fast path tracking (runtime only, not serialized)
     bool    hasUdpContact = false;
     int64_t lastUdpContactMs = 0;
+
+    // Went quiet after announcing sleep: parked, not failed (wake it, don't mourn it)
+    bool isParked() const { return isDead && heartbeat.node_state == "sleeping"; }
 };
 
+// Immutable node list published by HeartbeatManager (local + peers, by node id).
+// Rebuilt on the first read after a node changed, so repeat reads copy nothing.
+struct NodeSnapshot
+{
+    uint64_t version = 0;
+    std::vector<NodeInfo> nodes;
+};
+
+using NodeSnapshotPtr = std::shared_ptr<const NodeSnapshot>;
+
 } // namespace SR
@@ -1,5 +1,6 @@
 #include "core/ipc_server.h"
 
+#include <algorithm>
 #include <iostream>
 #include <cstring>
 
@@ -11,6 +12,7 @@ IpcServer::IpcServer()
 {
     m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
     m_connectEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_readEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
 }
 
 IpcServer::~IpcServer()
@@ -18,6 +20,7 @@ IpcServer::~IpcServer()
     close();
     if (m_stopEvent) CloseHandle(m_stopEvent);
     if (m_connectEvent) CloseHandle(m_connectEvent);
+    if (m_readEvent) CloseHandle(m_readEvent);
 }
 
 bool IpcServer::create(const std::string& nodeId)
@@ -142,71 +145,102 @@ bool IpcServer::send(const std::string& json)
     return true;
 }
 
-bool IpcServer::readExact(void* buf, DWORD count, int timeoutMs)
+bool IpcServer::readAvailable(int timeoutMs)
 {
-    DWORD totalRead = 0;
-    auto* p = static_cast<char*>(buf);
+    // Keep only the unconsumed tail, then make room for a full chunk (or the
+    // rest of a large pending frame)
+    if (m_rxHead > 0)
+    {
+        std::memmove(m_rxBuf.data(), m_rxBuf.data() + m_rxHead, m_rxTail - m_rxHead);
+        m_rxTail -= m_rxHead;
+        m_rxHead = 0;
+    }
+    size_t want = RX_CHUNK_BYTES;
+    if (m_rxTail >= sizeof(uint32_t))
+    {
+        uint32_t len = 0;
+        std::memcpy(&len, m_rxBuf.data(), sizeof(len));
+        if (len <= MAX_MESSAGE_BYTES && sizeof(len) + len > m_rxTail)
+            want = std::max(want, sizeof(len) + len - m_rxTail);
+    }
+    if (m_rxBuf.size() < m_rxTail + want)
+        m_rxBuf.resize(m_rxTail + want);
 
-    while (totalRead < count)
+    ResetEvent(m_readEvent);
+    OVERLAPPED ov{};
+    ov.hEvent = m_readEvent;
+
+    DWORD bytesRead = 0;
+    DWORD space = static_cast<DWORD>(m_rxBuf.size() - m_rxTail);
+    if (ReadFile(m_pipe, m_rxBuf.data() + m_rxTail, space, &bytesRead, &ov))
     {
-        OVERLAPPED ov{};
-        ov.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
-        if (!ov.hEvent) return false;
+        // Read completed synchronously
+        m_rxTail += bytesRead;
+        return bytesRead > 0;
+    }
 
-        DWORD bytesRead = 0;
-        BOOL result = ReadFile(m_pipe, p + totalRead, count - totalRead, &bytesRead, &ov);
+    DWORD err = GetLastError();
+    if (err != ERROR_IO_PENDING)
+    {
+        if (err == ERROR_BROKEN_PIPE || err == ERROR_NO_DATA)
+            m_connected = false;
+        return false;
+    }
 
-        if (result)
-        {
-            // Read completed synchronously
-            CloseHandle(ov.hEvent);
-            totalRead += bytesRead;
-            continue;
-        }
+    // Wait for read to complete, stop event, or timeout
+    HANDLE events[] = { m_readEvent, m_stopEvent };
+    DWORD timeout = (timeoutMs < 0) ? INFINITE : static_cast<DWORD>(timeoutMs);
+    DWORD waitResult = WaitForMultipleObjects(2, events, FALSE, timeout);
 
-        DWORD err = GetLastError();
-        if (err != ERROR_IO_PENDING)
+    DWORD transferred = 0;
+    if (waitResult != WAIT_OBJECT_0)
+    {
+        // The buffer outlives this call, so the read must be finished before
+        // returning; keep whatever it delivered before the cancel
+        CancelIo(m_pipe);
+        if (GetOverlappedResult(m_pipe, &ov, &transferred, TRUE))
+            m_rxTail += transferred;
+        if (waitResult == WAIT_OBJECT_0 + 1)
         {
-            CloseHandle(ov.hEvent);
-            if (err == ERROR_BROKEN_PIPE || err == ERROR_NO_DATA)
-            {
-                m_connected = false;
-            }
+            m_connected = false;
             return false;
         }
+        return transferred > 0;
+    }
 
-        // Wait for read to complete, stop event, or timeout
-        HANDLE events[] = { ov.hEvent, m_stopEvent };
-        DWORD timeout = (timeoutMs < 0) ? INFINITE : static_cast<DWORD>(timeoutMs);
-        DWORD waitResult = WaitForMultipleObjects(2, events, FALSE, timeout);
+    if (!GetOverlappedResult(m_pipe, &ov, &transferred, FALSE))
+    {
+        if (GetLastError() == ERROR_BROKEN_PIPE)
+            m_connected = false;
+        return false;
+    }
+    m_rxTail += transferred;
+    return transferred > 0;
+}
 
-        if (waitResult == WAIT_OBJECT_0)
-        {
-            DWORD transferred = 0;
-            if (GetOverlappedResult(m_pipe, &ov, &transferred, FALSE))
-            {
-                totalRead += transferred;
-            }
-            else
-            {
-                DWORD ovErr = GetLastError();
-                CloseHandle(ov.hEvent);
-                if (ovErr == ERROR_BROKEN_PIPE) m_connected = false;
-                return false;
-            }
-        }
-        else
-        {
-            // Timeout or stop event
-            CancelIo(m_pipe);
-            CloseHandle(ov.hEvent);
-            if (waitResult == WAIT_OBJECT_0 + 1) m_connected = false;
-            return false;
-        }
+bool IpcServer::nextFrame(std::string_view& frame)
+{
+    if (m_rxTail - m_rxHead < sizeof(uint32_t))
+        return false;
 
-        CloseHandle(ov.hEvent);
+    // 4-byte little-endian length prefix
+    uint32_t len = 0;
+    std::memcpy(&len, m_rxBuf.data() + m_rxHead, sizeof(len));
+
+    // Sanity check
+    if (len > MAX_MESSAGE_BYTES)
+    {
+        std::cerr << "[IpcServer] Message too large: " << len << " bytes" << std::endl;
+        m_connected = false;
+        m_rxHead = m_rxTail = 0;
+        return false;
     }
 
+    if (m_rxTail - m_rxHead - sizeof(len) < len)
+        return false;
+
+    frame = std::string_view(m_rxBuf.data() + m_rxHead + sizeof(len), len);
+    m_rxHead += sizeof(len) + len;
     return true;
 }
 
@@ -214,25 +248,36 @@ std::optional<std::string> IpcServer::receive(int timeoutMs)
 {
     if (!m_connected || m_pipe == INVALID_HANDLE_VALUE) return std::nullopt;
 
-    // Read 4-byte length prefix
-    uint32_t len = 0;
-    if (!readExact(&len, sizeof(len), timeoutMs))
-        return std::nullopt;
+    std::string_view frame;
+    while (!nextFrame(frame))
+    {
+        if (!m_connected || !readAvailable(timeoutMs))
+            return std::nullopt;
+    }
+    return std::string(frame);
+}
 
-    // Sanity check
-    if (len > 16 * 1024 * 1024)
+bool IpcServer::receiveBatch(const std::function<void(std::string_view)>& onFrame, int timeoutMs)
+{
+    if (!m_connected || m_pipe == INVALID_HANDLE_VALUE) return false;
+
+    // Frames already buffered go first; only read when none are complete
+    std::string_view frame;
+    bool any = false;
+    while (nextFrame(frame))
     {
-        std::cerr << "[IpcServer] Message too large: " << len << " bytes" << std::endl;
-        m_connected = false;
-        return std::nullopt;
+        onFrame(frame);
+        any = true;
     }
+    if (any)
+        return true;
 
-    // Read payload
-    std::string payload(len, '\0');
-    if (!readExact(payload.data(), len, timeoutMs))
-        return std::nullopt;
+    if (!m_connected || !readAvailable(timeoutMs))
+        return false;
 
-    return payload;
+    while (nextFrame(frame))
+        onFrame(frame);
+    return true;
 }
 
 void IpcServer::disconnect()
@@ -242,6 +287,7 @@ void IpcServer::disconnect()
         FlushFileBuffers(m_pipe);
         DisconnectNamedPipe(m_pipe);
         m_connected = false;
+        m_rxHead = m_rxTail = 0;    // a partial frame belongs to the old client
         std::cout << "[IpcServer] Client disconnected" << std::endl;
     }
 }
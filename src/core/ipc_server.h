@@ -1,8 +1,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <optional>
+#include <functional>
 #include <mutex>
+#include <vector>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -39,6 +42,15 @@ public:
     /// Returns nullopt on timeout, disconnect, or error.
     std::optional<std::string> receive(int timeoutMs = -1);
 
+    /// Read whatever the pipe holds (up to RX_CHUNK_BYTES at a time) and pass
+    /// every complete frame to onFrame. Views point into the receive buffer and
+    /// are only valid during the call. Blocks up to timeoutMs for data.
+    /// Returns false on timeout, disconnect, or error.
+    bool receiveBatch(const std::function<void(std::string_view)>& onFrame, int timeoutMs = -1);
+
+    static constexpr size_t RX_CHUNK_BYTES = 64 * 1024;
+    static constexpr uint32_t MAX_MESSAGE_BYTES = 16 * 1024 * 1024;
+
     /// Disconnect the current client (allows re-accepting).
     void disconnect();
 
@@ -56,10 +68,17 @@ private:
     HANDLE m_pipe = INVALID_HANDLE_VALUE;
     HANDLE m_stopEvent = nullptr;
     HANDLE m_connectEvent = nullptr;
+    HANDLE m_readEvent = nullptr;
     bool m_connected = false;
     std::mutex m_writeMutex;
 
-    bool readExact(void* buf, DWORD count, int timeoutMs);
+    // Receive buffer: frames are split in place, unread bytes kept for the next read
+    std::vector<char> m_rxBuf;
+    size_t m_rxHead = 0;
+    size_t m_rxTail = 0;
+
+    bool readAvailable(int timeoutMs);
+    bool nextFrame(std::string_view& frame);
 #endif
 };
 
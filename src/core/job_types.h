@@ -1,8 +1,12 @@
 #pragma once
 
+#include "core/token_template.h"
+
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include <optional>
 #include <cstdint>
 #include <iomanip>
@@ -42,18 +46,119 @@ struct ProgressConfig
     std::vector<ErrorPattern> error_patterns;
 };
 
+// validation: "exit_code_only" trusts the exit code, "exists_nonzero" checks
+// the file the agent saw reported. "verify_frames" has the coordinator check
+// every frame of the output pattern after each chunk and again before the job
+// completes (OutputVerifier); missing, empty or bad frames are requeued.
 struct OutputDetection
 {
     std::optional<std::string> stdout_regex;     // nullopt = no detection
     int path_group = 1;
-    std::string validation = "exit_code_only";   // or "exists_nonzero"
+    std::string validation = "exit_code_only";   // or "exists_nonzero", "verify_frames"
+    bool check_headers = true;                   // verify_frames: magic bytes of known formats
+    double min_size_ratio = 0.0;                 // verify_frames: under this x the job's median size = truncated (0 = off)
     std::string info;
+
+    bool verifiesFrames() const { return validation == "verify_frames"; }
+};
+
+// Keep one DCC process per job per node and feed it successive chunks on
+// stdin (see the bootstrap scripts under plugins/). The launch command is the
+// job's own flags minus the per-chunk ones, plus launch_args.
+struct PersistentConfig
+{
+    bool enabled = false;
+    std::string bootstrap;                  // script path relative to {farm}/plugins, "{bootstrap}" in launch_args
+    std::vector<std::string> drop_flags;    // flags left out of the launch, with their positional value
+    std::vector<std::string> launch_args;   // appended after the remaining flags
+    int max_chunks = 0;                     // recycle after this many chunks (0 = no limit)
+    int max_memory_mb = 0;                  // recycle once resident memory passes this (0 = no limit)
 };
 
+// Render process placement, applied by sr-agent at spawn. A node's Config
+// overrides the priority; its slot pins bound the CPU set and NUMA node.
+inline bool isPriorityClass(const std::string& p)
+{
+    return p.empty() || p == "idle" || p == "below_normal" || p == "normal" ||
+           p == "above_normal" || p == "high";
+}
+
 struct ProcessConfig
 {
     std::string kill_method = "terminate";
     std::optional<std::string> working_dir;
+    PersistentConfig persistent;
+    std::string priority;           // "" = inherit, or an isPriorityClass() name
+    std::string cpu_set;            // logical processors, e.g. "0-15,32-47" (empty = all)
+    int numa_node = -1;             // -1 = any
+};
+
+// Minimum machine size for a job. Checked against the node's total RAM/VRAM,
+// and against what is free right now when the node has nothing else running.
+struct ResourceRequirements
+{
+    int min_ram_gb = 0;             // 0 = no minimum
+    int min_vram_gb = 0;            // 0 = no minimum (nodes with unknown VRAM don't qualify otherwise)
+
+    bool any() const { return min_ram_gb > 0 || min_vram_gb > 0; }
+};
+
+// One tile of a split still, in the 0-1 border coordinates Blender uses
+// (origin bottom-left)
+struct TileRegion
+{
+    int index = 0;      // 0-based, row-major from the bottom row
+    int col = 0;
+    int row = 0;
+    double min_x = 0.0, min_y = 0.0, max_x = 1.0, max_y = 1.0;
+};
+
+// Tile split: one still rendered as cols x rows regions on separate nodes,
+// then assembled by a merge task once every tile is done. A tiled job's
+// dispatch units stand in for frames — units 1..count() are tiles, unit
+// mergeUnit() is the merge — so chunks, commands and the journal stay keyed
+// by frame number. The template supplies the merge; the submitter the grid.
+struct TileSplit
+{
+    int cols = 0;
+    int rows = 0;
+    int frame = 1;                                  // the still being split
+    std::map<std::string, std::string> merge_cmd;   // per OS; missing = the job's cmd
+    std::vector<std::string> merge_args;            // tokens: {frame}, {tile_count}, {tile_cols},
+                                                    // {tile_rows}, {output_path} (the job's output flag)
+
+    bool supported() const { return !merge_args.empty(); }
+    bool enabled() const { return supported() && cols > 0 && rows > 0 && cols * rows > 1; }
+    int count() const { return cols * rows; }
+    int mergeUnit() const { return count() + 1; }
+    bool isMerge(int unit) const { return enabled() && unit == mergeUnit(); }
+
+    TileRegion region(int unit) const
+    {
+        TileRegion r;
+        r.index = unit - 1;
+        r.col = r.index % cols;
+        r.row = r.index / cols;
+        r.min_x = double(r.col) / cols;
+        r.max_x = double(r.col + 1) / cols;
+        r.min_y = double(r.row) / rows;
+        r.max_y = double(r.row + 1) / rows;
+        return r;
+    }
+};
+
+// Upstream job a job waits on. Job-level: nothing dispatches until the
+// upstream job has completed. Frame-level: each chunk waits only for the same
+// frame numbers of the upstream job, so stages overlap (falls back to
+// job-level for tiled jobs, and where the upstream table isn't held by the
+// same coordinator). An upstream that ends cancelled or failed (live or
+// archived) fails the downstream job: the coordinator writes a "failed" state
+// entry for it. A requeue keeps depends_on, so resubmit it against the new
+// upstream instead.
+struct JobDependency
+{
+    std::string job_id;
+    bool frames = false;
 };
 
 // ─── Template-specific structs ──────────────────────────────────────────────
@@ -78,6 +183,11 @@ struct TemplateFlag
     std::string filter;             // file extensions for NFD, e.g. "blend" or "aep"
     std::string id;                 // cross-reference identifier for {flag:id} tokens
     std::optional<std::string> default_pattern;  // auto-resolve pattern for output paths
+    bool cache = true;              // "file" inputs: allow the node-local input cache (off for scenes with relative asset paths)
+
+    // Runtime (not serialized): default_pattern split into tokens once, when
+    // the template is loaded (TemplateManager::compilePatterns)
+    std::shared_ptr<const TokenTemplate> pattern_plan;
 };
 
 struct JobDefaults
@@ -88,6 +198,7 @@ struct JobDefaults
     int priority = 50;
     int max_retries = 3;
     std::optional<int> timeout_seconds;
+    std::optional<int> target_chunk_seconds;   // set = adaptive chunk sizing
 };
 
 struct JobTemplate
@@ -104,6 +215,8 @@ struct JobTemplate
     ProcessConfig process;
     std::map<std::string, std::string> environment;
     std::vector<std::string> tags_required;
+    ResourceRequirements requirements;
+    TileSplit tiles;                        // merge_args set = stills can be tile-split
 
     // Runtime (not serialized)
     bool valid = false;
@@ -117,6 +230,8 @@ struct ManifestFlag
 {
     std::string flag;
     std::optional<std::string> value;
+    bool cache_input = false;       // value is an input file the node may read from its local cache
+    bool output_path = false;       // value is the render output path (redirected when staging)
 };
 
 struct JobManifest
@@ -136,6 +251,7 @@ struct JobManifest
     int chunk_size = 1;
     int max_retries = 3;
     std::optional<int> timeout_seconds;
+    std::optional<int> target_chunk_seconds;   // set = coordinator sizes chunks to this wall time
 
     std::optional<std::string> output_dir;  // parent directory of output path — auto-created before render
 
@@ -144,6 +260,9 @@ struct JobManifest
     ProcessConfig process;
     std::map<std::string, std::string> environment;
     std::vector<std::string> tags_required;
+    ResourceRequirements requirements;
+    TileSplit tiles;                // enabled(): frame_start..frame_end are tile units
+    std::vector<JobDependency> depends_on;
 };
 
 // ─── Job state structs ──────────────────────────────────────────────────────
@@ -156,11 +275,22 @@ struct JobStateEntry
     int64_t timestamp_ms = 0;
 };
 
+// state/0-rollup.json, written by the coordinator: the newest entry folded in.
+// Carries the JobStateEntry fields and sorts below every entry name, so a
+// reader that takes the newest file still gets the newest entry (compaction
+// always keeps it) and a valid state if that one doesn't parse.
+struct JobStateRollup
+{
+    JobStateEntry entry;
+    std::string covers;     // filename of the newest entry folded in
+};
+
 struct JobInfo
 {
     JobManifest manifest;
     std::string current_state = "active";
     int current_priority = 50;
+    int64_t state_timestamp_ms = 0;     // when current_state was written (0 = unknown)
 };
 
 // ─── Claim structs ──────────────────────────────────────────────────────────
@@ -203,13 +333,73 @@ inline std::vector<ChunkRange> computeChunks(int frame_start, int frame_end, int
     return chunks;
 }
 
+// Frame set as runs, "1-20,22,24-47" — carries a failed chunk's finished
+// frames in chunk_failed reports
+inline std::string formatFrameSet(const std::set<int>& frames)
+{
+    std::string out;
+    for (auto it = frames.begin(); it != frames.end(); )
+    {
+        int first = *it, last = first;
+        while (++it != frames.end() && *it == last + 1)
+            last = *it;
+        if (!out.empty()) out += ",";
+        out += std::to_string(first);
+        if (last != first) out += "-" + std::to_string(last);
+    }
+    return out;
+}
+
+inline std::set<int> parseFrameSet(const std::string& s)
+{
+    std::set<int> frames;
+    std::istringstream ss(s);
+    std::string run;
+    while (std::getline(ss, run, ','))
+    {
+        try
+        {
+            // A leading '-' is a negative frame, not a separator
+            size_t dash = run.find('-', 1);
+            int first = std::stoi(run.substr(0, dash));
+            int last = (dash == std::string::npos) ? first : std::stoi(run.substr(dash + 1));
+            for (int f = first; f <= last && frames.size() < 100000; ++f)
+                frames.insert(f);
+        }
+        catch (...) {}
+    }
+    return frames;
+}
+
 // ─── Dispatch structs (coordinator-based dispatch) ───────────────────────────
 
+// Compact in-memory chunk state; serialized as the lowercase strings below
+enum class DispatchState : uint8_t { Pending, Assigned, Completed, Failed };
+
+inline const char* dispatchStateToString(DispatchState s)
+{
+    switch (s)
+    {
+        case DispatchState::Assigned:  return "assigned";
+        case DispatchState::Completed: return "completed";
+        case DispatchState::Failed:    return "failed";
+        default:                       return "pending";
+    }
+}
+
+inline DispatchState dispatchStateFromString(const std::string& s)
+{
+    if (s == "assigned")  return DispatchState::Assigned;
+    if (s == "completed") return DispatchState::Completed;
+    if (s == "failed")    return DispatchState::Failed;
+    return DispatchState::Pending;
+}
+
 struct DispatchChunk
 {
     int frame_start = 0;
     int frame_end = 0;
-    std::string state = "pending";      // pending | assigned | completed | failed
+    DispatchState state = DispatchState::Pending;
     std::string assigned_to;
     int64_t assigned_at_ms = 0;
     int64_t completed_at_ms = 0;
@@ -221,6 +411,7 @@ struct DispatchTable
     int _version = 1;
     std::string coordinator_id;
     int64_t updated_at_ms = 0;
+    uint64_t journal_seq = 0;   // last dispatch.journal record folded into this snapshot
     std::vector<DispatchChunk> chunks;
 };
 
@@ -319,6 +510,8 @@ inline void to_json(nlohmann::json& j, const OutputDetection& o)
         {"stdout_regex", o.stdout_regex.has_value() ? nlohmann::json(o.stdout_regex.value()) : nlohmann::json(nullptr)},
         {"path_group", o.path_group},
         {"validation", o.validation},
+        {"check_headers", o.check_headers},
+        {"min_size_ratio", o.min_size_ratio},
         {"info", o.info},
     };
 }
@@ -329,17 +522,46 @@ inline void from_json(const nlohmann::json& j, OutputDetection& o)
         o.stdout_regex = j.at("stdout_regex").get<std::string>();
     if (j.contains("path_group"))  j.at("path_group").get_to(o.path_group);
     if (j.contains("validation"))  j.at("validation").get_to(o.validation);
+    if (j.contains("check_headers"))  j.at("check_headers").get_to(o.check_headers);
+    if (j.contains("min_size_ratio")) j.at("min_size_ratio").get_to(o.min_size_ratio);
     if (j.contains("info"))        j.at("info").get_to(o.info);
 }
 
 // ─── JSON serialization: ProcessConfig ──────────────────────────────────────
 
+inline void to_json(nlohmann::json& j, const PersistentConfig& p)
+{
+    j = nlohmann::json{
+        {"enabled", p.enabled},
+        {"bootstrap", p.bootstrap},
+        {"drop_flags", p.drop_flags},
+        {"launch_args", p.launch_args},
+        {"max_chunks", p.max_chunks},
+        {"max_memory_mb", p.max_memory_mb},
+    };
+}
+
+inline void from_json(const nlohmann::json& j, PersistentConfig& p)
+{
+    if (j.contains("enabled"))        j.at("enabled").get_to(p.enabled);
+    if (j.contains("bootstrap"))      j.at("bootstrap").get_to(p.bootstrap);
+    if (j.contains("drop_flags"))     j.at("drop_flags").get_to(p.drop_flags);
+    if (j.contains("launch_args"))    j.at("launch_args").get_to(p.launch_args);
+    if (j.contains("max_chunks"))     j.at("max_chunks").get_to(p.max_chunks);
+    if (j.contains("max_memory_mb"))  j.at("max_memory_mb").get_to(p.max_memory_mb);
+}
+
 inline void to_json(nlohmann::json& j, const ProcessConfig& p)
 {
     j = nlohmann::json{
         {"kill_method", p.kill_method},
         {"working_dir", p.working_dir.has_value() ? nlohmann::json(p.working_dir.value()) : nlohmann::json(nullptr)},
     };
+    if (p.persistent.enabled)
+        j["persistent"] = p.persistent;
+    if (!p.priority.empty()) j["priority"] = p.priority;
+    if (!p.cpu_set.empty())  j["cpu_set"] = p.cpu_set;
+    if (p.numa_node >= 0)    j["numa_node"] = p.numa_node;
 }
 
 inline void from_json(const nlohmann::json& j, ProcessConfig& p)
@@ -347,6 +569,65 @@ inline void from_json(const nlohmann::json& j, ProcessConfig& p)
     if (j.contains("kill_method"))  j.at("kill_method").get_to(p.kill_method);
     if (j.contains("working_dir") && !j.at("working_dir").is_null())
         p.working_dir = j.at("working_dir").get<std::string>();
+    if (j.contains("persistent") && j.at("persistent").is_object())
+        j.at("persistent").get_to(p.persistent);
+    if (j.contains("priority"))     j.at("priority").get_to(p.priority);
+    if (j.contains("cpu_set"))      j.at("cpu_set").get_to(p.cpu_set);
+    if (j.contains("numa_node"))    j.at("numa_node").get_to(p.numa_node);
+}
+
+// ─── JSON serialization: ResourceRequirements ───────────────────────────────
+
+inline void to_json(nlohmann::json& j, const ResourceRequirements& r)
+{
+    j = nlohmann::json{
+        {"min_ram_gb", r.min_ram_gb},
+        {"min_vram_gb", r.min_vram_gb},
+    };
+}
+
+inline void from_json(const nlohmann::json& j, ResourceRequirements& r)
+{
+    if (j.contains("min_ram_gb"))   j.at("min_ram_gb").get_to(r.min_ram_gb);
+    if (j.contains("min_vram_gb"))  j.at("min_vram_gb").get_to(r.min_vram_gb);
+}
+
+// ─── JSON serialization: TileSplit ──────────────────────────────────────────
+
+inline void to_json(nlohmann::json& j, const TileSplit& t)
+{
+    j = nlohmann::json{
+        {"cols", t.cols},
+        {"rows", t.rows},
+        {"frame", t.frame},
+        {"merge_cmd", t.merge_cmd},
+        {"merge_args", t.merge_args},
+    };
+}
+
+inline void from_json(const nlohmann::json& j, TileSplit& t)
+{
+    if (j.contains("cols"))         j.at("cols").get_to(t.cols);
+    if (j.contains("rows"))         j.at("rows").get_to(t.rows);
+    if (j.contains("frame"))        j.at("frame").get_to(t.frame);
+    if (j.contains("merge_cmd"))    j.at("merge_cmd").get_to(t.merge_cmd);
+    if (j.contains("merge_args"))   j.at("merge_args").get_to(t.merge_args);
+}
+
+// ─── JSON serialization: JobDependency ──────────────────────────────────────
+
+inline void to_json(nlohmann::json& j, const JobDependency& d)
+{
+    j = nlohmann::json{
+        {"job_id", d.job_id},
+        {"frames", d.frames},
+    };
+}
+
+inline void from_json(const nlohmann::json& j, JobDependency& d)
+{
+    if (j.contains("job_id"))   j.at("job_id").get_to(d.job_id);
+    if (j.contains("frames"))   j.at("frames").get_to(d.frames);
 }
 
 // ─── JSON serialization: TemplateCmd ────────────────────────────────────────
@@ -386,6 +667,7 @@ inline void to_json(nlohmann::json& j, const TemplateFlag& f)
     if (!f.filter.empty()) j["filter"] = f.filter;
     if (!f.id.empty())     j["id"] = f.id;
     if (f.default_pattern.has_value()) j["default_pattern"] = f.default_pattern.value();
+    if (!f.cache)          j["cache"] = false;
 }
 
 inline void from_json(const nlohmann::json& j, TemplateFlag& f)
@@ -403,6 +685,7 @@ inline void from_json(const nlohmann::json& j, TemplateFlag& f)
     if (j.contains("id"))       j.at("id").get_to(f.id);
     if (j.contains("default_pattern") && !j.at("default_pattern").is_null())
         f.default_pattern = j.at("default_pattern").get<std::string>();
+    if (j.contains("cache"))    j.at("cache").get_to(f.cache);
 }
 
 // ─── JSON serialization: JobDefaults ────────────────────────────────────────
@@ -416,6 +699,7 @@ inline void to_json(nlohmann::json& j, const JobDefaults& d)
         {"priority", d.priority},
         {"max_retries", d.max_retries},
         {"timeout_seconds", d.timeout_seconds.has_value() ? nlohmann::json(d.timeout_seconds.value()) : nlohmann::json(nullptr)},
+        {"target_chunk_seconds", d.target_chunk_seconds.has_value() ? nlohmann::json(d.target_chunk_seconds.value()) : nlohmann::json(nullptr)},
     };
 }
 
@@ -428,6 +712,8 @@ inline void from_json(const nlohmann::json& j, JobDefaults& d)
     if (j.contains("max_retries"))  j.at("max_retries").get_to(d.max_retries);
     if (j.contains("timeout_seconds") && !j.at("timeout_seconds").is_null())
         d.timeout_seconds = j.at("timeout_seconds").get<int>();
+    if (j.contains("target_chunk_seconds") && !j.at("target_chunk_seconds").is_null())
+        d.target_chunk_seconds = j.at("target_chunk_seconds").get<int>();
 }
 
 // ─── JSON serialization: JobTemplate ────────────────────────────────────────
@@ -448,6 +734,8 @@ inline void to_json(nlohmann::json& j, const JobTemplate& t)
         {"tags_required", t.tags_required},
     };
     if (!t.frame_padding.empty()) j["frame_padding"] = t.frame_padding;
+    if (t.requirements.any()) j["requirements"] = t.requirements;
+    if (t.tiles.supported()) j["tiles"] = t.tiles;
 }
 
 inline void from_json(const nlohmann::json& j, JobTemplate& t)
@@ -464,6 +752,10 @@ inline void from_json(const nlohmann::json& j, JobTemplate& t)
     if (j.contains("process"))           j.at("process").get_to(t.process);
     if (j.contains("environment"))       j.at("environment").get_to(t.environment);
     if (j.contains("tags_required"))     j.at("tags_required").get_to(t.tags_required);
+    if (j.contains("requirements") && j.at("requirements").is_object())
+        j.at("requirements").get_to(t.requirements);
+    if (j.contains("tiles") && j.at("tiles").is_object())
+        j.at("tiles").get_to(t.tiles);
 }
 
 // ─── JSON serialization: ManifestFlag ───────────────────────────────────────
@@ -474,6 +766,8 @@ inline void to_json(nlohmann::json& j, const ManifestFlag& f)
         {"flag", f.flag},
         {"value", f.value.has_value() ? nlohmann::json(f.value.value()) : nlohmann::json(nullptr)},
     };
+    if (f.cache_input) j["cache_input"] = true;
+    if (f.output_path) j["output_path"] = true;
 }
 
 inline void from_json(const nlohmann::json& j, ManifestFlag& f)
@@ -483,6 +777,8 @@ inline void from_json(const nlohmann::json& j, ManifestFlag& f)
         f.value = j.at("value").get<std::string>();
     else if (j.contains("value") && j.at("value").is_null())
         f.value = std::nullopt;
+    if (j.contains("cache_input")) j.at("cache_input").get_to(f.cache_input);
+    if (j.contains("output_path")) j.at("output_path").get_to(f.output_path);
 }
 
 // ─── JSON serialization: JobManifest ────────────────────────────────────────
@@ -503,6 +799,7 @@ inline void to_json(nlohmann::json& j, const JobManifest& m)
         {"chunk_size", m.chunk_size},
         {"max_retries", m.max_retries},
         {"timeout_seconds", m.timeout_seconds.has_value() ? nlohmann::json(m.timeout_seconds.value()) : nlohmann::json(nullptr)},
+        {"target_chunk_seconds", m.target_chunk_seconds.has_value() ? nlohmann::json(m.target_chunk_seconds.value()) : nlohmann::json(nullptr)},
         {"output_dir", m.output_dir.has_value() ? nlohmann::json(m.output_dir.value()) : nlohmann::json(nullptr)},
         {"progress", m.progress},
         {"output_detection", m.output_detection},
@@ -510,6 +807,9 @@ inline void to_json(nlohmann::json& j, const JobManifest& m)
         {"environment", m.environment},
         {"tags_required", m.tags_required},
     };
+    if (m.requirements.any()) j["requirements"] = m.requirements;
+    if (m.tiles.enabled()) j["tiles"] = m.tiles;
+    if (!m.depends_on.empty()) j["depends_on"] = m.depends_on;
 }
 
 inline void from_json(const nlohmann::json& j, JobManifest& m)
@@ -528,6 +828,8 @@ inline void from_json(const nlohmann::json& j, JobManifest& m)
     if (j.contains("max_retries"))       j.at("max_retries").get_to(m.max_retries);
     if (j.contains("timeout_seconds") && !j.at("timeout_seconds").is_null())
         m.timeout_seconds = j.at("timeout_seconds").get<int>();
+    if (j.contains("target_chunk_seconds") && !j.at("target_chunk_seconds").is_null())
+        m.target_chunk_seconds = j.at("target_chunk_seconds").get<int>();
     if (j.contains("output_dir") && !j.at("output_dir").is_null())
         m.output_dir = j.at("output_dir").get<std::string>();
     if (j.contains("progress"))          j.at("progress").get_to(m.progress);
@@ -535,6 +837,12 @@ inline void from_json(const nlohmann::json& j, JobManifest& m)
     if (j.contains("process"))           j.at("process").get_to(m.process);
     if (j.contains("environment"))       j.at("environment").get_to(m.environment);
     if (j.contains("tags_required"))     j.at("tags_required").get_to(m.tags_required);
+    if (j.contains("requirements") && j.at("requirements").is_object())
+        j.at("requirements").get_to(m.requirements);
+    if (j.contains("tiles") && j.at("tiles").is_object())
+        j.at("tiles").get_to(m.tiles);
+    if (j.contains("depends_on") && j.at("depends_on").is_array())
+        j.at("depends_on").get_to(m.depends_on);
 }
 
 // ─── JSON serialization: DispatchChunk ──────────────────────────────────────
@@ -544,7 +852,7 @@ inline void to_json(nlohmann::json& j, const DispatchChunk& d)
     j = nlohmann::json{
         {"frame_start", d.frame_start},
         {"frame_end", d.frame_end},
-        {"state", d.state},
+        {"state", dispatchStateToString(d.state)},
         {"assigned_to", d.assigned_to},
         {"assigned_at_ms", d.assigned_at_ms},
         {"completed_at_ms", d.completed_at_ms},
@@ -556,7 +864,7 @@ inline void from_json(const nlohmann::json& j, DispatchChunk& d)
 {
     if (j.contains("frame_start"))     j.at("frame_start").get_to(d.frame_start);
     if (j.contains("frame_end"))       j.at("frame_end").get_to(d.frame_end);
-    if (j.contains("state"))           j.at("state").get_to(d.state);
+    if (j.contains("state"))           d.state = dispatchStateFromString(j.at("state").get<std::string>());
     if (j.contains("assigned_to"))     j.at("assigned_to").get_to(d.assigned_to);
     if (j.contains("assigned_at_ms"))  j.at("assigned_at_ms").get_to(d.assigned_at_ms);
     if (j.contains("completed_at_ms")) j.at("completed_at_ms").get_to(d.completed_at_ms);
@@ -571,6 +879,7 @@ inline void to_json(nlohmann::json& j, const DispatchTable& dt)
         {"_version", dt._version},
         {"coordinator_id", dt.coordinator_id},
         {"updated_at_ms", dt.updated_at_ms},
+        {"journal_seq", dt.journal_seq},
         {"chunks", dt.chunks},
     };
 }
@@ -580,6 +889,7 @@ inline void from_json(const nlohmann::json& j, DispatchTable& dt)
     if (j.contains("_version"))        j.at("_version").get_to(dt._version);
     if (j.contains("coordinator_id"))  j.at("coordinator_id").get_to(dt.coordinator_id);
     if (j.contains("updated_at_ms"))   j.at("updated_at_ms").get_to(dt.updated_at_ms);
+    if (j.contains("journal_seq"))     j.at("journal_seq").get_to(dt.journal_seq);
     if (j.contains("chunks"))          j.at("chunks").get_to(dt.chunks);
 }
 
@@ -604,4 +914,18 @@ inline void from_json(const nlohmann::json& j, JobStateEntry& s)
     if (j.contains("timestamp_ms")) j.at("timestamp_ms").get_to(s.timestamp_ms);
 }
 
+// ─── JSON serialization: JobStateRollup ─────────────────────────────────────
+
+inline void to_json(nlohmann::json& j, const JobStateRollup& r)
+{
+    to_json(j, r.entry);
+    j["covers"] = r.covers;
+}
+
+inline void from_json(const nlohmann::json& j, JobStateRollup& r)
+{
+    from_json(j, r.entry);
+    if (j.contains("covers")) j.at("covers").get_to(r.covers);
+}
+
 } // namespace SR
@@ -1,47 +1,137 @@
 #pragma once
 
-#include <string>
-#include <unordered_map>
-#include <cstdint>
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
 
 namespace SR {
 
+// Fixed-size "seen recently" set for msg_ids arriving over UDP, TCP and the
+// inbox. Keys are 64-bit hashes of the msg_id ("{ts}.{sender}.{seq}" — the
+// timestamp keeps a restarted sender's reused seqs distinct).
+//
+// Time-bucketed ring: each bucket is an open-addressing table holding the
+// keys first seen in one WINDOW_MS slice. Lookups probe every bucket; when
+// the newest bucket's window ends (or it fills up) the oldest is wiped and
+// reused, so expiry costs one memset per window. The tables are allocated
+// once, up front; nothing allocates per message.
+// IDs are remembered for at least (BUCKETS - 1) * WINDOW_MS.
 class MessageDedup
 {
 public:
+    static constexpr size_t  BUCKETS      = 4;
+    static constexpr size_t  BUCKET_SLOTS = 4096;                    // power of two
+    static constexpr size_t  BUCKET_MAX   = BUCKET_SLOTS * 3 / 4;    // rotate early past this load
+    static constexpr int64_t WINDOW_MS    = 20000;
+
+    struct Stats
+    {
+        uint64_t checked = 0;
+        uint64_t duplicates = 0;
+        uint64_t earlyRotations = 0;    // a bucket filled before its window ended
+    };
+
+    MessageDedup() : m_keys(std::make_unique<Tables>()) {}
+
     // Returns true if already seen. Records the ID if new.
-    bool isDuplicate(const std::string& msgId)
+    bool isDuplicate(std::string_view msgId) { return isDuplicate(hash(msgId)); }
+
+    bool isDuplicate(uint64_t key)
     {
+        if (key == 0) key = 1;  // 0 marks an empty slot
+        ++m_stats.checked;
+
+        for (size_t b = 0; b < BUCKETS; ++b)
+        {
+            if (contains(b, key))
+            {
+                ++m_stats.duplicates;
+                return true;
+            }
+        }
+
         auto now = nowMs();
-        auto it = m_seen.find(msgId);
-        if (it != m_seen.end())
-            return true;
-        m_seen[msgId] = now;
+        if (m_bucketStart == 0)
+            m_bucketStart = now;
+        if (now - m_bucketStart >= WINDOW_MS || m_counts[m_current] >= BUCKET_MAX)
+        {
+            if (now - m_bucketStart < WINDOW_MS)
+                ++m_stats.earlyRotations;
+            rotate(now);
+        }
+        insert(m_current, key);
         return false;
     }
 
-    // Drop entries older than 60 seconds. Call every ~30s.
-    void purge()
+    const Stats& stats() const { return m_stats; }
+
+    // Share of checked IDs that were duplicates, in percent
+    double duplicateRate() const
+    {
+        return m_stats.checked ? 100.0 * double(m_stats.duplicates) / double(m_stats.checked) : 0.0;
+    }
+
+    // FNV-1a
+    static uint64_t hash(std::string_view s)
     {
-        auto cutoff = nowMs() - 60000;
-        for (auto it = m_seen.begin(); it != m_seen.end(); )
+        uint64_t h = 1469598103934665603ull;
+        for (unsigned char c : s)
         {
-            if (it->second < cutoff)
-                it = m_seen.erase(it);
-            else
-                ++it;
+            h ^= c;
+            h *= 1099511628211ull;
         }
+        return h;
     }
 
 private:
+    static constexpr size_t MASK = BUCKET_SLOTS - 1;
+    static_assert((BUCKET_SLOTS & MASK) == 0, "BUCKET_SLOTS must be a power of two");
+
+    // Slots are spread by the high bits, so poorly mixed low bits don't cluster
+    static size_t home(uint64_t key) { return size_t((key * 0x9E3779B97F4A7C15ull) >> 32) & MASK; }
+
+    bool contains(size_t bucket, uint64_t key) const
+    {
+        const auto& keys = (*m_keys)[bucket];
+        for (size_t i = home(key); ; i = (i + 1) & MASK)
+        {
+            if (keys[i] == key) return true;
+            if (keys[i] == 0)   return false;   // load is capped, so an empty slot always exists
+        }
+    }
+
+    void insert(size_t bucket, uint64_t key)
+    {
+        auto& keys = (*m_keys)[bucket];
+        size_t i = home(key);
+        while (keys[i] != 0)
+            i = (i + 1) & MASK;
+        keys[i] = key;
+        ++m_counts[bucket];
+    }
+
+    void rotate(int64_t now)
+    {
+        m_current = (m_current + 1) % BUCKETS;
+        (*m_keys)[m_current].fill(0);
+        m_counts[m_current] = 0;
+        m_bucketStart = now;
+    }
+
     static int64_t nowMs()
     {
         return std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now().time_since_epoch()).count();
     }
 
-    std::unordered_map<std::string, int64_t> m_seen;
+    using Tables = std::array<std::array<uint64_t, BUCKET_SLOTS>, BUCKETS>;
+    std::unique_ptr<Tables> m_keys;     // value-initialized: all slots empty
+    std::array<size_t, BUCKETS> m_counts{};
+    size_t m_current = 0;
+    int64_t m_bucketStart = 0;
+    Stats m_stats;
 };
 
 } // namespace SR
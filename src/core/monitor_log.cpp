@@ -18,23 +18,48 @@ MonitorLog& MonitorLog::instance()
     return s_instance;
 }
 
+MonitorLog::~MonitorLog()
+{
+    stopFileLogging();
+}
+
 void MonitorLog::startFileLogging(const fs::path& farmPath, const std::string& nodeId)
 {
+    stopFileLogging();
+
+    // Ensure our node's directory exists
+    std::error_code ec;
+    fs::create_directories(farmPath / "nodes" / nodeId, ec);
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_fileQueue.clear();    // stragglers from a previous farm
+        m_writerRunning = true;
+    }
+
     std::lock_guard<std::mutex> lock(m_mutex);
     m_farmPath = farmPath;
     m_nodeId = nodeId;
     m_currentDate = currentDateStr();
+    m_writerThread = std::thread(&MonitorLog::writerThreadFunc, this);
     m_fileEnabled = true;
-
-    // Ensure our node's directory exists
-    std::error_code ec;
-    fs::create_directories(farmPath / "nodes" / nodeId, ec);
 }
 
 void MonitorLog::stopFileLogging()
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_fileEnabled = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fileEnabled = false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_writerRunning = false;
+    }
+    m_queueCv.notify_one();
+
+    // Writer drains the queue before exiting
+    if (m_writerThread.joinable())
+        m_writerThread.join();
 }
 
 void MonitorLog::info(const std::string& category, const std::string& message)
@@ -76,54 +101,109 @@ void MonitorLog::append(const std::string& level, const std::string& category,
 
     std::string fileLine = std::string(timeBuf) + " " + level + "  [" + category + "] " + message;
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-
-    // Add to ring buffer
-    Entry entry;
-    entry.timestamp_ms = ms;
-    entry.level = level;
-    entry.category = category;
-    entry.message = message;
+    char dateBuf[16];
+    std::strftime(dateBuf, sizeof(dateBuf), "%Y-%m-%d", &tmBuf);
 
-    if (m_buffer.size() < MAX_ENTRIES)
-    {
-        m_buffer.push_back(std::move(entry));
-    }
-    else
+    bool toFile = false;
     {
-        m_buffer[m_writePos] = std::move(entry);
-        m_wrapped = true;
-    }
-    m_writePos = (m_writePos + 1) % MAX_ENTRIES;
+        std::lock_guard<std::mutex> lock(m_mutex);
 
-    // Write to file
-    if (m_fileEnabled)
-        writeToFile(fileLine);
+        // Add to ring buffer
+        Entry entry;
+        entry.seq = m_nextSeq++;
+        entry.timestamp_ms = ms;
+        entry.level = level;
+        entry.category = category;
+        entry.message = message;
 
-    // Also write to stdout in debug builds
+        if (m_buffer.size() < MAX_ENTRIES)
+        {
+            m_buffer.push_back(std::move(entry));
+        }
+        else
+        {
+            m_buffer[m_writePos] = std::move(entry);
+            m_wrapped = true;
+        }
+        m_writePos = (m_writePos + 1) % MAX_ENTRIES;
+        m_revision.fetch_add(1, std::memory_order_relaxed);
+
+        toFile = m_fileEnabled;
+
+        // Also write to stdout in debug builds
 #ifndef NDEBUG
-    std::cout << fileLine << std::endl;
+        std::cout << fileLine << std::endl;
 #endif
+    }
+
+    // Hand off to the writer thread; never touch the (network) file here
+    if (toFile)
+    {
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_fileQueue.emplace_back(dateBuf, std::move(fileLine));
+            wake = m_fileQueue.size() >= WRITE_BATCH_LINES;
+        }
+        if (wake)
+            m_queueCv.notify_one();
+    }
 }
 
-void MonitorLog::writeToFile(const std::string& line)
+// ─── File writer thread ─────────────────────────────────────────────────────
+
+void MonitorLog::writerThreadFunc()
 {
-    // Check for date rollover
-    std::string today = currentDateStr();
-    if (today != m_currentDate)
+    std::vector<std::pair<std::string, std::string>> batch;
+    while (true)
     {
-        m_currentDate = today;
-        purgeOldFiles();
+        bool running;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCv.wait_for(lock, std::chrono::milliseconds(WRITE_BATCH_MS), [this] {
+                return m_fileQueue.size() >= WRITE_BATCH_LINES || !m_writerRunning;
+            });
+            batch.swap(m_fileQueue);
+            running = m_writerRunning;
+        }
+
+        if (!batch.empty())
+        {
+            writeBatch(batch);
+            batch.clear();
+        }
+
+        if (!running)
+            break;
     }
 
-    auto logPath = m_farmPath / "nodes" / m_nodeId /
-        ("monitor-" + m_currentDate + ".log");
+    if (m_file.is_open())
+        m_file.close();
+}
 
-    std::ofstream ofs(logPath, std::ios::app);
-    if (ofs.is_open())
+void MonitorLog::writeBatch(const std::vector<std::pair<std::string, std::string>>& lines)
+{
+    for (const auto& [date, line] : lines)
     {
-        ofs << line << "\n";
+        // Date rollover (lines carry the date they were logged on)
+        if (date != m_currentDate || !m_file.is_open())
+        {
+            bool rolled = date != m_currentDate;
+            m_file.close();
+            m_currentDate = date;
+            if (rolled)
+                purgeOldFiles();
+
+            auto logPath = m_farmPath / "nodes" / m_nodeId /
+                ("monitor-" + m_currentDate + ".log");
+            m_file.clear();
+            m_file.open(logPath, std::ios::app);
+            if (!m_file.is_open())
+                return;     // share unavailable; drop this batch
+        }
+        m_file << line << "\n";
     }
+    m_file.flush();
 }
 
 void MonitorLog::purgeOldFiles()
@@ -176,7 +256,7 @@ void MonitorLog::purgeOldFiles()
     }
 }
 
-std::string MonitorLog::currentDateStr() const
+std::string MonitorLog::currentDateStr()
 {
     auto now = std::chrono::system_clock::now();
     time_t t = std::chrono::system_clock::to_time_t(now);
@@ -197,6 +277,39 @@ void MonitorLog::clearEntries()
     m_buffer.clear();
     m_writePos = 0;
     m_wrapped = false;
+    ++m_clears;
+    m_revision.fetch_add(1, std::memory_order_relaxed);
+}
+
+MonitorLog::Delta MonitorLog::readSince(Cursor& cursor) const
+{
+    Delta delta;
+
+    // Every append and clear bumps the revision once, so a cursor that has
+    // seen all of them matches it exactly
+    if (cursor.seq + cursor.clears == m_revision.load(std::memory_order_relaxed))
+        return delta;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // The ring holds seqs [firstSeq, m_nextSeq), oldest at `oldest`
+    uint64_t firstSeq = m_nextSeq - m_buffer.size();
+    size_t oldest = m_wrapped ? m_writePos : 0;
+
+    uint64_t from = cursor.seq;
+    if (cursor.clears != m_clears || from < firstSeq || from > m_nextSeq)
+    {
+        delta.reset = true;
+        from = firstSeq;
+    }
+
+    delta.entries.reserve(size_t(m_nextSeq - from));
+    for (uint64_t seq = from; seq < m_nextSeq; ++seq)
+        delta.entries.push_back(m_buffer[(oldest + size_t(seq - firstSeq)) % m_buffer.size()]);
+
+    cursor.seq = m_nextSeq;
+    cursor.clears = m_clears;
+    return delta;
 }
 
 std::vector<MonitorLog::Entry> MonitorLog::getEntries() const
@@ -249,34 +362,70 @@ std::vector<std::string> MonitorLog::readNodeLog(
     std::string yesterdayStr(dateBuf);
 
     auto nodeDir = farmPath / "nodes" / nodeId;
+    size_t wanted = maxLines > 0 ? static_cast<size_t>(maxLines) : 0;
 
-    // Read yesterday's file first (if today's is short, we'll have more context)
-    auto yesterdayPath = nodeDir / ("monitor-" + yesterdayStr + ".log");
-    std::error_code ec;
-    if (fs::exists(yesterdayPath, ec))
+    // Today's tail first; yesterday's only tops it up when today is short
+    result = readTail(nodeDir / ("monitor-" + today + ".log"), wanted);
+    if (result.size() < wanted)
     {
-        std::ifstream ifs(yesterdayPath);
-        std::string line;
-        while (std::getline(ifs, line))
-            result.push_back(std::move(line));
+        auto older = readTail(nodeDir / ("monitor-" + yesterdayStr + ".log"),
+                              wanted - result.size());
+        result.insert(result.begin(),
+                      std::make_move_iterator(older.begin()),
+                      std::make_move_iterator(older.end()));
     }
 
-    // Read today's file
-    auto todayPath = nodeDir / ("monitor-" + today + ".log");
-    if (fs::exists(todayPath, ec))
+    return result;
+}
+
+std::vector<std::string> MonitorLog::readTail(const fs::path& path, size_t maxLines)
+{
+    std::vector<std::string> result;
+    if (maxLines == 0)
+        return result;
+
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open())
+        return result;
+
+    ifs.seekg(0, std::ios::end);
+    auto size = static_cast<uint64_t>(ifs.tellg());
+
+    // Walk backwards in blocks until the buffer holds maxLines complete lines
+    // (maxLines + 1 newlines, counting the one that ends the file)
+    static constexpr uint64_t BLOCK = 16 * 1024;
+    std::string data;
+    uint64_t pos = size;
+    size_t newlines = 0;
+    while (pos > 0 && newlines <= maxLines)
     {
-        std::ifstream ifs(todayPath);
-        std::string line;
-        while (std::getline(ifs, line))
-            result.push_back(std::move(line));
+        uint64_t len = std::min(BLOCK, pos);
+        pos -= len;
+        std::string block(len, '\0');
+        ifs.seekg(static_cast<std::streamoff>(pos));
+        ifs.read(block.data(), static_cast<std::streamsize>(len));
+        block.resize(static_cast<size_t>(ifs.gcount()));
+        newlines += static_cast<size_t>(std::count(block.begin(), block.end(), '\n'));
+        data.insert(0, block);
     }
 
-    // Trim to last maxLines
-    if ((int)result.size() > maxLines)
+    std::istringstream ss(data);
+    std::string line;
+    bool first = pos > 0;   // leading fragment of a line before the window
+    while (std::getline(ss, line))
     {
-        result.erase(result.begin(), result.begin() + ((int)result.size() - maxLines));
+        if (first)
+        {
+            first = false;
+            continue;
+        }
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        result.push_back(std::move(line));
     }
 
+    if (result.size() > maxLines)
+        result.erase(result.begin(), result.end() - static_cast<std::ptrdiff_t>(maxLines));
     return result;
 }
 
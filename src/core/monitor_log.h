@@ -1,8 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <fstream>
 #include <filesystem>
 #include <cstdint>
 
@@ -26,6 +30,7 @@ public:
     // UI access — returns copy of ring buffer (thread-safe)
     struct Entry
     {
+        uint64_t seq = 0;       // position in the stream of every entry ever appended
         int64_t timestamp_ms = 0;
         std::string level;      // "INFO", "WARN", "ERROR"
         std::string category;   // "claims", "render", "agent", "command", "health", "job", "farm"
@@ -34,31 +39,71 @@ public:
     std::vector<Entry> getEntries() const;
     void clearEntries();
 
+    // Incremental reads: a reader keeps a cursor and gets only the entries
+    // appended since its last call, so the lock is held for a handful of
+    // copies instead of the whole ring. With nothing new it doesn't lock.
+    struct Cursor
+    {
+        uint64_t seq = 0;       // next entry wanted
+        uint64_t clears = 0;    // clearEntries() calls seen
+    };
+    struct Delta
+    {
+        std::vector<Entry> entries;
+        // The reader's view is stale (cleared, or lapped by the ring):
+        // replace it with entries instead of appending them
+        bool reset = false;
+    };
+    Delta readSince(Cursor& cursor) const;
+    static constexpr size_t MAX_ENTRIES = 1000;     // ring size
+
+    // Changes on every append or clear (lock-free; lets the UI skip idle redraws)
+    uint64_t revision() const { return m_revision.load(std::memory_order_relaxed); }
+
     // Read another node's log file (for remote troubleshooting)
     static std::vector<std::string> readNodeLog(
         const std::filesystem::path& farmPath,
         const std::string& nodeId,
         int maxLines = 500);
 
+    // Last maxLines lines of a text file, reading backwards from the end so
+    // the cost tracks maxLines rather than the file size
+    static std::vector<std::string> readTail(const std::filesystem::path& path,
+                                             size_t maxLines);
+
 private:
     MonitorLog() = default;
+    ~MonitorLog();
     void append(const std::string& level, const std::string& category,
                 const std::string& message);
-    void writeToFile(const std::string& line);
+    void writerThreadFunc();
+    void writeBatch(const std::vector<std::pair<std::string, std::string>>& lines);
     void purgeOldFiles();
-    std::string currentDateStr() const;
+    static std::string currentDateStr();
 
     // Ring buffer
-    static constexpr size_t MAX_ENTRIES = 1000;
     std::vector<Entry> m_buffer;
     size_t m_writePos = 0;
     bool m_wrapped = false;
+    uint64_t m_nextSeq = 0;
+    uint64_t m_clears = 0;
+    std::atomic<uint64_t> m_revision{0};    // appends + clears
 
-    // File logging
+    // File logging: callers only queue lines; the writer thread owns the file
     std::filesystem::path m_farmPath;
     std::string m_nodeId;
     bool m_fileEnabled = false;
-    std::string m_currentDate;
+    std::string m_currentDate;      // writer thread only
+    std::ofstream m_file;           // writer thread only
+
+    // Pending (date, line) pairs; the writer swaps the whole vector out
+    std::vector<std::pair<std::string, std::string>> m_fileQueue;
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCv;
+    std::thread m_writerThread;
+    bool m_writerRunning = false;   // guarded by m_queueMutex
+    static constexpr int WRITE_BATCH_MS = 250;
+    static constexpr size_t WRITE_BATCH_LINES = 256;    // wake the writer early
 
     mutable std::mutex m_mutex;
 };
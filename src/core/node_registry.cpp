@@ -0,0 +1,150 @@
+#include "core/node_registry.h"
+
+#include <tuple>
+#include <utility>
+
+namespace SR {
+
+const char* NodeRegistry::eventName(Event event)
+{
+    switch (event)
+    {
+        case Event::Joined:      return "joined";
+        case Event::Left:        return "left";
+        case Event::BecameIdle:  return "idle";
+        case Event::BecameBusy:  return "busy";
+        case Event::BecameDead:  return "dead";
+        case Event::BecameAlive: return "alive";
+        case Event::TagsChanged: return "tags_changed";
+    }
+    return "unknown";
+}
+
+int NodeRegistry::subscribe(Listener listener)
+{
+    int token = m_nextToken++;
+    m_listeners.emplace_back(token, std::move(listener));
+    return token;
+}
+
+void NodeRegistry::unsubscribe(int token)
+{
+    std::erase_if(m_listeners, [token](const auto& l) { return l.first == token; });
+}
+
+bool NodeRegistry::idleOf(const NodeInfo& node)
+{
+    return node.heartbeat.render_state == "idle" &&
+           node.heartbeat.node_state == "active" &&
+           !node.isDead;
+}
+
+bool NodeRegistry::update(NodeSnapshotPtr snapshot)
+{
+    if (!snapshot)
+        return false;
+    if (m_updated && (snapshot == m_snapshot || snapshot->version == m_snapshot->version))
+        return false;
+
+    // Diff first, emit after: listeners see the new index whole
+    std::vector<std::tuple<Event, std::string, size_t>> events;
+    std::vector<std::pair<std::string, size_t>> left;              // index into the old snapshot
+
+    std::unordered_map<std::string, Entry> entries;
+    entries.reserve(snapshot->nodes.size());
+    for (size_t i = 0; i < snapshot->nodes.size(); ++i)
+    {
+        const auto& node = snapshot->nodes[i];
+        const auto& hb = node.heartbeat;
+
+        Entry e;
+        e.index = i;
+        e.seq = hb.seq;
+        e.dead = deadOf(node);
+        e.idle = idleOf(node);
+        e.lastKnown = node.lastKnown;
+        e.freeSlots = hb.free_slots;
+        e.renderSlots = hb.render_slots;
+        e.nodeState = hb.node_state;
+        e.renderState = hb.render_state;
+        e.tags = hb.tags;
+
+        auto it = m_entries.find(hb.node_id);
+        if (it == m_entries.end())
+        {
+            e.version = 1;
+            events.emplace_back(Event::Joined, hb.node_id, i);
+            if (e.dead)
+                events.emplace_back(Event::BecameDead, hb.node_id, i);
+            else if (e.idle)
+                events.emplace_back(Event::BecameIdle, hb.node_id, i);
+        }
+        else
+        {
+            const auto& old = it->second;
+            bool tagsChanged = e.tags != old.tags;
+            bool changed = tagsChanged || e.seq != old.seq || e.dead != old.dead || e.idle != old.idle ||
+                           e.lastKnown != old.lastKnown || e.freeSlots != old.freeSlots ||
+                           e.renderSlots != old.renderSlots || e.nodeState != old.nodeState ||
+                           e.renderState != old.renderState;
+            e.version = old.version + (changed ? 1 : 0);
+
+            if (e.dead != old.dead)
+                events.emplace_back(e.dead ? Event::BecameDead : Event::BecameAlive, hb.node_id, i);
+            if (e.idle && !old.idle)
+                events.emplace_back(Event::BecameIdle, hb.node_id, i);
+            else if (!e.idle && old.idle && !e.dead)
+                events.emplace_back(Event::BecameBusy, hb.node_id, i);
+            if (tagsChanged)
+                events.emplace_back(Event::TagsChanged, hb.node_id, i);
+        }
+        entries[hb.node_id] = std::move(e);
+    }
+    for (const auto& [nodeId, old] : m_entries)
+    {
+        if (!entries.count(nodeId))
+            left.emplace_back(nodeId, old.index);
+    }
+
+    auto previous = std::exchange(m_snapshot, std::move(snapshot));
+    m_entries = std::move(entries);
+    m_updated = true;
+
+    for (const auto& [nodeId, index] : left)
+        emit(Event::Left, nodeId, &previous->nodes[index]);
+    for (const auto& [event, nodeId, index] : events)
+        emit(event, nodeId, &m_snapshot->nodes[index]);
+    return true;
+}
+
+void NodeRegistry::emit(Event event, const std::string& nodeId, const NodeInfo* node)
+{
+    for (const auto& [token, listener] : m_listeners)
+        listener(event, nodeId, node);
+}
+
+const NodeInfo* NodeRegistry::find(const std::string& nodeId) const
+{
+    auto it = m_entries.find(nodeId);
+    return it != m_entries.end() ? &m_snapshot->nodes[it->second.index] : nullptr;
+}
+
+bool NodeRegistry::isDead(const std::string& nodeId) const
+{
+    auto it = m_entries.find(nodeId);
+    return it == m_entries.end() || it->second.dead;
+}
+
+bool NodeRegistry::isIdle(const std::string& nodeId) const
+{
+    auto it = m_entries.find(nodeId);
+    return it != m_entries.end() && it->second.idle;
+}
+
+uint64_t NodeRegistry::nodeVersion(const std::string& nodeId) const
+{
+    auto it = m_entries.find(nodeId);
+    return it != m_entries.end() ? it->second.version : 0;
+}
+
+} // namespace SR
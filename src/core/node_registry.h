@@ -0,0 +1,82 @@
+#pragma once
+
+#include "core/heartbeat.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SR {
+
+// Node id index over the published NodeSnapshot, for code that looks nodes up
+// per assignment. update() re-indexes only when the snapshot version moves,
+// diffs each node against the previous snapshot, bumps that node's version
+// when anything it carries changed, and tells subscribers about transitions.
+//
+// Not thread-safe: owned by one thread (the dispatch loop). Listeners run
+// synchronously inside update(), after the index is rebuilt, so they can query
+// the registry; they must not subscribe or unsubscribe from there.
+class NodeRegistry
+{
+public:
+    enum class Event : uint8_t
+    {
+        Joined,         // first seen (including the first update)
+        Left,           // no longer in the snapshot
+        BecameIdle,     // active, idle and alive, where it wasn't
+        BecameBusy,     // was idle, now rendering, stopped or draining
+        BecameDead,     // dead and reclaimable (isDead() turned true)
+        BecameAlive,    // back from dead
+        TagsChanged,
+    };
+    static const char* eventName(Event event);
+
+    // For Left, node is its entry in the previous snapshot (valid during the call)
+    using Listener = std::function<void(Event event, const std::string& nodeId, const NodeInfo* node)>;
+    int subscribe(Listener listener);
+    void unsubscribe(int token);
+
+    // Returns true if the snapshot version changed
+    bool update(NodeSnapshotPtr snapshot);
+
+    const NodeInfo* find(const std::string& nodeId) const;
+    const std::vector<NodeInfo>& nodes() const { return m_snapshot->nodes; }
+    uint64_t version() const { return m_snapshot->version; }
+
+    // Unknown nodes count as dead: work assigned to them can be reclaimed
+    bool isDead(const std::string& nodeId) const;
+    bool isIdle(const std::string& nodeId) const;
+
+    // Bumped each time the node's entry changes (0 = unknown)
+    uint64_t nodeVersion(const std::string& nodeId) const;
+
+private:
+    struct Entry
+    {
+        size_t index = 0;           // into m_snapshot->nodes
+        uint64_t version = 0;
+        uint64_t seq = 0;
+        bool dead = false;
+        bool idle = false;
+        bool lastKnown = false;
+        int freeSlots = 0;
+        int renderSlots = 0;
+        std::string nodeState;
+        std::string renderState;
+        std::vector<std::string> tags;
+    };
+    static bool deadOf(const NodeInfo& node) { return node.isDead && node.reclaimEligible; }
+    static bool idleOf(const NodeInfo& node);
+
+    void emit(Event event, const std::string& nodeId, const NodeInfo* node);
+
+    NodeSnapshotPtr m_snapshot = std::make_shared<const NodeSnapshot>();
+    bool m_updated = false;                             // first update() reports everyone as Joined
+    std::unordered_map<std::string, Entry> m_entries;
+    std::vector<std::pair<int, Listener>> m_listeners;
+    int m_nextToken = 1;
+};
+
+} // namespace SR
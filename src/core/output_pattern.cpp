@@ -0,0 +1,98 @@
+#include "core/output_pattern.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool startsWithNoCase(const std::string& s, size_t pos, const std::string& prefix)
+{
+    if (s.size() - pos < prefix.size())
+        return false;
+    for (size_t i = 0; i < prefix.size(); ++i)
+    {
+        if (std::tolower((unsigned char)s[pos + i]) != std::tolower((unsigned char)prefix[i]))
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool OutputPattern::exactNames() const
+{
+    return padding > 0 && suffix.find('.') != std::string::npos;
+}
+
+fs::path OutputPattern::framePath(int frame) const
+{
+    char digits[16];
+    std::snprintf(digits, sizeof(digits), "%0*d", padding, frame);
+    return dir / (prefix + digits + suffix);
+}
+
+std::optional<OutputPattern> outputPatternFor(const JobManifest& manifest)
+{
+    if (manifest.tiles.enabled())
+        return std::nullopt;
+    auto flag = std::find_if(manifest.flags.begin(), manifest.flags.end(),
+        [](const ManifestFlag& f) { return f.output_path && f.value.has_value(); });
+    if (flag == manifest.flags.end())
+        return std::nullopt;
+
+    fs::path value(flag->value.value());
+    OutputPattern p;
+    p.dir = value.parent_path();
+    if (p.dir.empty() && manifest.output_dir.has_value())
+        p.dir = manifest.output_dir.value();
+    if (p.dir.empty())
+        return std::nullopt;
+
+    // "shot_####.png", "shot_[####]" (AE); no #'s: the DCC appends the number
+    std::string name = value.filename().string();
+    size_t hashEnd = name.rfind('#');
+    if (hashEnd == std::string::npos)
+    {
+        p.prefix = name;
+    }
+    else
+    {
+        size_t hashStart = name.find_last_not_of('#', hashEnd);
+        hashStart = hashStart == std::string::npos ? 0 : hashStart + 1;
+        p.padding = int(hashEnd - hashStart + 1);
+        p.prefix = name.substr(0, hashStart);
+        p.suffix = name.substr(hashEnd + 1);
+        if (!p.prefix.empty() && p.prefix.back() == '[')
+            p.prefix.pop_back();
+        if (!p.suffix.empty() && p.suffix.front() == ']')
+            p.suffix.erase(0, 1);
+    }
+    return p;
+}
+
+std::optional<int> matchOutputFrame(const std::string& filename, const OutputPattern& pattern)
+{
+    if (!startsWithNoCase(filename, 0, pattern.prefix))
+        return std::nullopt;
+    size_t pos = pattern.prefix.size();
+    size_t digits = pos;
+    while (digits < filename.size() && std::isdigit((unsigned char)filename[digits]))
+        ++digits;
+    if (digits == pos || digits - pos > 9)
+        return std::nullopt;
+    if (!startsWithNoCase(filename, digits, pattern.suffix))
+        return std::nullopt;
+
+    // After the suffix only an extension the DCC added may follow
+    size_t rest = digits + pattern.suffix.size();
+    if (rest != filename.size() && (filename[rest] != '.' || filename.find('.', rest + 1) != std::string::npos))
+        return std::nullopt;
+    return std::stoi(filename.substr(pos, digits - pos));
+}
+
+} // namespace SR
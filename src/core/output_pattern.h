@@ -0,0 +1,32 @@
+#pragma once
+
+#include "core/job_types.h"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace SR {
+
+// Where a job's frames land: "{dir}/{prefix}{digits}{suffix}[.ext]", from the
+// manifest's output_path flag. Shared by the thumbnail strip and output
+// verification. Tiled jobs have no per-frame files and get no pattern.
+struct OutputPattern
+{
+    std::filesystem::path dir;
+    std::string prefix;
+    std::string suffix;
+    int padding = 0;        // number of #'s; 0 = the DCC appends the number (and extension)
+
+    // The exact file name of a frame is known only with #'s and an extension
+    bool exactNames() const;
+    std::filesystem::path framePath(int frame) const;   // exactNames() only
+};
+
+std::optional<OutputPattern> outputPatternFor(const JobManifest& manifest);
+
+// Frame number of a file in pattern.dir, if it's one of the job's outputs.
+// Case-insensitive: names are typed by people, and the share usually is.
+std::optional<int> matchOutputFrame(const std::string& filename, const OutputPattern& pattern);
+
+} // namespace SR
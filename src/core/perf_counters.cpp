@@ -0,0 +1,159 @@
+#include "core/perf_counters.h"
+#include "core/atomic_file_io.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+namespace SR {
+
+// ─── Probe ──────────────────────────────────────────────────────────────────
+
+void PerfProbe::record(std::chrono::steady_clock::duration elapsed)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    uint32_t sample = uint32_t((std::min<int64_t>)((std::max<int64_t>)(us, 0), UINT32_MAX));
+    uint64_t n = m_count.fetch_add(1, std::memory_order_relaxed);
+    m_samples[n % SAMPLES].store(sample, std::memory_order_relaxed);
+}
+
+PerfProbe::Stats PerfProbe::stats() const
+{
+    Stats s;
+    s.count = m_count.load(std::memory_order_relaxed);
+    if (s.count == 0)
+        return s;
+
+    // A slot being overwritten mid-copy just reads as old or new: fine for a histogram
+    size_t n = size_t((std::min<uint64_t>)(s.count, SAMPLES));
+    std::vector<uint32_t> samples(n);
+    for (size_t i = 0; i < n; ++i)
+        samples[i] = m_samples[i].load(std::memory_order_relaxed);
+    s.lastMs = m_samples[(s.count - 1) % SAMPLES].load(std::memory_order_relaxed) / 1000.0;
+
+    std::sort(samples.begin(), samples.end());
+    s.p50Ms = samples[n / 2] / 1000.0;
+    s.p99Ms = samples[(std::min)(n - 1, n * 99 / 100)] / 1000.0;
+    s.maxMs = samples.back() / 1000.0;
+    return s;
+}
+
+// ─── Registry ───────────────────────────────────────────────────────────────
+
+PerfCounters& PerfCounters::instance()
+{
+    static PerfCounters s_instance;
+    return s_instance;
+}
+
+PerfProbe& PerfCounters::probe(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& p : m_probes)
+    {
+        if (p.name() == name)
+            return p;
+    }
+    return m_probes.emplace_back(name);
+}
+
+void PerfCounters::countRead(uint64_t bytes)
+{
+    m_reads.fetch_add(1, std::memory_order_relaxed);
+    m_readBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void PerfCounters::countWrite(uint64_t bytes)
+{
+    m_writes.fetch_add(1, std::memory_order_relaxed);
+    m_writeBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+PerfCounters::Report PerfCounters::report()
+{
+    Report r;
+    r.reads = m_reads.load(std::memory_order_relaxed);
+    r.writes = m_writes.load(std::memory_order_relaxed);
+    r.readBytes = m_readBytes.load(std::memory_order_relaxed);
+    r.writeBytes = m_writeBytes.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Rates move once per window, so a panel reading every frame sees steady numbers
+    auto now = std::chrono::steady_clock::now();
+    auto windowMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_rateStart).count();
+    if (windowMs >= RATE_WINDOW_MS)
+    {
+        if (m_rateStart != std::chrono::steady_clock::time_point{})
+        {
+            double secs = windowMs / 1000.0;
+            m_readsPerSec = (r.reads - m_rateReads) / secs;
+            m_writesPerSec = (r.writes - m_rateWrites) / secs;
+            m_readBytesPerSec = (r.readBytes - m_rateReadBytes) / secs;
+            m_writeBytesPerSec = (r.writeBytes - m_rateWriteBytes) / secs;
+        }
+        m_rateStart = now;
+        m_rateReads = r.reads;
+        m_rateWrites = r.writes;
+        m_rateReadBytes = r.readBytes;
+        m_rateWriteBytes = r.writeBytes;
+    }
+    r.readsPerSec = m_readsPerSec;
+    r.writesPerSec = m_writesPerSec;
+    r.readBytesPerSec = m_readBytesPerSec;
+    r.writeBytesPerSec = m_writeBytesPerSec;
+
+    r.probes.reserve(m_probes.size());
+    for (const auto& p : m_probes)
+        r.probes.push_back({p.name(), p.stats()});
+    std::sort(r.probes.begin(), r.probes.end(),
+        [](const Report::Probe& a, const Report::Probe& b) { return a.name < b.name; });
+    return r;
+}
+
+std::string PerfCounters::formatReport(const Report& report) const
+{
+    std::string out;
+    char line[256];
+
+    time_t now = std::time(nullptr);
+    struct tm tmBuf;
+#ifdef _WIN32
+    localtime_s(&tmBuf, &now);
+#else
+    localtime_r(&now, &tmBuf);
+#endif
+    char timeBuf[32];
+    std::strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", &tmBuf);
+    out += "SmallRender performance report, ";
+    out += timeBuf;
+    out += "\n\n";
+
+    std::snprintf(line, sizeof(line), "%-28s %10s %10s %10s %10s %10s\n",
+                  "probe", "calls", "last ms", "p50 ms", "p99 ms", "max ms");
+    out += line;
+    for (const auto& p : report.probes)
+    {
+        std::snprintf(line, sizeof(line), "%-28s %10llu %10.2f %10.2f %10.2f %10.2f\n",
+                      p.name.c_str(), (unsigned long long)p.stats.count, p.stats.lastMs,
+                      p.stats.p50Ms, p.stats.p99Ms, p.stats.maxMs);
+        out += line;
+    }
+
+    std::snprintf(line, sizeof(line),
+                  "\nfarm reads:  %llu (%llu bytes), %.1f/s, %.0f bytes/s\n"
+                  "farm writes: %llu (%llu bytes), %.1f/s, %.0f bytes/s\n",
+                  (unsigned long long)report.reads, (unsigned long long)report.readBytes,
+                  report.readsPerSec, report.readBytesPerSec,
+                  (unsigned long long)report.writes, (unsigned long long)report.writeBytes,
+                  report.writesPerSec, report.writeBytesPerSec);
+    out += line;
+    return out;
+}
+
+bool PerfCounters::writeReport(const std::filesystem::path& path)
+{
+    return AtomicFileIO::writeText(path, formatReport(report()));
+}
+
+} // namespace SR
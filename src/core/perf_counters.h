@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SR {
+
+// One named timing point. The last SAMPLES durations live in a lock-free
+// ring, so recording from any thread is two relaxed atomics; percentiles are
+// only worked out when a report asks for them.
+class PerfProbe
+{
+public:
+    explicit PerfProbe(std::string name) : m_name(std::move(name)) {}
+
+    void record(std::chrono::steady_clock::duration elapsed);
+
+    struct Stats
+    {
+        uint64_t count = 0;     // all-time calls
+        double lastMs = 0.0;
+        double p50Ms = 0.0;     // over the ring
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+    };
+    Stats stats() const;
+
+    const std::string& name() const { return m_name; }
+
+    static constexpr size_t SAMPLES = 512;
+
+private:
+    std::string m_name;
+    std::array<std::atomic<uint32_t>, SAMPLES> m_samples{};    // microseconds
+    std::atomic<uint64_t> m_count{0};
+};
+
+// Times the enclosing scope into a probe
+class PerfScope
+{
+public:
+    explicit PerfScope(PerfProbe& probe)
+        : m_probe(probe), m_start(std::chrono::steady_clock::now()) {}
+    ~PerfScope() { m_probe.record(std::chrono::steady_clock::now() - m_start); }
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+    PerfProbe& m_probe;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Registry of probes plus farm I/O counters, for the performance panel and
+// bug-report dumps.
+class PerfCounters
+{
+public:
+    static PerfCounters& instance();
+
+    // Same name, same probe; the reference stays valid for the process
+    PerfProbe& probe(const std::string& name);
+
+    // Farm file traffic (AtomicFileIO reads and writes)
+    void countRead(uint64_t bytes);
+    void countWrite(uint64_t bytes);
+
+    struct Report
+    {
+        struct Probe
+        {
+            std::string name;
+            PerfProbe::Stats stats;
+        };
+        std::vector<Probe> probes;      // sorted by name
+
+        uint64_t reads = 0, writes = 0;             // all-time
+        uint64_t readBytes = 0, writeBytes = 0;
+        double readsPerSec = 0.0, writesPerSec = 0.0;   // over the last RATE_WINDOW_MS
+        double readBytesPerSec = 0.0, writeBytesPerSec = 0.0;
+    };
+    Report report();
+
+    std::string formatReport(const Report& report) const;
+    bool writeReport(const std::filesystem::path& path);
+
+    static constexpr int64_t RATE_WINDOW_MS = 1000;
+
+private:
+    PerfCounters() = default;
+
+    std::mutex m_mutex;
+    std::deque<PerfProbe> m_probes;     // deque: growing never moves a probe
+
+    std::atomic<uint64_t> m_reads{0}, m_writes{0};
+    std::atomic<uint64_t> m_readBytes{0}, m_writeBytes{0};
+
+    // Rates: totals at the start of the current window, and the last result
+    std::chrono::steady_clock::time_point m_rateStart{};
+    uint64_t m_rateReads = 0, m_rateWrites = 0, m_rateReadBytes = 0, m_rateWriteBytes = 0;
+    double m_readsPerSec = 0.0, m_writesPerSec = 0.0;
+    double m_readBytesPerSec = 0.0, m_writeBytesPerSec = 0.0;
+};
+
+} // namespace SR
+
+// Times the rest of the enclosing scope under `name` (a string literal).
+// The probe is looked up once per call site.
+#define SR_PERF_CONCAT_(a, b) a##b
+#define SR_PERF_CONCAT(a, b) SR_PERF_CONCAT_(a, b)
+#define SR_PERF_SCOPE(name) \
+    static ::SR::PerfProbe& SR_PERF_CONCAT(srPerfProbe_, __LINE__) = \
+        ::SR::PerfCounters::instance().probe(name); \
+    ::SR::PerfScope SR_PERF_CONCAT(srPerfScope_, __LINE__)(SR_PERF_CONCAT(srPerfProbe_, __LINE__))
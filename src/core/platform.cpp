@@ -5,9 +5,18 @@
 #include <Windows.h>
 #include <ShlObj.h>
 #include <shellapi.h>
+#include <WinSock2.h>
+#include <iphlpapi.h>
+#include <powrprof.h>
+#pragma comment(lib, "Iphlpapi.lib")
+#pragma comment(lib, "PowrProf.lib")
 #endif
 
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 namespace SR {
 
@@ -90,4 +99,95 @@ void openFolderInExplorer(const std::filesystem::path& folder)
 #endif
 }
 
+std::string getMacAddress()
+{
+#ifdef _WIN32
+    ULONG size = 16 * 1024;
+    std::vector<uint8_t> buf(size);
+    auto* addrs = reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buf.data());
+    ULONG flags = GAA_FLAG_INCLUDE_GATEWAYS | GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_DNS_SERVER;
+    ULONG rc = GetAdaptersAddresses(AF_INET, flags, nullptr, addrs, &size);
+    if (rc == ERROR_BUFFER_OVERFLOW)
+    {
+        buf.resize(size);
+        addrs = reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buf.data());
+        rc = GetAdaptersAddresses(AF_INET, flags, nullptr, addrs, &size);
+    }
+    if (rc != NO_ERROR)
+        return {};
+
+    // Prefer the adapter with a gateway: that's the one the farm's LAN is on
+    const IP_ADAPTER_ADDRESSES* fallback = nullptr;
+    for (auto* a = addrs; a; a = a->Next)
+    {
+        if (a->OperStatus != IfOperStatusUp || a->IfType == IF_TYPE_SOFTWARE_LOOPBACK ||
+            a->PhysicalAddressLength != 6)
+            continue;
+        if (a->FirstGatewayAddress)
+        {
+            fallback = a;
+            break;
+        }
+        if (!fallback)
+            fallback = a;
+    }
+    if (!fallback)
+        return {};
+    char mac[18];
+    const auto* p = fallback->PhysicalAddress;
+    std::snprintf(mac, sizeof(mac), "%02x:%02x:%02x:%02x:%02x:%02x", p[0], p[1], p[2], p[3], p[4], p[5]);
+    return mac;
+#elif defined(__linux__)
+    // Interface of the default route (destination 00000000)
+    std::string iface;
+    std::ifstream route("/proc/net/route");
+    std::string line;
+    std::getline(route, line);     // header
+    while (std::getline(route, line))
+    {
+        std::istringstream fields(line);
+        std::string name, dest;
+        if (fields >> name >> dest && dest == "00000000")
+        {
+            iface = name;
+            break;
+        }
+    }
+    if (iface.empty())
+        return {};
+    std::ifstream addr("/sys/class/net/" + iface + "/address");
+    std::string mac;
+    std::getline(addr, mac);
+    return mac == "00:00:00:00:00:00" ? std::string() : mac;
+#else
+    return {};
+#endif
+}
+
+bool suspendSystem()
+{
+#ifdef _WIN32
+    // Needs SeShutdownPrivilege, which interactive users hold but don't have enabled
+    HANDLE token = nullptr;
+    if (OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+    {
+        TOKEN_PRIVILEGES tp{};
+        if (LookupPrivilegeValueW(nullptr, SE_SHUTDOWN_NAME, &tp.Privileges[0].Luid))
+        {
+            tp.PrivilegeCount = 1;
+            tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+            AdjustTokenPrivileges(token, FALSE, &tp, 0, nullptr, nullptr);
+        }
+        CloseHandle(token);
+    }
+    return SetSuspendState(FALSE, FALSE, FALSE) != FALSE;
+#elif defined(__linux__)
+    return std::system("systemctl suspend") == 0;
+#elif defined(__APPLE__)
+    return std::system("pmset sleepnow") == 0;
+#else
+    return false;
+#endif
+}
+
 } // namespace SR
@@ -20,4 +20,11 @@ std::string getHostname();
 // Opens a folder in the platform file manager (Explorer, Finder, etc.)
 void openFolderInExplorer(const std::filesystem::path& folder);
 
+// MAC of the adapter carrying the default route ("aa:bb:cc:dd:ee:ff"), "" if unknown
+std::string getMacAddress();
+
+// Suspend to RAM. False if the OS refused (no permission, sleep disabled).
+// May return only after the machine has resumed.
+bool suspendSystem();
+
 } // namespace SR
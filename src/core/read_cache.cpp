@@ -0,0 +1,191 @@
+#include "core/read_cache.h"
+#include "core/atomic_file_io.h"
+#include "core/farm_storage.h"
+
+#include <iostream>
+
+namespace SR {
+
+ReadCache& ReadCache::instance()
+{
+    static ReadCache s_instance;
+    return s_instance;
+}
+
+bool ReadCache::statFile(const std::filesystem::path& path, FileStamp& out)
+{
+    auto st = FarmStorage::current().stat(path);
+    if (!st.exists || st.isDir)
+        return false;
+
+    out.size = st.size;
+    out.mtime = st.mtime;
+    out.fileId = st.fileId;
+    return true;
+}
+
+std::shared_ptr<const nlohmann::json> ReadCache::readJson(const std::filesystem::path& path)
+{
+    // Stat before reading: if the file is replaced in between, the entry
+    // carries the older stamp and the next call simply re-reads
+    FileStamp stamp;
+    if (!statFile(path, stamp))
+        return nullptr;
+
+    Key key = path.native();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto* e = findFresh(key, stamp))
+        {
+            ++m_hits;
+            return e->json;
+        }
+        ++m_misses;
+    }
+
+    // Failures aren't cached — a torn or half-synced file should be retried
+    auto data = AtomicFileIO::safeReadJson(path);
+    if (!data.has_value())
+        return nullptr;
+
+    auto json = std::make_shared<const nlohmann::json>(std::move(data.value()));
+
+    Entry entry;
+    entry.stamp = stamp;
+    entry.json = json;
+    store(key, std::move(entry));
+    return json;
+}
+
+std::shared_ptr<const void> ReadCache::readTyped(const std::filesystem::path& path,
+                                                 std::type_index type, const Converter& convert)
+{
+    FileStamp stamp;
+    if (!statFile(path, stamp))
+        return nullptr;
+
+    Key key = path.native();
+    std::shared_ptr<const nlohmann::json> json;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto* e = findFresh(key, stamp))
+        {
+            ++m_hits;
+            if (e->typedType == type)
+                return e->typed;
+            json = e->json;     // parsed already, only the conversion is missing
+        }
+        else
+        {
+            ++m_misses;
+        }
+    }
+
+    if (!json)
+    {
+        auto data = AtomicFileIO::safeReadJson(path);
+        if (!data.has_value())
+            return nullptr;
+        json = std::make_shared<const nlohmann::json>(std::move(data.value()));
+    }
+
+    // A conversion failure is cached too: the same bytes will fail the same way
+    std::shared_ptr<const void> typed;
+    try
+    {
+        typed = convert(*json);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[ReadCache] Convert error for " << path << ": " << e.what() << std::endl;
+    }
+
+    Entry entry;
+    entry.stamp = stamp;
+    entry.json = std::move(json);
+    entry.typedType = type;
+    entry.typed = typed;
+    store(key, std::move(entry));
+    return typed;
+}
+
+void ReadCache::invalidate(const std::filesystem::path& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(path.native());
+    if (it == m_entries.end())
+        return;
+
+    m_bytes -= it->second.stamp.size;
+    m_lru.erase(it->second.lru);
+    m_entries.erase(it);
+}
+
+void ReadCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+ReadCache::Stats ReadCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s;
+    s.hits = m_hits;
+    s.misses = m_misses;
+    s.evictions = m_evictions;
+    s.entries = m_entries.size();
+    s.bytes = m_bytes;
+    return s;
+}
+
+ReadCache::Entry* ReadCache::findFresh(const Key& key, const FileStamp& stamp)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end() || !(it->second.stamp == stamp))
+        return nullptr;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    return &it->second;
+}
+
+void ReadCache::store(const Key& key, Entry entry)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        m_bytes -= it->second.stamp.size;
+        entry.lru = it->second.lru;
+        m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+        it->second = std::move(entry);
+        m_bytes += it->second.stamp.size;
+    }
+    else
+    {
+        m_lru.push_front(key);
+        entry.lru = m_lru.begin();
+        m_bytes += entry.stamp.size;
+        m_entries.emplace(key, std::move(entry));
+    }
+
+    evictLocked();
+}
+
+void ReadCache::evictLocked()
+{
+    // Never evict the entry just stored (front), even if it alone exceeds MAX_BYTES
+    while (m_lru.size() > 1 && (m_entries.size() > MAX_ENTRIES || m_bytes > MAX_BYTES))
+    {
+        auto it = m_entries.find(m_lru.back());
+        m_bytes -= it->second.stamp.size;
+        m_entries.erase(it);
+        m_lru.pop_back();
+        ++m_evictions;
+    }
+}
+
+} // namespace SR
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+namespace SR {
+
+// Shared parse cache in front of AtomicFileIO::safeReadJson.
+//
+// Entries are keyed on path and validated with a stat (size + mtime, plus the
+// file ID where the platform gives it for free), so an unchanged file costs
+// one metadata lookup instead of open/read/parse. Atomic writers rename a
+// fresh .tmp over the target, which always changes the stamp.
+//
+// Results are shared_ptr-to-const: callers must copy before mutating.
+// Thread-safe; parsing happens outside the lock.
+class ReadCache
+{
+public:
+    static ReadCache& instance();
+
+    // Parsed document, or nullptr if missing / unreadable
+    std::shared_ptr<const nlohmann::json> readJson(const std::filesystem::path& path);
+
+    // Parsed and converted with from_json. The converted object is cached
+    // alongside the document, so finished-job manifests are never re-parsed.
+    template <typename T>
+    std::shared_ptr<const T> read(const std::filesystem::path& path)
+    {
+        auto obj = readTyped(path, typeid(T),
+            [](const nlohmann::json& j) -> std::shared_ptr<const void> {
+                return std::make_shared<const T>(j.get<T>());
+            });
+        return std::static_pointer_cast<const T>(obj);
+    }
+
+    void invalidate(const std::filesystem::path& path);
+    void clear();
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        uint64_t bytes = 0;     // sum of cached file sizes
+    };
+    Stats stats() const;
+
+    static constexpr size_t   MAX_ENTRIES = 4096;
+    static constexpr uint64_t MAX_BYTES   = 64ull * 1024 * 1024;
+
+private:
+    ReadCache() = default;
+
+    struct FileStamp
+    {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t fileId = 0;    // inode / change time; 0 where not available
+        bool operator==(const FileStamp&) const = default;
+    };
+
+    using Key = std::filesystem::path::string_type;
+
+    struct Entry
+    {
+        FileStamp stamp;
+        std::shared_ptr<const nlohmann::json> json;
+        std::type_index typedType = typeid(void);
+        std::shared_ptr<const void> typed;      // null with typedType set = conversion failed
+        std::list<Key>::iterator lru;
+    };
+
+    using Converter = std::function<std::shared_ptr<const void>(const nlohmann::json&)>;
+
+    static bool statFile(const std::filesystem::path& path, FileStamp& out);
+
+    std::shared_ptr<const void> readTyped(const std::filesystem::path& path,
+                                          std::type_index type, const Converter& convert);
+
+    // Lookup under m_mutex; bumps LRU on hit
+    Entry* findFresh(const Key& key, const FileStamp& stamp);
+    void store(const Key& key, Entry entry);
+    void evictLocked();
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<Key, Entry> m_entries;
+    std::list<Key> m_lru;               // front = most recently used
+    uint64_t m_bytes = 0;
+
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+};
+
+} // namespace SR
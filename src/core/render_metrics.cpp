@@ -0,0 +1,304 @@
+#include "core/render_metrics.h"
+#include "core/atomic_file_io.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Calls fn per complete line of data; returns the bytes consumed (through the last newline)
+size_t splitLines(const std::string& data, const std::function<void(std::string_view)>& fn)
+{
+    size_t start = 0;
+    while (true)
+    {
+        auto nl = data.find('\n', start);
+        if (nl == std::string::npos)
+            break;
+        std::string_view line(data.data() + start, nl - start);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (!line.empty())
+            fn(line);
+        start = nl + 1;
+    }
+    return start;
+}
+
+} // namespace
+
+// ─── Writer ─────────────────────────────────────────────────────────────────
+
+bool RenderMetricsWriter::open(const fs::path& metricsDir, const std::string& nodeId)
+{
+    close();
+
+    std::error_code ec;
+    fs::create_directories(metricsDir, ec);
+    m_path = metricsDir / (nodeId + ".jsonl");
+    m_records = 0;
+
+    // Count what's there; a torn last line (crash mid-write) is ended first
+    bool needsNewline = false;
+    if (auto text = AtomicFileIO::safeReadText(m_path))
+    {
+        m_records = size_t(std::count(text->begin(), text->end(), '\n'));
+        needsNewline = !text->empty() && text->back() != '\n';
+    }
+
+    m_file.open(m_path, std::ios::binary | std::ios::app);
+    if (!m_file.is_open())
+        return false;
+    if (needsNewline)
+        m_file << '\n';
+    return true;
+}
+
+void RenderMetricsWriter::close()
+{
+    if (m_file.is_open())
+        m_file.close();
+}
+
+void RenderMetricsWriter::append(const ChunkMetric& metric)
+{
+    if (!m_file.is_open())
+        return;
+
+    std::string line = nlohmann::json(metric).dump();
+    line += '\n';
+
+    // One write per sample so a reader sees either nothing or the whole line
+    m_file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    m_file.flush();
+    if (!m_file.good())
+    {
+        std::cerr << "[RenderMetrics] Append failed: " << m_path << std::endl;
+        return;
+    }
+
+    if (++m_records >= ROLL_RECORDS)
+        roll();
+}
+
+void RenderMetricsWriter::roll()
+{
+    m_file.close();
+
+    auto text = AtomicFileIO::safeReadText(m_path);
+    std::vector<std::string_view> lines;
+    if (text)
+        splitLines(*text, [&](std::string_view line) { lines.push_back(line); });
+
+    size_t from = lines.size() > KEEP_RECORDS ? lines.size() - KEEP_RECORDS : 0;
+    std::string kept;
+    for (size_t i = from; i < lines.size(); ++i)
+    {
+        kept.append(lines[i]);
+        kept += '\n';
+    }
+    if (AtomicFileIO::writeText(m_path, kept))
+        m_records = lines.size() - from;
+    else
+        std::cerr << "[RenderMetrics] Roll failed: " << m_path << std::endl;
+
+    m_file.open(m_path, std::ios::binary | std::ios::app);
+}
+
+// ─── Estimates ──────────────────────────────────────────────────────────────
+
+double RenderEstimates::speed(const std::string& nodeId, const std::string& templateId) const
+{
+    auto it = nodeTemplateSpeed.find({nodeId, templateId});
+    if (it != nodeTemplateSpeed.end())
+        return it->second;
+    auto nit = nodeSpeed.find(nodeId);
+    return nit != nodeSpeed.end() ? nit->second : 0.0;
+}
+
+double RenderEstimates::msPerFrame(const std::string& jobId, const std::string& templateId) const
+{
+    auto it = jobs.find(jobId);
+    if (it != jobs.end() && it->second.samples > 0)
+        return it->second.msPerFrame;
+    auto tit = templates.find(templateId);
+    return tit != templates.end() ? tit->second.msPerFrame : 0.0;
+}
+
+int64_t RenderEstimates::remainingMs(const std::string& jobId, const std::string& templateId,
+                                     int framesLeft, int running) const
+{
+    if (framesLeft <= 0)
+        return 0;
+    double perFrame = msPerFrame(jobId, templateId);
+    if (perFrame <= 0.0)
+        return -1;
+    return int64_t(perFrame * double(framesLeft) / double((std::max)(running, 1)));
+}
+
+// ─── Sample store ───────────────────────────────────────────────────────────
+
+size_t RenderMetrics::refresh(const fs::path& metricsDir)
+{
+    size_t added = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(metricsDir, ec))
+    {
+        if (!entry.is_regular_file(ec) || entry.path().extension() != ".jsonl")
+            continue;
+        readNode(entry.path(), m_nodes[entry.path().stem().string()], added);
+    }
+    return added;
+}
+
+void RenderMetrics::readNode(const fs::path& path, NodeSamples& node, size_t& added)
+{
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    if (ec || (size == node.offset && !node.head.empty()))
+        return;
+
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open())
+        return;
+
+    // Shrunk or rewritten by a roll: start over
+    bool restart = size < node.offset;
+    if (!restart && !node.head.empty())
+    {
+        std::string head(node.head.size(), '\0');
+        ifs.read(head.data(), static_cast<std::streamsize>(head.size()));
+        restart = static_cast<size_t>(ifs.gcount()) != head.size() || head != node.head;
+        ifs.clear();
+    }
+    if (restart)
+    {
+        node = {};
+        m_dirty = true;
+    }
+    if (size <= node.offset)
+        return;
+
+    std::string data(size - node.offset, '\0');
+    ifs.seekg(static_cast<std::streamoff>(node.offset));
+    ifs.read(data.data(), static_cast<std::streamsize>(data.size()));
+    data.resize(static_cast<size_t>(ifs.gcount()));
+
+    if (node.offset == 0)
+        node.head = data.substr(0, HEAD_BYTES);
+
+    // A line without its newline is still being written; left for next time
+    node.offset += splitLines(data, [&](std::string_view line)
+    {
+        auto j = nlohmann::json::parse(line, nullptr, false);
+        if (j.is_discarded() || !j.is_object())
+            return;
+        push(node, j.get<ChunkMetric>());
+        ++added;
+    });
+}
+
+void RenderMetrics::add(const ChunkMetric& metric)
+{
+    push(m_nodes[metric.node_id], ChunkMetric(metric));
+}
+
+void RenderMetrics::push(NodeSamples& node, ChunkMetric&& metric)
+{
+    if (metric.frames <= 0 || metric.wall_ms <= 0)
+        return;
+    node.samples.push_back(std::move(metric));
+    if (node.samples.size() > MAX_NODE_SAMPLES)
+        node.samples.pop_front();
+    m_dirty = true;
+}
+
+RenderEstimatesPtr RenderMetrics::estimates()
+{
+    if (!m_dirty && m_estimates)
+        return m_estimates;
+    m_dirty = false;
+
+    struct Sum
+    {
+        double ms = 0.0;
+        double frames = 0.0;
+        int samples = 0;
+        uint64_t peakMb = 0;
+
+        void add(const ChunkMetric& m)
+        {
+            ms += double(m.wall_ms);
+            frames += double(m.frames);
+            ++samples;
+            peakMb = (std::max)(peakMb, m.peak_mb);
+        }
+    };
+
+    auto est = std::make_shared<RenderEstimates>();
+    std::unordered_map<std::string, Sum> jobs;
+    struct NodeRate { std::string nodeId; double msPerFrame; uint64_t peakMb; int samples; };
+    std::unordered_map<std::string, std::vector<NodeRate>> templateRates;
+
+    for (const auto& [nodeId, node] : m_nodes)
+    {
+        // Newest first, so each (node, template) rate reflects the node as it is now
+        std::unordered_map<std::string, Sum> perTemplate;
+        for (auto it = node.samples.rbegin(); it != node.samples.rend(); ++it)
+        {
+            jobs[it->job_id].add(*it);
+            if (it->tile || it->template_id.empty())
+                continue;
+            auto& sum = perTemplate[it->template_id];
+            if (size_t(sum.samples) < RATE_SAMPLES)
+                sum.add(*it);
+        }
+        for (const auto& [templateId, sum] : perTemplate)
+        {
+            if (sum.samples >= MIN_SPEED_SAMPLES)
+                templateRates[templateId].push_back({nodeId, sum.ms / sum.frames, sum.peakMb, sum.samples});
+        }
+    }
+
+    for (const auto& [jobId, sum] : jobs)
+        est->jobs[jobId] = {sum.ms / sum.frames, sum.samples, sum.peakMb};
+
+    std::unordered_map<std::string, std::pair<double, int>> speedSums;     // nodeId -> (sum, count)
+    for (auto& [templateId, rates] : templateRates)
+    {
+        std::vector<double> sorted;
+        RenderEstimates::Rate rate;
+        for (const auto& r : rates)
+        {
+            sorted.push_back(r.msPerFrame);
+            rate.samples += r.samples;
+            rate.peakMb = (std::max)(rate.peakMb, r.peakMb);
+        }
+        std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+        rate.msPerFrame = sorted[sorted.size() / 2];
+        est->templates[templateId] = rate;
+
+        for (const auto& r : rates)
+        {
+            double speed = rate.msPerFrame / r.msPerFrame;
+            est->nodeTemplateSpeed[{r.nodeId, templateId}] = speed;
+            auto& [total, count] = speedSums[r.nodeId];
+            total += speed;
+            ++count;
+        }
+    }
+    for (const auto& [nodeId, sum] : speedSums)
+        est->nodeSpeed[nodeId] = sum.first / double(sum.second);
+
+    m_estimates = std::move(est);
+    return m_estimates;
+}
+
+} // namespace SR
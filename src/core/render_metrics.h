@@ -0,0 +1,145 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace SR {
+
+// One finished chunk, as measured by the node that rendered it
+struct ChunkMetric
+{
+    int64_t timestamp_ms = 0;
+    std::string node_id;
+    std::string job_id;
+    std::string template_id;
+    int frames = 0;
+    int64_t wall_ms = 0;
+    uint64_t peak_mb = 0;       // agent-reported peak working set; 0 = not reported
+    bool tile = false;          // a tile of a split still: only says something about its own job
+};
+
+inline void to_json(nlohmann::json& j, const ChunkMetric& m)
+{
+    j = nlohmann::json{
+        {"ts", m.timestamp_ms},
+        {"node", m.node_id},
+        {"job", m.job_id},
+        {"tmpl", m.template_id},
+        {"frames", m.frames},
+        {"wall_ms", m.wall_ms},
+    };
+    if (m.peak_mb > 0) j["peak_mb"] = m.peak_mb;
+    if (m.tile) j["tile"] = true;
+}
+
+inline void from_json(const nlohmann::json& j, ChunkMetric& m)
+{
+    if (j.contains("ts")) j.at("ts").get_to(m.timestamp_ms);
+    if (j.contains("node")) j.at("node").get_to(m.node_id);
+    if (j.contains("job")) j.at("job").get_to(m.job_id);
+    if (j.contains("tmpl")) j.at("tmpl").get_to(m.template_id);
+    if (j.contains("frames")) j.at("frames").get_to(m.frames);
+    if (j.contains("wall_ms")) j.at("wall_ms").get_to(m.wall_ms);
+    if (j.contains("peak_mb")) j.at("peak_mb").get_to(m.peak_mb);
+    if (j.contains("tile")) j.at("tile").get_to(m.tile);
+}
+
+// Appends this node's samples to metrics/{nodeId}.jsonl, one compact line per
+// chunk. Past ROLL_RECORDS lines the file is rewritten (atomically) down to
+// its newest KEEP_RECORDS, so it stays a fixed-size rolling window.
+class RenderMetricsWriter
+{
+public:
+    bool open(const std::filesystem::path& metricsDir, const std::string& nodeId);
+    void close();
+    bool isOpen() const { return m_file.is_open(); }
+
+    void append(const ChunkMetric& metric);
+
+    static constexpr size_t ROLL_RECORDS = 2000;
+    static constexpr size_t KEEP_RECORDS = 1000;
+
+private:
+    void roll();
+
+    std::filesystem::path m_path;
+    std::ofstream m_file;
+    size_t m_records = 0;
+};
+
+// Throughput derived from the samples: ms per frame on one render slot
+struct RenderEstimates
+{
+    struct Rate
+    {
+        double msPerFrame = 0.0;
+        int samples = 0;
+        uint64_t peakMb = 0;    // largest reported
+    };
+
+    std::unordered_map<std::string, Rate> jobs;         // every node's chunks of the job
+    std::unordered_map<std::string, Rate> templates;    // the median node's rate
+    // Node speed relative to that median (2.0 = renders twice as fast);
+    // per template, and averaged over every template the node has rendered
+    std::map<std::pair<std::string, std::string>, double> nodeTemplateSpeed;
+    std::unordered_map<std::string, double> nodeSpeed;
+
+    // 0 = no samples yet
+    double speed(const std::string& nodeId, const std::string& templateId) const;
+
+    // The job's own rate once it has one, else its template's; 0 = unknown
+    double msPerFrame(const std::string& jobId, const std::string& templateId) const;
+
+    // Wall time left for framesLeft frames spread over `running` chunks; -1 = unknown
+    int64_t remainingMs(const std::string& jobId, const std::string& templateId,
+                        int framesLeft, int running) const;
+};
+
+using RenderEstimatesPtr = std::shared_ptr<const RenderEstimates>;
+
+// Per-node samples gathered from every node's metrics file (or fed directly),
+// and the estimates built from them. Not thread-safe; the published
+// RenderEstimatesPtr is immutable and can be handed to any thread.
+class RenderMetrics
+{
+public:
+    // Tail every metrics/*.jsonl, restarting a node whose file rolled.
+    // Returns the number of new samples.
+    size_t refresh(const std::filesystem::path& metricsDir);
+
+    void add(const ChunkMetric& metric);
+
+    // Rebuilt only when samples changed since the last call
+    RenderEstimatesPtr estimates();
+
+    static constexpr size_t MAX_NODE_SAMPLES = RenderMetricsWriter::ROLL_RECORDS;
+    static constexpr size_t RATE_SAMPLES = 32;          // newest per (node, template) pair
+    static constexpr int MIN_SPEED_SAMPLES = 3;
+
+private:
+    struct NodeSamples
+    {
+        uint64_t offset = 0;            // bytes consumed
+        std::string head;               // first bytes, to spot a rolled file
+        std::deque<ChunkMetric> samples;
+    };
+    void readNode(const std::filesystem::path& path, NodeSamples& node, size_t& added);
+    void push(NodeSamples& node, ChunkMetric&& metric);
+
+    std::map<std::string, NodeSamples> m_nodes;
+    RenderEstimatesPtr m_estimates;
+    bool m_dirty = true;
+
+    static constexpr size_t HEAD_BYTES = 64;
+};
+
+} // namespace SR
@@ -0,0 +1,209 @@
+#include "core/resource_sampler.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <dxgi.h>
+#include <pdh.h>
+#include <pdhmsg.h>
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "pdh.lib")
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+ResourceSampler::~ResourceSampler()
+{
+#ifdef _WIN32
+    if (m_pdhQuery)
+        PdhCloseQuery(static_cast<PDH_HQUERY>(m_pdhQuery));
+#endif
+}
+
+NodeLoad ResourceSampler::sample(const fs::path& diskPath)
+{
+    NodeLoad load;
+    load.cpu_pct = sampleCpu();
+
+#ifdef _WIN32
+    MEMORYSTATUSEX mem{};
+    mem.dwLength = sizeof(mem);
+    if (GlobalMemoryStatusEx(&mem))
+        load.ram_free_mb = static_cast<uint32_t>(mem.ullAvailPhys / (1024 * 1024));
+#else
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    uint64_t kb = 0;
+    std::string unit;
+    while (meminfo >> key >> kb >> unit)
+    {
+        if (key == "MemAvailable:")
+        {
+            load.ram_free_mb = static_cast<uint32_t>(kb / 1024);
+            break;
+        }
+    }
+#endif
+
+    sampleGpu(load);
+
+    std::error_code ec;
+    auto space = fs::space(diskPath, ec);
+    if (!ec)
+        load.disk_free_gb = static_cast<uint32_t>(space.available >> 30);
+
+    return load;
+}
+
+// Busy share of all CPU time since the previous call
+int ResourceSampler::sampleCpu()
+{
+    uint64_t idle = 0, total = 0;
+#ifdef _WIN32
+    FILETIME idleFt, kernelFt, userFt;
+    if (!GetSystemTimes(&idleFt, &kernelFt, &userFt))
+        return -1;
+    auto toU64 = [](const FILETIME& ft) {
+        return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    };
+    idle = toU64(idleFt);
+    total = toU64(kernelFt) + toU64(userFt);    // kernel time includes idle
+#else
+    std::ifstream stat("/proc/stat");
+    std::string cpu;
+    stat >> cpu;
+    if (cpu != "cpu")
+        return -1;
+    uint64_t v = 0;
+    for (int i = 0; i < 8 && stat >> v; ++i)
+    {
+        total += v;
+        if (i == 3 || i == 4)   // idle, iowait
+            idle += v;
+    }
+#endif
+
+    int pct = -1;
+    if (m_prevTotal != 0 && total > m_prevTotal)
+    {
+        uint64_t dTotal = total - m_prevTotal;
+        uint64_t dIdle = (idle >= m_prevIdle) ? idle - m_prevIdle : 0;
+        pct = static_cast<int>(100 * (dTotal - (std::min)(dIdle, dTotal)) / dTotal);
+    }
+    m_prevIdle = idle;
+    m_prevTotal = total;
+    return pct;
+}
+
+void ResourceSampler::openGpuCounters()
+{
+    m_gpuOpened = true;
+#ifdef _WIN32
+    IDXGIFactory* factory = nullptr;
+    if (SUCCEEDED(CreateDXGIFactory(__uuidof(IDXGIFactory), reinterpret_cast<void**>(&factory))))
+    {
+        IDXGIAdapter* adapter = nullptr;
+        if (SUCCEEDED(factory->EnumAdapters(0, &adapter)))
+        {
+            DXGI_ADAPTER_DESC desc{};
+            if (SUCCEEDED(adapter->GetDesc(&desc)))
+                m_vramTotalMB = desc.DedicatedVideoMemory / (1024 * 1024);
+            adapter->Release();
+        }
+        factory->Release();
+    }
+
+    PDH_HQUERY query = nullptr;
+    if (PdhOpenQueryW(nullptr, 0, &query) != ERROR_SUCCESS)
+        return;
+    PDH_HCOUNTER engine = nullptr, vram = nullptr;
+    PdhAddEnglishCounterW(query, L"\\GPU Engine(*)\\Utilization Percentage", 0, &engine);
+    PdhAddEnglishCounterW(query, L"\\GPU Adapter Memory(*)\\Dedicated Usage", 0, &vram);
+    if (!engine && !vram)
+    {
+        PdhCloseQuery(query);
+        return;
+    }
+    PdhCollectQueryData(query);     // rate counters need a baseline
+    m_pdhQuery = query;
+    m_gpuEngineCounter = engine;
+    m_vramUsageCounter = vram;
+#endif
+}
+
+void ResourceSampler::sampleGpu(NodeLoad& load)
+{
+    if (!m_gpuOpened)
+        openGpuCounters();
+
+#ifdef _WIN32
+    if (!m_pdhQuery || PdhCollectQueryData(static_cast<PDH_HQUERY>(m_pdhQuery)) != ERROR_SUCCESS)
+        return;
+
+    // Wildcard counter -> one value per instance
+    auto readArray = [](void* counter, DWORD format, auto&& fn) {
+        if (!counter)
+            return false;
+        DWORD bytes = 0, count = 0;
+        auto hc = static_cast<PDH_HCOUNTER>(counter);
+        if (PdhGetFormattedCounterArrayW(hc, format, &bytes, &count, nullptr) != PDH_MORE_DATA)
+            return false;
+        std::vector<unsigned char> buf(bytes);
+        auto items = reinterpret_cast<PDH_FMT_COUNTERVALUE_ITEM_W*>(buf.data());
+        if (PdhGetFormattedCounterArrayW(hc, format, &bytes, &count, items) != ERROR_SUCCESS)
+            return false;
+        for (DWORD i = 0; i < count; ++i)
+            fn(items[i]);
+        return true;
+    };
+
+    // Instances are per process and engine ("pid_1_..._engtype_3D"); the
+    // busiest engine type (3D, Compute, Cuda, ...) is the GPU's utilization
+    std::map<std::wstring, double> byEngineType;
+    bool haveEngines = readArray(m_gpuEngineCounter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100,
+        [&](const PDH_FMT_COUNTERVALUE_ITEM_W& item) {
+            std::wstring name = item.szName;
+            auto pos = name.find(L"engtype_");
+            if (pos != std::wstring::npos && item.FmtValue.CStatus == ERROR_SUCCESS)
+                byEngineType[name.substr(pos)] += item.FmtValue.doubleValue;
+        });
+    if (haveEngines)
+    {
+        double busiest = 0.0;
+        for (const auto& [type, pct] : byEngineType)
+            busiest = (std::max)(busiest, pct);
+        load.gpu_pct = static_cast<int>((std::min)(busiest, 100.0));
+    }
+
+    if (m_vramTotalMB > 0)
+    {
+        uint64_t usedBytes = 0;
+        bool haveVram = readArray(m_vramUsageCounter, PDH_FMT_LARGE,
+            [&](const PDH_FMT_COUNTERVALUE_ITEM_W& item) {
+                // One instance per adapter; take the busiest (the render GPU)
+                if (item.FmtValue.CStatus == ERROR_SUCCESS)
+                    usedBytes = (std::max)(usedBytes, static_cast<uint64_t>(item.FmtValue.largeValue));
+            });
+        load.vram_total_mb = static_cast<uint32_t>(m_vramTotalMB);
+        if (haveVram)
+        {
+            uint64_t usedMB = usedBytes / (1024 * 1024);
+            load.vram_free_mb = static_cast<uint32_t>(m_vramTotalMB > usedMB ? m_vramTotalMB - usedMB : 0);
+        }
+    }
+#else
+    (void)load;
+#endif
+}
+
+} // namespace SR
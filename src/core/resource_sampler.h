@@ -0,0 +1,42 @@
+#pragma once
+
+#include "core/heartbeat.h"
+
+#include <cstdint>
+#include <filesystem>
+
+namespace SR {
+
+// Samples this machine's live load for the heartbeat: CPU utilization since
+// the previous sample, free RAM, GPU utilization and free VRAM (Windows, via
+// the "GPU Engine" / "GPU Adapter Memory" performance counters), and free
+// space on one disk. The first sample has no CPU/GPU rate yet.
+//
+// Not thread-safe; owned and called by one thread.
+class ResourceSampler
+{
+public:
+    ResourceSampler() = default;
+    ~ResourceSampler();
+
+    ResourceSampler(const ResourceSampler&) = delete;
+    ResourceSampler& operator=(const ResourceSampler&) = delete;
+
+    NodeLoad sample(const std::filesystem::path& diskPath);
+
+private:
+    int sampleCpu();
+    void openGpuCounters();
+    void sampleGpu(NodeLoad& load);
+
+    uint64_t m_prevIdle = 0;
+    uint64_t m_prevTotal = 0;
+
+    bool m_gpuOpened = false;
+    void* m_pdhQuery = nullptr;         // PDH_HQUERY
+    void* m_gpuEngineCounter = nullptr; // PDH_HCOUNTER
+    void* m_vramUsageCounter = nullptr; // PDH_HCOUNTER
+    uint64_t m_vramTotalMB = 0;         // dedicated memory of adapter 0
+};
+
+} // namespace SR
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace SR {
+
+// Bounded single-producer / single-consumer ring of reusable slots.
+//
+// Slots are constructed once and handed back and forth, so a T holding
+// vectors or strings keeps its capacity across uses (clear, don't reassign).
+// The producer fills beginWrite()'s slot and publishes it with commitWrite();
+// the consumer reads front() in place and releases it with pop().
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    // Producer: free slot to fill, or nullptr if the ring is full
+    T* beginWrite()
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return nullptr;
+        return &m_slots[tail & (Capacity - 1)];
+    }
+
+    // Producer: publish the slot returned by beginWrite()
+    void commitWrite()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer: oldest published slot, or nullptr if empty
+    T* front()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return nullptr;
+        return &m_slots[head & (Capacity - 1)];
+    }
+
+    // Consumer: release the slot returned by front()
+    void pop()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    std::array<T, Capacity> m_slots{};
+    alignas(64) std::atomic<size_t> m_head{0};  // next slot to consume
+    alignas(64) std::atomic<size_t> m_tail{0};  // next slot to fill
+};
+
+} // namespace SR
@@ -0,0 +1,622 @@
+#ifdef _WIN32
+#define FD_SETSIZE 256      // before WinSock2.h; the default 64 caps the farm size
+#endif
+
+#include "core/tcp_link.h"
+
+#ifdef _WIN32
+#include <WS2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace SR {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#ifdef _WIN32
+bool ensureWSA()
+{
+    static const bool ok = [] {
+        WSADATA wsa;
+        return WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+    }();
+    return ok;
+}
+#endif
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;    // a dead peer is an error, not SIGPIPE
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+constexpr size_t MAX_PEERS = FD_SETSIZE - 8;
+constexpr size_t COMPACT_BYTES = 64 * 1024;
+
+void closeSock(SocketType s)
+{
+#ifdef _WIN32
+    closesocket(s);
+#else
+    close(s);
+#endif
+}
+
+void setNonBlocking(SocketType s)
+{
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+    int flags = fcntl(s, F_GETFL, 0);
+    fcntl(s, F_SETFL, flags | O_NONBLOCK);
+#endif
+}
+
+void setNoDelay(SocketType s)
+{
+    // Control messages are small and latency-bound
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+}
+
+bool wouldBlock()
+{
+#ifdef _WIN32
+    int e = WSAGetLastError();
+    return e == WSAEWOULDBLOCK || e == WSAEINPROGRESS;
+#else
+    return errno == EWOULDBLOCK || errno == EAGAIN || errno == EINPROGRESS || errno == EINTR;
+#endif
+}
+
+int64_t msSince(Clock::time_point t, Clock::time_point now)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - t).count();
+}
+
+} // namespace
+
+TcpLink::~TcpLink()
+{
+    stop();
+}
+
+// ─── Lifecycle ──────────────────────────────────────────────────────────────
+
+bool TcpLink::listen(const std::string& nodeId, uint16_t port)
+{
+    if (m_running.load())
+        return true;
+
+#ifdef _WIN32
+    if (!ensureWSA())
+        return false;
+#endif
+
+    SocketType s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCK)
+        return false;
+
+#ifndef _WIN32
+    // Rebind straight after a restart (TIME_WAIT); on Windows this would
+    // let another process steal the port
+    int reuse = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+#endif
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(s, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(s, SOMAXCONN) != 0)
+    {
+        closeSock(s);
+        return false;
+    }
+    setNonBlocking(s);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_listenSock = s;
+        m_listenPort = port;
+    }
+    return startThread(nodeId);
+}
+
+bool TcpLink::startClient(const std::string& nodeId)
+{
+    if (m_running.load())
+        return true;
+
+#ifdef _WIN32
+    if (!ensureWSA())
+        return false;
+#endif
+
+    return startThread(nodeId);
+}
+
+bool TcpLink::startThread(const std::string& nodeId)
+{
+    m_nodeId = nodeId;
+    m_running.store(true);
+    m_thread = std::thread(&TcpLink::threadFunc, this);
+    return true;
+}
+
+void TcpLink::stop()
+{
+    if (!m_running.exchange(false))
+        return;
+
+    if (m_thread.joinable())
+        m_thread.join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& c : m_conns)
+        closeSock(c->sock);
+    m_conns.clear();
+    if (m_listenSock != INVALID_SOCK)
+        closeSock(m_listenSock);
+    m_listenSock = INVALID_SOCK;
+    m_listenPort = 0;
+    m_inbox.clear();
+    m_targetPeer.clear();
+    m_targetHost.clear();
+    m_targetPort = 0;
+}
+
+void TcpLink::connectTo(const std::string& peerId, const std::string& host, uint16_t port)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (peerId == m_targetPeer && host == m_targetHost && port == m_targetPort)
+        return;
+
+    m_targetPeer = peerId;
+    m_targetHost = host;
+    m_targetPort = port;
+    m_nextConnect = {};
+    for (auto& c : m_conns)
+        c->closed = true;   // new coordinator (or address): drop the old link
+}
+
+void TcpLink::disconnect()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_targetPeer.clear();
+    m_targetHost.clear();
+    m_targetPort = 0;
+    for (auto& c : m_conns)
+        c->closed = true;
+}
+
+// ─── Send / receive ─────────────────────────────────────────────────────────
+
+bool TcpLink::send(const std::string& peerId, const nlohmann::json& msg)
+{
+    if (!m_running.load() || peerId.empty())
+        return false;
+
+    std::string body = msg.dump();
+    if (body.size() > MAX_FRAME_BYTES)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& c : m_conns)
+    {
+        if (!c->ready || c->closed || c->peerId != peerId)
+            continue;
+        if (c->out.size() - c->outPos > HIGH_WATER_BYTES)
+            return false;
+        queueFrame(*c, body);
+        drain(*c);
+        return !c->closed;
+    }
+    return false;
+}
+
+void TcpLink::broadcast(const nlohmann::json& msg)
+{
+    if (!m_running.load())
+        return;
+
+    std::string body = msg.dump();
+    if (body.size() > MAX_FRAME_BYTES)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& c : m_conns)
+    {
+        if (!c->ready || c->closed || c->out.size() - c->outPos > HIGH_WATER_BYTES)
+            continue;
+        queueFrame(*c, body);
+        drain(*c);
+    }
+}
+
+std::vector<nlohmann::json> TcpLink::poll()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<nlohmann::json> out(std::make_move_iterator(m_inbox.begin()),
+                                    std::make_move_iterator(m_inbox.end()));
+    m_inbox.clear();
+    return out;
+}
+
+bool TcpLink::isConnected(const std::string& peerId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& c : m_conns)
+        if (c->ready && !c->closed && c->peerId == peerId)
+            return true;
+    return false;
+}
+
+size_t TcpLink::peerCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<size_t>(std::count_if(m_conns.begin(), m_conns.end(),
+        [](const auto& c) { return c->ready && !c->closed; }));
+}
+
+void TcpLink::queueFrame(Conn& c, const std::string& body)
+{
+    if (c.outPos == c.out.size())
+    {
+        c.out.clear();
+        c.outPos = 0;
+        c.lastDrain = Clock::now();     // stall clock starts with the first queued byte
+    }
+
+    auto len = static_cast<uint32_t>(body.size());
+    char hdr[4] = {
+        static_cast<char>(len >> 24), static_cast<char>(len >> 16),
+        static_cast<char>(len >> 8),  static_cast<char>(len),
+    };
+    c.out.append(hdr, sizeof(hdr));
+    c.out += body;
+}
+
+void TcpLink::sendHello(Conn& c)
+{
+    queueFrame(c, nlohmann::json{{"t", "hello"}, {"from", m_nodeId}}.dump());
+    drain(c);
+}
+
+void TcpLink::drain(Conn& c)
+{
+    while (c.outPos < c.out.size())
+    {
+        size_t chunk = std::min(c.out.size() - c.outPos, COMPACT_BYTES);
+        auto n = ::send(c.sock, c.out.data() + c.outPos, static_cast<int>(chunk), SEND_FLAGS);
+        if (n > 0)
+        {
+            c.outPos += static_cast<size_t>(n);
+            c.lastDrain = Clock::now();
+            continue;
+        }
+        if (n < 0 && wouldBlock())
+            break;
+        c.closed = true;
+        return;
+    }
+
+    if (c.outPos == c.out.size())
+    {
+        c.out.clear();
+        c.outPos = 0;
+    }
+    else if (c.outPos >= COMPACT_BYTES)
+    {
+        c.out.erase(0, c.outPos);
+        c.outPos = 0;
+    }
+}
+
+void TcpLink::readFrom(Conn& c)
+{
+    char buf[16 * 1024];
+    for (;;)
+    {
+        auto n = ::recv(c.sock, buf, static_cast<int>(sizeof(buf)), 0);
+        if (n > 0)
+        {
+            c.in.append(buf, static_cast<size_t>(n));
+            c.lastRecv = Clock::now();
+            if (static_cast<size_t>(n) < sizeof(buf))
+                break;
+            continue;
+        }
+        if (n < 0 && wouldBlock())
+            break;
+        c.closed = true;    // 0 = orderly shutdown
+        break;
+    }
+
+    size_t pos = 0;
+    while (!c.closed && c.in.size() - pos >= 4)
+    {
+        auto p = reinterpret_cast<const unsigned char*>(c.in.data() + pos);
+        uint32_t len = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+                       (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+        if (len > MAX_FRAME_BYTES)
+        {
+            std::cerr << "[TcpLink] Oversized frame from " << c.peerId << ", dropping link" << std::endl;
+            c.closed = true;
+            break;
+        }
+        if (c.in.size() - pos - 4 < len)
+            break;
+        handleFrame(c, c.in.data() + pos + 4, len);
+        pos += 4 + len;
+    }
+    c.in.erase(0, pos);
+}
+
+void TcpLink::handleFrame(Conn& c, const char* data, size_t len)
+{
+    nlohmann::json msg;
+    try
+    {
+        msg = nlohmann::json::parse(data, data + len);
+    }
+    catch (...)
+    {
+        c.closed = true;    // a stream can't resync past a bad frame
+        return;
+    }
+
+    if (msg.value("t", "") == "hello")
+    {
+        std::string from = msg.value("from", "");
+        if (c.ready || from.empty())
+            return;
+
+        // Worker: only the coordinator we looked up counts
+        if (m_listenSock == INVALID_SOCK && from != m_targetPeer)
+        {
+            std::cerr << "[TcpLink] Expected " << m_targetPeer << " but reached " << from << std::endl;
+            c.closed = true;
+            return;
+        }
+
+        // Coordinator: a reconnect supersedes the peer's older connection
+        for (auto& other : m_conns)
+            if (other.get() != &c && other->peerId == from)
+                other->closed = true;
+
+        c.peerId = from;
+        c.ready = true;
+        return;
+    }
+
+    if (c.ready)
+        m_inbox.push_back(std::move(msg));
+}
+
+// ─── I/O thread ─────────────────────────────────────────────────────────────
+
+void TcpLink::openClient()
+{
+    std::string host;
+    uint16_t port = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_listenSock != INVALID_SOCK || m_targetHost.empty() || !m_conns.empty() ||
+            Clock::now() < m_nextConnect)
+            return;
+        host = m_targetHost;
+        port = m_targetPort;
+        m_nextConnect = Clock::now() + std::chrono::milliseconds(RECONNECT_MS);
+    }
+
+    // Resolve outside the lock: senders must never wait on DNS
+    struct addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* res = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0 || !res)
+        return;
+
+    SocketType s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCK)
+    {
+        freeaddrinfo(res);
+        return;
+    }
+    setNonBlocking(s);
+    setNoDelay(s);
+
+    int rc = connect(s, res->ai_addr, static_cast<int>(res->ai_addrlen));
+    freeaddrinfo(res);
+    if (rc != 0 && !wouldBlock())
+    {
+        closeSock(s);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (host != m_targetHost || port != m_targetPort)
+    {
+        closeSock(s);   // re-targeted meanwhile
+        return;
+    }
+
+    auto c = std::make_unique<Conn>();
+    c->sock = s;
+    c->connecting = rc != 0;
+    c->lastRecv = c->lastDrain = Clock::now();
+    m_connectStarted = Clock::now();
+    if (!c->connecting)
+        sendHello(*c);
+    m_conns.push_back(std::move(c));
+}
+
+void TcpLink::acceptPending()
+{
+    for (;;)
+    {
+        SocketType s = accept(m_listenSock, nullptr, nullptr);
+        if (s == INVALID_SOCK)
+            return;
+
+        if (m_conns.size() >= MAX_PEERS)
+        {
+            closeSock(s);   // worker stays on UDP + filesystem
+            continue;
+        }
+
+        setNonBlocking(s);
+        setNoDelay(s);
+        auto c = std::make_unique<Conn>();
+        c->sock = s;
+        c->lastRecv = c->lastDrain = Clock::now();
+        sendHello(*c);
+        m_conns.push_back(std::move(c));
+    }
+}
+
+void TcpLink::reap()
+{
+    std::erase_if(m_conns, [](const std::unique_ptr<Conn>& c) {
+        if (!c->closed)
+            return false;
+        if (c->ready)
+            std::cerr << "[TcpLink] Link to " << c->peerId << " closed" << std::endl;
+        closeSock(c->sock);
+        return true;
+    });
+}
+
+void TcpLink::threadFunc()
+{
+    while (m_running.load())
+    {
+        openClient();
+
+        fd_set rfds, wfds, efds;
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        FD_ZERO(&efds);
+        SocketType maxSock = 0;
+        bool any = false;
+        auto add = [&](SocketType s, fd_set& set) {
+            FD_SET(s, &set);
+            maxSock = std::max(maxSock, s);
+            any = true;
+        };
+
+        // Only this thread adds or removes connections, so the sockets stay
+        // valid across the unlocked select()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            reap();
+            if (m_listenSock != INVALID_SOCK)
+                add(m_listenSock, rfds);
+            for (const auto& c : m_conns)
+            {
+                if (c->connecting)
+                {
+                    add(c->sock, wfds);
+                    add(c->sock, efds);
+                    continue;
+                }
+                add(c->sock, rfds);
+                if (c->outPos < c->out.size())
+                    add(c->sock, wfds);
+            }
+        }
+
+        if (!any)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MS));
+            continue;
+        }
+
+        struct timeval tv{};
+        tv.tv_usec = SELECT_TIMEOUT_MS * 1000;
+        if (select(static_cast<int>(maxSock) + 1, &rfds, &wfds, &efds, &tv) < 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MS));
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = Clock::now();
+
+        if (m_listenSock != INVALID_SOCK && FD_ISSET(m_listenSock, &rfds))
+            acceptPending();
+
+        for (auto& cp : m_conns)
+        {
+            auto& c = *cp;
+            if (c.closed || c.sock == INVALID_SOCK)
+                continue;
+
+            if (c.connecting)
+            {
+                if (FD_ISSET(c.sock, &wfds) || FD_ISSET(c.sock, &efds))
+                {
+                    int err = 0;
+#ifdef _WIN32
+                    int errLen = sizeof(err);
+#else
+                    socklen_t errLen = sizeof(err);
+#endif
+                    getsockopt(c.sock, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&err), &errLen);
+                    if (err != 0)
+                    {
+                        c.closed = true;
+                        continue;
+                    }
+                    c.connecting = false;
+                    c.lastRecv = now;
+                    sendHello(c);
+                }
+                else if (msSince(m_connectStarted, now) > CONNECT_TIMEOUT_MS)
+                {
+                    c.closed = true;
+                }
+                continue;
+            }
+
+            if (FD_ISSET(c.sock, &rfds))
+                readFrom(c);
+            if (!c.closed && FD_ISSET(c.sock, &wfds))
+                drain(c);
+
+            if (!c.closed && msSince(c.lastRecv, now) > IDLE_TIMEOUT_MS)
+            {
+                std::cerr << "[TcpLink] No traffic from " << (c.peerId.empty() ? "peer" : c.peerId)
+                          << " for " << IDLE_TIMEOUT_MS << "ms, dropping link" << std::endl;
+                c.closed = true;
+            }
+            if (!c.closed && c.outPos < c.out.size() && msSince(c.lastDrain, now) > IDLE_TIMEOUT_MS)
+            {
+                std::cerr << "[TcpLink] " << c.peerId << " stopped reading, dropping link" << std::endl;
+                c.closed = true;
+            }
+        }
+    }
+}
+
+} // namespace SR
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "core/udp_notify.h"    // SocketType, INVALID_SOCK
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SR {
+
+// Persistent TCP control link between the coordinator and its workers.
+//
+// The coordinator listens; each worker keeps one connection to it, found via
+// the coordinator's heartbeat (hostname + "tcp_port", or the UDP sender
+// address). Frames are a u32 big-endian length followed by one JSON object,
+// and both ends open with {"t":"hello","from":id} so connections are keyed
+// by node id. Messages are the same ones the UDP fast path carries.
+//
+// Backpressure: send() refuses a message once a peer has HIGH_WATER_BYTES
+// unsent, and the caller falls back to UDP or the filesystem, which stays the
+// durable path. A peer silent for IDLE_TIMEOUT_MS (heartbeats cross the link
+// every few seconds) or not draining its socket is dropped.
+//
+// One I/O thread accepts, connects, reads and drains; send() writes straight
+// to the socket when nothing is queued ahead of it (thread-safe).
+class TcpLink
+{
+public:
+    TcpLink() = default;
+    ~TcpLink();
+
+    TcpLink(const TcpLink&) = delete;
+    TcpLink& operator=(const TcpLink&) = delete;
+
+    // Coordinator: accept workers on port. False if the port can't be bound.
+    bool listen(const std::string& nodeId, uint16_t port);
+
+    // Worker: start idle; connectTo() picks (and later re-picks) the coordinator
+    bool startClient(const std::string& nodeId);
+    void connectTo(const std::string& peerId, const std::string& host, uint16_t port);
+    void disconnect();
+
+    void stop();
+
+    // False if the peer isn't connected or is backed up (caller falls back)
+    bool send(const std::string& peerId, const nlohmann::json& msg);
+    void broadcast(const nlohmann::json& msg);
+
+    // Messages received since the last call (main thread)
+    std::vector<nlohmann::json> poll();
+
+    bool isRunning() const { return m_running.load(); }
+    bool isConnected(const std::string& peerId) const;
+    size_t peerCount() const;
+    uint16_t listenPort() const { return m_listenPort; }
+
+    static constexpr size_t MAX_FRAME_BYTES  = 1024 * 1024;
+    static constexpr size_t HIGH_WATER_BYTES = 256 * 1024;
+    static constexpr int IDLE_TIMEOUT_MS     = 15000;
+    static constexpr int CONNECT_TIMEOUT_MS  = 1000;
+    static constexpr int RECONNECT_MS        = 2000;
+    static constexpr int SELECT_TIMEOUT_MS   = 50;
+
+private:
+    struct Conn
+    {
+        SocketType sock = INVALID_SOCK;
+        std::string peerId;         // set by the peer's hello
+        bool connecting = false;    // client: non-blocking connect in flight
+        bool ready = false;         // hello received
+        bool closed = false;        // error seen; the I/O thread reaps it
+        std::string in;
+        std::string out;
+        size_t outPos = 0;
+        std::chrono::steady_clock::time_point lastRecv{};
+        std::chrono::steady_clock::time_point lastDrain{};   // last write progress
+    };
+
+    bool startThread(const std::string& nodeId);
+    void threadFunc();
+    void openClient();                  // caller holds m_mutex
+    void acceptPending();               // caller holds m_mutex
+    void readFrom(Conn& c);             // caller holds m_mutex
+    void drain(Conn& c);                // caller holds m_mutex
+    void queueFrame(Conn& c, const std::string& body); // caller holds m_mutex
+    void sendHello(Conn& c);            // caller holds m_mutex
+    void handleFrame(Conn& c, const char* data, size_t len);
+    void reap();                        // caller holds m_mutex
+
+    std::string m_nodeId;
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+
+    mutable std::mutex m_mutex;
+    SocketType m_listenSock = INVALID_SOCK;
+    uint16_t m_listenPort = 0;
+    std::vector<std::unique_ptr<Conn>> m_conns;
+    std::deque<nlohmann::json> m_inbox;
+
+    // Worker target (under m_mutex)
+    std::string m_targetPeer;
+    std::string m_targetHost;
+    uint16_t m_targetPort = 0;
+    std::chrono::steady_clock::time_point m_nextConnect{};
+    std::chrono::steady_clock::time_point m_connectStarted{};
+};
+
+} // namespace SR
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SR {
+
+// A string with {token} placeholders, split once into literal and token
+// segments so it can be rendered any number of times in a single pass.
+//
+// Tokens named in the list given at compile time carry its index as their
+// id, so hot callers switch on an int instead of comparing names; any other
+// {name} gets id UNNAMED. The resolver appends a token's value and returns
+// true, or returns false to keep "{name}" as written. Values are never
+// rescanned for tokens.
+class TokenTemplate
+{
+public:
+    static constexpr int UNNAMED = -1;
+
+    TokenTemplate() = default;
+
+    explicit TokenTemplate(std::string text, std::initializer_list<std::string_view> names = {})
+        : m_text(std::move(text))
+    {
+        size_t literalStart = 0;
+        size_t pos = 0;
+        while ((pos = m_text.find('{', pos)) != std::string::npos)
+        {
+            size_t close = m_text.find('}', pos + 1);
+            if (close == std::string::npos)
+                break;
+            // "{a{b}": the token starts at the last brace before the close
+            size_t inner = m_text.rfind('{', close);
+            if (inner > pos)
+                pos = inner;
+            if (close == pos + 1)
+            {
+                pos = close + 1;        // "{}" is text
+                continue;
+            }
+
+            if (pos > literalStart)
+                m_segments.push_back({uint32_t(literalStart), uint32_t(pos - literalStart), LITERAL});
+            std::string_view name(m_text.data() + pos + 1, close - pos - 1);
+            int id = UNNAMED;
+            int index = 0;
+            for (auto n : names)
+            {
+                if (n == name) { id = index; break; }
+                ++index;
+            }
+            m_segments.push_back({uint32_t(pos + 1), uint32_t(name.size()), id});
+            ++m_tokens;
+            pos = literalStart = close + 1;
+        }
+        if (literalStart < m_text.size())
+            m_segments.push_back({uint32_t(literalStart), uint32_t(m_text.size() - literalStart), LITERAL});
+    }
+
+    bool hasTokens() const { return m_tokens > 0; }
+    const std::string& text() const { return m_text; }
+
+    // fn(int id, std::string_view name, std::string& out) -> bool
+    template <typename Fn>
+    void renderTo(std::string& out, Fn&& fn) const
+    {
+        for (const auto& seg : m_segments)
+        {
+            std::string_view piece(m_text.data() + seg.offset, seg.length);
+            if (seg.id == LITERAL)
+            {
+                out.append(piece);
+            }
+            else if (!fn(seg.id, piece, out))
+            {
+                out += '{';
+                out.append(piece);
+                out += '}';
+            }
+        }
+    }
+
+    template <typename Fn>
+    std::string render(Fn&& fn) const
+    {
+        if (m_tokens == 0)
+            return m_text;
+        std::string out;
+        out.reserve(m_text.size() + 16);
+        renderTo(out, fn);
+        return out;
+    }
+
+private:
+    static constexpr int LITERAL = -2;
+
+    // Literal: the text itself. Token: its name, inside the braces.
+    struct Segment
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        int id = LITERAL;
+    };
+
+    std::string m_text;
+    std::vector<Segment> m_segments;
+    size_t m_tokens = 0;
+};
+
+} // namespace SR
@@ -12,6 +12,7 @@
 #include <cerrno>
 #endif
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 
@@ -31,6 +32,208 @@ static bool ensureWSA()
 }
 #endif
 
+namespace {
+
+// Append-only: the index is the wire key
+const char* const KEY_TABLE[] = {
+    nullptr,        // 0 = inline name
+    "t", "from", "n", "seq", "ts", "st", "rs", "coord", "job",
+    "_version", "timestamp_ms", "type", "job_id", "reason",
+    "frame_start", "frame_end", "msg_id", "target",
+    "ep", "c", "j", "wv",
+};
+constexpr size_t KEY_COUNT = sizeof(KEY_TABLE) / sizeof(KEY_TABLE[0]);
+
+enum : uint8_t
+{
+    V_NULL = 0, V_FALSE = 1, V_TRUE = 2, V_INT = 3, V_UINT = 4,
+    V_DOUBLE = 5, V_STRING = 6, V_SELF = 7, V_PACKED = 8,
+};
+
+constexpr uint8_t MAGIC0 = 'S', MAGIC1 = 'R';
+constexpr uint8_t FLAG_NODE_ID = 0x01;
+constexpr size_t HEADER_SIZE = 9;
+
+uint32_t hashNodeId(const std::string& id)
+{
+    uint32_t h = 2166136261u;
+    for (unsigned char c : id)
+    {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void putVarint(std::string& out, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+bool getVarint(const char*& p, const char* end, uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7)
+    {
+        auto b = static_cast<uint8_t>(*p++);
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+void putU16(std::string& out, size_t pos, uint16_t v)
+{
+    out[pos] = static_cast<char>(v & 0xFF);
+    out[pos + 1] = static_cast<char>(v >> 8);
+}
+
+// One message body: a field per top-level key of a JSON object
+std::string encodeMessage(const nlohmann::json& msg, const std::string& self)
+{
+    std::string out;
+    for (const auto& [key, val] : msg.items())
+    {
+        // "from" is implied by the header
+        if (key == "from")
+            continue;
+
+        size_t k = 0;
+        for (size_t i = 1; i < KEY_COUNT; ++i)
+            if (key == KEY_TABLE[i]) { k = i; break; }
+        out += static_cast<char>(k);
+        if (k == 0)
+        {
+            out += static_cast<char>(std::min<size_t>(key.size(), 255));
+            out.append(key, 0, std::min<size_t>(key.size(), 255));
+        }
+
+        if (val.is_null())
+            out += static_cast<char>(V_NULL);
+        else if (val.is_boolean())
+            out += static_cast<char>(val.get<bool>() ? V_TRUE : V_FALSE);
+        else if (val.is_number_unsigned())
+        {
+            out += static_cast<char>(V_UINT);
+            putVarint(out, val.get<uint64_t>());
+        }
+        else if (val.is_number_integer())
+        {
+            int64_t v = val.get<int64_t>();
+            out += static_cast<char>(V_INT);
+            putVarint(out, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+        }
+        else if (val.is_number_float())
+        {
+            double d = val.get<double>();
+            out += static_cast<char>(V_DOUBLE);
+            out.append(reinterpret_cast<const char*>(&d), sizeof(d));
+        }
+        else if (val.is_string())
+        {
+            const auto& str = val.get_ref<const std::string&>();
+            if (str == self)
+            {
+                out += static_cast<char>(V_SELF);
+                continue;
+            }
+            out += static_cast<char>(V_STRING);
+            putVarint(out, str.size());
+            out += str;
+        }
+        else
+        {
+            auto packed = nlohmann::json::to_msgpack(val);
+            out += static_cast<char>(V_PACKED);
+            putVarint(out, packed.size());
+            out.append(reinterpret_cast<const char*>(packed.data()), packed.size());
+        }
+    }
+    return out;
+}
+
+bool decodeMessage(const char* p, const char* end, const std::string& self, nlohmann::json& msg)
+{
+    msg = nlohmann::json::object();
+    while (p < end)
+    {
+        size_t k = static_cast<uint8_t>(*p++);
+        std::string key;
+        if (k == 0)
+        {
+            if (p >= end) return false;
+            size_t len = static_cast<uint8_t>(*p++);
+            if (static_cast<size_t>(end - p) < len) return false;
+            key.assign(p, len);
+            p += len;
+        }
+        else if (k < KEY_COUNT)
+        {
+            key = KEY_TABLE[k];
+        }
+        else
+        {
+            return false;   // newer key table than ours
+        }
+
+        if (p >= end) return false;
+        uint8_t type = static_cast<uint8_t>(*p++);
+        uint64_t v = 0;
+        switch (type)
+        {
+        case V_NULL:  msg[key] = nullptr; break;
+        case V_FALSE: msg[key] = false; break;
+        case V_TRUE:  msg[key] = true; break;
+        case V_SELF:  msg[key] = self; break;
+        case V_UINT:
+            if (!getVarint(p, end, v)) return false;
+            msg[key] = v;
+            break;
+        case V_INT:
+            if (!getVarint(p, end, v)) return false;
+            msg[key] = static_cast<int64_t>((v >> 1) ^ (~(v & 1) + 1));
+            break;
+        case V_DOUBLE:
+        {
+            double d;
+            if (static_cast<size_t>(end - p) < sizeof(d)) return false;
+            std::memcpy(&d, p, sizeof(d));
+            p += sizeof(d);
+            msg[key] = d;
+            break;
+        }
+        case V_STRING:
+        case V_PACKED:
+        {
+            if (!getVarint(p, end, v) || static_cast<uint64_t>(end - p) < v) return false;
+            if (type == V_STRING)
+                msg[key] = std::string(p, static_cast<size_t>(v));
+            else
+            {
+                auto packed = nlohmann::json::from_msgpack(
+                    reinterpret_cast<const uint8_t*>(p),
+                    reinterpret_cast<const uint8_t*>(p) + v, true, false);
+                if (packed.is_discarded()) return false;
+                msg[key] = std::move(packed);
+            }
+            p += v;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 UdpNotify::~UdpNotify()
 {
     stop();
@@ -47,6 +250,16 @@ bool UdpNotify::start(const std::string& nodeId, uint16_t port, const std::strin
 #endif
 
     m_nodeId = nodeId;
+    m_nodeHash = hashNodeId(nodeId);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.clear();
+        m_peers.clear();
+        m_names.clear();
+        m_addrs.clear();
+        m_startedAt = std::chrono::steady_clock::now();
+        m_lastIdSent = {};
+    }
 
     // Create UDP socket
     m_socket = socket(AF_INET, SOCK_DGRAM, 0);
@@ -109,6 +322,8 @@ void UdpNotify::stop()
     if (m_socket == INVALID_SOCK)
         return;
 
+    flush();    // goodbye and anything else still queued
+
 #ifdef _WIN32
     closesocket(m_socket);
 #else
@@ -122,14 +337,190 @@ void UdpNotify::send(const nlohmann::json& msg)
     if (m_socket == INVALID_SOCK)
         return;
 
-    std::string data = msg.dump();
-    if (data.size() > MAX_MSG_SIZE)
-        return; // MTU guard — drop oversized messages
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.push_back(msg);
+}
+
+void UdpNotify::flush()
+{
+    if (m_socket == INVALID_SOCK)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pending.empty())
+        return;
+
+    std::vector<nlohmann::json> pending;
+    pending.swap(m_pending);
+
+    if (!useBinary())
+    {
+        // Legacy framing: one JSON object per datagram
+        for (auto& msg : pending)
+        {
+            msg["wv"] = WIRE_VERSION;
+            std::string data = msg.dump();
+            if (data.size() > MAX_MSG_SIZE)
+                continue; // MTU guard — drop oversized messages
+            sendDatagram(data);
+        }
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::string dgram;
+    uint8_t count = 0;
+
+    auto beginDatagram = [&]() {
+        bool withId = now - m_lastIdSent >= std::chrono::milliseconds(ID_RESEND_MS);
+        dgram.clear();
+        dgram += static_cast<char>(MAGIC0);
+        dgram += static_cast<char>(MAGIC1);
+        dgram += static_cast<char>(WIRE_VERSION);
+        dgram += static_cast<char>(withId ? FLAG_NODE_ID : 0);
+        for (int i = 0; i < 4; ++i)
+            dgram += static_cast<char>((m_nodeHash >> (8 * i)) & 0xFF);
+        dgram += '\0';     // message count, patched on send
+        if (withId)
+        {
+            dgram += static_cast<char>(std::min<size_t>(m_nodeId.size(), 255));
+            dgram.append(m_nodeId, 0, std::min<size_t>(m_nodeId.size(), 255));
+            m_lastIdSent = now;
+        }
+        count = 0;
+    };
+    auto sendCurrent = [&]() {
+        if (count == 0)
+            return;
+        dgram[HEADER_SIZE - 1] = static_cast<char>(count);
+        sendDatagram(dgram);
+    };
+
+    beginDatagram();
+    for (const auto& msg : pending)
+    {
+        std::string body = encodeMessage(msg, m_nodeId);
+        size_t need = 2 + body.size();
 
+        if (count > 0 && (dgram.size() + need > MAX_MSG_SIZE || count == 255))
+        {
+            sendCurrent();
+            beginDatagram();
+        }
+        if (dgram.size() + need > MAX_MSG_SIZE)
+            continue; // MTU guard — drop oversized messages
+
+        size_t pos = dgram.size();
+        dgram.append(2, '\0');
+        putU16(dgram, pos, static_cast<uint16_t>(body.size()));
+        dgram += body;
+        ++count;
+    }
+    sendCurrent();
+}
+
+void UdpNotify::sendDatagram(const std::string& data)
+{
     sendto(m_socket, data.c_str(), static_cast<int>(data.size()), 0,
            reinterpret_cast<struct sockaddr*>(&m_groupAddr), sizeof(m_groupAddr));
 }
 
+bool UdpNotify::isBinary() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return useBinary();
+}
+
+bool UdpNotify::useBinary() const
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_startedAt < std::chrono::milliseconds(NEGOTIATE_MS))
+        return false;   // haven't heard the farm yet
+
+    for (const auto& [hash, peer] : m_peers)
+    {
+        if (!peer.binary && now - peer.lastSeen < std::chrono::milliseconds(PEER_TTL_MS))
+            return false;
+    }
+    return true;
+}
+
+void UdpNotify::notePeer(uint32_t hash, bool binary)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& peer = m_peers[hash];
+    peer.binary = binary;
+    peer.lastSeen = std::chrono::steady_clock::now();
+}
+
+bool UdpNotify::decodeBinary(const char* data, size_t len, std::vector<nlohmann::json>& out)
+{
+    if (len < HEADER_SIZE || static_cast<uint8_t>(data[2]) > WIRE_VERSION)
+        return false;
+
+    uint8_t flags = static_cast<uint8_t>(data[3]);
+    uint32_t hash = 0;
+    for (int i = 0; i < 4; ++i)
+        hash |= static_cast<uint32_t>(static_cast<uint8_t>(data[4 + i])) << (8 * i);
+    size_t count = static_cast<uint8_t>(data[8]);
+
+    if (hash == m_nodeHash)
+        return true;    // self-sent
+
+    const char* p = data + HEADER_SIZE;
+    const char* end = data + len;
+    if (flags & FLAG_NODE_ID)
+    {
+        if (p >= end) return false;
+        size_t idLen = static_cast<uint8_t>(*p++);
+        if (static_cast<size_t>(end - p) < idLen) return false;
+        m_names[hash].assign(p, idLen);
+        p += idLen;
+    }
+
+    notePeer(hash, true);
+
+    auto nameIt = m_names.find(hash);
+    if (nameIt == m_names.end())
+        return false;   // not introduced yet; its next datagram with an id will be
+    const std::string& from = nameIt->second;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (end - p < 2) return false;
+        size_t bodyLen = static_cast<uint8_t>(p[0]) | (static_cast<size_t>(static_cast<uint8_t>(p[1])) << 8);
+        p += 2;
+        if (static_cast<size_t>(end - p) < bodyLen) return false;
+
+        nlohmann::json msg;
+        if (decodeMessage(p, p + bodyLen, from, msg))
+        {
+            msg["from"] = from;
+            out.push_back(std::move(msg));
+        }
+        p += bodyLen;
+    }
+    return true;
+}
+
+void UdpNotify::noteAddress(const std::string& nodeId, const struct sockaddr_in& sender)
+{
+    if (nodeId.empty())
+        return;
+    char text[INET_ADDRSTRLEN] = {};
+    if (!inet_ntop(AF_INET, &sender.sin_addr, text, sizeof(text)))
+        return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_addrs[nodeId] = text;
+}
+
+std::string UdpNotify::peerAddress(const std::string& nodeId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_addrs.find(nodeId);
+    return it != m_addrs.end() ? it->second : std::string();
+}
+
 std::vector<nlohmann::json> UdpNotify::poll()
 {
     std::vector<nlohmann::json> results;
@@ -154,6 +545,15 @@ std::vector<nlohmann::json> UdpNotify::poll()
         if (n <= 0)
             break; // EWOULDBLOCK or error — done
 
+        size_t first = results.size();
+        if (n >= 2 && static_cast<uint8_t>(buf[0]) == MAGIC0 && static_cast<uint8_t>(buf[1]) == MAGIC1)
+        {
+            decodeBinary(buf, static_cast<size_t>(n), results);
+            if (results.size() > first)
+                noteAddress(results[first].value("from", ""), sender);
+            continue;
+        }
+
         buf[n] = '\0';
 
         try
@@ -165,6 +565,13 @@ std::vector<nlohmann::json> UdpNotify::poll()
             if (from == m_nodeId)
                 continue;
 
+            // Untagged JSON is a peer that can't read binary yet
+            if (!from.empty())
+            {
+                notePeer(hashNodeId(from), msg.value("wv", 0) >= 1);
+                noteAddress(from, sender);
+            }
+
             results.push_back(std::move(msg));
         }
         catch (...)
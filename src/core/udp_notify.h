@@ -2,6 +2,9 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
 #include <cstdint>
 #include <nlohmann/json.hpp>
 
@@ -16,6 +19,21 @@ constexpr SocketType INVALID_SOCK = -1;
 
 namespace SR {
 
+// LAN multicast fast path.
+//
+// Two wire formats share the port. Legacy peers send one JSON object per
+// datagram. Current peers send binary datagrams of up to MAX_MSG_SIZE bytes:
+//   header   'S' 'R'  u8 version  u8 flags  u32 sender hash  u8 message count
+//            [u8 len + node id  — when FLAG_NODE_ID; resent every ID_RESEND_MS]
+//   message  u16 body length, then fields: u8 key, u8 type, payload
+// Keys index a fixed table of known field names (0 = inline name). Values are
+// varints, doubles, strings, a "sender's own id" marker, or msgpack for
+// arrays/objects. Receivers map the sender hash back to the node id learned
+// from FLAG_NODE_ID datagrams.
+//
+// A sender stays on JSON (tagged "wv") until it has listened for NEGOTIATE_MS
+// and no legacy peer was heard within PEER_TTL_MS, so mixed-version farms keep
+// talking during a rollout.
 class UdpNotify
 {
 public:
@@ -30,20 +48,55 @@ public:
                const std::string& group = "239.42.0.1");
     void stop();
 
-    // Fire-and-forget multicast send.
+    // Fire-and-forget multicast send. Queued until the next flush() (thread-safe).
     void send(const nlohmann::json& msg);
 
+    // Send everything queued, packed into as few datagrams as fit. Called once
+    // per main-loop tick and from stop().
+    void flush();
+
     // Non-blocking receive. Returns parsed messages, filtering out self-sent.
     std::vector<nlohmann::json> poll();
 
+    // IPv4 address a node's datagrams last came from ("" if never heard)
+    std::string peerAddress(const std::string& nodeId) const;
+
     bool isRunning() const { return m_socket != INVALID_SOCK; }
+    bool isBinary() const;      // current send format
+
+    static constexpr uint8_t WIRE_VERSION = 1;
 
 private:
+    void sendDatagram(const std::string& data);
+    bool useBinary() const;     // caller holds m_mutex
+    void notePeer(uint32_t hash, bool binary);
+    void noteAddress(const std::string& nodeId, const struct sockaddr_in& sender);
+    bool decodeBinary(const char* data, size_t len, std::vector<nlohmann::json>& out);
+
     SocketType m_socket = INVALID_SOCK;
     struct sockaddr_in m_groupAddr{};
     std::string m_nodeId;
+    uint32_t m_nodeHash = 0;
+
+    // Send queue and negotiation state
+    mutable std::mutex m_mutex;
+    std::vector<nlohmann::json> m_pending;
+    std::chrono::steady_clock::time_point m_startedAt{};
+    std::chrono::steady_clock::time_point m_lastIdSent{};
+
+    struct PeerWire
+    {
+        bool binary = false;
+        std::chrono::steady_clock::time_point lastSeen{};
+    };
+    std::map<uint32_t, PeerWire> m_peers;       // by node id hash
+    std::map<uint32_t, std::string> m_names;    // interned node ids
+    std::map<std::string, std::string> m_addrs; // node id -> sender address
 
     static constexpr size_t MAX_MSG_SIZE = 1400; // MTU guard
+    static constexpr int NEGOTIATE_MS = 10000;
+    static constexpr int PEER_TTL_MS = 30000;
+    static constexpr int ID_RESEND_MS = 2000;
 };
 
 } // namespace SR
@@ -0,0 +1,112 @@
+#include "core/wake_on_lan.h"
+
+#ifdef _WIN32
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+
+namespace SR {
+
+namespace {
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+constexpr SocketHandle NO_SOCKET = INVALID_SOCKET;
+
+bool ensureWSA()
+{
+    static const bool ok = [] {
+        WSADATA wsa;
+        return WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+    }();
+    return ok;
+}
+
+void closeSocket(SocketHandle s) { closesocket(s); }
+#else
+using SocketHandle = int;
+constexpr SocketHandle NO_SOCKET = -1;
+
+void closeSocket(SocketHandle s) { close(s); }
+#endif
+
+int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+bool parseMacAddress(const std::string& text, MacAddress& mac)
+{
+    if (text.size() != 17)
+        return false;
+    for (size_t i = 0; i < mac.size(); ++i)
+    {
+        size_t at = i * 3;
+        int hi = hexDigit(text[at]);
+        int lo = hexDigit(text[at + 1]);
+        if (hi < 0 || lo < 0)
+            return false;
+        if (i + 1 < mac.size() && text[at + 2] != ':' && text[at + 2] != '-')
+            return false;
+        mac[i] = static_cast<uint8_t>(hi * 16 + lo);
+    }
+    return true;
+}
+
+std::string formatMacAddress(const MacAddress& mac)
+{
+    char buf[18];
+    std::snprintf(buf, sizeof(buf), "%02x:%02x:%02x:%02x:%02x:%02x",
+                  mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return buf;
+}
+
+bool sendWakeOnLan(const std::string& mac, const std::string& broadcast, uint16_t port)
+{
+    MacAddress target;
+    if (!parseMacAddress(mac, target))
+        return false;
+
+#ifdef _WIN32
+    if (!ensureWSA())
+        return false;
+#endif
+
+    uint8_t packet[6 + 16 * 6];
+    std::memset(packet, 0xFF, 6);
+    for (size_t i = 0; i < 16; ++i)
+        std::memcpy(packet + 6 + i * 6, target.data(), target.size());
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, broadcast.c_str(), &addr.sin_addr) != 1)
+        return false;
+
+    SocketHandle s = socket(AF_INET, SOCK_DGRAM, 0);
+    if (s == NO_SOCKET)
+        return false;
+
+    int on = 1;
+    setsockopt(s, SOL_SOCKET, SO_BROADCAST, reinterpret_cast<const char*>(&on), sizeof(on));
+    auto sent = sendto(s, reinterpret_cast<const char*>(packet), static_cast<int>(sizeof(packet)), 0,
+                       reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr));
+    closeSocket(s);
+    return sent == static_cast<decltype(sent)>(sizeof(packet));
+}
+
+} // namespace SR
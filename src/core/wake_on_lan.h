@@ -0,0 +1,22 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace SR {
+
+// Wake-on-LAN: a magic packet (6 x 0xFF, then the target's MAC 16 times) sent
+// as a UDP broadcast. Only reaches nodes in the sender's broadcast domain, or
+// behind a directed broadcast address the routers forward.
+using MacAddress = std::array<uint8_t, 6>;
+
+// "aa:bb:cc:dd:ee:ff" or "aa-bb-cc-dd-ee-ff", either case
+bool parseMacAddress(const std::string& text, MacAddress& mac);
+std::string formatMacAddress(const MacAddress& mac);
+
+// Fire-and-forget; false if the MAC doesn't parse or the send failed
+bool sendWakeOnLan(const std::string& mac, const std::string& broadcast = "255.255.255.255",
+                   uint16_t port = 9);
+
+} // namespace SR
@@ -2,7 +2,10 @@
 
 #include <nlohmann/json.hpp>
 #include <filesystem>
+#include <map>
+#include <sstream>
 #include "core/monitor_log.h"
+#include "core/perf_counters.h"
 
 #ifdef _WIN32
 #include <Psapi.h>
@@ -10,6 +13,93 @@
 
 namespace SR {
 
+namespace {
+
+// "0-15,32-47" -> affinity mask. Bits past the first processor group (64) are
+// dropped: SetProcessAffinityMask only reaches the process's own group.
+uint64_t parseCpuSet(const std::string& spec)
+{
+    uint64_t mask = 0;
+    std::istringstream ss(spec);
+    std::string part;
+    while (std::getline(ss, part, ','))
+    {
+        try
+        {
+            auto dash = part.find('-');
+            int lo = std::stoi(part.substr(0, dash));
+            int hi = (dash == std::string::npos) ? lo : std::stoi(part.substr(dash + 1));
+            for (int cpu = (std::max)(lo, 0); cpu <= hi && cpu < 64; ++cpu)
+                mask |= uint64_t(1) << cpu;
+        }
+        catch (const std::exception&)
+        {
+            // Ignore malformed ranges; an empty mask leaves the agent unpinned
+        }
+    }
+    return mask;
+}
+
+#ifdef _WIN32
+std::wstring widen(const std::string& s)
+{
+    if (s.empty()) return {};
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.data(), (int)s.size(), nullptr, 0);
+    std::wstring out(len, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, s.data(), (int)s.size(), out.data(), len);
+    return out;
+}
+
+struct EnvNameLess
+{
+    bool operator()(const std::wstring& a, const std::wstring& b) const
+    {
+        return _wcsicmp(a.c_str(), b.c_str()) < 0;
+    }
+};
+
+// Our environment with "NAME=value;..." overrides applied, as a sorted,
+// double-NUL-terminated CREATE_UNICODE_ENVIRONMENT block
+std::wstring buildEnvironmentBlock(const std::string& overrides)
+{
+    std::map<std::wstring, std::wstring, EnvNameLess> vars;
+    if (wchar_t* env = GetEnvironmentStringsW())
+    {
+        for (const wchar_t* p = env; *p; p += wcslen(p) + 1)
+        {
+            std::wstring entry(p);
+            auto eq = entry.find(L'=', 1);     // "=C:=C:\\" style entries start with '='
+            if (eq != std::wstring::npos)
+                vars[entry.substr(0, eq)] = entry.substr(eq + 1);
+        }
+        FreeEnvironmentStringsW(env);
+    }
+
+    std::istringstream ss(overrides);
+    std::string pair;
+    while (std::getline(ss, pair, ';'))
+    {
+        auto eq = pair.find('=');
+        if (eq == std::string::npos || eq == 0)
+            continue;
+        vars[widen(pair.substr(0, eq))] = widen(pair.substr(eq + 1));
+    }
+
+    std::wstring block;
+    for (const auto& [name, value] : vars)
+    {
+        block += name;
+        block += L'=';
+        block += value;
+        block += L'\0';
+    }
+    block += L'\0';
+    return block;
+}
+#endif
+
+} // namespace
+
 AgentSupervisor::AgentSupervisor()
     : m_lastPingTime(std::chrono::steady_clock::now())
 {
@@ -20,11 +110,11 @@ AgentSupervisor::~AgentSupervisor()
     stop();
 }
 
-void AgentSupervisor::start(const std::string& nodeId)
+void AgentSupervisor::start(const std::string& agentId)
 {
-    m_nodeId = nodeId;
+    m_nodeId = agentId;
 
-    if (!m_ipc.create(nodeId))
+    if (!m_ipc.create(agentId))
     {
         MonitorLog::instance().error("agent", "Failed to create IPC pipe");
         return;
@@ -33,7 +123,7 @@ void AgentSupervisor::start(const std::string& nodeId)
     m_running = true;
     m_ipcThread = std::thread(&AgentSupervisor::ipcThreadFunc, this);
 
-    MonitorLog::instance().info("agent", "Started for node " + nodeId);
+    MonitorLog::instance().info("agent", "Started for " + agentId);
 }
 
 void AgentSupervisor::stop()
@@ -84,6 +174,12 @@ void AgentSupervisor::stop()
     MonitorLog::instance().info("agent", "Stopped");
 }
 
+void AgentSupervisor::setPin(const std::string& env, const std::string& cpuSet)
+{
+    m_pinEnv = env;
+    m_pinCpuSet = cpuSet;
+}
+
 bool AgentSupervisor::spawnAgent()
 {
 #ifdef _WIN32
@@ -107,13 +203,27 @@ bool AgentSupervisor::spawnAgent()
     si.cb = sizeof(si);
     PROCESS_INFORMATION pi{};
 
+    // Pinned slots: environment goes in at creation, affinity before the
+    // agent's first instruction so its renders inherit both
+    std::wstring envBlock;
+    DWORD flags = CREATE_NO_WINDOW;
+    if (!m_pinEnv.empty())
+    {
+        envBlock = buildEnvironmentBlock(m_pinEnv);
+        flags |= CREATE_UNICODE_ENVIRONMENT;
+    }
+    uint64_t affinity = parseCpuSet(m_pinCpuSet);
+    if (affinity != 0)
+        flags |= CREATE_SUSPENDED;
+
     BOOL ok = CreateProcessW(
         nullptr,
         cmdLine.data(),
         nullptr, nullptr,
         FALSE,
-        CREATE_NO_WINDOW,
-        nullptr, nullptr,
+        flags,
+        envBlock.empty() ? nullptr : envBlock.data(),
+        nullptr,
         &si, &pi
     );
 
@@ -123,11 +233,19 @@ bool AgentSupervisor::spawnAgent()
         return false;
     }
 
+    if (affinity != 0)
+    {
+        if (!SetProcessAffinityMask(pi.hProcess, static_cast<DWORD_PTR>(affinity)))
+            MonitorLog::instance().warn("agent", "Failed to pin " + m_nodeId + " to CPUs " +
+                                        m_pinCpuSet + ": " + std::to_string(GetLastError()));
+        ResumeThread(pi.hThread);
+    }
+
     m_processHandle = pi.hProcess;
     m_threadHandle = pi.hThread;
     m_agentPid = pi.dwProcessId;
 
-    MonitorLog::instance().info("agent", "Agent spawned, PID=" + std::to_string(m_agentPid));
+    MonitorLog::instance().info("agent", "Agent " + m_nodeId + " spawned, PID=" + std::to_string(m_agentPid));
     return true;
 #else
     MonitorLog::instance().error("agent", "spawnAgent not implemented on this platform");
@@ -202,7 +320,7 @@ bool AgentSupervisor::sendTask(const std::string& taskJson)
     return sendJson(taskJson);
 }
 
-void AgentSupervisor::setMessageHandler(std::function<void(const std::string&, const nlohmann::json&)> handler)
+void AgentSupervisor::setMessageHandler(std::function<void(const AgentMessage&)> handler)
 {
     m_messageHandler = std::move(handler);
 }
@@ -235,15 +353,13 @@ void AgentSupervisor::ipcThreadFunc()
 
             MonitorLog::instance().info("agent", "Agent connected via IPC");
 
-            // Receive loop
+            // Receive loop: every frame one read delivers is parsed here,
+            // off the main thread, then published in one go
             while (m_running && m_ipc.isConnected())
             {
-                auto msg = m_ipc.receive(1000); // 1s timeout for responsiveness
-                if (msg.has_value())
-                {
-                    std::lock_guard<std::mutex> lock(m_queueMutex);
-                    m_messageQueue.push(std::move(msg.value()));
-                }
+                m_ipc.receiveBatch([this](std::string_view frame) { parseFrame(frame); },
+                                   1000); // 1s timeout for responsiveness
+                publishOpen();
                 // On timeout, loop continues (checks m_running)
             }
 
@@ -287,50 +403,137 @@ void AgentSupervisor::ipcThreadFunc()
     }
 }
 
-void AgentSupervisor::processMessages()
+namespace {
+
+AgentMessage::Kind kindOf(const std::string& type)
+{
+    using Kind = AgentMessage::Kind;
+    if (type == "stdout")          return Kind::Stdout;
+    if (type == "progress")        return Kind::Progress;
+    if (type == "frame_completed") return Kind::FrameCompleted;
+    if (type == "ack")             return Kind::Ack;
+    if (type == "completed")       return Kind::Completed;
+    if (type == "failed")          return Kind::Failed;
+    if (type == "status")          return Kind::Status;
+    if (type == "pong")            return Kind::Pong;
+    return Kind::Other;
+}
+
+} // namespace
+
+AgentMessage* AgentSupervisor::openSlot()
+{
+    // Full ring: hold off reading so the pipe pushes back on the agent
+    while (m_running)
+    {
+        if (auto* slot = m_ring.beginWrite())
+            return slot;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return nullptr;
+}
+
+void AgentSupervisor::publishOpen()
+{
+    if (!m_open)
+        return;
+    m_ring.commitWrite();
+    m_open = nullptr;
+}
+
+void AgentSupervisor::parseFrame(std::string_view frame)
 {
-    // Drain the message queue on the main thread
-    std::queue<std::string> messages;
+    using Kind = AgentMessage::Kind;
+
+    nlohmann::json j;
+    try
+    {
+        j = nlohmann::json::parse(frame.begin(), frame.end());
+    }
+    catch (const std::exception& e)
     {
-        std::lock_guard<std::mutex> lock(m_queueMutex);
-        std::swap(messages, m_messageQueue);
+        MonitorLog::instance().error("agent", std::string("Failed to parse message: ") + e.what());
+        return;
     }
 
-    while (!messages.empty())
+    std::string type = j.value("type", "");
+    Kind kind = kindOf(type);
+
+    // Consecutive stdout batches share a slot; only the latest progress matters
+    bool merge = m_open && m_open->kind == kind &&
+                 (kind == Kind::Stdout || kind == Kind::Progress);
+    if (!merge)
     {
-        const auto& raw = messages.front();
+        publishOpen();
+        m_open = openSlot();
+        if (!m_open)
+            return;     // stopping
+        m_open->kind = kind;
+        m_open->type = type;
+        m_open->json = nullptr;
+        m_open->lines.clear();
+        m_open->progressPct = 0.0f;
+        m_open->frame = -1;
+    }
 
-        try
+    switch (kind)
+    {
+    case Kind::Stdout:
+        if (j.contains("lines") && j["lines"].is_array())
         {
-            auto j = nlohmann::json::parse(raw);
-            std::string type = j.value("type", "");
+            for (auto& line : j["lines"])
+            {
+                if (line.is_string())
+                    m_open->lines.push_back(std::move(line.get_ref<std::string&>()));
+            }
+        }
+        break;
+    case Kind::Progress:
+        m_open->progressPct = j.value("progress_pct", 0.0f);
+        break;
+    case Kind::FrameCompleted:
+        m_open->frame = j.value("frame", -1);
+        break;
+    default:
+        m_open->json = std::move(j);
+        break;
+    }
+}
 
-            if (type == "status")
+void AgentSupervisor::processMessages()
+{
+    SR_PERF_SCOPE("agent.messages");
+    // Drain parsed messages on the main thread
+    while (auto* msg = m_ring.front())
+    {
+        try
+        {
+            if (msg->kind == AgentMessage::Kind::Status)
             {
-                m_agentState = j.value("state", "unknown");
-                uint32_t pid = j.value("pid", 0u);
+                m_agentState = msg->json.value("state", "unknown");
+                uint32_t pid = msg->json.value("pid", 0u);
                 if (pid != 0) m_agentPid = pid;
                 MonitorLog::instance().info("agent", "Agent status: state=" + m_agentState + " pid=" + std::to_string(m_agentPid));
             }
-            else if (type == "pong")
+            else if (msg->kind == AgentMessage::Kind::Pong)
             {
                 // Agent is alive — nothing else to do for now
             }
             else if (m_messageHandler)
             {
-                m_messageHandler(type, j);
+                m_messageHandler(*msg);
             }
             else
             {
-                MonitorLog::instance().info("agent", "Received: " + type);
+                MonitorLog::instance().info("agent", "Received: " + msg->type);
             }
         }
         catch (const std::exception& e)
         {
-            MonitorLog::instance().error("agent", std::string("Failed to parse message: ") + e.what());
+            MonitorLog::instance().error("agent", "Failed to handle " + msg->type + ": " + e.what());
         }
 
-        messages.pop();
+        m_ring.pop();
     }
 
     // Periodic ping
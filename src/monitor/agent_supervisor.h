@@ -1,12 +1,13 @@
 #pragma once
 
 #include "core/ipc_server.h"
+#include "core/spsc_ring.h"
 
 #include <nlohmann/json.hpp>
 
 #include <string>
-#include <queue>
-#include <mutex>
+#include <string_view>
+#include <vector>
 #include <thread>
 #include <atomic>
 #include <chrono>
@@ -19,9 +20,25 @@
 
 namespace SR {
 
+/// Agent message parsed on the IPC thread. Slots are pooled in a ring, so
+/// fields are cleared rather than reassigned and keep their capacity.
+struct AgentMessage
+{
+    enum class Kind { Status, Pong, Ack, Progress, Stdout, FrameCompleted, Completed, Failed, Other };
+
+    Kind kind = Kind::Other;
+    std::string type;
+    nlohmann::json json;                // whole message (Status, Completed, Failed, Other)
+    std::vector<std::string> lines;     // Stdout: consecutive batches merged
+    float progressPct = 0.0f;           // Progress: latest value of a run
+    int frame = -1;                     // FrameCompleted
+};
+
 /// Manages the agent process lifecycle and IPC communication.
 /// Owns the IPC server, runs a background thread for receiving messages,
 /// and provides main-thread-safe methods for processing incoming messages.
+/// One instance per render slot; the agent id names both the pipe and the
+/// agent's single-instance lock, so slots only need distinct ids.
 class AgentSupervisor
 {
 public:
@@ -32,12 +49,17 @@ public:
     AgentSupervisor& operator=(const AgentSupervisor&) = delete;
 
     /// Start the IPC server and background thread.
-    /// Call once during MonitorApp::init().
-    void start(const std::string& nodeId);
+    /// Call once during MonitorApp::init(). agentId is the node id for slot 0,
+    /// "{nodeId}.s{slot}" for the others.
+    void start(const std::string& agentId);
 
     /// Stop everything: signal agent to shutdown, join threads, close pipe.
     void stop();
 
+    /// Pin the next spawned agent (and the renders it launches): extra
+    /// environment ("NAME=value;...") and a CPU set ("0-15,32-47").
+    void setPin(const std::string& env, const std::string& cpuSet);
+
     /// Spawn the agent process (sr-agent.exe --node-id <id>).
     /// Looks for sr-agent.exe next to the monitor executable.
     bool spawnAgent();
@@ -58,7 +80,7 @@ public:
     void sendAbort(const std::string& reason);
 
     /// Set handler for agent messages (ack, progress, stdout, completed, failed).
-    void setMessageHandler(std::function<void(const std::string&, const nlohmann::json&)> handler);
+    void setMessageHandler(std::function<void(const AgentMessage&)> handler);
 
     /// Process received messages on the main thread. Call each frame.
     void processMessages();
@@ -75,10 +97,18 @@ public:
     /// Agent reported state ("idle", "rendering", or empty)
     const std::string& agentState() const { return m_agentState; }
 
+    const std::string& agentId() const { return m_nodeId; }
+
 private:
     void ipcThreadFunc();
     bool sendJson(const std::string& json);
 
+    // IPC thread: parse one frame into the open ring slot (merging runs of
+    // stdout/progress), and publish that slot
+    void parseFrame(std::string_view frame);
+    void publishOpen();
+    AgentMessage* openSlot();   // waits while the ring is full
+
     IpcServer m_ipc;
     std::string m_nodeId;
 
@@ -86,9 +116,10 @@ private:
     std::thread m_ipcThread;
     std::atomic<bool> m_running{false};
 
-    // Thread-safe message queue (IPC thread produces, main thread consumes)
-    std::queue<std::string> m_messageQueue;
-    std::mutex m_queueMutex;
+    // Parsed messages (IPC thread produces, main thread consumes)
+    static constexpr size_t RING_SLOTS = 256;
+    SpscRing<AgentMessage, RING_SLOTS> m_ring;
+    AgentMessage* m_open = nullptr;     // IPC thread: slot being filled
 
     // Agent process
 #ifdef _WIN32
@@ -98,12 +129,16 @@ private:
     uint32_t m_agentPid = 0;
     std::string m_agentState;
 
+    // Slot pinning (applied at spawn)
+    std::string m_pinEnv;
+    std::string m_pinCpuSet;
+
     // Ping tracking
     std::chrono::steady_clock::time_point m_lastPingTime;
     static constexpr int PING_INTERVAL_SECONDS = 30;
 
     // Message handler callback
-    std::function<void(const std::string&, const nlohmann::json&)> m_messageHandler;
+    std::function<void(const AgentMessage&)> m_messageHandler;
 };
 
 } // namespace SR
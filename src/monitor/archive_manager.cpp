@@ -0,0 +1,358 @@
+#include "monitor/archive_manager.h"
+#include "core/dispatch_journal.h"
+#include "core/farm_storage.h"
+#include "core/monitor_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+ArchiveManager::~ArchiveManager()
+{
+    stop();
+}
+
+void ArchiveManager::start(const fs::path& farmPath, JobSnapshotFn jobSnapshotFn,
+                           std::function<void()> onJobsMoved)
+{
+    if (m_running.load())
+        return;
+
+    m_farmPath = farmPath;
+    m_jobSnapshotFn = std::move(jobSnapshotFn);
+    m_onJobsMoved = std::move(onJobsMoved);
+    m_records.clear();
+    m_indexOffset = 0;
+    m_indexRead = false;
+    m_failedMoves.clear();
+    m_lastPassMs = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_snapshot = std::make_shared<const Snapshot>();
+        m_refreshRequested = false;
+        m_scanRequested = 0;
+        m_scanIssued = 0;
+        m_cleanRequests.clear();
+    }
+
+    m_running.store(true);
+    m_thread = std::thread(&ArchiveManager::threadFunc, this);
+}
+
+void ArchiveManager::stop()
+{
+    m_running.store(false);
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void ArchiveManager::setArchiveAfterDays(int days)
+{
+    m_archiveAfterDays.store((std::max)(days, 0));
+    m_wakeFlag.store(true);
+}
+
+ArchiveManager::SnapshotPtr ArchiveManager::getSnapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_snapshot;
+}
+
+void ArchiveManager::refresh()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_refreshRequested = true;
+    m_wakeFlag.store(true);
+}
+
+uint64_t ArchiveManager::requestCleanupScan()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scanRequested = ++m_scanIssued;
+    m_wakeFlag.store(true);
+    return m_scanRequested;
+}
+
+void ArchiveManager::clean(CleanRequest request)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cleanRequests.push_back(std::move(request));
+    m_wakeFlag.store(true);
+}
+
+// ─── Thread ─────────────────────────────────────────────────────────────────
+
+void ArchiveManager::threadFunc()
+{
+    while (m_running.load())
+    {
+        for (int i = 0; i < 10 && m_running.load(); ++i)
+        {
+            if (m_wakeFlag.load()) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        if (!m_running.load()) break;
+        m_wakeFlag.store(false);
+
+        bool refresh = false;
+        uint64_t scan = 0;
+        std::vector<CleanRequest> cleans;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            refresh = std::exchange(m_refreshRequested, false);
+            scan = std::exchange(m_scanRequested, 0);
+            cleans = std::move(m_cleanRequests);
+            m_cleanRequests.clear();
+        }
+
+        try
+        {
+            for (const auto& req : cleans)
+                doClean(req);
+
+            if (scan)
+                cleanupScan(scan);
+            else if (refresh || !cleans.empty())
+            {
+                readIndex();
+                publish(0, nullptr);
+            }
+
+            auto now = nowMs();
+            if (m_archiveAfterDays.load() > 0 && now - m_lastPassMs >= ARCHIVE_PASS_MS)
+            {
+                m_lastPassMs = now;
+                archivePass();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            MonitorLog::instance().error("job", std::string("Archive exception: ") + e.what());
+        }
+        catch (...)
+        {
+            MonitorLog::instance().error("job", "Archive unknown exception");
+        }
+    }
+}
+
+void ArchiveManager::readIndex()
+{
+    ArchiveIndex::readSince(m_farmPath, m_indexOffset, [this](const ArchiveRecord& r) {
+        if (r.removed)
+            m_records.erase(r.job_id);
+        else
+            m_records[r.job_id] = r;
+    });
+    m_indexRead = true;
+}
+
+void ArchiveManager::publish(uint64_t scanSeq, std::vector<std::string>* orphanedDirs)
+{
+    auto snap = std::make_shared<Snapshot>();
+    snap->loaded = m_indexRead;
+    snap->records.reserve(m_records.size());
+    for (const auto& [id, r] : m_records)
+        snap->records.push_back(r);
+    std::sort(snap->records.begin(), snap->records.end(),
+        [](const ArchiveRecord& a, const ArchiveRecord& b) {
+            if (a.archived_at_ms != b.archived_at_ms)
+                return a.archived_at_ms > b.archived_at_ms;
+            return a.job_id < b.job_id;
+        });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    snap->version = m_snapshot->version + 1;
+    snap->scanSeq = scanSeq ? scanSeq : m_snapshot->scanSeq;
+    if (orphanedDirs)
+        snap->orphanedDirs = std::move(*orphanedDirs);
+    else
+        snap->orphanedDirs = m_snapshot->orphanedDirs;
+    m_snapshot = std::move(snap);
+}
+
+// ─── Archiving (coordinator) ────────────────────────────────────────────────
+
+void ArchiveManager::archivePass()
+{
+    auto jobs = m_jobSnapshotFn ? m_jobSnapshotFn() : nullptr;
+    if (!jobs || jobs->provisional)
+        return;
+
+    auto now = nowMs();
+    int64_t cutoff = now - int64_t(m_archiveAfterDays.load()) * 24 * 60 * 60 * 1000;
+
+    size_t moved = 0;
+    for (const auto& job : jobs->jobs)
+    {
+        if (job.current_state != "completed" && job.current_state != "cancelled")
+            continue;
+        if (job.state_timestamp_ms <= 0 || job.state_timestamp_ms > cutoff)
+            continue;
+        if (m_failedMoves.count(job.manifest.job_id))
+            continue;
+        if (archiveJob(job, now) && ++moved >= ARCHIVE_BATCH)
+            break;
+    }
+
+    if (moved == 0)
+        return;
+
+    MonitorLog::instance().info("job", "Archived " + std::to_string(moved) + " finished job(s)");
+    if (m_onJobsMoved)
+        m_onJobsMoved();
+    if (m_indexRead)
+    {
+        readIndex();
+        publish(0, nullptr);
+    }
+}
+
+bool ArchiveManager::archiveJob(const JobInfo& job, int64_t archivedAtMs)
+{
+    const auto& id = job.manifest.job_id;
+    auto jobDir = m_farmPath / "jobs" / id;
+    auto dest = ArchiveIndex::dir(m_farmPath) / id;
+
+    ArchiveRecord rec;
+    rec.job_id = id;
+    rec.template_id = job.manifest.template_id;
+    rec.state = job.current_state;
+    rec.frames = job.manifest.frame_end - job.manifest.frame_start + 1;
+    rec.submitted_by = job.manifest.submitted_by;
+    rec.submitted_at_ms = job.manifest.submitted_at_ms;
+    rec.finished_at_ms = job.state_timestamp_ms;
+    rec.archived_at_ms = archivedAtMs;
+    rec.output_dir = job.manifest.output_dir.value_or("");
+    if (auto dt = DispatchJournal::load(jobDir))
+    {
+        for (const auto& c : dt->chunks)
+        {
+            int count = c.frame_end - c.frame_start + 1;
+            if (c.state == DispatchState::Completed) rec.completed += count;
+            else if (c.state == DispatchState::Failed) rec.failed += count;
+        }
+    }
+
+    // A rename keeps it one step on the share; open handles (a peer tailing
+    // a log, a sync client) fail it, and it's retried after the next start
+    auto& storage = FarmStorage::current();
+    std::error_code ec;
+    storage.createDirectories(dest.parent_path());
+    if (storage.exists(dest))
+        ec = std::make_error_code(std::errc::file_exists);
+    else
+        storage.rename(jobDir, dest, ec);
+    if (ec)
+    {
+        m_failedMoves.insert(id);
+        MonitorLog::instance().warn("job", "Could not archive job " + id + ": " + ec.message());
+        return false;
+    }
+
+    if (!ArchiveIndex::append(m_farmPath, rec))
+    {
+        // Unlisted in the archive is worse than not archived: put it back
+        std::error_code undo;
+        storage.rename(dest, jobDir, undo);
+        m_failedMoves.insert(id);
+        MonitorLog::instance().warn("job", "Could not record archived job " + id + ", left in jobs/");
+        return false;
+    }
+    return true;
+}
+
+// ─── Cleanup ────────────────────────────────────────────────────────────────
+
+void ArchiveManager::cleanupScan(uint64_t seq)
+{
+    readIndex();
+
+    auto& storage = FarmStorage::current();
+    std::vector<std::string> orphaned;
+    auto jobsDir = m_farmPath / "jobs";
+    for (const auto& entry : storage.list(jobsDir))
+    {
+        if (!entry.isDir) continue;
+        if (!storage.exists(jobsDir / entry.name / "manifest.json"))
+            orphaned.push_back((jobsDir / entry.name).string());
+    }
+    std::sort(orphaned.begin(), orphaned.end());
+    publish(seq, &orphaned);
+}
+
+void ArchiveManager::doClean(const CleanRequest& request)
+{
+    auto& storage = FarmStorage::current();
+    int cleaned = 0;
+    bool jobsRemoved = false;
+
+    for (const auto& id : request.jobs)
+    {
+        if (storage.removeAll(m_farmPath / "jobs" / id))
+        {
+            MonitorLog::instance().info("farm", "Cleaned job: " + id);
+            jobsRemoved = true;
+            cleaned++;
+        }
+        else
+        {
+            MonitorLog::instance().error("farm", "Failed to clean job " + id);
+        }
+    }
+
+    for (const auto& id : request.archivedJobs)
+    {
+        if (!storage.removeAll(ArchiveIndex::dir(m_farmPath) / id))
+        {
+            MonitorLog::instance().error("farm", "Failed to clean archived job " + id);
+            continue;
+        }
+        ArchiveRecord removal;
+        removal.job_id = id;
+        removal.removed = true;
+        if (!ArchiveIndex::append(m_farmPath, removal))
+            MonitorLog::instance().warn("farm", "Could not record removal of archived job " + id);
+        MonitorLog::instance().info("farm", "Cleaned archived job: " + id);
+        cleaned++;
+    }
+
+    for (const auto& nodeId : request.deadNodes)
+    {
+        storage.removeAll(m_farmPath / "nodes" / nodeId);
+        storage.removeAll(m_farmPath / "commands" / nodeId);
+        MonitorLog::instance().info("farm", "Cleaned dead node: " + nodeId);
+        cleaned++;
+    }
+
+    for (const auto& dir : request.dirs)
+    {
+        if (storage.removeAll(dir))
+        {
+            MonitorLog::instance().info("farm", "Cleaned orphaned dir: " + dir.string());
+            jobsRemoved = true;
+            cleaned++;
+        }
+    }
+
+    if (jobsRemoved && m_onJobsMoved)
+        m_onJobsMoved();
+    if (cleaned > 0)
+        MonitorLog::instance().info("farm", "Farm cleanup: " + std::to_string(cleaned) + " items removed");
+}
+
+} // namespace SR
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "core/archive_index.h"
+#include "monitor/job_manager.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace SR {
+
+// Archive tier (see ArchiveIndex). On the coordinator, finished jobs whose
+// final state is older than the configured age are moved from jobs/ to
+// archive/ and recorded in the index, so job scans stop paying for them.
+// On every node, the index is read on demand for the archive browser and the
+// cleanup dialog, and cleanup deletions run here too: all share I/O stays on
+// this thread.
+class ArchiveManager
+{
+public:
+    using JobSnapshotFn = std::function<JobSnapshotPtr()>;
+
+    ~ArchiveManager();
+
+    ArchiveManager() = default;
+    ArchiveManager(const ArchiveManager&) = delete;
+    ArchiveManager& operator=(const ArchiveManager&) = delete;
+
+    // onJobsMoved: jobs/ lost directories (archived or cleaned), rescan it
+    void start(const std::filesystem::path& farmPath, JobSnapshotFn jobSnapshotFn,
+               std::function<void()> onJobsMoved);
+    void stop();
+
+    // Coordinator only; 0 = never (workers always pass 0)
+    void setArchiveAfterDays(int days);
+
+    struct Snapshot
+    {
+        uint64_t version = 0;
+        bool loaded = false;                    // the index has been read at least once
+        std::vector<ArchiveRecord> records;     // newest archived first
+        uint64_t scanSeq = 0;                   // last cleanup scan finished
+        std::vector<std::string> orphanedDirs;  // jobs/ entries without manifest.json
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+    SnapshotPtr getSnapshot() const;
+
+    // Read index lines appended since the last read
+    void refresh();
+
+    // refresh() plus a jobs/ listing for orphaned directories. Returns the
+    // scanSeq the snapshot will carry once it's done.
+    uint64_t requestCleanupScan();
+
+    struct CleanRequest
+    {
+        std::vector<std::string> jobs;          // in jobs/
+        std::vector<std::string> archivedJobs;  // in archive/; the index records the removal
+        std::vector<std::string> deadNodes;     // nodes/ and commands/ dirs
+        std::vector<std::filesystem::path> dirs;
+    };
+    void clean(CleanRequest request);
+
+    static constexpr int64_t ARCHIVE_PASS_MS = 60 * 1000;
+    static constexpr size_t ARCHIVE_BATCH = 50;     // jobs moved per pass, so a backlog drains gradually
+
+private:
+    void threadFunc();
+    void readIndex();
+    void archivePass();
+    bool archiveJob(const JobInfo& job, int64_t archivedAtMs);
+    void cleanupScan(uint64_t seq);
+    void doClean(const CleanRequest& request);
+    void publish(uint64_t scanSeq, std::vector<std::string>* orphanedDirs);
+
+    std::filesystem::path m_farmPath;
+    JobSnapshotFn m_jobSnapshotFn;
+    std::function<void()> m_onJobsMoved;
+
+    // Thread only
+    std::unordered_map<std::string, ArchiveRecord> m_records;
+    uint64_t m_indexOffset = 0;
+    bool m_indexRead = false;
+    std::set<std::string> m_failedMoves;    // warned once each
+    int64_t m_lastPassMs = 0;
+
+    // Requests from the main thread
+    mutable std::mutex m_mutex;
+    SnapshotPtr m_snapshot = std::make_shared<const Snapshot>();
+    bool m_refreshRequested = false;
+    uint64_t m_scanRequested = 0;
+    uint64_t m_scanIssued = 0;
+    std::vector<CleanRequest> m_cleanRequests;
+
+    std::atomic<int> m_archiveAfterDays{0};
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_wakeFlag{false};
+    std::thread m_thread;
+};
+
+} // namespace SR
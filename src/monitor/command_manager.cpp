@@ -1,7 +1,10 @@
 #include "monitor/command_manager.h"
 #include "core/atomic_file_io.h"
+#include "core/chunk_trace.h"
+#include "core/farm_storage.h"
 #include "core/platform.h"
 #include "core/udp_notify.h"
+#include "core/tcp_link.h"
 
 #include <algorithm>
 #include <chrono>
@@ -11,6 +14,21 @@ namespace SR {
 
 namespace fs = std::filesystem;
 
+namespace {
+
+// Sender-side hop of a traced command (assign_chunk)
+void traceCommand(const nlohmann::json& cmd, const char* name, int64_t startUs, int64_t endUs,
+                  const nlohmann::json& args)
+{
+    if (!cmd.contains("trace_id") || !ChunkTrace::instance().enabled())
+        return;
+    ChunkRange chunk{cmd.value("frame_start", 0), cmd.value("frame_end", 0)};
+    ChunkTrace::instance().record(cmd.value("job_id", ""), cmd.value("trace_id", ""), chunk,
+                                  name, startUs, endUs, args);
+}
+
+} // namespace
+
 CommandManager::~CommandManager()
 {
     if (m_running.load())
@@ -26,8 +44,16 @@ void CommandManager::start(const fs::path& farmPath, const std::string& nodeId)
     m_nodeId = nodeId;
 
     // Ensure inbox directory exists
-    std::error_code ec;
-    fs::create_directories(farmPath / "commands" / nodeId / "processed", ec);
+    FarmStorage::current().createDirectories(farmPath / "commands" / nodeId / "processed");
+
+    m_watch = FarmStorage::current().watch(farmPath / "commands" / nodeId, false, [this](const fs::path& rel) {
+        if (rel.empty() || rel.extension() == ".json")
+        {
+            int64_t none = 0;
+            m_firstWakeUs.compare_exchange_strong(none, ChunkTrace::nowUs());
+            m_wakeFlag.store(true);
+        }
+    });
 
     m_running.store(true);
     m_thread = std::thread(&CommandManager::threadFunc, this);
@@ -40,19 +66,25 @@ void CommandManager::stop()
     if (!m_running.load())
         return;
 
+    m_watch.reset();
     m_running.store(false);
     if (m_thread.joinable())
         m_thread.join();
 
+    flushQueued();
+    serviceUnacked(true);   // anything still unACKed goes to inbox files
+
     MonitorLog::instance().info("command", "Stopped");
 }
 
-void CommandManager::sendCommand(const std::string& targetNodeId,
-                                  const std::string& type,
-                                  const std::string& jobId,
-                                  const std::string& reason,
-                                  int frameStart,
-                                  int frameEnd)
+nlohmann::json CommandManager::buildCommand(const std::string& targetNodeId,
+                                            const std::string& type,
+                                            const std::string& jobId,
+                                            const std::string& reason,
+                                            int frameStart,
+                                            int frameEnd,
+                                            const std::string& framesDone,
+                                            const std::string& traceId)
 {
     auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
@@ -71,20 +103,88 @@ void CommandManager::sendCommand(const std::string& targetNodeId,
         j["frame_start"] = frameStart;
         j["frame_end"] = frameEnd;
     }
+    if (!framesDone.empty())
+        j["frames_done"] = framesDone;
+    if (!traceId.empty())
+        j["trace_id"] = traceId;
 
-    auto targetDir = m_farmPath / "commands" / targetNodeId;
-    std::error_code ec;
-    fs::create_directories(targetDir, ec);
-
-    std::string msgId = std::to_string(now) + "." + m_nodeId;
+    // Timestamp first: purgeProcessed() ages files by the leading field
+    std::string msgId = std::to_string(now) + "." + m_nodeId + "." + std::to_string(m_sendSeq++);
     j["msg_id"] = msgId;
     j["target"] = targetNodeId;
+    return j;
+}
 
-    std::string filename = msgId + ".json";
-    AtomicFileIO::writeJson(targetDir / filename, j);
+void CommandManager::writeCommandFile(const std::string& targetNodeId, const nlohmann::json& j)
+{
+    auto targetDir = m_farmPath / "commands" / targetNodeId;
+    FarmStorage::current().createDirectories(targetDir);
 
-    if (m_udpNotify)
-        m_udpNotify->send(j);
+    std::string filename = j.value("msg_id", "") + ".json";
+    int64_t startUs = ChunkTrace::nowUs();
+    AtomicFileIO::writeJson(targetDir / filename, j, FileClass::Command);
+    int64_t endUs = ChunkTrace::nowUs();
+
+    if (j.contains("commands") && j.at("commands").is_array())
+    {
+        for (const auto& cmd : j.at("commands"))
+            traceCommand(cmd, "command_write", startUs, endUs, {{"batch", j.at("commands").size()}});
+    }
+    else
+    {
+        traceCommand(j, "command_write", startUs, endUs, {{"batch", 1}});
+    }
+}
+
+void CommandManager::sendCommand(const std::string& targetNodeId,
+                                  const std::string& type,
+                                  const std::string& jobId,
+                                  const std::string& reason,
+                                  int frameStart,
+                                  int frameEnd,
+                                  const std::string& framesDone,
+                                  const std::string& traceId)
+{
+    int64_t startUs = ChunkTrace::nowUs();
+    auto j = buildCommand(targetNodeId, type, jobId, reason, frameStart, frameEnd, framesDone, traceId);
+    bool acked = sendReliable(targetNodeId, j);
+    if (!acked)
+    {
+        writeCommandFile(targetNodeId, j);
+        sendFast(targetNodeId, j);
+    }
+    if (!traceId.empty() && ChunkTrace::instance().enabled())
+        ChunkTrace::instance().record(jobId, traceId, {frameStart, frameEnd}, "command_send",
+                                      startUs, ChunkTrace::nowUs(), {{"acked", acked}});
+
+    std::string msg = "Sent " + type + " to " + targetNodeId;
+    if (!jobId.empty())
+        msg += " job=" + jobId;
+    MonitorLog::instance().info("command", msg);
+}
+
+void CommandManager::queueCommand(const std::string& targetNodeId,
+                                   const std::string& type,
+                                   const std::string& jobId,
+                                   const std::string& reason,
+                                   int frameStart,
+                                   int frameEnd,
+                                   const std::string& traceId)
+{
+    int64_t startUs = ChunkTrace::nowUs();
+    auto j = buildCommand(targetNodeId, type, jobId, reason, frameStart, frameEnd, {}, traceId);
+    bool acked = sendReliable(targetNodeId, j);
+    if (!acked)
+    {
+        sendFast(targetNodeId, j);
+
+        std::lock_guard<std::mutex> lock(m_outboxMutex);
+        m_outbox[targetNodeId].push_back(std::move(j));
+    }
+    // The file write, if any, is its own span at flushQueued()
+    if (!traceId.empty() && ChunkTrace::instance().enabled())
+        ChunkTrace::instance().record(jobId, traceId, {frameStart, frameEnd}, "command_send",
+                                      startUs, ChunkTrace::nowUs(), {{"acked", acked}});
 
     std::string msg = "Sent " + type + " to " + targetNodeId;
     if (!jobId.empty())
@@ -92,6 +192,135 @@ void CommandManager::sendCommand(const std::string& targetNodeId,
     MonitorLog::instance().info("command", msg);
 }
 
+void CommandManager::flushQueued()
+{
+    std::map<std::string, std::vector<nlohmann::json>> outbox;
+    {
+        std::lock_guard<std::mutex> lock(m_outboxMutex);
+        outbox.swap(m_outbox);
+    }
+
+    for (auto& [target, commands] : outbox)
+    {
+        if (commands.size() == 1)
+        {
+            writeCommandFile(target, commands.front());
+            continue;
+        }
+
+        // Envelope named like a command (first entry's msg_id) so inbox order
+        // and age-based purging stay the same
+        nlohmann::json envelope = {
+            {"_version", 1},
+            {"from", m_nodeId},
+            {"timestamp_ms", commands.front().value("timestamp_ms", int64_t(0))},
+            {"msg_id", commands.front().value("msg_id", "") + ".batch"},
+            {"target", target},
+            {"commands", std::move(commands)},
+        };
+        writeCommandFile(target, envelope);
+    }
+}
+
+// ─── ACKed UDP delivery ─────────────────────────────────────────────────────
+
+bool CommandManager::isDurable(const std::string& type)
+{
+    // Completions are the record of finished work; node stop/resume must hold
+    // across a receiver restart
+    return type == "chunk_completed" || type == "chunk_failed" ||
+           type == "stop_all" || type == "resume_all";
+}
+
+void CommandManager::sendFast(const std::string& targetNodeId, const nlohmann::json& j)
+{
+    if (m_tcpLink && m_tcpLink->send(targetNodeId, j))
+        return;
+    if (m_udpNotify)
+        m_udpNotify->send(j);
+}
+
+bool CommandManager::sendReliable(const std::string& targetNodeId, nlohmann::json& j)
+{
+    if (!hasFastPath() || !m_reachableFn || isDurable(j.value("type", "")))
+        return false;
+    if (!m_reachableFn(targetNodeId) && !(m_tcpLink && m_tcpLink->isConnected(targetNodeId)))
+        return false;
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_unackedMutex);
+    uint64_t dseq = ++m_destSeq[targetNodeId];
+    j["dseq"] = dseq;
+    sendFast(targetNodeId, j);
+
+    Unacked u;
+    u.cmd = std::move(j);
+    u.deadline = now + std::chrono::milliseconds(ACK_DEADLINE_MS);
+    u.nextSend = now + std::chrono::milliseconds(ACK_RETRY_MS);
+    m_unacked[{targetNodeId, dseq}] = std::move(u);
+    return true;
+}
+
+void CommandManager::acknowledge(const nlohmann::json& cmd)
+{
+    if (!hasFastPath() || !cmd.contains("dseq"))
+        return;
+
+    // ACK duplicates too: the first ACK may be what got lost
+    std::string sender = cmd.value("from", "");
+    sendFast(sender, {
+        {"t", "ack"},
+        {"from", m_nodeId},
+        {"target", sender},
+        {"seq", cmd.value("dseq", uint64_t(0))},
+    });
+}
+
+void CommandManager::onAck(const nlohmann::json& ack)
+{
+    std::string from = ack.value("from", "");
+    uint64_t seq = ack.value("seq", uint64_t(0));
+
+    std::lock_guard<std::mutex> lock(m_unackedMutex);
+    m_unacked.erase({from, seq});
+}
+
+void CommandManager::serviceUnacked(bool flushAll)
+{
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::string, nlohmann::json>> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_unackedMutex);
+        for (auto it = m_unacked.begin(); it != m_unacked.end(); )
+        {
+            auto& u = it->second;
+            if (flushAll || now >= u.deadline)
+            {
+                expired.emplace_back(it->first.first, std::move(u.cmd));
+                it = m_unacked.erase(it);
+                continue;
+            }
+            if (now >= u.nextSend && hasFastPath())
+            {
+                sendFast(it->first.first, u.cmd);
+                u.nextSend = now + std::chrono::milliseconds(ACK_RETRY_MS << u.attempts);
+                ++u.attempts;
+            }
+            ++it;
+        }
+    }
+
+    // Fall back to the durable path; the receiver dedups by msg_id if the
+    // datagram did make it
+    for (const auto& [target, cmd] : expired)
+    {
+        writeCommandFile(target, cmd);
+        if (!flushAll)
+            MonitorLog::instance().warn("command", "No ACK from " + target + " for " +
+                                        cmd.value("type", "") + ", wrote inbox file");
+    }
+}
+
 std::vector<CommandManager::Action> CommandManager::popActions()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -119,9 +348,10 @@ void CommandManager::threadFunc()
         {
             auto now = clock::now();
 
-            // Poll inbox every 3 seconds
+            // Poll inbox every 3 seconds, or as soon as the watcher sees a command land
             auto pollElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastPoll).count();
-            if (pollElapsed >= 3000)
+            int pollInterval = (m_watch && m_watch->isActive()) ? DirWatcher::FALLBACK_POLL_MS : POLL_INTERVAL_MS;
+            if (m_wakeFlag.exchange(false) || pollElapsed >= pollInterval)
             {
                 pollInbox();
                 lastPoll = clock::now();
@@ -135,7 +365,11 @@ void CommandManager::threadFunc()
                 lastPurge = clock::now();
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            for (int i = 0; i < 10 && m_running.load() && !m_wakeFlag.load(); ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                serviceUnacked();
+            }
         }
         catch (const std::exception& e)
         {
@@ -152,20 +386,17 @@ void CommandManager::threadFunc()
 
 void CommandManager::pollInbox()
 {
-    std::error_code ec;
+    auto& storage = FarmStorage::current();
     auto inboxDir = m_farmPath / "commands" / m_nodeId;
-    if (!fs::is_directory(inboxDir, ec))
-        return;
+    int64_t wakeUs = m_firstWakeUs.exchange(0);
 
     // Collect command files (not in processed/)
     std::vector<fs::path> files;
-    for (const auto& entry : fs::directory_iterator(inboxDir, ec))
+    for (const auto& entry : storage.list(inboxDir))
     {
-        if (!entry.is_regular_file(ec))
+        if (entry.isDir || !entry.name.ends_with(".json"))
             continue;
-        if (entry.path().extension() != ".json")
-            continue;
-        files.push_back(entry.path());
+        files.push_back(inboxDir / entry.name);
     }
 
     // Sort by filename (timestamp order)
@@ -180,30 +411,28 @@ void CommandManager::pollInbox()
         try
         {
             const auto& j = data.value();
-            Action action;
-            action.type = j.value("type", "");
-            action.jobId = j.value("job_id", "");
-            action.reason = j.value("reason", "");
-            action.frameStart = j.value("frame_start", 0);
-            action.frameEnd = j.value("frame_end", 0);
-            action.fromNodeId = j.value("from", "");
-            action.msgId = j.value("msg_id", "");
-            if (action.msgId.empty())
-                action.msgId = file.stem().string(); // fallback for old files
-
-            if (!action.type.empty())
+            auto stem = file.stem().string();
+
+            // Envelope from flushQueued(): each entry keeps its own msg_id, so
+            // MessageDedup still matches them against their UDP co-sends
+            if (j.contains("commands") && j.at("commands").is_array())
             {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_actionQueue.push(std::move(action));
+                const auto& commands = j.at("commands");
+                for (size_t i = 0; i < commands.size(); ++i)
+                    queueAction(commands[i], stem + "#" + std::to_string(i), wakeUs);
+            }
+            else
+            {
+                queueAction(j, stem, wakeUs); // stem = msg_id fallback for old files
             }
 
             // Move to processed
             auto processedDir = inboxDir / "processed";
-            fs::rename(file, processedDir / file.filename(), ec);
-            if (ec)
+            std::error_code ec;
+            if (!storage.rename(file, processedDir / file.filename(), ec))
             {
                 // If rename fails, try to delete to prevent re-processing
-                fs::remove(file, ec);
+                storage.remove(file);
             }
         }
         catch (const std::exception& e)
@@ -211,32 +440,58 @@ void CommandManager::pollInbox()
             MonitorLog::instance().error("command", "Failed to parse command: " + file.string() + " - " + std::string(e.what()));
             // Move bad file to processed to avoid loop
             auto processedDir = inboxDir / "processed";
-            fs::rename(file, processedDir / file.filename(), ec);
+            std::error_code ec;
+            storage.rename(file, processedDir / file.filename(), ec);
         }
     }
 }
 
+void CommandManager::queueAction(const nlohmann::json& j, const std::string& fallbackMsgId,
+                                 int64_t wakeUs)
+{
+    Action action;
+    action.type = j.value("type", "");
+    action.jobId = j.value("job_id", "");
+    action.reason = j.value("reason", "");
+    action.frameStart = j.value("frame_start", 0);
+    action.frameEnd = j.value("frame_end", 0);
+    action.framesDone = j.value("frames_done", "");
+    action.fromNodeId = j.value("from", "");
+    action.msgId = j.value("msg_id", "");
+    if (action.msgId.empty())
+        action.msgId = fallbackMsgId;
+    action.traceId = j.value("trace_id", "");
+    action.sentMs = j.value("timestamp_ms", int64_t(0));
+    action.receivedUs = ChunkTrace::nowUs();
+    action.via = "inbox";
+    // A wake from before this command was sent belongs to an earlier file
+    if (wakeUs >= action.sentMs * 1000)
+        action.seenUs = wakeUs;
+
+    if (action.type.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_actionQueue.push(std::move(action));
+}
+
 void CommandManager::purgeProcessed()
 {
-    std::error_code ec;
+    auto& storage = FarmStorage::current();
     auto processedDir = m_farmPath / "commands" / m_nodeId / "processed";
-    if (!fs::is_directory(processedDir, ec))
-        return;
 
     auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
 
     constexpr int64_t PURGE_AGE_MS = 24 * 60 * 60 * 1000; // 24 hours
 
-    for (const auto& entry : fs::directory_iterator(processedDir, ec))
+    for (const auto& entry : storage.list(processedDir))
     {
-        if (!entry.is_regular_file(ec))
-            continue;
-        if (entry.path().extension() != ".json")
+        if (entry.isDir || !entry.name.ends_with(".json"))
             continue;
 
         // Parse timestamp from filename: "1234567890.nodeId.json"
-        std::string stem = entry.path().stem().string(); // "1234567890.nodeId"
+        std::string stem = fs::path(entry.name).stem().string(); // "1234567890.nodeId"
         auto dotPos = stem.find('.');
         if (dotPos == std::string::npos)
             continue;
@@ -246,7 +501,7 @@ void CommandManager::purgeProcessed()
             int64_t ts = std::stoll(stem.substr(0, dotPos));
             if (now - ts > PURGE_AGE_MS)
             {
-                fs::remove(entry.path(), ec);
+                storage.remove(processedDir / entry.name);
             }
         }
         catch (...) {}
@@ -1,9 +1,17 @@
 #pragma once
 
+#include "core/dir_watcher.h"
+#include "core/farm_storage.h"
+
+#include <nlohmann/json.hpp>
+
 #include <filesystem>
+#include <functional>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <queue>
+#include <map>
 #include <mutex>
 #include <thread>
 #include <atomic>
@@ -11,6 +19,7 @@
 namespace SR {
 
 class UdpNotify;
+class TcpLink;
 
 class CommandManager
 {
@@ -25,13 +34,17 @@ public:
                const std::string& nodeId);
     void stop();
 
-    // Send a command to a target node's inbox (thread-safe).
+    // Send a command to a target node's inbox (thread-safe). framesDone is a
+    // formatFrameSet() list (chunk_failed: frames that finished anyway).
+    // traceId (assign_chunk) makes both ends record ChunkTrace spans.
     void sendCommand(const std::string& targetNodeId,
                      const std::string& type,
                      const std::string& jobId = {},
                      const std::string& reason = "user_request",
                      int frameStart = 0,
-                     int frameEnd = 0);
+                     int frameEnd = 0,
+                     const std::string& framesDone = {},
+                     const std::string& traceId = {});
 
     // Action queued from inbox polling, consumed by main thread.
     struct Action
@@ -41,31 +54,112 @@ public:
         std::string reason;
         int frameStart = 0;
         int frameEnd = 0;
+        std::string framesDone;
         std::string fromNodeId;
         std::string msgId;
+
+        // Chunk trace: the sender's clock at send, and on this node when the
+        // inbox watcher saw the file land (0 if it was polled) and when it was read
+        std::string traceId;
+        int64_t sentMs = 0;
+        int64_t seenUs = 0;
+        int64_t receivedUs = 0;
+        std::string via;        // "inbox", "udp" or "tcp"
     };
 
+    // Same as sendCommand, but the file write waits for flushQueued() so that
+    // commands to one target in a dispatch tick share a single envelope file.
+    // The UDP co-send still goes out immediately (thread-safe).
+    void queueCommand(const std::string& targetNodeId,
+                      const std::string& type,
+                      const std::string& jobId = {},
+                      const std::string& reason = "user_request",
+                      int frameStart = 0,
+                      int frameEnd = 0,
+                      const std::string& traceId = {});
+
+    // Write everything queued: a plain command file for a lone command,
+    // otherwise one envelope per target (thread-safe).
+    void flushQueued();
+
     // Pop all pending actions (main thread).
     std::vector<Action> popActions();
 
     // Set optional UDP notifier for co-sending commands.
     void setUdpNotify(UdpNotify* udp) { m_udpNotify = udp; }
 
+    // Set optional TCP control link; preferred over UDP for peers it reaches.
+    void setTcpLink(TcpLink* link) { m_tcpLink = link; }
+
+    // UDP-first delivery. A command to a peer reachable over UDP (per this
+    // predicate; set before start) carries a per-target "dseq" and is resent
+    // with backoff until that peer ACKs it. The inbox file is written only if
+    // no ACK arrives within ACK_DEADLINE_MS. Durable types always get a file.
+    void setReachability(std::function<bool(const std::string&)> fn) { m_reachableFn = std::move(fn); }
+
+    // Receiver: ACK a UDP command that carried a dseq (main thread)
+    void acknowledge(const nlohmann::json& cmd);
+    // Sender: an "ack" datagram addressed to us
+    void onAck(const nlohmann::json& ack);
+
 private:
     void threadFunc();
     void pollInbox();
     void purgeProcessed();
 
+    nlohmann::json buildCommand(const std::string& targetNodeId, const std::string& type,
+                                const std::string& jobId, const std::string& reason,
+                                int frameStart, int frameEnd,
+                                const std::string& framesDone = {},
+                                const std::string& traceId = {});
+    void writeCommandFile(const std::string& targetNodeId, const nlohmann::json& j);
+    void queueAction(const nlohmann::json& j, const std::string& fallbackMsgId, int64_t wakeUs);
+
+    // TCP link if it reaches the target, else UDP multicast
+    void sendFast(const std::string& targetNodeId, const nlohmann::json& j);
+    bool hasFastPath() const { return m_udpNotify || m_tcpLink; }
+
+    // Takes j if it goes out on the ACKed path; false means "write the file"
+    bool sendReliable(const std::string& targetNodeId, nlohmann::json& j);
+    void serviceUnacked(bool flushAll = false);    // retransmits + file fallback
+    static bool isDurable(const std::string& type);
+
+    static constexpr int POLL_INTERVAL_MS = 3000;
+    static constexpr int ACK_RETRY_MS = 200;        // doubled per attempt
+    static constexpr int ACK_DEADLINE_MS = 1500;
+
     std::filesystem::path m_farmPath;
     std::string m_nodeId;
     std::thread m_thread;
     std::atomic<bool> m_running{false};
+    std::atomic<bool> m_wakeFlag{false};
+    std::unique_ptr<FarmStorage::Watch> m_watch;    // own inbox; wakes pollInbox() as commands land
+    std::atomic<int64_t> m_firstWakeUs{0};          // first watcher wake since the last poll (chunk traces)
 
     // Action queue (bg thread -> main thread)
     std::queue<Action> m_actionQueue;
     std::mutex m_mutex;
 
     UdpNotify* m_udpNotify = nullptr;
+    TcpLink* m_tcpLink = nullptr;
+
+    // Queued commands per target, awaiting flushQueued()
+    std::map<std::string, std::vector<nlohmann::json>> m_outbox;
+    std::mutex m_outboxMutex;
+    std::atomic<uint32_t> m_sendSeq{0};    // keeps msg_ids unique within a millisecond
+
+    // Commands awaiting an ACK, by (target, dseq)
+    struct Unacked
+    {
+        nlohmann::json cmd;
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::steady_clock::time_point nextSend;
+        int attempts = 1;
+    };
+    std::map<std::pair<std::string, uint64_t>, Unacked> m_unacked;
+    std::map<std::string, uint64_t> m_destSeq;
+    std::mutex m_unackedMutex;
+    std::function<bool(const std::string&)> m_reachableFn;
 };
 
 } // namespace SR
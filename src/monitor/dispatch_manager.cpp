@@ -1,10 +1,18 @@
 #include "monitor/dispatch_manager.h"
+#include "core/archive_index.h"
 #include "core/atomic_file_io.h"
-#include "core/platform.h"
+#include "core/chunk_trace.h"
+#include "core/dispatch_journal.h"
+#include "core/coordinator_lease.h"
+#include "core/event_log.h"
+#include "core/farm_storage.h"
 #include "core/monitor_log.h"
+#include "core/output_pattern.h"
+#include "core/perf_counters.h"
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 
 namespace SR {
 
@@ -15,25 +23,71 @@ void DispatchManager::start(const fs::path& farmPath,
                              const std::string& nodeOS,
                              const TimingConfig& timing,
                              const std::vector<std::string>& tags,
-                             std::function<std::vector<NodeInfo>()> nodeSnapshotFn,
-                             std::function<std::vector<JobInfo>()> jobSnapshotFn)
+                             std::function<NodeSnapshotPtr()> nodeSnapshotFn,
+                             std::function<JobSnapshotPtr()> jobSnapshotFn)
 {
     if (m_running)
         return;
 
-    m_farmPath = farmPath;
-    m_nodeId = nodeId;
-    m_nodeOS = nodeOS;
-    m_timing = timing;
-    m_tags = tags;
-    m_nodeSnapshotFn = std::move(nodeSnapshotFn);
-    m_jobSnapshotFn = std::move(jobSnapshotFn);
-    m_assignments.clear();
-    m_dispatchTables.clear();
-    m_dirtyTables.clear();
-    m_completionWritten.clear();
-    m_recovered = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_farmPath = farmPath;
+        m_nodeId = nodeId;
+        m_nodeOS = nodeOS;
+        m_timing = timing;
+        m_tags = tags;
+        m_nodeSnapshotFn = std::move(nodeSnapshotFn);
+        m_jobSnapshotFn = std::move(jobSnapshotFn);
+        m_assignments.clear();
+        m_dispatchTables.clear();
+        m_chunkIndex.clear();
+        m_tableRevisions.clear();
+        m_adaptive.clear();
+        m_frameTimes.clear();
+        m_nodeWarmJob.clear();
+        m_nodes = NodeRegistry();
+        m_nodes.subscribe([this](NodeRegistry::Event event, const std::string& nodeId, const NodeInfo* node)
+        {
+            onNodeEvent(event, nodeId, *node);
+        });
+        m_nodeSlots.clear();
+        m_lastServedMs.clear();
+        m_preemptions.clear();
+        m_idleSinceMs.clear();
+        m_wakeSentMs.clear();
+        m_sleepSentMs.clear();
+        m_preemptedAt.clear();
+        m_freedSlots.clear();
+        m_dirtyTables.clear();
+        m_journal.clear();
+        m_completionWritten.clear();
+        m_unknownUpstream.clear();
+        m_archivedState.clear();
+        m_archiveOffset = 0;
+        m_lastArchiveReadMs = 0;
+        m_verifyInFlight.clear();
+        m_jobVerified.clear();
+        m_verifyWarned.clear();
+        m_localDispatches.clear();
+        m_jobs.reset();
+        m_jobsVersion = 0;
+        m_activeJobs.clear();
+        m_recovered = false;
+        m_wakePending = true;   // first cycle runs recovery immediately
+        m_fenced = false;
+        m_lastLeaseCheck = {};
+        m_shardsLoaded = false;
+        m_shards = {};
+        m_handoffUntilMs = 0;
+        m_handoffJobs.clear();
+        m_pendingChunks = 0;
+    }
+
+    m_verifier.setNotify([this] { wake(); });
+
     m_running = true;
+    if (m_threaded)
+        m_thread = std::thread(&DispatchManager::threadFunc, this);
 
     MonitorLog::instance().info("dispatch", "Started as coordinator");
 }
@@ -43,274 +97,552 @@ void DispatchManager::stop()
     if (!m_running)
         return;
 
-    // Write any dirty tables before stopping
-    for (const auto& jobId : m_dirtyTables)
     {
-        auto it = m_dispatchTables.find(jobId);
-        if (it == m_dispatchTables.end()) continue;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
 
-        auto& dt = it->second;
-        dt.updated_at_ms = nowMs();
-        nlohmann::json j = dt;
-        auto path = m_farmPath / "jobs" / jobId / "dispatch.json";
-        AtomicFileIO::writeJson(path, j);
+    // Before taking the lock: a worker may be waking us
+    m_verifier.stop();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Compact every table with outstanding changes or journal records;
+    // a superseded coordinator leaves the files to its successor
+    if (!m_fenced)
+    {
+        for (const auto& [jobId, js] : m_journal)
+        {
+            if (js.records > 0)
+                m_dirtyTables.insert(jobId);
+        }
+        for (const auto& jobId : m_dirtyTables)
+            flushTable(jobId, true);
     }
     m_dirtyTables.clear();
+    m_seedTables.clear();
 
-    m_running = false;
+    m_localDispatches.clear();
+    m_activeJobs.clear();
+    m_jobs.reset();
     MonitorLog::instance().info("dispatch", "Stopped");
 }
 
-void DispatchManager::update()
+void DispatchManager::wake()
 {
-    if (!m_running)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakePending = true;
+    }
+    m_cv.notify_one();
+}
+
+void DispatchManager::drainLocalDispatches()
+{
+    std::vector<LocalDispatch> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending.swap(m_localDispatches);
+    }
+
+    // Outside the lock: RenderCoordinator belongs to the main thread
+    if (m_localDispatchFn)
+    {
+        for (const auto& d : pending)
+            m_localDispatchFn(d.manifest, d.chunk, d.traceId);
+    }
+}
+
+void DispatchManager::setClock(std::function<int64_t()> clockFn)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_clockFn = std::move(clockFn);
+}
+
+void DispatchManager::setThreaded(bool threaded)
+{
+    m_threaded = threaded;
+}
+
+void DispatchManager::tick()
+{
+    if (!m_running || m_threaded)
         return;
 
-    auto jobs = m_jobSnapshotFn();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wakePending = false;
+    runCycleAndFlush(lock);
+}
 
-    // One-time recovery on first update
-    if (!m_recovered)
+void DispatchManager::seedTables(std::map<std::string, DispatchTable> tables)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_seedTables = std::move(tables);
+}
+
+void DispatchManager::setEpoch(uint64_t epoch)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_epoch = epoch;
+}
+
+void DispatchManager::fence()
+{
+    m_fenced = true;
+}
+
+void DispatchManager::setShardMode(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shardMode = enabled;
+}
+
+std::map<std::string, DispatchTable> DispatchManager::getDispatchTables() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dispatchTables;
+}
+
+DispatchManager::TableChanges DispatchManager::getChangedTables(uint64_t since) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TableChanges changes;
+    changes.version = m_tablesVersion.load();
+    for (const auto& [jobId, revision] : m_tableRevisions)
     {
-        recoverFromDisk(jobs);
-        m_recovered = true;
+        if (revision <= since)
+            continue;
+        auto it = m_dispatchTables.find(jobId);
+        auto iit = m_chunkIndex.find(jobId);
+        if (it == m_dispatchTables.end() || iit == m_chunkIndex.end())
+        {
+            changes.released.push_back(jobId);
+            continue;
+        }
+
+        const auto& frames = iit->second.frames;
+        TableProgress prog;
+        prog.completed = frames[size_t(DispatchState::Completed)];
+        prog.rendering = frames[size_t(DispatchState::Assigned)];
+        prog.failed = frames[size_t(DispatchState::Failed)];
+        prog.total = prog.completed + prog.rendering + prog.failed +
+                     frames[size_t(DispatchState::Pending)];
+        prog.renderingChunks = int(iit->second.assigned.size());
+
+        changes.tables.emplace(jobId, it->second);
+        changes.progress.emplace(jobId, prog);
     }
+    return changes;
+}
 
-    // Ensure dispatch tables exist for all active jobs
-    for (const auto& job : jobs)
+// ─── Dispatch thread ────────────────────────────────────────────────────────
+
+void DispatchManager::threadFunc()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running)
     {
-        if (job.current_state == "active" &&
-            m_dispatchTables.find(job.manifest.job_id) == m_dispatchTables.end())
+        m_wakePending = false;
+        runCycleAndFlush(lock);
+
+        // Sleep until an event arrives. The fallback timer covers heartbeat-file
+        // changes and stale timeouts; wake earlier if a throttled write is waiting.
+        int64_t waitMs = FALLBACK_WAKE_MS;
+        if (!m_dirtyTables.empty())
         {
-            initDispatchTable(job.manifest.job_id, job.manifest);
+            auto sinceWrite = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - m_lastWrite).count();
+            waitMs = std::clamp<int64_t>(WRITE_THROTTLE_MS - sinceWrite, 50, FALLBACK_WAKE_MS);
         }
+
+        m_cv.wait_for(lock, std::chrono::milliseconds(waitMs),
+                      [this] { return m_wakePending || !m_running; });
+    }
+}
+
+void DispatchManager::runCycleAndFlush(std::unique_lock<std::mutex>& lock)
+{
+    auto writes = runCycle();
+    auto flushFn = m_commandFlushFn;
+
+    lock.unlock();
+    for (auto& write : writes)
+        write.ok = performTableWrite(write);
+    if (flushFn)
+        flushFn();
+    lock.lock();
+
+    finishTableWrites(writes);
+}
+
+std::vector<DispatchManager::TableWrite> DispatchManager::runCycle()
+{
+    SR_PERF_SCOPE("dispatch.cycle");
+    m_cycleStartUs = ChunkTrace::nowUs();
+    if (!checkLease())
+        return {};
+
+    m_jobs = m_jobSnapshotFn();
+    m_estimates = m_estimatesFn ? m_estimatesFn() : nullptr;
+    refreshNodes();
+
+    // A list restored from the local index can miss jobs submitted since it
+    // was saved; recovering or dispatching from it could reset their tables
+    if (m_jobs->provisional)
+        return {};
+
+    // One-time recovery on first cycle. Shards recover each job once they
+    // own it and its handoff has settled (refreshJobViews).
+    if (!m_recovered)
+    {
+        if (!m_shardMode)
+            recoverFromDisk(m_jobs->jobs);
+        m_recovered = true;
     }
 
+    if (m_jobs->version != m_jobsVersion ||
+        (!m_handoffJobs.empty() && nowMs() >= m_handoffUntilMs))
+        refreshJobViews();
+
     processLocalCompletions();
     processWorkerReports();
+    processVerifyResults();
     detectDeadWorkers();
     checkJobCompletions();
 
     if (m_nodeActive)
+    {
+        // Preempt first: assignWork counts the slots it frees as open (the
+        // nodes' heartbeats lag) and the waiting job is first in line for them
+        preemptLowerPriority();
         assignWork();
+        speculateStragglers();
+    }
+
+    size_t pending = 0;
+    for (const auto* job : m_activeJobs)
+    {
+        auto iit = m_chunkIndex.find(job->manifest.job_id);
+        if (iit != m_chunkIndex.end())
+            pending += iit->second.pending.size();
+    }
+    m_pendingChunks = pending;
+
+    if (m_nodeActive)
+        managePower();
 
-    writeDispatchTables();
+    return takeTableWrites();
 }
 
 void DispatchManager::processAction(const CommandManager::Action& action)
 {
-    if (action.type == "chunk_completed" || action.type == "chunk_failed")
+    if (action.type != "chunk_completed" && action.type != "chunk_failed")
+        return;
+
     {
+        std::lock_guard<std::mutex> lock(m_mutex);
         m_workerReports.push(action);
+        m_wakePending = true;
     }
+    m_cv.notify_one();
 }
 
 void DispatchManager::queueLocalCompletion(const std::string& jobId,
                                             const ChunkRange& chunk,
-                                            const std::string& state)
+                                            const std::string& state,
+                                            const std::string& framesDone)
 {
-    m_localCompletionQueue.push({jobId, chunk, state});
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_localCompletionQueue.push({jobId, chunk, state, framesDone});
+        m_wakePending = true;
+    }
+    m_cv.notify_one();
 }
 
 void DispatchManager::handleJobStateChange(const std::string& jobId,
                                             const std::string& newState)
 {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wakePending = true;
+
     if (newState == "paused" || newState == "cancelled")
     {
-        // Find any assigned chunks for this job and send abort to workers
-        std::vector<std::string> nodesToAbort;
-        for (auto& [nodeId, assignment] : m_assignments)
+        // The caller already stopped our own render of it
+        dropJobAssignments(jobId, "job_" + newState, false);
+    }
+    else if (newState == "active")
+    {
+        // Resume: dispatch table already has pending chunks, assignWork() will pick them up
+        auto it = m_dispatchTables.find(jobId);
+        if (it == m_dispatchTables.end() && ownsJob(jobId) && !m_handoffJobs.count(jobId))
         {
-            if (assignment.jobId == jobId)
-                nodesToAbort.push_back(nodeId);
+            // Table may have been cleaned up — rebuild from manifest (a shard
+            // only rebuilds its own, and not one still being handed over)
+            auto snap = m_jobSnapshotFn();
+            if (const auto* job = snap->find(jobId))
+                initDispatchTable(jobId, job->manifest);
         }
+    }
+
+    auto flushFn = m_commandFlushFn;
+    lock.unlock();
+    m_cv.notify_one();
 
-        for (const auto& nodeId : nodesToAbort)
+    if (flushFn)
+        flushFn();
+}
+
+void DispatchManager::dropJobAssignments(const std::string& jobId, const std::string& reason,
+                                         bool includeSelf)
+{
+    // Drop this job's chunks from every node's queue and send abort to workers
+    for (auto nit = m_assignments.begin(); nit != m_assignments.end(); )
+    {
+        const auto& nodeId = nit->first;
+        auto& queue = nit->second;
+        for (auto ait = queue.begin(); ait != queue.end(); )
         {
-            if (nodeId != m_nodeId && m_commandSenderFn)
+            if (ait->jobId != jobId)
             {
-                auto& a = m_assignments[nodeId];
-                m_commandSenderFn(nodeId, "abort_chunk", jobId, "job_" + newState,
-                                  a.chunk.frame_start, a.chunk.frame_end);
+                ++ait;
+                continue;
             }
-            m_assignments.erase(nodeId);
-        }
-
-        // Mark all assigned chunks in dispatch table back to pending
-        auto it = m_dispatchTables.find(jobId);
-        if (it != m_dispatchTables.end())
-        {
-            for (auto& chunk : it->second.chunks)
+            if ((includeSelf || nodeId != m_nodeId) && m_commandSenderFn)
             {
-                if (chunk.state == "assigned")
-                {
-                    chunk.state = "pending";
-                    chunk.assigned_to.clear();
-                    chunk.assigned_at_ms = 0;
-                }
+                m_commandSenderFn(nodeId, "abort_chunk", jobId, reason,
+                                  ait->chunk.frame_start, ait->chunk.frame_end, {});
             }
-            markDirty(jobId);
+            ait = eraseAssignment(nodeId, queue, ait);
         }
+
+        if (queue.empty())
+            nit = m_assignments.erase(nit);
+        else
+            ++nit;
     }
-    else if (newState == "active")
+
+    // Mark all assigned chunks in dispatch table back to pending
+    auto it = m_dispatchTables.find(jobId);
+    auto iit = m_chunkIndex.find(jobId);
+    if (it != m_dispatchTables.end() && iit != m_chunkIndex.end())
     {
-        // Resume: dispatch table already has pending chunks, assignWork() will pick them up
-        auto it = m_dispatchTables.find(jobId);
-        if (it == m_dispatchTables.end())
-        {
-            // Table may have been cleaned up — rebuild from manifest
-            auto jobs = m_jobSnapshotFn();
-            for (const auto& job : jobs)
-            {
-                if (job.manifest.job_id == jobId)
-                {
-                    initDispatchTable(jobId, job.manifest);
-                    break;
-                }
-            }
-        }
+        std::vector<size_t> assigned(iit->second.assigned.begin(), iit->second.assigned.end());
+        for (size_t pos : assigned)
+            releaseChunk(it->second, iit->second, pos);
+        markDirty(jobId);
     }
 }
 
 void DispatchManager::setLocalDispatchCallback(DispatchCallback fn)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_localDispatchFn = std::move(fn);
 }
 
 void DispatchManager::setCommandSender(CommandSenderFn fn)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_commandSenderFn = std::move(fn);
 }
 
+void DispatchManager::setCommandFlush(std::function<void()> fn)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commandFlushFn = std::move(fn);
+}
+
+void DispatchManager::setRenderEstimates(std::function<RenderEstimatesPtr()> fn)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_estimatesFn = std::move(fn);
+}
+
 void DispatchManager::updateTiming(const TimingConfig& timing)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_timing = timing;
 }
 
 void DispatchManager::updateTags(const std::vector<std::string>& tags)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_tags = tags;
 }
 
 void DispatchManager::setNodeActive(bool active)
 {
-    m_nodeActive = active;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nodeActive = active;
+        m_wakePending = true;
+    }
+    m_cv.notify_one();
+}
+
+void DispatchManager::setPrefetchDepth(int depth)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_prefetchDepth = (std::max)(0, depth);
+}
+
+void DispatchManager::setJobAffinity(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobAffinity = enabled;
+}
+
+void DispatchManager::setPreemption(const PreemptionPolicy& policy)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_preemption = policy;
+}
+
+void DispatchManager::setPowerPolicy(const PowerPolicy& policy)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_power = policy;
+}
+
+void DispatchManager::setWakeSender(WakeSenderFn fn)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_wakeSenderFn = std::move(fn);
+}
+
+void DispatchManager::setSchedulingPolicy(SchedulingPolicy policy)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (policy != m_policy)
+        MonitorLog::instance().info("dispatch", std::string("Scheduling policy: ") +
+            schedulingPolicyName(policy));
+    m_policy = policy;
 }
 
 // ─── Dispatch cycle steps ───────────────────────────────────────────────────
 
 void DispatchManager::processLocalCompletions()
 {
+    std::queue<CompletionEntry> heldBack;   // jobs still being handed to us
     while (!m_localCompletionQueue.empty())
     {
         auto entry = std::move(m_localCompletionQueue.front());
         m_localCompletionQueue.pop();
 
-        auto it = m_dispatchTables.find(entry.jobId);
-        if (it == m_dispatchTables.end()) continue;
+        int pos = findChunk(entry.jobId, entry.chunk.frame_start, entry.chunk.frame_end);
+        if (pos < 0)
+        {
+            if (m_handoffJobs.count(entry.jobId))
+                heldBack.push(std::move(entry));
+            continue;
+        }
+
+        auto& dt = m_dispatchTables[entry.jobId];
+        auto& idx = m_chunkIndex[entry.jobId];
+        auto& chunk = dt.chunks[pos];
+
+        // Failures only count while the chunk is still ours — it may have been
+        // reassigned (and handed to someone else) before the abort landed
+        bool ownsChunk = chunk.state == DispatchState::Assigned && chunk.assigned_to == m_nodeId;
 
-        for (auto& chunk : it->second.chunks)
+        if (entry.state == "completed")
         {
-            if (chunk.frame_start == entry.chunk.frame_start &&
-                chunk.frame_end == entry.chunk.frame_end)
+            // First completion wins; a speculative copy finishing later is dropped
+            if (chunk.state != DispatchState::Completed)
             {
-                if (entry.state == "completed")
-                {
-                    chunk.state = "completed";
-                    chunk.completed_at_ms = nowMs();
-                }
-                else if (entry.state == "failed")
-                {
-                    chunk.retry_count++;
-                    auto jobs = m_jobSnapshotFn();
-                    int maxRetries = 3;
-                    for (const auto& j : jobs)
-                    {
-                        if (j.manifest.job_id == entry.jobId)
-                        {
-                            maxRetries = j.manifest.max_retries;
-                            break;
-                        }
-                    }
-                    chunk.state = (chunk.retry_count >= maxRetries) ? "failed" : "pending";
-                    chunk.assigned_to.clear();
-                    chunk.assigned_at_ms = 0;
-                }
-                else // abandoned
-                {
-                    chunk.state = "pending";
-                    chunk.assigned_to.clear();
-                    chunk.assigned_at_ms = 0;
-                }
+                setChunkState(dt, idx, (size_t)pos, DispatchState::Completed);
+                chunk.assigned_to = m_nodeId;
+                chunk.completed_at_ms = nowMs();
+                recordChunkTime(entry.jobId, m_nodeId, chunk);
                 markDirty(entry.jobId);
-                break;
+                abortDuplicates(entry.jobId, entry.chunk, m_nodeId);
+                if (auto* job = activeJob(entry.jobId); job && job->manifest.output_detection.verifiesFrames())
+                    verifyFrames(*job, entry.chunk, false);
+            }
+        }
+        else if (ownsChunk && promoteSpeculative(entry.jobId, (size_t)pos, m_nodeId))
+        {
+            markDirty(entry.jobId);
+        }
+        else if (ownsChunk)
+        {
+            if (entry.state == "failed")
+            {
+                if (!salvageChunk(entry.jobId, (size_t)pos, parseFrameSet(entry.framesDone), m_nodeId))
+                    failChunk(dt, idx, (size_t)pos);
             }
+            else // abandoned
+                releaseChunk(dt, idx, (size_t)pos);
+            markDirty(entry.jobId);
         }
 
-        // Remove from assignments
-        auto ait = m_assignments.find(m_nodeId);
-        if (ait != m_assignments.end() && ait->second.jobId == entry.jobId)
-            m_assignments.erase(ait);
+        removeAssignment(m_nodeId, entry.jobId, entry.chunk);
 
         MonitorLog::instance().info("dispatch", "Local " + entry.state + ": job=" + entry.jobId +
             " chunk=" + entry.chunk.rangeStr());
     }
+    m_localCompletionQueue = std::move(heldBack);
 }
 
 void DispatchManager::processWorkerReports()
 {
+    std::queue<CommandManager::Action> heldBack;    // jobs still being handed to us
     while (!m_workerReports.empty())
     {
         auto action = std::move(m_workerReports.front());
         m_workerReports.pop();
 
-        auto it = m_dispatchTables.find(action.jobId);
-        if (it == m_dispatchTables.end()) continue;
+        int pos = findChunk(action.jobId, action.frameStart, action.frameEnd);
+        if (pos < 0)
+        {
+            if (m_handoffJobs.count(action.jobId))
+                heldBack.push(std::move(action));
+            continue;
+        }
+
+        auto& dt = m_dispatchTables[action.jobId];
+        auto& idx = m_chunkIndex[action.jobId];
+        auto& chunk = dt.chunks[pos];
 
-        for (auto& chunk : it->second.chunks)
+        if (action.type == "chunk_completed")
         {
-            if (chunk.frame_start == action.frameStart &&
-                chunk.frame_end == action.frameEnd)
+            // First completion wins; a speculative copy finishing later is dropped
+            if (chunk.state != DispatchState::Completed)
             {
-                if (action.type == "chunk_completed")
-                {
-                    chunk.state = "completed";
-                    chunk.completed_at_ms = nowMs();
-                }
-                else // chunk_failed
-                {
-                    chunk.retry_count++;
-                    auto jobs = m_jobSnapshotFn();
-                    int maxRetries = 3;
-                    for (const auto& j : jobs)
-                    {
-                        if (j.manifest.job_id == action.jobId)
-                        {
-                            maxRetries = j.manifest.max_retries;
-                            break;
-                        }
-                    }
-                    chunk.state = (chunk.retry_count >= maxRetries) ? "failed" : "pending";
-                    chunk.assigned_to.clear();
-                    chunk.assigned_at_ms = 0;
-                }
+                setChunkState(dt, idx, (size_t)pos, DispatchState::Completed);
+                chunk.assigned_to = action.fromNodeId;
+                chunk.completed_at_ms = nowMs();
+                recordChunkTime(action.jobId, action.fromNodeId, chunk);
                 markDirty(action.jobId);
-                break;
+                abortDuplicates(action.jobId, ChunkRange{action.frameStart, action.frameEnd},
+                                action.fromNodeId);
+                if (auto* job = activeJob(action.jobId); job && job->manifest.output_detection.verifiesFrames())
+                    verifyFrames(*job, ChunkRange{action.frameStart, action.frameEnd}, false);
             }
         }
+        else if (chunk.state == DispatchState::Assigned && chunk.assigned_to == action.fromNodeId)
+        {
+            // chunk_failed — ignored if the chunk has since moved to another worker.
+            // A running speculative copy takes over instead of burning a retry.
+            if (!promoteSpeculative(action.jobId, (size_t)pos, action.fromNodeId) &&
+                !salvageChunk(action.jobId, (size_t)pos, parseFrameSet(action.framesDone), action.fromNodeId))
+                failChunk(dt, idx, (size_t)pos);
+            markDirty(action.jobId);
+        }
 
-        // Remove from assignments
-        auto ait = m_assignments.find(action.fromNodeId);
-        if (ait != m_assignments.end() && ait->second.jobId == action.jobId)
-            m_assignments.erase(ait);
+        removeAssignment(action.fromNodeId, action.jobId, ChunkRange{action.frameStart, action.frameEnd});
 
         MonitorLog::instance().info("dispatch", "Worker " + action.type + " from " +
             action.fromNodeId + ": job=" + action.jobId);
     }
+    m_workerReports = std::move(heldBack);
 }
 
 void DispatchManager::detectDeadWorkers()
 {
-    auto nodes = m_nodeSnapshotFn();
     auto now = nowMs();
 
     // Stale assignment timeout: generous enough for command propagation + inbox poll + render start
@@ -321,33 +653,38 @@ void DispatchManager::detectDeadWorkers()
     );
 
     std::vector<std::string> staleNodes;
-    for (auto& [nodeId, assignment] : m_assignments)
+    std::set<std::string> deadNodes;
+    std::set<std::string> parkedNodes;     // asleep: their chunks go back without a retry
+    for (auto& [nodeId, queue] : m_assignments)
     {
         if (nodeId == m_nodeId) continue; // self is never stale
+        if (queue.empty()) continue;
 
         // Case 1: worker is dead — reassign immediately
-        if (isNodeDead(nodeId, nodes))
+        const auto* node = m_nodes.find(nodeId);
+        if (isNodeDead(nodeId))
         {
             staleNodes.push_back(nodeId);
+            deadNodes.insert(nodeId);
+            if (node && node->isParked())
+                parkedNodes.insert(nodeId);
             continue;
         }
 
-        // Case 2: assignment has been pending too long and worker isn't rendering it
-        int64_t age = now - assignment.assignedAtMs;
-        if (age > staleMs)
+        // Case 2: an active assignment has been pending too long and the worker
+        // isn't rendering its job on any slot
+        const Heartbeat* hb = node ? &node->heartbeat : nullptr;
+        size_t active = (std::min)(queue.size(), slotsFor(nodeId));
+        for (size_t i = 0; i < active; ++i)
         {
-            bool workerRenderingThisJob = false;
-            for (const auto& n : nodes)
-            {
-                if (n.heartbeat.node_id == nodeId)
-                {
-                    workerRenderingThisJob =
-                        (n.heartbeat.render_state == "rendering" &&
-                         n.heartbeat.active_job == assignment.jobId);
-                    break;
-                }
-            }
+            const auto& assignment = queue[i];
+            int64_t age = now - assignment.assignedAtMs;
+            if (age <= staleMs)
+                continue;
 
+            bool workerRenderingThisJob = hb && hb->render_state == "rendering" &&
+                (hb->active_job == assignment.jobId ||
+                 std::find(hb->active_jobs.begin(), hb->active_jobs.end(), assignment.jobId) != hb->active_jobs.end());
             if (!workerRenderingThisJob)
             {
                 staleNodes.push_back(nodeId);
@@ -355,138 +692,371 @@ void DispatchManager::detectDeadWorkers()
                     " chunk=" + assignment.chunk.rangeStr() +
                     " job=" + assignment.jobId +
                     " (age=" + std::to_string(age / 1000) + "s, worker not rendering)");
+                break;
             }
         }
     }
 
     for (const auto& nodeId : staleNodes)
     {
-        auto& assignment = m_assignments[nodeId];
-        auto it = m_dispatchTables.find(assignment.jobId);
-        if (it != m_dispatchTables.end())
+        auto queue = std::move(m_assignments[nodeId]);
+        m_assignments.erase(nodeId);
+        bool alive = !deadNodes.count(nodeId);
+        bool parked = parkedNodes.count(nodeId) > 0;
+        size_t active = slotsFor(nodeId);
+
+        for (size_t i = 0; i < queue.size(); ++i)
         {
-            for (auto& chunk : it->second.chunks)
-            {
-                if (chunk.frame_start == assignment.chunk.frame_start &&
-                    chunk.frame_end == assignment.chunk.frame_end &&
-                    chunk.state == "assigned")
-                {
-                    chunk.retry_count++;
-                    auto jobs = m_jobSnapshotFn();
-                    int maxRetries = 3;
-                    for (const auto& j : jobs)
-                    {
-                        if (j.manifest.job_id == assignment.jobId)
-                        {
-                            maxRetries = j.manifest.max_retries;
-                            break;
-                        }
-                    }
-                    chunk.state = (chunk.retry_count >= maxRetries) ? "failed" : "pending";
-                    chunk.assigned_to.clear();
-                    chunk.assigned_at_ms = 0;
-                    markDirty(assignment.jobId);
+            const auto& assignment = queue[i];
+            int pos = findChunk(assignment.jobId, assignment.chunk.frame_start, assignment.chunk.frame_end);
+            if (pos < 0) continue;
 
-                    MonitorLog::instance().warn("dispatch", "Reassigning chunk " +
-                        assignment.chunk.rangeStr() + " from " + nodeId +
-                        " for job " + assignment.jobId);
-                    break;
-                }
+            auto& dt = m_dispatchTables[assignment.jobId];
+            auto& chunk = dt.chunks[pos];
+            if (chunk.state != DispatchState::Assigned || chunk.assigned_to != nodeId)
+                continue;
+
+            // A live-but-stale worker may still hold the chunk in its queue
+            if (alive && m_commandSenderFn)
+                m_commandSenderFn(nodeId, "abort_chunk", assignment.jobId, "coordinator_stale",
+                                  assignment.chunk.frame_start, assignment.chunk.frame_end, {});
+
+            markDirty(assignment.jobId);
+            if (promoteSpeculative(assignment.jobId, (size_t)pos, nodeId))
+                continue;
+
+            // Only active chunks cost a retry; prefetched ones never started.
+            // What an active one finished is in the node's event log.
+            if (i < active && !parked)
+            {
+                if (!salvageChunk(assignment.jobId, (size_t)pos,
+                                  finishedFramesFromEvents(assignment.jobId, nodeId, chunk), nodeId))
+                    failChunk(dt, m_chunkIndex[assignment.jobId], (size_t)pos);
             }
+            else
+                releaseChunk(dt, m_chunkIndex[assignment.jobId], (size_t)pos);
+
+            MonitorLog::instance().warn("dispatch", "Reassigning chunk " +
+                assignment.chunk.rangeStr() + " from " + nodeId +
+                " for job " + assignment.jobId);
         }
-        m_assignments.erase(nodeId);
     }
 }
 
 void DispatchManager::checkJobCompletions()
 {
-    auto jobs = m_jobSnapshotFn();
-
-    for (const auto& job : jobs)
+    for (const auto* job : m_activeJobs)
     {
-        if (job.current_state != "active")
+        const auto& jobId = job->manifest.job_id;
+        if (m_completionWritten.count(jobId))
             continue;
 
-        const auto& jobId = job.manifest.job_id;
-        if (m_completionWritten.count(jobId))
+        // Its input will never be there: fail it rather than wait forever
+        if (auto dead = job->manifest.depends_on.empty() ? std::nullopt : deadUpstream(*job))
+        {
+            dropJobAssignments(jobId, "upstream_" + dead->second, true);
+            writeJobState(jobId, "failed");
+            m_completionWritten.insert(jobId);
+            MonitorLog::instance().warn("dispatch", "JOB FAILED: " + jobId + ", upstream job '" +
+                                        dead->first + "' was " + dead->second);
             continue;
+        }
 
         auto it = m_dispatchTables.find(jobId);
-        if (it == m_dispatchTables.end())
+        auto iit = m_chunkIndex.find(jobId);
+        if (it == m_dispatchTables.end() || iit == m_chunkIndex.end())
             continue;
 
-        bool allDone = true;
-        for (const auto& chunk : it->second.chunks)
+        if (iit->second.completed != it->second.chunks.size())
+            continue;
+
+        // Every frame checked once more (requeued ones included) before it counts as done
+        if (job->manifest.output_detection.verifiesFrames() && !m_jobVerified.count(jobId))
         {
-            if (chunk.state != "completed")
-            {
-                allDone = false;
-                break;
-            }
+            const auto& chunks = it->second.chunks;
+            if (m_verifyInFlight.count(jobId))
+                continue;
+            if (!chunks.empty() &&
+                verifyFrames(*job, ChunkRange{chunks.front().frame_start, chunks.back().frame_end}, true))
+                continue;
+            m_jobVerified.insert(jobId);
         }
 
-        if (!allDone)
-            continue;
-
         // All chunks completed — write job state entry
-        auto now = nowMs();
-        JobStateEntry stateEntry;
-        stateEntry.state = "completed";
-        stateEntry.priority = 0;
-        stateEntry.node_id = m_nodeId;
-        stateEntry.timestamp_ms = now;
-
-        nlohmann::json j = stateEntry;
-        auto stateDir = m_farmPath / "jobs" / jobId / "state";
-        std::error_code ec;
-        fs::create_directories(stateDir, ec);
-        std::string filename = std::to_string(now) + ".json";
-        AtomicFileIO::writeJson(stateDir / filename, j);
-
+        writeJobState(jobId, "completed");
         m_completionWritten.insert(jobId);
         MonitorLog::instance().info("dispatch", "JOB COMPLETED: " + jobId);
     }
 }
 
-void DispatchManager::assignWork()
+void DispatchManager::writeJobState(const std::string& jobId, const std::string& state)
 {
-    auto nodes = m_nodeSnapshotFn();
-    auto jobs = m_jobSnapshotFn();
+    auto now = nowMs();
+    JobStateEntry stateEntry;
+    stateEntry.state = state;
+    stateEntry.priority = 0;
+    stateEntry.node_id = m_nodeId;
+    stateEntry.timestamp_ms = now;
+
+    nlohmann::json j = stateEntry;
+    auto stateDir = m_farmPath / "jobs" / jobId / "state";
+    FarmStorage::current().createDirectories(stateDir);
+    std::string filename = std::to_string(now) + ".json";
+    AtomicFileIO::writeJson(stateDir / filename, j, FileClass::State);
+}
 
-    // Build list of idle workers (nodes not already assigned)
-    std::vector<const NodeInfo*> idleWorkers;
-    for (const auto& node : nodes)
+// ─── Output verification ────────────────────────────────────────────────────
+
+const JobInfo* DispatchManager::activeJob(const std::string& jobId) const
+{
+    for (const auto* job : m_activeJobs)
     {
-        if (node.isDead) continue;
-        if (node.heartbeat.node_state != "active") continue;
-        if (node.heartbeat.render_state != "idle") continue;  // must show idle in heartbeat
-        if (m_assignments.count(node.heartbeat.node_id)) continue;
-        idleWorkers.push_back(&node);
+        if (job->manifest.job_id == jobId)
+            return job;
     }
+    return nullptr;
+}
 
-    if (idleWorkers.empty())
-        return;
-
-    // Sort jobs by priority (highest first)
-    std::vector<const JobInfo*> activeJobs;
-    for (const auto& job : jobs)
+bool DispatchManager::verifyFrames(const JobInfo& job, const ChunkRange& range, bool jobPass)
+{
+    const auto& jobId = job.manifest.job_id;
+    auto pattern = outputPatternFor(job.manifest);
+    if (!pattern)
     {
-        if (job.current_state == "active")
-            activeJobs.push_back(&job);
+        if (m_verifyWarned.insert(jobId).second)
+            MonitorLog::instance().warn("dispatch", "Job " + jobId +
+                " asks for verify_frames but has no per-frame output pattern; trusting exit codes");
+        return false;
     }
-    std::sort(activeJobs.begin(), activeJobs.end(),
-        [](const JobInfo* a, const JobInfo* b) {
-            return a->current_priority > b->current_priority;
-        });
 
-    // For each idle worker, find a pending chunk
+    const auto& detection = job.manifest.output_detection;
+    OutputVerifier::Request request;
+    request.jobId = jobId;
+    request.range = range;
+    request.jobPass = jobPass;
+    request.pattern = std::move(*pattern);
+    request.checkHeaders = detection.check_headers;
+    request.minSizeRatio = jobPass ? detection.min_size_ratio : 0.0;     // a chunk's median says little
+    m_verifier.submit(std::move(request));
+
+    ++m_verifyInFlight[jobId];
+    if (!jobPass)
+        m_jobVerified.erase(jobId);
+    return true;
+}
+
+void DispatchManager::processVerifyResults()
+{
+    for (auto& result : m_verifier.takeResults())
+    {
+        const auto& jobId = result.jobId;
+        auto fit = m_verifyInFlight.find(jobId);
+        if (fit != m_verifyInFlight.end() && --fit->second <= 0)
+            m_verifyInFlight.erase(fit);
+
+        // Deleted or handed to another shard since
+        if (!m_dispatchTables.count(jobId) || m_completionWritten.count(jobId))
+            continue;
+
+        if (!result.reachable)
+        {
+            if (m_verifyWarned.insert(jobId).second)
+                MonitorLog::instance().warn("dispatch", "Output dir of job " + jobId +
+                    " isn't reachable from the coordinator; frames not verified");
+        }
+        else if (!result.bad.empty())
+        {
+            requeueBadFrames(jobId, result.range, result.bad);
+            m_jobVerified.erase(jobId);
+            continue;
+        }
+
+        if (result.jobPass)
+            m_jobVerified.insert(jobId);
+    }
+}
+
+void DispatchManager::requeueBadFrames(const std::string& jobId, const ChunkRange& range,
+                                       const std::set<int>& bad)
+{
+    // Completed chunks in the range with a bad frame; salvage below reshapes the table
+    std::vector<ChunkRange> hit;
+    for (const auto& chunk : m_dispatchTables[jobId].chunks)
+    {
+        if (chunk.state != DispatchState::Completed ||
+            chunk.frame_end < range.frame_start || chunk.frame_start > range.frame_end)
+            continue;
+        auto b = bad.lower_bound(chunk.frame_start);
+        if (b != bad.end() && *b <= chunk.frame_end)
+            hit.push_back({chunk.frame_start, chunk.frame_end});
+    }
+
+    for (const auto& r : hit)
+    {
+        int pos = findChunk(jobId, r.frame_start, r.frame_end);
+        if (pos < 0)
+            continue;
+        auto& dt = m_dispatchTables[jobId];
+        auto& idx = m_chunkIndex[jobId];
+
+        // The good frames stay completed; the rest go back as one retry
+        std::set<int> good;
+        for (int f = r.frame_start; f <= r.frame_end; ++f)
+        {
+            if (!bad.count(f))
+                good.insert(f);
+        }
+        std::string nodeId = dt.chunks[pos].assigned_to;
+        if (!salvageChunk(jobId, (size_t)pos, good, nodeId))
+        {
+            failChunk(dt, idx, (size_t)pos);
+            dt.chunks[pos].completed_at_ms = 0;
+        }
+        markDirty(jobId);
+    }
+
+    std::string frames;
+    int listed = 0;
+    for (int f : bad)
+    {
+        if (listed++ == 8)
+        {
+            frames += " ...";
+            break;
+        }
+        frames += (frames.empty() ? "" : " ") + std::to_string(f);
+    }
+    MonitorLog::instance().warn("dispatch", "Output check: " + std::to_string(bad.size()) +
+        " missing or bad frame(s) in job " + jobId + " " + range.rangeStr() + ", requeued: " + frames);
+}
+
+void DispatchManager::assignWork()
+{
+    SR_PERF_SCOPE("dispatch.assign");
+
+    // Build list of workers with room in their queue: a node with nothing
+    // assigned that reports a free slot, or a node we're already feeding that is
+    // below its slots plus the prefetch depth. A node is listed once per open
+    // place, round-robin, so multi-slot nodes fill up without starving others.
+    std::vector<std::pair<const NodeInfo*, size_t>> open;
+    std::set<std::string> idleNodes;    // nothing queued or rendering: live load is all foreign
+    size_t maxOpen = 0;
+    for (const auto& node : m_nodes.nodes())
+    {
+        if (node.isDead) continue;
+        if (node.heartbeat.node_state != "active") continue;
+        if (!dispatchesTo(node.heartbeat)) continue;
+
+        const auto& nodeId = node.heartbeat.node_id;
+        size_t capacity = slotsFor(nodeId) + (size_t)m_prefetchDepth;
+        auto ait = m_assignments.find(nodeId);
+        size_t queued = (ait != m_assignments.end()) ? ait->second.size() : 0;
+        size_t room = 0;
+        if (queued == 0 && m_freedSlots.count(nodeId))
+        {
+            // Just preempted: the abort frees its slots before the heartbeat says so
+            room = capacity;
+        }
+        else if (queued == 0)
+        {
+            // Must show a free slot in its heartbeat
+            if (node.heartbeat.free_slots <= 0) continue;
+
+            // Our own renders load the machine by design, so only a node
+            // with nothing running is judged by its telemetry
+            if (node.heartbeat.free_slots >= node.heartbeat.render_slots)
+            {
+                bool overloaded = isOverloaded(node);
+                if (overloaded != (m_overloaded.count(nodeId) > 0))
+                {
+                    if (overloaded)
+                    {
+                        m_overloaded.insert(nodeId);
+                        MonitorLog::instance().info("dispatch", "Holding work from " + nodeId +
+                            ": busy outside the farm (cpu " + std::to_string(node.heartbeat.load.cpu_pct) +
+                            "%, " + std::to_string(node.heartbeat.load.ram_free_mb) + " MB free)");
+                    }
+                    else
+                    {
+                        m_overloaded.erase(nodeId);
+                        MonitorLog::instance().info("dispatch", nodeId + " load back to normal");
+                    }
+                }
+                if (overloaded) continue;
+                idleNodes.insert(nodeId);
+            }
+            room = (std::min)(capacity, (size_t)node.heartbeat.free_slots + (size_t)m_prefetchDepth);
+        }
+        else if (queued < capacity)
+        {
+            room = capacity - queued;
+        }
+        if (room == 0) continue;
+        open.push_back({&node, room});
+        maxOpen = (std::max)(maxOpen, room);
+    }
+
+    // Most spare throughput picks first: measured speed times idle CPU share.
+    // Unknown speed counts as the median, unknown load as idle.
+    auto spareThroughput = [this](const NodeInfo* n)
+    {
+        int cpu = std::clamp(n->heartbeat.load.cpu_pct, 0, 95);
+        return nodeSpeed(n->heartbeat.node_id, {}) * double(100 - cpu);
+    };
+    std::stable_sort(open.begin(), open.end(), [&](const auto& a, const auto& b)
+    {
+        return spareThroughput(a.first) > spareThroughput(b.first);
+    });
+
+    std::vector<const NodeInfo*> idleWorkers;
+    for (size_t round = 0; round < maxOpen; ++round)
+    {
+        for (const auto& [node, room] : open)
+        {
+            if (round < room)
+                idleWorkers.push_back(node);
+        }
+    }
+
+    if (idleWorkers.empty())
+        return;
+
+    // Fair-share works from live running-chunk counts; job counts come straight
+    // from the chunk index, submitter totals are tallied here and bumped per assign
+    bool fairShare = (m_policy != SchedulingPolicy::Priority);
+    std::unordered_map<std::string, size_t> submitterRunning;
+    if (m_policy == SchedulingPolicy::FairShareSubmitter)
+    {
+        for (const auto* job : m_activeJobs)
+            submitterRunning[job->manifest.submitted_by] += runningChunks(job->manifest.job_id);
+    }
+    std::vector<const JobInfo*> jobOrder;
+    std::vector<const JobInfo*> candidates;
+    auto now = nowMs();
+
+    // For each idle worker, find a pending chunk
     for (const auto* worker : idleWorkers)
     {
         const auto& workerNodeId = worker->heartbeat.node_id;
         const auto& workerOS = worker->heartbeat.os;
         const auto& workerTags = worker->heartbeat.tags;
+        bool workerIdle = idleNodes.count(workerNodeId) > 0;
+
+        if (fairShare)
+            orderJobsForWorker(jobOrder, submitterRunning);
+        const auto& order = fairShare ? jobOrder : m_activeJobs;
+
+        // Try the job this worker is warm on first, then the normal order
+        const JobInfo* warm = m_jobAffinity ? warmJobFor(workerNodeId, order, now) : nullptr;
+        if (warm)
+        {
+            candidates.clear();
+            candidates.push_back(warm);
+            for (const auto* job : order)
+                if (job != warm) candidates.push_back(job);
+        }
 
-        for (const auto* job : activeJobs)
+        for (const auto* job : warm ? candidates : order)
         {
             const auto& jobId = job->manifest.job_id;
 
@@ -505,26 +1075,40 @@ void DispatchManager::assignWork()
                 continue;
             }
 
+            // Machine too small for the job (or, idle, short of free memory now)
+            if (!meetsRequirements(job->manifest.requirements, *worker, workerIdle))
+                continue;
+
             auto it = m_dispatchTables.find(jobId);
-            if (it == m_dispatchTables.end())
+            auto iit = m_chunkIndex.find(jobId);
+            if (it == m_dispatchTables.end() || iit == m_chunkIndex.end())
                 continue;
 
-            // Find first pending chunk
-            DispatchChunk* pendingChunk = nullptr;
-            for (auto& chunk : it->second.chunks)
+            // Lowest pending chunk (with dependencies: whose upstream is done;
+            // adaptive resizing would merge ready ranges into waiting ones)
+            if (iit->second.pending.empty())
+                continue;
+            size_t pos = *iit->second.pending.begin();
+            if (!job->manifest.depends_on.empty())
             {
-                if (chunk.state == "pending")
-                {
-                    pendingChunk = &chunk;
-                    break;
-                }
+                auto ready = readyChunk(*job, it->second, iit->second);
+                if (!ready)
+                    continue;
+                pos = *ready;
+            }
+            else if (m_adaptive.count(jobId))
+            {
+                pos = adaptChunk(jobId, pos);
             }
+            DispatchChunk* pendingChunk = &it->second.chunks[pos];
 
-            if (!pendingChunk)
+            // A tiled still's merge waits until every tile has completed
+            if (job->manifest.tiles.isMerge(pendingChunk->frame_start) &&
+                iit->second.completed + 1 < it->second.chunks.size())
                 continue;
 
             // Assign!
-            pendingChunk->state = "assigned";
+            setChunkState(it->second, iit->second, pos, DispatchState::Assigned);
             pendingChunk->assigned_to = workerNodeId;
             pendingChunk->assigned_at_ms = nowMs();
             markDirty(jobId);
@@ -533,13 +1117,20 @@ void DispatchManager::assignWork()
             cr.frame_start = pendingChunk->frame_start;
             cr.frame_end = pendingChunk->frame_end;
 
-            m_assignments[workerNodeId] = {jobId, cr, pendingChunk->assigned_at_ms};
+            m_assignments[workerNodeId].push_back({jobId, cr, pendingChunk->assigned_at_ms});
+            if (m_policy == SchedulingPolicy::FairShareSubmitter)
+                ++submitterRunning[job->manifest.submitted_by];
+            m_nodeWarmJob[workerNodeId] = jobId;
+            m_lastServedMs[jobId] = now;
+            m_freedSlots.erase(workerNodeId);
+
+            std::string traceId = newTraceId();
+            traceAssignment(jobId, cr, traceId, workerNodeId, false);
 
             if (workerNodeId == m_nodeId)
             {
-                // Self-dispatch: call local callback directly
-                if (m_localDispatchFn)
-                    m_localDispatchFn(job->manifest, cr);
+                // Self-dispatch: main thread hands it to the local RenderCoordinator
+                m_localDispatches.push_back({job->manifest, cr, traceId});
                 MonitorLog::instance().info("dispatch", "Self-assigned: job=" + jobId +
                     " chunk=" + cr.rangeStr());
             }
@@ -549,257 +1140,1692 @@ void DispatchManager::assignWork()
                 if (m_commandSenderFn)
                     m_commandSenderFn(workerNodeId, "assign_chunk", jobId,
                                       "coordinator_dispatch",
-                                      cr.frame_start, cr.frame_end);
+                                      cr.frame_start, cr.frame_end, traceId);
                 MonitorLog::instance().info("dispatch", "Assigned to " + workerNodeId +
                     ": job=" + jobId + " chunk=" + cr.rangeStr());
             }
 
-            break; // one assignment per idle worker per cycle
+            break; // one assignment per open place per cycle
         }
     }
 }
 
-void DispatchManager::writeDispatchTables()
+std::string DispatchManager::newTraceId()
 {
-    if (m_dirtyTables.empty())
-        return;
-
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastWrite).count();
-    if (elapsed < WRITE_THROTTLE_MS)
-        return;
-
-    m_lastWrite = now;
-
-    for (const auto& jobId : m_dirtyTables)
-    {
-        auto it = m_dispatchTables.find(jobId);
-        if (it == m_dispatchTables.end()) continue;
-
-        auto& dt = it->second;
-        dt.updated_at_ms = nowMs();
-        dt.coordinator_id = m_nodeId;
-
-        nlohmann::json j = dt;
-        auto path = m_farmPath / "jobs" / jobId / "dispatch.json";
-        AtomicFileIO::writeJson(path, j);
-    }
-
-    m_dirtyTables.clear();
+    // Unique across coordinators and restarts; the worker only echoes it
+    return m_nodeId + "." + std::to_string(nowMs()) + "." + std::to_string(++m_traceSeq);
 }
 
-// ─── Manual chunk controls ──────────────────────────────────────────────────
-
-void DispatchManager::reassignChunk(const std::string& jobId, int frameStart, int frameEnd)
+void DispatchManager::traceAssignment(const std::string& jobId, const ChunkRange& chunk,
+                                      const std::string& traceId, const std::string& nodeId,
+                                      bool speculative)
 {
-    auto it = m_dispatchTables.find(jobId);
-    if (it == m_dispatchTables.end()) return;
+    ChunkTrace::instance().record(jobId, traceId, chunk, "dispatch", m_cycleStartUs, ChunkTrace::nowUs(),
+                                  {{"worker", nodeId}, {"speculative", speculative}});
+}
 
-    for (auto& chunk : it->second.chunks)
+std::optional<size_t> DispatchManager::readyChunk(const JobInfo& job, const DispatchTable& dt,
+                                                  const ChunkIndex& idx)
+{
+    const auto& jobId = job.manifest.job_id;
+    std::vector<const DispatchTable*> frameDeps;
+    for (const auto& dep : job.manifest.depends_on)
     {
-        if (chunk.frame_start == frameStart && chunk.frame_end == frameEnd &&
-            chunk.state == "assigned")
+        auto uit = m_jobs->index.find(dep.job_id);
+        if (uit == m_jobs->index.end())
         {
-            // Send abort to the worker currently rendering this chunk
-            if (!chunk.assigned_to.empty() && m_commandSenderFn)
-            {
-                if (chunk.assigned_to == m_nodeId)
-                {
-                    // Self-assigned: abort via local dispatch callback won't work,
-                    // but the completion callback handles reassignment.
-                    // We need to tell MonitorApp to abort the local render.
-                    // For now, send abort_chunk to self inbox (processed next cycle).
-                    m_commandSenderFn(m_nodeId, "abort_chunk", jobId,
-                                      "coordinator_reassign", frameStart, frameEnd);
-                }
-                else
-                {
-                    m_commandSenderFn(chunk.assigned_to, "abort_chunk", jobId,
-                                      "coordinator_reassign", frameStart, frameEnd);
-                }
-
-                // Remove from assignments
-                m_assignments.erase(chunk.assigned_to);
-            }
+            if (unknownUpstreamDone(jobId, dep.job_id))
+                continue;
+            return std::nullopt;
+        }
+        const auto& upstream = m_jobs->jobs[uit->second];
+        if (upstream.current_state == "completed")
+            continue;
 
-            chunk.state = "pending";
-            chunk.assigned_to.clear();
-            chunk.assigned_at_ms = 0;
-            markDirty(jobId);
+        // Frame-level needs the upstream table here; otherwise the whole job
+        bool byFrame = dep.frames && !job.manifest.tiles.enabled() && !upstream.manifest.tiles.enabled();
+        auto tit = byFrame ? m_dispatchTables.find(dep.job_id) : m_dispatchTables.end();
+        if (tit == m_dispatchTables.end())
+            return std::nullopt;
+        frameDeps.push_back(&tit->second);
+    }
 
-            MonitorLog::instance().info("dispatch", "Manual reassign: job=" + jobId +
-                " chunk=" + std::to_string(frameStart) + "-" + std::to_string(frameEnd));
-            return;
-        }
+    size_t scanned = 0;
+    for (size_t pos : idx.pending)
+    {
+        if (++scanned > DEPENDENCY_SCAN)
+            break;
+        const auto& chunk = dt.chunks[pos];
+        if (std::all_of(frameDeps.begin(), frameDeps.end(), [&](const DispatchTable* up) {
+                return framesCompleted(*up, chunk.frame_start, chunk.frame_end);
+            }))
+            return pos;
     }
+    return std::nullopt;
 }
 
-void DispatchManager::retryFailedChunk(const std::string& jobId, int frameStart, int frameEnd)
+std::optional<std::pair<std::string, std::string>> DispatchManager::deadUpstream(const JobInfo& job)
 {
-    auto it = m_dispatchTables.find(jobId);
-    if (it == m_dispatchTables.end()) return;
-
-    for (auto& chunk : it->second.chunks)
+    for (const auto& dep : job.manifest.depends_on)
     {
-        if (chunk.frame_start == frameStart && chunk.frame_end == frameEnd &&
-            chunk.state == "failed")
+        std::string state;
+        auto uit = m_jobs->index.find(dep.job_id);
+        if (uit != m_jobs->index.end())
         {
-            chunk.state = "pending";
-            chunk.assigned_to.clear();
-            chunk.assigned_at_ms = 0;
-            // Keep retry_count — don't reset so max_retries can still be enforced
-            markDirty(jobId);
-
-            MonitorLog::instance().info("dispatch", "Manual retry: job=" + jobId +
-                " chunk=" + std::to_string(frameStart) + "-" + std::to_string(frameEnd));
-            return;
+            state = m_jobs->jobs[uit->second].current_state;
+        }
+        else
+        {
+            readArchivedStates();
+            auto ait = m_archivedState.find(dep.job_id);
+            if (ait != m_archivedState.end())
+                state = ait->second;
         }
+        if (state == "cancelled" || state == "failed")
+            return std::make_pair(dep.job_id, state);
     }
+    return std::nullopt;
 }
 
-// ─── Helpers ────────────────────────────────────────────────────────────────
+void DispatchManager::readArchivedStates()
+{
+    int64_t now = nowMs();
+    if (m_lastArchiveReadMs != 0 && now - m_lastArchiveReadMs < ARCHIVE_READ_MS)
+        return;
+
+    m_lastArchiveReadMs = now;
+    ArchiveIndex::readSince(m_farmPath, m_archiveOffset, [this](const ArchiveRecord& r) {
+        if (r.removed)
+            m_archivedState.erase(r.job_id);
+        else
+            m_archivedState[r.job_id] = r.state;
+    });
+}
 
-bool DispatchManager::isNodeIdle(const std::string& nodeId,
-                                  const std::vector<NodeInfo>& nodes) const
+bool DispatchManager::unknownUpstreamDone(const std::string& jobId, const std::string& upstreamId)
 {
-    for (const auto& n : nodes)
+    int64_t now = nowMs();
+    readArchivedStates();
+
+    auto ait = m_archivedState.find(upstreamId);
+    if (ait != m_archivedState.end())
+        return ait->second == "completed";
+
+    auto [it, inserted] = m_unknownUpstream.try_emplace(jobId + "/" + upstreamId);
+    auto& unknown = it->second;
+    if (inserted)
     {
-        if (n.heartbeat.node_id == nodeId)
-            return n.heartbeat.render_state == "idle" &&
-                   n.heartbeat.node_state == "active" &&
-                   !n.isDead;
+        unknown.sinceMs = now;
+        MonitorLog::instance().warn("dispatch", "Job '" + jobId + "' waits on unknown job '" + upstreamId +
+            "' (not indexed yet?); releasing it in " + std::to_string(UNKNOWN_UPSTREAM_GRACE_MS / 1000) +
+            "s if it never shows up");
     }
-    return false;
+    if (unknown.released)
+        return true;
+    if (now - unknown.sinceMs < UNKNOWN_UPSTREAM_GRACE_MS)
+        return false;
+
+    unknown.released = true;
+    MonitorLog::instance().warn("dispatch", "Job '" + jobId + "' still depends on unknown job '" +
+                                upstreamId + "', treating it as done");
+    return true;
 }
 
-bool DispatchManager::isNodeDead(const std::string& nodeId,
-                                  const std::vector<NodeInfo>& nodes) const
+bool DispatchManager::framesCompleted(const DispatchTable& dt, int frameStart, int frameEnd)
 {
-    for (const auto& n : nodes)
+    // Chunks are sorted and disjoint; frames the table doesn't cover have
+    // nothing to wait for
+    auto it = std::partition_point(dt.chunks.begin(), dt.chunks.end(),
+        [&](const DispatchChunk& c) { return c.frame_end < frameStart; });
+    for (; it != dt.chunks.end() && it->frame_start <= frameEnd; ++it)
     {
-        if (n.heartbeat.node_id == nodeId)
-            return n.isDead && n.reclaimEligible;
+        if (it->state != DispatchState::Completed)
+            return false;
     }
-    return true; // not found = dead
+    return true;
 }
 
-bool DispatchManager::hasOSCmd(const JobManifest& manifest, const std::string& nodeOS) const
+// ─── Preemption ─────────────────────────────────────────────────────────────
+
+bool DispatchManager::hasReadyWork(const JobInfo& job)
 {
-    auto it = manifest.cmd.find(nodeOS);
-    return it != manifest.cmd.end() && !it->second.empty();
+    const auto& jobId = job.manifest.job_id;
+    auto it = m_dispatchTables.find(jobId);
+    auto iit = m_chunkIndex.find(jobId);
+    if (it == m_dispatchTables.end() || iit == m_chunkIndex.end() || iit->second.pending.empty())
+        return false;
+    if (!job.manifest.depends_on.empty())
+        return readyChunk(job, it->second, iit->second).has_value();
+
+    // A tiled still's merge alone waits on the tiles, not on a slot
+    const auto& idx = iit->second;
+    return !(idx.pending.size() == 1 &&
+             job.manifest.tiles.isMerge(it->second.chunks[*idx.pending.begin()].frame_start) &&
+             idx.completed + 1 < it->second.chunks.size());
 }
 
-bool DispatchManager::hasRequiredTags(const std::vector<std::string>& required,
-                                      const std::vector<std::string>& nodeTags) const
+void DispatchManager::preemptLowerPriority()
 {
-    for (const auto& req : required)
+    if (!m_preemption.enabled() || m_activeJobs.empty())
+        return;
+
+    auto now = nowMs();
+
+    // Slots freed earlier and still unclaimed count against the job's demand
+    std::unordered_map<std::string, size_t> unclaimed;
+    for (auto fit = m_freedSlots.begin(); fit != m_freedSlots.end(); )
     {
-        bool found = false;
-        for (const auto& tag : nodeTags)
+        const auto* node = m_nodes.find(fit->first);
+        if (!node || node->isDead || now - fit->second.atMs >= FREED_SLOT_MS)
         {
-            if (tag == req) { found = true; break; }
+            fit = m_freedSlots.erase(fit);
+            continue;
         }
-        if (!found) return false;
+        ++unclaimed[fit->second.jobId];
+        ++fit;
     }
-    return true;
-}
 
-void DispatchManager::initDispatchTable(const std::string& jobId, const JobManifest& manifest)
-{
-    auto chunks = computeChunks(manifest.frame_start, manifest.frame_end, manifest.chunk_size);
+    while (!m_preemptions.empty() && now - m_preemptions.front() >= 3600 * 1000)
+        m_preemptions.pop_front();
+    int budget = (std::min)(m_preemption.max_per_cycle,
+                            m_preemption.max_per_hour - static_cast<int>(m_preemptions.size()));
+    if (budget <= 0)
+        return;
 
-    DispatchTable dt;
-    dt.coordinator_id = m_nodeId;
-    dt.updated_at_ms = nowMs();
-    dt.chunks.reserve(chunks.size());
+    std::unordered_map<std::string, int> activePriority;
+    for (const auto* job : m_activeJobs)
+        activePriority[job->manifest.job_id] = job->current_priority;
 
-    for (const auto& cr : chunks)
+    int64_t waitMs = int64_t(m_preemption.wait_s) * 1000;
+    int64_t cooldownMs = int64_t(m_preemption.node_cooldown_s) * 1000;
+
+    // Highest priority first (m_activeJobs order)
+    for (const auto* job : m_activeJobs)
     {
-        DispatchChunk dc;
-        dc.frame_start = cr.frame_start;
-        dc.frame_end = cr.frame_end;
-        dt.chunks.push_back(dc);
-    }
+        if (budget <= 0)
+            break;
+        const auto& jobId = job->manifest.job_id;
+        auto sit = m_lastServedMs.find(jobId);
+        if (sit == m_lastServedMs.end() || now - sit->second < waitMs || !hasReadyWork(*job))
+            continue;
+        int ceiling = job->current_priority - m_preemption.min_priority_gap;
 
-    m_dispatchTables[jobId] = std::move(dt);
-    markDirty(jobId);
+        SR_PERF_SCOPE("dispatch.preempt");
 
-    MonitorLog::instance().info("dispatch", "Init dispatch table: job=" + jobId +
-        " chunks=" + std::to_string(chunks.size()));
-}
+        // Rendering chunks of low enough jobs, on nodes that could take this one
+        struct Victim
+        {
+            std::string nodeId;
+            Assignment assignment;
+            int priority = 0;
+        };
+        std::vector<Victim> victims;
+        for (const auto& node : m_nodes.nodes())
+        {
+            const auto& nodeId = node.heartbeat.node_id;
+            if (node.isDead || node.heartbeat.node_state != "active" || !dispatchesTo(node.heartbeat))
+                continue;
+            auto cit = m_preemptedAt.find(nodeId);
+            if (cit != m_preemptedAt.end() && now - cit->second < cooldownMs)
+                continue;
+            if (!hasOSCmd(job->manifest, node.heartbeat.os) ||
+                !hasRequiredTags(job->manifest.tags_required, node.heartbeat.tags) ||
+                !meetsRequirements(job->manifest.requirements, node, false))
+                continue;
+            auto ait = m_assignments.find(nodeId);
+            if (ait == m_assignments.end())
+                continue;
 
-void DispatchManager::markDirty(const std::string& jobId)
-{
-    m_dirtyTables.insert(jobId);
+            size_t active = (std::min)(slotsFor(nodeId), ait->second.size());
+            for (size_t i = 0; i < active; ++i)
+            {
+                const auto& a = ait->second[i];
+                auto pit = activePriority.find(a.jobId);
+                if (pit == activePriority.end() || pit->second > ceiling)
+                    continue;
+                if (a.speculative || hasSpeculativeCopy(a.jobId, a.chunk))
+                    continue;
+                victims.push_back({nodeId, a, pit->second});
+            }
+        }
+
+        // Lowest priority, then the youngest (least work thrown away)
+        std::sort(victims.begin(), victims.end(), [](const Victim& a, const Victim& b) {
+            if (a.priority != b.priority)
+                return a.priority < b.priority;
+            return a.assignment.assignedAtMs > b.assignment.assignedAtMs;
+        });
+
+        size_t wanted = m_chunkIndex[jobId].pending.size();
+        auto uit = unclaimed.find(jobId);
+        if (uit != unclaimed.end())
+            wanted -= (std::min)(wanted, uit->second);
+        size_t freed = 0;
+        for (const auto& v : victims)
+        {
+            if (budget <= 0 || freed >= wanted)
+                break;
+            if (m_preemptedAt.count(v.nodeId) && m_preemptedAt[v.nodeId] == now)
+                continue;   // one slot per node per cycle
+
+            // Chunks prefetched behind it would start next: release the low ones too
+            std::vector<Assignment> release{v.assignment};
+            auto& queue = m_assignments[v.nodeId];
+            for (size_t i = slotsFor(v.nodeId); i < queue.size(); ++i)
+            {
+                auto pit = activePriority.find(queue[i].jobId);
+                if (pit != activePriority.end() && pit->second <= ceiling && !queue[i].speculative)
+                    release.push_back(queue[i]);
+            }
+
+            for (size_t i = 0; i < release.size(); ++i)
+            {
+                const auto& a = release[i];
+                if (m_commandSenderFn)
+                    m_commandSenderFn(v.nodeId, "abort_chunk", a.jobId, "preempted",
+                                      a.chunk.frame_start, a.chunk.frame_end, {});
+                removeAssignment(v.nodeId, a.jobId, a.chunk);
+
+                int pos = findChunk(a.jobId, a.chunk.frame_start, a.chunk.frame_end);
+                if (pos < 0)
+                    continue;
+                auto& dt = m_dispatchTables[a.jobId];
+                auto& idx = m_chunkIndex[a.jobId];
+                if (dt.chunks[pos].state != DispatchState::Assigned || dt.chunks[pos].assigned_to != v.nodeId)
+                    continue;
+
+                // The rendering one keeps frames its node already wrote out
+                std::set<int> done;
+                if (i == 0)
+                    done = finishedFramesFromEvents(a.jobId, v.nodeId, dt.chunks[pos]);
+                if (done.empty() || !salvageChunk(a.jobId, (size_t)pos, done, v.nodeId, false))
+                    releaseChunk(dt, idx, (size_t)pos);
+                markDirty(a.jobId);
+            }
+
+            MonitorLog::instance().info("dispatch", "Preempted " + v.nodeId + ": job=" +
+                v.assignment.jobId + " chunk=" + v.assignment.chunk.rangeStr() + " (priority " +
+                std::to_string(v.priority) + ") for job " + jobId + " (priority " +
+                std::to_string(job->current_priority) + "), waiting " +
+                std::to_string((now - sit->second) / 1000) + "s");
+
+            m_preemptedAt[v.nodeId] = now;
+            m_freedSlots[v.nodeId] = {jobId, now};
+            m_preemptions.push_back(now);
+            --budget;
+            ++freed;
+        }
+    }
 }
 
-int64_t DispatchManager::nowMs() const
+void DispatchManager::orderJobsForWorker(std::vector<const JobInfo*>& order,
+                                         const std::unordered_map<std::string, size_t>& submitterRunning) const
 {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    // Priority tiers stay strict; within a tier the least-served submitter/job
+    // goes first. Stable sort off m_activeJobs keeps FIFO as the tie-break.
+    order = m_activeJobs;
+    bool bySubmitter = (m_policy == SchedulingPolicy::FairShareSubmitter);
+    std::stable_sort(order.begin(), order.end(),
+        [&](const JobInfo* a, const JobInfo* b)
+        {
+            if (a->current_priority != b->current_priority)
+                return a->current_priority > b->current_priority;
+            if (bySubmitter)
+            {
+                auto sa = submitterRunning.find(a->manifest.submitted_by);
+                auto sb = submitterRunning.find(b->manifest.submitted_by);
+                size_t ra = (sa != submitterRunning.end()) ? sa->second : 0;
+                size_t rb = (sb != submitterRunning.end()) ? sb->second : 0;
+                if (ra != rb)
+                    return ra < rb;
+            }
+            return runningChunks(a->manifest.job_id) < runningChunks(b->manifest.job_id);
+        });
 }
 
-// ─── Recovery ───────────────────────────────────────────────────────────────
-
-void DispatchManager::recoverFromDisk(const std::vector<JobInfo>& jobs)
+const JobInfo* DispatchManager::warmJobFor(const std::string& nodeId,
+                                          const std::vector<const JobInfo*>& order,
+                                          int64_t now) const
 {
-    std::error_code ec;
+    auto wit = m_nodeWarmJob.find(nodeId);
+    if (wit == m_nodeWarmJob.end())
+        return nullptr;
 
-    for (const auto& job : jobs)
+    auto hasPending = [this](const JobInfo* job)
     {
-        if (job.current_state != "active")
-            continue;
+        auto iit = m_chunkIndex.find(job->manifest.job_id);
+        return iit != m_chunkIndex.end() && !iit->second.pending.empty();
+    };
 
-        const auto& jobId = job.manifest.job_id;
-        auto dispatchPath = m_farmPath / "jobs" / jobId / "dispatch.json";
+    const JobInfo* warm = nullptr;
+    const JobInfo* top = nullptr;   // first job in order that still has work
+    for (const auto* job : order)
+    {
+        if (!hasPending(job)) continue;
+        if (!top) top = job;
+        if (job->manifest.job_id == wit->second) { warm = job; break; }
+    }
 
-        if (!fs::is_regular_file(dispatchPath, ec))
-            continue;
+    // Affinity never jumps a priority tier
+    if (!warm || warm->current_priority < top->current_priority)
+        return nullptr;
 
-        auto data = AtomicFileIO::safeReadJson(dispatchPath);
-        if (!data.has_value())
+    // Starvation guard: a same-priority job waiting too long gets this worker instead
+    for (const auto* job : order)
+    {
+        if (job == warm || job->current_priority != warm->current_priority || !hasPending(job))
             continue;
+        auto sit = m_lastServedMs.find(job->manifest.job_id);
+        if (sit != m_lastServedMs.end() && now - sit->second > AFFINITY_STARVE_MS)
+            return nullptr;
+    }
 
-        try
-        {
-            DispatchTable dt = data.value().get<DispatchTable>();
+    return warm;
+}
 
-            // Mark "assigned" chunks to dead nodes as "pending",
-            // and rebuild m_assignments for chunks that remain assigned
-            auto nodes = m_nodeSnapshotFn();
-            for (auto& chunk : dt.chunks)
-            {
-                if (chunk.state == "assigned")
-                {
-                    if (chunk.assigned_to.empty() || isNodeDead(chunk.assigned_to, nodes))
-                    {
-                        chunk.state = "pending";
-                        chunk.assigned_to.clear();
-                        chunk.assigned_at_ms = 0;
-                    }
-                    else
-                    {
-                        // Rebuild in-memory assignment tracking so detectDeadWorkers
-                        // and stale-assignment timeout can monitor this assignment
-                        ChunkRange cr;
-                        cr.frame_start = chunk.frame_start;
-                        cr.frame_end = chunk.frame_end;
-                        m_assignments[chunk.assigned_to] = {jobId, cr, chunk.assigned_at_ms};
-                    }
-                }
-            }
+size_t DispatchManager::runningChunks(const std::string& jobId) const
+{
+    auto iit = m_chunkIndex.find(jobId);
+    return (iit != m_chunkIndex.end()) ? iit->second.assigned.size() : 0;
+}
 
-            m_dispatchTables[jobId] = std::move(dt);
-            markDirty(jobId);
+std::vector<DispatchManager::TableWrite> DispatchManager::takeTableWrites()
+{
+    if (m_dirtyTables.empty())
+        return {};
 
-            MonitorLog::instance().info("dispatch", "Recovered dispatch table: " + jobId);
-        }
-        catch (const std::exception& e)
-        {
-            MonitorLog::instance().error("dispatch", "Failed to recover dispatch table for " +
-                jobId + ": " + std::string(e.what()));
-        }
-    }
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastWrite).count();
+    if (elapsed < WRITE_THROTTLE_MS)
+        return {};
+
+    m_lastWrite = now;
+
+    std::vector<TableWrite> writes;
+    for (const auto& jobId : m_dirtyTables)
+    {
+        if (auto write = prepareTableWrite(jobId, false))
+            writes.push_back(std::move(*write));
+    }
+    m_dirtyTables.clear();
+    return writes;
+}
+
+void DispatchManager::finishTableWrites(const std::vector<TableWrite>& writes)
+{
+    // Keep tables whose write failed dirty so they're retried next cycle
+    for (const auto& write : writes)
+    {
+        finishTableWrite(write);
+        if (!write.ok)
+            m_dirtyTables.insert(write.jobId);
+    }
+}
+
+bool DispatchManager::flushTable(const std::string& jobId, bool compact)
+{
+    auto write = prepareTableWrite(jobId, compact);
+    if (!write) return true;
+
+    write->ok = performTableWrite(*write);
+    finishTableWrite(*write);
+    return write->ok;
+}
+
+std::optional<DispatchManager::TableWrite> DispatchManager::prepareTableWrite(const std::string& jobId,
+                                                                             bool compact)
+{
+    auto it = m_dispatchTables.find(jobId);
+    if (it == m_dispatchTables.end()) return std::nullopt;
+
+    auto& dt = it->second;
+    auto& idx = m_chunkIndex[jobId];
+    auto& js = m_journal[jobId];
+
+    dt.updated_at_ms = nowMs();
+    dt.coordinator_id = m_nodeId;
+
+    TableWrite write;
+    write.jobId = jobId;
+    write.jobDir = m_farmPath / "jobs" / jobId;
+    write.starts = std::exchange(idx.dirtyStarts, {});
+
+    size_t compactAt = (std::max)(JOURNAL_MIN_COMPACT, dt.chunks.size() / 4);
+    if (compact || js.needsSnapshot || js.records + write.starts.size() > compactAt)
+    {
+        write.snapshot = true;
+        write.table = dt;
+        return write;
+    }
+
+    // Delta: one record per touched chunk (stale starts from merges are skipped)
+    write.records.reserve(write.starts.size());
+    for (int frameStart : write.starts)
+    {
+        auto pit = idx.byFrameStart.find(frameStart);
+        if (pit != idx.byFrameStart.end())
+            write.records.push_back(dt.chunks[pit->second]);
+    }
+    write.seq = dt.journal_seq + 1;
+    return write;
+}
+
+bool DispatchManager::performTableWrite(TableWrite& write)
+{
+    if (write.snapshot)
+        return DispatchJournal::writeSnapshot(write.jobDir, write.table);
+    return DispatchJournal::append(write.jobDir, write.records, write.seq);
+}
+
+void DispatchManager::finishTableWrite(const TableWrite& write)
+{
+    // The table may have been released or cleaned up while unlocked
+    auto it = m_dispatchTables.find(write.jobId);
+    if (it == m_dispatchTables.end()) return;
+
+    auto& idx = m_chunkIndex[write.jobId];
+    auto& js = m_journal[write.jobId];
+    if (!write.ok)
+    {
+        idx.dirtyStarts.insert(write.starts.begin(), write.starts.end());
+        return;
+    }
+
+    if (write.snapshot)
+    {
+        js = {};
+        js.needsSnapshot = false;
+        return;
+    }
+    it->second.journal_seq = write.seq - 1;
+    js.records += write.records.size();
+}
+
+// ─── Speculative execution ──────────────────────────────────────────────────
+
+void DispatchManager::speculateStragglers()
+{
+    auto now = nowMs();
+
+    // Spare capacity: nodes reporting a free slot that nothing queued will fill
+    std::vector<const NodeInfo*> spare;
+    for (const auto& node : m_nodes.nodes())
+    {
+        if (node.isDead || node.heartbeat.node_state != "active" ||
+            node.heartbeat.free_slots <= 0 || !dispatchesTo(node.heartbeat))
+            continue;
+        auto ait = m_assignments.find(node.heartbeat.node_id);
+        if (ait != m_assignments.end() && ait->second.size() >= slotsFor(node.heartbeat.node_id))
+            continue;
+        spare.push_back(&node);
+    }
+    if (spare.empty())
+        return;
+
+    for (const auto* job : m_activeJobs)
+    {
+        const auto& jobId = job->manifest.job_id;
+        auto it = m_dispatchTables.find(jobId);
+        auto iit = m_chunkIndex.find(jobId);
+        if (it == m_dispatchTables.end() || iit == m_chunkIndex.end())
+            continue;
+
+        // Only at the tail: nothing left to hand out (bar a tiled still's
+        // merge, which waits on these), some chunks still rendering
+        const auto& idx = iit->second;
+        bool onlyMerge = idx.pending.size() == 1 &&
+            job->manifest.tiles.isMerge(it->second.chunks[*idx.pending.begin()].frame_start);
+        if ((!idx.pending.empty() && !onlyMerge) || idx.assigned.empty())
+            continue;
+
+        auto fit = m_frameTimes.find(jobId);
+        if (fit == m_frameTimes.end() || fit->second.size() < MIN_FRAME_TIME_SAMPLES)
+            continue;
+        std::vector<double> sorted(fit->second.begin(), fit->second.end());
+        std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+        double medianPerFrame = sorted[sorted.size() / 2];
+        const auto& templateId = job->manifest.template_id;
+
+        // Backups go to the fastest spare node on this template first
+        std::stable_sort(spare.begin(), spare.end(), [&](const NodeInfo* a, const NodeInfo* b)
+        {
+            return nodeSpeed(a->heartbeat.node_id, templateId) > nodeSpeed(b->heartbeat.node_id, templateId);
+        });
+
+        for (size_t pos : idx.assigned)
+        {
+            if (spare.empty())
+                return;
+
+            const auto& chunk = it->second.chunks[pos];
+            ChunkRange cr{chunk.frame_start, chunk.frame_end};
+
+            // Elapsed since the owner started it (one of its active entries), not since it was queued
+            auto nit = m_assignments.find(chunk.assigned_to);
+            if (nit == m_assignments.end() || nit->second.empty())
+                continue;
+            const auto& ownerQueue = nit->second;
+            auto activeEnd = ownerQueue.begin() + (std::min)(ownerQueue.size(), slotsFor(chunk.assigned_to));
+            auto owned = std::find_if(ownerQueue.begin(), activeEnd, [&](const Assignment& a)
+            {
+                return a.jobId == jobId && a.chunk == cr;
+            });
+            if (owned == activeEnd)
+                continue;
+            if (hasSpeculativeCopy(jobId, cr))
+                continue;
+
+            int64_t elapsed = now - owned->assignedAtMs;
+            if (elapsed < MIN_STRAGGLER_MS)
+                continue;
+
+            // Fastest compatible spare node that isn't the owner
+            auto sit = std::find_if(spare.begin(), spare.end(), [&](const NodeInfo* n)
+            {
+                return n->heartbeat.node_id != chunk.assigned_to &&
+                       hasOSCmd(job->manifest, n->heartbeat.os) &&
+                       hasRequiredTags(job->manifest.tags_required, n->heartbeat.tags) &&
+                       meetsRequirements(job->manifest.requirements, *n, false);
+            });
+            if (sit == spare.end())
+                continue;
+
+            // Overdue for its own node's pace (a node known to be slow isn't a
+            // straggler just for taking its usual time), or a measured-faster
+            // spare node would finish it well before the owner is expected to
+            double frames = double(cr.frame_end - cr.frame_start + 1);
+            double expected = medianPerFrame * frames / nodeSpeed(chunk.assigned_to, templateId);
+            double backupExpected = medianPerFrame * frames / nodeSpeed((*sit)->heartbeat.node_id, templateId);
+            bool overdue = double(elapsed) >= expected * STRAGGLER_FACTOR;
+            bool outpaced = m_estimates &&
+                backupExpected * BACKUP_MARGIN < expected - double(elapsed);
+            if (!overdue && !outpaced)
+                continue;
+
+            const auto& backupId = (*sit)->heartbeat.node_id;
+            m_assignments[backupId].push_back({jobId, cr, now, true});
+
+            std::string traceId = newTraceId();
+            traceAssignment(jobId, cr, traceId, backupId, true);
+            if (backupId == m_nodeId)
+            {
+                m_localDispatches.push_back({job->manifest, cr, traceId});
+            }
+            else if (m_commandSenderFn)
+            {
+                m_commandSenderFn(backupId, "assign_chunk", jobId, "coordinator_speculative",
+                                  cr.frame_start, cr.frame_end, traceId);
+            }
+
+            MonitorLog::instance().info("dispatch", "Speculative copy on " + backupId +
+                ": job=" + jobId + " chunk=" + cr.rangeStr() + " (owner " + chunk.assigned_to +
+                ", " + std::to_string(elapsed / 1000) + "s vs expected " +
+                std::to_string(int64_t(expected) / 1000) + "s)");
+
+            spare.erase(sit);
+        }
+    }
+}
+
+bool DispatchManager::hasSpeculativeCopy(const std::string& jobId, const ChunkRange& chunk) const
+{
+    for (const auto& [nodeId, queue] : m_assignments)
+    {
+        for (const auto& a : queue)
+        {
+            if (a.speculative && a.jobId == jobId && a.chunk == chunk)
+                return true;
+        }
+    }
+    return false;
+}
+
+void DispatchManager::abortDuplicates(const std::string& jobId, const ChunkRange& chunk,
+                                      const std::string& keepNodeId)
+{
+    std::vector<std::string> holders;
+    for (const auto& [nodeId, queue] : m_assignments)
+    {
+        if (nodeId == keepNodeId) continue;
+        for (const auto& a : queue)
+        {
+            if (a.jobId == jobId && a.chunk == chunk)
+            {
+                holders.push_back(nodeId);
+                break;
+            }
+        }
+    }
+
+    for (const auto& nodeId : holders)
+    {
+        // Self too: abort_chunk via own inbox, same as a manual reassign
+        if (m_commandSenderFn)
+            m_commandSenderFn(nodeId, "abort_chunk", jobId, "speculative_lost",
+                              chunk.frame_start, chunk.frame_end, {});
+        removeAssignment(nodeId, jobId, chunk);
+
+        MonitorLog::instance().info("dispatch", "Aborting duplicate on " + nodeId +
+            ": job=" + jobId + " chunk=" + chunk.rangeStr());
+    }
+}
+
+bool DispatchManager::promoteSpeculative(const std::string& jobId, size_t pos,
+                                         const std::string& fromNodeId)
+{
+    auto& chunk = m_dispatchTables[jobId].chunks[pos];
+    ChunkRange cr{chunk.frame_start, chunk.frame_end};
+
+    for (auto& [nodeId, queue] : m_assignments)
+    {
+        if (nodeId == fromNodeId) continue;
+        for (auto& a : queue)
+        {
+            if (!a.speculative || a.jobId != jobId || !(a.chunk == cr))
+                continue;
+
+            a.speculative = false;
+            chunk.assigned_to = nodeId;
+            chunk.assigned_at_ms = a.assignedAtMs;
+            m_chunkIndex[jobId].dirtyStarts.insert(chunk.frame_start);
+
+            MonitorLog::instance().info("dispatch", "Speculative copy on " + nodeId +
+                " takes over chunk " + cr.rangeStr() + " from " + fromNodeId +
+                " for job " + jobId);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ─── Manual chunk controls ──────────────────────────────────────────────────
+
+void DispatchManager::reassignChunk(const std::string& jobId, int frameStart, int frameEnd)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    int pos = findChunk(jobId, frameStart, frameEnd);
+    if (pos < 0) return;
+
+    auto& dt = m_dispatchTables[jobId];
+    auto& chunk = dt.chunks[pos];
+    if (chunk.state != DispatchState::Assigned) return;
+
+    // Send abort to the worker currently rendering this chunk
+    if (!chunk.assigned_to.empty() && m_commandSenderFn)
+    {
+        if (chunk.assigned_to == m_nodeId)
+        {
+            // Self-assigned: abort via local dispatch callback won't work,
+            // but the completion callback handles reassignment.
+            // We need to tell MonitorApp to abort the local render.
+            // For now, send abort_chunk to self inbox (processed next cycle).
+            m_commandSenderFn(m_nodeId, "abort_chunk", jobId,
+                              "coordinator_reassign", frameStart, frameEnd, {});
+        }
+        else
+        {
+            m_commandSenderFn(chunk.assigned_to, "abort_chunk", jobId,
+                              "coordinator_reassign", frameStart, frameEnd, {});
+        }
+
+        // Remove from assignments
+        removeAssignment(chunk.assigned_to, jobId, ChunkRange{frameStart, frameEnd});
+    }
+    abortDuplicates(jobId, ChunkRange{frameStart, frameEnd}, chunk.assigned_to);
+
+    releaseChunk(dt, m_chunkIndex[jobId], (size_t)pos);
+    markDirty(jobId);
+
+    MonitorLog::instance().info("dispatch", "Manual reassign: job=" + jobId +
+        " chunk=" + std::to_string(frameStart) + "-" + std::to_string(frameEnd));
+
+    m_wakePending = true;
+    auto flushFn = m_commandFlushFn;
+    lock.unlock();
+    m_cv.notify_one();
+
+    if (flushFn)
+        flushFn();
+}
+
+void DispatchManager::retryFailedChunk(const std::string& jobId, int frameStart, int frameEnd)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int pos = findChunk(jobId, frameStart, frameEnd);
+    if (pos < 0) return;
+
+    auto& dt = m_dispatchTables[jobId];
+    if (dt.chunks[pos].state != DispatchState::Failed) return;
+
+    // Keep retry_count — don't reset so max_retries can still be enforced
+    releaseChunk(dt, m_chunkIndex[jobId], (size_t)pos);
+    markDirty(jobId);
+
+    MonitorLog::instance().info("dispatch", "Manual retry: job=" + jobId +
+        " chunk=" + std::to_string(frameStart) + "-" + std::to_string(frameEnd));
+
+    m_wakePending = true;
+    m_cv.notify_one();
+}
+
+// ─── Power management ───────────────────────────────────────────────────────
+
+void DispatchManager::managePower()
+{
+    // A shard only sees its own jobs' queue, which says nothing about the farm's
+    if (!m_power.enabled() || m_shardMode)
+        return;
+    auto now = nowMs();
+
+    size_t pending = 0, ready = 0;
+    for (const auto* job : m_activeJobs)
+    {
+        auto iit = m_chunkIndex.find(job->manifest.job_id);
+        if (iit == m_chunkIndex.end())
+            continue;
+        pending += iit->second.pending.size();
+        if (hasReadyWork(*job))
+            ready += iit->second.pending.size();
+    }
+
+    // Wake: after assignWork, what's still ready is what the awake nodes won't
+    // take. Nodes already woken and on their way up count against the need.
+    if (m_power.wake_on_lan && m_wakeSenderFn)
+    {
+        int64_t timeoutMs = int64_t(m_power.wake_timeout_s) * 1000;
+        for (auto it = m_wakeSentMs.begin(); it != m_wakeSentMs.end();)
+        {
+            if (now - it->second < timeoutMs)
+            {
+                ++it;
+                continue;
+            }
+            MonitorLog::instance().warn("dispatch", "Worker " + it->first + " didn't wake within " +
+                std::to_string(m_power.wake_timeout_s) + "s");
+            it = m_wakeSentMs.erase(it);
+        }
+
+        size_t want = ready / (size_t)(std::max)(1, m_power.wake_pending_chunks);
+        if (m_wakeSentMs.size() < want)
+        {
+            std::vector<const NodeInfo*> asleep;
+            for (const auto& node : m_nodes.nodes())
+            {
+                if (node.isParked() && !node.heartbeat.mac_address.empty() &&
+                    dispatchesTo(node.heartbeat) && !m_wakeSentMs.count(node.heartbeat.node_id))
+                    asleep.push_back(&node);
+            }
+            std::stable_sort(asleep.begin(), asleep.end(), [this](const NodeInfo* a, const NodeInfo* b)
+            {
+                return nodeSpeed(a->heartbeat.node_id, {}) > nodeSpeed(b->heartbeat.node_id, {});
+            });
+            for (const auto* node : asleep)
+            {
+                if (m_wakeSentMs.size() >= want)
+                    break;
+                const auto& nodeId = node->heartbeat.node_id;
+                // Even a failed send waits out the timeout before the next try
+                m_wakeSentMs[nodeId] = now;
+                if (m_wakeSenderFn(node->heartbeat.mac_address, m_power.wake_broadcast))
+                    MonitorLog::instance().info("dispatch", "Waking " + nodeId + " (" +
+                        std::to_string(ready) + " ready chunks)");
+                else
+                    MonitorLog::instance().warn("dispatch", "Wake-on-LAN to " + nodeId +
+                        " (" + node->heartbeat.mac_address + ") failed");
+            }
+        }
+    }
+
+    // Sleep: only nodes that opted in, and only ones we can wake again
+    if (m_power.idle_sleep_min > 0 && m_power.wake_on_lan && m_commandSenderFn && pending == 0)
+    {
+        int64_t idleMs = int64_t(m_power.idle_sleep_min) * 60000;
+        for (const auto& [nodeId, since] : m_idleSinceMs)
+        {
+            if (now - since < idleMs || nodeId == m_nodeId || m_sleepSentMs.count(nodeId))
+                continue;
+            const auto* node = m_nodes.find(nodeId);
+            if (!node || !node->heartbeat.allow_sleep || node->heartbeat.mac_address.empty())
+                continue;
+            const auto& hb = node->heartbeat;
+            if (hb.is_coordinator || hb.is_standby || hb.is_shard)
+                continue;
+            auto ait = m_assignments.find(nodeId);
+            if (ait != m_assignments.end() && !ait->second.empty())
+                continue;
+
+            m_sleepSentMs[nodeId] = now;
+            m_commandSenderFn(nodeId, "sleep", {}, "idle", 0, 0, {});
+            MonitorLog::instance().info("dispatch", "Asking " + nodeId + " to sleep (idle " +
+                std::to_string((now - since) / 60000) + " min)");
+        }
+    }
+}
+
+// ─── Helpers ────────────────────────────────────────────────────────────────
+
+void DispatchManager::refreshNodes()
+{
+    if (m_nodeSnapshotFn)
+        m_nodes.update(m_nodeSnapshotFn());
+}
+
+void DispatchManager::onNodeEvent(NodeRegistry::Event event, const std::string& nodeId, const NodeInfo& node)
+{
+    using Event = NodeRegistry::Event;
+    switch (event)
+    {
+        case Event::Joined:
+            m_nodeSlots.erase(nodeId);
+            break;
+
+        case Event::Left:
+            // Its queue may still be draining; keep the slot count for it
+            m_nodeSlots[nodeId] = (size_t)(std::max)(1, node.heartbeat.render_slots);
+            m_nodeWarmJob.erase(nodeId);
+            m_freedSlots.erase(nodeId);
+            m_overloaded.erase(nodeId);
+            m_idleSinceMs.erase(nodeId);
+            m_wakeSentMs.erase(nodeId);
+            m_sleepSentMs.erase(nodeId);
+            break;
+
+        case Event::BecameIdle:
+            m_idleSinceMs[nodeId] = nowMs();
+            break;
+
+        case Event::BecameBusy:
+            m_idleSinceMs.erase(nodeId);
+            m_sleepSentMs.erase(nodeId);
+            break;
+
+        case Event::BecameDead:
+        {
+            // detectDeadWorkers reclaims its queue this cycle
+            auto ait = m_assignments.find(nodeId);
+            if (ait != m_assignments.end() && !ait->second.empty())
+                MonitorLog::instance().warn("dispatch", "Worker " + nodeId +
+                    (node.isParked() ? " went to sleep" : " went dead") + " holding " +
+                    std::to_string(ait->second.size()) + " chunk(s)");
+            m_overloaded.erase(nodeId);
+            m_idleSinceMs.erase(nodeId);
+            m_sleepSentMs.erase(nodeId);
+            break;
+        }
+
+        case Event::BecameAlive:
+            if (m_wakeSentMs.erase(nodeId))
+                MonitorLog::instance().info("dispatch", "Worker " + nodeId + " is awake");
+            break;
+
+        case Event::TagsChanged:
+            MonitorLog::instance().info("dispatch", "Worker " + nodeId + " tags changed");
+            break;
+
+        default:
+            break;
+    }
+}
+
+double DispatchManager::nodeSpeed(const std::string& nodeId, const std::string& templateId) const
+{
+    double speed = m_estimates ? m_estimates->speed(nodeId, templateId) : 0.0;
+    return speed > 0.0 ? speed : 1.0;
+}
+
+bool DispatchManager::hasOSCmd(const JobManifest& manifest, const std::string& nodeOS) const
+{
+    auto it = manifest.cmd.find(nodeOS);
+    return it != manifest.cmd.end() && !it->second.empty();
+}
+
+bool DispatchManager::hasRequiredTags(const std::vector<std::string>& required,
+                                      const std::vector<std::string>& nodeTags) const
+{
+    for (const auto& req : required)
+    {
+        bool found = false;
+        for (const auto& tag : nodeTags)
+        {
+            if (tag == req) { found = true; break; }
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+bool DispatchManager::meetsRequirements(const ResourceRequirements& req, const NodeInfo& node,
+                                        bool idle) const
+{
+    if (!req.any())
+        return true;
+    const auto& hb = node.heartbeat;
+    uint64_t minRamMB = uint64_t(req.min_ram_gb) * 1024;
+    uint64_t minVramMB = uint64_t(req.min_vram_gb) * 1024;
+
+    if (req.min_ram_gb > 0 && hb.ram_gb < uint64_t(req.min_ram_gb))
+        return false;
+    if (req.min_vram_gb > 0 && hb.load.vram_total_mb < minVramMB)
+        return false;
+
+    // With nothing of ours running, whatever is in use belongs to someone else
+    // and won't be freed for the render
+    if (idle)
+    {
+        if (req.min_ram_gb > 0 && hb.load.ram_free_mb > 0 && hb.load.ram_free_mb < minRamMB)
+            return false;
+        if (req.min_vram_gb > 0 && hb.load.vram_free_mb > 0 && hb.load.vram_free_mb < minVramMB)
+            return false;
+    }
+    return true;
+}
+
+bool DispatchManager::isOverloaded(const NodeInfo& node) const
+{
+    const auto& load = node.heartbeat.load;
+    return load.cpu_pct >= OVERLOAD_CPU_PCT ||
+           (load.ram_free_mb > 0 && load.ram_free_mb < OVERLOAD_RAM_FREE_MB);
+}
+
+void DispatchManager::removeAssignment(const std::string& nodeId, const std::string& jobId,
+                                       const ChunkRange& chunk)
+{
+    auto nit = m_assignments.find(nodeId);
+    if (nit == m_assignments.end()) return;
+
+    auto& queue = nit->second;
+    for (auto ait = queue.begin(); ait != queue.end(); ++ait)
+    {
+        if (ait->jobId != jobId || !(ait->chunk == chunk))
+            continue;
+
+        eraseAssignment(nodeId, queue, ait);
+        if (queue.empty())
+            m_assignments.erase(nit);
+        return;
+    }
+}
+
+std::deque<DispatchManager::Assignment>::iterator
+DispatchManager::eraseAssignment(const std::string& nodeId, std::deque<Assignment>& queue,
+                                 std::deque<Assignment>::iterator it)
+{
+    size_t slots = slotsFor(nodeId);
+    size_t index = (size_t)(it - queue.begin());
+    it = queue.erase(it);
+    // The first prefetched chunk moved into the freed slot and starts now
+    if (index < slots && queue.size() >= slots)
+        queue[slots - 1].assignedAtMs = nowMs();
+    return it;
+}
+
+size_t DispatchManager::slotsFor(const std::string& nodeId) const
+{
+    if (const auto* node = m_nodes.find(nodeId))
+        return (size_t)(std::max)(1, node->heartbeat.render_slots);
+    auto it = m_nodeSlots.find(nodeId);
+    return it != m_nodeSlots.end() ? it->second : 1;
+}
+
+void DispatchManager::initDispatchTable(const std::string& jobId, const JobManifest& manifest)
+{
+    // Adaptive jobs start as one pending range; adaptChunk() carves it up on assignment
+    bool adaptive = manifest.target_chunk_seconds.has_value() && manifest.target_chunk_seconds.value() > 0;
+    int span = manifest.frame_end - manifest.frame_start + 1;
+    auto chunks = computeChunks(manifest.frame_start, manifest.frame_end,
+                                adaptive ? span : manifest.chunk_size);
+
+    DispatchTable dt;
+    dt.coordinator_id = m_nodeId;
+    dt.updated_at_ms = nowMs();
+    dt.chunks.reserve(chunks.size());
+
+    for (const auto& cr : chunks)
+    {
+        DispatchChunk dc;
+        dc.frame_start = cr.frame_start;
+        dc.frame_end = cr.frame_end;
+        dt.chunks.push_back(dc);
+    }
+
+    m_dispatchTables[jobId] = std::move(dt);
+    buildChunkIndex(jobId, manifest.max_retries);
+    initAdaptive(jobId, manifest);
+    markDirty(jobId);
+
+    MonitorLog::instance().info("dispatch", "Init dispatch table: job=" + jobId +
+        " chunks=" + std::to_string(chunks.size()));
+}
+
+void DispatchManager::markDirty(const std::string& jobId)
+{
+    m_dirtyTables.insert(jobId);
+    m_tableRevisions[jobId] = ++m_tablesVersion;
+}
+
+// ─── Chunk index ────────────────────────────────────────────────────────────
+
+void DispatchManager::buildChunkIndex(const std::string& jobId, int maxRetries)
+{
+    const auto& dt = m_dispatchTables[jobId];
+
+    ChunkIndex idx;
+    idx.maxRetries = maxRetries;
+    idx.byFrameStart.reserve(dt.chunks.size());
+
+    // Unwritten changes survive a rebuild (adaptive split/merge)
+    auto old = m_chunkIndex.find(jobId);
+    if (old != m_chunkIndex.end())
+        idx.dirtyStarts = std::move(old->second.dirtyStarts);
+
+    for (size_t i = 0; i < dt.chunks.size(); ++i)
+    {
+        const auto& chunk = dt.chunks[i];
+        idx.byFrameStart[chunk.frame_start] = i;
+        idx.frames[size_t(chunk.state)] += chunk.frame_end - chunk.frame_start + 1;
+        switch (chunk.state)
+        {
+            case DispatchState::Pending:   idx.pending.insert(i); break;
+            case DispatchState::Assigned:  idx.assigned.insert(i); break;
+            case DispatchState::Completed: ++idx.completed; break;
+            case DispatchState::Failed:    break;
+        }
+    }
+
+    m_chunkIndex[jobId] = std::move(idx);
+}
+
+int DispatchManager::findChunk(const std::string& jobId, int frameStart, int frameEnd) const
+{
+    auto iit = m_chunkIndex.find(jobId);
+    if (iit == m_chunkIndex.end()) return -1;
+
+    auto pit = iit->second.byFrameStart.find(frameStart);
+    if (pit == iit->second.byFrameStart.end()) return -1;
+
+    const auto& chunk = m_dispatchTables.at(jobId).chunks[pit->second];
+    if (chunk.frame_end != frameEnd) return -1;
+
+    return (int)pit->second;
+}
+
+void DispatchManager::setChunkState(DispatchTable& dt, ChunkIndex& idx,
+                                    size_t pos, DispatchState state)
+{
+    auto& chunk = dt.chunks[pos];
+    idx.dirtyStarts.insert(chunk.frame_start);
+    if (chunk.state == state)
+        return;
+
+    switch (chunk.state)
+    {
+        case DispatchState::Pending:   idx.pending.erase(pos); break;
+        case DispatchState::Assigned:  idx.assigned.erase(pos); break;
+        case DispatchState::Completed: --idx.completed; break;
+        case DispatchState::Failed:    break;
+    }
+
+    switch (state)
+    {
+        case DispatchState::Pending:   idx.pending.insert(pos); break;
+        case DispatchState::Assigned:  idx.assigned.insert(pos); break;
+        case DispatchState::Completed: ++idx.completed; break;
+        case DispatchState::Failed:    break;
+    }
+
+    int count = chunk.frame_end - chunk.frame_start + 1;
+    idx.frames[size_t(chunk.state)] -= count;
+    idx.frames[size_t(state)] += count;
+    chunk.state = state;
+}
+
+void DispatchManager::failChunk(DispatchTable& dt, ChunkIndex& idx, size_t pos)
+{
+    auto& chunk = dt.chunks[pos];
+    chunk.retry_count++;
+    setChunkState(dt, idx, pos,
+        (chunk.retry_count >= idx.maxRetries) ? DispatchState::Failed : DispatchState::Pending);
+    chunk.assigned_to.clear();
+    chunk.assigned_at_ms = 0;
+}
+
+bool DispatchManager::salvageChunk(const std::string& jobId, size_t pos,
+                                   const std::set<int>& framesDone, const std::string& nodeId,
+                                   bool countRetry)
+{
+    auto& chunks = m_dispatchTables[jobId].chunks;
+    const DispatchChunk failed = chunks[pos];
+    auto first = framesDone.lower_bound(failed.frame_start);
+    auto last = framesDone.upper_bound(failed.frame_end);
+    if (first == last)
+        return false;
+
+    // Alternating runs of finished / unfinished frames, in frame order
+    int maxRetries = m_chunkIndex[jobId].maxRetries;
+    int retries = failed.retry_count + (countRetry ? 1 : 0);
+    int64_t now = nowMs();
+    std::vector<DispatchChunk> pieces;
+    int salvaged = 0;
+    for (int f = failed.frame_start; f <= failed.frame_end; )
+    {
+        bool done = framesDone.count(f) > 0;
+        DispatchChunk piece;
+        piece.frame_start = f;
+        while (f <= failed.frame_end && (framesDone.count(f) > 0) == done)
+            ++f;
+        piece.frame_end = f - 1;
+        if (done)
+        {
+            piece.state = DispatchState::Completed;
+            piece.assigned_to = nodeId;
+            piece.assigned_at_ms = failed.assigned_at_ms;
+            piece.completed_at_ms = now;
+            piece.retry_count = failed.retry_count;
+            salvaged += piece.frame_end - piece.frame_start + 1;
+        }
+        else
+        {
+            piece.state = (countRetry && retries >= maxRetries) ? DispatchState::Failed : DispatchState::Pending;
+            piece.retry_count = retries;
+        }
+        pieces.push_back(piece);
+    }
+
+    chunks.erase(chunks.begin() + pos);
+    chunks.insert(chunks.begin() + pos, pieces.begin(), pieces.end());
+
+    // Positions shifted; every piece needs a journal record
+    buildChunkIndex(jobId, maxRetries);
+    for (const auto& piece : pieces)
+        m_chunkIndex[jobId].dirtyStarts.insert(piece.frame_start);
+
+    int total = failed.frame_end - failed.frame_start + 1;
+    MonitorLog::instance().info("dispatch", "Salvaged " + std::to_string(salvaged) + "/" +
+        std::to_string(total) + " frame(s) of chunk " + ChunkRange{failed.frame_start, failed.frame_end}.rangeStr() +
+        " for job " + jobId + ", requeueing the rest");
+    return true;
+}
+
+std::set<int> DispatchManager::finishedFramesFromEvents(const std::string& jobId, const std::string& nodeId,
+                                                       const DispatchChunk& chunk) const
+{
+    std::set<int> frames;
+    auto dir = m_farmPath / "jobs" / jobId / "events" / nodeId;
+    if (!EventLogReader::exists(dir))
+        return frames;
+
+    // Only this attempt's frames; staged ones never reached the share
+    EventLogCursor cursor;
+    EventLogReader::readSince(dir, cursor, [&](const nlohmann::json& e) {
+        if (e.value("type", "") != "frame_finished" || e.value("staged", false))
+            return;
+        if (e.value("timestamp_ms", int64_t(0)) < chunk.assigned_at_ms)
+            return;
+        int frame = e.value("frame_start", chunk.frame_start - 1);
+        if (frame >= chunk.frame_start && frame <= chunk.frame_end)
+            frames.insert(frame);
+    });
+    return frames;
+}
+
+void DispatchManager::releaseChunk(DispatchTable& dt, ChunkIndex& idx, size_t pos)
+{
+    auto& chunk = dt.chunks[pos];
+    setChunkState(dt, idx, pos, DispatchState::Pending);
+    chunk.assigned_to.clear();
+    chunk.assigned_at_ms = 0;
+}
+
+int64_t DispatchManager::nowMs() const
+{
+    if (m_clockFn)
+        return m_clockFn();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void DispatchManager::refreshJobViews()
+{
+    m_jobsVersion = m_jobs->version;
+
+    // JobManager already orders by priority desc, then submission time
+    m_activeJobs.clear();
+    m_handoffJobs.clear();
+    for (const auto& job : m_jobs->jobs)
+    {
+        if (job.current_state != "active")
+            continue;
+        const auto& jobId = job.manifest.job_id;
+        if (!ownsJob(jobId))
+            continue;
+
+        // Ensure dispatch tables exist for all active jobs. A shard picks up
+        // a job it gained from the job's journal, once the previous owner has
+        // had HANDOFF_MS to write it out.
+        if (m_dispatchTables.find(jobId) == m_dispatchTables.end())
+        {
+            bool recovered = false;
+            if (m_shardMode)
+            {
+                if (nowMs() < m_handoffUntilMs)
+                {
+                    m_handoffJobs.insert(jobId);
+                    continue;
+                }
+                recovered = recoverJob(job);
+            }
+            if (!recovered)
+                initDispatchTable(jobId, job.manifest);
+        }
+
+        m_activeJobs.push_back(&job);
+        m_lastServedMs.emplace(jobId, nowMs());   // waiting clock starts on activation
+    }
+}
+
+// ─── Sharded coordination ───────────────────────────────────────────────────
+
+bool DispatchManager::ownsJob(const std::string& jobId) const
+{
+    return !m_shardMode || m_shards.ownerOf(jobId) == m_nodeId;
+}
+
+bool DispatchManager::dispatchesTo(const Heartbeat& hb) const
+{
+    return !m_shardMode || m_shards.dispatcherFor(hb) == m_nodeId;
+}
+
+void DispatchManager::refreshShards()
+{
+    // Unreadable (mid-sync, say): keep the membership we have
+    auto shards = CoordinatorShards::peek(m_farmPath);
+    if (!shards || (m_shardsLoaded && shards->epoch == m_shards.epoch))
+        return;
+
+    m_shards = std::move(*shards);
+    m_shardsLoaded = true;
+    m_handoffUntilMs = nowMs() + HANDOFF_MS;
+    m_jobsVersion = 0;      // re-derive the owned jobs next cycle
+
+    // Still a member: our final write is what the new owner loads. Dropped
+    // while unreachable: the new owner may already be writing, leave it be.
+    bool member = m_shards.contains(m_nodeId);
+    std::vector<std::string> moved;
+    for (const auto& [jobId, dt] : m_dispatchTables)
+    {
+        if (!ownsJob(jobId))
+            moved.push_back(jobId);
+    }
+    for (const auto& jobId : moved)
+        releaseTable(jobId, member);
+
+    MonitorLog::instance().info("dispatch", "Shard membership epoch " + std::to_string(m_shards.epoch) +
+        ": " + std::to_string(m_shards.members.size()) + " member(s)" +
+        (member ? "" : ", this node not among them") +
+        (moved.empty() ? "" : ", " + std::to_string(moved.size()) + " job(s) handed off"));
+}
+
+void DispatchManager::releaseTable(const std::string& jobId, bool flush)
+{
+    if (flush && !flushTable(jobId, true))
+        MonitorLog::instance().warn("dispatch", "Could not write " + jobId +
+            " before handing it off; its new owner replays the journal as it stands");
+
+    // Workers keep rendering what they hold; the new owner rebuilds the
+    // assignments from the table, and their reports are routed to it
+    for (auto nit = m_assignments.begin(); nit != m_assignments.end(); )
+    {
+        auto& queue = nit->second;
+        for (auto ait = queue.begin(); ait != queue.end(); )
+        {
+            if (ait->jobId == jobId)
+                ait = eraseAssignment(nit->first, queue, ait);
+            else
+                ++ait;
+        }
+        if (queue.empty())
+            nit = m_assignments.erase(nit);
+        else
+            ++nit;
+    }
+
+    m_dispatchTables.erase(jobId);
+    m_chunkIndex.erase(jobId);
+    m_journal.erase(jobId);
+    m_adaptive.erase(jobId);
+    m_dirtyTables.erase(jobId);
+    m_handoffJobs.erase(jobId);
+    m_tableRevisions[jobId] = ++m_tablesVersion;    // reported as released
+}
+
+// ─── Adaptive chunk sizing ──────────────────────────────────────────────────
+
+void DispatchManager::initAdaptive(const std::string& jobId, const JobManifest& manifest)
+{
+    if (!manifest.target_chunk_seconds.has_value() || manifest.target_chunk_seconds.value() <= 0)
+    {
+        m_adaptive.erase(jobId);
+        return;
+    }
+
+    AdaptiveState st;
+    st.targetMs = int64_t(manifest.target_chunk_seconds.value()) * 1000;
+    st.initialSize = (std::max)(1, manifest.chunk_size);
+
+    // Keep chunks well inside the per-chunk timeout
+    if (manifest.timeout_seconds.has_value() && manifest.timeout_seconds.value() > 0)
+        st.targetMs = (std::min)(st.targetMs, int64_t(manifest.timeout_seconds.value()) * 500);
+
+    // Seed the estimate from chunks already completed (recovered tables)
+    for (const auto& chunk : m_dispatchTables[jobId].chunks)
+    {
+        if (chunk.state != DispatchState::Completed || chunk.assigned_at_ms <= 0 ||
+            chunk.completed_at_ms <= chunk.assigned_at_ms)
+            continue;
+        double perFrame = double(chunk.completed_at_ms - chunk.assigned_at_ms) /
+                          double(chunk.frame_end - chunk.frame_start + 1);
+        st.msPerFrame = (st.msPerFrame <= 0.0) ? perFrame
+            : st.msPerFrame + FRAME_TIME_ALPHA * (perFrame - st.msPerFrame);
+    }
+
+    m_adaptive[jobId] = st;
+}
+
+void DispatchManager::recordChunkTime(const std::string& jobId, const std::string& nodeId,
+                                      const DispatchChunk& chunk)
+{
+    // Prefer the time the chunk became one of the node's active ones — with
+    // prefetch, assigned_at_ms includes time spent waiting in the worker's queue
+    int64_t startMs = chunk.assigned_at_ms;
+    auto nit = m_assignments.find(nodeId);
+    if (nit != m_assignments.end())
+    {
+        const auto& queue = nit->second;
+        size_t active = (std::min)(queue.size(), slotsFor(nodeId));
+        for (size_t i = 0; i < active; ++i)
+        {
+            if (queue[i].jobId == jobId && queue[i].chunk.frame_start == chunk.frame_start &&
+                queue[i].chunk.frame_end == chunk.frame_end)
+            {
+                startMs = queue[i].assignedAtMs;
+                break;
+            }
+        }
+    }
+    if (startMs <= 0 || chunk.completed_at_ms <= startMs) return;
+
+    double perFrame = double(chunk.completed_at_ms - startMs) /
+                      double(chunk.frame_end - chunk.frame_start + 1);
+
+    // Recent samples feed straggler detection for every job
+    auto& samples = m_frameTimes[jobId];
+    samples.push_back(perFrame);
+    if (samples.size() > FRAME_TIME_SAMPLES)
+        samples.pop_front();
+
+    auto ait = m_adaptive.find(jobId);
+    if (ait == m_adaptive.end()) return;
+
+    auto& st = ait->second;
+    st.msPerFrame = (st.msPerFrame <= 0.0) ? perFrame
+        : st.msPerFrame + FRAME_TIME_ALPHA * (perFrame - st.msPerFrame);
+}
+
+size_t DispatchManager::adaptChunk(const std::string& jobId, size_t pos)
+{
+    const auto& st = m_adaptive[jobId];
+    auto& chunks = m_dispatchTables[jobId].chunks;
+
+    // Retried chunks keep their range so retry_count stays meaningful
+    if (chunks[pos].retry_count > 0)
+        return pos;
+
+    int want = st.initialSize;
+    if (st.msPerFrame > 0.0)
+        want = (int)std::lround(double(st.targetMs) / st.msPerFrame);
+    want = std::clamp(want, 1, MAX_ADAPTIVE_CHUNK);
+
+    bool changed = false;
+    size_t oldSize = chunks.size();
+    std::vector<int> staleStarts;   // frame_starts that no longer begin a chunk
+    int len = chunks[pos].frame_end - chunks[pos].frame_start + 1;
+
+    if (len > want)
+    {
+        // Split: assign the head, leave the remainder pending right behind it
+        DispatchChunk rest;
+        rest.frame_start = chunks[pos].frame_start + want;
+        rest.frame_end = chunks[pos].frame_end;
+        chunks[pos].frame_end = rest.frame_start - 1;
+        chunks.insert(chunks.begin() + pos + 1, rest);
+        changed = true;
+    }
+    else if (len < want && st.msPerFrame > 0.0)
+    {
+        // Merge following untouched pending ranges until we reach the target
+        while (len < want && pos + 1 < chunks.size())
+        {
+            auto& next = chunks[pos + 1];
+            if (next.state != DispatchState::Pending || next.retry_count > 0 ||
+                next.frame_start != chunks[pos].frame_end + 1)
+                break;
+
+            int nextLen = next.frame_end - next.frame_start + 1;
+            int take = (std::min)(nextLen, want - len);
+            chunks[pos].frame_end += take;
+            len += take;
+            changed = true;
+
+            staleStarts.push_back(next.frame_start);
+            if (take == nextLen)
+                chunks.erase(chunks.begin() + pos + 1);
+            else
+                next.frame_start += take;
+        }
+    }
+
+    if (changed)
+    {
+        // Patch the index instead of rebuilding it: only positions after pos
+        // moved, by one per split or minus the merged-away chunks. Frame
+        // counts per state don't change, everything involved is pending.
+        auto& idx = m_chunkIndex[jobId];
+        ptrdiff_t delta = ptrdiff_t(chunks.size()) - ptrdiff_t(oldSize);
+        size_t removed = delta < 0 ? size_t(-delta) : 0;
+        for (auto* positions : {&idx.pending, &idx.assigned})
+        {
+            auto first = positions->upper_bound(pos);
+            std::vector<size_t> tail(first, positions->end());
+            positions->erase(first, positions->end());
+            for (size_t p : tail)
+            {
+                if (p > pos + removed)
+                    positions->insert(positions->end(), size_t(ptrdiff_t(p) + delta));
+            }
+        }
+        if (delta > 0)
+            idx.pending.insert(pos + 1);
+
+        for (int start : staleStarts)
+            idx.byFrameStart.erase(start);
+        for (size_t i = pos + 1; i < chunks.size(); ++i)
+            idx.byFrameStart[chunks[i].frame_start] = i;
+
+        // Both the resized chunk and what now follows it need journal records
+        idx.dirtyStarts.insert(chunks[pos].frame_start);
+        if (pos + 1 < chunks.size())
+            idx.dirtyStarts.insert(chunks[pos + 1].frame_start);
+    }
+
+    return pos;
+}
+
+// ─── Recovery ───────────────────────────────────────────────────────────────
+
+void DispatchManager::recoverFromDisk(const std::vector<JobInfo>& jobs)
+{
+    for (const auto& job : jobs)
+    {
+        if (job.current_state == "active")
+            recoverJob(job);
+    }
+    m_seedTables.clear();
+}
+
+bool DispatchManager::recoverJob(const JobInfo& job)
+{
+    const auto& jobId = job.manifest.job_id;
+    auto jobDir = m_farmPath / "jobs" / jobId;
+    auto seeded = m_seedTables.find(jobId);
+
+    auto snapshot = FarmStorage::current().stat(jobDir / "dispatch.json");
+    if (seeded == m_seedTables.end() && (!snapshot.exists || snapshot.isDir))
+        return false;
+
+    try
+    {
+        // A mirrored table is at least as new as the files (the old
+        // coordinator's writes are throttled); otherwise snapshot + journal
+        // replay. Either way the first write after recovery compacts.
+        DispatchTable dt;
+        if (seeded != m_seedTables.end())
+        {
+            dt = std::move(seeded->second);
+        }
+        else
+        {
+            auto loaded = DispatchJournal::load(jobDir);
+            if (!loaded.has_value())
+                return false;
+            dt = std::move(loaded.value());
+        }
+
+        // Mark "assigned" chunks to dead nodes as "pending",
+        // and rebuild m_assignments for chunks that remain assigned
+        for (auto& chunk : dt.chunks)
+        {
+            if (chunk.state == DispatchState::Assigned)
+            {
+                if (chunk.assigned_to.empty() || isNodeDead(chunk.assigned_to))
+                {
+                    chunk.state = DispatchState::Pending;
+                    chunk.assigned_to.clear();
+                    chunk.assigned_at_ms = 0;
+                }
+                else
+                {
+                    // Rebuild in-memory assignment tracking so detectDeadWorkers
+                    // and stale-assignment timeout can monitor this assignment
+                    ChunkRange cr;
+                    cr.frame_start = chunk.frame_start;
+                    cr.frame_end = chunk.frame_end;
+                    m_assignments[chunk.assigned_to].push_back({jobId, cr, chunk.assigned_at_ms});
+                }
+            }
+        }
+        adoptReportedChunks(jobId, dt, m_nodes.nodes());
+
+        m_dispatchTables[jobId] = std::move(dt);
+        buildChunkIndex(jobId, job.manifest.max_retries);
+        initAdaptive(jobId, job.manifest);
+        markDirty(jobId);
+
+        MonitorLog::instance().info("dispatch", std::string("Recovered dispatch table") +
+            (seeded != m_seedTables.end() ? " (mirrored): " : ": ") + jobId);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        MonitorLog::instance().error("dispatch", "Failed to recover dispatch table for " +
+            jobId + ": " + std::string(e.what()));
+    }
+    return false;
+}
+
+void DispatchManager::adoptReportedChunks(const std::string& jobId, DispatchTable& dt,
+                                          const std::vector<NodeInfo>& nodes)
+{
+    // An assignment the old coordinator made after its last write (or delta)
+    // still shows up in the worker's heartbeat: "f1-10, f11-20". Labels don't
+    // say which job a range belongs to, so only single-job nodes are matched.
+    for (const auto& node : nodes)
+    {
+        const auto& hb = node.heartbeat;
+        if (node.isDead || hb.render_state != "rendering" || hb.active_job != jobId)
+            continue;
+        if (hb.active_jobs.size() > 1)
+            continue;
+
+        size_t pos = 0;
+        while (pos < hb.active_frames.size())
+        {
+            size_t end = hb.active_frames.find(',', pos);
+            if (end == std::string::npos)
+                end = hb.active_frames.size();
+            std::string label = hb.active_frames.substr(pos, end - pos);
+            pos = end + 1;
+
+            label.erase(0, label.find_first_not_of(" f"));
+            int first = 0, last = 0;
+            try
+            {
+                size_t dash = label.find('-');
+                first = std::stoi(label.substr(0, dash));
+                last = (dash == std::string::npos) ? first : std::stoi(label.substr(dash + 1));
+            }
+            catch (...)
+            {
+                continue;
+            }
+
+            for (auto& chunk : dt.chunks)
+            {
+                if (chunk.frame_start != first || chunk.frame_end != last)
+                    continue;
+                if (chunk.state == DispatchState::Pending)
+                {
+                    chunk.state = DispatchState::Assigned;
+                    chunk.assigned_to = hb.node_id;
+                    chunk.assigned_at_ms = nowMs();
+                    m_assignments[hb.node_id].push_back({jobId, ChunkRange{first, last}, chunk.assigned_at_ms});
+                    MonitorLog::instance().info("dispatch", "Adopted in-flight chunk " + jobId + " f" +
+                        std::to_string(first) + "-" + std::to_string(last) + " on " + hb.node_id);
+                }
+                break;
+            }
+        }
+    }
+}
+
+bool DispatchManager::checkLease()
+{
+    if (m_fenced)
+        return false;
+    if (m_epoch == 0 && !m_shardMode)
+        return true;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_lastLeaseCheck < std::chrono::milliseconds(LEASE_CHECK_MS))
+        return !m_shardMode || m_shardsLoaded;
+    m_lastLeaseCheck = now;
+
+    // Shards aren't fenced by coordinator.json: the membership decides what each owns
+    if (m_shardMode)
+    {
+        refreshShards();
+        return m_shardsLoaded;
+    }
+
+    auto lease = CoordinatorLease::peek(m_farmPath);
+    if (!lease || !CoordinatorLease::outranks(lease->epoch, lease->node_id, m_epoch, m_nodeId))
+        return true;
+
+    m_fenced = true;
+    m_dirtyTables.clear();
+    m_localDispatches.clear();
+    MonitorLog::instance().error("dispatch", "Superseded by " + lease->node_id + " (epoch " +
+        std::to_string(lease->epoch) + " > " + std::to_string(m_epoch) + "), dispatch stopped");
+    return false;
 }
 
 } // namespace SR
@@ -2,43 +2,93 @@
 
 #include "core/job_types.h"
 #include "core/heartbeat.h"
+#include "core/node_registry.h"
 #include "core/config.h"
+#include "core/coordinator_shards.h"
+#include "core/render_metrics.h"
 #include "monitor/command_manager.h"
+#include "monitor/job_manager.h"
+#include "monitor/output_verifier.h"
 
+#include <array>
 #include <filesystem>
 #include <vector>
 #include <string>
 #include <map>
+#include <optional>
 #include <set>
+#include <unordered_map>
 #include <queue>
+#include <deque>
 #include <functional>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 namespace SR {
 
+// Coordinator dispatch loop. Runs on its own thread, woken by worker reports,
+// local completions, job/node changes and a slow fallback timer. Public
+// methods are thread-safe; all dispatch state is guarded by m_mutex.
 class DispatchManager
 {
 public:
     DispatchManager() = default;
+    DispatchManager(const DispatchManager&) = delete;
+    DispatchManager& operator=(const DispatchManager&) = delete;
 
     void start(const std::filesystem::path& farmPath,
                const std::string& nodeId,
                const std::string& nodeOS,
                const TimingConfig& timing,
                const std::vector<std::string>& tags,
-               std::function<std::vector<NodeInfo>()> nodeSnapshotFn,
-               std::function<std::vector<JobInfo>()> jobSnapshotFn);
+               std::function<NodeSnapshotPtr()> nodeSnapshotFn,
+               std::function<JobSnapshotPtr()> jobSnapshotFn);
     void stop();
 
-    // Main-thread dispatch cycle — called from MonitorApp::update()
-    void update();
+    // Run a dispatch cycle soon (UDP heartbeat flipped a node idle, job list changed)
+    void wake();
+
+    // Main thread: hand queued self-dispatches to the local RenderCoordinator
+    void drainLocalDispatches();
+
+    // Simulator hooks (call before start()): a virtual clock for every timestamp
+    // and timeout, and unthreaded mode where the caller drives cycles via tick()
+    void setClock(std::function<int64_t()> clockFn);
+    void setThreaded(bool threaded);
+    void tick();
+
+    // Standby takeover (call before start()): tables mirrored from the old
+    // coordinator's replica stream, used instead of disk for those jobs
+    void seedTables(std::map<std::string, DispatchTable> tables);
+
+    // Fencing (call before start()): the epoch this coordinator claimed in
+    // coordinator.json, 0 = unfenced. Once a newer claim shows up, cycles and
+    // table writes stop; fence() does the same on the caller's word.
+    void setEpoch(uint64_t epoch);
+    void fence();
+    bool isFenced() const { return m_fenced.load(); }
+
+    // Sharded mode (call before start()): this coordinator is one member of
+    // coordinators.json and dispatches only the jobs and workers the
+    // membership gives it (see CoordinatorShards). Jobs moving away are
+    // written out and dropped; jobs moving in are read from their journal
+    // once HANDOFF_MS has given the previous owner time for its last write.
+    void setShardMode(bool enabled);
+
+    // Pending chunks of the jobs this coordinator dispatches, as of the last
+    // cycle (a shard advertises it so other shards' idle workers can be lent)
+    size_t pendingChunks() const { return m_pendingChunks.load(); }
 
     // Route worker reports (chunk_completed, chunk_failed) from CommandManager
     void processAction(const CommandManager::Action& action);
 
-    // Queue local completion from own RenderCoordinator
+    // Queue local completion from own RenderCoordinator (framesDone: see
+    // RenderCoordinator::CompletionCallback)
     void queueLocalCompletion(const std::string& jobId, const ChunkRange& chunk,
-                              const std::string& state);
+                              const std::string& state, const std::string& framesDone = {});
 
     // Handle job state changes (pause/cancel/resume) from job controls
     void handleJobStateChange(const std::string& jobId, const std::string& newState);
@@ -47,50 +97,185 @@ public:
     void reassignChunk(const std::string& jobId, int frameStart, int frameEnd);
     void retryFailedChunk(const std::string& jobId, int frameStart, int frameEnd);
 
-    // Set callback for dispatching to local RenderCoordinator
-    using DispatchCallback = std::function<void(const JobManifest&, const ChunkRange&)>;
+    // Set callback for dispatching to local RenderCoordinator (invoked from drainLocalDispatches).
+    // traceId names the assignment in chunk traces (ChunkTrace).
+    using DispatchCallback = std::function<void(const JobManifest&, const ChunkRange&,
+                                                const std::string& traceId)>;
     void setLocalDispatchCallback(DispatchCallback fn);
 
-    // Set callback for sending commands to workers
+    // Set callback for sending commands to workers (traceId: assign_chunk only)
     using CommandSenderFn = std::function<void(const std::string& target,
                                                const std::string& type,
                                                const std::string& jobId,
                                                const std::string& reason,
-                                               int frameStart, int frameEnd)>;
+                                               int frameStart, int frameEnd,
+                                               const std::string& traceId)>;
     void setCommandSender(CommandSenderFn fn);
 
+    // Optional: called once commands for a batch of decisions are out (end of a
+    // cycle, job state change, manual reassign), so the sender can coalesce them
+    void setCommandFlush(std::function<void()> fn);
+
+    // Optional: the farm's measured render speeds, grabbed once per cycle.
+    // Faster nodes pick first; stragglers are judged against their own node's pace.
+    void setRenderEstimates(std::function<RenderEstimatesPtr()> fn);
+
     // Live config updates
     void updateTiming(const TimingConfig& timing);
     void updateTags(const std::vector<std::string>& tags);
     void setNodeActive(bool active);
+    void setPrefetchDepth(int depth);
+    void setSchedulingPolicy(SchedulingPolicy policy);
+    void setJobAffinity(bool enabled);
+    void setPreemption(const PreemptionPolicy& policy);
+
+    // Power management (see PowerPolicy). The wake sender broadcasts a magic
+    // packet (sendWakeOnLan); it runs on the dispatch thread.
+    void setPowerPolicy(const PowerPolicy& policy);
+    using WakeSenderFn = std::function<bool(const std::string& mac, const std::string& broadcast)>;
+    void setWakeSender(WakeSenderFn fn);
 
     bool isRunning() const { return m_running; }
 
-    // Main-thread accessor for in-memory dispatch tables (coordinator only).
-    // Safe to call from main thread only; MonitorApp copies data for UIDataCache.
-    const std::map<std::string, DispatchTable>& getDispatchTables() const { return m_dispatchTables; }
+    // Copy of the in-memory dispatch tables (coordinator only).
+    // tablesVersion() changes whenever a table does, so callers can skip unchanged copies.
+    std::map<std::string, DispatchTable> getDispatchTables() const;
+    uint64_t tablesVersion() const { return m_tablesVersion.load(); }
+
+    // Frame counts of one table, kept up to date at every chunk state change
+    struct TableProgress
+    {
+        int total = 0, completed = 0, rendering = 0, failed = 0;
+        int renderingChunks = 0;
+    };
+
+    // Tables changed since `since` (0 = all of them), for UIDataCache and the
+    // replica stream. Pass `version` back next time; unchanged tables aren't copied.
+    struct TableChanges
+    {
+        uint64_t version = 0;
+        std::map<std::string, DispatchTable> tables;
+        std::map<std::string, TableProgress> progress;  // same keys as tables
+        std::vector<std::string> released;              // handed to another shard
+    };
+    TableChanges getChangedTables(uint64_t since) const;
 
 private:
+    void threadFunc();
+    // Table writes the cycle left are done (with the command flush) after
+    // unlocking, so UI and report threads never wait on the share
+    void runCycleAndFlush(std::unique_lock<std::mutex>& lock);
+    struct TableWrite;
+    std::vector<TableWrite> runCycle();
+
     // Dispatch cycle steps
     void processLocalCompletions();
     void processWorkerReports();
     void detectDeadWorkers();
+    void processVerifyResults();
     void checkJobCompletions();
+    void preemptLowerPriority();
     void assignWork();
-    void writeDispatchTables();
+    void speculateStragglers();
+    void managePower();
+    std::vector<TableWrite> takeTableWrites();      // dirty tables, throttled
+    void finishTableWrites(const std::vector<TableWrite>& writes);
+    bool flushTable(const std::string& jobId, bool compact);   // journal append or snapshot, in place
+
+    // A journal append or snapshot split in three: prepared and finished
+    // under m_mutex, written without it
+    std::optional<TableWrite> prepareTableWrite(const std::string& jobId, bool compact);
+    static bool performTableWrite(TableWrite& write);
+    void finishTableWrite(const TableWrite& write);
 
     // Helpers
-    bool isNodeIdle(const std::string& nodeId, const std::vector<NodeInfo>& nodes) const;
-    bool isNodeDead(const std::string& nodeId, const std::vector<NodeInfo>& nodes) const;
+    void refreshNodes();    // m_nodes from the current snapshot, once per cycle
+    void onNodeEvent(NodeRegistry::Event event, const std::string& nodeId, const NodeInfo& node);
+    bool isNodeIdle(const std::string& nodeId) const { return m_nodes.isIdle(nodeId); }
+    bool isNodeDead(const std::string& nodeId) const { return m_nodes.isDead(nodeId); }
+    // Relative render speed from the estimates (1.0 = farm median, also when unknown)
+    double nodeSpeed(const std::string& nodeId, const std::string& templateId) const;
     bool hasOSCmd(const JobManifest& manifest, const std::string& nodeOS) const;
     bool hasRequiredTags(const std::vector<std::string>& required,
                          const std::vector<std::string>& nodeTags) const;
+    bool meetsRequirements(const ResourceRequirements& req, const NodeInfo& node, bool idle) const;
+    bool isOverloaded(const NodeInfo& node) const;
+    void orderJobsForWorker(std::vector<const JobInfo*>& order,
+                            const std::unordered_map<std::string, size_t>& submitterRunning) const;
+    size_t runningChunks(const std::string& jobId) const;
+    const JobInfo* warmJobFor(const std::string& nodeId,
+                              const std::vector<const JobInfo*>& order, int64_t now) const;
+    void removeAssignment(const std::string& nodeId, const std::string& jobId,
+                          const ChunkRange& chunk);
+    size_t slotsFor(const std::string& nodeId) const;  // from its last heartbeat, default 1
     void initDispatchTable(const std::string& jobId, const JobManifest& manifest);
     void markDirty(const std::string& jobId);
+
+    // Chunk index helpers — all chunk state changes go through setChunkState()
+    struct ChunkIndex;
+    void buildChunkIndex(const std::string& jobId, int maxRetries);
+    int findChunk(const std::string& jobId, int frameStart, int frameEnd) const;
+    void setChunkState(DispatchTable& dt, ChunkIndex& idx, size_t pos, DispatchState state);
+    void failChunk(DispatchTable& dt, ChunkIndex& idx, size_t pos);
+
+    // Partial salvage: split a failed chunk so its finished frames count as
+    // completed and only the unfinished sub-ranges are requeued (as one
+    // failure). False = nothing finished, caller fails the chunk as before.
+    bool salvageChunk(const std::string& jobId, size_t pos, const std::set<int>& framesDone,
+                      const std::string& nodeId, bool countRetry = true);
+    // Frames a (dead) node reported finished for a chunk, from its event log
+    std::set<int> finishedFramesFromEvents(const std::string& jobId, const std::string& nodeId,
+                                           const DispatchChunk& chunk) const;
+    void releaseChunk(DispatchTable& dt, ChunkIndex& idx, size_t pos);
+
+    // Job dependencies: the lowest pending chunk whose upstream work has
+    // completed (nullopt = none within DEPENDENCY_SCAN of the front)
+    std::optional<size_t> readyChunk(const JobInfo& job, const DispatchTable& dt, const ChunkIndex& idx);
+    // First upstream that ended cancelled or failed: {job id, state}, or nullopt
+    std::optional<std::pair<std::string, std::string>> deadUpstream(const JobInfo& job);
+    void readArchivedStates();          // m_archivedState, at most every ARCHIVE_READ_MS
+    void writeJobState(const std::string& jobId, const std::string& state);
+    // Drop the job's queued chunks everywhere (abort_chunk to each holder;
+    // ourselves too when includeSelf) and put its assigned ones back to pending
+    void dropJobAssignments(const std::string& jobId, const std::string& reason, bool includeSelf);
+    static bool framesCompleted(const DispatchTable& dt, int frameStart, int frameEnd);
+
+    // Preemption: a pending chunk could be handed out now, given a slot
+    bool hasReadyWork(const JobInfo& job);
+
+    // Output verification: false = the job has no frame pattern to check
+    const JobInfo* activeJob(const std::string& jobId) const;
+    bool verifyFrames(const JobInfo& job, const ChunkRange& range, bool jobPass);
+    void requeueBadFrames(const std::string& jobId, const ChunkRange& range, const std::set<int>& bad);
+
+    // Speculative execution — duplicates of tail stragglers; first completion wins
+    bool hasSpeculativeCopy(const std::string& jobId, const ChunkRange& chunk) const;
+    void abortDuplicates(const std::string& jobId, const ChunkRange& chunk,
+                         const std::string& keepNodeId);
+    bool promoteSpeculative(const std::string& jobId, size_t pos, const std::string& fromNodeId);
+
+    // Adaptive chunk sizing
+    void initAdaptive(const std::string& jobId, const JobManifest& manifest);
+    void recordChunkTime(const std::string& jobId, const std::string& nodeId,
+                         const DispatchChunk& chunk);
+    size_t adaptChunk(const std::string& jobId, size_t pos);
     int64_t nowMs() const;
 
     // Recovery
     void recoverFromDisk(const std::vector<JobInfo>& jobs);
+    bool recoverJob(const JobInfo& job);   // false = no table on disk
+    void adoptReportedChunks(const std::string& jobId, DispatchTable& dt,
+                             const std::vector<NodeInfo>& nodes);
+    bool checkLease();      // false once superseded
+
+    // Rebuild per-version job views (active list, missing tables)
+    void refreshJobViews();
+
+    // Sharded mode: re-read the membership, releasing jobs now owned elsewhere
+    void refreshShards();
+    void releaseTable(const std::string& jobId, bool flush);
+    bool ownsJob(const std::string& jobId) const;
+    bool dispatchesTo(const Heartbeat& hb) const;
 
     // Config
     std::filesystem::path m_farmPath;
@@ -98,37 +283,215 @@ private:
     std::string m_nodeOS;
     TimingConfig m_timing;
     std::vector<std::string> m_tags;
-    bool m_running = false;
+    std::atomic<bool> m_running{false};
     bool m_nodeActive = true;
     bool m_recovered = false;
+    int m_prefetchDepth = 1;    // chunks queued ahead of the one a node is rendering
+    SchedulingPolicy m_policy = SchedulingPolicy::Priority;
+    bool m_jobAffinity = true;
+
+    // Dispatch thread
+    std::thread m_thread;
+    mutable std::mutex m_mutex;     // held for a whole cycle and by every public entry point
+    std::condition_variable m_cv;
+    bool m_wakePending = false;
+    std::atomic<uint64_t> m_tablesVersion{0};
+    static constexpr int64_t FALLBACK_WAKE_MS = 2000;
+    bool m_threaded = true;
+    std::function<int64_t()> m_clockFn;     // empty = system clock
+
+    // Takeover and fencing
+    std::map<std::string, DispatchTable> m_seedTables;
+    uint64_t m_epoch = 0;
+    std::atomic<bool> m_fenced{false};
+    std::chrono::steady_clock::time_point m_lastLeaseCheck{};
+    static constexpr int64_t LEASE_CHECK_MS = 2000;
+
+    // Sharded mode
+    bool m_shardMode = false;
+    bool m_shardsLoaded = false;
+    CoordinatorShards m_shards;
+    int64_t m_handoffUntilMs = 0;           // jobs gained at the last membership change wait until then
+    std::set<std::string> m_handoffJobs;    // owned, waiting on that; their reports are held back
+    std::atomic<size_t> m_pendingChunks{0};
+    static constexpr int64_t HANDOFF_MS = 10000;
+
+    // Self-dispatches queued by the cycle, handed over on the main thread
+    struct LocalDispatch
+    {
+        JobManifest manifest;
+        ChunkRange chunk;
+        std::string traceId;
+    };
+    std::vector<LocalDispatch> m_localDispatches;
+
+    // Chunk trace ids, one per assignment; the span runs from the cycle's start
+    std::string newTraceId();
+    void traceAssignment(const std::string& jobId, const ChunkRange& chunk, const std::string& traceId,
+                         const std::string& nodeId, bool speculative);
+    uint64_t m_traceSeq = 0;
+    int64_t m_cycleStartUs = 0;
 
     // Callbacks
-    std::function<std::vector<NodeInfo>()> m_nodeSnapshotFn;
-    std::function<std::vector<JobInfo>()> m_jobSnapshotFn;
+    std::function<NodeSnapshotPtr()> m_nodeSnapshotFn;
+    std::function<JobSnapshotPtr()> m_jobSnapshotFn;
     DispatchCallback m_localDispatchFn;
     CommandSenderFn m_commandSenderFn;
+    std::function<void()> m_commandFlushFn;
+    std::function<RenderEstimatesPtr()> m_estimatesFn;
+    RenderEstimatesPtr m_estimates;     // this cycle's; may be null
 
-    // Current assignments: nodeId -> (jobId, chunk, timestamp)
+    // Job snapshot grabbed once per update(); views below are rebuilt only when
+    // its version changes. m_activeJobs points into m_jobs.
+    JobSnapshotPtr m_jobs;
+    uint64_t m_jobsVersion = 0;
+    std::vector<const JobInfo*> m_activeJobs;   // priority desc, FIFO within priority
+
+    // Current assignments: nodeId -> queue of (jobId, chunk, timestamp).
+    // The first slotsFor(node) entries are rendering, one per render slot;
+    // the rest are prefetched behind them.
     struct Assignment
     {
         std::string jobId;
         ChunkRange chunk;
-        int64_t assignedAtMs = 0;
+        int64_t assignedAtMs = 0;   // for an active entry: when it became active
+        bool speculative = false;   // duplicate of a straggler still owned by chunk.assigned_to
+    };
+    std::map<std::string, std::deque<Assignment>> m_assignments;
+    NodeRegistry m_nodes;                                   // this cycle's nodes, by id
+    std::unordered_map<std::string, size_t> m_nodeSlots;   // render slots of nodes that left the snapshot
+
+    // Erase one entry; a prefetched chunk moving into a freed slot starts its clock
+    std::deque<Assignment>::iterator eraseAssignment(const std::string& nodeId,
+                                                     std::deque<Assignment>& queue,
+                                                     std::deque<Assignment>::iterator it);
+
+    // Affinity: the job each node last received a chunk of (its warm scene), and
+    // when each active job was last handed a chunk — a job of the same priority
+    // left waiting longer than AFFINITY_STARVE_MS overrides affinity
+    std::unordered_map<std::string, std::string> m_nodeWarmJob;
+    std::unordered_map<std::string, int64_t> m_lastServedMs;
+    static constexpr int64_t AFFINITY_STARVE_MS = 120000;
+
+    // Load-aware dispatch: an idle node whose own telemetry shows it busy
+    // (someone working at it, or a non-farm process) gets no new chunks
+    static constexpr int OVERLOAD_CPU_PCT = 85;
+    static constexpr uint32_t OVERLOAD_RAM_FREE_MB = 1024;
+    std::set<std::string> m_overloaded;     // for logging transitions only
+
+    // Upstreams missing from the job list: submitted in the same batch but
+    // not indexed yet, archived, or a typo'd id. Archived-and-completed ones
+    // are done; anything else holds its downstream until the grace runs out.
+    struct UnknownUpstream
+    {
+        int64_t sinceMs = 0;
+        bool released = false;
+    };
+    bool unknownUpstreamDone(const std::string& jobId, const std::string& upstreamId);
+    std::map<std::string, UnknownUpstream> m_unknownUpstream;  // "job/upstream"
+    std::map<std::string, std::string> m_archivedState;        // archive/index.jsonl: job id -> final state
+    uint64_t m_archiveOffset = 0;
+    int64_t m_lastArchiveReadMs = 0;
+    static constexpr int64_t UNKNOWN_UPSTREAM_GRACE_MS = 600000;
+    static constexpr int64_t ARCHIVE_READ_MS = 5000;
+
+    // Power management (see PowerPolicy). Idle times come from the registry's
+    // idle/busy events; a node stays in m_wakeSentMs until it's back (or
+    // wake_timeout_s passes) and in m_sleepSentMs until it's busy or parked.
+    PowerPolicy m_power;
+    WakeSenderFn m_wakeSenderFn;
+    std::unordered_map<std::string, int64_t> m_idleSinceMs;
+    std::unordered_map<std::string, int64_t> m_wakeSentMs;
+    std::unordered_map<std::string, int64_t> m_sleepSentMs;
+
+    // Preemption (see PreemptionPolicy); waiting is timed by m_lastServedMs
+    PreemptionPolicy m_preemption;
+    std::deque<int64_t> m_preemptions;                          // when, for the hourly budget
+    std::unordered_map<std::string, int64_t> m_preemptedAt;     // node -> last preempted
+
+    // A slot preemption freed, until the node is handed work again. Its
+    // heartbeat still shows it busy, so assignWork counts the slots open, and
+    // the job it was freed for doesn't preempt again for the same chunk.
+    struct FreedSlot
+    {
+        std::string jobId;
+        int64_t atMs = 0;
     };
-    std::map<std::string, Assignment> m_assignments;
+    std::unordered_map<std::string, FreedSlot> m_freedSlots;   // by node
+    static constexpr int64_t FREED_SLOT_MS = 60000;             // unclaimed that long: give up on it
+    static constexpr size_t DEPENDENCY_SCAN = 64;   // pending chunks checked per job per worker
 
     // In-memory dispatch tables: jobId -> DispatchTable
     std::map<std::string, DispatchTable> m_dispatchTables;
 
-    // Jobs needing dispatch.json re-write
+    // Per-job index over DispatchTable::chunks, kept in step with every state change
+    struct ChunkIndex
+    {
+        std::unordered_map<int, size_t> byFrameStart;   // frame_start -> position in chunks
+        std::set<size_t> pending;                       // ordered, so lowest frame goes first
+        std::set<size_t> assigned;
+        size_t completed = 0;
+        std::array<int, 4> frames{};                    // frame count per DispatchState
+        int maxRetries = 3;
+        std::set<int> dirtyStarts;                      // frame_starts to journal on next write
+    };
+    std::map<std::string, ChunkIndex> m_chunkIndex;
+
+    // m_tablesVersion as of each table's last change (getChangedTables)
+    std::map<std::string, uint64_t> m_tableRevisions;
+
+    // Adaptive jobs: pending ranges are split/merged at assignment time so each
+    // chunk lands near targetMs of wall time, based on measured per-frame time
+    struct AdaptiveState
+    {
+        int64_t targetMs = 0;
+        int initialSize = 1;        // manifest chunk_size, used until a frame time is measured
+        double msPerFrame = 0.0;    // moving average of measured render time per frame
+    };
+    std::map<std::string, AdaptiveState> m_adaptive;
+    static constexpr int MAX_ADAPTIVE_CHUNK = 1000;
+    static constexpr double FRAME_TIME_ALPHA = 0.3;
+
+    // Recent measured ms-per-frame per job (all jobs), for straggler detection
+    std::map<std::string, std::deque<double>> m_frameTimes;
+    static constexpr size_t FRAME_TIME_SAMPLES = 32;
+    static constexpr size_t MIN_FRAME_TIME_SAMPLES = 3;
+    static constexpr double STRAGGLER_FACTOR = 2.0;     // elapsed vs median chunk time
+    static constexpr int64_t MIN_STRAGGLER_MS = 60000;
+    static constexpr double BACKUP_MARGIN = 1.5;        // a backup must beat the owner's remaining time by this
+
+    // Jobs with changes not yet on disk
     std::set<std::string> m_dirtyTables;
 
+    // Per-job dispatch.journal bookkeeping; compaction rewrites dispatch.json
+    // once the journal outgrows a fraction of the table
+    struct JournalState
+    {
+        size_t records = 0;         // records appended since the last snapshot
+        bool needsSnapshot = true;  // new/recovered tables start with a full write
+    };
+    std::map<std::string, JournalState> m_journal;
+
+    struct TableWrite
+    {
+        std::string jobId;
+        std::filesystem::path jobDir;
+        bool snapshot = false;
+        DispatchTable table;                // snapshot: a copy as of prepare
+        std::vector<DispatchChunk> records; // delta
+        uint64_t seq = 0;                   // delta: first record's seq, then one past the last
+        std::set<int> starts;               // the dirtyStarts it covers, put back on failure
+        bool ok = false;
+    };
+    static constexpr size_t JOURNAL_MIN_COMPACT = 64;
+
     // Local completion queue (from own RenderCoordinator)
     struct CompletionEntry
     {
         std::string jobId;
         ChunkRange chunk;
         std::string state;
+        std::string framesDone;
     };
     std::queue<CompletionEntry> m_localCompletionQueue;
 
@@ -139,8 +502,16 @@ private:
     std::chrono::steady_clock::time_point m_lastWrite{};
     static constexpr int WRITE_THROTTLE_MS = 2000;
 
-    // Jobs already marked completed (avoid duplicate state writes)
+    // Jobs already marked completed or failed (avoid duplicate state writes)
     std::set<std::string> m_completionWritten;
+
+    // Output verification (OutputDetection "verify_frames"): each chunk is
+    // checked as it completes, and the whole job once more before it's marked
+    // completed — only after that pass comes back clean or can't see the dir
+    OutputVerifier m_verifier;
+    std::map<std::string, int> m_verifyInFlight;    // jobId -> requests out
+    std::set<std::string> m_jobVerified;
+    std::set<std::string> m_verifyWarned;           // unreachable / no pattern, warned once each
 };
 
 } // namespace SR
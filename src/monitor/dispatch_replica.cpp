@@ -0,0 +1,342 @@
+#include "monitor/dispatch_replica.h"
+
+namespace SR {
+
+namespace {
+
+bool sameChunk(const DispatchChunk& a, const DispatchChunk& b)
+{
+    return a.frame_start == b.frame_start && a.frame_end == b.frame_end &&
+           a.state == b.state && a.assigned_to == b.assigned_to &&
+           a.assigned_at_ms == b.assigned_at_ms && a.completed_at_ms == b.completed_at_ms &&
+           a.retry_count == b.retry_count;
+}
+
+// [idx, fs, fe, state, who, assigned_at, completed_at, retries]
+nlohmann::json encodeChunk(size_t idx, const DispatchChunk& dc)
+{
+    return nlohmann::json::array({
+        idx, dc.frame_start, dc.frame_end, static_cast<int>(dc.state),
+        dc.assigned_to, dc.assigned_at_ms, dc.completed_at_ms, dc.retry_count,
+    });
+}
+
+bool decodeChunk(const nlohmann::json& e, size_t& idx, DispatchChunk& dc)
+{
+    if (!e.is_array() || e.size() < 8)
+        return false;
+    try
+    {
+        idx = e[0].get<size_t>();
+        dc.frame_start = e[1].get<int>();
+        dc.frame_end = e[2].get<int>();
+        int st = e[3].get<int>();
+        if (st < 0 || st > static_cast<int>(DispatchState::Failed))
+            return false;
+        dc.state = static_cast<DispatchState>(st);
+        dc.assigned_to = e[4].get<std::string>();
+        dc.assigned_at_ms = e[5].get<int64_t>();
+        dc.completed_at_ms = e[6].get<int64_t>();
+        dc.retry_count = e[7].get<int>();
+    }
+    catch (...)
+    {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// ─── Publisher ──────────────────────────────────────────────────────────────
+
+void DispatchReplicaPublisher::reset(const std::string& nodeId)
+{
+    m_nodeId = nodeId;
+    m_epoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    m_seq = 0;
+    m_sent.clear();
+}
+
+std::vector<nlohmann::json> DispatchReplicaPublisher::deltas(
+    const std::map<std::string, DispatchTable>& tables)
+{
+    std::vector<nlohmann::json> out;
+
+    for (const auto& [jobId, dt] : tables)
+    {
+        auto it = m_sent.find(jobId);
+        std::vector<size_t> changed;
+        if (it == m_sent.end())
+        {
+            if (dt.chunks.size() <= FULL_SEND_MAX_CHUNKS)
+                for (size_t i = 0; i < dt.chunks.size(); ++i)
+                    changed.push_back(i);
+        }
+        else if (it->second.size() != dt.chunks.size())
+        {
+            // Re-chunked: receivers must rebuild the whole layout
+            for (size_t i = 0; i < dt.chunks.size(); ++i)
+                changed.push_back(i);
+        }
+        else
+        {
+            for (size_t i = 0; i < dt.chunks.size(); ++i)
+                if (!sameChunk(it->second[i], dt.chunks[i]))
+                    changed.push_back(i);
+        }
+        m_sent[jobId] = dt.chunks;
+
+        // Pack changed chunks into as few datagrams as fit
+        size_t pos = 0;
+        while (pos < changed.size())
+        {
+            nlohmann::json msg = {
+                {"t", "dd"},
+                {"from", m_nodeId},
+                {"ep", m_epoch},
+                {"seq", ++m_seq},
+                {"job", jobId},
+                {"n", dt.chunks.size()},
+            };
+            size_t bytes = msg.dump().size() + 8;
+            auto entries = nlohmann::json::array();
+            while (pos < changed.size())
+            {
+                auto e = encodeChunk(changed[pos], dt.chunks[changed[pos]]);
+                size_t len = e.dump().size() + 1;
+                if (!entries.empty() && bytes + len > REPLICA_MAX_PAYLOAD)
+                    break;
+                bytes += len;
+                entries.push_back(std::move(e));
+                ++pos;
+            }
+            msg["c"] = std::move(entries);
+            out.push_back(std::move(msg));
+        }
+    }
+
+    return out;
+}
+
+std::vector<nlohmann::json> DispatchReplicaPublisher::digest(
+    const std::map<std::string, DispatchTable>& tables) const
+{
+    std::vector<nlohmann::json> out;
+
+    auto begin = [&]() {
+        return nlohmann::json{
+            {"t", "dg"},
+            {"from", m_nodeId},
+            {"ep", m_epoch},
+            {"seq", m_seq},
+            {"j", nlohmann::json::array()},
+        };
+    };
+
+    nlohmann::json msg = begin();
+    size_t bytes = msg.dump().size();
+    for (const auto& [jobId, dt] : tables)
+    {
+        int total = 0, completed = 0, rendering = 0, failed = 0;
+        for (const auto& dc : dt.chunks)
+        {
+            int count = dc.frame_end - dc.frame_start + 1;
+            total += count;
+            if (dc.state == DispatchState::Completed) completed += count;
+            else if (dc.state == DispatchState::Assigned) rendering += count;
+            else if (dc.state == DispatchState::Failed) failed += count;
+        }
+
+        // [job, chunks, hash, total, completed, rendering, failed]
+        auto e = nlohmann::json::array({
+            jobId, dt.chunks.size(), DispatchReplica::hashTable(dt),
+            total, completed, rendering, failed,
+        });
+        size_t len = e.dump().size() + 1;
+        if (!msg["j"].empty() && bytes + len > REPLICA_MAX_PAYLOAD)
+        {
+            out.push_back(std::move(msg));
+            msg = begin();
+            bytes = msg.dump().size();
+        }
+        bytes += len;
+        msg["j"].push_back(std::move(e));
+    }
+    if (!msg["j"].empty())
+        out.push_back(std::move(msg));
+    return out;
+}
+
+// ─── Receiver ───────────────────────────────────────────────────────────────
+
+std::vector<std::string> DispatchReplica::apply(const nlohmann::json& msg)
+{
+    std::vector<std::string> touched;
+
+    std::string type = msg.value("t", "");
+    std::string from = msg.value("from", "");
+    int64_t epoch = msg.value("ep", int64_t(0));
+    uint64_t seq = msg.value("seq", uint64_t(0));
+    if (from.empty())
+        return touched;
+
+    // A different coordinator (or a restarted one): nothing we hold is trustworthy
+    bool newStream = from != m_from || epoch != m_epoch;
+    if (newStream)
+    {
+        m_from = from;
+        m_epoch = epoch;
+        invalidateAll();
+    }
+
+    if (type == "dd")
+    {
+        if (!newStream && seq != m_lastSeq + 1)
+            invalidateAll();    // lost deltas; wait for the next digest or disk
+        m_lastSeq = seq;
+
+        std::string jobId = msg.value("job", "");
+        size_t n = msg.value("n", size_t(0));
+        if (jobId.empty() || !msg.contains("c") || !msg["c"].is_array())
+            return touched;
+
+        auto& jr = m_jobs[jobId];
+        if (jr.table.chunks.size() != n)
+        {
+            jr.table.chunks.assign(n, DispatchChunk{});
+            jr.valid = false;
+        }
+        for (const auto& e : msg["c"])
+        {
+            size_t idx = 0;
+            DispatchChunk dc;
+            if (decodeChunk(e, idx, dc) && idx < n)
+                jr.table.chunks[idx] = std::move(dc);
+        }
+        jr.table.coordinator_id = from;
+        jr.dirtySinceDigest = true;
+        touched.push_back(jobId);
+    }
+    else if (type == "dg")
+    {
+        // The digest carries the publisher's last delta seq
+        if (!newStream && seq != m_lastSeq)
+            invalidateAll();
+        m_lastSeq = seq;
+
+        if (!msg.contains("j") || !msg["j"].is_array())
+            return touched;
+
+        auto now = std::chrono::steady_clock::now();
+        for (const auto& e : msg["j"])
+        {
+            if (!e.is_array() || e.size() < 7)
+                continue;
+            try
+            {
+                std::string jobId = e[0].get<std::string>();
+                auto& jr = m_jobs[jobId];
+                jr.digest.chunks = e[1].get<size_t>();
+                jr.digest.hash = e[2].get<uint64_t>();
+                jr.digest.total = e[3].get<int>();
+                jr.digest.completed = e[4].get<int>();
+                jr.digest.rendering = e[5].get<int>();
+                jr.digest.failed = e[6].get<int>();
+                jr.digest.receivedAt = now;
+                jr.hasDigest = true;
+                jr.dirtySinceDigest = false;
+                jr.valid = jr.table.chunks.size() == jr.digest.chunks &&
+                           hashTable(jr.table) == jr.digest.hash;
+                touched.push_back(jobId);
+            }
+            catch (...) {}
+        }
+    }
+
+    return touched;
+}
+
+void DispatchReplica::seed(const std::string& jobId, const DispatchTable& table)
+{
+    auto& jr = m_jobs[jobId];
+    if (jr.valid)
+        return;
+
+    jr.table = table;
+
+    // Deltas after the digest would be lost by the overwrite, so only a table
+    // that matches a digest with nothing newer is trusted right away
+    jr.valid = jr.hasDigest && !jr.dirtySinceDigest &&
+               jr.table.chunks.size() == jr.digest.chunks &&
+               hashTable(jr.table) == jr.digest.hash;
+}
+
+void DispatchReplica::retain(const std::set<std::string>& jobIds)
+{
+    std::erase_if(m_jobs, [&](const auto& kv) { return jobIds.count(kv.first) == 0; });
+}
+
+const DispatchTable* DispatchReplica::table(const std::string& jobId) const
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || !it->second.valid)
+        return nullptr;
+    return &it->second.table;
+}
+
+const DispatchReplica::Digest* DispatchReplica::digest(const std::string& jobId, int maxAgeMs) const
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || !it->second.hasDigest)
+        return nullptr;
+    auto age = std::chrono::steady_clock::now() - it->second.digest.receivedAt;
+    if (age > std::chrono::milliseconds(maxAgeMs))
+        return nullptr;
+    return &it->second.digest;
+}
+
+void DispatchReplica::clear()
+{
+    m_jobs.clear();
+    m_from.clear();
+    m_epoch = 0;
+    m_lastSeq = 0;
+}
+
+void DispatchReplica::invalidateAll()
+{
+    for (auto& [id, jr] : m_jobs)
+        jr.valid = false;
+}
+
+uint64_t DispatchReplica::hashTable(const DispatchTable& table)
+{
+    // FNV-1a over every replicated chunk field
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&](const void* data, size_t len) {
+        auto p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < len; ++i)
+        {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    auto mixInt = [&](int64_t v) { mix(&v, sizeof(v)); };
+
+    for (const auto& dc : table.chunks)
+    {
+        mixInt(dc.frame_start);
+        mixInt(dc.frame_end);
+        mixInt(static_cast<int>(dc.state));
+        mixInt(static_cast<int64_t>(dc.assigned_to.size()));
+        mix(dc.assigned_to.data(), dc.assigned_to.size());
+        mixInt(dc.assigned_at_ms);
+        mixInt(dc.completed_at_ms);
+        mixInt(dc.retry_count);
+    }
+    return h;
+}
+
+} // namespace SR
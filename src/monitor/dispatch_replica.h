@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/job_types.h"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace SR {
+
+// Dispatch tables replicated over the UDP multicast fast path.
+//
+// The coordinator multicasts sequence-numbered deltas ("dd": changed chunks
+// of one job) whenever a table changes, plus a digest ("dg": per-job chunk
+// count, content hash and progress counts) every DIGEST_INTERVAL_MS. Other
+// monitors keep a replica: a job's table is trusted only once a digest hash
+// matches it, and every table drops back to the disk files as soon as a
+// sequence gap or coordinator change shows deltas were lost.
+//
+// Messages stay under REPLICA_MAX_PAYLOAD bytes so UdpNotify never drops them.
+
+// ─── Coordinator side ───────────────────────────────────────────────────────
+
+class DispatchReplicaPublisher
+{
+public:
+    void reset(const std::string& nodeId);   // new stream epoch
+
+    // Deltas for the tables changed since the last call (tables the
+    // coordinator holds are only dropped along with the stream, by reset())
+    std::vector<nlohmann::json> deltas(const std::map<std::string, DispatchTable>& tables);
+    std::vector<nlohmann::json> digest(const std::map<std::string, DispatchTable>& tables) const;
+
+    static constexpr int DIGEST_INTERVAL_MS = 5000;
+
+    // A job first seen with more chunks than this is not sent whole;
+    // receivers seed it from disk and the digest confirms it
+    static constexpr size_t FULL_SEND_MAX_CHUNKS = 64;
+
+private:
+    std::string m_nodeId;
+    int64_t m_epoch = 0;
+    uint64_t m_seq = 0;
+    std::map<std::string, std::vector<DispatchChunk>> m_sent;
+};
+
+// ─── Receiver side ──────────────────────────────────────────────────────────
+
+class DispatchReplica
+{
+public:
+    struct Digest
+    {
+        size_t chunks = 0;
+        uint64_t hash = 0;
+        int total = 0, completed = 0, rendering = 0, failed = 0;
+        std::chrono::steady_clock::time_point receivedAt{};
+    };
+
+    // Apply a "dd" or "dg" message. Returns the jobs whose replicated state
+    // (table or digest) changed.
+    std::vector<std::string> apply(const nlohmann::json& msg);
+
+    // Disk read of a job the replica doesn't trust yet; kept as the base for
+    // later deltas and validated by the next digest
+    void seed(const std::string& jobId, const DispatchTable& table);
+
+    // Drop jobs that are no longer listed
+    void retain(const std::set<std::string>& jobIds);
+
+    // Valid table, or nullptr if the caller should read disk
+    const DispatchTable* table(const std::string& jobId) const;
+
+    // Digest newer than maxAgeMs, or nullptr
+    const Digest* digest(const std::string& jobId, int maxAgeMs) const;
+
+    void clear();
+
+    static uint64_t hashTable(const DispatchTable& table);
+
+    // How long a digest stands in for a disk read
+    static constexpr int DIGEST_FRESH_MS = 3 * DispatchReplicaPublisher::DIGEST_INTERVAL_MS;
+
+private:
+    struct JobReplica
+    {
+        DispatchTable table;
+        bool valid = false;
+        bool hasDigest = false;
+        bool dirtySinceDigest = false;  // deltas applied after the last digest
+        Digest digest;
+    };
+
+    void invalidateAll();
+
+    std::map<std::string, JobReplica> m_jobs;
+    std::string m_from;
+    int64_t m_epoch = 0;
+    uint64_t m_lastSeq = 0;
+};
+
+// Wire size budget shared by both sides (UdpNotify::MAX_MSG_SIZE is 1400)
+constexpr size_t REPLICA_MAX_PAYLOAD = 1200;
+
+} // namespace SR
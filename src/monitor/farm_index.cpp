@@ -0,0 +1,136 @@
+#include "monitor/farm_index.h"
+#include "core/atomic_file_io.h"
+#include "core/monitor_log.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// FNV-1a
+uint64_t hashString(const std::string& s)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : s)
+    {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+} // namespace
+
+fs::path FarmIndex::pathFor(const fs::path& appDataDir, const fs::path& farmPath)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.cbor",
+                  (unsigned long long)hashString(farmPath.lexically_normal().generic_string()));
+    return appDataDir / "index" / name;
+}
+
+std::optional<FarmIndex::Data> FarmIndex::load(const fs::path& path, const fs::path& farmPath)
+{
+    auto j = AtomicFileIO::safeReadJson(path);
+    if (!j || !j->is_object())
+        return std::nullopt;
+
+    try
+    {
+        if (j->value("_version", 0) != VERSION ||
+            j->value("farm", std::string()) != farmPath.lexically_normal().generic_string())
+            return std::nullopt;
+
+        Data data;
+        data.savedAtMs = j->value("saved_at_ms", int64_t(0));
+
+        for (const auto& e : j->at("jobs"))
+        {
+            JobManager::IndexedJob job;
+            job.info.manifest = e.at("manifest").get<JobManifest>();
+            job.info.current_state = e.at("state").get<std::string>();
+            job.info.current_priority = e.at("priority").get<int>();
+            job.info.state_timestamp_ms = e.value("state_ms", int64_t(0));
+            job.stateMtime = e.value("state_mtime", int64_t(0));
+            data.jobs.push_back(std::move(job));
+        }
+
+        // The file format doesn't carry validity; the index does, so a
+        // restored list looks like a scanned one
+        for (const auto& e : j->at("templates"))
+        {
+            auto t = e.at("template").get<JobTemplate>();
+            t.valid = e.value("valid", false);
+            t.validation_error = e.value("validation_error", std::string());
+            t.isExample = e.value("example", false);
+            data.templates.push_back(std::move(t));
+        }
+
+        for (const auto& [jobId, p] : j->at("progress").items())
+        {
+            UIDataCache::JobProgress jp;
+            jp.completed = p.at(0).get<int>();
+            jp.total = p.at(1).get<int>();
+            jp.rendering = p.at(2).get<int>();
+            jp.failed = p.at(3).get<int>();
+            jp.renderingChunks = p.at(4).get<int>();
+            data.progress[jobId] = jp;
+        }
+        return data;
+    }
+    catch (const std::exception& e)
+    {
+        MonitorLog::instance().warn("farm", "Ignoring farm index " + path.string() + ": " + e.what());
+        return std::nullopt;
+    }
+}
+
+bool FarmIndex::save(const fs::path& path, const fs::path& farmPath, const Data& data)
+{
+    nlohmann::json jobs = nlohmann::json::array();
+    for (const auto& job : data.jobs)
+    {
+        jobs.push_back({
+            {"manifest", job.info.manifest},
+            {"state", job.info.current_state},
+            {"priority", job.info.current_priority},
+            {"state_ms", job.info.state_timestamp_ms},
+            {"state_mtime", job.stateMtime},
+        });
+    }
+
+    nlohmann::json templates = nlohmann::json::array();
+    for (const auto& t : data.templates)
+    {
+        templates.push_back({
+            {"template", t},
+            {"valid", t.valid},
+            {"validation_error", t.validation_error},
+            {"example", t.isExample},
+        });
+    }
+
+    nlohmann::json progress = nlohmann::json::object();
+    for (const auto& [jobId, p] : data.progress)
+        progress[jobId] = {p.completed, p.total, p.rendering, p.failed, p.renderingChunks};
+
+    nlohmann::json j = {
+        {"_version", VERSION},
+        {"farm", farmPath.lexically_normal().generic_string()},
+        {"saved_at_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()},
+        {"jobs", std::move(jobs)},
+        {"templates", std::move(templates)},
+        {"progress", std::move(progress)},
+    };
+
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    return AtomicFileIO::writeJson(path, j, JsonEncoding::Cbor);
+}
+
+} // namespace SR
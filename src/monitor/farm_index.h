@@ -0,0 +1,46 @@
+#pragma once
+
+#include "monitor/job_manager.h"
+#include "monitor/template_manager.h"
+#include "monitor/ui_data_cache.h"
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace SR {
+
+// Node-local copy of what a cold start otherwise reads off the share: job
+// manifests and states, templates, and each job's last-known progress. One
+// CBOR file per farm under the app data dir ("index/{hash}.cbor").
+//
+// Loaded at farm start so the UI has a job list before the first scan; the
+// managers then reconcile with the share in the background and the app saves
+// the reconciled state back. Only ever a head start: nothing here outranks
+// the share.
+class FarmIndex
+{
+public:
+    struct Data
+    {
+        std::vector<JobManager::IndexedJob> jobs;
+        std::vector<JobTemplate> templates;
+        std::map<std::string, UIDataCache::JobProgress> progress;
+        int64_t savedAtMs = 0;
+    };
+
+    static std::filesystem::path pathFor(const std::filesystem::path& appDataDir,
+                                         const std::filesystem::path& farmPath);
+
+    // nullopt: missing, unreadable, another format version or another farm
+    static std::optional<Data> load(const std::filesystem::path& path,
+                                    const std::filesystem::path& farmPath);
+    static bool save(const std::filesystem::path& path, const std::filesystem::path& farmPath,
+                     const Data& data);
+
+    static constexpr int VERSION = 1;
+};
+
+} // namespace SR
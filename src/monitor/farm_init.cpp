@@ -1,10 +1,12 @@
 #include "monitor/farm_init.h"
 #include "core/config.h"
 #include "core/atomic_file_io.h"
+#include "core/farm_storage.h"
 #include "core/platform.h"
 #include "core/monitor_log.h"
 
 #include <chrono>
+#include <fstream>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -42,6 +44,16 @@ static fs::path findBundledPluginsDir()
     return {};
 }
 
+// Bundled files are local; the copy lands on the farm through FarmStorage
+static bool copyToFarm(const fs::path& src, const fs::path& dest)
+{
+    std::ifstream file(src, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return FarmStorage::current().writeAtomic(dest, bytes);
+}
+
 static void copyPlugins(const fs::path& farmPath)
 {
     auto bundled = findBundledPluginsDir();
@@ -57,14 +69,13 @@ static void copyPlugins(const fs::path& farmPath)
         if (!appDir.is_directory(ec)) continue;
 
         auto destDir = farmPath / "plugins" / appDir.path().filename();
-        fs::create_directories(destDir, ec);
+        FarmStorage::current().createDirectories(destDir);
 
         for (auto& entry : fs::directory_iterator(appDir.path(), ec))
         {
             if (!entry.is_regular_file(ec)) continue;
             auto dest = destDir / entry.path().filename();
-            fs::copy_file(entry.path(), dest, fs::copy_options::overwrite_existing, ec);
-            if (!ec)
+            if (copyToFarm(entry.path(), dest))
                 MonitorLog::instance().info("farm", "Copied plugin: " +
                     appDir.path().filename().string() + "/" + entry.path().filename().string());
         }
@@ -87,8 +98,7 @@ static void copyExampleTemplates(const fs::path& farmPath)
         if (entry.is_regular_file() && entry.path().extension() == ".json")
         {
             auto dest = destDir / entry.path().filename();
-            fs::copy_file(entry.path(), dest, fs::copy_options::overwrite_existing, ec);
-            if (!ec)
+            if (copyToFarm(entry.path(), dest))
                 MonitorLog::instance().info("farm", "Copied template: " + entry.path().filename().string());
         }
     }
@@ -97,10 +107,10 @@ static void copyExampleTemplates(const fs::path& farmPath)
 FarmInit::Result FarmInit::init(const fs::path& syncRoot, const std::string& nodeId)
 {
     Result result;
-    std::error_code ec;
+    auto& storage = FarmStorage::current();
 
     // Validate sync root
-    if (!fs::is_directory(syncRoot, ec))
+    if (!storage.isDirectory(syncRoot))
     {
         result.error = "Sync root is not a valid directory: " + syncRoot.string();
         return result;
@@ -109,19 +119,20 @@ FarmInit::Result FarmInit::init(const fs::path& syncRoot, const std::string& nod
     fs::path farmPath = syncRoot / "SmallRender-v1";
     result.farmPath = farmPath;
 
-    bool firstNode = !fs::exists(farmPath, ec);
+    bool firstNode = !storage.exists(farmPath);
 
     if (firstNode)
     {
         MonitorLog::instance().info("farm", "Creating farm structure at: " + farmPath.string());
 
         // Create full directory structure
-        fs::create_directories(farmPath / "nodes", ec);
-        fs::create_directories(farmPath / "jobs", ec);
-        fs::create_directories(farmPath / "commands", ec);
-        fs::create_directories(farmPath / "templates" / "examples", ec);
-        fs::create_directories(farmPath / "plugins", ec);
-        fs::create_directories(farmPath / "submissions" / "processed", ec);
+        storage.createDirectories(farmPath / "nodes");
+        storage.createDirectories(farmPath / "jobs");
+        storage.createDirectories(farmPath / "commands");
+        storage.createDirectories(farmPath / "templates" / "examples");
+        storage.createDirectories(farmPath / "plugins");
+        storage.createDirectories(farmPath / "submissions" / "processed");
+        storage.createDirectories(farmPath / "metrics");
 
         // Write farm.json
         auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -166,8 +177,8 @@ FarmInit::Result FarmInit::init(const fs::path& syncRoot, const std::string& nod
     }
 
     // Always ensure own node dirs exist
-    fs::create_directories(farmPath / "nodes" / nodeId, ec);
-    fs::create_directories(farmPath / "commands" / nodeId / "processed", ec);
+    storage.createDirectories(farmPath / "nodes" / nodeId);
+    storage.createDirectories(farmPath / "commands" / nodeId / "processed");
 
     result.success = true;
     return result;
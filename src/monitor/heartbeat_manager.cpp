@@ -1,5 +1,7 @@
 #include "monitor/heartbeat_manager.h"
 #include "core/atomic_file_io.h"
+#include "core/farm_storage.h"
+#include "core/read_cache.h"
 #include "core/platform.h"
 #include <nlohmann/json.hpp>
 
@@ -7,6 +9,7 @@
 #include <chrono>
 #include <cmath>
 #include "core/monitor_log.h"
+#include "core/perf_counters.h"
 
 namespace SR {
 
@@ -31,6 +34,7 @@ void HeartbeatManager::start(const fs::path& farmPath,
     m_nodeId   = identity.nodeId();
     m_hostname = identity.systemInfo().hostname;
     m_os       = getOS();
+    m_macAddress = getMacAddress();
     m_gpuName  = identity.systemInfo().gpuName;
     m_cpuCores = identity.systemInfo().cpuCores;
     m_ramGb    = identity.systemInfo().ramMB / 1024;
@@ -38,15 +42,21 @@ void HeartbeatManager::start(const fs::path& farmPath,
     m_tags     = tags;
     m_seq.store(0);
     m_nodeState = "active";
+    m_parked = false;
     m_renderState = "idle";
     m_activeJob.clear();
     m_activeFrames.clear();
+    m_fastPathActive = false;
+    m_fieldsChanged = false;
+    m_throttled = false;
+    m_load = {};
 
     m_running.store(true);
 
     // Write first heartbeat immediately (on caller thread for visibility)
     writeHeartbeat();
 
+    startScanPool();
     m_thread = std::thread(&HeartbeatManager::threadFunc, this);
 
     MonitorLog::instance().info("health", "Started (heartbeat=" + std::to_string(timing.heartbeat_interval_ms) + "ms, scan=" + std::to_string(timing.scan_interval_ms) + "ms, dead_scans=" + std::to_string(timing.dead_threshold_scans) + ")");
@@ -60,20 +70,33 @@ void HeartbeatManager::stop()
     m_running.store(false);
     if (m_thread.joinable())
         m_thread.join();
+    stopScanPool();
 
     writeFinalHeartbeat();
 
     MonitorLog::instance().info("health", "Stopped");
 }
 
-std::vector<NodeInfo> HeartbeatManager::getNodeSnapshot() const
+bool HeartbeatManager::hasUdpContact(const std::string& nodeId) const
 {
     std::lock_guard<std::mutex> lock(m_mutex);
-    std::vector<NodeInfo> result;
-    result.reserve(m_nodes.size());
+    auto it = m_nodes.find(nodeId);
+    return it != m_nodes.end() && !it->second.isDead && it->second.hasUdpContact;
+}
+
+NodeSnapshotPtr HeartbeatManager::getNodeSnapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_nodeSnapshot->version == m_nodesVersion)
+        return m_nodeSnapshot;
+
+    auto snap = std::make_shared<NodeSnapshot>();
+    snap->version = m_nodesVersion;
+    snap->nodes.reserve(m_nodes.size());
     for (const auto& [id, info] : m_nodes)
-        result.push_back(info);
-    return result;
+        snap->nodes.push_back(info);
+    m_nodeSnapshot = std::move(snap);
+    return m_nodeSnapshot;
 }
 
 void HeartbeatManager::updateTiming(const TimingConfig& timing)
@@ -85,49 +108,176 @@ void HeartbeatManager::updateTiming(const TimingConfig& timing)
 void HeartbeatManager::updateTags(const std::vector<std::string>& tags)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_tags == tags) return;
     m_tags = tags;
+    noteChange();
 }
 
 void HeartbeatManager::setIsCoordinator(bool coordinator)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isCoordinator == coordinator) return;
     m_isCoordinator = coordinator;
+    noteChange();
+}
+
+void HeartbeatManager::setIsStandby(bool standby)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isStandby == standby) return;
+    m_isStandby = standby;
+    noteChange();
+}
+
+void HeartbeatManager::setCoordinatorEpoch(uint64_t epoch)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_coordEpoch == epoch) return;
+    m_coordEpoch = epoch;
+    noteChange();
+}
+
+void HeartbeatManager::setShardState(bool isShard, int pendingChunks)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isShard == isShard && m_shardPending == pendingChunks) return;
+    m_isShard = isShard;
+    m_shardPending = pendingChunks;
+    noteChange();
+}
+
+void HeartbeatManager::setWorkFor(const std::string& shardNodeId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_workFor == shardNodeId) return;
+    m_workFor = shardNodeId;
+    noteChange();
+}
+
+void HeartbeatManager::setAllowSleep(bool allow)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_allowSleep == allow) return;
+    m_allowSleep = allow;
+    noteChange();
+}
+
+void HeartbeatManager::setParked(bool parked)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_parked == parked) return;
+    m_parked = parked;
+    if (parked)
+        m_seq.fetch_add(1);
+    noteChange();
+    if (!parked)
+        return;
+
+    // The thread may not get another turn before the machine suspends
+    nlohmann::json j = buildHeartbeat();
+    AtomicFileIO::writeJson(m_nodesDir / m_nodeId / "heartbeat.json", j, FileClass::Heartbeat);
+}
+
+void HeartbeatManager::setTcpPort(uint16_t port)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_tcpPort == port) return;
+    m_tcpPort = port;
+    noteChange();
+}
+
+void HeartbeatManager::setFastPathActive(bool active)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fastPathActive = active;
 }
 
 void HeartbeatManager::setRenderState(const std::string& state,
                                        const std::string& activeJob,
                                        const std::string& activeFrames)
 {
+    // Called every frame; only a real change costs a write
     std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_renderState == state && m_activeJob == activeJob && m_activeFrames == activeFrames)
+        return;
     m_renderState = state;
     m_activeJob = activeJob;
     m_activeFrames = activeFrames;
+    noteChange();
+}
+
+void HeartbeatManager::setRenderSlots(int slots, int freeSlots,
+                                      const std::vector<std::string>& activeJobs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_renderSlots == slots && m_freeSlots == freeSlots && m_activeJobs == activeJobs)
+        return;
+    m_renderSlots = slots;
+    m_freeSlots = freeSlots;
+    m_activeJobs = activeJobs;
+    noteChange();
 }
 
 void HeartbeatManager::setNodeState(const std::string& state)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_nodeState == state) return;
     m_nodeState = state;
+    noteChange();
+}
+
+void HeartbeatManager::noteChange()
+{
+    // Must be called with m_mutex held. The local entry (dispatch reads it for
+    // self-assignment) updates now; the file follows on the thread.
+    m_fieldsChanged = true;
+    ++m_nodesVersion;
+    auto it = m_nodes.find(m_nodeId);
+    if (it != m_nodes.end())
+        it->second.heartbeat = buildHeartbeat();
 }
 
-void HeartbeatManager::processUdpHeartbeat(const nlohmann::json& msg)
+bool HeartbeatManager::diskHeartbeatThrottled() const
+{
+    // Must be called with m_mutex held. Peers on another subnet, or not yet
+    // heard on the fast path, still need the file at the normal cadence.
+    if (!m_fastPathActive)
+        return false;
+    size_t alive = 0;
+    for (const auto& [id, info] : m_nodes)
+    {
+        if (info.isLocal || info.isDead)
+            continue;
+        if (!info.hasUdpContact)
+            return false;
+        ++alive;
+    }
+    return alive > 0;
+}
+
+bool HeartbeatManager::processUdpHeartbeat(const nlohmann::json& msg)
 {
     std::string peerId = msg.value("n", "");
     if (peerId.empty() || peerId == m_nodeId)
-        return;
+        return false;
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    ++m_nodesVersion;
     auto& info = m_nodes[peerId];
     auto myNow = nowMs();
+    int wasFree = (!info.isDead && info.heartbeat.node_state == "active")
+                  ? info.heartbeat.free_slots : 0;
+    std::string wasWorkFor = info.heartbeat.work_for;
 
+    // A datagram is proof of life on its own: the sender's disk seq may sit
+    // still for THROTTLED_HEARTBEAT_MS while it multicasts
     uint64_t seq = msg.value("seq", uint64_t(0));
-    if (seq > info.lastSeenSeq)
-    {
-        info.lastSeenSeq = seq;
-        info.staleCount = 0;
-        info.isDead = false;
-    }
+    info.lastSeenSeq = (std::max)(info.lastSeenSeq, seq);
+    info.staleCount = 0;
+    if (info.isDead)
+        info.reclaimEligible = false;
+    info.isDead = false;
 
     // Update fast-changing fields from compact UDP heartbeat
     info.heartbeat.node_id = peerId;
@@ -136,14 +286,37 @@ void HeartbeatManager::processUdpHeartbeat(const nlohmann::json& msg)
     info.heartbeat.node_state = msg.value("st", std::string("active"));
     info.heartbeat.render_state = msg.value("rs", std::string("idle"));
     info.heartbeat.is_coordinator = msg.value("coord", false);
+    info.heartbeat.is_standby = msg.value("sb", false);
+    info.heartbeat.coord_epoch = msg.value("cep", uint64_t(0));
+    info.heartbeat.is_shard = msg.value("shd", false);
+    info.heartbeat.shard_pending = msg.value("spd", 0);
+    info.heartbeat.work_for = msg.value("wf", std::string());
+    if (msg.contains("tcp"))
+        info.heartbeat.tcp_port = msg.value("tcp", uint16_t(0));
     if (msg.contains("job") && !msg["job"].is_null())
         info.heartbeat.active_job = msg["job"].get<std::string>();
     else
         info.heartbeat.active_job.clear();
+    info.heartbeat.active_frames = msg.value("fr", std::string());
+    info.heartbeat.render_slots = msg.value("sl", 1);
+    info.heartbeat.free_slots = msg.value("fs", info.heartbeat.render_state == "idle" ? info.heartbeat.render_slots : 0);
+    if (msg.contains("jobs") && msg["jobs"].is_array())
+        info.heartbeat.active_jobs = msg["jobs"].get<std::vector<std::string>>();
+    else if (!info.heartbeat.active_job.empty())
+        info.heartbeat.active_jobs = {info.heartbeat.active_job};
+    else
+        info.heartbeat.active_jobs.clear();
+    if (msg.contains("ld") && msg["ld"].is_object())
+        msg["ld"].get_to(info.heartbeat.load);
 
     info.isLocal = false;
     info.hasUdpContact = true;
     info.lastUdpContactMs = myNow;
+
+    // A worker lent to another shard (or back home) is one too
+    return !info.isDead && info.heartbeat.node_state == "active" &&
+           (info.heartbeat.free_slots > wasFree ||
+            (info.heartbeat.work_for != wasWorkFor && info.heartbeat.free_slots > 0));
 }
 
 void HeartbeatManager::processUdpGoodbye(const nlohmann::json& msg)
@@ -161,6 +334,7 @@ void HeartbeatManager::processUdpGoodbye(const nlohmann::json& msg)
     auto& info = it->second;
     if (!info.isDead)
     {
+        ++m_nodesVersion;
         info.isDead = true;
         info.reclaimEligible = true;  // chunks can be reassigned immediately
         info.hasUdpContact = false;
@@ -177,6 +351,7 @@ void HeartbeatManager::threadFunc()
 
     auto lastHeartbeat = clock::now();
     auto lastScan = clock::time_point{}; // trigger immediate first scan
+    auto lastSample = clock::time_point{};
 
     while (m_running.load())
     {
@@ -192,8 +367,35 @@ void HeartbeatManager::threadFunc()
 
             auto hbElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastHeartbeat).count();
             auto scanElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastScan).count();
+            auto sampleElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastSample).count();
+
+            if (sampleElapsed >= LOAD_SAMPLE_MS)
+            {
+                sampleLoad();
+                lastSample = now;
+                sampleElapsed = 0;
+            }
 
-            if (hbElapsed >= static_cast<int64_t>(timing.heartbeat_interval_ms))
+            // Long cadence while the fast path carries liveness to every peer;
+            // field changes are written promptly either way
+            int64_t hbInterval = static_cast<int64_t>(timing.heartbeat_interval_ms);
+            bool changed = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                bool throttled = diskHeartbeatThrottled();
+                if (throttled != m_throttled)
+                {
+                    m_throttled = throttled;
+                    MonitorLog::instance().info("health", throttled
+                        ? "Fast path reaches all peers, disk heartbeat every " + std::to_string(THROTTLED_HEARTBEAT_MS / 1000) + "s"
+                        : "Disk heartbeat back to every " + std::to_string(hbInterval) + "ms");
+                }
+                if (throttled)
+                    hbInterval = (std::max)(hbInterval, THROTTLED_HEARTBEAT_MS);
+                changed = m_fieldsChanged;
+            }
+
+            if (hbElapsed >= hbInterval || (changed && hbElapsed >= MIN_CHANGE_WRITE_MS))
             {
                 writeHeartbeat();
                 lastHeartbeat = clock::now();
@@ -202,15 +404,14 @@ void HeartbeatManager::threadFunc()
             if (scanElapsed >= static_cast<int64_t>(timing.scan_interval_ms))
             {
                 scanPeers();
-                detectStaleness();
-                detectClockSkew();
                 lastScan = clock::now();
             }
 
             // Sleep until next event, but no longer than 500ms (responsive to stop)
-            auto timeToNextHb = static_cast<int64_t>(timing.heartbeat_interval_ms) - hbElapsed;
+            auto timeToNextHb = hbInterval - hbElapsed;
             auto timeToNextScan = static_cast<int64_t>(timing.scan_interval_ms) - scanElapsed;
-            auto sleepMs = std::min({timeToNextHb, timeToNextScan, int64_t(500)});
+            auto timeToNextSample = LOAD_SAMPLE_MS - sampleElapsed;
+            auto sleepMs = std::min({timeToNextHb, timeToNextScan, timeToNextSample, int64_t(500)});
             if (sleepMs < 10) sleepMs = 10;
 
             std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs));
@@ -228,21 +429,44 @@ void HeartbeatManager::threadFunc()
     }
 }
 
+void HeartbeatManager::sampleLoad()
+{
+    // Counter queries can take a few ms; keep them outside m_mutex
+    NodeLoad load = m_sampler.sample(getAppDataDir());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_load = load;
+    // Load isn't a field change (it would defeat the disk throttle), but the
+    // local entry stays current for self-dispatch
+    ++m_nodesVersion;
+    auto it = m_nodes.find(m_nodeId);
+    if (it != m_nodes.end())
+        it->second.heartbeat.load = load;
+}
+
+NodeLoad HeartbeatManager::localLoad() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_load;
+}
+
 void HeartbeatManager::writeHeartbeat()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
     m_seq.fetch_add(1);
+    m_fieldsChanged = false;
     auto hb = buildHeartbeat();
     nlohmann::json j = hb;
 
     auto path = m_nodesDir / m_nodeId / "heartbeat.json";
-    if (!AtomicFileIO::writeJson(path, j))
+    if (!AtomicFileIO::writeJson(path, j, FileClass::Heartbeat))
     {
         MonitorLog::instance().error("health", "Failed to write heartbeat (seq=" + std::to_string(m_seq.load()) + ")");
     }
 
     // Update local node in map
+    ++m_nodesVersion;
     auto& local = m_nodes[m_nodeId];
     local.heartbeat = hb;
     local.isLocal = true;
@@ -261,7 +485,7 @@ void HeartbeatManager::writeFinalHeartbeat()
     nlohmann::json j = hb;
 
     auto path = m_nodesDir / m_nodeId / "heartbeat.json";
-    AtomicFileIO::writeJson(path, j);
+    AtomicFileIO::writeJson(path, j, FileClass::Heartbeat);
 }
 
 Heartbeat HeartbeatManager::buildHeartbeat() const
@@ -275,15 +499,27 @@ Heartbeat HeartbeatManager::buildHeartbeat() const
     hb.protocol_version = PROTOCOL_VERSION;
     hb.seq = m_seq.load();
     hb.timestamp_ms = nowMs();
-    hb.node_state = m_nodeState;
+    hb.node_state = m_parked ? "sleeping" : m_nodeState;
     hb.render_state = m_renderState;
     hb.active_job = m_activeJob;
     hb.active_frames = m_activeFrames;
+    hb.active_jobs = m_activeJobs;
+    hb.render_slots = m_renderSlots;
+    hb.free_slots = m_freeSlots;
     hb.gpu_name = m_gpuName;
     hb.cpu_cores = m_cpuCores;
     hb.ram_gb = m_ramGb;
+    hb.load = m_load;
     hb.tags = m_tags;
     hb.is_coordinator = m_isCoordinator;
+    hb.is_standby = m_isStandby;
+    hb.coord_epoch = m_coordEpoch;
+    hb.tcp_port = m_tcpPort;
+    hb.is_shard = m_isShard;
+    hb.shard_pending = m_shardPending;
+    hb.work_for = m_workFor;
+    hb.mac_address = m_macAddress;
+    hb.allow_sleep = m_allowSleep;
     return hb;
 }
 
@@ -293,41 +529,171 @@ int64_t HeartbeatManager::nowMs() const
         std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
+void HeartbeatManager::startScanPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        m_scanStopping = false;
+        m_scanQueue.clear();
+        m_scanInFlight.clear();
+        m_scanStarted.clear();
+        m_scanResults.clear();
+    }
+    for (size_t i = 0; i < SCAN_WORKERS; ++i)
+        m_scanThreads.emplace_back(&HeartbeatManager::scanWorkerFunc, this);
+}
+
+void HeartbeatManager::stopScanPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        m_scanStopping = true;
+        m_scanQueue.clear();
+    }
+    m_scanCv.notify_all();
+    // A read stuck on an unreachable share still has to return before join
+    for (auto& t : m_scanThreads)
+    {
+        if (t.joinable())
+            t.join();
+    }
+    m_scanThreads.clear();
+}
+
+void HeartbeatManager::scanWorkerFunc()
+{
+    std::unique_lock<std::mutex> lock(m_scanMutex);
+    while (true)
+    {
+        m_scanCv.wait(lock, [this] { return m_scanStopping || !m_scanQueue.empty(); });
+        if (m_scanStopping)
+            return;
+
+        ScanRead job = std::move(m_scanQueue.front());
+        m_scanQueue.pop_front();
+        m_scanStarted[job.peerId] = std::chrono::steady_clock::now();
+        lock.unlock();
+
+        // Unchanged heartbeat (stopped or dead peer) is a stat, not a re-parse
+        auto hb = ReadCache::instance().read<Heartbeat>(job.path);
+
+        lock.lock();
+        m_scanStarted.erase(job.peerId);
+        m_scanInFlight.erase(job.peerId);
+        m_scanResults.push_back({job.peerId, std::move(hb)});
+        m_scanDoneCv.notify_all();
+    }
+}
+
 void HeartbeatManager::scanPeers()
 {
-    std::error_code ec;
-    std::lock_guard<std::mutex> lock(m_mutex);
+    SR_PERF_SCOPE("heartbeat.scanPeers");
+    using clock = std::chrono::steady_clock;
 
-    for (auto& entry : fs::directory_iterator(m_nodesDir, ec))
+    // List peers and read their heartbeats with no lock held: on high-latency
+    // mounts each read can take hundreds of ms
+    std::vector<ScanRead> reads;
+    for (auto& entry : FarmStorage::current().list(m_nodesDir))
     {
-        if (!entry.is_directory(ec))
+        if (!entry.isDir)
             continue;
+        if (entry.name == m_nodeId)
+            continue;   // kept current by writeHeartbeat()/noteChange()
+        auto path = m_nodesDir / entry.name / "heartbeat.json";
+        reads.push_back({std::move(entry.name), std::move(path)});
+    }
+
+    std::vector<ScanResult> results;
+    std::set<std::string> skipped;
+    {
+        std::unique_lock<std::mutex> lock(m_scanMutex);
+        for (auto& r : reads)
+        {
+            // A read still outstanding from an earlier scan isn't queued twice
+            if (m_scanInFlight.insert(r.peerId).second)
+                m_scanQueue.push_back(std::move(r));
+        }
+        m_scanCv.notify_all();
+
+        // Wait until every read is done, or what's left has outlived its timeout
+        auto scanStart = clock::now();
+        while (!m_scanInFlight.empty() && !m_scanStopping)
+        {
+            auto now = clock::now();
+            if (now - scanStart >= std::chrono::milliseconds(SCAN_MAX_MS))
+                break;
+            bool waiting = !m_scanQueue.empty();
+            for (const auto& [peerId, started] : m_scanStarted)
+            {
+                if (now - started < std::chrono::milliseconds(SCAN_FILE_TIMEOUT_MS))
+                    waiting = true;
+            }
+            if (!waiting)
+                break;
+            m_scanDoneCv.wait_for(lock, std::chrono::milliseconds(20));
+        }
 
-        std::string peerId = entry.path().filename().string();
-        auto hbPath = entry.path() / "heartbeat.json";
+        // Reads that never started are dropped; running ones deliver next scan
+        for (const auto& r : m_scanQueue)
+            m_scanInFlight.erase(r.peerId);
+        m_scanQueue.clear();
+        skipped = m_scanInFlight;
+        results.swap(m_scanResults);
+    }
 
-        auto data = AtomicFileIO::safeReadJson(hbPath);
-        if (!data.has_value())
+    // Swap the results in, then judge liveness on the complete picture
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& r : results)
+    {
+        if (!r.hb)
             continue;
 
-        try
+        const auto& cached = r.hb;
+        bool isNew = (m_nodes.find(r.peerId) == m_nodes.end());
+        auto& info = m_nodes[r.peerId];
+        info.isLocal = false;
+        info.lastKnown = false;
+        info.lastKnownScans = 0;
+
+        if (info.hasUdpContact && cached->timestamp_ms < info.heartbeat.timestamp_ms)
         {
-            Heartbeat hb = data.value().get<Heartbeat>();
-            bool isNew = (m_nodes.find(peerId) == m_nodes.end());
-            auto& info = m_nodes[peerId];
-            info.heartbeat = hb;
-            info.isLocal = (peerId == m_nodeId);
-
-            // Seed lastSeenSeq on first discovery so the node must
-            // advance its seq to prove it's alive (not just stale on disk)
-            if (isNew && !info.isLocal)
-                info.lastSeenSeq = hb.seq;
+            // Fast-path state is newer than a throttled file: take only the
+            // fields heartbeats don't carry over UDP
+            info.heartbeat.hostname = cached->hostname;
+            info.heartbeat.os = cached->os;
+            info.heartbeat.app_version = cached->app_version;
+            info.heartbeat.protocol_version = cached->protocol_version;
+            info.heartbeat.gpu_name = cached->gpu_name;
+            info.heartbeat.cpu_cores = cached->cpu_cores;
+            info.heartbeat.ram_gb = cached->ram_gb;
+            info.heartbeat.tags = cached->tags;
+            info.heartbeat.last_cmd_timestamp_ms = cached->last_cmd_timestamp_ms;
         }
-        catch (const std::exception& e)
+        else
         {
-            MonitorLog::instance().error("health", "Failed to parse heartbeat for " + peerId + ": " + std::string(e.what()));
+            info.heartbeat = *cached;
         }
+
+        // Seed lastSeenSeq on first discovery so the node must
+        // advance its seq to prove it's alive (not just stale on disk)
+        if (isNew)
+            info.lastSeenSeq = cached->seq;
+    }
+
+    for (const auto& peerId : skipped)
+    {
+        auto it = m_nodes.find(peerId);
+        if (it == m_nodes.end())
+            continue;
+        if (!it->second.lastKnown)
+            MonitorLog::instance().warn("health", "Heartbeat read for " + peerId + " is slow, keeping last known state");
+        it->second.lastKnown = true;
+        it->second.lastKnownScans++;
     }
+
+    detectStaleness();
+    detectClockSkew();
+    ++m_nodesVersion;
 }
 
 void HeartbeatManager::detectStaleness()
@@ -338,8 +704,18 @@ void HeartbeatManager::detectStaleness()
         if (info.isLocal)
             continue;
 
-        // Seq-based staleness detection (runs for all nodes including stopped)
-        if (info.heartbeat.seq == info.lastSeenSeq)
+        // A file we couldn't read this scan is no evidence either way, until
+        // it has been unreadable for as long as it'd take to call a node dead
+        if (info.lastKnown && !info.hasUdpContact &&
+            info.lastKnownScans < m_timing.dead_threshold_scans)
+            continue;
+
+        // Fast-path peers: liveness is last contact (their disk heartbeat may be
+        // throttled). Others: seq-based staleness (runs for all nodes including stopped)
+        bool advanced = info.hasUdpContact
+            ? (nowMs() - info.lastUdpContactMs) <= UDP_DEAD_MS
+            : info.heartbeat.seq != info.lastSeenSeq;
+        if (!advanced)
         {
             info.staleCount++;
         }
@@ -350,7 +726,8 @@ void HeartbeatManager::detectStaleness()
             info.reclaimEligible = false;
         }
 
-        info.lastSeenSeq = info.heartbeat.seq;
+        if (!info.hasUdpContact)
+            info.lastSeenSeq = info.heartbeat.seq;
 
         // Stopped nodes are alive but their chunks can be reassigned
         if (!info.isDead && info.heartbeat.node_state == "stopped")
@@ -360,7 +737,14 @@ void HeartbeatManager::detectStaleness()
 
         if (info.staleCount >= m_timing.dead_threshold_scans)
         {
-            if (!info.isDead)
+            if (!info.isDead && info.heartbeat.node_state == "sleeping")
+            {
+                // Said it was going to sleep: parked, and has nothing to reclaim
+                info.isDead = true;
+                info.reclaimEligible = true;
+                MonitorLog::instance().info("health", "Node parked (sleeping): " + id);
+            }
+            else if (!info.isDead)
             {
                 info.isDead = true;
                 info.reclaimEligible = false; // grace period: one more scan
@@ -374,19 +758,26 @@ void HeartbeatManager::detectStaleness()
 
         // UDP fast dead detection: if we had UDP contact and lost it for 10s,
         // the node is almost certainly down — fast-track to dead without waiting
-        // for the slower filesystem stale count to accumulate.
+        // for the slower filesystem stale count to accumulate. From then on the
+        // file seq decides again; a live sender resumes its normal disk cadence
+        // once it stops hearing us too.
         if (info.hasUdpContact)
         {
             int64_t udpSilenceMs = nowMs() - info.lastUdpContactMs;
-            if (udpSilenceMs > 15000)
+            if (udpSilenceMs > UDP_CONTACT_LOST_MS)
             {
                 info.hasUdpContact = false;
+                info.lastSeenSeq = info.heartbeat.seq;
             }
-            if (udpSilenceMs > 10000 && !info.isDead)
+            if (udpSilenceMs > UDP_DEAD_MS && !info.isDead)
             {
                 info.isDead = true;
-                info.reclaimEligible = false; // grace period: one more scan
-                MonitorLog::instance().warn("health", "Node DEAD (UDP lost): " + id);
+                bool parked = info.heartbeat.node_state == "sleeping";
+                info.reclaimEligible = parked;      // else grace period: one more scan
+                if (parked)
+                    MonitorLog::instance().info("health", "Node parked (sleeping): " + id);
+                else
+                    MonitorLog::instance().warn("health", "Node DEAD (UDP lost): " + id);
             }
         }
     }
@@ -3,18 +3,28 @@
 #include "core/heartbeat.h"
 #include "core/config.h"
 #include "core/node_identity.h"
+#include "core/resource_sampler.h"
 
 #include <filesystem>
 #include <vector>
 #include <string>
 #include <map>
+#include <set>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <thread>
 #include <atomic>
 #include <nlohmann/json_fwd.hpp>
 
 namespace SR {
 
+// Liveness: peers heard over the fast path (UDP/TCP heartbeats) are judged by
+// last contact; the rest by their heartbeat.json seq advancing. While every
+// alive peer hears us on the fast path, our own heartbeat.json is only
+// rewritten every THROTTLED_HEARTBEAT_MS, plus whenever a field changes.
 class HeartbeatManager
 {
 public:
@@ -34,7 +44,10 @@ public:
     void stop();
 
     // Thread-safe snapshot of all known nodes (local + peers).
-    std::vector<NodeInfo> getNodeSnapshot() const;
+    NodeSnapshotPtr getNodeSnapshot() const;
+
+    // Thread-safe: peer is alive and heard over UDP recently.
+    bool hasUdpContact(const std::string& nodeId) const;
 
     // True if this node's clock is skewed vs majority of alive peers.
     bool hasLocalClockSkew() const { return m_localClockSkew.load(); }
@@ -43,15 +56,29 @@ public:
     void updateTiming(const TimingConfig& timing);
     void updateTags(const std::vector<std::string>& tags);
     void setIsCoordinator(bool coordinator);
+    void setIsStandby(bool standby);
+    void setCoordinatorEpoch(uint64_t epoch);
+    void setTcpPort(uint16_t port);     // advertised control link port (0 = none)
+    void setShardState(bool isShard, int pendingChunks);    // see CoordinatorShards
+    void setWorkFor(const std::string& shardNodeId);        // worker lent to a shard ("" = home)
+    void setFastPathActive(bool active);    // we multicast heartbeats; allows disk throttling
+    void setAllowSleep(bool allow);         // advertise that we honour sleep commands
+
+    // Announce "sleeping" before suspending (written to disk before returning),
+    // so peers park this node instead of declaring it dead; false on resume
+    void setParked(bool parked);
 
     // Live render state updates (thread-safe, called from main thread).
     void setRenderState(const std::string& state,
                         const std::string& activeJob,
                         const std::string& activeFrames);
+    void setRenderSlots(int slots, int freeSlots, const std::vector<std::string>& activeJobs);
     void setNodeState(const std::string& state);
 
     // UDP fast path: process compact heartbeat from UDP (main thread).
-    void processUdpHeartbeat(const nlohmann::json& msg);
+    // Returns true if the peer just gained a free render slot, or was lent to
+    // another shard with one (active/alive).
+    bool processUdpHeartbeat(const nlohmann::json& msg);
 
     // UDP fast path: process goodbye from a shutting-down node (main thread).
     void processUdpGoodbye(const nlohmann::json& msg);
@@ -59,16 +86,48 @@ public:
     // Thread-safe read of local sequence number.
     uint64_t localSeq() const { return m_seq.load(); }
 
+    // Thread-safe: latest resource sample of this node (for the UDP heartbeat).
+    NodeLoad localLoad() const;
+
+    static constexpr int64_t THROTTLED_HEARTBEAT_MS = 60000;
+    static constexpr int64_t MIN_CHANGE_WRITE_MS    = 1000;     // coalesce change-triggered writes
+    static constexpr int64_t UDP_DEAD_MS            = 10000;    // fast-path silence before dead
+    static constexpr int64_t UDP_CONTACT_LOST_MS    = 15000;    // ... before back to disk liveness
+    static constexpr int64_t LOAD_SAMPLE_MS         = 2000;     // resource telemetry cadence
+
+    // Peer scan: heartbeat files are read on a small pool, outside m_mutex
+    static constexpr size_t  SCAN_WORKERS         = 4;
+    static constexpr int64_t SCAN_FILE_TIMEOUT_MS = 1000;   // one read, once started
+    static constexpr int64_t SCAN_MAX_MS          = 3000;   // whole scan, queued reads included
+
 private:
     void threadFunc();
     void writeHeartbeat();
     void writeFinalHeartbeat();
     void scanPeers();
-    void detectStaleness();
-    void detectClockSkew();
+    void detectStaleness();             // caller holds m_mutex
+    void detectClockSkew();             // caller holds m_mutex
+    void sampleLoad();
+
+    // Scan I/O pool
+    struct ScanRead
+    {
+        std::string peerId;
+        std::filesystem::path path;
+    };
+    struct ScanResult
+    {
+        std::string peerId;
+        std::shared_ptr<const Heartbeat> hb;    // nullptr = missing / unreadable
+    };
+    void startScanPool();
+    void stopScanPool();
+    void scanWorkerFunc();
 
     Heartbeat buildHeartbeat() const;
     int64_t nowMs() const;
+    void noteChange();                  // caller holds m_mutex
+    bool diskHeartbeatThrottled() const;    // caller holds m_mutex
 
     // Config (protected by m_mutex)
     std::filesystem::path m_farmPath;
@@ -82,16 +141,47 @@ private:
     TimingConfig m_timing;
     std::vector<std::string> m_tags;
     bool m_isCoordinator = false;
+    bool m_isStandby = false;
+    uint64_t m_coordEpoch = 0;
+    uint16_t m_tcpPort = 0;
+    bool m_isShard = false;
+    int m_shardPending = 0;
+    std::string m_workFor;
+    std::string m_macAddress;
+    bool m_allowSleep = false;
 
     // Dynamic state (updated from main thread via setters)
     std::string m_nodeState = "active";
+    bool m_parked = false;              // reported as node_state "sleeping"
     std::string m_renderState = "idle";
     std::string m_activeJob;
     std::string m_activeFrames;
+    std::vector<std::string> m_activeJobs;
+    int m_renderSlots = 1;
+    int m_freeSlots = 1;
+    bool m_fastPathActive = false;
+    bool m_fieldsChanged = false;       // written out by the thread, coalesced
+    bool m_throttled = false;           // last cadence decision (for logging)
+    NodeLoad m_load;
+
+    ResourceSampler m_sampler;          // heartbeat thread only
 
     // State
     std::atomic<uint64_t> m_seq{0};
     std::map<std::string, NodeInfo> m_nodes;  // node_id -> info
+    uint64_t m_nodesVersion = 0;              // bumped by every change to m_nodes
+    mutable NodeSnapshotPtr m_nodeSnapshot = std::make_shared<const NodeSnapshot>();
+
+    // Scan I/O pool (guarded by m_scanMutex, never held with m_mutex)
+    std::vector<std::thread> m_scanThreads;
+    std::mutex m_scanMutex;
+    std::condition_variable m_scanCv;       // work queued / stopping
+    std::condition_variable m_scanDoneCv;   // a read finished
+    std::deque<ScanRead> m_scanQueue;
+    std::set<std::string> m_scanInFlight;   // queued or reading (a slow read blocks re-queueing)
+    std::map<std::string, std::chrono::steady_clock::time_point> m_scanStarted;
+    std::vector<ScanResult> m_scanResults;  // finished, incl. late ones from earlier scans
+    bool m_scanStopping = false;
 
     // Thread
     std::thread m_thread;
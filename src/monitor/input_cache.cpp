@@ -0,0 +1,398 @@
+#include "monitor/input_cache.h"
+#include "core/monitor_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// FNV-1a
+uint64_t hashString(const std::string& s)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : s)
+    {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+std::string mb(uint64_t bytes)
+{
+    return std::to_string(bytes / (1024 * 1024)) + " MB";
+}
+
+} // namespace
+
+InputCache::~InputCache()
+{
+    stop();
+}
+
+void InputCache::start(const fs::path& dir, uint64_t budgetBytes)
+{
+    if (m_thread.joinable())
+        return;
+
+    m_dir = dir;
+    m_budget = budgetBytes;
+    std::error_code ec;
+    fs::create_directories(m_dir, ec);
+    if (ec)
+    {
+        MonitorLog::instance().warn("cache", "Input cache dir unavailable: " + m_dir.string() + " (" + ec.message() + ")");
+        return;
+    }
+
+    loadExisting();
+    m_abort = false;
+    m_running = true;
+    m_thread = std::thread(&InputCache::threadFunc, this);
+    m_active = true;
+
+    MonitorLog::instance().info("cache", "Input cache at " + m_dir.string() + ": " +
+        std::to_string(m_stats.entries) + " entries, " + mb(m_stats.bytes) + " of " + mb(m_budget));
+}
+
+void InputCache::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+            return;
+        m_running = false;
+        m_queue.clear();
+    }
+    m_active = false;
+    m_abort = true;
+    m_cv.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_keyBySource.clear();
+    m_stats = {};
+}
+
+void InputCache::setBudget(uint64_t budgetBytes)
+{
+    std::vector<fs::path> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_budget = budgetBytes;
+        evictLocked({}, victims);
+    }
+    std::error_code ec;
+    for (const auto& v : victims)
+        fs::remove_all(v, ec);
+}
+
+InputCache::Status InputCache::request(const std::string& source)
+{
+    return enqueue(source, true);
+}
+
+void InputCache::prefetch(const std::string& source)
+{
+    enqueue(source, false);
+}
+
+std::optional<std::string> InputCache::localPath(const std::string& source)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto keyIt = m_keyBySource.find(source);
+    if (keyIt == m_keyBySource.end())
+        return std::nullopt;
+    auto it = m_entries.find(keyIt->second);
+    if (it == m_entries.end() || it->second.state != State::Ready)
+        return std::nullopt;
+
+    // Deleted behind our back: forget it, the next request fetches again
+    std::error_code ec;
+    if (!fs::is_regular_file(it->second.local, ec))
+    {
+        m_stats.bytes -= it->second.bytes;
+        --m_stats.entries;
+        m_entries.erase(it);
+        return std::nullopt;
+    }
+
+    it->second.lastUsedMs = nowMs();
+    ++m_stats.hits;
+    return it->second.local.string();
+}
+
+InputCache::Stats InputCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+InputCache::Status InputCache::enqueue(const std::string& source, bool urgent)
+{
+    if (source.empty() || !isRunning())
+        return Status::Unavailable;
+
+    // The stat is the only share access here; it also tells a changed source apart
+    uint64_t size = 0;
+    auto key = keyFor(source, size);
+    if (!key)
+        return Status::Unavailable;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running || size > m_budget)
+        return Status::Unavailable;
+    m_keyBySource[source] = *key;
+
+    auto it = m_entries.find(*key);
+    if (it != m_entries.end())
+    {
+        auto& e = it->second;
+        switch (e.state)
+        {
+        case State::Ready:
+            return Status::Ready;
+        case State::Copying:
+            return Status::Pending;
+        case State::Queued:
+            if (urgent)
+            {
+                auto q = std::find_if(m_queue.begin(), m_queue.end(),
+                    [&](const Fetch& f) { return f.key == *key; });
+                if (q != m_queue.end() && q != m_queue.begin())
+                {
+                    Fetch f = std::move(*q);
+                    m_queue.erase(q);
+                    m_queue.push_front(std::move(f));
+                }
+            }
+            return Status::Pending;
+        case State::Failed:
+            if (nowMs() - e.failedAtMs < RETRY_MS)
+                return Status::Unavailable;
+            e.state = State::Queued;
+            break;
+        }
+    }
+    else
+    {
+        m_entries[*key] = Entry{};
+    }
+
+    Fetch f{*key, fs::path(source)};
+    if (urgent)
+        m_queue.push_front(std::move(f));
+    else
+        m_queue.push_back(std::move(f));
+    m_cv.notify_one();
+    return Status::Pending;
+}
+
+void InputCache::threadFunc()
+{
+    while (true)
+    {
+        Fetch fetch;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+            if (!m_running)
+                return;
+            fetch = std::move(m_queue.front());
+            m_queue.pop_front();
+            auto it = m_entries.find(fetch.key);
+            if (it == m_entries.end())
+                continue;
+            it->second.state = State::Copying;
+        }
+
+        auto dir = m_dir / fetch.key;
+        auto local = dir / fetch.source.filename();
+        auto partial = local;
+        partial += ".partial";
+
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        auto startMs = nowMs();
+        bool ok = !ec && copyFile(fetch.source, partial);
+        if (ok)
+        {
+            fs::rename(partial, local, ec);
+            ok = !ec;
+        }
+        uint64_t bytes = ok ? fs::file_size(local, ec) : 0;
+        if (!ok)
+            fs::remove_all(dir, ec);
+
+        std::vector<fs::path> victims;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(fetch.key);
+            if (it == m_entries.end())
+                continue;
+            auto& e = it->second;
+            if (ok)
+            {
+                e.state = State::Ready;
+                e.local = local;
+                e.bytes = bytes;
+                e.lastUsedMs = nowMs();
+                ++m_stats.fetched;
+                m_stats.bytes += bytes;
+                ++m_stats.entries;
+                evictLocked(fetch.key, victims);
+            }
+            else
+            {
+                e.state = State::Failed;
+                e.failedAtMs = nowMs();
+                ++m_stats.failed;
+            }
+        }
+
+        if (ok)
+            MonitorLog::instance().info("cache", "Cached " + fetch.source.string() + " (" + mb(bytes) +
+                ", " + std::to_string((nowMs() - startMs) / 1000) + "s)");
+        else if (!m_abort)
+            MonitorLog::instance().warn("cache", "Failed to cache " + fetch.source.string() + ", chunks read the share");
+
+        for (const auto& v : victims)
+            fs::remove_all(v, ec);
+    }
+}
+
+// Block copy, so stop() doesn't wait out a multi-GB file
+bool InputCache::copyFile(const fs::path& src, const fs::path& dst)
+{
+    std::ifstream in(src, std::ios::binary);
+    std::ofstream out(dst, std::ios::binary | std::ios::trunc);
+    if (!in.is_open() || !out.is_open())
+        return false;
+
+    std::vector<char> buf(COPY_BLOCK);
+    while (in)
+    {
+        if (m_abort)
+            return false;
+        in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+        auto n = in.gcount();
+        if (n > 0 && !out.write(buf.data(), n))
+            return false;
+    }
+    if (in.bad())
+        return false;
+    out.close();
+    return !out.fail();
+}
+
+void InputCache::evictLocked(const std::string& keep, std::vector<fs::path>& victims)
+{
+    while (m_stats.bytes > m_budget)
+    {
+        auto oldest = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if (it->second.state != State::Ready || it->first == keep)
+                continue;
+            if (oldest == m_entries.end() || it->second.lastUsedMs < oldest->second.lastUsedMs)
+                oldest = it;
+        }
+        if (oldest == m_entries.end())
+            break;
+
+        MonitorLog::instance().info("cache", "Evicting " + oldest->second.local.filename().string() +
+            " (" + mb(oldest->second.bytes) + ")");
+        victims.push_back(m_dir / oldest->first);
+        m_stats.bytes -= oldest->second.bytes;
+        --m_stats.entries;
+        ++m_stats.evicted;
+        m_entries.erase(oldest);
+    }
+}
+
+// Rebuild the index from "{dir}/{key}/{file}"; last use is taken from the
+// entry dir's mtime, which the rename into place sets
+void InputCache::loadExisting()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_keyBySource.clear();
+    m_stats = {};
+
+    std::error_code ec;
+    auto fsNow = fs::file_time_type::clock::now();
+    auto now = nowMs();
+    for (auto& dirEntry : fs::directory_iterator(m_dir, ec))
+    {
+        if (!dirEntry.is_directory(ec))
+            continue;
+
+        Entry e;
+        for (auto& file : fs::directory_iterator(dirEntry.path(), ec))
+        {
+            if (!file.is_regular_file(ec))
+                continue;
+            if (file.path().extension() == ".partial")
+                continue;
+            e.local = file.path();
+            e.bytes = file.file_size(ec);
+        }
+        if (e.local.empty())
+        {
+            fs::remove_all(dirEntry.path(), ec);
+            continue;
+        }
+        // Only the finished copy stays
+        for (auto& file : fs::directory_iterator(dirEntry.path(), ec))
+        {
+            if (file.path() != e.local)
+                fs::remove_all(file.path(), ec);
+        }
+
+        auto age = fsNow - fs::last_write_time(dirEntry.path(), ec);
+        e.state = State::Ready;
+        e.lastUsedMs = now - std::chrono::duration_cast<std::chrono::milliseconds>(age).count();
+        m_stats.bytes += e.bytes;
+        ++m_stats.entries;
+        m_entries[dirEntry.path().filename().string()] = std::move(e);
+    }
+
+    std::vector<fs::path> victims;
+    evictLocked({}, victims);
+    for (const auto& v : victims)
+        fs::remove_all(v, ec);
+}
+
+std::optional<std::string> InputCache::keyFor(const fs::path& source, uint64_t& size)
+{
+    std::error_code ec;
+    size = fs::file_size(source, ec);
+    if (ec)
+        return std::nullopt;
+    auto mtime = fs::last_write_time(source, ec);
+    if (ec)
+        return std::nullopt;
+
+    auto identity = source.lexically_normal().string() + "|" + std::to_string(size) + "|" +
+                    std::to_string(mtime.time_since_epoch().count());
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hashString(identity)));
+    return std::string(key);
+}
+
+} // namespace SR
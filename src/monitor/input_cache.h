@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SR {
+
+// Node-local copies of job input files (scenes, projects), so chunks read
+// them from local disk instead of the share.
+//
+// Entries are keyed by source path + size + mtime: a changed source gets a
+// new entry and the old one ages out. One background thread copies into
+// "{dir}/{key}/{filename}" (the DCC sees the original file name) through a
+// ".partial" file renamed into place. Least recently used entries are
+// evicted once the cache passes its byte budget.
+//
+// Called from the main thread; request/prefetch only stat the source.
+class InputCache
+{
+public:
+    enum class Status { Ready, Pending, Unavailable };
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t fetched = 0;
+        uint64_t failed = 0;
+        uint64_t evicted = 0;
+        uint64_t bytes = 0;     // on disk, ready entries only
+        size_t entries = 0;
+    };
+
+    InputCache() = default;
+    ~InputCache();
+
+    InputCache(const InputCache&) = delete;
+    InputCache& operator=(const InputCache&) = delete;
+
+    // Picks up entries left by a previous run; stray .partial copies are removed
+    void start(const std::filesystem::path& dir, uint64_t budgetBytes);
+    void stop();    // abandons an in-progress copy
+    bool isRunning() const { return m_active; }
+    void setBudget(uint64_t budgetBytes);
+
+    // Ready: localPath() has the copy. Pending: queued or copying (a request
+    // jumps ahead of prefetches). Unavailable: missing, too large, or the copy
+    // failed recently — read the source.
+    Status request(const std::string& source);
+    void prefetch(const std::string& source);
+
+    // The ready copy for source, marked as just used
+    std::optional<std::string> localPath(const std::string& source);
+
+    Stats stats() const;
+
+    static constexpr int64_t  RETRY_MS   = 60000;  // after a failed copy
+    static constexpr size_t   COPY_BLOCK = 4 * 1024 * 1024;
+
+private:
+    enum class State { Queued, Copying, Ready, Failed };
+
+    struct Entry
+    {
+        State state = State::Queued;
+        std::filesystem::path local;
+        uint64_t bytes = 0;
+        int64_t lastUsedMs = 0;
+        int64_t failedAtMs = 0;
+    };
+
+    struct Fetch
+    {
+        std::string key;
+        std::filesystem::path source;
+    };
+
+    Status enqueue(const std::string& source, bool urgent);
+    void threadFunc();
+    bool copyFile(const std::filesystem::path& src, const std::filesystem::path& dst);
+    void evictLocked(const std::string& keep, std::vector<std::filesystem::path>& victims);
+    void loadExisting();
+
+    static std::optional<std::string> keyFor(const std::filesystem::path& source, uint64_t& size);
+
+    std::filesystem::path m_dir;
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Fetch> m_queue;
+    std::map<std::string, Entry> m_entries;             // by key
+    std::map<std::string, std::string> m_keyBySource;   // last key seen for a source path
+    uint64_t m_budget = 0;
+    bool m_running = false;
+    std::atomic<bool> m_abort{false};
+    std::atomic<bool> m_active{false};     // readable off the main thread
+    Stats m_stats;
+};
+
+} // namespace SR
@@ -1,8 +1,11 @@
 #include "monitor/job_manager.h"
 #include "core/atomic_file_io.h"
+#include "core/farm_storage.h"
+#include "core/read_cache.h"
 #include "core/platform.h"
 
 #include "core/monitor_log.h"
+#include "core/perf_counters.h"
 
 #include <algorithm>
 #include <chrono>
@@ -14,19 +17,56 @@ JobManager::~JobManager()
     stop();
 }
 
-void JobManager::start(const std::filesystem::path& farmPath)
+void JobManager::start(const std::filesystem::path& farmPath, std::vector<IndexedJob> seed)
 {
     if (m_running.load()) return;
 
     m_farmPath = farmPath;
+    m_jobCache.clear();
+    m_pendingDirs.clear();
+    m_jobsDirMtime = 0;
+    m_scansSinceVerify = 0;
 
-    // First scan synchronous — data available immediately
-    auto result = doScan();
+    if (seed.empty())
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_jobs = std::move(result);
+        // First scan synchronous — data available immediately
+        publish(doScan());
+        m_invalidated.store(false);
+    }
+    else
+    {
+        // Manifests never change, so the seeded ones stay; the first scan
+        // re-lists jobs/ (m_jobsDirMtime is unset) and only the state/ dirs
+        // whose mtime moved since the index was saved
+        for (auto& s : seed)
+        {
+            CachedJob cj;
+            cj.stateDirMtime = s.stateMtime;
+            cj.stateKnown = s.stateMtime != 0;
+            cj.info = std::move(s.info);
+            auto id = cj.info.manifest.job_id;
+            m_jobCache.emplace(std::move(id), std::move(cj));
+        }
+        publish(sortedJobs(), true);
+        m_invalidated.store(true);
+        MonitorLog::instance().info("job", "Restored " + std::to_string(m_jobCache.size()) +
+            " jobs from the local index, reconciling in the background");
     }
-    m_invalidated.store(false);
+
+    // Only job dirs, manifests and state/ matter here; claims, events and
+    // stdout churn constantly and are ignored
+    m_watch = FarmStorage::current().watch(farmPath / "jobs", true, [this](const std::filesystem::path& rel) {
+        if (rel.empty())
+        {
+            invalidate();
+            return;
+        }
+        if (rel.extension() == ".tmp")
+            return;
+        auto it = rel.begin();
+        if (++it == rel.end() || *it == "manifest.json" || *it == "state")
+            invalidate();
+    });
 
     m_running.store(true);
     m_thread = std::thread(&JobManager::threadFunc, this);
@@ -34,6 +74,7 @@ void JobManager::start(const std::filesystem::path& farmPath)
 
 void JobManager::stop()
 {
+    m_watch.reset();
     m_running.store(false);
     if (m_thread.joinable())
         m_thread.join();
@@ -54,7 +95,9 @@ void JobManager::threadFunc()
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastScan).count();
 
-        if (elapsed < SCAN_COOLDOWN_MS && !m_invalidated.load())
+        // Watched: changes arrive via invalidate(), the timer is only a safety net
+        int interval = (m_watch && m_watch->isActive()) ? DirWatcher::FALLBACK_POLL_MS : SCAN_COOLDOWN_MS;
+        if (elapsed < interval && !m_invalidated.load())
             continue;
 
         lastScan = now;
@@ -62,9 +105,7 @@ void JobManager::threadFunc()
 
         try
         {
-            auto result = doScan();
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_jobs = std::move(result);
+            publish(doScan());
         }
         catch (const std::exception& e)
         {
@@ -79,109 +120,272 @@ void JobManager::threadFunc()
 
 std::vector<JobInfo> JobManager::doScan()
 {
-    std::vector<JobInfo> jobs;
-
-    namespace fs = std::filesystem;
-    std::error_code ec;
+    SR_PERF_SCOPE("jobs.scan");
+    auto& storage = FarmStorage::current();
     auto jobsDir = m_farmPath / "jobs";
-    if (!fs::is_directory(jobsDir, ec))
-        return jobs;
+    auto jobsStat = storage.stat(jobsDir);
+    if (!jobsStat.isDir)
+    {
+        m_jobCache.clear();
+        m_pendingDirs.clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stateMtimes.clear();
+        return {};
+    }
+
+    // jobs/ itself only changes when a job directory is added or removed
+    auto jobsMtime = jobsStat.mtime;
+    bool verify = ++m_scansSinceVerify >= VERIFY_EVERY_SCANS;
+    bool relist = verify || jobsMtime == 0 || jobsMtime != m_jobsDirMtime;
+    if (verify)
+        m_scansSinceVerify = 0;
 
-    for (const auto& entry : fs::directory_iterator(jobsDir, ec))
+    if (relist)
     {
-        if (!entry.is_directory(ec))
-            continue;
+        m_jobsDirMtime = jobsMtime;
 
-        auto manifestPath = entry.path() / "manifest.json";
-        if (!fs::exists(manifestPath, ec))
-            continue;
+        std::unordered_set<std::string> present;
+        std::unordered_set<std::string> pending;
+        for (auto& entry : storage.list(jobsDir))
+        {
+            if (!entry.isDir)
+                continue;
+            auto id = std::move(entry.name);
+            present.insert(id);
+            if (m_jobCache.find(id) == m_jobCache.end())
+                pending.insert(std::move(id));
+        }
+        m_pendingDirs = std::move(pending);
 
-        auto data = AtomicFileIO::safeReadJson(manifestPath);
-        if (!data.has_value())
-            continue;
+        for (auto it = m_jobCache.begin(); it != m_jobCache.end(); )
+        {
+            if (present.count(it->first))
+                ++it;
+            else
+                it = m_jobCache.erase(it);
+        }
+    }
 
-        try
+    // New directories: the manifest may still be syncing, so keep retrying
+    for (auto it = m_pendingDirs.begin(); it != m_pendingDirs.end(); )
+    {
+        auto manifest = ReadCache::instance().read<JobManifest>(jobsDir / *it / "manifest.json");
+        if (!manifest)
         {
-            JobInfo info;
-            info.manifest = data.value().get<JobManifest>();
+            ++it;
+            continue;
+        }
+
+        CachedJob cj;
+        cj.info.manifest = *manifest;
+        m_jobCache.emplace(*it, std::move(cj));
+        it = m_pendingDirs.erase(it);
+    }
+
+    // Known jobs: one stat of state/ each; only a moved mtime costs a listing
+    for (auto it = m_jobCache.begin(); it != m_jobCache.end(); )
+    {
+        auto& cj = it->second;
+        auto stateDir = jobsDir / it->first / "state";
 
-            // Read latest state from state/ directory
-            auto stateDir = entry.path() / "state";
-            if (fs::is_directory(stateDir, ec))
+        auto st = storage.stat(stateDir);
+        auto mtime = st.mtime;
+        if (!st.isDir)
+        {
+            if (!storage.exists(jobsDir / it->first))
             {
-                // Collect state files, sort by filename descending (newest first)
-                std::vector<fs::path> stateFiles;
-                for (const auto& sf : fs::directory_iterator(stateDir, ec))
-                {
-                    if (sf.is_regular_file(ec) && sf.path().extension() == ".json")
-                        stateFiles.push_back(sf.path());
-                }
-
-                std::sort(stateFiles.begin(), stateFiles.end(),
-                    [](const fs::path& a, const fs::path& b) {
-                        return a.filename().string() > b.filename().string();
-                    });
-
-                // Read first valid state file
-                for (const auto& sf : stateFiles)
-                {
-                    auto stateData = AtomicFileIO::safeReadJson(sf);
-                    if (!stateData.has_value())
-                        continue;
-
-                    try
-                    {
-                        auto stateEntry = stateData.value().get<JobStateEntry>();
-                        info.current_state = stateEntry.state;
-                        info.current_priority = stateEntry.priority;
-                        break;
-                    }
-                    catch (...) { continue; }
-                }
+                it = m_jobCache.erase(it);   // removed since the last listing
+                continue;
             }
-
-            jobs.push_back(std::move(info));
+            ++it;
+            continue;
         }
-        catch (const std::exception& e)
+
+        // Stat before listing: an entry landing mid-listing moves the mtime again
+        if (verify || !cj.stateKnown || mtime != cj.stateDirMtime)
         {
-            MonitorLog::instance().error("job", "Failed to parse manifest: " + entry.path().string() + " - " + std::string(e.what()));
+            cj.stateDirMtime = mtime;
+            cj.stateKnown = readLatestState(stateDir, cj.info);
         }
+        ++it;
     }
 
+    std::unordered_map<std::string, int64_t> mtimes;
+    mtimes.reserve(m_jobCache.size());
+    for (const auto& [id, cj] : m_jobCache)
+    {
+        if (cj.stateKnown)
+            mtimes[id] = cj.stateDirMtime;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stateMtimes = std::move(mtimes);
+    }
+
+    return sortedJobs();
+}
+
+std::vector<JobInfo> JobManager::sortedJobs() const
+{
+    std::vector<JobInfo> jobs;
+    jobs.reserve(m_jobCache.size());
+    for (const auto& [id, cj] : m_jobCache)
+        jobs.push_back(cj.info);
+
     // Sort: priority desc, then submitted_at asc (oldest first = FIFO within same priority)
     std::sort(jobs.begin(), jobs.end(),
         [](const JobInfo& a, const JobInfo& b) {
             if (a.current_priority != b.current_priority)
                 return a.current_priority > b.current_priority;
-            return a.manifest.submitted_at_ms < b.manifest.submitted_at_ms;
+            if (a.manifest.submitted_at_ms != b.manifest.submitted_at_ms)
+                return a.manifest.submitted_at_ms < b.manifest.submitted_at_ms;
+            return a.manifest.job_id < b.manifest.job_id;
         });
 
     return jobs;
 }
 
-std::string JobManager::submitJob(const std::filesystem::path& farmPath,
-                                  const JobManifest& manifest, int priority)
+bool JobManager::readLatestState(const std::filesystem::path& stateDir, JobInfo& info)
+{
+    namespace fs = std::filesystem;
+
+    // Names only here; after compaction the directory holds a handful of files
+    std::vector<fs::path> entries;
+    bool hasRollup = false;
+    bool hasLegacyRollup = false;
+    for (const auto& sf : FarmStorage::current().list(stateDir))
+    {
+        if (sf.isDir || !sf.name.ends_with(".json"))
+            continue;
+        if (sf.name == STATE_ROLLUP_NAME)
+            hasRollup = true;
+        else if (sf.name == STATE_ROLLUP_LEGACY_NAME)
+            hasLegacyRollup = true;
+        else
+            entries.push_back(stateDir / sf.name);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+        [](const fs::path& a, const fs::path& b) {
+            return a.filename().string() > b.filename().string();
+        });
+
+    std::shared_ptr<const JobStateRollup> rollup;
+    if (hasRollup)
+        rollup = ReadCache::instance().read<JobStateRollup>(stateDir / STATE_ROLLUP_NAME);
+
+    // Fast path: only entries named after what the roll-up covers get parsed.
+    // Without a readable roll-up this is the full newest-first scan.
+    std::shared_ptr<const JobStateEntry> newest;
+    std::string newestName;
+    for (const auto& sf : entries)
+    {
+        auto name = sf.filename().string();
+        if (rollup && name <= rollup->covers)
+            break;
+
+        newest = ReadCache::instance().read<JobStateEntry>(sf);
+        if (newest)
+        {
+            newestName = std::move(name);
+            break;
+        }
+    }
+
+    const JobStateEntry* latest = newest ? newest.get() : (rollup ? &rollup->entry : nullptr);
+    if (!latest)
+        return false;
+
+    info.current_state = latest->state;
+    info.current_priority = latest->priority;
+    info.state_timestamp_ms = latest->timestamp_ms;
+
+    // The old roll-up name sorted above the entries and would shadow them
+    if (m_compactStates.load() && hasLegacyRollup)
+    {
+        auto legacy = stateDir / STATE_ROLLUP_LEGACY_NAME;
+        if (FarmStorage::current().remove(legacy))
+            ReadCache::instance().invalidate(legacy);
+    }
+
+    if (m_compactStates.load() && newest && entries.size() >= STATE_COMPACT_MIN_ENTRIES)
+        compactStateDir(stateDir, entries, *newest, newestName, rollup.get());
+
+    return true;
+}
+
+void JobManager::compactStateDir(const std::filesystem::path& stateDir,
+                                 const std::vector<std::filesystem::path>& entries,
+                                 const JobStateEntry& newest, const std::string& newestName,
+                                 const JobStateRollup* rollup)
 {
     namespace fs = std::filesystem;
-    std::error_code ec;
+
+    if (!rollup || rollup->covers < newestName)
+    {
+        JobStateRollup next;
+        next.entry = newest;
+        next.covers = newestName;
+        nlohmann::json j = next;
+        if (!AtomicFileIO::writeJson(stateDir / STATE_ROLLUP_NAME, j, FileClass::State))
+        {
+            MonitorLog::instance().warn("job", "Failed to write state roll-up in " + stateDir.string());
+            return;
+        }
+    }
+
+    // Entry names start with their write timestamp; only covered entries past
+    // the settle window go, and the newest entry always stays
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    int pruned = 0;
+    for (const auto& sf : entries)
+    {
+        auto name = sf.filename().string();
+        if (name >= newestName)
+            continue;
+
+        int64_t writtenMs = 0;
+        try { writtenMs = std::stoll(name); }
+        catch (...) { continue; }
+        if (now - writtenMs < STATE_SETTLE_MS)
+            continue;
+
+        if (FarmStorage::current().remove(sf))
+        {
+            ReadCache::instance().invalidate(sf);
+            ++pruned;
+        }
+    }
+
+    if (pruned > 0)
+        MonitorLog::instance().info("job", "Compacted " + std::to_string(pruned) +
+            " state entries in " + stateDir.parent_path().filename().string());
+}
+
+std::string JobManager::submitJob(const std::filesystem::path& farmPath,
+                                  const JobManifest& manifest, int priority,
+                                  bool rescan)
+{
+    auto& storage = FarmStorage::current();
 
     auto jobsDir = farmPath / "jobs";
     auto jobDir = jobsDir / manifest.job_id;
 
     // Create directories
-    fs::create_directories(jobDir / "state", ec);
-    if (ec)
+    if (!storage.createDirectories(jobDir / "state"))
     {
-        MonitorLog::instance().error("job", "Failed to create job dirs: " + ec.message());
+        MonitorLog::instance().error("job", "Failed to create job dirs in " + jobDir.string());
         return {};
     }
-    fs::create_directories(jobDir / "claims", ec);
-    fs::create_directories(jobDir / "events", ec);
-    fs::create_directories(jobDir / "stdout", ec);
+    storage.createDirectories(jobDir / "claims");
+    storage.createDirectories(jobDir / "events");
+    storage.createDirectories(jobDir / "stdout");
 
     // Check manifest doesn't already exist (race protection)
     auto manifestPath = jobDir / "manifest.json";
-    if (fs::exists(manifestPath, ec))
+    if (storage.exists(manifestPath))
     {
         MonitorLog::instance().error("job", "Manifest already exists: " + manifestPath.string());
         return {};
@@ -208,14 +412,15 @@ std::string JobManager::submitJob(const std::filesystem::path& farmPath,
 
     auto stateFilename = std::to_string(timestampMs) + "_" + manifest.submitted_by + ".json";
     nlohmann::json stateJson = state;
-    if (!AtomicFileIO::writeJson(jobDir / "state" / stateFilename, stateJson))
+    if (!AtomicFileIO::writeJson(jobDir / "state" / stateFilename, stateJson, FileClass::State))
     {
         MonitorLog::instance().error("job", "Failed to write initial state");
         return {};
     }
 
     // Force rescan on next scan() call
-    invalidate();
+    if (rescan)
+        invalidate();
 
     MonitorLog::instance().info("job", "Job submitted: " + manifest.job_id);
     return manifest.job_id;
@@ -227,8 +432,6 @@ bool JobManager::writeStateEntry(const std::filesystem::path& farmPath,
                                   int priority,
                                   const std::string& nodeId)
 {
-    namespace fs = std::filesystem;
-
     auto now = std::chrono::system_clock::now();
     auto timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()).count();
@@ -240,12 +443,11 @@ bool JobManager::writeStateEntry(const std::filesystem::path& farmPath,
     entry.timestamp_ms = timestampMs;
 
     auto stateDir = farmPath / "jobs" / jobId / "state";
-    std::error_code ec;
-    fs::create_directories(stateDir, ec);
+    FarmStorage::current().createDirectories(stateDir);
 
     auto stateFilename = std::to_string(timestampMs) + "_" + nodeId + ".json";
     nlohmann::json j = entry;
-    if (!AtomicFileIO::writeJson(stateDir / stateFilename, j))
+    if (!AtomicFileIO::writeJson(stateDir / stateFilename, j, FileClass::State))
     {
         MonitorLog::instance().error("job", "Failed to write state entry for " + jobId);
         return false;
@@ -257,10 +459,66 @@ bool JobManager::writeStateEntry(const std::filesystem::path& farmPath,
     return true;
 }
 
-std::vector<JobInfo> JobManager::getJobSnapshot() const
+void JobManager::publish(std::vector<JobInfo>&& jobs, bool provisional)
+{
+    JobSnapshotPtr current;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        current = m_snapshot;
+    }
+
+    // Manifests are immutable once written, so id + state + priority is
+    // enough to tell whether anything changed
+    auto snap = std::make_shared<JobSnapshot>();
+    snap->jobs = std::move(jobs);
+    snap->index.reserve(snap->jobs.size());
+    for (size_t i = 0; i < snap->jobs.size(); ++i)
+    {
+        const auto& job = snap->jobs[i];
+        snap->index[job.manifest.job_id] = i;
+
+        const JobInfo* prev = current->find(job.manifest.job_id);
+        if (!prev)
+            snap->added.push_back(job.manifest.job_id);
+        else if (prev->current_state != job.current_state ||
+                 prev->current_priority != job.current_priority)
+            snap->changed.push_back(job.manifest.job_id);
+    }
+    for (const auto& job : current->jobs)
+    {
+        if (snap->index.find(job.manifest.job_id) == snap->index.end())
+            snap->removed.push_back(job.manifest.job_id);
+    }
+
+    // A provisional list is always replaced, even by an identical one
+    if (current->version != 0 && !current->provisional &&
+        snap->added.empty() && snap->changed.empty() && snap->removed.empty())
+        return;
+
+    snap->version = current->version + 1;
+    snap->provisional = provisional;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshot = std::move(snap);
+}
+
+JobSnapshotPtr JobManager::getJobSnapshot() const
 {
     std::lock_guard<std::mutex> lock(m_mutex);
-    return m_jobs;
+    return m_snapshot;
+}
+
+std::vector<JobManager::IndexedJob> JobManager::indexedJobs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<IndexedJob> out;
+    out.reserve(m_snapshot->jobs.size());
+    for (const auto& job : m_snapshot->jobs)
+    {
+        auto it = m_stateMtimes.find(job.manifest.job_id);
+        out.push_back({job, it != m_stateMtimes.end() ? it->second : 0});
+    }
+    return out;
 }
 
 void JobManager::invalidate()
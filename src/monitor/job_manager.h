@@ -1,10 +1,15 @@
 #pragma once
 
 #include "core/job_types.h"
+#include "core/dir_watcher.h"
+#include "core/farm_storage.h"
 
 #include <filesystem>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
 #include <chrono>
 #include <mutex>
 #include <thread>
@@ -12,6 +17,33 @@
 
 namespace SR {
 
+// Immutable job list published by JobManager. The version only advances when a
+// scan actually changes something, so consumers can skip work on a repeat.
+struct JobSnapshot
+{
+    uint64_t version = 0;
+    std::vector<JobInfo> jobs;                          // priority desc, submitted_at asc
+    std::unordered_map<std::string, size_t> index;      // job_id -> position in jobs
+
+    // What this version changed relative to version - 1 (a consumer that
+    // skipped versions must treat the whole list as changed)
+    std::vector<std::string> added;
+    std::vector<std::string> changed;                   // state or priority
+    std::vector<std::string> removed;
+
+    // Restored from the local farm index and not yet checked against the
+    // share: fine to show, not to dispatch from (it can miss newer jobs)
+    bool provisional = false;
+
+    const JobInfo* find(const std::string& jobId) const
+    {
+        auto it = index.find(jobId);
+        return it != index.end() ? &jobs[it->second] : nullptr;
+    }
+};
+
+using JobSnapshotPtr = std::shared_ptr<const JobSnapshot>;
+
 class JobManager
 {
 public:
@@ -21,17 +53,32 @@ public:
     JobManager(const JobManager&) = delete;
     JobManager& operator=(const JobManager&) = delete;
 
-    // Start background scanning thread. First scan is synchronous.
-    void start(const std::filesystem::path& farmPath);
+    // A job as the local farm index keeps it: state/ mtime included, so the
+    // reconciling scan only re-lists jobs whose state moved
+    struct IndexedJob
+    {
+        JobInfo info;
+        int64_t stateMtime = 0;     // FarmStorage::stat ticks
+    };
+
+    // Start background scanning thread. Without a seed the first scan is
+    // synchronous; with one, the seed is published (provisional) right away
+    // and the first scan runs in the background.
+    void start(const std::filesystem::path& farmPath, std::vector<IndexedJob> seed = {});
 
     // Stop background thread.
     void stop();
 
-    // Thread-safe snapshot for UI / DispatchManager
-    std::vector<JobInfo> getJobSnapshot() const;
+    // Thread-safe snapshot for UI / DispatchManager (cheap: shares the published list)
+    JobSnapshotPtr getJobSnapshot() const;
 
+    // The current snapshot with state/ mtimes, for saving the farm index
+    std::vector<IndexedJob> indexedJobs() const;
+
+    // rescan = false leaves invalidate() to the caller (a batch rescans once)
     std::string submitJob(const std::filesystem::path& farmPath,
-                          const JobManifest& manifest, int priority);
+                          const JobManifest& manifest, int priority,
+                          bool rescan = true);
 
     bool writeStateEntry(const std::filesystem::path& farmPath,
                          const std::string& jobId,
@@ -41,17 +88,62 @@ public:
 
     void invalidate();
 
+    // Coordinator only: roll state/ up into 0-rollup.json and prune old entries
+    void setStateCompaction(bool enabled) { m_compactStates.store(enabled); }
+
 private:
     void threadFunc();
     std::vector<JobInfo> doScan();
+    void publish(std::vector<JobInfo>&& jobs, bool provisional = false);
+    std::vector<JobInfo> sortedJobs() const;    // m_jobCache in snapshot order
+
+    // Newest valid entry in jobs/{id}/state: the roll-up plus any entries
+    // named after what it covers. Returns false if none was readable.
+    bool readLatestState(const std::filesystem::path& stateDir, JobInfo& info);
+
+    // Fold the newest entry into the roll-up and drop covered entries past the
+    // settle window. entries: state files other than the roll-up, newest first.
+    void compactStateDir(const std::filesystem::path& stateDir,
+                         const std::vector<std::filesystem::path>& entries,
+                         const JobStateEntry& newest, const std::string& newestName,
+                         const JobStateRollup* rollup);
+
+    // Scan-thread cache. Manifests are immutable after submission, so a job's
+    // manifest is read once; state/ is re-listed only when its mtime moves.
+    struct CachedJob
+    {
+        JobInfo info;
+        int64_t stateDirMtime = 0;
+        bool stateKnown = false;
+    };
+    std::unordered_map<std::string, CachedJob> m_jobCache;
+    std::unordered_set<std::string> m_pendingDirs;      // job dirs whose manifest hasn't synced yet
+    int64_t m_jobsDirMtime = 0;
+    int m_scansSinceVerify = 0;
+
+    // Directory mtimes can be coarse (FAT, some sync clients), so every
+    // VERIFY_EVERY_SCANS scans everything is re-listed regardless
+    static constexpr int VERIFY_EVERY_SCANS = 20;
 
     std::filesystem::path m_farmPath;
-    std::vector<JobInfo> m_jobs;
+    JobSnapshotPtr m_snapshot = std::make_shared<const JobSnapshot>();
+    std::unordered_map<std::string, int64_t> m_stateMtimes;    // by job id, as of the last scan
     mutable std::mutex m_mutex;
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_invalidated{true};
+    std::atomic<bool> m_compactStates{false};
     std::thread m_thread;
+    std::unique_ptr<FarmStorage::Watch> m_watch;    // jobs/ tree; wakes the scan on manifest/state changes
     static constexpr int SCAN_COOLDOWN_MS = 3000;
+
+    // Compact once a state/ holds this many entries; entries newer than the
+    // settle window are kept so late-syncing peers never miss one
+    static constexpr size_t STATE_COMPACT_MIN_ENTRIES = 16;
+    static constexpr int64_t STATE_SETTLE_MS = 10 * 60 * 1000;
+    // Sorts below every timestamped entry, so a reader that takes the newest
+    // name first only falls back to it when no entry parses
+    static constexpr const char* STATE_ROLLUP_NAME = "0-rollup.json";
+    static constexpr const char* STATE_ROLLUP_LEGACY_NAME = "current.json";  // sorted above them; ignored, coordinator removes it
 };
 
 } // namespace SR
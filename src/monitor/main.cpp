@@ -2,6 +2,7 @@
 #include "monitor/ui/style.h"
 #include "core/system_tray.h"
 #include "core/single_instance.h"
+#include "core/perf_counters.h"
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
@@ -10,9 +11,10 @@
 #include <imgui_impl_opengl3.h>
 #include <nfd.h>
 
+#include <algorithm>
 #include <iostream>
+#include <cstdint>
 #include <cstring>
-#include <thread>
 #include <chrono>
 
 #ifdef _WIN32
@@ -38,6 +40,29 @@ static void glfwErrorCallback(int error, const char* description)
     std::cerr << "[GLFW] Error " << error << ": " << description << std::endl;
 }
 
+// ─── Frame pacing ───────────────────────────────────────────────────────────
+
+static constexpr int FARM_TICK_MS = 50;             // MonitorApp::update() cadence, drawn or not
+static constexpr int IDLE_REDRAW_MS = 1000;         // elapsed times and clocks keep moving
+static constexpr int INPUT_SETTLE_FRAMES = 3;       // hover, popups and layout catch up after input
+
+// Input on the main window; bumped by callbacks the ImGui backend chains to
+static uint64_t s_inputEvents = 0;
+
+static void installInputCallbacks(GLFWwindow* window)
+{
+    // Must run before ImGui_ImplGlfw_InitForOpenGL, which calls these after its own
+    glfwSetCursorPosCallback(window, [](GLFWwindow*, double, double) { ++s_inputEvents; });
+    glfwSetMouseButtonCallback(window, [](GLFWwindow*, int, int, int) { ++s_inputEvents; });
+    glfwSetScrollCallback(window, [](GLFWwindow*, double, double) { ++s_inputEvents; });
+    glfwSetKeyCallback(window, [](GLFWwindow*, int, int, int, int) { ++s_inputEvents; });
+    glfwSetCharCallback(window, [](GLFWwindow*, unsigned int) { ++s_inputEvents; });
+    glfwSetWindowFocusCallback(window, [](GLFWwindow*, int) { ++s_inputEvents; });
+    glfwSetCursorEnterCallback(window, [](GLFWwindow*, int) { ++s_inputEvents; });
+    glfwSetWindowSizeCallback(window, [](GLFWwindow*, int, int) { ++s_inputEvents; });
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow*) { ++s_inputEvents; });
+}
+
 int main(int argc, char* argv[])
 {
 #ifdef _WIN32
@@ -139,6 +164,7 @@ int main(int argc, char* argv[])
         style.Colors[ImGuiCol_WindowBg].w = 1.0f;
     }
 
+    installInputCallbacks(window);
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glslVersion);
 
@@ -194,6 +220,7 @@ int main(int argc, char* argv[])
     tray.onShowWindow = [&]() {
         glfwShowWindow(window);
         glfwFocusWindow(window);
+        ++s_inputEvents;
     };
 
     tray.onStopResume = [&]() {
@@ -208,19 +235,66 @@ int main(int argc, char* argv[])
     };
 
     // --- Main loop — exit controlled by app, not GLFW ---
+    // The farm ticks every FARM_TICK_MS. With low_power_ui the loop sleeps in
+    // glfwWaitEventsTimeout in between and redraws only after input, when
+    // app.uiRevision() moves, or every IDLE_REDRAW_MS; without it every
+    // iteration draws (vsync-paced) as before. Hidden or minimized, nothing draws.
+    using Clock = std::chrono::steady_clock;
+    auto nextTick = Clock::now();
+    auto lastDraw = Clock::time_point{};
+    uint64_t drawnRevision = 0;
+    int settleFrames = INPUT_SETTLE_FRAMES;
+    bool wasVisible = false;
+    auto& frameProbe = SR::PerfCounters::instance().probe("ui.frame");
+
     while (!app.shouldExit())
     {
-        glfwPollEvents();
-        app.update();
+        bool lowPower = app.config().low_power_ui;
+        bool visible = glfwGetWindowAttrib(window, GLFW_VISIBLE) != 0 &&
+                       glfwGetWindowAttrib(window, GLFW_ICONIFIED) == 0;
+
+        // Wait for input or the next deadline, unless a frame is due right away
+        uint64_t inputsBefore = s_inputEvents;
+        auto now = Clock::now();
+        if (visible && (!lowPower || settleFrames > 0))
+        {
+            glfwPollEvents();
+        }
+        else
+        {
+            auto deadline = nextTick;
+            if (visible)
+                deadline = (std::min)(deadline, lastDraw + std::chrono::milliseconds(IDLE_REDRAW_MS));
+            if (deadline > now)
+            {
+                glfwWaitEventsTimeout(std::chrono::duration<double>(deadline - now).count());
+                // Woken early: an event, possibly on a secondary viewport
+                if (Clock::now() < deadline)
+                    ++s_inputEvents;
+            }
+            else
+            {
+                glfwPollEvents();
+            }
+        }
+        if (s_inputEvents != inputsBefore || (visible && !wasVisible))
+            settleFrames = INPUT_SETTLE_FRAMES;
+        wasVisible = visible;
 
-        bool visible = glfwGetWindowAttrib(window, GLFW_VISIBLE) != 0;
+        now = Clock::now();
+        if (!(lowPower && visible) || now >= nextTick)
+        {
+            // A visible window without low_power_ui ticks once per drawn frame, as before
+            app.update();
+            nextTick = now + std::chrono::milliseconds(FARM_TICK_MS);
+        }
 
         // Auto-show window when exit dialog needs to display
-        if (app.isExitPending() && !visible)
+        if (app.isExitPending() && !glfwGetWindowAttrib(window, GLFW_VISIBLE))
         {
             glfwShowWindow(window);
             glfwFocusWindow(window);
-            visible = true;
+            settleFrames = INPUT_SETTLE_FRAMES;
         }
 
         // Update tray icon
@@ -229,39 +303,50 @@ int main(int argc, char* argv[])
         tray.setStatusText(app.trayStatusText());
         tray.setNodeActive(app.nodeState() == SR::NodeState::Active);
 
-        if (visible)
-        {
-            // Full ImGui frame + render + swap
-            ImGui_ImplOpenGL3_NewFrame();
-            ImGui_ImplGlfw_NewFrame();
-            ImGui::NewFrame();
-
-            app.renderUI();
-
-            ImGui::Render();
-            int displayW, displayH;
-            glfwGetFramebufferSize(window, &displayW, &displayH);
-            glViewport(0, 0, displayW, displayH);
-            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT);
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-
-            // Update additional platform windows
-            if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
-            {
-                GLFWwindow* backupCtx = glfwGetCurrentContext();
-                ImGui::UpdatePlatformWindows();
-                ImGui::RenderPlatformWindowsDefault();
-                glfwMakeContextCurrent(backupCtx);
-            }
-
-            glfwSwapBuffers(window);
-        }
-        else
+        if (!visible)
+            continue;
+
+        uint64_t revision = app.uiRevision();
+        if (lowPower && settleFrames == 0 && revision == drawnRevision &&
+            now - lastDraw < std::chrono::milliseconds(IDLE_REDRAW_MS))
+            continue;
+
+        // Full ImGui frame + render + swap
+        auto frameStart = Clock::now();
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+
+        app.renderUI();
+
+        // Something mid-interaction (drag, text field) keeps frames coming
+        if (settleFrames > 0)
+            --settleFrames;
+        if (ImGui::IsAnyItemActive() || io.WantTextInput)
+            settleFrames = (std::max)(settleFrames, 1);
+
+        ImGui::Render();
+        int displayW, displayH;
+        glfwGetFramebufferSize(window, &displayW, &displayH);
+        glViewport(0, 0, displayW, displayH);
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+        // Update additional platform windows
+        if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
         {
-            // Window hidden — sleep to save CPU, background threads keep running
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            GLFWwindow* backupCtx = glfwGetCurrentContext();
+            ImGui::UpdatePlatformWindows();
+            ImGui::RenderPlatformWindowsDefault();
+            glfwMakeContextCurrent(backupCtx);
         }
+
+        // Before the swap, which mostly waits on vsync
+        frameProbe.record(Clock::now() - frameStart);
+        glfwSwapBuffers(window);
+        lastDraw = now;
+        drawnRevision = revision;
     }
 
     // --- Cleanup ---
@@ -0,0 +1,357 @@
+#include "monitor/metrics_exporter.h"
+#include "core/atomic_file_io.h"
+#include "core/monitor_log.h"
+#include "core/perf_counters.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct NodeStats
+{
+    int total = 0, alive = 0, idle = 0, rendering = 0, draining = 0, sleeping = 0;
+    int slots = 0, freeSlots = 0;
+};
+
+NodeStats nodeStats(const std::vector<NodeInfo>& nodes)
+{
+    NodeStats s;
+    for (const auto& n : nodes)
+    {
+        ++s.total;
+        if (n.isParked())
+            ++s.sleeping;
+        if (n.isDead)
+            continue;
+        const auto& hb = n.heartbeat;
+        ++s.alive;
+        s.slots += hb.render_slots;
+        s.freeSlots += hb.free_slots;
+        if (hb.node_state == "draining")
+            ++s.draining;
+        if (hb.render_state == "rendering")
+            ++s.rendering;
+        else if (hb.node_state == "active")
+            ++s.idle;
+    }
+    return s;
+}
+
+std::map<std::string, int> jobStateCounts(const JobSnapshot& jobs)
+{
+    std::map<std::string, int> counts{
+        {"active", 0}, {"paused", 0}, {"completed", 0}, {"failed", 0}, {"cancelled", 0}};
+    for (const auto& j : jobs.jobs)
+        ++counts[j.current_state];
+    return counts;
+}
+
+// Prometheus label value: backslash, quote and newline escaped
+std::string escapeLabel(const std::string& value)
+{
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value)
+    {
+        if (c == '\\' || c == '"')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (c == '\n')
+        {
+            out += "\\n";
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    return out;
+}
+
+class PromWriter
+{
+public:
+    void family(const char* name, const char* type, const char* help)
+    {
+        m_out += "# HELP ";
+        m_out += name;
+        m_out += ' ';
+        m_out += help;
+        m_out += "\n# TYPE ";
+        m_out += name;
+        m_out += ' ';
+        m_out += type;
+        m_out += '\n';
+    }
+
+    // labels: already formatted, e.g. state="active"
+    void sample(const char* name, double value, const std::string& labels = {})
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.6g", value);
+        m_out += name;
+        if (!labels.empty())
+        {
+            m_out += '{';
+            m_out += labels;
+            m_out += '}';
+        }
+        m_out += ' ';
+        m_out += buf;
+        m_out += '\n';
+    }
+
+    std::string take() { return std::move(m_out); }
+
+private:
+    std::string m_out;
+};
+
+} // namespace
+
+void MetricsExporter::configure(const std::string& path, int intervalSec)
+{
+    fs::path next = path;
+    if (next != m_path)
+    {
+        m_lastWrite = {};
+        m_warned = false;
+    }
+    m_path = std::move(next);
+    m_json = m_path.extension() == ".json";
+    m_interval = std::chrono::milliseconds(
+        int64_t((std::max)(intervalSec > 0 ? intervalSec : DEFAULT_INTERVAL_SEC, 1)) * 1000);
+}
+
+void MetricsExporter::observeTables(const std::map<std::string, DispatchTable>& changed,
+                                    const std::vector<std::string>& released,
+                                    const JobSnapshot& jobs, int64_t nowMs)
+{
+    if (!enabled())
+        return;
+
+    for (const auto& jobId : released)
+        m_jobChunks.erase(jobId);
+
+    for (const auto& [jobId, table] : changed)
+    {
+        JobChunks jc;
+        for (const auto& c : table.chunks)
+        {
+            switch (c.state)
+            {
+                case DispatchState::Pending:    ++jc.pending; break;
+                case DispatchState::Assigned:   ++jc.rendering; break;
+                case DispatchState::Completed:  ++jc.completed; break;
+                case DispatchState::Failed:     ++jc.failed; break;
+            }
+            if (c.retry_count > 0)
+            {
+                ++jc.retried;
+                jc.retries += uint64_t(c.retry_count);
+            }
+            if (c.state == DispatchState::Completed && c.assigned_at_ms > 0 &&
+                c.completed_at_ms >= c.assigned_at_ms &&
+                nowMs - c.completed_at_ms <= TURNAROUND_WINDOW_MS)
+            {
+                jc.turnaround.emplace_back(c.completed_at_ms,
+                                           double(c.completed_at_ms - c.assigned_at_ms) / 1000.0);
+            }
+        }
+        m_jobChunks[jobId] = std::move(jc);
+    }
+
+    ChunkStats s;
+    std::vector<double> turnaround;
+    double turnaroundSum = 0.0;
+    for (const auto& [jobId, jc] : m_jobChunks)
+    {
+        const auto* job = jobs.find(jobId);
+        s.pending += jc.pending;
+        if (job && job->current_state == "active")
+            s.queued += jc.pending;
+        s.rendering += jc.rendering;
+        s.completed += jc.completed;
+        s.failed += jc.failed;
+        s.retried += jc.retried;
+        s.retries += jc.retries;
+        for (const auto& [completedAtMs, sec] : jc.turnaround)
+        {
+            if (nowMs - completedAtMs > TURNAROUND_WINDOW_MS)
+                continue;
+            turnaround.push_back(sec);
+            turnaroundSum += sec;
+        }
+    }
+
+    s.recent = int(turnaround.size());
+    if (!turnaround.empty())
+    {
+        std::sort(turnaround.begin(), turnaround.end());
+        s.turnaroundP50Sec = turnaround[turnaround.size() / 2];
+        s.turnaroundP90Sec = turnaround[(std::min)(turnaround.size() - 1, turnaround.size() * 9 / 10)];
+        s.turnaroundMeanSec = turnaroundSum / double(turnaround.size());
+    }
+
+    m_chunks = s;
+    m_hasChunks = true;
+}
+
+void MetricsExporter::update(const std::vector<NodeInfo>& nodes, const JobSnapshot& jobs,
+                             bool isCoordinator)
+{
+    if (!enabled())
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (m_lastWrite != std::chrono::steady_clock::time_point{} && now - m_lastWrite < m_interval)
+        return;
+    m_lastWrite = now;
+
+    std::string text = m_json ? formatJson(nodes, jobs, isCoordinator)
+                              : formatPrometheus(nodes, jobs, isCoordinator);
+
+    std::error_code ec;
+    if (m_path.has_parent_path())
+        fs::create_directories(m_path.parent_path(), ec);
+    if (AtomicFileIO::writeText(m_path, text))
+    {
+        m_warned = false;
+    }
+    else if (!m_warned)
+    {
+        MonitorLog::instance().warn("farm", "Metrics export to " + m_path.string() + " failed");
+        m_warned = true;
+    }
+}
+
+std::string MetricsExporter::formatPrometheus(const std::vector<NodeInfo>& nodes,
+                                              const JobSnapshot& jobs, bool isCoordinator) const
+{
+    PromWriter w;
+
+    w.family("sr_coordinator", "gauge", "1 if this node runs dispatch");
+    w.sample("sr_coordinator", isCoordinator ? 1 : 0);
+
+    w.family("sr_jobs", "gauge", "Jobs by state");
+    for (const auto& [state, count] : jobStateCounts(jobs))
+        w.sample("sr_jobs", count, "state=\"" + escapeLabel(state) + "\"");
+
+    auto ns = nodeStats(nodes);
+    w.family("sr_nodes", "gauge", "Known nodes by state (alive ones are also counted as idle or rendering)");
+    w.sample("sr_nodes", ns.total, "state=\"known\"");
+    w.sample("sr_nodes", ns.alive, "state=\"alive\"");
+    w.sample("sr_nodes", ns.idle, "state=\"idle\"");
+    w.sample("sr_nodes", ns.rendering, "state=\"rendering\"");
+    w.sample("sr_nodes", ns.draining, "state=\"draining\"");
+    w.sample("sr_nodes", ns.sleeping, "state=\"sleeping\"");
+    w.family("sr_render_slots", "gauge", "Render slots on alive nodes");
+    w.sample("sr_render_slots", ns.slots, "state=\"total\"");
+    w.sample("sr_render_slots", ns.freeSlots, "state=\"free\"");
+
+    w.family("sr_node_alive", "gauge", "1 while the node's heartbeat advances");
+    for (const auto& n : nodes)
+    {
+        w.sample("sr_node_alive", n.isDead ? 0 : 1,
+                 "node=\"" + escapeLabel(n.heartbeat.node_id) + "\",host=\"" +
+                 escapeLabel(n.heartbeat.hostname) + "\"");
+    }
+
+    if (m_hasChunks)
+    {
+        const auto& c = m_chunks;
+        w.family("sr_chunks", "gauge", "Dispatch chunks by state, all jobs");
+        w.sample("sr_chunks", c.pending, "state=\"pending\"");
+        w.sample("sr_chunks", c.rendering, "state=\"rendering\"");
+        w.sample("sr_chunks", c.completed, "state=\"completed\"");
+        w.sample("sr_chunks", c.failed, "state=\"failed\"");
+        w.family("sr_queue_depth", "gauge", "Pending chunks of active jobs");
+        w.sample("sr_queue_depth", c.queued);
+        w.family("sr_chunks_retried", "gauge", "Chunks that needed at least one retry");
+        w.sample("sr_chunks_retried", c.retried);
+        w.family("sr_chunk_retries", "gauge", "Retries summed over all chunks");
+        w.sample("sr_chunk_retries", double(c.retries));
+        w.family("sr_chunk_turnaround_seconds", "summary",
+                 "Assignment to completion, chunks finished in the last hour");
+        w.sample("sr_chunk_turnaround_seconds", c.turnaroundP50Sec, "quantile=\"0.5\"");
+        w.sample("sr_chunk_turnaround_seconds", c.turnaroundP90Sec, "quantile=\"0.9\"");
+        w.sample("sr_chunk_turnaround_seconds_sum", c.turnaroundMeanSec * c.recent);
+        w.sample("sr_chunk_turnaround_seconds_count", c.recent);
+    }
+
+    auto perf = PerfCounters::instance().report();
+    w.family("sr_probe_milliseconds", "summary", "Scoped timers (dispatch.cycle is the coordinator tick)");
+    for (const auto& p : perf.probes)
+    {
+        std::string probe = "probe=\"" + escapeLabel(p.name) + "\"";
+        w.sample("sr_probe_milliseconds", p.stats.p50Ms, probe + ",quantile=\"0.5\"");
+        w.sample("sr_probe_milliseconds", p.stats.p99Ms, probe + ",quantile=\"0.99\"");
+        w.sample("sr_probe_milliseconds_count", double(p.stats.count), probe);
+    }
+    w.family("sr_farm_file_ops_total", "counter", "AtomicFileIO reads and writes");
+    w.sample("sr_farm_file_ops_total", double(perf.reads), "op=\"read\"");
+    w.sample("sr_farm_file_ops_total", double(perf.writes), "op=\"write\"");
+    w.family("sr_farm_file_bytes_total", "counter", "AtomicFileIO bytes read and written");
+    w.sample("sr_farm_file_bytes_total", double(perf.readBytes), "op=\"read\"");
+    w.sample("sr_farm_file_bytes_total", double(perf.writeBytes), "op=\"write\"");
+
+    return w.take();
+}
+
+std::string MetricsExporter::formatJson(const std::vector<NodeInfo>& nodes,
+                                        const JobSnapshot& jobs, bool isCoordinator) const
+{
+    nlohmann::json j;
+    j["timestamp_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    j["coordinator"] = isCoordinator;
+    j["jobs"] = jobStateCounts(jobs);
+
+    auto ns = nodeStats(nodes);
+    j["nodes"] = {
+        {"known", ns.total}, {"alive", ns.alive}, {"idle", ns.idle},
+        {"rendering", ns.rendering}, {"draining", ns.draining}, {"sleeping", ns.sleeping},
+        {"slots", ns.slots}, {"free_slots", ns.freeSlots},
+    };
+
+    if (m_hasChunks)
+    {
+        const auto& c = m_chunks;
+        j["chunks"] = {
+            {"pending", c.pending}, {"rendering", c.rendering},
+            {"completed", c.completed}, {"failed", c.failed},
+            {"queue_depth", c.queued}, {"retried", c.retried}, {"retries", c.retries},
+        };
+        j["turnaround_sec"] = {
+            {"p50", c.turnaroundP50Sec}, {"p90", c.turnaroundP90Sec},
+            {"mean", c.turnaroundMeanSec}, {"count", c.recent},
+        };
+    }
+
+    auto perf = PerfCounters::instance().report();
+    auto& probes = j["probes"] = nlohmann::json::object();
+    for (const auto& p : perf.probes)
+    {
+        probes[p.name] = {
+            {"count", p.stats.count}, {"p50_ms", p.stats.p50Ms},
+            {"p99_ms", p.stats.p99Ms}, {"max_ms", p.stats.maxMs},
+        };
+    }
+    j["farm_io"] = {
+        {"reads", perf.reads}, {"writes", perf.writes},
+        {"read_bytes", perf.readBytes}, {"write_bytes", perf.writeBytes},
+    };
+
+    return j.dump(2);
+}
+
+} // namespace SR
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "core/heartbeat.h"
+#include "core/job_types.h"
+#include "monitor/job_manager.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace SR {
+
+// Writes farm metrics to a local file every interval, for external dashboards
+// and alerting: Prometheus text exposition (point node_exporter's or
+// windows_exporter's textfile collector at it) or, for a ".json" path, one
+// JSON document. Everything comes from what the monitor already holds in
+// memory (dispatch tables, node and job snapshots, PerfCounters); the only
+// I/O is the local file itself. Main thread only.
+class MetricsExporter
+{
+public:
+    // Empty path = off
+    void configure(const std::string& path, int intervalSec);
+    bool enabled() const { return !m_path.empty(); }
+
+    // Coordinator: fold the tables that changed into the chunk aggregates
+    // (called where they're already copied for the UI). Other jobs keep
+    // their counts from earlier calls; released ones (a shard handed them
+    // off) drop out.
+    void observeTables(const std::map<std::string, DispatchTable>& changed,
+                       const std::vector<std::string>& released,
+                       const JobSnapshot& jobs, int64_t nowMs);
+    void clearTables() { m_jobChunks.clear(); m_chunks = {}; m_hasChunks = false; }
+
+    // Writes when the interval has passed
+    void update(const std::vector<NodeInfo>& nodes, const JobSnapshot& jobs,
+                bool isCoordinator);
+
+    static constexpr int DEFAULT_INTERVAL_SEC = 15;
+    static constexpr int64_t TURNAROUND_WINDOW_MS = 60 * 60 * 1000;   // chunks finished in the last hour
+
+private:
+    struct ChunkStats
+    {
+        int pending = 0, rendering = 0, completed = 0, failed = 0;
+        int queued = 0;                 // pending chunks of active jobs
+        int retried = 0;                // chunks with retry_count > 0
+        uint64_t retries = 0;
+        int recent = 0;                 // completed inside TURNAROUND_WINDOW_MS
+        double turnaroundP50Sec = 0.0, turnaroundP90Sec = 0.0, turnaroundMeanSec = 0.0;
+    };
+
+    std::string formatPrometheus(const std::vector<NodeInfo>& nodes, const JobSnapshot& jobs,
+                                 bool isCoordinator) const;
+    std::string formatJson(const std::vector<NodeInfo>& nodes, const JobSnapshot& jobs,
+                           bool isCoordinator) const;
+
+    std::filesystem::path m_path;
+    bool m_json = false;
+    std::chrono::milliseconds m_interval{DEFAULT_INTERVAL_SEC * 1000};
+    std::chrono::steady_clock::time_point m_lastWrite{};
+    bool m_warned = false;              // one log line per failing path
+
+    // One job's table, counted when it last changed
+    struct JobChunks
+    {
+        int pending = 0, rendering = 0, completed = 0, failed = 0;
+        int retried = 0;
+        uint64_t retries = 0;
+        std::vector<std::pair<int64_t, double>> turnaround;    // completed_at_ms, seconds
+    };
+    std::map<std::string, JobChunks> m_jobChunks;
+
+    ChunkStats m_chunks;
+    bool m_hasChunks = false;
+};
+
+} // namespace SR
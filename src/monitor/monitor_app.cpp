@@ -1,15 +1,44 @@
 #include "monitor/monitor_app.h"
 #include "monitor/farm_init.h"
+#include "monitor/farm_index.h"
 #include "monitor/ui_data_cache.h"
 #include "core/platform.h"
 #include "core/atomic_file_io.h"
+#include "core/chunk_trace.h"
+#include "core/coordinator_lease.h"
+#include "core/coordinator_shards.h"
+#include "core/farm_storage.h"
+#include "core/read_cache.h"
 #include "core/monitor_log.h"
+#include "core/perf_counters.h"
+#include "core/wake_on_lan.h"
 
 #include <imgui.h>
+#include <algorithm>
+#include <cstdio>
 #include <filesystem>
 
 namespace SR {
 
+namespace {
+
+// Live coordinator with the highest (epoch, node_id) rank, or nullptr
+const NodeInfo* rulingCoordinator(const std::vector<NodeInfo>& nodes)
+{
+    const NodeInfo* best = nullptr;
+    for (const auto& n : nodes)
+    {
+        if (n.isDead || !n.heartbeat.is_coordinator)
+            continue;
+        if (!best || CoordinatorLease::outranks(n.heartbeat.coord_epoch, n.heartbeat.node_id,
+                                                best->heartbeat.coord_epoch, best->heartbeat.node_id))
+            best = &n;
+    }
+    return best;
+}
+
+} // namespace
+
 bool MonitorApp::init()
 {
     // Resolve app data directory
@@ -31,12 +60,11 @@ bool MonitorApp::init()
     // Create UIDataCache (will be started/stopped with farm)
     m_uiDataCache = std::make_unique<UIDataCache>();
 
-    // Initialize agent supervisor (IPC server + background thread)
-    m_agentSupervisor.start(m_identity.nodeId());
-    if (m_config.auto_start_agent)
-    {
-        m_agentSupervisor.spawnAgent();
-    }
+    // Frame thumbnails are node-local, independent of the farm
+    m_thumbnailCache.start(m_appDataDir / "thumbs");
+
+    // Initialize agent supervisors (IPC server + background thread per slot)
+    startAgents();
 
     // Initialize dashboard
     m_dashboard.init(this);
@@ -53,17 +81,19 @@ bool MonitorApp::init()
 
 void MonitorApp::update()
 {
+    SR_PERF_SCOPE("app.update");
     try
     {
-        m_agentSupervisor.processMessages();
+        for (auto& agent : m_agents)
+            agent->processMessages();
 
         // Check for CLI submit requests from another process
         checkSubmitRequest();
 
         if (m_farmRunning)
         {
-            // Phase 1: UDP fast path
-            handleUdpMessages();
+            // Phase 1: fast path (UDP multicast + TCP link)
+            handleFastPathMessages();
 
             // Phase 2: Filesystem slow path (dedup skips already-processed)
             auto actions = m_commandManager.popActions();
@@ -74,54 +104,122 @@ void MonitorApp::update()
                 processAction(action);
             }
 
+            checkParkedResume();
+
             // Periodic: UDP heartbeat (every 3s)
             auto now = std::chrono::steady_clock::now();
             if (std::chrono::duration_cast<std::chrono::milliseconds>(
                     now - m_lastUdpHeartbeat).count() >= 3000)
             {
-                sendUdpHeartbeat();
+                sendFastHeartbeat();
                 m_lastUdpHeartbeat = now;
             }
 
-            // Periodic: dedup purge (every 30s)
+            // Periodic: dispatch digest so viewers can verify their replicas
+            // (one coordinator's stream; shards leave viewers on disk)
+            if (m_isCoordinator && !m_isShard && (m_udpNotify.isRunning() || m_tcpLink.isRunning()) &&
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    now - m_lastReplicaDigest).count() >= DispatchReplicaPublisher::DIGEST_INTERVAL_MS)
+            {
+                for (const auto& msg : m_replicaPublisher.digest(m_dispatchManager.getDispatchTables()))
+                {
+                    m_udpNotify.send(msg);
+                    m_tcpLink.broadcast(msg);
+                }
+                m_lastReplicaDigest = now;
+            }
+
+            // Periodic: coordinator fencing and standby takeover
             if (std::chrono::duration_cast<std::chrono::milliseconds>(
-                    now - m_lastDedupPurge).count() >= 30000)
+                    now - m_lastRoleCheck).count() >= ROLE_CHECK_MS)
+            {
+                checkCoordinatorRole();
+                m_lastRoleCheck = now;
+            }
+
+            // Periodic: worker re-checks where the coordinator's link is (every 1s)
+            if (!m_isCoordinator && m_tcpLink.isRunning() &&
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    now - m_lastTcpTargetCheck).count() >= 1000)
             {
-                m_dedup.purge();
-                m_lastDedupPurge = now;
+                updateTcpLinkTarget();
+                m_lastTcpTargetCheck = now;
             }
 
             // Refresh cached snapshots from bg threads (zero FS I/O)
-            m_cachedJobs = m_jobManager.getJobSnapshot();
-            m_cachedTemplates = m_templateManager.getTemplateSnapshot();
+            m_jobSnapshot = m_jobManager.getJobSnapshot();
+            m_templateSnapshot = m_templateManager.getTemplateSnapshot();
 
             // Push context to UIDataCache bg thread
             {
-                std::vector<std::string> jobIds;
-                jobIds.reserve(m_cachedJobs.size());
-                for (const auto& j : m_cachedJobs)
-                    jobIds.push_back(j.manifest.job_id);
-                m_uiDataCache->setJobIds(jobIds);
+                if (m_jobSnapshot->version != m_pushedJobsVersion)
+                {
+                    std::vector<std::string> jobIds;
+                    jobIds.reserve(m_jobSnapshot->jobs.size());
+                    for (const auto& j : m_jobSnapshot->jobs)
+                        jobIds.push_back(j.manifest.job_id);
+                    m_uiDataCache->setJobIds(jobIds);
+                    m_pushedJobsVersion = m_jobSnapshot->version;
+                    if (m_isCoordinator)
+                        m_dispatchManager.wake();
+                }
                 m_uiDataCache->setSelectedJobId(m_selectedJobId);
 
-                if (m_config.is_coordinator)
-                    m_uiDataCache->setDispatchTables(m_dispatchManager.getDispatchTables());
+                if (m_isCoordinator &&
+                    m_dispatchManager.tablesVersion() != m_pushedTablesVersion)
+                {
+                    // Only the tables that changed since the last push are copied
+                    auto changes = m_dispatchManager.getChangedTables(m_pushedTablesVersion);
+                    m_pushedTablesVersion = changes.version;
+                    if (!m_isShard && (m_udpNotify.isRunning() || m_tcpLink.isRunning()))
+                    {
+                        for (const auto& msg : m_replicaPublisher.deltas(changes.tables))
+                        {
+                            m_udpNotify.send(msg);
+                            m_tcpLink.broadcast(msg);
+                        }
+                    }
+                    auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count();
+                    m_metricsExporter.observeTables(changes.tables, changes.released, *m_jobSnapshot, nowMs);
+
+                    std::map<std::string, UIDataCache::JobProgress> progress;
+                    for (const auto& [jobId, p] : changes.progress)
+                        progress[jobId] = {p.completed, p.total, p.rendering, p.failed, p.renderingChunks};
+                    m_uiDataCache->mergeDispatchTables(std::move(changes.tables), changes.released, progress);
+                }
             }
 
-            if (m_config.is_coordinator)
+            saveFarmIndex(false);
+
+            if (m_metricsExporter.enabled())
+                m_metricsExporter.update(m_heartbeatManager.getNodeSnapshot()->nodes,
+                                         *m_jobSnapshot, m_isCoordinator);
+
+            // Dispatch itself runs on DispatchManager's thread; self-assignments
+            // are handed to the RenderCoordinator here on the main thread
+            if (m_isCoordinator)
             {
-                m_dispatchManager.update();
+                m_dispatchManager.drainLocalDispatches();
                 m_submissionManager.update();
             }
 
-            m_renderCoordinator.update(m_agentSupervisor);
+            m_renderCoordinator.update();
 
-            // Worker: retry deferred assignments waiting for manifest propagation
-            if (!m_config.is_coordinator)
-                processDeferredAssignments();
+            // Retry deferred assignments waiting for manifest propagation (these
+            // can outlive a standby's takeover, so not worker-only)
+            processDeferredAssignments();
+
+            if (m_renderCoordinator.inputCacheEnabled() && m_renderCoordinator.isRendering() &&
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    now - m_lastInputPrefetch).count() >= INPUT_PREFETCH_MS)
+            {
+                prefetchNextJobInputs();
+                m_lastInputPrefetch = now;
+            }
 
             // Worker: retry sending buffered completions when coordinator is back
-            if (!m_config.is_coordinator && !m_pendingCompletions.empty())
+            if (!m_isCoordinator && !m_pendingCompletions.empty())
                 flushPendingCompletions();
 
             // Sync render state to heartbeat so peers can see it
@@ -135,6 +233,14 @@ void MonitorApp::update()
             {
                 m_heartbeatManager.setRenderState("idle", "", "");
             }
+            m_heartbeatManager.setRenderSlots(static_cast<int>(m_renderCoordinator.slotCount()),
+                                              static_cast<int>(m_renderCoordinator.freeSlots()),
+                                              m_renderCoordinator.activeJobIds());
+
+            // One batch of multicast datagrams per tick (incl. dispatch-thread sends)
+            m_udpNotify.flush();
+
+            ChunkTrace::instance().flush();
         }
 
     }
@@ -233,8 +339,12 @@ void MonitorApp::shutdown()
     // Stop heartbeat first (writes final "stopped" heartbeat)
     stopFarm();
 
-    // Then stop agent
-    m_agentSupervisor.stop();
+    // Then stop agents
+    for (auto& agent : m_agents)
+        agent->stop();
+
+    // While the GL context is still current
+    m_thumbnailCache.stop();
 
     // Save config last
     saveConfig();
@@ -256,17 +366,70 @@ bool MonitorApp::startFarm()
     m_farmPath = result.farmPath;
     MonitorLog::instance().startFileLogging(m_farmPath, m_identity.nodeId());
 
-    // Start bg scanning threads (first scan synchronous = data ready before DispatchManager)
-    m_jobManager.start(m_farmPath);
-    m_templateManager.start(m_farmPath);
+    // Per-class farm file encodings (readers auto-detect, so this only affects writes)
+    for (const auto& [clsName, encName] : m_config.file_encodings)
+    {
+        auto enc = jsonEncodingFromString(encName);
+        bool matched = false;
+        for (uint8_t c = 1; c < static_cast<uint8_t>(FileClass::Count) && enc; ++c)
+        {
+            if (clsName == fileClassName(static_cast<FileClass>(c)))
+            {
+                AtomicFileIO::setEncoding(static_cast<FileClass>(c), *enc);
+                matched = true;
+            }
+        }
+        if (!matched)
+            MonitorLog::instance().warn("farm", "Ignoring file encoding " + clsName + "=" + encName);
+    }
+
+    // Start bg scanning threads. With a local index they start from it and
+    // reconcile in the background (DispatchManager waits for that); without
+    // one the first scan is synchronous.
+    m_isCoordinator = m_config.is_coordinator;
+    m_isShard = m_isCoordinator && m_config.coordinator_shard;
+    m_coordEpoch = 0;
+    m_shards = CoordinatorShards::read(m_farmPath).value_or(CoordinatorShards{});
+    m_workFor.clear();
+    m_workLeaseCooldown.clear();
+    m_lastBusy = std::chrono::steady_clock::now();
+    m_farmIndexPath = FarmIndex::pathFor(m_appDataDir, m_farmPath);
+    m_indexSavedRevision = 0;
+    m_lastIndexSave = std::chrono::steady_clock::now();
+    auto index = FarmIndex::load(m_farmIndexPath, m_farmPath);
+    m_jobManager.setStateCompaction(m_isCoordinator && !m_isShard);
+    m_jobManager.start(m_farmPath, index ? std::move(index->jobs) : std::vector<JobManager::IndexedJob>{});
+    m_templateManager.start(m_farmPath, index ? std::move(index->templates) : std::vector<JobTemplate>{});
 
     // Populate caches immediately
-    m_cachedJobs = m_jobManager.getJobSnapshot();
-    m_cachedTemplates = m_templateManager.getTemplateSnapshot();
+    m_jobSnapshot = m_jobManager.getJobSnapshot();
+    m_pushedJobsVersion = 0;
+    m_templateSnapshot = m_templateManager.getTemplateSnapshot();
+    if (index)
+    {
+        // Job ids first, so the cache's first scan doesn't prune the seeded progress
+        std::vector<std::string> jobIds;
+        jobIds.reserve(m_jobSnapshot->jobs.size());
+        for (const auto& j : m_jobSnapshot->jobs)
+            jobIds.push_back(j.manifest.job_id);
+        m_uiDataCache->setJobIds(jobIds);
+        m_uiDataCache->seedProgress(index->progress);
+        m_pushedJobsVersion = m_jobSnapshot->version;
+    }
 
-    m_heartbeatManager.setIsCoordinator(m_config.is_coordinator);
+    m_heartbeatManager.setIsCoordinator(m_isCoordinator);
+    m_heartbeatManager.setIsStandby(!m_isCoordinator && m_config.standby_coordinator);
+    m_heartbeatManager.setCoordinatorEpoch(0);
+    m_heartbeatManager.setShardState(m_isShard, 0);
+    m_heartbeatManager.setWorkFor("");
+    m_heartbeatManager.setAllowSleep(m_config.allow_remote_sleep);
     m_heartbeatManager.start(m_farmPath, m_identity, m_config.timing, m_config.tags);
 
+    m_commandManager.setReachability([this](const std::string& nodeId) {
+        return m_heartbeatManager.hasUdpContact(nodeId);
+    });
+    ChunkTrace::instance().start(m_farmPath, m_identity.nodeId());
+    ChunkTrace::instance().setEnabled(m_config.chunk_tracing);
     m_commandManager.start(m_farmPath, m_identity.nodeId());
 
     if (m_config.udp_enabled)
@@ -277,110 +440,107 @@ bool MonitorApp::startFarm()
             MonitorLog::instance().info("udp", "Multicast unavailable, filesystem-only mode");
     }
     m_commandManager.setUdpNotify(m_udpNotify.isRunning() ? &m_udpNotify : nullptr);
+    m_replicaPublisher.reset(m_identity.nodeId());
+    m_lastReplicaDigest = {};
 
-    if (m_config.is_coordinator)
+    if (m_isCoordinator)
     {
         // Check for existing coordinator
-        auto nodes = m_heartbeatManager.getNodeSnapshot();
+        auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+        const auto& nodes = nodeSnapshot->nodes;
+        uint64_t peerEpoch = 0;
         for (const auto& n : nodes)
         {
-            if (!n.isLocal && !n.isDead && n.heartbeat.is_coordinator)
+            peerEpoch = (std::max)(peerEpoch, n.heartbeat.coord_epoch);
+            // Shards only share the farm with shards
+            if (!n.isLocal && !n.isDead && n.heartbeat.is_coordinator &&
+                !(m_isShard && n.heartbeat.is_shard))
             {
                 m_farmError = "Another coordinator is already active: " +
                               n.heartbeat.hostname + " (" + n.heartbeat.node_id + ")";
                 MonitorLog::instance().error("farm", m_farmError);
+                m_commandManager.setUdpNotify(nullptr);
                 m_commandManager.stop();
+                m_udpNotify.stop();
                 m_heartbeatManager.stop();
+                m_isCoordinator = false;
+                m_isShard = false;
                 MonitorLog::instance().stopFileLogging();
                 return false;
             }
         }
 
-        // Start DispatchManager
-        m_dispatchManager.start(
-            m_farmPath, m_identity.nodeId(), getOS(),
-            m_config.timing, m_config.tags,
-            [this]() { return m_heartbeatManager.getNodeSnapshot(); },
-            [this]() { return m_jobManager.getJobSnapshot(); }
-        );
-
-        m_dispatchManager.setLocalDispatchCallback(
-            [this](const JobManifest& m, const ChunkRange& c) {
-                m_renderCoordinator.queueDispatch(m, c);
-            }
-        );
-
-        m_dispatchManager.setCommandSender(
-            [this](const std::string& target, const std::string& type,
-                   const std::string& jobId, const std::string& reason,
-                   int frameStart, int frameEnd) {
-                m_commandManager.sendCommand(target, type, jobId, reason, frameStart, frameEnd);
-            }
-        );
-
-        // Coordinator: completions go to DispatchManager
-        m_renderCoordinator.init(m_farmPath, m_identity.nodeId(), getOS(),
-            [this](const std::string& jobId, const ChunkRange& chunk, const std::string& state) {
-                m_dispatchManager.queueLocalCompletion(jobId, chunk, state);
-            },
-            &m_agentSupervisor
-        );
+        if (m_isShard)
+        {
+            // Join the membership: the jobs and workers that hash to us move
+            // over once their previous owners have written them out
+            m_coordEpoch = CoordinatorShards::join(m_farmPath, m_identity.nodeId(), 0);
+            if (m_coordEpoch == 0)
+                MonitorLog::instance().warn("farm", "Could not write coordinators.json, joining on the next role check");
+            m_shards = CoordinatorShards::read(m_farmPath).value_or(m_shards);
+        }
+        else
+        {
+            // Claim the next fencing epoch: a predecessor still running somewhere
+            // sees it and steps down
+            m_coordEpoch = CoordinatorLease::claim(m_farmPath, m_identity.nodeId(), peerEpoch);
+            if (m_coordEpoch == 0)
+                MonitorLog::instance().warn("farm", "Could not write coordinator.json, running unfenced");
+        }
+        m_heartbeatManager.setCoordinatorEpoch(m_coordEpoch);
 
-        // Start SubmissionManager (coordinator processes DCC submission inbox)
-        m_submissionManager.start(
-            m_farmPath, m_identity.nodeId(), getOS(),
-            [this](const std::string& templateId) -> std::optional<JobTemplate> {
-                // Use thread-safe snapshot (called from SubmissionManager bg thread)
-                auto templates = m_templateManager.getTemplateSnapshot();
-                for (const auto& t : templates)
-                {
-                    if (t.template_id == templateId && t.valid)
-                        return t;
-                }
-                return std::nullopt;
-            },
-            [this](const JobManifest& manifest, int priority) -> std::string {
-                return m_jobManager.submitJob(m_farmPath, manifest, priority);
-            }
-        );
+        startCoordinatorServices({});
 
-        MonitorLog::instance().info("farm", "Started as coordinator");
+        MonitorLog::instance().info("farm", std::string(m_isShard ? "Started as coordinator shard" : "Started as coordinator") +
+            " (epoch " + std::to_string(m_coordEpoch) + ")");
     }
     else
     {
-        // Worker: completions sent to coordinator via command file
-        m_renderCoordinator.init(m_farmPath, m_identity.nodeId(), getOS(),
-            [this](const std::string& jobId, const ChunkRange& chunk, const std::string& state) {
-                std::string coordId = findCoordinatorNodeId();
-                if (coordId.empty())
-                {
-                    MonitorLog::instance().warn("farm", "No coordinator found, buffering completion for retry");
-                    m_pendingCompletions.push_back({jobId, chunk, state});
-                    return;
-                }
-                std::string cmdType = (state == "completed") ? "chunk_completed" : "chunk_failed";
-                m_commandManager.sendCommand(coordId, cmdType, jobId, state,
-                                             chunk.frame_start, chunk.frame_end);
-            },
-            &m_agentSupervisor
-        );
-
-        MonitorLog::instance().info("farm", "Started as worker");
+        MonitorLog::instance().info("farm", m_config.standby_coordinator
+            ? "Started as worker (standby coordinator)" : "Started as worker");
     }
 
-    m_agentSupervisor.setMessageHandler(
-        [this](const std::string& type, const nlohmann::json& j) {
-            m_renderCoordinator.handleAgentMessage(type, j);
-        }
+    // Completions go to DispatchManager or the coordinator, whichever role we hold now
+    m_renderCoordinator.init(m_farmPath, m_identity.nodeId(), getOS(),
+        [this](const std::string& jobId, const ChunkRange& chunk, const std::string& state,
+               const std::string& framesDone) {
+            reportCompletion(jobId, chunk, state, framesDone);
+        },
+        agentPointers()
     );
+    m_renderCoordinator.setStdoutOptions(m_config.stdout_compress, m_config.stdout_stage_local);
+    m_renderCoordinator.setInputCacheOptions(m_config.input_cache_enabled, m_config.input_cache_dir,
+                                             m_config.input_cache_gb);
+    m_renderCoordinator.setOutputStaging(m_config.output_staging, m_config.output_staging_dir);
+    m_renderCoordinator.setPlacementOptions(m_config.render_priority, slotNumaNodes(m_config));
+
+    startTcpLink();
+    m_heartbeatManager.setFastPathActive(m_udpNotify.isRunning() || m_tcpLink.isRunning());
+
+    for (size_t i = 0; i < m_agents.size(); ++i)
+    {
+        m_agents[i]->setMessageHandler(
+            [this, i](const AgentMessage& msg) {
+                m_renderCoordinator.handleAgentMessage(i, msg);
+            }
+        );
+    }
 
     // Start UIDataCache bg thread
     m_uiDataCache->start(m_farmPath);
+    applyMetricsExport();
+
+    m_archiveManager.start(m_farmPath,
+        [this]() { return m_jobManager.getJobSnapshot(); },
+        [this]() { m_jobManager.invalidate(); });
+    applyArchiving();
 
     m_farmRunning = true;
+    m_farmStartedAt = std::chrono::steady_clock::now();
+    m_lastRoleCheck = m_farmStartedAt;
 
     // Announce presence immediately so peers discover us within ~50ms
-    sendUdpHeartbeat();
+    sendFastHeartbeat();
     m_lastUdpHeartbeat = std::chrono::steady_clock::now();
 
     MonitorLog::instance().info("farm", "Farm started at: " + m_farmPath.string());
@@ -393,31 +553,56 @@ void MonitorApp::stopFarm()
         return;
 
     // Broadcast goodbye so peers/coordinator know immediately
-    if (m_udpNotify.isRunning())
-    {
-        m_udpNotify.send({
-            {"t", "bye"},
-            {"from", m_identity.nodeId()},
-            {"n", m_identity.nodeId()},
-        });
-    }
+    nlohmann::json bye = {
+        {"t", "bye"},
+        {"from", m_identity.nodeId()},
+        {"n", m_identity.nodeId()},
+    };
+    m_udpNotify.send(bye);
+    m_tcpLink.broadcast(bye);
 
+    saveFarmIndex(true);
     m_uiDataCache->stop();
+    m_archiveManager.stop();
 
-    m_commandManager.setUdpNotify(nullptr);
-    m_commandManager.stop();
-    m_udpNotify.stop();
-
-    if (m_config.is_coordinator)
+    // Dispatch thread sends commands — stop it before the command/UDP paths go away
+    if (m_isCoordinator)
     {
         m_dispatchManager.stop();
         m_submissionManager.stop();
+
+        // After the final compaction, so our jobs move on with their tables written
+        if (m_isShard && !CoordinatorShards::leave(m_farmPath, m_identity.nodeId()))
+            MonitorLog::instance().warn("farm", "Could not leave coordinators.json; shards prune it once it's seen dead");
     }
 
+    m_commandManager.setUdpNotify(nullptr);
+    m_commandManager.setTcpLink(nullptr);
+    m_commandManager.stop();
+    m_udpNotify.stop();
+    m_tcpLink.stop();
+    m_heartbeatManager.setTcpPort(0);
+
     m_jobManager.stop();
     m_templateManager.stop();
 
     m_heartbeatManager.stop();
+
+    // Scanners are stopped; drop cached parses so a different farm starts cold
+    auto rc = ReadCache::instance().stats();
+    MonitorLog::instance().info("farm", "Read cache: " + std::to_string(rc.hits) + " hits, "
+        + std::to_string(rc.misses) + " misses, " + std::to_string(rc.evictions) + " evictions");
+    ReadCache::instance().clear();
+
+    const auto& dd = m_dedup.stats();
+    char rate[16];
+    std::snprintf(rate, sizeof(rate), "%.1f", m_dedup.duplicateRate());
+    MonitorLog::instance().info("farm", "Message dedup: " + std::to_string(dd.checked) + " checked, "
+        + std::to_string(dd.duplicates) + " duplicates (" + rate + "%), "
+        + std::to_string(dd.earlyRotations) + " early rotations");
+
+    ChunkTrace::instance().stop();
+
     MonitorLog::instance().stopFileLogging();
     m_farmRunning = false;
     m_farmPath.clear();
@@ -425,110 +610,535 @@ void MonitorApp::stopFarm()
     m_nodeState = NodeState::Active;
     m_pendingCompletions.clear();
     m_deferredAssignments.clear();
+    m_isCoordinator = false;
+    m_isShard = false;
+    m_coordEpoch = 0;
+    m_shards = {};
+    m_workFor.clear();
 }
 
 // ─── Coordinator query ──────────────────────────────────────────────────────
 
 std::string MonitorApp::findCoordinatorNodeId() const
 {
-    auto nodes = m_heartbeatManager.getNodeSnapshot();
-    for (const auto& n : nodes)
+    auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
+    const NodeInfo* coord = rulingCoordinator(nodes);
+    return coord ? coord->heartbeat.node_id : std::string();
+}
+
+std::string MonitorApp::coordinatorFor(const std::string& jobId) const
+{
+    if (!m_shards.isSharded())
+        return findCoordinatorNodeId();
+
+    // The shard owning the job, once it's live (a dead one's jobs move when
+    // it's pruned, and the report goes to the new owner then)
+    std::string owner = m_shards.ownerOf(jobId);
+    auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+    for (const auto& n : nodeSnapshot->nodes)
     {
-        if (!n.isDead && n.heartbeat.is_coordinator)
-            return n.heartbeat.node_id;
+        if (n.heartbeat.node_id == owner)
+            return n.isDead ? std::string() : owner;
     }
     return {};
 }
 
-// ─── UDP multicast fast path ─────────────────────────────────────────────────
+void MonitorApp::reportCompletion(const std::string& jobId, const ChunkRange& chunk,
+                                  const std::string& state, const std::string& framesDone)
+{
+    std::string cmdType = (state == "completed") ? "chunk_completed" : "chunk_failed";
+    if (m_isCoordinator)
+    {
+        // A shard may finish a chunk of a job it has since handed to another
+        std::string owner = m_isShard ? m_shards.ownerOf(jobId) : std::string();
+        if (owner.empty() || owner == m_identity.nodeId())
+            m_dispatchManager.queueLocalCompletion(jobId, chunk, state, framesDone);
+        else
+            m_commandManager.sendCommand(owner, cmdType, jobId, state,
+                                         chunk.frame_start, chunk.frame_end, framesDone);
+        return;
+    }
 
-void MonitorApp::handleUdpMessages()
+    // Worker: completions sent to coordinator via command file
+    std::string coordId = coordinatorFor(jobId);
+    if (coordId.empty())
+    {
+        MonitorLog::instance().warn("farm", "No coordinator found, buffering completion for retry");
+        m_pendingCompletions.push_back({jobId, chunk, state, framesDone});
+        return;
+    }
+    m_commandManager.sendCommand(coordId, cmdType, jobId, state,
+                                 chunk.frame_start, chunk.frame_end, framesDone);
+}
+
+// ─── Coordinator role ───────────────────────────────────────────────────────
+
+void MonitorApp::startCoordinatorServices(std::map<std::string, DispatchTable> seedTables)
 {
-    if (!m_udpNotify.isRunning()) return;
+    // Configure DispatchManager before start() — its thread dispatches right away
+    m_dispatchManager.setPrefetchDepth(m_config.prefetch_depth);
+    m_dispatchManager.setSchedulingPolicy(m_config.scheduling_policy);
+    m_dispatchManager.setJobAffinity(m_config.job_affinity);
+    m_dispatchManager.setPreemption(m_config.preemption);
+    m_dispatchManager.setPowerPolicy(m_config.power);
+    m_dispatchManager.setWakeSender([](const std::string& mac, const std::string& broadcast) {
+        return sendWakeOnLan(mac, broadcast);
+    });
+    m_dispatchManager.setNodeActive(m_nodeState == NodeState::Active);
+    m_dispatchManager.seedTables(std::move(seedTables));
+    m_dispatchManager.setEpoch(m_coordEpoch);
+    m_dispatchManager.setShardMode(m_isShard);
+
+    m_dispatchManager.setLocalDispatchCallback(
+        [this](const JobManifest& m, const ChunkRange& c, const std::string& traceId) {
+            m_renderCoordinator.queueDispatch(m, c, traceId);
+        }
+    );
+
+    m_dispatchManager.setCommandSender(
+        [this](const std::string& target, const std::string& type,
+               const std::string& jobId, const std::string& reason,
+               int frameStart, int frameEnd, const std::string& traceId) {
+            m_commandManager.queueCommand(target, type, jobId, reason, frameStart, frameEnd, traceId);
+        }
+    );
+    m_dispatchManager.setCommandFlush([this]() { m_commandManager.flushQueued(); });
+    m_dispatchManager.setRenderEstimates([this]() { return m_uiDataCache->renderEstimates(); });
+
+    // Start DispatchManager
+    m_dispatchManager.start(
+        m_farmPath, m_identity.nodeId(), getOS(),
+        m_config.timing, m_config.tags,
+        [this]() { return m_heartbeatManager.getNodeSnapshot(); },
+        [this]() { return m_jobManager.getJobSnapshot(); }
+    );
+
+    // Submission inbox, state compaction and archiving: one node's job
+    applyFarmChores();
+}
 
-    for (const auto& msg : m_udpNotify.poll())
+void MonitorApp::startSubmissionInbox()
+{
+    // Start SubmissionManager (coordinator processes DCC submission inbox)
+    m_submissionManager.start(
+        m_farmPath, m_identity.nodeId(), getOS(),
+        [this](const std::string& templateId) -> std::optional<JobTemplate> {
+            // Use thread-safe snapshot (called from SubmissionManager bg thread)
+            auto snapshot = m_templateManager.getTemplateSnapshot();
+            const auto* t = snapshot->find(templateId);
+            if (t && t->valid)
+                return *t;
+            return std::nullopt;
+        },
+        [this](const JobManifest& manifest, int priority) -> std::string {
+            return m_jobManager.submitJob(m_farmPath, manifest, priority, false);
+        },
+        // One rescan (and with it one dispatch pass) per inbox batch
+        [this](size_t) { m_jobManager.invalidate(); }
+    );
+}
+
+void MonitorApp::checkCoordinatorRole()
+{
+    // Shards aren't fenced by one another: membership settles what each owns
+    checkShardRole();
+    if (m_isShard)
+        return;
+
+    auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
+
+    if (m_isCoordinator)
     {
-        std::string type = msg.value("t", "");
-        if (type == "hb")
+        if (m_dispatchManager.isFenced())
         {
-            m_heartbeatManager.processUdpHeartbeat(msg);
-            continue;
+            demoteToWorker("coordinator.json was claimed with a newer epoch");
+            return;
         }
-        if (type == "bye")
+        for (const auto& n : nodes)
         {
-            m_heartbeatManager.processUdpGoodbye(msg);
-            continue;
+            if (n.isLocal || n.isDead || !n.heartbeat.is_coordinator)
+                continue;
+            if (CoordinatorLease::outranks(n.heartbeat.coord_epoch, n.heartbeat.node_id,
+                                           m_coordEpoch, m_identity.nodeId()))
+            {
+                demoteToWorker(n.heartbeat.hostname + " (" + n.heartbeat.node_id + ") holds epoch " +
+                               std::to_string(n.heartbeat.coord_epoch));
+                return;
+            }
         }
+        return;
+    }
 
-        // Commands are targeted — ignore if not addressed to us
-        std::string target = msg.value("target", "");
-        if (!target.empty() && target != m_identity.nodeId())
-            continue;
+    if (!m_config.standby_coordinator)
+        return;
+
+    // Peers count as dead until their seq moves, so give discovery one full
+    // dead threshold before reading "no live coordinator" as a failure
+    int64_t settleMs = int64_t(m_config.timing.dead_threshold_scans + 1) * m_config.timing.scan_interval_ms;
+    if (std::chrono::steady_clock::now() - m_farmStartedAt < std::chrono::milliseconds(settleMs))
+        return;
 
-        std::string msgId = msg.value("msg_id", "");
-        if (msgId.empty() || m_dedup.isDuplicate(msgId))
+    for (const auto& n : nodes)
+    {
+        if (n.isLocal || n.isDead)
             continue;
+        if (n.heartbeat.is_coordinator)
+            return;
+        // Several standbys: the lowest node_id takes over, the rest keep waiting
+        if (n.heartbeat.is_standby && n.heartbeat.node_id < m_identity.nodeId())
+            return;
+    }
 
-        CommandManager::Action action;
-        action.type = msg.value("type", "");
-        action.jobId = msg.value("job_id", "");
-        action.reason = msg.value("reason", "");
-        action.frameStart = msg.value("frame_start", 0);
-        action.frameEnd = msg.value("frame_end", 0);
-        action.fromNodeId = msg.value("from", "");
-        action.msgId = msgId;
+    promoteToCoordinator();
+}
 
-        if (!action.type.empty())
-            processAction(action);
+void MonitorApp::promoteToCoordinator()
+{
+    auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
+    uint64_t peerEpoch = 0;
+    for (const auto& n : nodes)
+        peerEpoch = (std::max)(peerEpoch, n.heartbeat.coord_epoch);
+
+    uint64_t epoch = CoordinatorLease::claim(m_farmPath, m_identity.nodeId(), peerEpoch);
+    if (epoch == 0)
+    {
+        MonitorLog::instance().warn("farm", "Standby takeover deferred: could not write coordinator.json");
+        return;
     }
+
+    // Tables the multicast replica has verified against a digest are current
+    // to the last delta; anything else is read from the dispatch journal
+    std::vector<std::string> activeJobs;
+    for (const auto& job : m_jobSnapshot->jobs)
+    {
+        if (job.current_state == "active")
+            activeJobs.push_back(job.manifest.job_id);
+    }
+    auto mirrored = m_uiDataCache->replicatedTables(activeJobs);
+    size_t mirroredCount = mirrored.size();
+
+    m_isCoordinator = true;
+    m_coordEpoch = epoch;
+    m_heartbeatManager.setIsStandby(false);
+    m_heartbeatManager.setIsCoordinator(true);
+    m_heartbeatManager.setCoordinatorEpoch(epoch);
+    m_jobManager.setStateCompaction(true);
+    applyArchiving();
+
+    startCoordinatorServices(std::move(mirrored));
+
+    // Workers follow the advertised port to our listener
+    m_commandManager.setTcpLink(nullptr);
+    m_tcpLink.stop();
+    startTcpLink();
+
+    m_replicaPublisher.reset(m_identity.nodeId());
+    m_lastReplicaDigest = {};
+    m_pushedTablesVersion = 0;
+
+    // Completions buffered while no coordinator was reachable are ours now
+    for (const auto& pc : m_pendingCompletions)
+        m_dispatchManager.queueLocalCompletion(pc.jobId, pc.chunk, pc.state, pc.framesDone);
+    m_pendingCompletions.clear();
+
+    MonitorLog::instance().warn("farm", "Standby takeover: now coordinator (epoch " + std::to_string(epoch) +
+        ", " + std::to_string(mirroredCount) + " of " + std::to_string(activeJobs.size()) +
+        " active table(s) mirrored)");
+
+    sendFastHeartbeat();
+    m_lastUdpHeartbeat = std::chrono::steady_clock::now();
+}
+
+void MonitorApp::demoteToWorker(const std::string& reason)
+{
+    MonitorLog::instance().error("farm", "Stepping down as coordinator: " + reason);
+
+    // Fence before stopping: the final compaction must not overwrite the
+    // successor's tables
+    m_dispatchManager.fence();
+    m_dispatchManager.stop();
+    m_submissionManager.stop();
+
+    m_isCoordinator = false;
+    m_coordEpoch = 0;
+    m_heartbeatManager.setIsCoordinator(false);
+    m_heartbeatManager.setCoordinatorEpoch(0);
+    m_heartbeatManager.setIsStandby(m_config.standby_coordinator);
+    m_jobManager.setStateCompaction(false);
+    applyArchiving();
+    m_uiDataCache->clearDispatchTables();
+    m_metricsExporter.clearTables();
+
+    m_commandManager.setTcpLink(nullptr);
+    m_tcpLink.stop();
+    m_heartbeatManager.setTcpPort(0);
+    startTcpLink();
+
+    sendFastHeartbeat();
+    m_lastUdpHeartbeat = std::chrono::steady_clock::now();
 }
 
-void MonitorApp::sendUdpHeartbeat()
+bool MonitorApp::isSupersededCoordinator(const std::string& nodeId) const
 {
-    if (!m_udpNotify.isRunning()) return;
+    // Only chunk commands are fenced, and only once the sender is known and
+    // someone else is the ruling coordinator (a just-started one may not be
+    // visible yet; then nothing is dropped)
+    if (nodeId.empty() || nodeId == m_identity.nodeId())
+        return false;
+    auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
+
+    // Sharded: every member (or a live shard that joined since we last read
+    // the membership) dispatches its own jobs
+    if (m_shards.isSharded())
+    {
+        if (m_shards.contains(nodeId))
+            return false;
+        return std::any_of(nodes.begin(), nodes.end(), [&](const NodeInfo& n) {
+            return n.heartbeat.node_id == nodeId && !(n.heartbeat.is_shard && !n.isDead);
+        });
+    }
+
+    const NodeInfo* ruling = rulingCoordinator(nodes);
+    if (!ruling || ruling->heartbeat.node_id == nodeId)
+        return false;
+    return std::any_of(nodes.begin(), nodes.end(),
+                       [&](const NodeInfo& n) { return n.heartbeat.node_id == nodeId; });
+}
+
+// ─── Fast path (UDP multicast + TCP link) ────────────────────────────────────
+
+void MonitorApp::handleFastPathMessages()
+{
+    SR_PERF_SCOPE("app.fastPath");
+    if (m_udpNotify.isRunning())
+    {
+        for (const auto& msg : m_udpNotify.poll())
+            handleFastPathMessage(msg, false);
+    }
+    if (m_tcpLink.isRunning())
+    {
+        for (const auto& msg : m_tcpLink.poll())
+            handleFastPathMessage(msg, true);
+    }
+}
+
+void MonitorApp::handleFastPathMessage(const nlohmann::json& msg, bool viaTcp)
+{
+    std::string type = msg.value("t", "");
+    if (type == "hb")
+    {
+        // A peer flipping to idle is a dispatch opportunity
+        if (m_heartbeatManager.processUdpHeartbeat(msg) && m_isCoordinator)
+            m_dispatchManager.wake();
+        return;
+    }
+    if (type == "bye")
+    {
+        m_heartbeatManager.processUdpGoodbye(msg);
+        return;
+    }
+    if (type == "dd" || type == "dg")
+    {
+        // One ordered stream per replica: with the link up, the multicast
+        // copies would only look like sequence gaps
+        if (!m_isCoordinator && (viaTcp || m_tcpLink.peerCount() == 0))
+            m_uiDataCache->applyReplicaMessage(msg);
+        return;
+    }
+
+    // Commands are targeted — ignore if not addressed to us
+    std::string target = msg.value("target", "");
+    if (!target.empty() && target != m_identity.nodeId())
+        return;
+
+    if (type == "ack")
+    {
+        m_commandManager.onAck(msg);
+        return;
+    }
+    if (!target.empty())
+        m_commandManager.acknowledge(msg);
+
+    std::string msgId = msg.value("msg_id", "");
+    if (msgId.empty() || m_dedup.isDuplicate(msgId))
+        return;
+
+    CommandManager::Action action;
+    action.type = msg.value("type", "");
+    action.jobId = msg.value("job_id", "");
+    action.reason = msg.value("reason", "");
+    action.frameStart = msg.value("frame_start", 0);
+    action.frameEnd = msg.value("frame_end", 0);
+    action.framesDone = msg.value("frames_done", "");
+    action.fromNodeId = msg.value("from", "");
+    action.msgId = msgId;
+    action.traceId = msg.value("trace_id", "");
+    action.sentMs = msg.value("timestamp_ms", int64_t(0));
+    action.receivedUs = ChunkTrace::nowUs();
+    action.via = viaTcp ? "tcp" : "udp";
+
+    if (!action.type.empty())
+        processAction(action);
+}
+
+void MonitorApp::startTcpLink()
+{
+    if (!tcpLinkActive(m_config))
+        return;
+
+    if (m_isCoordinator)
+    {
+        if (m_tcpLink.listen(m_identity.nodeId(), m_config.tcp_port))
+        {
+            m_heartbeatManager.setTcpPort(m_config.tcp_port);
+            MonitorLog::instance().info("tcp", "Control link listening on port " + std::to_string(m_config.tcp_port));
+        }
+        else
+        {
+            MonitorLog::instance().warn("tcp", "Control link port " + std::to_string(m_config.tcp_port) +
+                                        " unavailable, workers stay on UDP/filesystem");
+        }
+    }
+    else
+    {
+        m_tcpLink.startClient(m_identity.nodeId());
+        m_lastTcpTargetCheck = {};
+    }
+
+    if (m_tcpLink.isRunning())
+        m_commandManager.setTcpLink(&m_tcpLink);
+}
+
+void MonitorApp::updateTcpLinkTarget()
+{
+    auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
+    const NodeInfo* coord = nullptr;
+    if (m_shards.isSharded())
+    {
+        // The shard dispatching to us: home, or the one we're lent to
+        Heartbeat self;
+        self.node_id = m_identity.nodeId();
+        self.work_for = m_workFor;
+        std::string target = m_shards.dispatcherFor(self);
+        for (const auto& n : nodes)
+        {
+            if (n.heartbeat.node_id == target && !n.isDead)
+                coord = &n;
+        }
+    }
+    else
+    {
+        coord = rulingCoordinator(nodes);
+    }
+
+    if (!coord || coord->isLocal || coord->heartbeat.tcp_port == 0)
+    {
+        m_tcpLink.disconnect();
+        return;
+    }
+
+    // The address its datagrams come from beats a hostname lookup
+    std::string host = m_udpNotify.peerAddress(coord->heartbeat.node_id);
+    if (host.empty())
+        host = coord->heartbeat.hostname;
+    if (host.empty())
+        return;
+
+    m_tcpLink.connectTo(coord->heartbeat.node_id, host, coord->heartbeat.tcp_port);
+}
+
+void MonitorApp::sendFastHeartbeat()
+{
+    if (!m_udpNotify.isRunning() && !m_tcpLink.isRunning()) return;
 
     auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
 
-    m_udpNotify.send({
+    nlohmann::json hb = {
         {"t", "hb"},
         {"from", m_identity.nodeId()},
         {"n", m_identity.nodeId()},
         {"seq", m_heartbeatManager.localSeq()},
         {"ts", now},
-        {"st", m_nodeState == NodeState::Active ? "active" : "stopped"},
+        {"st", m_parked ? "sleeping" : m_nodeState == NodeState::Active ? "active" : "stopped"},
         {"rs", m_renderCoordinator.isRendering() ? "rendering" : "idle"},
-        {"coord", m_config.is_coordinator},
+        {"coord", m_isCoordinator},
         {"job", m_renderCoordinator.isRendering()
             ? nlohmann::json(m_renderCoordinator.currentJobId())
             : nlohmann::json(nullptr)},
-    });
+        {"fr", m_renderCoordinator.currentChunkLabel()},
+        {"sl", m_renderCoordinator.slotCount()},
+        {"fs", m_renderCoordinator.freeSlots()},
+        {"ld", m_heartbeatManager.localLoad()},
+    };
+    if (m_renderCoordinator.slotCount() > 1)
+        hb["jobs"] = m_renderCoordinator.activeJobIds();
+    if (m_isCoordinator && m_tcpLink.listenPort() != 0)
+        hb["tcp"] = m_tcpLink.listenPort();
+    if (m_isCoordinator)
+        hb["cep"] = m_coordEpoch;
+    else if (m_config.standby_coordinator)
+        hb["sb"] = true;
+    if (m_isShard)
+    {
+        hb["shd"] = true;
+        hb["spd"] = m_dispatchManager.pendingChunks();
+    }
+    if (!m_workFor.empty())
+        hb["wf"] = m_workFor;
+
+    // Over the link this also keeps the connection (and its idle timer) alive
+    m_udpNotify.send(hb);
+    m_tcpLink.broadcast(hb);
 }
 
 void MonitorApp::processAction(const CommandManager::Action& action)
 {
+    if ((action.type == "assign_chunk" || action.type == "abort_chunk" || action.type == "sleep") &&
+        isSupersededCoordinator(action.fromNodeId))
+    {
+        MonitorLog::instance().warn("farm", "Ignoring " + action.type + " from superseded coordinator " +
+                                    action.fromNodeId);
+        return;
+    }
+
     if (action.type == "assign_chunk")
     {
         handleAssignChunk(action);
     }
     else if (action.type == "abort_chunk")
     {
-        if (m_renderCoordinator.currentJobId() == action.jobId)
-            m_renderCoordinator.abortCurrentRender("Coordinator abort: " + action.reason);
-        m_renderCoordinator.purgeJob(action.jobId);
-        // Clear deferred assignments for this job
+        // Chunk-scoped: other prefetched chunks of the same job stay queued
+        ChunkRange chunk{action.frameStart, action.frameEnd};
+        m_renderCoordinator.abortChunk(action.jobId, chunk, "Coordinator abort: " + action.reason);
+        m_renderCoordinator.purgeChunk(action.jobId, chunk);
+        // Clear deferred assignment for this chunk
         std::erase_if(m_deferredAssignments,
-            [&](const DeferredAssignment& da) { return da.action.jobId == action.jobId; });
+            [&](const DeferredAssignment& da) {
+                return da.action.jobId == action.jobId &&
+                       da.action.frameStart == action.frameStart &&
+                       da.action.frameEnd == action.frameEnd;
+            });
     }
     else if (action.type == "chunk_completed" || action.type == "chunk_failed")
     {
-        if (m_config.is_coordinator)
-            m_dispatchManager.processAction(action);
+        if (m_isCoordinator && !forwardToShardOwner(action))
+        {
+            // A forwarded report names the worker that sent it
+            CommandManager::Action report = action;
+            if (report.reason.rfind(FORWARDED_PREFIX, 0) == 0)
+                report.fromNodeId = report.reason.substr(std::char_traits<char>::length(FORWARDED_PREFIX));
+            m_dispatchManager.processAction(report);
+        }
     }
     else if (action.type == "stop_job")
     {
-        if (m_renderCoordinator.currentJobId() == action.jobId)
-            m_renderCoordinator.abortCurrentRender("Remote stop: " + action.reason);
+        m_renderCoordinator.abortJob(action.jobId, "Remote stop: " + action.reason);
         m_renderCoordinator.purgeJob(action.jobId);
         // Clear deferred assignments for this job
         std::erase_if(m_deferredAssignments,
@@ -542,28 +1152,95 @@ void MonitorApp::processAction(const CommandManager::Action& action)
     {
         setNodeState(NodeState::Active);
     }
+    else if (action.type == "sleep")
+    {
+        handleSleepRequest(action);
+    }
     else if (action.type == "submission_available")
     {
-        if (m_config.is_coordinator)
+        if (m_isCoordinator)
             m_submissionManager.wakeUp();
     }
 }
 
-// ─── Worker: handle assign_chunk ─────────────────────────────────────────────
+// ─── Worker: sleep on request ────────────────────────────────────────────────
 
-void MonitorApp::handleAssignChunk(const CommandManager::Action& action)
+void MonitorApp::handleSleepRequest(const CommandManager::Action& action)
 {
-    if (m_renderCoordinator.isRendering())
+    if (m_parked)
+        return;
+    if (!m_config.allow_remote_sleep)
     {
-        // Already busy — report failure back to coordinator
-        std::string coordId = findCoordinatorNodeId();
-        if (!coordId.empty())
+        MonitorLog::instance().info("farm", "Ignoring sleep from " + action.fromNodeId +
+                                    ": remote sleep not allowed on this node");
+        return;
+    }
+    // The coordinator's view may be a heartbeat old
+    if (m_isCoordinator || m_nodeState != NodeState::Active || m_renderCoordinator.isRendering() ||
+        m_renderCoordinator.queuedCount() > 0 || m_renderCoordinator.pendingUploads() > 0 ||
+        !m_deferredAssignments.empty())
+    {
+        MonitorLog::instance().info("farm", "Ignoring sleep from " + action.fromNodeId + ": work in progress");
+        return;
+    }
+
+    MonitorLog::instance().info("farm", "Going to sleep (requested by " + action.fromNodeId + ")");
+    m_parked = true;
+    m_parkedAt = std::chrono::steady_clock::now();
+    m_heartbeatManager.setParked(true);
+    sendFastHeartbeat();
+    m_udpNotify.flush();
+    m_lastUdpHeartbeat = m_parkedAt;
+
+    if (!suspendSystem())
+    {
+        MonitorLog::instance().warn("farm", "Sleep failed: the OS refused to suspend");
+        unpark();
+    }
+}
+
+void MonitorApp::checkParkedResume()
+{
+    auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (m_parked)
+    {
+        // The loop doesn't tick while suspended; the first tick after shows the gap
+        bool slept = m_lastTickWallMs > 0 && wallMs - m_lastTickWallMs >= RESUME_GAP_MS;
+        if (slept)
         {
-            m_commandManager.sendCommand(coordId, "chunk_failed", action.jobId,
-                                         "worker_busy", action.frameStart, action.frameEnd);
+            MonitorLog::instance().info("farm", "Resumed from sleep");
+            unpark();
+        }
+        else if (std::chrono::steady_clock::now() - m_parkedAt >= std::chrono::milliseconds(PARK_GRACE_MS))
+        {
+            MonitorLog::instance().warn("farm", "Still awake " + std::to_string(PARK_GRACE_MS / 1000) +
+                                        "s after a sleep request; back to active");
+            unpark();
         }
-        return;
     }
+    m_lastTickWallMs = wallMs;
+}
+
+void MonitorApp::unpark()
+{
+    m_parked = false;
+    m_heartbeatManager.setParked(false);
+    sendFastHeartbeat();
+    m_lastUdpHeartbeat = std::chrono::steady_clock::now();
+}
+
+// ─── Worker: handle assign_chunk ─────────────────────────────────────────────
+
+void MonitorApp::handleAssignChunk(const CommandManager::Action& action)
+{
+    // Busy is fine — the coordinator prefetches chunks ahead of the active one,
+    // and RenderCoordinator picks the next one up as soon as the current finishes.
+    // Only ignore re-deliveries of a chunk we already hold.
+    ChunkRange assigned{action.frameStart, action.frameEnd};
+    if (m_renderCoordinator.hasChunk(action.jobId, assigned))
+        return;
+    traceDelivery(action);
 
     // Read manifest from disk (may not have propagated across NAS yet)
     auto manifestPath = m_farmPath / "jobs" / action.jobId / "manifest.json";
@@ -572,7 +1249,7 @@ void MonitorApp::handleAssignChunk(const CommandManager::Action& action)
     {
         // Defer for retry — manifest likely hasn't synced from coordinator yet
         m_deferredAssignments.push_back({action, 0,
-            std::chrono::steady_clock::now() + std::chrono::milliseconds(500)});
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(500), ChunkTrace::nowUs()});
         MonitorLog::instance().info("farm", "Deferring assignment (manifest not yet available): " + action.jobId);
         return;
     }
@@ -584,14 +1261,14 @@ void MonitorApp::handleAssignChunk(const CommandManager::Action& action)
         chunk.frame_start = action.frameStart;
         chunk.frame_end = action.frameEnd;
 
-        m_renderCoordinator.queueDispatch(manifest, chunk);
+        m_renderCoordinator.queueDispatch(manifest, chunk, action.traceId);
         MonitorLog::instance().info("farm", "Accepted assignment: job=" + action.jobId +
             " chunk=" + chunk.rangeStr());
     }
     catch (const std::exception& e)
     {
         MonitorLog::instance().error("farm", "Failed to parse manifest: " + std::string(e.what()));
-        std::string coordId = findCoordinatorNodeId();
+        std::string coordId = coordinatorFor(action.jobId);
         if (!coordId.empty())
         {
             m_commandManager.sendCommand(coordId, "chunk_failed", action.jobId,
@@ -600,24 +1277,77 @@ void MonitorApp::handleAssignChunk(const CommandManager::Action& action)
     }
 }
 
-// ─── Worker: flush buffered completions ──────────────────────────────────────
+// ─── Worker: chunk trace ─────────────────────────────────────────────────────
 
-void MonitorApp::flushPendingCompletions()
+void MonitorApp::traceDelivery(const CommandManager::Action& action)
 {
-    std::string coordId = findCoordinatorNodeId();
-    if (coordId.empty())
-        return; // Still no coordinator — try again next update
+    auto& trace = ChunkTrace::instance();
+    if (action.traceId.empty() || !trace.enabled())
+        return;
 
-    for (const auto& pc : m_pendingCompletions)
+    // Starts on the coordinator's clock, so these carry the offset between the two
+    ChunkRange chunk{action.frameStart, action.frameEnd};
+    int64_t sentUs = action.sentMs * 1000;
+    int64_t nowUs = ChunkTrace::nowUs();
+    if (action.via != "inbox")
     {
+        trace.record(action.jobId, action.traceId, chunk, "fast_path", sentUs, nowUs, {{"via", action.via}});
+    }
+    else if (action.seenUs > 0)
+    {
+        trace.record(action.jobId, action.traceId, chunk, "sync_propagation", sentUs, action.seenUs);
+        trace.record(action.jobId, action.traceId, chunk, "inbox_poll", action.seenUs, nowUs);
+    }
+    else
+    {
+        // No watcher event: when the file landed is unknown
+        trace.record(action.jobId, action.traceId, chunk, "sync_and_poll", sentUs, nowUs);
+    }
+}
+
+// ─── Worker: flush buffered completions ──────────────────────────────────────
+
+void MonitorApp::flushPendingCompletions()
+{
+    // Per job: with shards, each goes to its job's owner once that's live
+    size_t flushed = 0;
+    std::erase_if(m_pendingCompletions, [&](const PendingCompletion& pc) {
+        std::string coordId = coordinatorFor(pc.jobId);
+        if (coordId.empty())
+            return false; // Still no coordinator — try again next update
         std::string cmdType = (pc.state == "completed") ? "chunk_completed" : "chunk_failed";
         m_commandManager.sendCommand(coordId, cmdType, pc.jobId, pc.state,
-                                     pc.chunk.frame_start, pc.chunk.frame_end);
-    }
+                                     pc.chunk.frame_start, pc.chunk.frame_end, pc.framesDone);
+        ++flushed;
+        return true;
+    });
 
-    MonitorLog::instance().info("farm", "Flushed " + std::to_string(m_pendingCompletions.size()) +
-                                " buffered completion(s) to coordinator");
-    m_pendingCompletions.clear();
+    if (flushed > 0)
+        MonitorLog::instance().info("farm", "Flushed " + std::to_string(flushed) +
+                                    " buffered completion(s) to coordinator");
+}
+
+// ─── Worker: input cache prefetch ────────────────────────────────────────────
+
+void MonitorApp::prefetchNextJobInputs()
+{
+    // Highest-priority active job this node could take but isn't rendering
+    auto rendering = m_renderCoordinator.activeJobIds();
+    for (const auto& job : m_jobSnapshot->jobs)
+    {
+        if (job.current_state != "active" ||
+            std::find(rendering.begin(), rendering.end(), job.manifest.job_id) != rendering.end())
+            continue;
+        bool tagsOk = std::all_of(job.manifest.tags_required.begin(), job.manifest.tags_required.end(),
+            [&](const std::string& t) {
+                return std::find(m_config.tags.begin(), m_config.tags.end(), t) != m_config.tags.end();
+            });
+        if (!tagsOk || job.manifest.cmd.find(getOS()) == job.manifest.cmd.end())
+            continue;
+
+        m_renderCoordinator.prefetchInputs(job.manifest);
+        return;
+    }
 }
 
 // ─── Worker: process deferred assignments ────────────────────────────────────
@@ -637,19 +1367,6 @@ void MonitorApp::processDeferredAssignments()
             continue;
         }
 
-        // If we started rendering something else in the meantime, fail this one
-        if (m_renderCoordinator.isRendering())
-        {
-            std::string coordId = findCoordinatorNodeId();
-            if (!coordId.empty())
-            {
-                m_commandManager.sendCommand(coordId, "chunk_failed", it->action.jobId,
-                                             "worker_busy", it->action.frameStart, it->action.frameEnd);
-            }
-            it = m_deferredAssignments.erase(it);
-            continue;
-        }
-
         auto manifestPath = m_farmPath / "jobs" / it->action.jobId / "manifest.json";
         auto data = AtomicFileIO::safeReadJson(manifestPath);
 
@@ -662,7 +1379,10 @@ void MonitorApp::processDeferredAssignments()
                 chunk.frame_start = it->action.frameStart;
                 chunk.frame_end = it->action.frameEnd;
 
-                m_renderCoordinator.queueDispatch(manifest, chunk);
+                ChunkTrace::instance().record(manifest.job_id, it->action.traceId, chunk, "manifest_wait",
+                                              it->deferredUs, ChunkTrace::nowUs(),
+                                              {{"retries", it->retryCount}});
+                m_renderCoordinator.queueDispatch(manifest, chunk, it->action.traceId);
                 MonitorLog::instance().info("farm", "Accepted deferred assignment: job=" + it->action.jobId +
                     " chunk=" + chunk.rangeStr() + " (retry " + std::to_string(it->retryCount) + ")");
             }
@@ -706,28 +1426,23 @@ void MonitorApp::pauseJob(const std::string& jobId)
 
     // Get current priority
     int priority = 50;
-    for (const auto& j : m_cachedJobs)
-    {
-        if (j.manifest.job_id == jobId)
-        {
-            priority = j.current_priority;
-            break;
-        }
-    }
+    if (const auto* j = m_jobSnapshot->find(jobId))
+        priority = j->current_priority;
 
     m_jobManager.writeStateEntry(m_farmPath, jobId, "paused", priority, m_identity.nodeId());
 
-    // Kill current render if it's this job
-    if (m_renderCoordinator.currentJobId() == jobId)
-        m_renderCoordinator.abortCurrentRender("Job paused");
+    // Kill current render if it's this job, and drop any prefetched chunks
+    m_renderCoordinator.abortJob(jobId, "Job paused");
+    m_renderCoordinator.purgeJob(jobId);
 
-    if (m_config.is_coordinator)
+    if (m_isCoordinator)
     {
         m_dispatchManager.handleJobStateChange(jobId, "paused");
     }
 
     // Notify peers
-    auto nodes = m_heartbeatManager.getNodeSnapshot();
+    auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
     for (const auto& n : nodes)
     {
         if (n.isLocal || n.isDead) continue;
@@ -742,18 +1457,12 @@ void MonitorApp::resumeJob(const std::string& jobId)
     if (!m_farmRunning) return;
 
     int priority = 50;
-    for (const auto& j : m_cachedJobs)
-    {
-        if (j.manifest.job_id == jobId)
-        {
-            priority = j.current_priority;
-            break;
-        }
-    }
+    if (const auto* j = m_jobSnapshot->find(jobId))
+        priority = j->current_priority;
 
     m_jobManager.writeStateEntry(m_farmPath, jobId, "active", priority, m_identity.nodeId());
 
-    if (m_config.is_coordinator)
+    if (m_isCoordinator)
     {
         m_dispatchManager.handleJobStateChange(jobId, "active");
     }
@@ -767,17 +1476,18 @@ void MonitorApp::cancelJob(const std::string& jobId)
 
     m_jobManager.writeStateEntry(m_farmPath, jobId, "cancelled", 0, m_identity.nodeId());
 
-    // Abort current render if it's this job
-    if (m_renderCoordinator.currentJobId() == jobId)
-        m_renderCoordinator.abortCurrentRender("Job cancelled");
+    // Abort current render if it's this job, and drop any prefetched chunks
+    m_renderCoordinator.abortJob(jobId, "Job cancelled");
+    m_renderCoordinator.purgeJob(jobId);
 
-    if (m_config.is_coordinator)
+    if (m_isCoordinator)
     {
         m_dispatchManager.handleJobStateChange(jobId, "cancelled");
     }
 
     // Notify peers
-    auto nodes = m_heartbeatManager.getNodeSnapshot();
+    auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
     for (const auto& n : nodes)
     {
         if (n.isLocal || n.isDead) continue;
@@ -792,20 +1502,12 @@ void MonitorApp::requeueJob(const std::string& jobId)
     if (!m_farmRunning) return;
 
     // Find the source job
-    const JobInfo* source = nullptr;
-    for (const auto& j : m_cachedJobs)
-    {
-        if (j.manifest.job_id == jobId)
-        {
-            source = &j;
-            break;
-        }
-    }
+    // Hold the snapshot: submitJob() below may publish a new one
+    auto snapshot = m_jobSnapshot;
+    const JobInfo* source = snapshot->find(jobId);
     if (!source) return;
 
     // Build new slug: strip any existing "-requeueN" suffix, then find next number
-    namespace fs = std::filesystem;
-    std::error_code ec;
     auto jobsDir = m_farmPath / "jobs";
 
     std::string baseSlug = jobId;
@@ -816,10 +1518,10 @@ void MonitorApp::requeueJob(const std::string& jobId)
     // Find highest existing requeue number to avoid recycling old numbers
     int maxN = 0;
     std::string prefix = baseSlug + "-requeue";
-    for (auto& entry : fs::directory_iterator(jobsDir, ec))
+    for (const auto& entry : FarmStorage::current().list(jobsDir))
     {
-        if (!entry.is_directory(ec)) continue;
-        std::string name = entry.path().filename().string();
+        if (!entry.isDir) continue;
+        const std::string& name = entry.name;
         if (name.size() > prefix.size() && name.substr(0, prefix.size()) == prefix)
         {
             try { int n = std::stoi(name.substr(prefix.size())); if (n > maxN) maxN = n; }
@@ -862,13 +1564,10 @@ void MonitorApp::deleteJob(const std::string& jobId)
     cancelJob(jobId);
 
     // Delete entire job directory
-    namespace fs = std::filesystem;
-    std::error_code ec;
     auto jobDir = m_farmPath / "jobs" / jobId;
-    fs::remove_all(jobDir, ec);
-    if (ec)
+    if (!FarmStorage::current().removeAll(jobDir))
     {
-        MonitorLog::instance().error("job", "Failed to delete job dir: " + ec.message());
+        MonitorLog::instance().error("job", "Failed to delete job dir: " + jobDir.string());
     }
 
     m_jobManager.invalidate();
@@ -881,13 +1580,13 @@ void MonitorApp::deleteJob(const std::string& jobId)
 
 void MonitorApp::reassignChunk(const std::string& jobId, int frameStart, int frameEnd)
 {
-    if (!m_farmRunning || !m_config.is_coordinator) return;
+    if (!m_farmRunning || !m_isCoordinator) return;
     m_dispatchManager.reassignChunk(jobId, frameStart, frameEnd);
 }
 
 void MonitorApp::retryFailedChunk(const std::string& jobId, int frameStart, int frameEnd)
 {
-    if (!m_farmRunning || !m_config.is_coordinator) return;
+    if (!m_farmRunning || !m_isCoordinator) return;
     m_dispatchManager.retryFailedChunk(jobId, frameStart, frameEnd);
 }
 
@@ -901,17 +1600,16 @@ void MonitorApp::setNodeState(NodeState state)
     {
     case NodeState::Active:
         m_renderCoordinator.setStopped(false);
-        if (m_config.is_coordinator)
+        if (m_isCoordinator)
             m_dispatchManager.setNodeActive(true);
         m_heartbeatManager.setNodeState("active");
         MonitorLog::instance().info("farm", "Node state: Active");
         break;
 
     case NodeState::Stopped:
-        if (m_renderCoordinator.isRendering())
-            m_renderCoordinator.abortCurrentRender("Node stopped");
+        m_renderCoordinator.abortAll("Node stopped");
         m_renderCoordinator.setStopped(true);
-        if (m_config.is_coordinator)
+        if (m_isCoordinator)
             m_dispatchManager.setNodeActive(false);
         m_heartbeatManager.setNodeState("stopped");
         MonitorLog::instance().info("farm", "Node state: Stopped");
@@ -919,10 +1617,71 @@ void MonitorApp::setNodeState(NodeState state)
     }
 
     // Immediately broadcast state change so peers see it within ~50ms
-    sendUdpHeartbeat();
+    sendFastHeartbeat();
     m_lastUdpHeartbeat = std::chrono::steady_clock::now();
 }
 
+// ─── Farm index ─────────────────────────────────────────────────────────────
+
+void MonitorApp::saveFarmIndex(bool force)
+{
+    // Until the first reconcile the file on disk is as good as what we hold
+    if (!m_farmRunning || m_jobSnapshot->provisional)
+        return;
+
+    auto progress = m_uiDataCache->getProgressSnapshot();
+    uint64_t rev = 0;
+    auto mix = [&rev](uint64_t v) { rev = (rev ^ v) * 0x100000001b3ull; };
+    mix(m_jobSnapshot->version);
+    mix(m_templateSnapshot->version);
+    mix(progress->version);
+    if (rev == m_indexSavedRevision)
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (!force && std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastIndexSave).count() < INDEX_SAVE_MS)
+        return;
+    m_lastIndexSave = now;
+
+    FarmIndex::Data data;
+    data.jobs = m_jobManager.indexedJobs();
+    data.templates = m_templateSnapshot->templates;
+    data.progress = progress->jobs;
+    if (FarmIndex::save(m_farmIndexPath, m_farmPath, data))
+        m_indexSavedRevision = rev;
+    else
+        MonitorLog::instance().warn("farm", "Failed to save farm index " + m_farmIndexPath.string());
+}
+
+// ─── UI revision ────────────────────────────────────────────────────────────
+
+uint64_t MonitorApp::uiRevision() const
+{
+    uint64_t rev = 0;
+    auto mix = [&rev](uint64_t v) { rev = (rev ^ v) * 0x100000001b3ull; };
+
+    mix(m_farmRunning);
+    mix(static_cast<uint64_t>(m_nodeState));
+    mix(m_exitRequested);
+    mix(MonitorLog::instance().revision());
+    mix(m_thumbnailCache.revision());
+    for (const auto& agent : m_agents)
+        mix(std::hash<std::string>{}(agent->agentState()));
+    if (!m_farmRunning)
+        return rev;
+
+    mix(m_jobSnapshot->version);
+    mix(m_templateSnapshot->version);
+    mix(m_heartbeatManager.getNodeSnapshot()->version);
+    mix(m_uiDataCache->getProgressSnapshot()->version);
+    mix(reinterpret_cast<uintptr_t>(m_uiDataCache->getFrameStateSnapshot().get()));
+    if (m_isCoordinator)
+        mix(m_dispatchManager.tablesVersion());
+    mix(m_renderCoordinator.activeCount());
+    mix(static_cast<uint64_t>(m_renderCoordinator.currentProgress() * 10.0f));     // 0.1% steps
+    return rev;
+}
+
 // ─── Tray state ─────────────────────────────────────────────────────────────
 
 TrayIconState MonitorApp::trayState() const
@@ -930,7 +1689,7 @@ TrayIconState MonitorApp::trayState() const
     if (!m_farmRunning || m_nodeState == NodeState::Stopped)
         return TrayIconState::Gray;
 
-    if (!m_agentSupervisor.isAgentConnected() && m_agentSupervisor.agentPid() != 0)
+    if (anyAgentLost())
         return TrayIconState::Red;
 
     if (m_renderCoordinator.isRendering())
@@ -949,7 +1708,7 @@ std::string MonitorApp::trayTooltip() const
     if (m_nodeState == NodeState::Stopped)
         return prefix + " — Stopped";
 
-    if (!m_agentSupervisor.isAgentConnected() && m_agentSupervisor.agentPid() != 0)
+    if (anyAgentLost())
         return prefix + " — Agent disconnected";
 
     if (m_renderCoordinator.isRendering())
@@ -988,7 +1747,7 @@ void MonitorApp::requestExit()
 
 void MonitorApp::beginForceExit()
 {
-    m_renderCoordinator.abortCurrentRender("Force exit");
+    m_renderCoordinator.abortAll("Force exit");
     m_shouldExit = true;
     MonitorLog::instance().info("farm", "Exit: kill and exit");
 }
@@ -999,8 +1758,285 @@ void MonitorApp::cancelExit()
     MonitorLog::instance().info("farm", "Exit cancelled");
 }
 
+// ─── Agents ─────────────────────────────────────────────────────────────────
+
+void MonitorApp::startAgents()
+{
+    // Slot 0 keeps the plain node id, so single-slot nodes look as before
+    int slots = renderSlotCount(m_config);
+    for (int i = 0; i < slots; ++i)
+    {
+        auto agent = std::make_unique<AgentSupervisor>();
+        std::string agentId = m_identity.nodeId();
+        if (i > 0)
+            agentId += ".s" + std::to_string(i);
+
+        if (i < static_cast<int>(m_config.render_slot_pins.size()))
+        {
+            const auto& pin = m_config.render_slot_pins[i];
+            agent->setPin(pin.env, pin.cpu_set);
+        }
+
+        agent->start(agentId);
+        if (m_config.auto_start_agent)
+            agent->spawnAgent();
+        m_agents.push_back(std::move(agent));
+    }
+}
+
+std::vector<AgentSupervisor*> MonitorApp::agentPointers() const
+{
+    std::vector<AgentSupervisor*> agents;
+    for (const auto& agent : m_agents)
+        agents.push_back(agent.get());
+    return agents;
+}
+
+bool MonitorApp::anyAgentLost() const
+{
+    for (const auto& agent : m_agents)
+    {
+        if (!agent->isAgentConnected() && agent->agentPid() != 0)
+            return true;
+    }
+    return false;
+}
+
 // ─── Config ─────────────────────────────────────────────────────────────────
 
+void MonitorApp::applyMetricsExport()
+{
+    m_metricsExporter.configure(m_config.metrics_export_path, m_config.metrics_export_interval_sec);
+    if (m_metricsExporter.enabled())
+        MonitorLog::instance().info("farm", "Exporting metrics to " + m_config.metrics_export_path);
+}
+
+void MonitorApp::applyChunkTracing()
+{
+    ChunkTrace::instance().setEnabled(m_config.chunk_tracing);
+}
+
+void MonitorApp::applyPowerSettings()
+{
+    m_heartbeatManager.setAllowSleep(m_config.allow_remote_sleep);
+    if (m_isCoordinator)
+        m_dispatchManager.setPowerPolicy(m_config.power);
+}
+
+bool MonitorApp::exportJobTrace(const std::string& jobId)
+{
+    if (m_farmPath.empty())
+        return false;
+
+    auto trace = ChunkTrace::exportJob(m_farmPath, jobId);
+    if (trace.is_null())
+    {
+        MonitorLog::instance().warn("trace", "No chunk trace recorded for job " + jobId);
+        return false;
+    }
+
+    auto dir = getAppDataDir() / "traces";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    auto path = dir / (jobId + ".trace.json");
+    if (!AtomicFileIO::writeJson(path, trace))
+    {
+        MonitorLog::instance().error("trace", "Failed to write " + path.string());
+        return false;
+    }
+
+    MonitorLog::instance().info("trace", "Exported chunk trace to " + path.string() +
+                                " (open in ui.perfetto.dev or chrome://tracing)");
+    openFolderInExplorer(dir);
+    return true;
+}
+
+void MonitorApp::applyArchiving()
+{
+    m_archiveManager.setArchiveAfterDays(runsFarmChores() ? m_config.archive_after_days : 0);
+}
+
+bool MonitorApp::runsFarmChores() const
+{
+    return m_isCoordinator && (!m_isShard || m_shards.primary() == m_identity.nodeId());
+}
+
+void MonitorApp::applyFarmChores()
+{
+    bool chores = runsFarmChores();
+    m_jobManager.setStateCompaction(chores);
+    if (chores && !m_submissionManager.isRunning())
+        startSubmissionInbox();
+    else if (!chores && m_submissionManager.isRunning())
+        m_submissionManager.stop();
+    applyArchiving();
+}
+
+// ─── Coordinator shards ─────────────────────────────────────────────────────
+
+void MonitorApp::checkShardRole()
+{
+    std::string previousPrimary = m_shards.primary();
+    if (auto shards = CoordinatorShards::peek(m_farmPath))
+        m_shards = std::move(*shards);
+
+    if (!m_isShard)
+    {
+        if (!m_isCoordinator)
+            updateWorkLease();
+        return;
+    }
+
+    const auto& self = m_identity.nodeId();
+    if (!m_shards.contains(self))
+    {
+        // Pruned while unreachable, or dropped by a concurrent join: our
+        // dispatcher released everything when it saw us go
+        uint64_t epoch = CoordinatorShards::join(m_farmPath, self, m_shards.epoch);
+        if (epoch != 0)
+        {
+            m_coordEpoch = epoch;
+            m_heartbeatManager.setCoordinatorEpoch(epoch);
+            m_shards = CoordinatorShards::read(m_farmPath).value_or(m_shards);
+            MonitorLog::instance().warn("farm", "Not listed in coordinators.json, rejoined (epoch " +
+                                        std::to_string(epoch) + ")");
+        }
+    }
+    else
+    {
+        // The lowest live member prunes members that died without leaving,
+        // once discovery has settled (peers count as dead until seen)
+        int64_t settleMs = int64_t(m_config.timing.dead_threshold_scans + 1) * m_config.timing.scan_interval_ms;
+        if (std::chrono::steady_clock::now() - m_farmStartedAt >= std::chrono::milliseconds(settleMs))
+        {
+            auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+            std::vector<std::string> dead;
+            bool lowestLive = true;
+            for (const auto& m : m_shards.members)
+            {
+                if (m.node_id == self)
+                    continue;
+                auto it = std::find_if(nodeSnapshot->nodes.begin(), nodeSnapshot->nodes.end(),
+                    [&](const NodeInfo& n) { return n.heartbeat.node_id == m.node_id; });
+                if (it == nodeSnapshot->nodes.end() || (it->isDead && it->reclaimEligible))
+                    dead.push_back(m.node_id);
+                else if (!it->isDead && m.node_id < self)
+                    lowestLive = false;
+            }
+            if (lowestLive && !dead.empty())
+            {
+                for (const auto& id : dead)
+                {
+                    if (CoordinatorShards::leave(m_farmPath, id))
+                        MonitorLog::instance().warn("farm", "Removed dead shard " + id + " from coordinators.json");
+                }
+                m_shards = CoordinatorShards::read(m_farmPath).value_or(m_shards);
+            }
+        }
+    }
+
+    m_heartbeatManager.setShardState(true, static_cast<int>(m_dispatchManager.pendingChunks()));
+    if (m_shards.primary() != previousPrimary)
+        applyFarmChores();
+}
+
+void MonitorApp::updateWorkLease()
+{
+    auto now = std::chrono::steady_clock::now();
+    bool idle = m_nodeState == NodeState::Active && !m_renderCoordinator.isRendering() &&
+                m_deferredAssignments.empty() &&
+                m_renderCoordinator.freeSlots() == m_renderCoordinator.slotCount();
+    if (!idle)
+        m_lastBusy = now;
+
+    auto endLease = [&](const std::string& why) {
+        MonitorLog::instance().info("farm", "Returned from shard " + m_workFor + ": " + why);
+        m_workFor.clear();
+        m_heartbeatManager.setWorkFor("");
+        sendFastHeartbeat();
+    };
+
+    if (m_shards.members.size() < 2)
+    {
+        if (!m_workFor.empty())
+            endLease("farm is no longer sharded");
+        return;
+    }
+
+    auto nodeSnapshot = m_heartbeatManager.getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
+    auto liveShard = [&](const std::string& id) -> const NodeInfo* {
+        for (const auto& n : nodes)
+        {
+            if (n.heartbeat.node_id == id)
+                return (!n.isDead && n.heartbeat.is_shard) ? &n : nullptr;
+        }
+        return nullptr;
+    };
+
+    const NodeInfo* home = liveShard(m_shards.homeOf(m_identity.nodeId()));
+    int homePending = home ? home->heartbeat.shard_pending : 0;
+
+    if (!m_workFor.empty())
+    {
+        const NodeInfo* lender = m_shards.contains(m_workFor) ? liveShard(m_workFor) : nullptr;
+        if (!lender)
+            endLease("shard is gone");
+        else if (homePending > 0)
+            endLease("home shard has work");
+        else if (idle && lender->heartbeat.shard_pending == 0)
+            endLease("backlog drained");
+        else if (idle && now - m_lastBusy >= std::chrono::milliseconds(WORK_LEASE_IDLE_MS))
+        {
+            // Its backlog isn't reaching us (holds, pools, tags): don't ask again soon
+            m_workLeaseCooldown[m_workFor] = now + std::chrono::milliseconds(WORK_LEASE_COOLDOWN_MS);
+            endLease("no work assigned");
+        }
+        return;
+    }
+
+    if (!idle || homePending > 0 || now - m_lastBusy < std::chrono::milliseconds(WORK_REQUEST_IDLE_MS))
+        return;
+
+    std::erase_if(m_workLeaseCooldown, [&](const auto& e) { return e.second <= now; });
+    const NodeInfo* best = nullptr;
+    for (const auto& n : nodes)
+    {
+        if (n.isDead || !n.heartbeat.is_shard || n.heartbeat.shard_pending <= 0 || (home && &n == home))
+            continue;
+        if (!m_shards.contains(n.heartbeat.node_id) || m_workLeaseCooldown.count(n.heartbeat.node_id))
+            continue;
+        if (!best || n.heartbeat.shard_pending > best->heartbeat.shard_pending)
+            best = &n;
+    }
+    if (!best)
+        return;
+
+    m_workFor = best->heartbeat.node_id;
+    m_lastBusy = now;   // the lease's idle clock starts here
+    m_heartbeatManager.setWorkFor(m_workFor);
+    sendFastHeartbeat();
+    MonitorLog::instance().info("farm", "Idle with home shard drained, lent to shard " +
+                                best->heartbeat.hostname + " (" + std::to_string(best->heartbeat.shard_pending) +
+                                " chunks pending)");
+}
+
+bool MonitorApp::forwardToShardOwner(const CommandManager::Action& action)
+{
+    // A report that's already been forwarded once stays here, even if the
+    // membership moved again: the journal carries it on in that case
+    if (!m_isShard || action.reason.rfind(FORWARDED_PREFIX, 0) == 0)
+        return false;
+    std::string owner = m_shards.ownerOf(action.jobId);
+    if (owner.empty() || owner == m_identity.nodeId())
+        return false;
+
+    m_commandManager.sendCommand(owner, action.type, action.jobId,
+                                 FORWARDED_PREFIX + action.fromNodeId,
+                                 action.frameStart, action.frameEnd, action.framesDone);
+    return true;
+}
+
 void MonitorApp::loadConfig()
 {
     auto data = AtomicFileIO::safeReadJson(m_configPath);
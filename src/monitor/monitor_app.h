@@ -1,8 +1,10 @@
 #pragma once
 
 #include "core/config.h"
+#include "core/coordinator_shards.h"
 #include "core/node_identity.h"
 #include "monitor/agent_supervisor.h"
+#include "monitor/archive_manager.h"
 #include "monitor/heartbeat_manager.h"
 #include "monitor/dispatch_manager.h"
 #include "monitor/render_coordinator.h"
@@ -11,7 +13,11 @@
 #include "monitor/command_manager.h"
 #include "monitor/submission_manager.h"
 #include "monitor/ui_data_cache.h"
+#include "monitor/dispatch_replica.h"
+#include "monitor/metrics_exporter.h"
+#include "monitor/thumbnail_cache.h"
 #include "core/udp_notify.h"
+#include "core/tcp_link.h"
 #include "core/message_dedup.h"
 #include "monitor/ui/dashboard.h"
 
@@ -32,12 +38,17 @@ public:
     // Phase 1 bootstrap: load node_id, load config, create dirs
     bool init();
 
-    // Called each frame — logic only (messages, commands, scans)
+    // Farm tick — logic only (messages, commands, scans). Runs on its own
+    // cadence in main.cpp, whether or not the UI draws.
     void update();
 
-    // Called each frame — UI rendering (only when window is visible, inside ImGui frame)
+    // UI rendering (only when window is visible, inside ImGui frame)
     void renderUI();
 
+    // Changes whenever something the panels show may have (snapshot versions,
+    // log appends, render progress); an idle window only redraws when it does
+    uint64_t uiRevision() const;
+
     // Save config and clean up
     void shutdown();
 
@@ -45,21 +56,38 @@ public:
     Config& config() { return m_config; }
     const Config& config() const { return m_config; }
     const NodeIdentity& identity() const { return m_identity; }
-    AgentSupervisor& agentSupervisor() { return m_agentSupervisor; }
+    AgentSupervisor& agentSupervisor(size_t slot = 0) { return *m_agents[slot]; }
+    size_t agentCount() const { return m_agents.size(); }
     HeartbeatManager& heartbeatManager() { return m_heartbeatManager; }
     DispatchManager& dispatchManager() { return m_dispatchManager; }
     TemplateManager& templateManager() { return m_templateManager; }
     JobManager& jobManager() { return m_jobManager; }
     RenderCoordinator& renderCoordinator() { return m_renderCoordinator; }
     CommandManager& commandManager() { return m_commandManager; }
+    ArchiveManager& archiveManager() { return m_archiveManager; }
+
+    // Re-read the metrics export settings from config()
+    void applyMetricsExport();
+    // Re-read archive_after_days from config(); only the coordinator archives
+    void applyArchiving();
+    // Re-read chunk_tracing from config()
+    void applyChunkTracing();
+    // Re-read allow_remote_sleep and the coordinator's power policy from config()
+    void applyPowerSettings();
+
+    // Merge a job's chunk trace spans from every node into a Chrome trace
+    // file under {app data}/traces and open the folder. False if there were none.
+    bool exportJobTrace(const std::string& jobId);
 
     // Cached snapshots (refreshed each frame from bg threads, zero FS)
-    const std::vector<JobInfo>& cachedJobs() const { return m_cachedJobs; }
-    const std::vector<JobTemplate>& cachedTemplates() const { return m_cachedTemplates; }
+    const std::vector<JobInfo>& cachedJobs() const { return m_jobSnapshot->jobs; }
+    const JobSnapshot& jobSnapshot() const { return *m_jobSnapshot; }
+    const std::vector<JobTemplate>& cachedTemplates() const { return m_templateSnapshot->templates; }
 
     // UIDataCache accessor
     UIDataCache& uiDataCache() { return *m_uiDataCache; }
     const UIDataCache& uiDataCache() const { return *m_uiDataCache; }
+    ThumbnailCache& thumbnailCache() { return m_thumbnailCache; }
 
     // Job controls (called from UI)
     void pauseJob(const std::string& jobId);
@@ -77,7 +105,8 @@ public:
     NodeState nodeState() const { return m_nodeState; }
 
     // Coordinator queries
-    bool isCoordinator() const { return m_config.is_coordinator; }
+    // Running role: a standby that took over is coordinator until the farm stops
+    bool isCoordinator() const { return m_farmRunning ? m_isCoordinator : m_config.is_coordinator; }
     std::string findCoordinatorNodeId() const;
 
     // Tray state (called each frame by main.cpp)
@@ -121,15 +150,54 @@ public:
 private:
     void loadConfig();
     void checkSubmitRequest();  // Poll for CLI submission signal file
-
-    // UDP multicast fast path
-    void handleUdpMessages();
-    void sendUdpHeartbeat();
+    void startAgents();         // one supervisor per render slot
+    std::vector<AgentSupervisor*> agentPointers() const;
+    bool anyAgentLost() const;  // spawned but not connected
+
+    // Fast path: UDP multicast and the TCP control link
+    void handleFastPathMessages();
+    void handleFastPathMessage(const nlohmann::json& msg, bool viaTcp);
+    void sendFastHeartbeat();
+    void startTcpLink();
+    void updateTcpLinkTarget();     // worker: follow the coordinator's advertised link
     void processAction(const CommandManager::Action& action);
 
     // Worker-side: handle assign_chunk from coordinator
     void handleAssignChunk(const CommandManager::Action& action);
 
+    // Worker-side: the coordinator's sleep command (Config::allow_remote_sleep).
+    // The node announces "sleeping", suspends, and reports active again once
+    // a gap in the tick clock shows it resumed (or it never went down).
+    void handleSleepRequest(const CommandManager::Action& action);
+    void checkParkedResume();
+    void unpark();
+    bool m_parked = false;
+    std::chrono::steady_clock::time_point m_parkedAt{};
+    int64_t m_lastTickWallMs = 0;
+    static constexpr int64_t PARK_GRACE_MS = 60000;     // not suspended by then: back to active
+    static constexpr int64_t RESUME_GAP_MS = 10000;     // wall-clock gap between ticks that means we slept
+
+    // Coordinator role: start/stop dispatch at farm start, standby takeover,
+    // or when a newer coordinator epoch shows up
+    void startCoordinatorServices(std::map<std::string, DispatchTable> seedTables);
+    void checkCoordinatorRole();
+    void promoteToCoordinator();
+    void demoteToWorker(const std::string& reason);
+    bool isSupersededCoordinator(const std::string& nodeId) const;  // commands from it are fenced
+    void reportCompletion(const std::string& jobId, const ChunkRange& chunk, const std::string& state,
+                          const std::string& framesDone);
+    void startSubmissionInbox();
+
+    // Sharded coordinators (see CoordinatorShards): every node follows the
+    // membership; a shard keeps its entry and prunes dead members, a worker
+    // asks for work from another shard while its home has none
+    void checkShardRole();
+    void applyFarmChores();             // submission inbox, archiving and compaction follow the primary
+    bool runsFarmChores() const;
+    std::string coordinatorFor(const std::string& jobId) const;    // where a job's reports go ("" = none live)
+    bool forwardToShardOwner(const CommandManager::Action& action);
+    void updateWorkLease();
+
     // Worker-side: retry sending buffered completions to coordinator
     void flushPendingCompletions();
 
@@ -138,7 +206,7 @@ private:
 
     NodeIdentity m_identity;
     Config m_config;
-    AgentSupervisor m_agentSupervisor;
+    std::vector<std::unique_ptr<AgentSupervisor>> m_agents;    // one per render slot
     HeartbeatManager m_heartbeatManager;
     DispatchManager m_dispatchManager;
     TemplateManager m_templateManager;
@@ -146,16 +214,42 @@ private:
     RenderCoordinator m_renderCoordinator;
     CommandManager m_commandManager;
     SubmissionManager m_submissionManager;
+    ArchiveManager m_archiveManager;
     std::unique_ptr<UIDataCache> m_uiDataCache;
     UdpNotify m_udpNotify;
+    TcpLink m_tcpLink;
+    std::chrono::steady_clock::time_point m_lastTcpTargetCheck{};
     MessageDedup m_dedup;
     std::chrono::steady_clock::time_point m_lastUdpHeartbeat{};
-    std::chrono::steady_clock::time_point m_lastDedupPurge{};
+    DispatchReplicaPublisher m_replicaPublisher;   // coordinator: dispatch deltas over UDP
+    MetricsExporter m_metricsExporter;
+    ThumbnailCache m_thumbnailCache;               // job detail frame previews (GL textures)
+    std::chrono::steady_clock::time_point m_lastReplicaDigest{};
+
+    // Coordinator role and fencing (see CoordinatorLease)
+    bool m_isCoordinator = false;
+    uint64_t m_coordEpoch = 0;
+    std::chrono::steady_clock::time_point m_lastRoleCheck{};
+    std::chrono::steady_clock::time_point m_farmStartedAt{};
+    static constexpr int ROLE_CHECK_MS = 1000;
+
+    // Sharded coordinators: membership as last read (no members = not sharded)
+    CoordinatorShards m_shards;
+    bool m_isShard = false;                 // coordinator role held as one of the members
+    std::string m_workFor;                  // worker: shard we're lent to ("" = home)
+    std::chrono::steady_clock::time_point m_lastBusy{};     // rendering, or holding a deferred assignment
+    std::map<std::string, std::chrono::steady_clock::time_point> m_workLeaseCooldown;
+    static constexpr int WORK_REQUEST_IDLE_MS = 5000;       // idle this long with nothing at home: ask
+    static constexpr int WORK_LEASE_IDLE_MS = 20000;        // a lease that brought no work by then ends
+    static constexpr int WORK_LEASE_COOLDOWN_MS = 60000;    // ... and that shard isn't asked again for this long
+    static constexpr const char* FORWARDED_PREFIX = "fwd:"; // reason of a report passed on by a shard
     Dashboard m_dashboard;
 
     // Cached snapshots (refreshed each frame from bg threads)
-    std::vector<JobInfo> m_cachedJobs;
-    std::vector<JobTemplate> m_cachedTemplates;
+    JobSnapshotPtr m_jobSnapshot = std::make_shared<const JobSnapshot>();
+    uint64_t m_pushedJobsVersion = 0;   // last job list version sent to UIDataCache
+    uint64_t m_pushedTablesVersion = 0; // last dispatch table version sent to UIDataCache
+    TemplateSnapshotPtr m_templateSnapshot = std::make_shared<const TemplateSnapshot>();
 
     // Farm state
     std::filesystem::path m_farmPath;
@@ -171,7 +265,7 @@ private:
     SubmitRequest m_pendingSubmitRequest;
 
     // Worker-side: buffered completions when coordinator is offline
-    struct PendingCompletion { std::string jobId; ChunkRange chunk; std::string state; };
+    struct PendingCompletion { std::string jobId; ChunkRange chunk; std::string state; std::string framesDone; };
     std::vector<PendingCompletion> m_pendingCompletions;
 
     // Worker-side: deferred assignments waiting for manifest to propagate
@@ -180,10 +274,27 @@ private:
         CommandManager::Action action;
         int retryCount = 0;
         std::chrono::steady_clock::time_point nextRetry;
+        int64_t deferredUs = 0;     // chunk trace: start of the manifest wait
     };
     std::vector<DeferredAssignment> m_deferredAssignments;
     void processDeferredAssignments();
 
+    // Worker-side: an assign_chunk's trip from the coordinator, as ChunkTrace spans
+    void traceDelivery(const CommandManager::Action& action);
+
+    // Worker-side: warm the input cache with the next job while rendering
+    void prefetchNextJobInputs();
+    std::chrono::steady_clock::time_point m_lastInputPrefetch{};
+    static constexpr int INPUT_PREFETCH_MS = 5000;
+
+    // Local farm index (see FarmIndex): loaded at farm start, saved when the
+    // reconciled jobs, templates or progress moved, at most every INDEX_SAVE_MS
+    void saveFarmIndex(bool force);
+    std::filesystem::path m_farmIndexPath;
+    uint64_t m_indexSavedRevision = 0;
+    std::chrono::steady_clock::time_point m_lastIndexSave{};
+    static constexpr int INDEX_SAVE_MS = 60000;
+
     // Exit state
     bool m_exitRequested = false;
     bool m_shouldExit = false;
@@ -0,0 +1,337 @@
+#include "monitor/output_stager.h"
+#include "core/monitor_log.h"
+
+#include <chrono>
+#include <fstream>
+
+#include <zlib.h>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// CRC32 of a whole file; false if it can't be read
+bool fileCrc(const fs::path& path, uLong& crc, const std::atomic<bool>& abort)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    crc = crc32(0L, Z_NULL, 0);
+    std::vector<char> buf(OutputStager::COPY_BLOCK);
+    while (in)
+    {
+        if (abort)
+            return false;
+        in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+        auto n = in.gcount();
+        if (n > 0)
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(buf.data()), static_cast<uInt>(n));
+    }
+    return !in.bad();
+}
+
+} // namespace
+
+OutputStager::~OutputStager()
+{
+    stop();
+}
+
+void OutputStager::start(const fs::path& root)
+{
+    if (!m_workers.empty())
+        return;
+
+    m_root = root;
+    std::error_code ec;
+    fs::remove_all(m_root, ec);
+    fs::create_directories(m_root, ec);
+    if (ec)
+    {
+        MonitorLog::instance().warn("render", "Output staging dir unavailable: " + m_root.string() + " (" + ec.message() + ")");
+        return;
+    }
+
+    m_abort = false;
+    m_running = true;
+    for (int i = 0; i < UPLOAD_WORKERS; ++i)
+        m_workers.emplace_back(&OutputStager::workerFunc, this);
+
+    MonitorLog::instance().info("render", "Output staging at " + m_root.string());
+}
+
+void OutputStager::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+            return;
+        m_running = false;
+        if (!m_queue.empty())
+            MonitorLog::instance().warn("render", "Output staging stopped with " +
+                std::to_string(m_queue.size()) + " upload(s) pending");
+        m_queue.clear();
+    }
+    m_abort = true;
+    m_cv.notify_all();
+    for (auto& t : m_workers)
+    {
+        if (t.joinable())
+            t.join();
+    }
+    m_workers.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_chunks.clear();
+}
+
+std::string OutputStager::keyFor(const std::string& jobId, const ChunkRange& chunk)
+{
+    return jobId + "/" + chunk.rangeStr();
+}
+
+fs::path OutputStager::chunkDir(const std::string& jobId, const ChunkRange& chunk) const
+{
+    return m_root / jobId / chunk.rangeStr();
+}
+
+void OutputStager::beginChunk(const std::string& jobId, const ChunkRange& chunk, const fs::path& remoteDir)
+{
+    ChunkUpload cu;
+    cu.jobId = jobId;
+    cu.chunk = chunk;
+    cu.localDir = chunkDir(jobId, chunk);
+    cu.remoteDir = remoteDir;
+
+    // A retry of the same chunk starts clean
+    std::error_code ec;
+    fs::remove_all(cu.localDir, ec);
+    fs::create_directories(cu.localDir, ec);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    cu.generation = m_nextGeneration++;
+    m_chunks[keyFor(jobId, chunk)] = std::move(cu);
+}
+
+void OutputStager::scan(const std::string& jobId, const ChunkRange& chunk)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_chunks.find(keyFor(jobId, chunk));
+    if (it != m_chunks.end() && !it->second.ended)
+        scanLocked(it->second, false);
+}
+
+void OutputStager::endChunk(const std::string& jobId, const ChunkRange& chunk)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto key = keyFor(jobId, chunk);
+    auto it = m_chunks.find(key);
+    if (it == m_chunks.end())
+        return;
+
+    it->second.ended = true;
+    scanLocked(it->second, true);
+    if (it->second.pending == 0)
+        finishLocked(key);
+}
+
+void OutputStager::discardChunk(const std::string& jobId, const ChunkRange& chunk)
+{
+    fs::path localDir;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto key = keyFor(jobId, chunk);
+        auto it = m_chunks.find(key);
+        if (it == m_chunks.end())
+            return;
+        localDir = it->second.localDir;
+        std::erase_if(m_queue, [&](const Upload& u) { return u.key == key; });
+        m_chunks.erase(it);
+    }
+    // An upload already in flight finds its chunk gone and drops the result
+    std::error_code ec;
+    fs::remove_all(localDir, ec);
+}
+
+std::string OutputStager::remotePathFor(const std::string& jobId, const ChunkRange& chunk,
+                                        const std::string& localPath) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_chunks.find(keyFor(jobId, chunk));
+    if (it == m_chunks.end() || localPath.empty())
+        return localPath;
+
+    auto rel = fs::path(localPath).lexically_relative(it->second.localDir);
+    if (rel.empty() || *rel.begin() == "..")
+        return localPath;
+    return (it->second.remoteDir / rel).string();
+}
+
+std::vector<OutputStager::Result> OutputStager::popResults()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Result> out;
+    out.swap(m_results);
+    return out;
+}
+
+size_t OutputStager::pendingUploads() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t n = 0;
+    for (const auto& [key, cu] : m_chunks)
+        n += static_cast<size_t>(cu.pending);
+    return n;
+}
+
+// Local disk only, so fine under the lock
+void OutputStager::scanLocked(ChunkUpload& cu, bool all)
+{
+    auto settledBefore = fs::file_time_type::clock::now() - std::chrono::milliseconds(SETTLE_MS);
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(cu.localDir, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (!it->is_regular_file(ec))
+            continue;
+        auto rel = it->path().lexically_relative(cu.localDir);
+        if (cu.seen.count(rel))
+            continue;
+        if (!all && it->last_write_time(ec) > settledBefore)
+            continue;
+
+        cu.seen.insert(rel);
+        ++cu.pending;
+        m_queue.push_back({keyFor(cu.jobId, cu.chunk), cu.generation, rel});
+        m_cv.notify_one();
+    }
+}
+
+void OutputStager::finishLocked(const std::string& key)
+{
+    auto it = m_chunks.find(key);
+    if (it == m_chunks.end())
+        return;
+
+    auto& cu = it->second;
+    m_results.push_back({cu.jobId, cu.chunk, !cu.failed, cu.error});
+    if (!cu.failed)
+    {
+        std::error_code ec;
+        fs::remove_all(cu.localDir, ec);
+        fs::remove(cu.localDir.parent_path(), ec);   // the job dir, once its last chunk is gone
+    }
+    m_chunks.erase(it);
+}
+
+void OutputStager::workerFunc()
+{
+    while (true)
+    {
+        Upload job;
+        fs::path src, dst;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+            if (!m_running)
+                return;
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            auto it = m_chunks.find(job.key);
+            if (it == m_chunks.end() || it->second.generation != job.generation)
+                continue;
+            src = it->second.localDir / job.rel;
+            dst = it->second.remoteDir / job.rel;
+        }
+
+        std::string error;
+        bool ok = false;
+        for (int attempt = 0; attempt < UPLOAD_ATTEMPTS && !ok && !m_abort; ++attempt)
+            ok = upload(src, dst, error);
+        if (m_abort)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_chunks.find(job.key);
+        if (it == m_chunks.end() || it->second.generation != job.generation)
+            continue;
+        auto& cu = it->second;
+        --cu.pending;
+        if (!ok && !cu.failed)
+        {
+            cu.failed = true;
+            cu.error = "Upload failed for " + job.rel.string() + ": " + error;
+            MonitorLog::instance().error("render", cu.error);
+        }
+        if (cu.ended && cu.pending == 0)
+            finishLocked(job.key);
+    }
+}
+
+bool OutputStager::upload(const fs::path& src, const fs::path& dst, std::string& error)
+{
+    auto tmp = dst;
+    tmp += ".sr-upload";
+
+    std::error_code ec;
+    fs::create_directories(dst.parent_path(), ec);
+
+    uLong srcCrc = crc32(0L, Z_NULL, 0);
+    {
+        std::ifstream in(src, std::ios::binary);
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!in.is_open() || !out.is_open())
+        {
+            error = !in.is_open() ? "cannot read staged file" : "cannot write to output dir";
+            return false;
+        }
+
+        std::vector<char> buf(COPY_BLOCK);
+        while (in)
+        {
+            if (m_abort)
+                return false;
+            in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+            auto n = in.gcount();
+            if (n <= 0)
+                continue;
+            srcCrc = crc32(srcCrc, reinterpret_cast<const Bytef*>(buf.data()), static_cast<uInt>(n));
+            if (!out.write(buf.data(), n))
+            {
+                error = "write failed";
+                break;
+            }
+        }
+        out.close();
+        if (!error.empty() || in.bad() || out.fail())
+        {
+            if (error.empty())
+                error = "copy failed";
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+
+    // Read back what the share actually stored
+    uLong dstCrc = 0;
+    if (!fileCrc(tmp, dstCrc, m_abort) || dstCrc != srcCrc)
+    {
+        error = "checksum mismatch after upload";
+        fs::remove(tmp, ec);
+        return false;
+    }
+
+    fs::rename(tmp, dst, ec);
+    if (ec)
+    {
+        error = "rename failed: " + ec.message();
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace SR
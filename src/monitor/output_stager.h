@@ -0,0 +1,113 @@
+#pragma once
+
+#include "core/job_types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SR {
+
+// Output staging: a chunk renders into its own local dir
+// ("{root}/{job_id}/{range}") and a small pool of upload threads copies the
+// finished files into the job's output dir on the share.
+//
+// Each upload goes to "{file}.sr-upload", is read back and compared by CRC32
+// against the local file, then renamed into place, so the share never shows
+// a partial frame. Files are picked up as frames finish (scan) and once more
+// when the chunk ends; a chunk's result is posted once every file it wrote
+// has committed, or as failed if one couldn't. The render slot doesn't wait
+// for that, so the next chunk starts while uploads run.
+//
+// Called from the main thread; results are collected there with popResults().
+class OutputStager
+{
+public:
+    struct Result
+    {
+        std::string jobId;
+        ChunkRange chunk;
+        bool ok = true;
+        std::string error;
+    };
+
+    OutputStager() = default;
+    ~OutputStager();
+
+    OutputStager(const OutputStager&) = delete;
+    OutputStager& operator=(const OutputStager&) = delete;
+
+    // Clears chunk dirs left by a previous run: those chunks were never
+    // reported, so the coordinator hands them out again
+    void start(const std::filesystem::path& root);
+    void stop();    // abandons uploads still pending; their chunks post no result
+    bool isRunning() const { return !m_workers.empty(); }
+
+    std::filesystem::path chunkDir(const std::string& jobId, const ChunkRange& chunk) const;
+
+    // Chunk lifecycle: files under chunkDir() upload to remoteDir (same relative path)
+    void beginChunk(const std::string& jobId, const ChunkRange& chunk, const std::filesystem::path& remoteDir);
+    void scan(const std::string& jobId, const ChunkRange& chunk);      // a frame finished
+    void endChunk(const std::string& jobId, const ChunkRange& chunk);  // render succeeded
+    void discardChunk(const std::string& jobId, const ChunkRange& chunk);  // render failed
+
+    // Where a staged local path ends up, for reporting; other paths pass through
+    std::string remotePathFor(const std::string& jobId, const ChunkRange& chunk, const std::string& localPath) const;
+
+    std::vector<Result> popResults();
+    size_t pendingUploads() const;
+
+    static constexpr int     UPLOAD_WORKERS = 3;
+    static constexpr int     UPLOAD_ATTEMPTS = 3;
+    static constexpr int64_t SETTLE_MS = 2000;     // mid-chunk, only files untouched this long
+    static constexpr size_t  COPY_BLOCK = 1024 * 1024;
+
+private:
+    struct ChunkUpload
+    {
+        std::string jobId;
+        ChunkRange chunk;
+        std::filesystem::path localDir;
+        std::filesystem::path remoteDir;
+        std::set<std::filesystem::path> seen;   // relative paths queued or uploaded
+        uint64_t generation = 0;                // tells a retried chunk from its discarded run
+        int pending = 0;
+        bool ended = false;
+        bool failed = false;
+        std::string error;
+    };
+
+    struct Upload
+    {
+        std::string key;
+        uint64_t generation = 0;
+        std::filesystem::path rel;
+    };
+
+    static std::string keyFor(const std::string& jobId, const ChunkRange& chunk);
+    void scanLocked(ChunkUpload& cu, bool all);
+    void finishLocked(const std::string& key);
+    void workerFunc();
+    bool upload(const std::filesystem::path& src, const std::filesystem::path& dst, std::string& error);
+
+    std::filesystem::path m_root;
+    std::vector<std::thread> m_workers;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Upload> m_queue;
+    std::map<std::string, ChunkUpload> m_chunks;    // by "{job_id}/{range}"
+    std::vector<Result> m_results;
+    uint64_t m_nextGeneration = 1;
+    bool m_running = false;
+    std::atomic<bool> m_abort{false};
+};
+
+} // namespace SR
@@ -0,0 +1,301 @@
+#include "monitor/output_verifier.h"
+#include "core/perf_counters.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+OutputVerifier::~OutputVerifier()
+{
+    stop();
+}
+
+void OutputVerifier::setNotify(std::function<void()> fn)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_notifyFn = std::move(fn);
+}
+
+void OutputVerifier::submit(Request request)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            m_running = true;
+            for (int i = 0; i < WORKERS; ++i)
+                m_workers.emplace_back(&OutputVerifier::workerFunc, this);
+        }
+
+        uint64_t id = m_nextId++;
+        Pending p;
+        p.request = std::move(request);
+        p.tasksLeft = 1;
+        m_pending.emplace(id, std::move(p));
+
+        Task probe;
+        probe.id = id;
+        probe.probe = true;
+        m_queue.push_back(std::move(probe));
+    }
+    m_cv.notify_one();
+}
+
+std::vector<OutputVerifier::Result> OutputVerifier::takeResults()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::exchange(m_done, {});
+}
+
+void OutputVerifier::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        m_queue.clear();
+    }
+    m_cv.notify_all();
+    for (auto& t : m_workers)
+    {
+        if (t.joinable())
+            t.join();
+    }
+    m_workers.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.clear();
+    m_done.clear();
+}
+
+// ─── Checks ─────────────────────────────────────────────────────────────────
+
+bool OutputVerifier::headerLooksValid(const fs::path& path)
+{
+    struct Magic
+    {
+        const char* ext;
+        const char* bytes;
+        size_t size;
+    };
+    static constexpr Magic MAGICS[] = {
+        {".exr",  "\x76\x2f\x31\x01", 4},
+        {".png",  "\x89PNG\r\n\x1a\n", 8},
+        {".jpg",  "\xff\xd8\xff", 3},
+        {".jpeg", "\xff\xd8\xff", 3},
+        {".tif",  "II*\0", 4},
+        {".tiff", "II*\0", 4},
+        {".dpx",  "SDPX", 4},
+        {".hdr",  "#?", 2},
+        {".bmp",  "BM", 2},
+    };
+
+    std::string ext = path.extension().string();
+    for (auto& c : ext)
+        c = char(std::tolower((unsigned char)c));
+    auto magic = std::find_if(std::begin(MAGICS), std::end(MAGICS),
+                              [&](const Magic& m) { return ext == m.ext; });
+    if (magic == std::end(MAGICS))
+        return true;    // a format we don't know: size checks only
+
+    char head[8] = {};
+    std::ifstream in(path, std::ios::binary);
+    if (!in.read(head, std::streamsize(magic->size)))
+        return false;
+    if (std::memcmp(head, magic->bytes, magic->size) == 0)
+        return true;
+
+    // Big-endian TIFF, byte-swapped DPX
+    if (ext == ".tif" || ext == ".tiff")
+        return std::memcmp(head, "MM\0*", 4) == 0;
+    if (ext == ".dpx")
+        return std::memcmp(head, "XPDS", 4) == 0;
+    return false;
+}
+
+// ─── Workers ────────────────────────────────────────────────────────────────
+
+void OutputVerifier::workerFunc()
+{
+    for (;;)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+            if (!m_running)
+                return;
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        if (task.probe)
+            probe(task);
+        else
+            check(task);
+
+        std::function<void()> notify;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_running)
+                return;
+            auto it = m_pending.find(task.id);
+            if (it == m_pending.end() || --it->second.tasksLeft > 0)
+                continue;
+            finishRequest(task.id);
+            notify = m_notifyFn;
+        }
+        if (notify)
+            notify();
+    }
+}
+
+void OutputVerifier::probe(const Task& task)
+{
+    SR_PERF_SCOPE("verify.probe");
+    Request request;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_pending.find(task.id);
+        if (it == m_pending.end())
+            return;
+        request = it->second.request;
+    }
+    const auto& pattern = request.pattern;
+    const auto& range = request.range;
+
+    // A dir the coordinator can't see (a worker-local path, an unmapped drive)
+    // says nothing about the frames
+    std::error_code ec;
+    if (!fs::is_directory(pattern.dir, ec))
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending[task.id].reachable = false;
+        return;
+    }
+
+    std::vector<std::pair<int, fs::path>> files;
+    std::set<int> missing;
+    if (pattern.exactNames())
+    {
+        for (int f = range.frame_start; f <= range.frame_end; ++f)
+            files.emplace_back(f, pattern.framePath(f));
+    }
+    else
+    {
+        // The DCC picks the padding / extension: match what's there. Several
+        // files for a frame (EXR plus a proxy) are all checked.
+        for (auto it = fs::directory_iterator(pattern.dir, fs::directory_options::skip_permission_denied, ec);
+             !ec && it != fs::directory_iterator(); it.increment(ec))
+        {
+            auto frame = matchOutputFrame(it->path().filename().string(), pattern);
+            if (frame && *frame >= range.frame_start && *frame <= range.frame_end)
+                files.emplace_back(*frame, it->path());
+        }
+        std::set<int> found;
+        for (const auto& [frame, path] : files)
+            found.insert(frame);
+        for (int f = range.frame_start; f <= range.frame_end; ++f)
+        {
+            if (!found.count(f))
+                missing.insert(f);
+        }
+    }
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& p = m_pending[task.id];
+        p.bad.insert(missing.begin(), missing.end());
+        for (size_t i = 0; i < files.size(); i += BATCH)
+        {
+            Task batch;
+            batch.id = task.id;
+            auto end = files.begin() + (std::min)(i + BATCH, files.size());
+            batch.files.assign(std::make_move_iterator(files.begin() + i), std::make_move_iterator(end));
+            m_queue.push_back(std::move(batch));
+            ++p.tasksLeft;
+            queued = true;
+        }
+    }
+    if (queued)
+        m_cv.notify_all();
+}
+
+void OutputVerifier::check(const Task& task)
+{
+    SR_PERF_SCOPE("verify.check");
+    bool checkHeaders = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_pending.find(task.id);
+        if (it == m_pending.end())
+            return;
+        checkHeaders = it->second.request.checkHeaders;
+    }
+
+    std::vector<std::pair<int, uint64_t>> good;
+    std::set<int> bad;
+    for (const auto& [frame, path] : task.files)
+    {
+        std::error_code ec;
+        auto size = fs::file_size(path, ec);
+        if (ec || size == 0 || (checkHeaders && !headerLooksValid(path)))
+            bad.insert(frame);
+        else
+            good.emplace_back(frame, size);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_pending.find(task.id);
+    if (it == m_pending.end())
+        return;
+    auto& p = it->second;
+    p.bad.insert(bad.begin(), bad.end());
+    for (const auto& [frame, size] : good)
+    {
+        // Of several files for one frame, the largest stands for it
+        auto& s = p.sizes[frame];
+        s = (std::max)(s, size);
+    }
+}
+
+void OutputVerifier::finishRequest(uint64_t id)
+{
+    auto node = m_pending.extract(id);
+    auto& p = node.mapped();
+
+    // Of several files for a frame, one good one is enough
+    for (const auto& [frame, size] : p.sizes)
+        p.bad.erase(frame);
+
+    if (p.reachable && p.request.minSizeRatio > 0.0 && p.sizes.size() >= 3)
+    {
+        std::vector<uint64_t> sizes;
+        sizes.reserve(p.sizes.size());
+        for (const auto& [frame, size] : p.sizes)
+            sizes.push_back(size);
+        std::nth_element(sizes.begin(), sizes.begin() + sizes.size() / 2, sizes.end());
+        double floor = double(sizes[sizes.size() / 2]) * p.request.minSizeRatio;
+        for (const auto& [frame, size] : p.sizes)
+        {
+            if (double(size) < floor)
+                p.bad.insert(frame);
+        }
+    }
+
+    Result r;
+    r.jobId = std::move(p.request.jobId);
+    r.range = p.request.range;
+    r.jobPass = p.request.jobPass;
+    r.reachable = p.reachable;
+    if (p.reachable)
+        r.bad = std::move(p.bad);
+    m_done.push_back(std::move(r));
+}
+
+} // namespace SR
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/job_types.h"
+#include "core/output_pattern.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace SR {
+
+// Checks that a range of frames really landed on the share, for jobs with
+// OutputDetection::validation "verify_frames" (see DispatchManager).
+//
+// Each request starts with one probe of the output dir: with an exact file
+// name per frame (#'s plus an extension) the frames are then stat'ed directly,
+// otherwise the dir is listed once and its files matched. The stats (and the
+// optional header reads) run in batches of BATCH frames on WORKERS threads, so
+// a long job doesn't serialize thousands of round trips to the file server.
+// A frame is bad when it's missing, empty, doesn't start with its format's
+// magic bytes, or (minSizeRatio) is far below the median size of the request.
+//
+// Workers start on the first submit(). submit() and takeResults() may be
+// called from any thread; the notify callback runs on a worker, unlocked.
+class OutputVerifier
+{
+public:
+    OutputVerifier() = default;
+    ~OutputVerifier();
+
+    OutputVerifier(const OutputVerifier&) = delete;
+    OutputVerifier& operator=(const OutputVerifier&) = delete;
+
+    struct Request
+    {
+        std::string jobId;
+        ChunkRange range;
+        bool jobPass = false;       // the whole job, before it's marked completed
+        OutputPattern pattern;
+        bool checkHeaders = true;
+        double minSizeRatio = 0.0;  // 0 = off
+    };
+
+    struct Result
+    {
+        std::string jobId;
+        ChunkRange range;
+        bool jobPass = false;
+        bool reachable = true;      // false: output dir not visible from here, nothing checked
+        std::set<int> bad;          // frames to render again
+    };
+
+    void setNotify(std::function<void()> fn);  // call before the first submit()
+    void submit(Request request);
+    std::vector<Result> takeResults();
+    void stop();                    // drops queued and in-flight requests
+
+    // Frame-level checks, also usable on their own
+    static bool headerLooksValid(const std::filesystem::path& path);
+
+    static constexpr int    WORKERS = 4;
+    static constexpr size_t BATCH = 64;
+
+private:
+    struct Pending
+    {
+        Request request;
+        size_t tasksLeft = 0;
+        bool reachable = true;
+        std::set<int> bad;
+        std::map<int, uint64_t> sizes;  // frames that passed, for the median
+    };
+
+    struct Task
+    {
+        uint64_t id = 0;
+        bool probe = false;         // resolve the frames' files first
+        std::vector<std::pair<int, std::filesystem::path>> files;
+    };
+
+    void workerFunc();
+    void probe(const Task& task);
+    void check(const Task& task);
+    void finishRequest(uint64_t id);    // m_mutex held
+
+    std::function<void()> m_notifyFn;
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Task> m_queue;
+    std::map<uint64_t, Pending> m_pending;
+    std::vector<Result> m_done;
+    uint64_t m_nextId = 1;
+    bool m_running = false;
+};
+
+} // namespace SR
@@ -1,13 +1,13 @@
 #include "monitor/render_coordinator.h"
 #include "monitor/agent_supervisor.h"
 #include "core/atomic_file_io.h"
+#include "core/chunk_trace.h"
 #include "core/platform.h"
 #include "core/monitor_log.h"
 
 #include <algorithm>
+#include <charconv>
 #include <chrono>
-#include <fstream>
-#include <iomanip>
 #include <sstream>
 
 namespace SR {
@@ -16,62 +16,82 @@ namespace fs = std::filesystem;
 
 void RenderCoordinator::init(const fs::path& farmPath, const std::string& nodeId,
                               const std::string& nodeOS, CompletionCallback completionFn,
-                              AgentSupervisor* supervisor)
+                              const std::vector<AgentSupervisor*>& agents)
 {
     m_farmPath = farmPath;
     m_nodeId = nodeId;
     m_nodeOS = nodeOS;
     m_completionFn = std::move(completionFn);
-    m_supervisor = supervisor;
-    m_eventSeq = 0;
-    m_eventSeqLoaded = false;
-    m_activeRender.reset();
+    m_eventLogs.clear();
+    m_metrics.close();
+    m_taskPlans.clear();
+    m_slots.clear();
+
+    // Each slot stages into its own dir so same-named logs can't collide
+    auto stagingDir = getAppDataDir() / "stdout_staging";
+    for (size_t i = 0; i < agents.size(); ++i)
+    {
+        Slot slot;
+        slot.index = i;
+        slot.agent = agents[i];
+        slot.stdoutWriter = std::make_unique<StdoutWriter>();
+        slot.stdoutWriter->start(i == 0 ? stagingDir : stagingDir / ("s" + std::to_string(i)));
+        m_slots.push_back(std::move(slot));
+    }
     m_stopped = false;
 
-    MonitorLog::instance().info("render", "Initialized for node " + nodeId);
+    MonitorLog::instance().info("render", "Initialized for node " + nodeId +
+        " (" + std::to_string(m_slots.size()) + " render slot" + (m_slots.size() == 1 ? "" : "s") + ")");
 }
 
-void RenderCoordinator::queueDispatch(const JobManifest& manifest, const ChunkRange& chunk)
+void RenderCoordinator::queueDispatch(const JobManifest& manifest, const ChunkRange& chunk,
+                                      const std::string& traceId)
 {
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    m_dispatchQueue.push({manifest, chunk});
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        PendingDispatch pending;
+        pending.manifest = manifest;
+        pending.chunk = chunk;
+        pending.traceId = traceId;
+        pending.queuedUs = ChunkTrace::nowUs();
+        m_dispatchQueue.push_back(std::move(pending));
+    }
     MonitorLog::instance().info("render", "Queued dispatch: job=" + manifest.job_id + " chunk=" + chunk.rangeStr());
+    prefetchInputs(manifest);
 }
 
-void RenderCoordinator::update(AgentSupervisor& supervisor)
+void RenderCoordinator::update()
 {
-    // If no active render and dispatch queue has items and agent is connected
-    if (!m_activeRender.has_value())
+    collectUploads();
+
+    if (m_stopped)
     {
-        PendingDispatch pending;
-        bool hasPending = false;
+        // Stopped: don't start new work, abandon queued chunks
+        std::deque<PendingDispatch> abandoned;
         {
             std::lock_guard<std::mutex> lock(m_queueMutex);
-            if (!m_dispatchQueue.empty())
-            {
-                pending = std::move(m_dispatchQueue.front());
-                m_dispatchQueue.pop();
-                hasPending = true;
-            }
+            abandoned.swap(m_dispatchQueue);
         }
-
-        if (hasPending && m_stopped)
+        for (auto& pending : abandoned)
         {
-            // Stopped: don't start new work, abandon the chunk
             MonitorLog::instance().info("render", "Stopped - skipping dispatch, abandoning chunk");
             if (m_completionFn)
-                m_completionFn(pending.manifest.job_id, pending.chunk, "abandoned");
-            hasPending = false;
+                m_completionFn(pending.manifest.job_id, pending.chunk, "abandoned", {});
         }
+    }
 
-        if (hasPending)
+    for (auto& slot : m_slots)
+    {
+        // Idle slot with a connected agent takes the next queued chunk
+        if (!slot.active.has_value() && slot.agent->isAgentConnected())
         {
-            if (!supervisor.isAgentConnected())
+            PendingDispatch pending;
             {
-                MonitorLog::instance().warn("render", "Agent not connected, re-queuing dispatch");
                 std::lock_guard<std::mutex> lock(m_queueMutex);
-                m_dispatchQueue.push(std::move(pending));
-                return;
+                if (m_dispatchQueue.empty() || !inputsReady(m_dispatchQueue.front()))
+                    continue;
+                pending = std::move(m_dispatchQueue.front());
+                m_dispatchQueue.pop_front();
             }
 
             // Set up ActiveRender
@@ -81,61 +101,123 @@ void RenderCoordinator::update(AgentSupervisor& supervisor)
             ar.ackReceived = false;
             ar.progressPct = 0.0f;
             ar.startTime = std::chrono::steady_clock::now();
+            ar.traceId = pending.traceId;
+            ar.slotUs = ChunkTrace::nowUs();
+
+            // Prefetched chunks wait here for a slot; a job's first may then wait on its inputs
+            auto& trace = ChunkTrace::instance();
+            int64_t queueEndUs = pending.inputWaitUs ? pending.inputWaitUs : ar.slotUs;
+            trace.record(ar.manifest.job_id, ar.traceId, ar.chunk, "slot_queue", pending.queuedUs, queueEndUs,
+                         {{"slot", slot.index}});
+            if (pending.inputWaitUs)
+                trace.record(ar.manifest.job_id, ar.traceId, ar.chunk, "input_cache_wait",
+                             pending.inputWaitUs, ar.slotUs);
 
-            MonitorLog::instance().info("render", "Starting render: job=" + ar.manifest.job_id + " chunk=" + ar.chunk.rangeStr());
+            MonitorLog::instance().info("render", "Starting render on slot " + std::to_string(slot.index) +
+                ": job=" + ar.manifest.job_id + " chunk=" + ar.chunk.rangeStr());
 
-            m_activeRender = std::move(ar);
+            slot.active = std::move(ar);
 
             // Dispatch the chunk as a single task
-            dispatchChunk(supervisor);
+            dispatchChunk(slot);
         }
-    }
 
-    // Agent disconnect detection during active render
-    if (m_activeRender.has_value() && !supervisor.isAgentConnected())
-    {
-        MonitorLog::instance().error("render", "Agent disconnected during render!");
-        auto& ar = m_activeRender.value();
-        flushStdout();
-        emitEvent("chunk_failed", ar.chunk, {{"error", "Agent disconnected"}});
-        failChunk("Agent disconnected during render");
+        // Agent disconnect detection during active render
+        if (slot.active.has_value() && !slot.agent->isAgentConnected())
+        {
+            MonitorLog::instance().error("render", "Agent " + slot.agent->agentId() + " disconnected during render!");
+            slot.stdoutWriter->finish();
+            emitEvent(slot, "chunk_failed", slot.active->chunk, {{"error", "Agent disconnected"}});
+            failChunk(slot, "Agent disconnected during render");
+        }
     }
 }
 
-void RenderCoordinator::abortCurrentRender(const std::string& reason)
+void RenderCoordinator::abortSlot(Slot& slot, const std::string& reason)
 {
-    if (!m_activeRender.has_value())
+    if (!slot.active.has_value())
         return;
 
-    auto& ar = m_activeRender.value();
-    std::string jobId = ar.manifest.job_id;
-
-    MonitorLog::instance().warn("render", "Aborting render: job=" + jobId + " chunk=" + ar.chunk.rangeStr() + " reason=" + reason);
+    auto& ar = slot.active.value();
+    MonitorLog::instance().warn("render", "Aborting render: job=" + ar.manifest.job_id + " chunk=" + ar.chunk.rangeStr() + " reason=" + reason);
 
     // Tell the agent to abort
-    if (m_supervisor)
-        m_supervisor->sendAbort(reason);
+    slot.agent->sendAbort(reason);
 
-    // Emit failure event and flush stdout
-    flushStdout();
-    emitEvent("chunk_failed", ar.chunk, {{"error", reason}});
+    // Emit failure event and close out stdout
+    slot.stdoutWriter->finish();
+    emitEvent(slot, "chunk_failed", ar.chunk, {{"error", reason}});
 
     // Fail the chunk
-    failChunk(reason);
+    failChunk(slot, reason);
+}
+
+void RenderCoordinator::abortAll(const std::string& reason)
+{
+    for (auto& slot : m_slots)
+        abortSlot(slot, reason);
+}
+
+bool RenderCoordinator::abortChunk(const std::string& jobId, const ChunkRange& chunk,
+                                   const std::string& reason)
+{
+    for (auto& slot : m_slots)
+    {
+        if (slot.active.has_value() && slot.active->manifest.job_id == jobId &&
+            slot.active->chunk == chunk)
+        {
+            abortSlot(slot, reason);
+            return true;
+        }
+    }
+    return false;
+}
+
+void RenderCoordinator::abortJob(const std::string& jobId, const std::string& reason)
+{
+    for (auto& slot : m_slots)
+    {
+        if (slot.active.has_value() && slot.active->manifest.job_id == jobId)
+            abortSlot(slot, reason);
+    }
 }
 
 void RenderCoordinator::purgeJob(const std::string& jobId)
 {
     std::lock_guard<std::mutex> lock(m_queueMutex);
-    std::queue<PendingDispatch> keep;
-    while (!m_dispatchQueue.empty())
+    std::erase_if(m_dispatchQueue,
+        [&](const PendingDispatch& pd) { return pd.manifest.job_id == jobId; });
+}
+
+void RenderCoordinator::purgeChunk(const std::string& jobId, const ChunkRange& chunk)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    std::erase_if(m_dispatchQueue,
+        [&](const PendingDispatch& pd) { return pd.manifest.job_id == jobId && pd.chunk == chunk; });
+}
+
+bool RenderCoordinator::hasChunk(const std::string& jobId, const ChunkRange& chunk)
+{
+    for (const auto& slot : m_slots)
+    {
+        if (slot.active.has_value() &&
+            slot.active->manifest.job_id == jobId && slot.active->chunk == chunk)
+            return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    for (const auto& pd : m_dispatchQueue)
     {
-        auto& item = m_dispatchQueue.front();
-        if (item.manifest.job_id != jobId)
-            keep.push(std::move(item));
-        m_dispatchQueue.pop();
+        if (pd.manifest.job_id == jobId && pd.chunk == chunk)
+            return true;
     }
-    m_dispatchQueue = std::move(keep);
+    return false;
+}
+
+size_t RenderCoordinator::queuedCount()
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_dispatchQueue.size();
 }
 
 void RenderCoordinator::setStopped(bool stopped)
@@ -143,122 +225,314 @@ void RenderCoordinator::setStopped(bool stopped)
     m_stopped = stopped;
 }
 
-void RenderCoordinator::handleAgentMessage(const std::string& type, const nlohmann::json& j)
+void RenderCoordinator::handleAgentMessage(size_t slotIndex, const AgentMessage& msg)
 {
-    if (!m_activeRender.has_value())
+    using Kind = AgentMessage::Kind;
+
+    if (slotIndex >= m_slots.size())
+        return;
+    auto& slot = m_slots[slotIndex];
+
+    if (!slot.active.has_value())
     {
-        MonitorLog::instance().warn("render", "Received " + type + " with no active render, ignoring");
+        MonitorLog::instance().warn("render", "Received " + msg.type + " with no active render on slot " +
+                                    std::to_string(slotIndex) + ", ignoring");
         return;
     }
 
-    auto& ar = m_activeRender.value();
+    auto& ar = slot.active.value();
 
-    if (type == "ack")
+    switch (msg.kind)
     {
+    case Kind::Ack:
         ar.ackReceived = true;
         ar.startTime = std::chrono::steady_clock::now();
-        emitEvent("chunk_started", ar.chunk);
+        ar.ackUs = ChunkTrace::nowUs();
+        ChunkTrace::instance().record(ar.manifest.job_id, ar.traceId, ar.chunk, "agent_spawn",
+                                      ar.taskSentUs, ar.ackUs,
+                                      {{"agent", slot.agent->agentId()},
+                                       {"spawn_ms", msg.json.value("spawn_ms", int64_t(0))}});
+        emitEvent(slot, "chunk_started", ar.chunk);
         MonitorLog::instance().info("render", "Chunk " + ar.chunk.rangeStr() + " acknowledged");
-    }
-    else if (type == "progress")
-    {
-        ar.progressPct = j.value("progress_pct", 0.0f);
-    }
-    else if (type == "stdout")
-    {
-        if (j.contains("lines") && j["lines"].is_array())
+        break;
+
+    case Kind::Progress:
+        ar.progressPct = msg.progressPct;
+        if (ar.loadedUs == 0 && ar.ackUs > 0)
         {
-            std::vector<std::string> lines;
-            for (const auto& line : j["lines"])
-            {
-                if (line.is_string())
-                    lines.push_back(line.get<std::string>());
-            }
-            appendStdout(lines);
+            // First progress line: the DCC has loaded the scene and is rendering
+            ar.loadedUs = ChunkTrace::nowUs();
+            ChunkTrace::instance().record(ar.manifest.job_id, ar.traceId, ar.chunk, "dcc_load",
+                                          ar.ackUs, ar.loadedUs);
         }
-    }
-    else if (type == "frame_completed")
-    {
-        int frame = j.value("frame", -1);
-        if (frame >= 0)
+        break;
+
+    case Kind::Stdout:
+        // Buffered by the writer thread; flushed by size/interval, never per batch
+        slot.stdoutWriter->append(msg.lines);
+        break;
+
+    case Kind::FrameCompleted:
+        if (msg.frame >= 0)
         {
-            ar.completedFrames.insert(frame);
-            ChunkRange singleFrame{frame, frame};
-            emitEvent("frame_finished", singleFrame);
+            if (ar.loadedUs == 0 && ar.ackUs > 0)
+            {
+                ar.loadedUs = ChunkTrace::nowUs();
+                ChunkTrace::instance().record(ar.manifest.job_id, ar.traceId, ar.chunk, "dcc_load",
+                                              ar.ackUs, ar.loadedUs);
+            }
+            ar.completedFrames.insert(msg.frame);
+            if (ar.staged)
+                m_outputStager.scan(ar.manifest.job_id, ar.chunk);
+            // Staged frames aren't on the share yet: not salvageable for the coordinator
+            ChunkRange singleFrame{msg.frame, msg.frame};
+            emitEvent(slot, "frame_finished", singleFrame,
+                      ar.staged ? nlohmann::json{{"staged", true}} : nlohmann::json::object());
             MonitorLog::instance().info("render",
-                "Frame " + std::to_string(frame) + " finished for job " + ar.manifest.job_id);
+                "Frame " + std::to_string(msg.frame) + " finished for job " + ar.manifest.job_id);
         }
+        break;
+
+    case Kind::Completed:
+        onChunkCompleted(slot, msg.json);
+        break;
+
+    case Kind::Failed:
+        onChunkFailed(slot, msg.json);
+        break;
+
+    default:
+        break;
     }
-    else if (type == "completed")
+}
+
+size_t RenderCoordinator::activeCount() const
+{
+    size_t n = 0;
+    for (const auto& slot : m_slots)
+        n += slot.active.has_value() ? 1 : 0;
+    return n;
+}
+
+size_t RenderCoordinator::freeSlots() const
+{
+    size_t n = 0;
+    for (const auto& slot : m_slots)
     {
-        onChunkCompleted(j);
+        if (!slot.active.has_value() && slot.agent->isAgentConnected())
+            ++n;
     }
-    else if (type == "failed")
+    return n;
+}
+
+std::vector<std::string> RenderCoordinator::activeJobIds() const
+{
+    std::vector<std::string> ids;
+    for (const auto& slot : m_slots)
     {
-        onChunkFailed(j);
+        if (slot.active.has_value() &&
+            std::find(ids.begin(), ids.end(), slot.active->manifest.job_id) == ids.end())
+            ids.push_back(slot.active->manifest.job_id);
     }
+    return ids;
 }
 
 std::string RenderCoordinator::currentJobId() const
 {
-    if (m_activeRender.has_value())
-        return m_activeRender->manifest.job_id;
+    for (const auto& slot : m_slots)
+    {
+        if (slot.active.has_value())
+            return slot.active->manifest.job_id;
+    }
     return {};
 }
 
-ChunkRange RenderCoordinator::currentChunk() const
+std::string RenderCoordinator::currentChunkLabel() const
 {
-    if (m_activeRender.has_value())
-        return m_activeRender->chunk;
-    return {};
+    std::string label;
+    for (const auto& slot : m_slots)
+    {
+        if (!slot.active.has_value())
+            continue;
+
+        const auto& chunk = slot.active->chunk;
+        if (!label.empty())
+            label += ", ";
+        label += "f" + std::to_string(chunk.frame_start);
+        if (chunk.frame_end != chunk.frame_start)
+            label += "-" + std::to_string(chunk.frame_end);
+    }
+    return label;
 }
 
-std::string RenderCoordinator::currentChunkLabel() const
+float RenderCoordinator::currentProgress() const
 {
-    if (!m_activeRender.has_value())
-        return {};
+    for (const auto& slot : m_slots)
+    {
+        if (slot.active.has_value())
+            return slot.active->progressPct;
+    }
+    return 0.0f;
+}
+
+// ─── Task message building ─────────────────────────────────────────────────
+
+namespace {
 
-    const auto& chunk = m_activeRender->chunk;
-    if (chunk.frame_start == chunk.frame_end)
-        return "f" + std::to_string(chunk.frame_start);
-    return "f" + std::to_string(chunk.frame_start) + "-" + std::to_string(chunk.frame_end);
+enum TaskToken
+{
+    TokFrame, TokChunkStart, TokChunkEnd,
+    TokTileCount, TokTileCols, TokTileRows,
+    TokTileIndex, TokTileCol, TokTileRow,
+    TokTileMinX, TokTileMaxX, TokTileMinY, TokTileMaxY,
+    TokOutputPath,
+};
+
+// Same order as TaskToken
+TokenTemplate compileTask(std::string text)
+{
+    return TokenTemplate(std::move(text), {
+        "frame", "chunk_start", "chunk_end",
+        "tile_count", "tile_cols", "tile_rows",
+        "tile_index", "tile_col", "tile_row",
+        "tile_min_x", "tile_max_x", "tile_min_y", "tile_max_y",
+        "output_path",
+    });
 }
 
-float RenderCoordinator::currentProgress() const
+void appendInt(std::string& out, int64_t v)
 {
-    if (m_activeRender.has_value())
-        return m_activeRender->progressPct;
-    return 0.0f;
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
 }
 
-// ─── Task JSON building ────────────────────────────────────────────────────
+void appendCoord(std::string& out, double v)
+{
+    std::ostringstream ss;
+    ss << v;    // shortest form: 0, 0.25, 0.333333, 1
+    out += ss.str();
+}
 
-nlohmann::json RenderCoordinator::buildTaskJson(const JobManifest& manifest, const ChunkRange& chunk)
+void appendJsonString(std::string& out, std::string_view s)
 {
-    // Get executable for this OS
+    static const char* hex = "0123456789abcdef";
+    out += '"';
+    for (char c : s)
+    {
+        switch (c)
+        {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                out += "\\u00";
+                out += hex[(c >> 4) & 0xF];
+                out += hex[c & 0xF];
+            }
+            else
+            {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+// {"a":1,"b":2} -> ,"a":1,"b":2 (to continue an object being written by hand)
+std::string asMembers(const nlohmann::json& obj)
+{
+    std::string s = obj.dump();
+    return "," + s.substr(1, s.size() - 2);
+}
+
+} // namespace
+
+const RenderCoordinator::TaskPlan& RenderCoordinator::taskPlan(const JobManifest& manifest)
+{
+    auto it = m_taskPlans.find(manifest.job_id);
+    if (it != m_taskPlans.end() && it->second.submittedAtMs == manifest.submitted_at_ms)
+        return it->second;
+
+    if (it == m_taskPlans.end() && m_taskPlans.size() >= MAX_TASK_PLANS)
+    {
+        for (auto p = m_taskPlans.begin(); p != m_taskPlans.end(); )
+        {
+            bool inUse = std::any_of(m_slots.begin(), m_slots.end(), [&](const Slot& slot)
+            {
+                return slot.active.has_value() && slot.active->manifest.job_id == p->first;
+            });
+            p = inUse ? std::next(p) : m_taskPlans.erase(p);
+        }
+    }
+
+    TaskPlan plan;
+    plan.submittedAtMs = manifest.submitted_at_ms;
+    plan.head = "{\"type\":\"task\",\"job_id\":" + nlohmann::json(manifest.job_id).dump();
+
+    // Executable for this OS; a tiled still's merge may run its own tool
     auto cmdIt = manifest.cmd.find(m_nodeOS);
-    std::string executable;
-    if (cmdIt != manifest.cmd.end())
-        executable = cmdIt->second;
+    std::string executable = cmdIt != manifest.cmd.end() ? cmdIt->second : std::string();
+    plan.executable = nlohmann::json(executable).dump();
+    auto mergeIt = manifest.tiles.merge_cmd.find(m_nodeOS);
+    plan.mergeExecutable = (mergeIt != manifest.tiles.merge_cmd.end() && !mergeIt->second.empty())
+        ? nlohmann::json(mergeIt->second).dump()
+        : plan.executable;
+
+    auto finish = [](TaskPlan::Arg& arg)
+    {
+        if (!arg.text.hasTokens() && arg.cacheFlag < 0 && !arg.output)
+            arg.json = nlohmann::json(arg.text.text()).dump();
+    };
 
-    // Build args from flags with token substitution
-    std::vector<std::string> args;
-    for (const auto& f : manifest.flags)
+    const auto& persistent = manifest.process.persistent;
+    if (persistent.enabled)
     {
-        if (!f.flag.empty())
-            args.push_back(substituteTokens(f.flag, chunk));
-        if (f.value.has_value())
-            args.push_back(substituteTokens(f.value.value(), chunk));
+        plan.args = compilePersistentArgs(manifest);
+    }
+    else
+    {
+        for (size_t i = 0; i < manifest.flags.size(); ++i)
+        {
+            const auto& f = manifest.flags[i];
+            if (!f.flag.empty())
+            {
+                plan.args.emplace_back(compileTask(f.flag));
+                finish(plan.args.back());
+            }
+            if (!f.value.has_value())
+                continue;
+            TaskPlan::Arg arg(compileTask(f.value.value()));
+            arg.cacheFlag = f.cache_input ? int(i) : -1;
+            arg.output = f.output_path;
+            finish(arg);
+            plan.args.push_back(std::move(arg));
+        }
     }
 
-    // Build progress spec
-    nlohmann::json progressJson = nullptr;
-    if (!manifest.progress.patterns.empty() || manifest.progress.completion_pattern.has_value())
+    if (manifest.tiles.enabled())
     {
-        progressJson = manifest.progress;
+        auto out = std::find_if(manifest.flags.begin(), manifest.flags.end(),
+                                [](const ManifestFlag& f) { return f.output_path && f.value.has_value(); });
+        if (out != manifest.flags.end())
+            plan.mergeOutput = compileTask(out->value.value());
+        for (const auto& a : manifest.tiles.merge_args)
+        {
+            plan.mergeArgs.emplace_back(compileTask(a));
+            finish(plan.mergeArgs.back());
+        }
     }
 
-    // Build output detection
+    if (manifest.process.working_dir.has_value())
+        plan.workingDir = compileTask(manifest.process.working_dir.value());
+
+    // Output detection, environment, timeout and the persistent key never
+    // change; the progress spec is dropped for the merge (the merge tool's
+    // output means nothing to the DCC's patterns)
     nlohmann::json outputJson = nullptr;
     if (manifest.output_detection.stdout_regex.has_value())
     {
@@ -267,48 +541,199 @@ nlohmann::json RenderCoordinator::buildTaskJson(const JobManifest& manifest, con
             {"capture_group", manifest.output_detection.path_group},
         };
     }
-
-    // Working dir
-    std::string workingDir;
-    if (manifest.process.working_dir.has_value())
-        workingDir = substituteTokens(manifest.process.working_dir.value(), chunk);
-
-    nlohmann::json task = {
-        {"type", "task"},
-        {"job_id", manifest.job_id},
-        {"frame_start", chunk.frame_start},
-        {"frame_end", chunk.frame_end},
-        {"command", {
-            {"executable", executable},
-            {"args", args},
-        }},
-        {"working_dir", workingDir.empty() ? nlohmann::json(nullptr) : nlohmann::json(workingDir)},
+    nlohmann::json tail = {
         {"environment", manifest.environment},
-        {"progress", progressJson},
+        {"progress", nullptr},
         {"output_detection", outputJson},
         {"timeout_seconds", manifest.timeout_seconds.has_value()
             ? nlohmann::json(manifest.timeout_seconds.value())
             : nlohmann::json(nullptr)},
     };
+    // The chunk range travels in the task; the process gets it on stdin
+    if (persistent.enabled)
+    {
+        tail["persistent"] = {
+            {"key", manifest.job_id},
+            {"max_chunks", persistent.max_chunks},
+            {"max_memory_mb", persistent.max_memory_mb},
+        };
+    }
+    plan.mergeTail = asMembers(tail);
+    if (!manifest.progress.patterns.empty() || manifest.progress.completion_pattern.has_value())
+        tail["progress"] = manifest.progress;
+    plan.tail = asMembers(tail);
+
+    auto& cached = m_taskPlans[manifest.job_id];
+    cached = std::move(plan);
+    return cached;
+}
+
+std::string RenderCoordinator::buildTaskMessage(const JobManifest& manifest, const ChunkRange& chunk,
+                                                bool staged, const nlohmann::json& placement,
+                                                const std::string& traceId)
+{
+    const auto& plan = taskPlan(manifest);
+    const auto& tiles = manifest.tiles;
+    bool merge = tiles.isMerge(chunk.frame_start);
+    bool tile = tiles.enabled() && !merge;
+    TileRegion region;
+    if (tile)
+        region = tiles.region(chunk.frame_start);
+
+    // A tiled job's units all render (or merge) the one still
+    int first = tiles.enabled() ? tiles.frame : chunk.frame_start;
+    int last = tiles.enabled() ? tiles.frame : chunk.frame_end;
+
+    std::string outputPath;
+    auto resolve = [&](int id, std::string_view, std::string& out) -> bool
+    {
+        switch (id)
+        {
+        case TokFrame:          // alias for {chunk_start} (backward compat)
+        case TokChunkStart: appendInt(out, first); return true;
+        case TokChunkEnd:   appendInt(out, last); return true;
+        case TokTileCount:  if (!tiles.enabled()) return false; appendInt(out, tiles.count()); return true;
+        case TokTileCols:   if (!tiles.enabled()) return false; appendInt(out, tiles.cols); return true;
+        case TokTileRows:   if (!tiles.enabled()) return false; appendInt(out, tiles.rows); return true;
+        case TokTileIndex:  if (!tile) return false; appendInt(out, region.index); return true;
+        case TokTileCol:    if (!tile) return false; appendInt(out, region.col); return true;
+        case TokTileRow:    if (!tile) return false; appendInt(out, region.row); return true;
+        case TokTileMinX:   if (!tile) return false; appendCoord(out, region.min_x); return true;
+        case TokTileMaxX:   if (!tile) return false; appendCoord(out, region.max_x); return true;
+        case TokTileMinY:   if (!tile) return false; appendCoord(out, region.min_y); return true;
+        case TokTileMaxY:   if (!tile) return false; appendCoord(out, region.max_y); return true;
+        case TokOutputPath: if (!merge) return false; out += outputPath; return true;
+        default:            return false;
+        }
+    };
+    if (merge && plan.mergeOutput)
+        outputPath = plan.mergeOutput->render(resolve);
+
+    const auto& args = merge ? plan.mergeArgs : plan.args;
+    std::string msg;
+    msg.reserve(plan.head.size() + plan.tail.size() + args.size() * 48 + 256);
+    msg += plan.head;
+    msg += ",\"frame_start\":";
+    appendInt(msg, chunk.frame_start);
+    msg += ",\"frame_end\":";
+    appendInt(msg, chunk.frame_end);
+    if (!traceId.empty())
+    {
+        msg += ",\"trace_id\":";
+        appendJsonString(msg, traceId);
+    }
+    msg += ",\"command\":{\"executable\":";
+    msg += merge ? plan.mergeExecutable : plan.executable;
+    msg += ",\"args\":[";
+    std::string value;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        const auto& a = args[i];
+        if (i > 0)
+            msg += ',';
+        if (!a.json.empty())
+        {
+            msg += a.json;
+            continue;
+        }
+        value.clear();
+        a.text.renderTo(value, resolve);
+        if (a.cacheFlag >= 0)
+            value = cachedInput(manifest.flags[a.cacheFlag], value);
+        if (staged && a.output)
+            value = stagedOutput(manifest, chunk, value);
+        appendJsonString(msg, value);
+    }
+    msg += "]},\"working_dir\":";
+    std::string workingDir = plan.workingDir ? plan.workingDir->render(resolve) : std::string();
+    if (workingDir.empty())
+        msg += "null";
+    else
+        appendJsonString(msg, workingDir);
+    msg += merge ? plan.mergeTail : plan.tail;
+    if (!placement.is_null())
+    {
+        msg += ",\"placement\":";
+        msg += placement.dump();
+    }
+    msg += '}';
+    return msg;
+}
+
+std::vector<RenderCoordinator::TaskPlan::Arg> RenderCoordinator::compilePersistentArgs(const JobManifest& manifest) const
+{
+    const auto& persistent = manifest.process.persistent;
+    auto isChunkToken = [](const std::string& s) {
+        return s.find("{frame}") != std::string::npos
+            || s.find("{chunk_start}") != std::string::npos
+            || s.find("{chunk_end}") != std::string::npos;
+    };
+    auto isDropped = [&](const std::string& flag) {
+        return std::find(persistent.drop_flags.begin(), persistent.drop_flags.end(), flag)
+            != persistent.drop_flags.end();
+    };
+    // Launch args are literal: no chunk exists yet to fill anything in
+    auto literal = [](const std::string& text, int cacheFlag) {
+        TaskPlan::Arg arg{TokenTemplate(text)};
+        arg.cacheFlag = cacheFlag;
+        if (cacheFlag < 0)
+            arg.json = nlohmann::json(text).dump();
+        return arg;
+    };
+
+    std::vector<TaskPlan::Arg> args;
+    for (size_t i = 0; i < manifest.flags.size(); ++i)
+    {
+        const auto& f = manifest.flags[i];
+        if (!f.flag.empty() && isDropped(f.flag))
+        {
+            // A standalone flag takes the positional value after it along
+            if (!f.value.has_value() && i + 1 < manifest.flags.size() && manifest.flags[i + 1].flag.empty())
+                ++i;
+            continue;
+        }
+        // Anything left that names the chunk has no meaning at launch
+        if (isChunkToken(f.flag) || (f.value.has_value() && isChunkToken(f.value.value())))
+            continue;
+
+        if (!f.flag.empty())
+            args.push_back(literal(f.flag, -1));
+        if (f.value.has_value())
+            args.push_back(literal(f.value.value(), f.cache_input ? int(i) : -1));
+    }
 
-    return task;
+    std::string bootstrap = persistent.bootstrap.empty()
+        ? std::string()
+        : (m_farmPath / "plugins" / persistent.bootstrap).string();
+    for (const auto& a : persistent.launch_args)
+    {
+        auto arg = TokenTemplate(a, {"bootstrap"}).render([&](int id, std::string_view, std::string& out)
+        {
+            if (id != 0)
+                return false;
+            out += bootstrap;
+            return true;
+        });
+        args.push_back(literal(arg, -1));
+    }
+    return args;
 }
 
-void RenderCoordinator::dispatchChunk(AgentSupervisor& supervisor)
+void RenderCoordinator::dispatchChunk(Slot& slot)
 {
-    if (!m_activeRender.has_value())
+    if (!slot.active.has_value())
         return;
 
-    auto& ar = m_activeRender.value();
+    auto& ar = slot.active.value();
     ar.ackReceived = false;
     ar.progressPct = 0.0f;
     ar.startTime = std::chrono::steady_clock::now();
-    ar.stdoutBuffer.clear();
 
     // Build stdout log filename: {rangeStr}_{timestamp_ms}.log
     auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
     ar.stdoutLogName = ar.chunk.rangeStr() + "_" + std::to_string(nowMs) + ".log";
+    slot.stdoutWriter->begin(m_farmPath / "jobs" / ar.manifest.job_id / "stdout" / m_nodeId / ar.stdoutLogName);
 
     // Ensure output directory exists before dispatching
     if (ar.manifest.output_dir.has_value() && !ar.manifest.output_dir.value().empty())
@@ -319,82 +744,51 @@ void RenderCoordinator::dispatchChunk(AgentSupervisor& supervisor)
             MonitorLog::instance().warn("render", "Failed to create output dir: " + ar.manifest.output_dir.value() + " (" + ec.message() + ")");
     }
 
-    auto taskJson = buildTaskJson(ar.manifest, ar.chunk);
-    std::string taskStr = taskJson.dump();
+    // The merge writes to the share itself; its tiles are already there
+    ar.staged = canStage(ar.manifest) && !ar.manifest.tiles.isMerge(ar.chunk.frame_start);
+    if (ar.staged)
+        m_outputStager.beginChunk(ar.manifest.job_id, ar.chunk, fs::path(ar.manifest.output_dir.value()));
 
-    MonitorLog::instance().info("render", "Dispatching chunk " + ar.chunk.rangeStr() + " for job " + ar.manifest.job_id);
+    std::string taskStr = buildTaskMessage(ar.manifest, ar.chunk, ar.staged,
+                                           buildPlacement(ar.manifest, slot.index), ar.traceId);
 
-    supervisor.sendTask(taskStr);
-}
+    MonitorLog::instance().info("render", "Dispatching chunk " + ar.chunk.rangeStr() + " for job " + ar.manifest.job_id +
+        " to " + slot.agent->agentId());
 
-std::string RenderCoordinator::substituteTokens(const std::string& input, const ChunkRange& chunk) const
-{
-    std::string result = input;
+    // Log file, output dir and staging setup can each touch the share
+    ar.taskSentUs = ChunkTrace::nowUs();
+    ChunkTrace::instance().record(ar.manifest.job_id, ar.traceId, ar.chunk, "task_setup", ar.slotUs, ar.taskSentUs,
+                                  {{"staged", ar.staged}});
+    slot.agent->sendTask(taskStr);
+}
 
-    // {frame} → alias for {chunk_start} (backward compat)
-    {
-        std::string token = "{frame}";
-        size_t pos = 0;
-        while ((pos = result.find(token, pos)) != std::string::npos)
-        {
-            result.replace(pos, token.length(), std::to_string(chunk.frame_start));
-            pos += std::to_string(chunk.frame_start).length();
-        }
-    }
+// ─── Events ─────────────────────────────────────────────────────────────────
 
-    // {chunk_start}
-    {
-        std::string token = "{chunk_start}";
-        size_t pos = 0;
-        while ((pos = result.find(token, pos)) != std::string::npos)
-        {
-            result.replace(pos, token.length(), std::to_string(chunk.frame_start));
-            pos += std::to_string(chunk.frame_start).length();
-        }
-    }
+void RenderCoordinator::emitEvent(Slot& slot, const std::string& type, const ChunkRange& chunk,
+                                  const nlohmann::json& extra)
+{
+    if (!slot.active.has_value())
+        return;
 
-    // {chunk_end}
+    // Slots on the same job append to one writer, keeping a single seq stream
+    auto eventsDir = m_farmPath / "jobs" / slot.active->manifest.job_id / "events" / m_nodeId;
+    auto& log = m_eventLogs[eventsDir];
+    if (!log.isOpen())
     {
-        std::string token = "{chunk_end}";
-        size_t pos = 0;
-        while ((pos = result.find(token, pos)) != std::string::npos)
+        pruneEventLogs();
+        if (!log.open(eventsDir))
         {
-            result.replace(pos, token.length(), std::to_string(chunk.frame_end));
-            pos += std::to_string(chunk.frame_end).length();
+            MonitorLog::instance().error("render", "Failed to open event log: " + eventsDir.string());
+            return;
         }
     }
 
-    return result;
-}
-
-// ─── Event files ────────────────────────────────────────────────────────────
-
-void RenderCoordinator::emitEvent(const std::string& type, const ChunkRange& chunk, const nlohmann::json& extra)
-{
-    if (!m_activeRender.has_value())
-        return;
-
-    auto& ar = m_activeRender.value();
-    auto eventsDir = m_farmPath / "jobs" / ar.manifest.job_id / "events" / m_nodeId;
-    ensureDir(eventsDir);
-
-    uint64_t seq = nextEventSeq();
-    std::string rangeStr = chunk.rangeStr();
-
-    // Filename: {6-digit seq}_{type}_{rangeStr}.json
-    std::ostringstream fname;
-    fname << std::setfill('0') << std::setw(6) << seq
-          << "_" << type
-          << "_" << rangeStr
-          << ".json";
-
     auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
 
     nlohmann::json event = {
         {"_version", 1},
         {"node_id", m_nodeId},
-        {"seq", seq},
         {"frame_start", chunk.frame_start},
         {"frame_end", chunk.frame_end},
         {"type", type},
@@ -407,157 +801,281 @@ void RenderCoordinator::emitEvent(const std::string& type, const ChunkRange& chu
         event[key] = val;
     }
 
-    AtomicFileIO::writeJson(eventsDir / fname.str(), event);
+    log.append(event);   // stamps "seq"
 }
 
-uint64_t RenderCoordinator::nextEventSeq()
+void RenderCoordinator::pruneEventLogs()
 {
-    if (!m_eventSeqLoaded && m_activeRender.has_value())
+    for (auto it = m_eventLogs.begin(); it != m_eventLogs.end(); )
     {
-        // Scan existing event files to find max seq
-        auto& ar = m_activeRender.value();
-        auto eventsDir = m_farmPath / "jobs" / ar.manifest.job_id / "events" / m_nodeId;
-
-        std::error_code ec;
-        if (fs::is_directory(eventsDir, ec))
+        bool inUse = !it->second.isOpen();     // the one being opened
+        for (const auto& slot : m_slots)
         {
-            for (const auto& entry : fs::directory_iterator(eventsDir, ec))
-            {
-                if (!entry.is_regular_file(ec) || entry.path().extension() != ".json")
-                    continue;
-
-                std::string name = entry.path().stem().string();
-                // Parse first 6 digits as seq number
-                if (name.size() >= 6)
-                {
-                    try
-                    {
-                        uint64_t s = std::stoull(name.substr(0, 6));
-                        if (s > m_eventSeq)
-                            m_eventSeq = s;
-                    }
-                    catch (...) {}
-                }
-            }
+            if (slot.active.has_value() &&
+                it->first == m_farmPath / "jobs" / slot.active->manifest.job_id / "events" / m_nodeId)
+                inUse = true;
         }
-        m_eventSeqLoaded = true;
+        it = inUse ? std::next(it) : m_eventLogs.erase(it);
     }
-
-    return ++m_eventSeq;
 }
 
 // ─── Stdout log files ───────────────────────────────────────────────────────
 
-void RenderCoordinator::appendStdout(const std::vector<std::string>& lines)
+void RenderCoordinator::setStdoutOptions(bool compress, bool stageLocally)
 {
-    if (!m_activeRender.has_value())
-        return;
-
-    // Append to buffer
-    auto& ar = m_activeRender.value();
-    for (const auto& line : lines)
-        ar.stdoutBuffer.push_back(line);
-
-    // Flush to disk
-    flushStdout();
+    for (auto& slot : m_slots)
+        slot.stdoutWriter->setOptions(compress, stageLocally);
 }
 
-void RenderCoordinator::flushStdout()
+// ─── Input cache ────────────────────────────────────────────────────────────
+
+void RenderCoordinator::setInputCacheOptions(bool enabled, const std::string& dir, int budgetGb)
 {
-    if (!m_activeRender.has_value())
+    if (!enabled)
+    {
+        m_inputCache.stop();
         return;
+    }
+    uint64_t budget = uint64_t((std::max)(1, budgetGb)) << 30;
+    if (m_inputCache.isRunning())
+        m_inputCache.setBudget(budget);
+    else
+        m_inputCache.start(dir.empty() ? getAppDataDir() / "input_cache" : fs::path(dir), budget);
+}
 
-    auto& ar = m_activeRender.value();
-    if (ar.stdoutBuffer.empty())
+void RenderCoordinator::prefetchInputs(const JobManifest& manifest)
+{
+    if (!m_inputCache.isRunning())
         return;
+    for (const auto& f : manifest.flags)
+    {
+        if (f.cache_input && f.value.has_value())
+            m_inputCache.prefetch(f.value.value());
+    }
+}
 
-    auto stdoutDir = m_farmPath / "jobs" / ar.manifest.job_id / "stdout" / m_nodeId;
-    ensureDir(stdoutDir);
-
-    auto logPath = stdoutDir / ar.stdoutLogName;
+bool RenderCoordinator::inputsReady(PendingDispatch& pending)
+{
+    if (!m_inputCache.isRunning())
+        return true;
 
-    // Append mode
-    std::ofstream ofs(logPath, std::ios::app);
-    if (ofs.is_open())
+    bool waiting = false;
+    for (const auto& f : pending.manifest.flags)
     {
-        for (const auto& line : ar.stdoutBuffer)
-            ofs << line << "\n";
-        ofs.flush();
+        if (f.cache_input && f.value.has_value() &&
+            m_inputCache.request(f.value.value()) == InputCache::Status::Pending)
+            waiting = true;
     }
-    else
+    if (!waiting)
+        return true;
+
+    // A job's first chunk waits for its copy: the DCC would read the whole
+    // file from the share anyway, and every later chunk then reads it locally
+    auto now = std::chrono::steady_clock::now();
+    if (pending.inputWaitStart == std::chrono::steady_clock::time_point{})
     {
-        MonitorLog::instance().error("render", "Failed to open stdout log: " + logPath.string());
+        pending.inputWaitStart = now;
+        pending.inputWaitUs = ChunkTrace::nowUs();
+        MonitorLog::instance().info("render", "Caching inputs for job " + pending.manifest.job_id +
+            " before chunk " + pending.chunk.rangeStr());
     }
+    if (std::chrono::duration_cast<std::chrono::milliseconds>(now - pending.inputWaitStart).count() < INPUT_WAIT_MS)
+        return false;
 
-    ar.stdoutBuffer.clear();
+    MonitorLog::instance().warn("render", "Input cache still copying for job " + pending.manifest.job_id +
+        ", rendering from the share");
+    return true;
+}
+
+std::string RenderCoordinator::cachedInput(const ManifestFlag& flag, const std::string& value)
+{
+    if (!flag.cache_input || !m_inputCache.isRunning())
+        return value;
+    return m_inputCache.localPath(value).value_or(value);
+}
+
+// ─── Output staging ─────────────────────────────────────────────────────────
+
+void RenderCoordinator::setOutputStaging(bool enabled, const std::string& dir)
+{
+    // Turning it off only stops staging new chunks; uploads in flight finish
+    m_stageOutputs = enabled;
+    if (enabled && !m_outputStager.isRunning())
+        m_outputStager.start(dir.empty() ? getAppDataDir() / "output_staging" : fs::path(dir));
+}
+
+void RenderCoordinator::setPlacementOptions(const std::string& priority, std::vector<int> slotNuma)
+{
+    m_renderPriority = priority;
+    m_slotNuma = std::move(slotNuma);
+}
+
+nlohmann::json RenderCoordinator::buildPlacement(const JobManifest& manifest, size_t slotIndex) const
+{
+    // The agent intersects the CPU set with the slot's pinned affinity
+    nlohmann::json placement;
+    const auto& priority = m_renderPriority.empty() ? manifest.process.priority : m_renderPriority;
+    if (!priority.empty())
+        placement["priority"] = priority;
+    if (!manifest.process.cpu_set.empty())
+        placement["cpu_set"] = manifest.process.cpu_set;
+
+    int numa = manifest.process.numa_node;
+    if (slotIndex < m_slotNuma.size() && m_slotNuma[slotIndex] >= 0)
+        numa = m_slotNuma[slotIndex];
+    if (numa >= 0)
+        placement["numa_node"] = numa;
+    return placement;
+}
+
+bool RenderCoordinator::canStage(const JobManifest& manifest) const
+{
+    if (!m_stageOutputs || !m_outputStager.isRunning() || manifest.process.persistent.enabled ||
+        !manifest.output_dir.has_value() || manifest.output_dir.value().empty())
+        return false;
+    return std::any_of(manifest.flags.begin(), manifest.flags.end(),
+        [](const ManifestFlag& f) { return f.output_path && f.value.has_value(); });
+}
+
+// Same path relative to the output dir, under the chunk's staging dir
+std::string RenderCoordinator::stagedOutput(const JobManifest& manifest, const ChunkRange& chunk,
+                                            const std::string& value) const
+{
+    auto rel = fs::path(value).lexically_relative(fs::path(manifest.output_dir.value()));
+    if (rel.empty() || *rel.begin() == "..")
+        rel = fs::path(value).filename();
+    return (m_outputStager.chunkDir(manifest.job_id, chunk) / rel).string();
+}
+
+void RenderCoordinator::collectUploads()
+{
+    for (auto& r : m_outputStager.popResults())
+    {
+        if (r.ok)
+            MonitorLog::instance().info("render", "Chunk " + r.chunk.rangeStr() + " uploaded for job " + r.jobId);
+        else
+            MonitorLog::instance().error("render", "Chunk " + r.chunk.rangeStr() + " FAILED for job " + r.jobId + ": " + r.error);
+        if (m_completionFn)
+            m_completionFn(r.jobId, r.chunk, r.ok ? "completed" : "failed", {});
+    }
 }
 
 // ─── Completion / failure ───────────────────────────────────────────────────
 
-void RenderCoordinator::onChunkCompleted(const nlohmann::json& j)
+void RenderCoordinator::onChunkCompleted(Slot& slot, const nlohmann::json& j)
 {
-    if (!m_activeRender.has_value())
+    if (!slot.active.has_value())
         return;
 
-    auto& ar = m_activeRender.value();
-    flushStdout();
+    auto& ar = slot.active.value();
+    slot.stdoutWriter->finish();
 
     int64_t elapsed_ms = j.value("elapsed_ms", int64_t(0));
     int exit_code = j.value("exit_code", 0);
+    uint64_t peak_mb = j.value("peak_memory_mb", uint64_t(0));
     std::string output_file;
     if (j.contains("output_file") && !j["output_file"].is_null())
         output_file = j["output_file"].get<std::string>();
+    if (ar.staged)
+        output_file = m_outputStager.remotePathFor(ar.manifest.job_id, ar.chunk, output_file);
 
-    emitEvent("chunk_finished", ar.chunk, {
+    emitEvent(slot, "chunk_finished", ar.chunk, {
         {"elapsed_ms", elapsed_ms},
         {"exit_code", exit_code},
         {"output_file", output_file.empty() ? nlohmann::json(nullptr) : nlohmann::json(output_file)},
     });
 
+    // Throughput sample for ETAs and the scheduler's node-speed model; a tiled
+    // still's merge isn't a render
+    if (!ar.manifest.tiles.isMerge(ar.chunk.frame_start))
+    {
+        if (!m_metrics.isOpen())
+            m_metrics.open(m_farmPath / "metrics", m_nodeId);
+        ChunkMetric metric;
+        metric.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        metric.node_id = m_nodeId;
+        metric.job_id = ar.manifest.job_id;
+        metric.template_id = ar.manifest.template_id;
+        metric.frames = ar.chunk.frame_end - ar.chunk.frame_start + 1;
+        metric.wall_ms = elapsed_ms;
+        metric.peak_mb = peak_mb;
+        metric.tile = ar.manifest.tiles.enabled();
+        m_metrics.append(metric);
+    }
+
     std::string jobId = ar.manifest.job_id;
     ChunkRange chunk = ar.chunk;
 
     MonitorLog::instance().info("render", "Chunk " + chunk.rangeStr() + " completed for job " + jobId + " (exit_code=" + std::to_string(exit_code) + ", elapsed=" + std::to_string(elapsed_ms) + "ms)");
 
-    m_activeRender.reset();
-    if (m_completionFn)
-        m_completionFn(jobId, chunk, "completed");
+    traceRenderEnd(slot, "completed");
+
+    // Staged: the slot frees up now, the coordinator hears once uploads commit
+    bool staged = ar.staged;
+    slot.active.reset();
+    if (staged)
+        m_outputStager.endChunk(jobId, chunk);
+    else if (m_completionFn)
+        m_completionFn(jobId, chunk, "completed", {});
 }
 
-void RenderCoordinator::onChunkFailed(const nlohmann::json& j)
+void RenderCoordinator::onChunkFailed(Slot& slot, const nlohmann::json& j)
 {
-    if (!m_activeRender.has_value())
+    if (!slot.active.has_value())
         return;
 
-    auto& ar = m_activeRender.value();
-    flushStdout();
+    auto& ar = slot.active.value();
+    slot.stdoutWriter->finish();
 
     int exit_code = j.value("exit_code", -1);
     std::string error = j.value("error", std::string("Unknown error"));
 
-    emitEvent("chunk_failed", ar.chunk, {
+    emitEvent(slot, "chunk_failed", ar.chunk, {
         {"exit_code", exit_code},
         {"error", error},
     });
 
     MonitorLog::instance().error("render", "Chunk " + ar.chunk.rangeStr() + " failed: " + error);
 
-    failChunk(error);
+    failChunk(slot, error);
 }
 
-void RenderCoordinator::failChunk(const std::string& error)
+void RenderCoordinator::failChunk(Slot& slot, const std::string& error)
 {
-    if (!m_activeRender.has_value())
+    if (!slot.active.has_value())
         return;
 
-    std::string jobId = m_activeRender->manifest.job_id;
-    ChunkRange chunk = m_activeRender->chunk;
+    std::string jobId = slot.active->manifest.job_id;
+    ChunkRange chunk = slot.active->chunk;
 
     MonitorLog::instance().error("render", "Chunk " + chunk.rangeStr() + " FAILED for job " + jobId + ": " + error);
 
-    m_activeRender.reset();
+    // Finished frames are salvaged unless they only exist in staging
+    std::set<int> done;
+    if (slot.active->staged)
+        m_outputStager.discardChunk(jobId, chunk);
+    else
+        done.insert(slot.active->completedFrames.lower_bound(chunk.frame_start),
+                    slot.active->completedFrames.upper_bound(chunk.frame_end));
+    if (!done.empty())
+        MonitorLog::instance().info("render", std::to_string(done.size()) + " frame(s) of " +
+            chunk.rangeStr() + " finished before the failure");
+
+    traceRenderEnd(slot, "failed");
+    slot.active.reset();
     if (m_completionFn)
-        m_completionFn(jobId, chunk, "failed");
+        m_completionFn(jobId, chunk, "failed", formatFrameSet(done));
+}
+
+void RenderCoordinator::traceRenderEnd(Slot& slot, const char* state)
+{
+    const auto& ar = slot.active.value();
+    if (ar.ackUs == 0)
+        return;     // never acknowledged: nothing rendered
+    int64_t startUs = ar.loadedUs ? ar.loadedUs : ar.ackUs;
+    ChunkTrace::instance().record(ar.manifest.job_id, ar.traceId, ar.chunk, "render", startUs, ChunkTrace::nowUs(),
+                                  {{"state", state}, {"frames_done", ar.completedFrames.size()}});
 }
 
 } // namespace SR
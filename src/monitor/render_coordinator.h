@@ -1,11 +1,19 @@
 #pragma once
 
 #include "core/job_types.h"
+#include "core/event_log.h"
+#include "core/render_metrics.h"
+#include "core/token_template.h"
+#include "monitor/stdout_writer.h"
+#include "monitor/input_cache.h"
+#include "monitor/output_stager.h"
 
 #include <filesystem>
 #include <string>
 #include <vector>
-#include <queue>
+#include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <optional>
@@ -16,68 +24,149 @@
 namespace SR {
 
 class AgentSupervisor;
+struct AgentMessage;
 
+// Runs chunks on this node's render slots — one agent each. Queued chunks go
+// to whichever slot frees up first; every slot shares the node's event log.
 class RenderCoordinator
 {
 public:
+    // framesDone: on "failed", the frames that finished before the failure
+    // (formatFrameSet), so the coordinator only requeues the rest
     using CompletionCallback = std::function<void(const std::string& jobId,
                                                    const ChunkRange& chunk,
-                                                   const std::string& state)>;
+                                                   const std::string& state,
+                                                   const std::string& framesDone)>;
 
     RenderCoordinator() = default;
 
+    // One supervisor per render slot, slot 0 first
     void init(const std::filesystem::path& farmPath, const std::string& nodeId,
               const std::string& nodeOS, CompletionCallback completionFn,
-              AgentSupervisor* supervisor);
+              const std::vector<AgentSupervisor*>& agents);
 
-    // Called by DispatchManager — thread-safe
-    void queueDispatch(const JobManifest& manifest, const ChunkRange& chunk);
+    // Called by DispatchManager — thread-safe. traceId (the coordinator's,
+    // for ChunkTrace) goes out with the task and comes back on agent replies.
+    void queueDispatch(const JobManifest& manifest, const ChunkRange& chunk,
+                       const std::string& traceId = {});
 
     // Called from MonitorApp::update() (main thread)
-    void update(AgentSupervisor& supervisor);
+    void update();
 
-    // Called from AgentSupervisor message handler (main thread)
-    void handleAgentMessage(const std::string& type, const nlohmann::json& j);
+    // Called from slot's AgentSupervisor message handler (main thread)
+    void handleAgentMessage(size_t slot, const AgentMessage& msg);
 
     // Abort (kill-only — no drain concept)
-    void abortCurrentRender(const std::string& reason);
+    void abortAll(const std::string& reason);
+    bool abortChunk(const std::string& jobId, const ChunkRange& chunk, const std::string& reason);
+    void abortJob(const std::string& jobId, const std::string& reason);
     void purgeJob(const std::string& jobId);  // Remove queued (not yet active) chunks for a job
+    void purgeChunk(const std::string& jobId, const ChunkRange& chunk);  // Remove one queued chunk
     void setStopped(bool stopped);
     bool isStopped() const { return m_stopped; }
 
-    // UI queries
-    bool isRendering() const { return m_activeRender.has_value(); }
+    // Slot queries
+    size_t slotCount() const { return m_slots.size(); }
+    size_t activeCount() const;
+    size_t freeSlots() const;   // idle, with a connected agent
+    std::vector<std::string> activeJobIds() const;  // one per busy slot, deduplicated
+
+    // UI queries (current* describe the first busy slot)
+    bool isRendering() const { return activeCount() > 0; }
+    bool hasChunk(const std::string& jobId, const ChunkRange& chunk);  // active or queued
+    size_t queuedCount();
     std::string currentJobId() const;
-    ChunkRange currentChunk() const;
-    std::string currentChunkLabel() const;  // "f42" or "f42-50"
+    std::string currentChunkLabel() const;  // "f42" or "f42-50"; busy slots joined by ", "
     float currentProgress() const;
 
-private:
-    // Task JSON building + dispatch
-    nlohmann::json buildTaskJson(const JobManifest& manifest, const ChunkRange& chunk);
-    void dispatchChunk(AgentSupervisor& supervisor);
-    std::string substituteTokens(const std::string& input, const ChunkRange& chunk) const;
+    // Stdout log handling (from Config; applies to the next chunk)
+    void setStdoutOptions(bool compress, bool stageLocally);
+
+    // Node-local input cache (from Config). Queued chunks' inputs are
+    // prefetched; prefetchInputs() warms the cache for a job not queued yet.
+    void setInputCacheOptions(bool enabled, const std::string& dir, int budgetGb);  // dir "" = app data
+    bool inputCacheEnabled() const { return m_inputCache.isRunning(); }
+    void prefetchInputs(const JobManifest& manifest);
 
-    // Event files
-    void emitEvent(const std::string& type, const ChunkRange& chunk, const nlohmann::json& extra = {});
-    uint64_t nextEventSeq();
+    // Output staging (from Config): chunks render locally and report
+    // completion once their uploads commit. Persistent-process jobs keep
+    // writing to the share, since their output path is fixed at launch.
+    void setOutputStaging(bool enabled, const std::string& dir);  // dir "" = app data
+    size_t pendingUploads() const { return m_outputStager.pendingUploads(); }
 
-    // Stdout log files
-    void flushStdout();
-    void appendStdout(const std::vector<std::string>& lines);
+    // Render process placement (from Config): priority "" = per template;
+    // slotNuma by slot index, -1 = the template's NUMA node
+    void setPlacementOptions(const std::string& priority, std::vector<int> slotNuma);
+
+private:
+    struct Slot;
+
+    // A job's task message, compiled on its first chunk: args and working dir
+    // as token plans ({frame}, {chunk_start}, {chunk_end}; for a tiled job's
+    // units also {tile_index}, {tile_count}, {tile_col}, {tile_row},
+    // {tile_cols}, {tile_rows}, {tile_min_x}/{tile_max_x}/{tile_min_y}/
+    // {tile_max_y}), everything chunk-independent already serialized
+    struct TaskPlan
+    {
+        struct Arg
+        {
+            explicit Arg(TokenTemplate t) : text(std::move(t)) {}
+
+            TokenTemplate text;
+            int cacheFlag = -1;     // manifest.flags index whose value may be an input cache copy
+            bool output = false;    // an output path, redirected when staging
+            std::string json;       // serialized already: nothing about it varies per chunk
+        };
+        int64_t submittedAtMs = 0;  // a resubmission under the same id recompiles
+        std::string head;           // {"type":"task","job_id":...
+        std::string executable;     // JSON strings
+        std::string mergeExecutable;
+        std::vector<Arg> args;
+        std::vector<Arg> mergeArgs;
+        std::optional<TokenTemplate> mergeOutput;   // the output path flag, for the merge's {output_path}
+        std::optional<TokenTemplate> workingDir;
+        std::string tail;           // ,"environment":...  — the rest of the object, unclosed
+        std::string mergeTail;      // same, without the DCC's progress patterns
+    };
+    std::map<std::string, TaskPlan> m_taskPlans;    // by job id
+    static constexpr size_t MAX_TASK_PLANS = 32;    // then plans of jobs no slot is on are dropped
+
+    // Task message building + dispatch
+    const TaskPlan& taskPlan(const JobManifest& manifest);
+    std::string buildTaskMessage(const JobManifest& manifest, const ChunkRange& chunk, bool staged,
+                                 const nlohmann::json& placement, const std::string& traceId);
+    nlohmann::json buildPlacement(const JobManifest& manifest, size_t slotIndex) const;  // null = inherit
+    void dispatchChunk(Slot& slot);
+    std::vector<TaskPlan::Arg> compilePersistentArgs(const JobManifest& manifest) const;
+    std::string cachedInput(const ManifestFlag& flag, const std::string& value);  // local copy when cached
+    bool canStage(const JobManifest& manifest) const;
+    std::string stagedOutput(const JobManifest& manifest, const ChunkRange& chunk, const std::string& value) const;
+    void collectUploads();  // post completions whose uploads have committed
+
+    // Events (appended to this node's log for the slot's active job)
+    void emitEvent(Slot& slot, const std::string& type, const ChunkRange& chunk,
+                   const nlohmann::json& extra = {});
+    void pruneEventLogs();  // close logs no busy slot is writing to
 
     // Completion / failure
-    void onChunkCompleted(const nlohmann::json& j);
-    void onChunkFailed(const nlohmann::json& j);
-    void failChunk(const std::string& error);
+    void onChunkCompleted(Slot& slot, const nlohmann::json& j);
+    void onChunkFailed(Slot& slot, const nlohmann::json& j);
+    void failChunk(Slot& slot, const std::string& error);
+    void traceRenderEnd(Slot& slot, const char* state);   // the "render" span, before active resets
+    void abortSlot(Slot& slot, const std::string& reason);
 
     // Dispatch queue (DispatchManager → main thread)
     struct PendingDispatch
     {
         JobManifest manifest;
         ChunkRange chunk;
+        std::chrono::steady_clock::time_point inputWaitStart{};
+        std::string traceId;
+        int64_t queuedUs = 0;       // chunk trace (ChunkTrace::nowUs)
+        int64_t inputWaitUs = 0;
     };
-    std::queue<PendingDispatch> m_dispatchQueue;
+    bool inputsReady(PendingDispatch& pending);  // false while a first fetch is still copying
+    std::deque<PendingDispatch> m_dispatchQueue;   // prefetched chunks wait here
     std::mutex m_queueMutex;
 
     // Active render state (main thread only)
@@ -88,21 +177,45 @@ private:
         bool ackReceived = false;
         float progressPct = 0.0f;
         std::chrono::steady_clock::time_point startTime;
-        std::vector<std::string> stdoutBuffer;
         std::string stdoutLogName;  // "{rangeStr}_{timestamp_ms}.log" — set once at dispatch
         std::set<int> completedFrames;
+        bool staged = false;        // outputs go through m_outputStager
+
+        // Chunk trace (ChunkTrace::nowUs): slot taken, task sent, agent ACK,
+        // first progress from the DCC
+        std::string traceId;
+        int64_t slotUs = 0;
+        int64_t taskSentUs = 0;
+        int64_t ackUs = 0;
+        int64_t loadedUs = 0;
     };
-    std::optional<ActiveRender> m_activeRender;
+
+    // Render slot (main thread only)
+    struct Slot
+    {
+        size_t index = 0;
+        AgentSupervisor* agent = nullptr;
+        std::optional<ActiveRender> active;
+        std::unique_ptr<StdoutWriter> stdoutWriter;     // one open log per slot, written off-thread
+    };
+    std::vector<Slot> m_slots;
 
     // Config
     std::filesystem::path m_farmPath;
     std::string m_nodeId;
     std::string m_nodeOS;
     CompletionCallback m_completionFn;
-    AgentSupervisor* m_supervisor = nullptr;
-    uint64_t m_eventSeq = 0;
-    bool m_eventSeqLoaded = false;
+    // One writer per job's events/{nodeId} dir, shared by the slots on that job
+    std::map<std::filesystem::path, EventLogWriter> m_eventLogs;
+    RenderMetricsWriter m_metrics;     // metrics/{nodeId}.jsonl, opened on first completion
     bool m_stopped = false;
+
+    InputCache m_inputCache;
+    OutputStager m_outputStager;
+    bool m_stageOutputs = false;
+    std::string m_renderPriority;
+    std::vector<int> m_slotNuma;
+    static constexpr int INPUT_WAIT_MS = 300000;  // then render from the share
 };
 
 } // namespace SR
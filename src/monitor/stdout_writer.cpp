@@ -0,0 +1,331 @@
+#include "monitor/stdout_writer.h"
+#include "core/monitor_log.h"
+
+#include <zlib.h>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+gzFile openGz(const fs::path& path, const char* mode)
+{
+#ifdef _WIN32
+    return gzopen_w(path.wstring().c_str(), mode);
+#else
+    return gzopen(path.string().c_str(), mode);
+#endif
+}
+
+// Compress src into dst via dst.tmp, so readers never see a partial .gz
+bool gzipFile(const fs::path& src, const fs::path& dst)
+{
+    std::ifstream in(src, std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    auto tmp = dst;
+    tmp += ".tmp";
+    gzFile out = openGz(tmp, "wb6");
+    if (!out)
+        return false;
+
+    bool ok = true;
+    std::vector<char> buf(64 * 1024);
+    while (ok && in)
+    {
+        in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+        auto n = static_cast<unsigned>(in.gcount());
+        if (n > 0 && gzwrite(out, buf.data(), n) != static_cast<int>(n))
+            ok = false;
+    }
+    if (gzclose(out) != Z_OK)
+        ok = false;
+
+    std::error_code ec;
+    if (ok)
+        fs::rename(tmp, dst, ec);
+    if (!ok || ec)
+    {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+StdoutWriter::~StdoutWriter()
+{
+    stop();
+}
+
+void StdoutWriter::start(const fs::path& stagingDir)
+{
+    if (m_thread.joinable())
+        return;
+
+    m_stagingDir = stagingDir;
+    m_running = true;
+    m_thread = std::thread(&StdoutWriter::threadFunc, this);
+}
+
+void StdoutWriter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+            return;
+        m_running = false;
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void StdoutWriter::setOptions(bool compress, bool stageLocally)
+{
+    // Staging applies from the next begin(); compression to the next finish
+    m_compress = compress;
+    m_stageLocally = stageLocally;
+}
+
+void StdoutWriter::begin(const fs::path& farmLogPath)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ops.push_back({Op::Kind::Begin, farmLogPath, {}});
+    }
+    m_cv.notify_one();
+}
+
+void StdoutWriter::append(const std::vector<std::string>& lines)
+{
+    if (lines.empty())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ops.push_back({Op::Kind::Lines, {}, lines});
+    }
+    m_cv.notify_one();
+}
+
+void StdoutWriter::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ops.push_back({Op::Kind::Finish, {}, {}});
+    }
+    m_cv.notify_one();
+}
+
+fs::path StdoutWriter::partPath(const fs::path& logPath, int part)
+{
+    if (part == 0)
+        return logPath;
+    auto p = logPath;
+    p.replace_extension(".p" + std::to_string(part) + ".log");
+    return p;
+}
+
+bool StdoutWriter::readLines(const fs::path& path,
+                             const std::function<void(std::string&&)>& fn)
+{
+    if (path.extension() != ".gz")
+    {
+        std::ifstream ifs(path);
+        if (!ifs.is_open())
+            return false;
+        std::string line;
+        while (std::getline(ifs, line))
+            fn(std::move(line));
+        return true;
+    }
+
+    gzFile in = openGz(path, "rb");
+    if (!in)
+        return false;
+
+    // gzgets splits lines longer than the buffer; stitch them back together
+    char buf[8192];
+    std::string line;
+    while (gzgets(in, buf, sizeof(buf)))
+    {
+        line += buf;
+        if (!line.empty() && line.back() == '\n')
+        {
+            line.pop_back();
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            fn(std::move(line));
+            line.clear();
+        }
+    }
+    if (!line.empty())
+        fn(std::move(line));
+    gzclose(in);
+    return true;
+}
+
+// ─── Writer thread ──────────────────────────────────────────────────────────
+
+void StdoutWriter::threadFunc()
+{
+    while (true)
+    {
+        std::deque<Op> ops;
+        bool running;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS),
+                          [this] { return !m_ops.empty() || !m_running; });
+            ops.swap(m_ops);
+            running = m_running;
+        }
+
+        for (auto& op : ops)
+            handle(op);
+
+        if (!m_pending.empty())
+        {
+            auto age = std::chrono::steady_clock::now() - m_pendingSince;
+            if (age >= std::chrono::milliseconds(FLUSH_INTERVAL_MS))
+                writePending();
+        }
+
+        if (!running)
+            break;
+    }
+
+    finalize();
+}
+
+void StdoutWriter::handle(Op& op)
+{
+    switch (op.kind)
+    {
+    case Op::Kind::Begin:
+        finalize();
+        m_farmLog = op.path;
+        m_staged = m_stageLocally && !m_stagingDir.empty();
+        m_writeLog = m_staged ? m_stagingDir / op.path.filename() : op.path;
+        m_part = 0;
+        openPart();
+        break;
+
+    case Op::Kind::Lines:
+        if (m_farmLog.empty())
+            break;
+        if (m_pending.empty())
+            m_pendingSince = std::chrono::steady_clock::now();
+        for (const auto& line : op.lines)
+        {
+            m_pending += line;
+            m_pending += '\n';
+        }
+        if (m_pending.size() >= FLUSH_BYTES)
+            writePending();
+        break;
+
+    case Op::Kind::Finish:
+        finalize();
+        break;
+    }
+}
+
+void StdoutWriter::openPart()
+{
+    auto path = partPath(m_writeLog, m_part);
+
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+
+    m_file.open(path, std::ios::app | std::ios::binary);
+    if (!m_file.is_open())
+        MonitorLog::instance().error("render", "Failed to open stdout log: " + path.string());
+
+    m_partBytes = fs::file_size(path, ec);
+    if (ec)
+        m_partBytes = 0;
+}
+
+void StdoutWriter::writePending()
+{
+    if (m_pending.empty())
+        return;
+
+    // Pending always holds whole lines, so parts split on line boundaries
+    if (m_file.is_open())
+    {
+        m_file.write(m_pending.data(), static_cast<std::streamsize>(m_pending.size()));
+        m_file.flush();
+        m_partBytes += m_pending.size();
+    }
+    m_pending.clear();
+
+    if (m_partBytes >= ROTATE_BYTES && m_file.is_open())
+    {
+        m_file.close();
+        ++m_part;
+        openPart();
+    }
+}
+
+void StdoutWriter::finalize()
+{
+    if (m_farmLog.empty())
+        return;
+
+    writePending();
+    if (m_file.is_open())
+        m_file.close();
+
+    for (int part = 0; part <= m_part; ++part)
+        publish(partPath(m_writeLog, part), partPath(m_farmLog, part));
+
+    m_farmLog.clear();
+    m_writeLog.clear();
+    m_part = 0;
+    m_partBytes = 0;
+}
+
+void StdoutWriter::publish(const fs::path& src, const fs::path& dst)
+{
+    std::error_code ec;
+    if (!fs::exists(src, ec))
+        return;
+    if (m_staged)
+        fs::create_directories(dst.parent_path(), ec);
+
+    if (m_compress)
+    {
+        auto gz = dst;
+        gz += ".gz";
+        if (gzipFile(src, gz))
+        {
+            // The .gz is in place before the plain log goes away
+            fs::remove(src, ec);
+            return;
+        }
+        MonitorLog::instance().warn("render", "Failed to compress stdout log: " + src.string());
+    }
+
+    if (!m_staged)
+        return;     // already on the farm, uncompressed
+
+    auto tmp = dst;
+    tmp += ".tmp";
+    fs::copy_file(src, tmp, fs::copy_options::overwrite_existing, ec);
+    if (!ec)
+        fs::rename(tmp, dst, ec);
+    if (ec)
+    {
+        MonitorLog::instance().error("render", "Failed to upload stdout log: " + dst.string() + " (" + ec.message() + ")");
+        fs::remove(tmp, ec);
+        return;     // leave the staged copy for inspection
+    }
+    fs::remove(src, ec);
+}
+
+} // namespace SR
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SR {
+
+// Background writer for one render's stdout log at a time.
+//
+// Lines are buffered and written to a handle kept open for the whole chunk,
+// flushed every FLUSH_BYTES or FLUSH_INTERVAL_MS. Logs past ROTATE_BYTES
+// continue in "{name}.pN.log" parts. When the chunk finishes, each part is
+// gzipped to "{part}.gz" (if compression is on). With local staging, the log
+// is written under the app data dir and only reaches the farm at finish: one
+// upload instead of a stream of small network appends, but no live tail for
+// other nodes.
+//
+// begin/append/finish are called from the main thread and only queue work.
+class StdoutWriter
+{
+public:
+    StdoutWriter() = default;
+    ~StdoutWriter();
+
+    StdoutWriter(const StdoutWriter&) = delete;
+    StdoutWriter& operator=(const StdoutWriter&) = delete;
+
+    void start(const std::filesystem::path& stagingDir);
+    void stop();    // finishes the open log first
+
+    void setOptions(bool compress, bool stageLocally);
+
+    // Start a new log at farmLogPath (".../stdout/{node}/{range}_{ts}.log").
+    // An unfinished previous log is finished first.
+    void begin(const std::filesystem::path& farmLogPath);
+    void append(const std::vector<std::string>& lines);
+    void finish();
+
+    static constexpr size_t   FLUSH_BYTES       = 64 * 1024;
+    static constexpr int      FLUSH_INTERVAL_MS = 1000;
+    static constexpr uint64_t ROTATE_BYTES      = 16ull * 1024 * 1024;
+
+    // "{range}_{ts}.log" -> "{range}_{ts}.pN.log" (part 0 is the path itself)
+    static std::filesystem::path partPath(const std::filesystem::path& logPath, int part);
+
+    // Read a ".log" or ".log.gz" line by line. False if it can't be opened.
+    static bool readLines(const std::filesystem::path& path,
+                          const std::function<void(std::string&&)>& fn);
+
+private:
+    struct Op
+    {
+        enum class Kind { Begin, Lines, Finish } kind;
+        std::filesystem::path path;
+        std::vector<std::string> lines;
+    };
+
+    void threadFunc();
+    void handle(Op& op);
+    void openPart();
+    void writePending();
+    void finalize();
+    void publish(const std::filesystem::path& src, const std::filesystem::path& dst);
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Op> m_ops;
+    bool m_running = false;
+
+    std::atomic<bool> m_compress{true};
+    std::atomic<bool> m_stageLocally{false};
+    std::filesystem::path m_stagingDir;
+
+    // Writer-thread state for the open log
+    std::filesystem::path m_farmLog;        // part 0 path on the farm
+    std::filesystem::path m_writeLog;       // part 0 path being written (farm or staging)
+    bool m_staged = false;
+    int m_part = 0;
+    std::ofstream m_file;
+    uint64_t m_partBytes = 0;
+    std::string m_pending;
+    std::chrono::steady_clock::time_point m_pendingSince{};
+};
+
+} // namespace SR
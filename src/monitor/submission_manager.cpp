@@ -1,9 +1,11 @@
 #include "monitor/submission_manager.h"
+#include "core/archive_index.h"
 #include "core/atomic_file_io.h"
 #include "core/monitor_log.h"
 #include "monitor/template_manager.h"
 
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <filesystem>
 #include <chrono>
 
@@ -20,18 +22,24 @@ void SubmissionManager::start(const fs::path& farmPath,
                               const std::string& nodeId,
                               const std::string& os,
                               TemplateLoader templateLoader,
-                              JobSubmitter jobSubmitter)
+                              JobSubmitter jobSubmitter,
+                              SubmittedFn onSubmitted)
 {
     m_farmPath = farmPath;
     m_nodeId = nodeId;
     m_os = os;
     m_templateLoader = std::move(templateLoader);
     m_jobSubmitter = std::move(jobSubmitter);
+    m_onSubmitted = std::move(onSubmitted);
     m_running = true;
 
     // Ensure submissions directories exist
-    std::error_code ec;
-    fs::create_directories(m_farmPath / "submissions" / "processed", ec);
+    FarmStorage::current().createDirectories(m_farmPath / "submissions" / "processed");
+
+    m_watch = FarmStorage::current().watch(m_farmPath / "submissions", false, [this](const fs::path& rel) {
+        if (rel.empty() || rel.extension() == ".json")
+            wakeUp();
+    });
 
     // Start background thread
     m_threadRunning.store(true);
@@ -42,6 +50,7 @@ void SubmissionManager::start(const fs::path& farmPath,
 
 void SubmissionManager::stop()
 {
+    m_watch.reset();
     m_running = false;
     m_threadRunning.store(false);
     if (m_thread.joinable())
@@ -74,7 +83,8 @@ void SubmissionManager::threadFunc()
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastPoll).count();
         bool woken = m_wakeFlag.exchange(false);
 
-        if (elapsed < POLL_INTERVAL_MS && !woken)
+        int interval = (m_watch && m_watch->isActive()) ? DirWatcher::FALLBACK_POLL_MS : POLL_INTERVAL_MS;
+        if (elapsed < interval && !woken)
             continue;
 
         m_lastPoll = now;
@@ -105,82 +115,172 @@ void SubmissionManager::threadFunc()
 void SubmissionManager::pollInbox()
 {
     auto inboxDir = m_farmPath / "submissions";
-    std::error_code ec;
-
-    if (!fs::is_directory(inboxDir, ec)) return;
 
     // Collect and sort JSON files
     std::vector<fs::path> files;
-    for (auto& entry : fs::directory_iterator(inboxDir, ec))
+    for (const auto& entry : FarmStorage::current().list(inboxDir))
     {
-        if (!entry.is_regular_file(ec)) continue;
-        if (entry.path().extension() != ".json") continue;
-        files.push_back(entry.path());
+        if (entry.isDir || !entry.name.ends_with(".json")) continue;
+        files.push_back(inboxDir / entry.name);
     }
 
     // Sort by filename (timestamp-based = chronological order)
     std::sort(files.begin(), files.end());
 
+    // Validate everything first, so a packed file's jobs go out together
+    PassState pass;
+    std::vector<PreparedJob> jobs;
+    std::vector<fs::path> done;
     for (const auto& file : files)
     {
-        processSubmission(file);
+        if (readSubmission(file, pass, jobs))
+            done.push_back(file);
+    }
+
+    size_t submitted = 0;
+    if (!jobs.empty())
+    {
+        auto results = submitAll(jobs);
+        std::map<std::string, std::pair<size_t, size_t>> perFile;   // packed file → submitted, failed
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            const auto& job = jobs[i];
+            if (results[i].empty())
+            {
+                MonitorLog::instance().error("farm", "Failed to submit job from submission: " + job.source);
+                if (job.packed)
+                    ++perFile[job.file].second;
+                continue;
+            }
+            ++submitted;
+            if (job.packed)
+                ++perFile[job.file].first;
+            else
+                MonitorLog::instance().info("farm", "Auto-submitted job '" + results[i] + "' from " +
+                                            job.host + " (template: " + job.templateId + ")");
+        }
+        for (const auto& [file, counts] : perFile)
+        {
+            MonitorLog::instance().info("farm", "Packed submission " + file + ": " +
+                                        std::to_string(counts.first) + " job(s) submitted, " +
+                                        std::to_string(counts.second) + " failed");
+        }
     }
+
+    // Always move to processed (even on error, to prevent retry loop)
+    for (const auto& file : done)
+        moveToProcessed(file);
+
+    if (submitted > 0 && m_onSubmitted)
+        m_onSubmitted(submitted);
 }
 
-void SubmissionManager::processSubmission(const fs::path& file)
+bool SubmissionManager::readSubmission(const fs::path& file, PassState& pass,
+                                       std::vector<PreparedJob>& jobs)
 {
     auto data = AtomicFileIO::safeReadJson(file);
+    std::string fname = file.filename().string();
     if (!data.has_value())
     {
-        std::string fname = file.filename().string();
         int& count = m_readFailCounts[fname];
         ++count;
         if (count >= MAX_READ_RETRIES)
         {
             MonitorLog::instance().error("farm", "Giving up on unreadable submission after " +
                                          std::to_string(count) + " retries: " + fname);
-            std::error_code ec;
-            fs::rename(file, m_farmPath / "submissions" / "processed" / file.filename(), ec);
             m_readFailCounts.erase(fname);
+            return true;
         }
-        else
+        MonitorLog::instance().info("farm", "Submission not yet readable (retry " +
+                                    std::to_string(count) + "): " + fname);
+        return false;
+    }
+
+    // Clear retry counter on successful read
+    m_readFailCounts.erase(fname);
+
+    const auto& j = data.value();
+    if (!j.is_object() || !j.contains("jobs"))
+    {
+        if (auto job = prepareJob(j, fname, pass))
         {
-            MonitorLog::instance().info("farm", "Submission not yet readable (retry " +
-                                        std::to_string(count) + "): " + fname);
+            job->file = fname;
+            jobs.push_back(std::move(*job));
         }
-        return;
+        return true;
     }
 
-    // Clear retry counter on successful read
-    m_readFailCounts.erase(file.filename().string());
+    if (!j["jobs"].is_array())
+    {
+        MonitorLog::instance().error("farm", "Packed submission 'jobs' is not an array: " + fname);
+        return true;
+    }
 
-    try
+    // Packed: the file's own keys are defaults for every entry
+    nlohmann::json defaults = j;
+    defaults.erase("jobs");
+    const auto& entries = j["jobs"];
+    if (entries.size() > MAX_PACKED_JOBS)
+        MonitorLog::instance().error("farm", "Packed submission " + fname + " has " +
+                                     std::to_string(entries.size()) + " jobs, only the first " +
+                                     std::to_string(MAX_PACKED_JOBS) + " are read");
+
+    size_t count = (std::min)(entries.size(), MAX_PACKED_JOBS);
+    for (size_t i = 0; i < count; ++i)
     {
-        const auto& j = data.value();
+        std::string source = fname + "#" + std::to_string(i);
+        if (!entries[i].is_object())
+        {
+            MonitorLog::instance().error("farm", "Packed submission entry is not an object: " + source);
+            continue;
+        }
+
+        nlohmann::json request = defaults;
+        for (const auto& [key, val] : entries[i].items())
+        {
+            if (key == "overrides" && val.is_object() && request.contains("overrides") &&
+                request["overrides"].is_object())
+                request["overrides"].update(val);
+            else
+                request[key] = val;
+        }
+
+        if (auto job = prepareJob(request, source, pass))
+        {
+            job->file = fname;
+            job->packed = true;
+            jobs.push_back(std::move(*job));
+        }
+    }
+    return true;
+}
 
+std::optional<SubmissionManager::PreparedJob> SubmissionManager::prepareJob(
+    const nlohmann::json& j, const std::string& source, PassState& pass)
+{
+    try
+    {
         std::string templateId = j.value("template_id", "");
         std::string jobName = j.value("job_name", "");
         std::string submittedByHost = j.value("submitted_by_host", "");
 
         if (templateId.empty())
         {
-            MonitorLog::instance().error("farm", "Submission missing template_id: " + file.filename().string());
-            std::error_code ec;
-            fs::rename(file, m_farmPath / "submissions" / "processed" / file.filename(), ec);
-            return;
+            MonitorLog::instance().error("farm", "Submission missing template_id: " + source);
+            return std::nullopt;
         }
 
-        // Load template
-        auto tmplOpt = m_templateLoader(templateId);
-        if (!tmplOpt.has_value())
+        // Load template (once per pass: a packed file usually names one)
+        auto cached = pass.templates.find(templateId);
+        if (cached == pass.templates.end())
+            cached = pass.templates.emplace(templateId, m_templateLoader(templateId)).first;
+        if (!cached->second.has_value())
         {
             MonitorLog::instance().error("farm", "Template not found for submission: " + templateId);
-            std::error_code ec;
-            fs::rename(file, m_farmPath / "submissions" / "processed" / file.filename(), ec);
-            return;
+            return std::nullopt;
         }
 
-        auto tmpl = tmplOpt.value();
+        auto tmpl = cached->second.value();
 
         // Apply overrides from submission
         if (j.contains("overrides") && j["overrides"].is_object())
@@ -220,6 +320,15 @@ void SubmissionManager::processSubmission(const fs::path& file)
                 timeout = j["timeout_seconds"].get<int>();
         }
 
+        std::optional<int> targetChunkSeconds = tmpl.job_defaults.target_chunk_seconds;
+        if (j.contains("target_chunk_seconds"))
+        {
+            if (j["target_chunk_seconds"].is_null())
+                targetChunkSeconds = std::nullopt;
+            else
+                targetChunkSeconds = j["target_chunk_seconds"].get<int>();
+        }
+
         // Build flag values
         std::vector<std::string> flagValues;
         flagValues.reserve(tmpl.flags.size());
@@ -231,18 +340,28 @@ void SubmissionManager::processSubmission(const fs::path& file)
                 flagValues.push_back("");
         }
 
-        // Generate slug
-        auto jobsDir = m_farmPath / "jobs";
+        // Generate slug against one listing of jobs/ and archive/ per pass,
+        // so ids handed out earlier in the pass count as taken
+        if (!pass.idsListed)
+        {
+            for (const auto& dir : {m_farmPath / "jobs", ArchiveIndex::dir(m_farmPath)})
+            {
+                for (auto& entry : FarmStorage::current().list(dir))
+                    pass.takenIds.insert(std::move(entry.name));
+            }
+            pass.idsListed = true;
+        }
         if (jobName.empty())
             jobName = templateId + "-batch";
-        auto slug = TemplateManager::generateSlug(jobName, jobsDir);
+        auto slug = TemplateManager::generateSlug(jobName, [&](const std::string& id) {
+            return pass.takenIds.count(id) > 0;
+        });
         if (slug.empty())
         {
             MonitorLog::instance().error("farm", "Failed to generate slug for submission: " + jobName);
-            std::error_code ec;
-            fs::rename(file, m_farmPath / "submissions" / "processed" / file.filename(), ec);
-            return;
+            return std::nullopt;
         }
+        pass.takenIds.insert(slug);
 
         // Get cmd for coordinator's OS (used as fallback)
         std::string cmdPath = getCmdForOS(tmpl.cmd, m_os);
@@ -252,47 +371,109 @@ void SubmissionManager::processSubmission(const fs::path& file)
             tmpl, flagValues, cmdPath, slug,
             frameStart, frameEnd, chunkSize,
             maxRetries, timeout, m_nodeId, m_os);
+        manifest.target_chunk_seconds = targetChunkSeconds;
 
-        // Submit
-        auto result = m_jobSubmitter(manifest, priority);
-        if (result.empty())
+        // "tiles": {"cols", "rows"} splits frame_start into tiles (template permitting)
+        if (j.contains("tiles") && j["tiles"].is_object())
         {
-            MonitorLog::instance().error("farm", "Failed to submit job from submission: " + jobName);
+            int cols = j["tiles"].value("cols", 0);
+            int rows = j["tiles"].value("rows", 0);
+            manifest.frame_end = manifest.frame_start;
+            if (!TemplateManager::applyTileSplit(manifest, cols, rows))
+                MonitorLog::instance().warn("farm", "Tile split ignored for " + jobName +
+                    ": template '" + templateId + "' has no merge, or the grid is out of range");
         }
-        else
+
+        for (const auto& d : j.value("depends_on", nlohmann::json::array()))
         {
-            MonitorLog::instance().info("farm", "Auto-submitted job '" + result + "' from " +
-                                        submittedByHost + " (template: " + templateId + ")");
+            JobDependency dep;
+            std::string name;
+            if (d.is_string())
+            {
+                name = d.get<std::string>();
+            }
+            else if (d.is_object())
+            {
+                dep.job_id = d.value("job_id", "");
+                name = d.value("job_name", "");
+                dep.frames = d.value("frames", false);
+            }
+            if (dep.job_id.empty())
+            {
+                auto named = pass.idsByName.find(name);
+                dep.job_id = (named != pass.idsByName.end()) ? named->second : name;
+            }
+            if (!dep.job_id.empty())
+                manifest.depends_on.push_back(std::move(dep));
         }
+        pass.idsByName[jobName] = slug;
+
+        PreparedJob job;
+        job.manifest = std::move(manifest);
+        job.priority = priority;
+        job.source = source;
+        job.host = submittedByHost;
+        job.templateId = templateId;
+        return job;
     }
     catch (const std::exception& e)
     {
-        MonitorLog::instance().error("farm", "Exception processing submission " +
-                                     file.filename().string() + ": " + e.what());
+        MonitorLog::instance().error("farm", "Exception processing submission " + source + ": " + e.what());
+        return std::nullopt;
     }
+}
 
-    // Always move to processed (even on error, to prevent retry loop)
+std::vector<std::string> SubmissionManager::submitAll(const std::vector<PreparedJob>& jobs)
+{
+    // Each job is a handful of share round trips (dirs, manifest, state):
+    // latency-bound, so a few at a time rather than one after another
+    std::vector<std::string> results(jobs.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < jobs.size(); i = next.fetch_add(1))
+        {
+            try
+            {
+                results[i] = m_jobSubmitter(jobs[i].manifest, jobs[i].priority);
+            }
+            catch (const std::exception& e)
+            {
+                MonitorLog::instance().error("farm", "Exception submitting " + jobs[i].source + ": " + e.what());
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    size_t count = (std::min)(SUBMIT_WORKERS, jobs.size());
+    for (size_t w = 1; w < count; ++w)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& t : workers)
+        t.join();
+    return results;
+}
+
+void SubmissionManager::moveToProcessed(const fs::path& file)
+{
     std::error_code ec;
-    fs::rename(file, m_farmPath / "submissions" / "processed" / file.filename(), ec);
+    FarmStorage::current().rename(file, m_farmPath / "submissions" / "processed" / file.filename(), ec);
 }
 
 void SubmissionManager::purgeProcessed()
 {
+    auto& storage = FarmStorage::current();
     auto processedDir = m_farmPath / "submissions" / "processed";
-    std::error_code ec;
-
-    if (!fs::is_directory(processedDir, ec)) return;
 
     auto now = std::chrono::system_clock::now();
     auto cutoff = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()).count() - 86400000; // 24 hours
 
-    for (auto& entry : fs::directory_iterator(processedDir, ec))
+    for (const auto& entry : storage.list(processedDir))
     {
-        if (!entry.is_regular_file(ec)) continue;
+        if (entry.isDir) continue;
 
         // Extract timestamp from filename (first 13 digits before '.')
-        std::string name = entry.path().stem().string();
+        std::string name = fs::path(entry.name).stem().string();
         auto dotPos = name.find('.');
         if (dotPos == std::string::npos) continue;
 
@@ -301,7 +482,7 @@ void SubmissionManager::purgeProcessed()
             int64_t ts = std::stoll(name.substr(0, dotPos));
             if (ts < cutoff)
             {
-                fs::remove(entry.path(), ec);
+                storage.remove(processedDir / entry.name);
             }
         }
         catch (...) {}
@@ -1,12 +1,18 @@
 #pragma once
 
 #include "core/job_types.h"
+#include "core/dir_watcher.h"
+#include "core/farm_storage.h"
+
+#include <nlohmann/json.hpp>
 
 #include <filesystem>
 #include <functional>
 #include <map>
 #include <optional>
+#include <set>
 #include <string>
+#include <vector>
 #include <chrono>
 #include <thread>
 #include <atomic>
@@ -14,11 +20,21 @@
 
 namespace SR {
 
+// DCC/pipeline submission inbox, {farm}/submissions/. A file holds one job
+// request, or a packed batch: {"jobs": [...]} where every entry is a request
+// and the file's other keys are defaults shared by all of them ("overrides"
+// merge key by key). Each inbox pass validates everything it read in one go,
+// then creates the job directories in parallel. "depends_on" lists upstream
+// jobs: ids, or {"job_id" | "job_name", "frames"}, where a job_name refers to
+// a job submitted earlier in the same pass (e.g. the same packed file).
 class SubmissionManager
 {
 public:
     using TemplateLoader = std::function<std::optional<JobTemplate>(const std::string&)>;
+    // Called from several submit workers at once
     using JobSubmitter = std::function<std::string(const JobManifest&, int)>;
+    // Once per inbox pass that submitted anything (the job list rescan)
+    using SubmittedFn = std::function<void(size_t)>;
 
     ~SubmissionManager();
 
@@ -30,14 +46,43 @@ public:
                const std::string& nodeId,
                const std::string& os,
                TemplateLoader templateLoader,
-               JobSubmitter jobSubmitter);
+               JobSubmitter jobSubmitter,
+               SubmittedFn onSubmitted = {});
     void stop();
+    bool isRunning() const { return m_running; }
     void update();  // Called from MonitorApp::update() on coordinator only
     void wakeUp();  // Reset poll timer for immediate check (called on UDP notification)
 
 private:
+    struct PreparedJob
+    {
+        JobManifest manifest;
+        int priority = 0;
+        std::string file;
+        std::string source;     // file name, #index within a packed file
+        bool packed = false;
+        std::string host;
+        std::string templateId;
+    };
+
+    // Per inbox pass: template lookups and taken job ids (jobs/ and archive/
+    // listed once, plus the slugs this pass has handed out)
+    struct PassState
+    {
+        std::map<std::string, std::optional<JobTemplate>> templates;
+        std::set<std::string> takenIds;
+        bool idsListed = false;
+        std::map<std::string, std::string> idsByName;   // job_name → id given this pass
+    };
+
     void pollInbox();
-    void processSubmission(const std::filesystem::path& file);
+    // Read one inbox file into jobs; false = not readable yet, leave it
+    bool readSubmission(const std::filesystem::path& file, PassState& pass,
+                        std::vector<PreparedJob>& jobs);
+    std::optional<PreparedJob> prepareJob(const nlohmann::json& j, const std::string& source,
+                                          PassState& pass);
+    std::vector<std::string> submitAll(const std::vector<PreparedJob>& jobs);
+    void moveToProcessed(const std::filesystem::path& file);
     void purgeProcessed();
 
     std::filesystem::path m_farmPath;
@@ -47,11 +92,14 @@ private:
 
     TemplateLoader m_templateLoader;
     JobSubmitter m_jobSubmitter;
+    SubmittedFn m_onSubmitted;
 
     std::chrono::steady_clock::time_point m_lastPoll{};
     std::chrono::steady_clock::time_point m_lastPurge{};
     static constexpr int POLL_INTERVAL_MS = 5000;
     static constexpr int PURGE_INTERVAL_MS = 3600000; // 1 hour
+    static constexpr size_t SUBMIT_WORKERS = 8;         // job dirs created at once (share round trips)
+    static constexpr size_t MAX_PACKED_JOBS = 1000;     // entries past this in one file are rejected
 
     // Track unreadable files for retry (cloud FS propagation delay)
     std::map<std::string, int> m_readFailCounts;  // filename → retry count
@@ -61,6 +109,7 @@ private:
     std::thread m_thread;
     std::atomic<bool> m_threadRunning{false};
     std::atomic<bool> m_wakeFlag{false};
+    std::unique_ptr<FarmStorage::Watch> m_watch;    // submissions/ inbox
 
     void threadFunc();
 };
@@ -1,7 +1,9 @@
 #include "monitor/template_manager.h"
+#include "core/archive_index.h"
 #include "core/atomic_file_io.h"
 #include "core/platform.h"
 #include "core/monitor_log.h"
+#include "core/token_template.h"
 
 #include <algorithm>
 #include <cctype>
@@ -17,25 +19,39 @@ TemplateManager::~TemplateManager()
     stop();
 }
 
-void TemplateManager::start(const std::filesystem::path& farmPath)
+void TemplateManager::start(const std::filesystem::path& farmPath, std::vector<JobTemplate> seed)
 {
     if (m_running.load()) return;
 
     m_farmPath = farmPath;
+    m_index.clear();
 
-    // First scan synchronous — data available immediately
-    auto result = doScan();
+    if (seed.empty())
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_templates = std::move(result);
+        // First scan synchronous — data available immediately
+        bool changed = false;
+        publish(doScan(changed));
+    }
+    else
+    {
+        for (auto& tmpl : seed)
+            compilePatterns(tmpl);
+        publish(std::move(seed));
+        m_invalidated.store(true);
     }
 
+    m_watch = FarmStorage::current().watch(farmPath / "templates", true, [this](const std::filesystem::path& rel) {
+        if (rel.extension() != ".tmp")
+            m_invalidated.store(true);
+    });
+
     m_running.store(true);
     m_thread = std::thread(&TemplateManager::threadFunc, this);
 }
 
 void TemplateManager::stop()
 {
+    m_watch.reset();
     m_running.store(false);
     if (m_thread.joinable())
         m_thread.join();
@@ -47,23 +63,26 @@ void TemplateManager::threadFunc()
 
     while (m_running.load())
     {
-        for (int i = 0; i < 10 && m_running.load(); ++i)
+        for (int i = 0; i < 10 && m_running.load() && !m_invalidated.load(); ++i)
             std::this_thread::sleep_for(std::chrono::milliseconds(50));
 
         if (!m_running.load()) break;
 
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastScan).count();
-        if (elapsed < SCAN_COOLDOWN_MS)
+        bool woken = m_invalidated.exchange(false);
+        int interval = (m_watch && m_watch->isActive()) ? DirWatcher::FALLBACK_POLL_MS : SCAN_COOLDOWN_MS;
+        if (elapsed < interval && !woken)
             continue;
 
         lastScan = now;
 
         try
         {
-            auto result = doScan();
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_templates = std::move(result);
+            bool changed = false;
+            auto templates = doScan(changed);
+            if (changed)
+                publish(std::move(templates));
         }
         catch (const std::exception& e)
         {
@@ -76,13 +95,29 @@ void TemplateManager::threadFunc()
     }
 }
 
-std::vector<JobTemplate> TemplateManager::doScan()
+std::vector<JobTemplate> TemplateManager::doScan(bool& changed)
 {
-    std::vector<JobTemplate> templates;
-
     // Load examples first, then user templates
-    loadTemplatesFromDir(m_farmPath / "templates" / "examples", true, templates);
-    loadTemplatesFromDir(m_farmPath / "templates", false, templates);
+    std::vector<std::filesystem::path> order;
+    changed = false;
+    loadTemplatesFromDir(m_farmPath / "templates" / "examples", true, order, changed);
+    loadTemplatesFromDir(m_farmPath / "templates", false, order, changed);
+
+    // Files gone since the last scan
+    std::set<std::filesystem::path> seen(order.begin(), order.end());
+    std::erase_if(m_index, [&](const auto& entry) {
+        if (seen.count(entry.first))
+            return false;
+        changed = true;
+        return true;
+    });
+    if (!changed)
+        return {};
+
+    std::vector<JobTemplate> templates;
+    templates.reserve(order.size());
+    for (const auto& path : order)
+        templates.push_back(m_index.at(path).tmpl);
 
     // User templates with same template_id override examples
     std::set<std::string> userIds;
@@ -102,60 +137,109 @@ std::vector<JobTemplate> TemplateManager::doScan()
     return templates;
 }
 
-std::vector<JobTemplate> TemplateManager::getTemplateSnapshot() const
+static bool sameTemplates(const std::vector<JobTemplate>& a, const std::vector<JobTemplate>& b)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_templates;
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        // The serialized form, plus what the file format doesn't carry
+        if (a[i].valid != b[i].valid || a[i].isExample != b[i].isExample ||
+            a[i].validation_error != b[i].validation_error ||
+            nlohmann::json(a[i]) != nlohmann::json(b[i]))
+            return false;
+    }
+    return true;
 }
 
-void TemplateManager::loadTemplatesFromDir(const std::filesystem::path& dir, bool isExample,
-                                            std::vector<JobTemplate>& out)
+void TemplateManager::publish(std::vector<JobTemplate> templates)
 {
-    namespace fs = std::filesystem;
-    std::error_code ec;
-    if (!fs::is_directory(dir, ec))
+    TemplateSnapshotPtr current;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        current = m_snapshot;
+    }
+    if (current->version != 0 && sameTemplates(current->templates, templates))
         return;
 
-    for (const auto& entry : fs::directory_iterator(dir, ec))
+    auto snap = std::make_shared<TemplateSnapshot>();
+    snap->version = current->version + 1;
+    snap->templates = std::move(templates);
+    for (size_t i = 0; i < snap->templates.size(); ++i)
+        snap->byId.emplace(snap->templates[i].template_id, i);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshot = std::move(snap);
+}
+
+TemplateSnapshotPtr TemplateManager::getTemplateSnapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_snapshot;
+}
+
+void TemplateManager::loadTemplatesFromDir(const std::filesystem::path& dir, bool isExample,
+                                            std::vector<std::filesystem::path>& order, bool& changed)
+{
+    auto& storage = FarmStorage::current();
+    for (const auto& entry : storage.list(dir))
     {
-        if (!entry.is_regular_file(ec) || entry.path().extension() != ".json")
+        if (entry.isDir || !entry.name.ends_with(".json"))
             continue;
 
         // Skip farm.json
-        if (entry.path().filename() == "farm.json")
+        if (entry.name == "farm.json")
             continue;
 
-        auto data = AtomicFileIO::safeReadJson(entry.path());
-        if (!data.has_value())
-        {
-            // Create an invalid template entry so user sees the error
-            JobTemplate invalid;
-            invalid.template_id = entry.path().stem().string();
-            invalid.name = invalid.template_id;
-            invalid.valid = false;
-            invalid.validation_error = "Failed to parse JSON";
-            invalid.isExample = isExample;
-            out.push_back(std::move(invalid));
+        // A stat per file instead of a read, parse and validate
+        auto path = dir / entry.name;
+        auto st = storage.stat(path);
+        if (!st.exists)
+            continue;       // deleted since the listing
+        order.push_back(path);
+
+        auto it = m_index.find(path);
+        if (it != m_index.end() && it->second.stat.size == st.size && it->second.stat.mtime == st.mtime &&
+            it->second.stat.fileId == st.fileId)
             continue;
-        }
 
-        try
-        {
-            auto tmpl = data.value().get<JobTemplate>();
-            tmpl.isExample = isExample;
-            validateTemplate(tmpl);
-            out.push_back(std::move(tmpl));
-        }
-        catch (const std::exception& e)
-        {
-            JobTemplate invalid;
-            invalid.template_id = entry.path().stem().string();
-            invalid.name = invalid.template_id;
-            invalid.valid = false;
-            invalid.validation_error = std::string("Parse error: ") + e.what();
-            invalid.isExample = isExample;
-            out.push_back(std::move(invalid));
-        }
+        m_index[path] = IndexEntry{st, loadTemplate(path, isExample)};
+        changed = true;
+    }
+}
+
+JobTemplate TemplateManager::loadTemplate(const std::filesystem::path& path, bool isExample)
+{
+    auto data = AtomicFileIO::safeReadJson(path);
+    if (!data.has_value())
+    {
+        // Create an invalid template entry so user sees the error
+        JobTemplate invalid;
+        invalid.template_id = path.stem().string();
+        invalid.name = invalid.template_id;
+        invalid.valid = false;
+        invalid.validation_error = "Failed to parse JSON";
+        invalid.isExample = isExample;
+        return invalid;
+    }
+
+    try
+    {
+        auto tmpl = data.value().get<JobTemplate>();
+        tmpl.isExample = isExample;
+        validateTemplate(tmpl);
+        compilePatterns(tmpl);
+        return tmpl;
+    }
+    catch (const std::exception& e)
+    {
+        JobTemplate invalid;
+        invalid.template_id = path.stem().string();
+        invalid.name = invalid.template_id;
+        invalid.valid = false;
+        invalid.validation_error = std::string("Parse error: ") + e.what();
+        invalid.isExample = isExample;
+        return invalid;
     }
 }
 
@@ -172,18 +256,37 @@ static void replaceAll(std::string& str, const std::string& from, const std::str
     }
 }
 
+// Same order as the names in compilePattern()
+enum PatternToken { FramePad, ProjectDir, FileName, DateYmd, DateY, DateM, DateD, TimeHm, TimeH, TimeM };
+
+static TokenTemplate compilePattern(const std::string& pattern)
+{
+    return TokenTemplate(pattern, {
+        "frame_pad", "project_dir", "file_name",
+        "date:YYYYMMDD", "date:YYYY", "date:MM", "date:DD",
+        "time:HHmm", "time:HH", "time:mm",
+    });
+}
+
+void TemplateManager::compilePatterns(JobTemplate& tmpl)
+{
+    for (auto& f : tmpl.flags)
+    {
+        f.pattern_plan = f.default_pattern.has_value()
+            ? std::make_shared<const TokenTemplate>(compilePattern(f.default_pattern.value()))
+            : nullptr;
+    }
+}
+
 std::string TemplateManager::resolvePattern(
     const std::string& pattern,
     const JobTemplate& tmpl,
     const std::vector<std::string>& flagValues,
     std::chrono::system_clock::time_point now)
 {
-    std::string result = pattern;
-
-    // 1. {frame_pad}
-    replaceAll(result, "{frame_pad}", tmpl.frame_padding);
-
-    // 2. {project_dir} and {file_name} — derived from first type:"file" flag
+    // {project_dir} and {file_name} come from the first type:"file" flag
+    bool hasFileFlag = false;
+    std::string projectDir, fileName;
     for (size_t i = 0; i < tmpl.flags.size(); ++i)
     {
         if (tmpl.flags[i].type == "file")
@@ -191,34 +294,15 @@ std::string TemplateManager::resolvePattern(
             std::string filePath = (i < flagValues.size()) ? flagValues[i] : "";
             if (!filePath.empty())
             {
-                namespace fs = std::filesystem;
-                fs::path p(filePath);
-                std::string projectDir = p.parent_path().string();
-                std::string fileName = p.stem().string();
-                replaceAll(result, "{project_dir}", projectDir);
-                replaceAll(result, "{file_name}", fileName);
-            }
-            else
-            {
-                replaceAll(result, "{project_dir}", "");
-                replaceAll(result, "{file_name}", "");
+                std::filesystem::path p(filePath);
+                projectDir = p.parent_path().string();
+                fileName = p.stem().string();
             }
+            hasFileFlag = true;
             break;
         }
     }
 
-    // 3. {flag:id} — scan for flags with matching id
-    for (size_t i = 0; i < tmpl.flags.size(); ++i)
-    {
-        if (!tmpl.flags[i].id.empty())
-        {
-            std::string token = "{flag:" + tmpl.flags[i].id + "}";
-            std::string val = (i < flagValues.size()) ? flagValues[i] : "";
-            replaceAll(result, token, val);
-        }
-    }
-
-    // 4. Date/time tokens
     auto tt = std::chrono::system_clock::to_time_t(now);
     struct tm tmBuf;
     #ifdef _WIN32
@@ -227,27 +311,67 @@ std::string TemplateManager::resolvePattern(
     localtime_r(&tt, &tmBuf);
     #endif
 
-    char buf[32];
-    std::strftime(buf, sizeof(buf), "%Y%m%d", &tmBuf);
-    replaceAll(result, "{date:YYYYMMDD}", buf);
-
-    std::strftime(buf, sizeof(buf), "%Y", &tmBuf);
-    replaceAll(result, "{date:YYYY}", buf);
-
-    std::strftime(buf, sizeof(buf), "%m", &tmBuf);
-    replaceAll(result, "{date:MM}", buf);
-
-    std::strftime(buf, sizeof(buf), "%d", &tmBuf);
-    replaceAll(result, "{date:DD}", buf);
+    static constexpr const char* timeFormats[] = {"%Y%m%d", "%Y", "%m", "%d", "%H%M", "%H", "%M"};
 
-    std::strftime(buf, sizeof(buf), "%H%M", &tmBuf);
-    replaceAll(result, "{time:HHmm}", buf);
-
-    std::strftime(buf, sizeof(buf), "%H", &tmBuf);
-    replaceAll(result, "{time:HH}", buf);
+    // The flag's plan if this is its default_pattern (per keystroke in the
+    // submission panel), else split now
+    const TokenTemplate* plan = nullptr;
+    for (const auto& f : tmpl.flags)
+    {
+        if (f.pattern_plan && f.pattern_plan->text() == pattern)
+        {
+            plan = f.pattern_plan.get();
+            break;
+        }
+    }
+    TokenTemplate compiled;
+    if (!plan)
+    {
+        compiled = compilePattern(pattern);
+        plan = &compiled;
+    }
 
-    std::strftime(buf, sizeof(buf), "%M", &tmBuf);
-    replaceAll(result, "{time:mm}", buf);
+    // One pass; a substituted value is never scanned for tokens itself
+    std::string result = plan->render([&](int id, std::string_view name, std::string& out)
+    {
+        switch (id)
+        {
+        case FramePad:
+            out += tmpl.frame_padding;
+            return true;
+        case ProjectDir:
+        case FileName:
+            if (!hasFileFlag)
+                return false;
+            out += id == ProjectDir ? projectDir : fileName;
+            return true;
+        case TokenTemplate::UNNAMED:
+        {
+            // {flag:id}
+            constexpr std::string_view prefix = "flag:";
+            if (name.substr(0, prefix.size()) != prefix)
+                return false;
+            auto flagId = name.substr(prefix.size());
+            for (size_t i = 0; i < tmpl.flags.size(); ++i)
+            {
+                if (!tmpl.flags[i].id.empty() && tmpl.flags[i].id == flagId)
+                {
+                    if (i < flagValues.size())
+                        out += flagValues[i];
+                    return true;
+                }
+            }
+            return false;
+        }
+        default:
+        {
+            char buf[32];
+            size_t n = std::strftime(buf, sizeof(buf), timeFormats[id - DateYmd], &tmBuf);
+            out.append(buf, n);
+            return true;
+        }
+        }
+    });
 
     // 5. Cleanup pass — remove separator artifacts from empty references
     replaceAll(result, "-/", "/");
@@ -287,6 +411,13 @@ bool TemplateManager::validateTemplate(JobTemplate& tmpl)
         return false;
     }
 
+    if (!isPriorityClass(tmpl.process.priority))
+    {
+        tmpl.valid = false;
+        tmpl.validation_error = "Unknown process priority: " + tmpl.process.priority;
+        return false;
+    }
+
     return true;
 }
 
@@ -332,6 +463,17 @@ std::vector<std::string> TemplateManager::validateSubmission(
 
 std::string TemplateManager::generateSlug(const std::string& jobName,
                                           const std::filesystem::path& jobsDir)
+{
+    // Dedup check: archived jobs keep their ids too
+    auto& storage = FarmStorage::current();
+    auto archiveDir = ArchiveIndex::dir(jobsDir.parent_path());
+    return generateSlug(jobName, [&](const std::string& id) {
+        return storage.exists(jobsDir / id) || storage.exists(archiveDir / id);
+    });
+}
+
+std::string TemplateManager::generateSlug(const std::string& jobName,
+                                          const std::function<bool(const std::string&)>& taken)
 {
     // Lowercase
     std::string slug;
@@ -378,16 +520,13 @@ std::string TemplateManager::generateSlug(const std::string& jobName,
     if (slug.empty())
         return {};
 
-    // Dedup check
-    namespace fs = std::filesystem;
-    std::error_code ec;
-    if (!fs::exists(jobsDir / slug, ec))
+    if (!taken(slug))
         return slug;
 
     for (int i = 2; i <= 99; ++i)
     {
         std::string candidate = slug + "-" + std::to_string(i);
-        if (!fs::exists(jobsDir / candidate, ec))
+        if (!taken(candidate))
             return candidate;
     }
 
@@ -469,6 +608,8 @@ JobManifest TemplateManager::bakeManifestStatic(
 
         ManifestFlag mf;
         mf.flag = tf.flag;
+        mf.cache_input = tf.type == "file" && tf.cache;
+        mf.output_path = tf.type == "output";
 
         if (tf.editable && i < flagValues.size())
             mf.value = flagValues[i];
@@ -495,6 +636,7 @@ JobManifest TemplateManager::bakeManifestStatic(
     m.chunk_size = chunkSize;
     m.max_retries = maxRetries;
     m.timeout_seconds = timeout;
+    m.target_chunk_seconds = tmpl.job_defaults.target_chunk_seconds;
 
     // Copy verbatim from template
     m.progress = tmpl.progress;
@@ -502,10 +644,35 @@ JobManifest TemplateManager::bakeManifestStatic(
     m.process = tmpl.process;
     m.environment = tmpl.environment;
     m.tags_required = tmpl.tags_required;
+    m.requirements = tmpl.requirements;
+    m.tiles = tmpl.tiles;
+    m.tiles.cols = m.tiles.rows = 0;    // the submitter opts in via applyTileSplit()
 
     return m;
 }
 
+bool TemplateManager::applyTileSplit(JobManifest& manifest, int cols, int rows)
+{
+    auto& tiles = manifest.tiles;
+    tiles.cols = cols;
+    tiles.rows = rows;
+    if (!tiles.enabled() || cols > MAX_TILE_AXIS || rows > MAX_TILE_AXIS)
+    {
+        tiles.cols = tiles.rows = 0;
+        return false;
+    }
+
+    // One unit per tile plus the merge, each its own chunk. Persistent
+    // processes only take frame ranges, so tiles launch a process each.
+    tiles.frame = manifest.frame_start;
+    manifest.frame_start = 1;
+    manifest.frame_end = tiles.mergeUnit();
+    manifest.chunk_size = 1;
+    manifest.target_chunk_seconds.reset();
+    manifest.process.persistent.enabled = false;
+    return true;
+}
+
 std::string TemplateManager::buildCommandPreview(
     const JobTemplate& tmpl,
     const std::vector<std::string>& flagValues,
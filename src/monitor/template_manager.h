@@ -1,8 +1,14 @@
 #pragma once
 
 #include "core/job_types.h"
+#include "core/dir_watcher.h"
+#include "core/farm_storage.h"
 
 #include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <optional>
@@ -13,6 +19,24 @@
 
 namespace SR {
 
+// Immutable template list published by TemplateManager. A rescan that finds
+// the same templates keeps the current version.
+struct TemplateSnapshot
+{
+    uint64_t version = 0;
+    std::vector<JobTemplate> templates;
+    std::unordered_map<std::string, size_t> byId;   // template_id -> index in templates
+
+    // nullptr if unknown; invalid templates are found too (check valid)
+    const JobTemplate* find(const std::string& templateId) const
+    {
+        auto it = byId.find(templateId);
+        return it != byId.end() ? &templates[it->second] : nullptr;
+    }
+};
+
+using TemplateSnapshotPtr = std::shared_ptr<const TemplateSnapshot>;
+
 class TemplateManager
 {
 public:
@@ -22,14 +46,16 @@ public:
     TemplateManager(const TemplateManager&) = delete;
     TemplateManager& operator=(const TemplateManager&) = delete;
 
-    // Start background scanning thread. First scan is synchronous.
-    void start(const std::filesystem::path& farmPath);
+    // Start background scanning thread. Without a seed (the farm index's
+    // copy) the first scan is synchronous; with one, the seed is published
+    // and the first scan runs right away in the background.
+    void start(const std::filesystem::path& farmPath, std::vector<JobTemplate> seed = {});
 
     // Stop background thread.
     void stop();
 
     // Thread-safe snapshot for UI
-    std::vector<JobTemplate> getTemplateSnapshot() const;
+    TemplateSnapshotPtr getTemplateSnapshot() const;
 
     JobManifest bakeManifest(const JobTemplate& tmpl,
                              const std::vector<std::string>& flagValues,
@@ -48,6 +74,11 @@ public:
                              int maxRetries, std::optional<int> timeout,
                              const std::string& nodeId, const std::string& os);
 
+    // Split the manifest's first frame into cols x rows tiles plus a merge
+    // (see TileSplit). Requires a template with a merge; false = left as is.
+    static constexpr int MAX_TILE_AXIS = 16;
+    static bool applyTileSplit(JobManifest& manifest, int cols, int rows);
+
     std::string buildCommandPreview(const JobTemplate& tmpl,
                                     const std::vector<std::string>& flagValues,
                                     const std::string& cmdPath) const;
@@ -55,14 +86,24 @@ public:
     static std::string generateSlug(const std::string& jobName,
                                     const std::filesystem::path& jobsDir);
 
+    // Same, against a caller's set of taken ids (a batch listing jobs/ once)
+    static std::string generateSlug(const std::string& jobName,
+                                    const std::function<bool(const std::string&)>& taken);
+
+    // A flag's default_pattern uses the plan compiled at load; any other
+    // pattern is split into tokens on the spot
     static std::string resolvePattern(
         const std::string& pattern,
         const JobTemplate& tmpl,
         const std::vector<std::string>& flagValues,
         std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
 
+    // A scan only validates files that changed
     static bool validateTemplate(JobTemplate& tmpl);
 
+    // Fills TemplateFlag::pattern_plan for every default_pattern
+    static void compilePatterns(JobTemplate& tmpl);
+
     static std::vector<std::string> validateSubmission(
         const JobTemplate& tmpl, const std::vector<std::string>& flagValues,
         const std::string& cmdPath, const std::string& jobName,
@@ -71,15 +112,29 @@ public:
 
 private:
     void threadFunc();
-    std::vector<JobTemplate> doScan();
+    // changed = false: every file as it was last scan, the list is the same
+    std::vector<JobTemplate> doScan(bool& changed);
+    void publish(std::vector<JobTemplate> templates);
     void loadTemplatesFromDir(const std::filesystem::path& dir, bool isExample,
-                              std::vector<JobTemplate>& out);
+                              std::vector<std::filesystem::path>& order, bool& changed);
+    static JobTemplate loadTemplate(const std::filesystem::path& path, bool isExample);
+
+    // Parsed, validated template per file, re-read only when its size, mtime
+    // or file id moves. Scan thread only (and start(), before it runs).
+    struct IndexEntry
+    {
+        StorageStat stat;
+        JobTemplate tmpl;
+    };
+    std::map<std::filesystem::path, IndexEntry> m_index;
 
     std::filesystem::path m_farmPath;
-    std::vector<JobTemplate> m_templates;
+    TemplateSnapshotPtr m_snapshot = std::make_shared<const TemplateSnapshot>();
     mutable std::mutex m_mutex;
     std::atomic<bool> m_running{false};
+    std::atomic<bool> m_invalidated{false};
     std::thread m_thread;
+    std::unique_ptr<FarmStorage::Watch> m_watch;    // templates/ (including examples/)
     static constexpr int SCAN_COOLDOWN_MS = 5000;
 };
 
@@ -0,0 +1,582 @@
+#include "monitor/thumbnail_cache.h"
+#include "core/monitor_log.h"
+#include "core/perf_counters.h"
+
+#include <glad/gl.h>
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_NO_STDIO
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_TGA
+#define STBI_ONLY_BMP
+#define STBI_ONLY_HDR
+#include <stb_image.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace SR {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// FNV-1a
+uint64_t hashString(const std::string& s)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : s)
+    {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Box filter: every source pixel lands in exactly one destination pixel
+void downscale(const uint8_t* src, int w, int h, std::vector<uint8_t>& dst, int& dw, int& dh)
+{
+    int longest = (std::max)(w, h);
+    if (longest <= ThumbnailCache::THUMB_MAX)
+    {
+        dw = w;
+        dh = h;
+        dst.assign(src, src + size_t(w) * h * 4);
+        return;
+    }
+    dw = (std::max)(1, int(int64_t(w) * ThumbnailCache::THUMB_MAX / longest));
+    dh = (std::max)(1, int(int64_t(h) * ThumbnailCache::THUMB_MAX / longest));
+    dst.assign(size_t(dw) * dh * 4, 0);
+
+    std::vector<uint32_t> sum(size_t(dw) * 4);
+    for (int dy = 0; dy < dh; ++dy)
+    {
+        int y0 = int(int64_t(dy) * h / dh);
+        int y1 = (std::max)(y0 + 1, int(int64_t(dy + 1) * h / dh));
+        std::fill(sum.begin(), sum.end(), 0u);
+        for (int y = y0; y < y1; ++y)
+        {
+            const uint8_t* row = src + size_t(y) * w * 4;
+            for (int dx = 0; dx < dw; ++dx)
+            {
+                int x0 = int(int64_t(dx) * w / dw);
+                int x1 = (std::max)(x0 + 1, int(int64_t(dx + 1) * w / dw));
+                for (int x = x0; x < x1; ++x)
+                {
+                    for (int c = 0; c < 4; ++c)
+                        sum[size_t(dx) * 4 + c] += row[size_t(x) * 4 + c];
+                }
+            }
+        }
+        for (int dx = 0; dx < dw; ++dx)
+        {
+            int x0 = int(int64_t(dx) * w / dw);
+            int x1 = (std::max)(x0 + 1, int(int64_t(dx + 1) * w / dw));
+            uint32_t area = uint32_t((x1 - x0) * (y1 - y0));
+            for (int c = 0; c < 4; ++c)
+                dst[(size_t(dy) * dw + dx) * 4 + c] = uint8_t(sum[size_t(dx) * 4 + c] / area);
+        }
+    }
+}
+
+constexpr char DISK_MAGIC[4] = {'S', 'R', 'T', 'H'};
+constexpr size_t DISK_HEADER = 12;     // magic, width, height
+
+} // namespace
+
+ThumbnailCache::~ThumbnailCache()
+{
+    stopWorkers();
+}
+
+// ─── Lifecycle ──────────────────────────────────────────────────────────────
+
+void ThumbnailCache::start(const fs::path& diskDir)
+{
+    if (isRunning())
+        return;
+
+    m_diskDir = diskDir;
+    std::error_code ec;
+    fs::create_directories(m_diskDir, ec);
+    if (ec)
+    {
+        MonitorLog::instance().warn("thumbs", "Thumbnail cache dir unavailable: " + m_diskDir.string() + " (" + ec.message() + ")");
+        return;
+    }
+    trimDiskCache();
+
+    m_running = true;
+    for (int i = 0; i < WORKERS; ++i)
+        m_workers.emplace_back(&ThumbnailCache::workerFunc, this);
+}
+
+void ThumbnailCache::stop()
+{
+    stopWorkers();
+
+    for (auto& [key, e] : m_entries)
+        releaseTexture(e);
+    m_entries.clear();
+    m_lru.clear();
+    m_textureBytes = 0;
+    m_frames.reset();
+    m_pattern.reset();
+    m_jobId.clear();
+    m_completed = -1;
+    m_scanQueued = false;
+}
+
+void ThumbnailCache::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        m_queue.clear();
+        m_scan.reset();
+    }
+    m_cv.notify_all();
+    m_shareCv.notify_all();
+    for (auto& t : m_workers)
+    {
+        if (t.joinable())
+            t.join();
+    }
+    m_workers.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_done.clear();
+    m_scanDone.reset();
+}
+
+// ─── Main thread ────────────────────────────────────────────────────────────
+
+void ThumbnailCache::beginFrame()
+{
+    if (!isRunning())
+        return;
+    ++m_frame;
+
+    std::vector<Decoded> done;
+    std::optional<std::pair<std::string, std::shared_ptr<const FrameMap>>> scanDone;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        done.swap(m_done);
+        scanDone.swap(m_scanDone);
+
+        // Cells scrolled out of view: forget their queued decodes so they
+        // cost nothing, and so scrolling back queues them fresh
+        auto stale = std::remove_if(m_queue.begin(), m_queue.end(), [&](const Task& t) {
+            auto it = m_entries.find(t.key);
+            if (it == m_entries.end())
+                return true;
+            if (it->second.askedFrame + STALE_FRAMES >= m_frame)
+                return false;
+            m_entries.erase(it);
+            return true;
+        });
+        m_queue.erase(stale, m_queue.end());
+    }
+
+    if (scanDone)
+    {
+        m_scanQueued = false;
+        if (scanDone->first == m_jobId)
+            m_frames = std::move(scanDone->second);
+    }
+
+    for (auto& d : done)
+    {
+        auto it = m_entries.find(d.key);
+        if (it == m_entries.end())
+            continue;
+        auto& e = it->second;
+        if (!d.ok)
+        {
+            e.state = State::Failed;
+            continue;
+        }
+
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, d.width, d.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, d.rgba.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        e.state = State::Ready;
+        e.thumb = {uint32_t(tex), d.width, d.height};
+        m_lru.push_front(d.key);
+        e.lru = m_lru.begin();
+        m_textureBytes += d.rgba.size();
+    }
+
+    // Textures asked for last frame are on screen; never evict those
+    while (m_textureBytes > TEXTURE_BUDGET && !m_lru.empty())
+    {
+        auto it = m_entries.find(m_lru.back());
+        if (it != m_entries.end())
+        {
+            if (it->second.askedFrame + 1 >= m_frame)
+                break;
+            releaseTexture(it->second);
+            m_entries.erase(it);
+        }
+        m_lru.pop_back();
+    }
+}
+
+void ThumbnailCache::setJob(const JobManifest& manifest, int completed)
+{
+    if (!isRunning())
+        return;
+
+    if (manifest.job_id != m_jobId)
+    {
+        m_jobId = manifest.job_id;
+        m_pattern = outputPatternFor(manifest);
+        m_frames.reset();
+        m_completed = -1;
+    }
+    if (!m_pattern || m_scanQueued || completed == m_completed)
+        return;
+
+    int64_t now = nowMs();
+    if (m_completed >= 0 && now - m_lastScanMs < RESCAN_MS)
+        return;
+    m_completed = completed;
+    m_lastScanMs = now;
+    m_scanQueued = true;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_scan = std::make_pair(m_jobId, *m_pattern);
+    }
+    m_cv.notify_one();
+}
+
+ThumbnailCache::Status ThumbnailCache::get(int frame, Thumb& out)
+{
+    if (!m_frames)
+        return m_scanQueued ? Status::Pending : Status::Unavailable;
+    auto fit = m_frames->find(frame);
+    if (fit == m_frames->end() || !fit->second.decodable)
+        return Status::Unavailable;
+    const auto& file = fit->second;
+
+    auto [it, inserted] = m_entries.try_emplace(file.key);
+    auto& e = it->second;
+    e.askedFrame = m_frame;
+    if (inserted)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back({file.key, file});
+            if (m_queue.size() > MAX_QUEUE)
+            {
+                m_entries.erase(m_queue.front().key);
+                m_queue.pop_front();
+            }
+        }
+        m_cv.notify_one();
+        return Status::Pending;
+    }
+
+    switch (e.state)
+    {
+    case State::Ready:
+        m_lru.splice(m_lru.begin(), m_lru, e.lru);
+        out = e.thumb;
+        return Status::Ready;
+    case State::Queued:
+        return Status::Pending;
+    case State::Failed:
+        break;
+    }
+    return Status::Unavailable;
+}
+
+void ThumbnailCache::releaseTexture(Entry& e)
+{
+    if (e.thumb.texture == 0)
+        return;
+    GLuint tex = e.thumb.texture;
+    glDeleteTextures(1, &tex);
+    m_textureBytes -= size_t(e.thumb.width) * e.thumb.height * 4;
+    e.thumb = {};
+}
+
+// ─── Output matching ────────────────────────────────────────────────────────
+
+bool ThumbnailCache::isDecodable(const fs::path& path)
+{
+    std::string ext = path.extension().string();
+    for (auto& c : ext)
+        c = char(std::tolower((unsigned char)c));
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" ||
+           ext == ".bmp" || ext == ".hdr";
+}
+
+std::string ThumbnailCache::keyFor(const FrameFile& file)
+{
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)hashString(
+        file.path.generic_string() + "|" + std::to_string(file.size) + "|" + std::to_string(file.mtime)));
+    return buf;
+}
+
+// ─── Workers ────────────────────────────────────────────────────────────────
+
+void ThumbnailCache::workerFunc()
+{
+    for (;;)
+    {
+        std::optional<std::pair<std::string, Pattern>> scan;
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return !m_running || m_scan || !m_queue.empty(); });
+            if (!m_running)
+                return;
+            if (m_scan)
+            {
+                scan = std::move(m_scan);
+                m_scan.reset();
+            }
+            else
+            {
+                // Newest first: that's what's on screen now
+                task = std::move(m_queue.back());
+                m_queue.pop_back();
+            }
+        }
+
+        if (scan)
+        {
+            auto frames = std::make_shared<const FrameMap>(listFrames(scan->second));
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_scanDone = std::make_pair(std::move(scan->first), std::move(frames));
+        }
+        else
+        {
+            auto d = decode(task);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_running)
+                return;
+            m_done.push_back(std::move(d));
+        }
+        m_revision.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+ThumbnailCache::FrameMap ThumbnailCache::listFrames(const Pattern& pattern)
+{
+    SR_PERF_SCOPE("thumbs.list");
+    FrameMap frames;
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(pattern.dir, fs::directory_options::skip_permission_denied, ec);
+         !ec && it != fs::directory_iterator(); it.increment(ec))
+    {
+        std::error_code fileEc;
+        if (!it->is_regular_file(fileEc))
+            continue;
+        auto frame = matchOutputFrame(it->path().filename().string(), pattern);
+        if (!frame)
+            continue;
+
+        // Several files per frame (EXR plus a PNG proxy): keep one we can show
+        bool decodable = isDecodable(it->path());
+        auto existing = frames.find(*frame);
+        if (existing != frames.end() && (existing->second.decodable || !decodable))
+            continue;
+
+        FrameFile f;
+        f.path = it->path();
+        f.size = it->file_size(fileEc);
+        f.mtime = int64_t(it->last_write_time(fileEc).time_since_epoch().count());
+        f.decodable = decodable;
+        f.key = keyFor(f);
+        frames[*frame] = std::move(f);
+    }
+    return frames;
+}
+
+ThumbnailCache::Decoded ThumbnailCache::decode(const Task& task)
+{
+    Decoded d;
+    d.key = task.key;
+
+    fs::path cachePath = m_diskDir / (task.key + ".thumb");
+    if (auto hit = readDiskCache(cachePath))
+    {
+        hit->key = task.key;
+        return std::move(*hit);
+    }
+    if (task.file.size > MAX_SOURCE_BYTES)
+        return d;
+
+    // Share reads are the expensive part; cache hits above skip the queue
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_shareCv.wait(lock, [this] { return !m_running || m_shareReaders < SHARE_READS; });
+        if (!m_running)
+            return d;
+        ++m_shareReaders;
+    }
+    std::string bytes;
+    {
+        std::ifstream in(task.file.path, std::ios::binary);
+        if (in)
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_shareReaders;
+    }
+    m_shareCv.notify_one();
+    if (bytes.empty())
+        return d;
+    PerfCounters::instance().countRead(bytes.size());
+
+    SR_PERF_SCOPE("thumbs.decode");
+    int w = 0, h = 0, channels = 0;
+    stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(bytes.data()),
+                                            int(bytes.size()), &w, &h, &channels, 4);
+    if (!pixels)
+        return d;
+    downscale(pixels, w, h, d.rgba, d.width, d.height);
+    stbi_image_free(pixels);
+    d.ok = true;
+
+    writeDiskCache(cachePath, d);
+    return d;
+}
+
+// ─── Disk cache ─────────────────────────────────────────────────────────────
+
+// "{key}.thumb": magic, width, height (uint32 LE), RGBA
+std::optional<ThumbnailCache::Decoded> ThumbnailCache::readDiskCache(const fs::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return std::nullopt;
+
+    char header[DISK_HEADER];
+    if (!in.read(header, sizeof(header)) || std::memcmp(header, DISK_MAGIC, 4) != 0)
+        return std::nullopt;
+    uint32_t w = 0, h = 0;
+    std::memcpy(&w, header + 4, 4);
+    std::memcpy(&h, header + 8, 4);
+    if (w == 0 || h == 0 || w > THUMB_MAX || h > THUMB_MAX)
+        return std::nullopt;
+
+    Decoded d;
+    d.width = int(w);
+    d.height = int(h);
+    d.rgba.resize(size_t(w) * h * 4);
+    if (!in.read(reinterpret_cast<char*>(d.rgba.data()), std::streamsize(d.rgba.size())))
+        return std::nullopt;
+    in.close();
+    d.ok = true;
+
+    // Recently shown entries survive the next trim
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return d;
+}
+
+void ThumbnailCache::writeDiskCache(const fs::path& path, const Decoded& d)
+{
+    auto tmp = path;
+    tmp += ".partial";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return;
+        uint32_t w = uint32_t(d.width), h = uint32_t(d.height);
+        out.write(DISK_MAGIC, 4);
+        out.write(reinterpret_cast<const char*>(&w), 4);
+        out.write(reinterpret_cast<const char*>(&h), 4);
+        out.write(reinterpret_cast<const char*>(d.rgba.data()), std::streamsize(d.rgba.size()));
+        if (!out.good())
+        {
+            out.close();
+            std::error_code ec;
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec)
+        fs::remove(tmp, ec);
+}
+
+// Oldest first until under DISK_BUDGET; stray .partial files always go
+void ThumbnailCache::trimDiskCache()
+{
+    struct File
+    {
+        fs::path path;
+        fs::file_time_type mtime;
+        uint64_t size;
+    };
+    std::vector<File> files;
+    uint64_t total = 0;
+
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(m_diskDir, ec); !ec && it != fs::directory_iterator(); it.increment(ec))
+    {
+        std::error_code fileEc;
+        if (it->path().extension() == ".partial")
+        {
+            fs::remove(it->path(), fileEc);
+            continue;
+        }
+        if (it->path().extension() != ".thumb")
+            continue;
+        File f{it->path(), it->last_write_time(fileEc), it->file_size(fileEc)};
+        total += f.size;
+        files.push_back(std::move(f));
+    }
+    if (total <= DISK_BUDGET)
+        return;
+
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) { return a.mtime < b.mtime; });
+    size_t removed = 0;
+    for (const auto& f : files)
+    {
+        if (total <= DISK_BUDGET)
+            break;
+        std::error_code rmEc;
+        if (fs::remove(f.path, rmEc))
+        {
+            total -= f.size;
+            ++removed;
+        }
+    }
+    MonitorLog::instance().info("thumbs", "Trimmed " + std::to_string(removed) + " cached thumbnails");
+}
+
+} // namespace SR
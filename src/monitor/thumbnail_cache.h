@@ -0,0 +1,162 @@
+#pragma once
+
+#include "core/job_types.h"
+#include "core/output_pattern.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace SR {
+
+// Rendered-frame thumbnails for the job detail panel.
+//
+// The job's output dir is listed in the background and its files matched to
+// frames by the output flag's #### pattern. Thumbnails are decoded on a small
+// worker pool, downscaled to THUMB_MAX and kept in a node-local disk cache
+// keyed by source path + size + mtime, so a frame crosses the network once
+// per node. At most SHARE_READS workers read the share at a time; the rest
+// serve disk-cache hits. Decodes are only queued for cells in view, newest
+// first, and dropped when nobody has asked for them for STALE_FRAMES drawn
+// frames (scrolled away). Finished decodes become GL textures in
+// beginFrame(), held in an LRU under TEXTURE_BUDGET.
+//
+// Main thread only (GL calls); the workers never touch GL.
+class ThumbnailCache
+{
+public:
+    enum class Status { Ready, Pending, Unavailable };
+
+    struct Thumb
+    {
+        uint32_t texture = 0;   // GL texture name
+        int width = 0;
+        int height = 0;
+    };
+
+    ThumbnailCache() = default;
+    ~ThumbnailCache();
+
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+    // Trims the disk cache to DISK_BUDGET (oldest first) and starts the workers
+    void start(const std::filesystem::path& diskDir);
+    void stop();    // with the GL context still current: frees the textures
+    bool isRunning() const { return !m_workers.empty(); }
+
+    // Once per drawn frame, before get(): uploads finished decodes, drops
+    // stale queue entries and evicts textures over budget
+    void beginFrame();
+
+    // The job get() looks frames up in. Its output dir is listed on the first
+    // call and again when `completed` moves, at most once per RESCAN_MS.
+    // Tiled stills and outputs without a frame pattern have no thumbnails.
+    void setJob(const JobManifest& manifest, int completed);
+    bool hasFrames() const { return m_frames && !m_frames->empty(); }
+
+    // Ready: out is filled. Pending: listing, queued or decoding. Unavailable:
+    // no file for the frame, too large, or not an image stb_image reads.
+    Status get(int frame, Thumb& out);
+
+    // Moves as decodes and listings land, so an idle UI redraws for them
+    uint64_t revision() const { return m_revision.load(std::memory_order_relaxed); }
+
+    static constexpr int      THUMB_MAX = 256;                       // longest side, pixels
+    static constexpr int      WORKERS = 3;
+    static constexpr int      SHARE_READS = 2;                       // concurrent reads of source frames
+    static constexpr uint64_t MAX_SOURCE_BYTES = 256ull * 1024 * 1024;
+    static constexpr size_t   MAX_QUEUE = 256;                       // oldest requests fall off
+    static constexpr uint64_t STALE_FRAMES = 10;
+    static constexpr size_t   TEXTURE_BUDGET = 64 * 1024 * 1024;     // RGBA bytes on the GPU
+    static constexpr uint64_t DISK_BUDGET = 512ull * 1024 * 1024;
+    static constexpr int64_t  RESCAN_MS = 5000;
+
+private:
+    struct FrameFile
+    {
+        std::filesystem::path path;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        bool decodable = false;
+        std::string key;        // keyFor()
+    };
+    using FrameMap = std::unordered_map<int, FrameFile>;
+
+    using Pattern = OutputPattern;
+    static bool isDecodable(const std::filesystem::path& path);
+
+    enum class State { Queued, Ready, Failed };
+
+    struct Entry
+    {
+        State state = State::Queued;
+        Thumb thumb;
+        uint64_t askedFrame = 0;                    // last beginFrame() count it was asked for in
+        std::list<std::string>::iterator lru;       // Ready only
+    };
+
+    struct Task
+    {
+        std::string key;
+        FrameFile file;
+    };
+
+    struct Decoded
+    {
+        std::string key;
+        std::vector<uint8_t> rgba;
+        int width = 0;
+        int height = 0;
+        bool ok = false;
+    };
+
+    void stopWorkers();
+    void workerFunc();
+    FrameMap listFrames(const Pattern& pattern);
+    Decoded decode(const Task& task);
+    std::optional<Decoded> readDiskCache(const std::filesystem::path& path);
+    void writeDiskCache(const std::filesystem::path& path, const Decoded& d);
+    void trimDiskCache();
+    void releaseTexture(Entry& e);
+
+    static std::string keyFor(const FrameFile& file);
+
+    // Main thread
+    std::unordered_map<std::string, Entry> m_entries;   // by key
+    std::list<std::string> m_lru;                       // ready keys, most recent first
+    size_t m_textureBytes = 0;
+    uint64_t m_frame = 0;
+    std::string m_jobId;
+    std::optional<Pattern> m_pattern;
+    int m_completed = -1;
+    int64_t m_lastScanMs = 0;
+    bool m_scanQueued = false;
+    std::shared_ptr<const FrameMap> m_frames;
+
+    // Shared with the workers
+    std::filesystem::path m_diskDir;
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_shareCv;
+    std::deque<Task> m_queue;                       // newest at the back
+    std::optional<std::pair<std::string, Pattern>> m_scan;     // job id + pattern
+    std::vector<Decoded> m_done;
+    std::optional<std::pair<std::string, std::shared_ptr<const FrameMap>>> m_scanDone;
+    int m_shareReaders = 0;
+    bool m_running = false;
+    std::atomic<uint64_t> m_revision{0};
+};
+
+} // namespace SR
@@ -14,6 +14,7 @@ void Dashboard::init(MonitorApp* app)
     m_jobListPanel.init(app);
     m_jobDetailPanel.init(app);
     m_logPanel.init(app);
+    m_perfPanel.init(app);
     m_farmCleanupDialog.init(app);
 }
 
@@ -67,6 +68,7 @@ void Dashboard::render()
     m_jobDetailPanel.render();
     m_jobListPanel.render();
     m_logPanel.render();
+    m_perfPanel.render();
 
     // Farm Cleanup dialog (modal)
     m_farmCleanupDialog.render();
@@ -137,6 +139,8 @@ void Dashboard::renderMenuBar()
             ImGui::MenuItem("Job Detail",    nullptr, &m_jobDetailPanel.visible);
             ImGui::MenuItem("Job List",      nullptr, &m_jobListPanel.visible);
             ImGui::MenuItem("Log",           nullptr, &m_logPanel.visible);
+            ImGui::Separator();
+            ImGui::MenuItem("Performance",   nullptr, &m_perfPanel.visible);
             ImGui::EndMenu();
         }
         ImGui::EndMenuBar();
@@ -5,6 +5,7 @@
 #include "monitor/ui/job_list_panel.h"
 #include "monitor/ui/job_detail_panel.h"
 #include "monitor/ui/log_panel.h"
+#include "monitor/ui/perf_panel.h"
 #include "monitor/ui/farm_cleanup_dialog.h"
 
 namespace SR {
@@ -30,6 +31,7 @@ private:
     JobListPanel       m_jobListPanel;
     JobDetailPanel     m_jobDetailPanel;
     LogPanel           m_logPanel;
+    PerfPanel          m_perfPanel;
     FarmCleanupDialog  m_farmCleanupDialog;
 
     bool m_showSettings = false;
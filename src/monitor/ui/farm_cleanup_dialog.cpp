@@ -1,6 +1,5 @@
 #include "monitor/ui/farm_cleanup_dialog.h"
 #include "monitor/monitor_app.h"
-#include "core/monitor_log.h"
 
 #include <imgui.h>
 #include <filesystem>
@@ -16,7 +15,15 @@ void FarmCleanupDialog::init(MonitorApp* app)
 
 void FarmCleanupDialog::open()
 {
-    scanItems();
+    m_completedJobs.clear();
+    m_archivedJobs.clear();
+    m_deadNodes.clear();
+    m_orphanedDirs.clear();
+    m_scanned = false;
+
+    // The archive index and the jobs/ listing are read on ArchiveManager's thread
+    if (m_app && m_app->isFarmRunning())
+        m_scanSeq = m_app->archiveManager().requestCleanupScan();
     m_shouldOpen = true;
 }
 
@@ -49,9 +56,22 @@ void FarmCleanupDialog::render()
     float buttonRowHeight = ImGui::GetFrameHeightWithSpacing() + ImGui::GetStyle().ItemSpacing.y;
     ImGui::BeginChild("CleanupContent", ImVec2(0, -buttonRowHeight), ImGuiChildFlags_None);
 
-    bool hasAnyItems = !m_completedJobs.empty() || !m_deadNodes.empty() || !m_orphanedDirs.empty();
+    if (!m_scanned && m_app && m_app->isFarmRunning() &&
+        m_app->archiveManager().getSnapshot()->scanSeq >= m_scanSeq)
+    {
+        scanItems();
+        m_scanned = true;
+    }
 
-    if (!hasAnyItems)
+    bool hasAnyItems = !m_completedJobs.empty() || !m_archivedJobs.empty() ||
+                       !m_deadNodes.empty() || !m_orphanedDirs.empty();
+
+    if (!m_scanned)
+    {
+        ImGui::TextDisabled("Scanning farm...");
+        ImGui::Spacing();
+    }
+    else if (!hasAnyItems)
     {
         ImGui::TextDisabled("Nothing to clean up.");
         ImGui::Spacing();
@@ -70,6 +90,28 @@ void FarmCleanupDialog::render()
         ImGui::Spacing();
     }
 
+    // --- Archived Jobs ---
+    if (!m_archivedJobs.empty())
+    {
+        ImGui::SeparatorText("Archived Jobs");
+        ImGui::TextDisabled("Removes the job directory under archive/.");
+        ImGuiListClipper clipper;
+        clipper.Begin((int)m_archivedJobs.size());
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                auto& item = m_archivedJobs[i];
+                ImGui::PushID(i);
+                ImGui::Checkbox(item.label.c_str(), &item.selected);
+                ImGui::SameLine(0, 8);
+                ImGui::TextDisabled("%s", item.detail.c_str());
+                ImGui::PopID();
+            }
+        }
+        ImGui::Spacing();
+    }
+
     // --- Dead Nodes ---
     if (!m_deadNodes.empty())
     {
@@ -103,6 +145,7 @@ void FarmCleanupDialog::render()
     if (ImGui::Button("Select All"))
     {
         for (auto& i : m_completedJobs) i.selected = true;
+        for (auto& i : m_archivedJobs) i.selected = true;
         for (auto& i : m_deadNodes) i.selected = true;
         for (auto& i : m_orphanedDirs) i.selected = true;
     }
@@ -111,6 +154,7 @@ void FarmCleanupDialog::render()
     // Count selected
     int selectedCount = 0;
     for (auto& i : m_completedJobs) if (i.selected) selectedCount++;
+    for (auto& i : m_archivedJobs) if (i.selected) selectedCount++;
     for (auto& i : m_deadNodes) if (i.selected) selectedCount++;
     for (auto& i : m_orphanedDirs) if (i.selected) selectedCount++;
 
@@ -141,15 +185,13 @@ void FarmCleanupDialog::render()
 void FarmCleanupDialog::scanItems()
 {
     m_completedJobs.clear();
+    m_archivedJobs.clear();
     m_deadNodes.clear();
     m_orphanedDirs.clear();
 
     if (!m_app || !m_app->isFarmRunning())
         return;
 
-    const auto& farmPath = m_app->farmPath();
-    std::error_code ec;
-
     // --- Completed/Cancelled Jobs ---
     for (const auto& job : m_app->cachedJobs())
     {
@@ -164,11 +206,23 @@ void FarmCleanupDialog::scanItems()
         }
     }
 
+    // --- Archived Jobs (from the index; archive/ itself isn't listed) ---
+    auto archive = m_app->archiveManager().getSnapshot();
+    for (const auto& rec : archive->records)
+    {
+        CleanupItem item;
+        item.id = rec.job_id;
+        item.label = rec.job_id;
+        item.detail = rec.state + " | " + std::to_string(rec.frames) + " frames";
+        m_archivedJobs.push_back(std::move(item));
+    }
+
     // --- Dead Nodes ---
-    auto nodes = m_app->heartbeatManager().getNodeSnapshot();
+    auto nodeSnapshot = m_app->heartbeatManager().getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
     for (const auto& n : nodes)
     {
-        if (n.isDead && !n.isLocal)
+        if (n.isDead && !n.isLocal && !n.isParked())
         {
             CleanupItem item;
             item.id = n.heartbeat.node_id;
@@ -179,23 +233,13 @@ void FarmCleanupDialog::scanItems()
     }
 
     // --- Orphaned Job Directories ---
-    auto jobsDir = farmPath / "jobs";
-    if (fs::is_directory(jobsDir, ec))
+    for (const auto& dir : archive->orphanedDirs)
     {
-        for (auto& entry : fs::directory_iterator(jobsDir, ec))
-        {
-            if (!entry.is_directory(ec)) continue;
-
-            auto manifestPath = entry.path() / "manifest.json";
-            if (!fs::exists(manifestPath, ec))
-            {
-                CleanupItem item;
-                item.id = entry.path().string();
-                item.label = "jobs/" + entry.path().filename().string();
-                item.detail = "no manifest.json";
-                m_orphanedDirs.push_back(std::move(item));
-            }
-        }
+        CleanupItem item;
+        item.id = dir;
+        item.label = "jobs/" + fs::path(dir).filename().string();
+        item.detail = "no manifest.json";
+        m_orphanedDirs.push_back(std::move(item));
     }
 }
 
@@ -204,54 +248,18 @@ void FarmCleanupDialog::cleanSelected()
     if (!m_app || !m_app->isFarmRunning())
         return;
 
-    const auto& farmPath = m_app->farmPath();
-    std::error_code ec;
-    int cleaned = 0;
-
-    // --- Clean completed/cancelled jobs ---
+    // Deletes run on ArchiveManager's thread
+    ArchiveManager::CleanRequest req;
     for (const auto& item : m_completedJobs)
-    {
-        if (!item.selected) continue;
-        auto jobDir = farmPath / "jobs" / item.id;
-        fs::remove_all(jobDir, ec);
-        if (!ec)
-        {
-            MonitorLog::instance().info("farm", "Cleaned job: " + item.id);
-            cleaned++;
-        }
-        else
-        {
-            MonitorLog::instance().error("farm", "Failed to clean job " + item.id + ": " + ec.message());
-        }
-    }
-
-    // --- Clean dead nodes ---
+        if (item.selected) req.jobs.push_back(item.id);
+    for (const auto& item : m_archivedJobs)
+        if (item.selected) req.archivedJobs.push_back(item.id);
     for (const auto& item : m_deadNodes)
-    {
-        if (!item.selected) continue;
-        fs::remove_all(farmPath / "nodes" / item.id, ec);
-        fs::remove_all(farmPath / "commands" / item.id, ec);
-        MonitorLog::instance().info("farm", "Cleaned dead node: " + item.id);
-        cleaned++;
-    }
-
-    // --- Clean orphaned dirs ---
+        if (item.selected) req.deadNodes.push_back(item.id);
     for (const auto& item : m_orphanedDirs)
-    {
-        if (!item.selected) continue;
-        fs::remove_all(fs::path(item.id), ec);
-        if (!ec)
-        {
-            MonitorLog::instance().info("farm", "Cleaned orphaned dir: " + item.label);
-            cleaned++;
-        }
-    }
+        if (item.selected) req.dirs.push_back(fs::path(item.id));
 
-    if (cleaned > 0)
-    {
-        m_app->jobManager().invalidate();
-        MonitorLog::instance().info("farm", "Farm cleanup: " + std::to_string(cleaned) + " items removed");
-    }
+    m_app->archiveManager().clean(std::move(req));
 }
 
 } // namespace SR
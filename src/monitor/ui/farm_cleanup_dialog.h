@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -15,11 +16,13 @@ public:
     void open();        // Trigger scan + open popup
 
 private:
-    void scanItems();
+    void scanItems();   // once the background scan has landed
     void cleanSelected();
 
     MonitorApp* m_app = nullptr;
     bool m_shouldOpen = false;
+    uint64_t m_scanSeq = 0;     // ArchiveManager cleanup scan this dialog waits for
+    bool m_scanned = false;
 
     struct CleanupItem
     {
@@ -30,6 +33,7 @@ private:
     };
 
     std::vector<CleanupItem> m_completedJobs;
+    std::vector<CleanupItem> m_archivedJobs;
     std::vector<CleanupItem> m_deadNodes;
     std::vector<CleanupItem> m_orphanedDirs;
 };
@@ -2,6 +2,7 @@
 #include "monitor/monitor_app.h"
 #include "monitor/template_manager.h"
 #include "monitor/ui_data_cache.h"
+#include "monitor/thumbnail_cache.h"
 #include "core/platform.h"
 #include "core/job_types.h"
 
@@ -10,6 +11,7 @@
 #include <imgui.h>
 #include <nfd.h>
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <ctime>
 #include <filesystem>
@@ -39,10 +41,12 @@ void JobDetailPanel::render()
         m_frameStart = 1; m_frameEnd = 250; m_chunkSize = 1;
         m_priority = 50; m_maxRetries = 3; m_timeout = 0;
         m_hasTimeout = false;
+        m_adaptiveChunks = false; m_targetChunkSec = 180;
+        m_tileSplit = false; m_tileCols = 4; m_tileRows = 4;
         m_errors.clear();
         m_detailJobId.clear();
         m_hasCachedDetailJob = false;
-        m_cachedFrameState = {};
+        m_cachedFrameState.reset();
 
         // Pre-fill from CLI submit request if present
         if (m_app->hasPendingSubmitRequest())
@@ -111,7 +115,7 @@ void JobDetailPanel::render()
     {
         m_mode = Mode::Detail;
         m_detailJobId = m_app->selectedJobId();
-        m_cachedFrameState = {};  // clear stale data from previous job
+        m_cachedFrameState.reset();  // clear stale data from previous job
     }
 
     if (ImGui::Begin("Job Detail", nullptr, ImGuiWindowFlags_NoTitleBar))
@@ -434,6 +438,7 @@ void JobDetailPanel::renderSubmission()
     ImGui::TextUnformatted("Frame End");
     if (Fonts::bold) ImGui::PopFont();
 
+    ImGui::BeginDisabled(m_tileSplit);
     ImGui::SetNextItemWidth(-FLT_MIN);
     ImGui::InputInt("##fend", &m_frameEnd);
 
@@ -448,9 +453,32 @@ void JobDetailPanel::renderSubmission()
     ImGui::InputInt("##chunk", &m_chunkSize);
     if (m_chunkSize < 1) m_chunkSize = 1;
     ImGui::TextDisabled("Frames per task sent to a node");
+    ImGui::EndDisabled();
 
     ImGui::Separator();
 
+    // --- Tile split (stills) ---
+    if (tmpl.tiles.supported())
+    {
+        if (Fonts::bold) ImGui::PushFont(Fonts::bold);
+        ImGui::TextUnformatted("Tile Split");
+        if (Fonts::bold) ImGui::PopFont();
+
+        ImGui::Checkbox("Split still into tiles##tile_check", &m_tileSplit);
+        if (m_tileSplit)
+        {
+            ImGui::SetNextItemWidth(100);
+            ImGui::InputInt("Columns##tile_cols", &m_tileCols);
+            ImGui::SetNextItemWidth(100);
+            ImGui::InputInt("Rows##tile_rows", &m_tileRows);
+            m_tileCols = std::clamp(m_tileCols, 1, TemplateManager::MAX_TILE_AXIS);
+            m_tileRows = std::clamp(m_tileRows, 1, TemplateManager::MAX_TILE_AXIS);
+            ImGui::TextDisabled("Frame Start only, one tile per node, merged when all are done");
+        }
+
+        ImGui::Separator();
+    }
+
     // --- Priority ---
     if (Fonts::bold) ImGui::PushFont(Fonts::bold);
     ImGui::TextUnformatted("Priority");
@@ -489,6 +517,22 @@ void JobDetailPanel::renderSubmission()
 
     ImGui::Separator();
 
+    // --- Adaptive chunking ---
+    if (Fonts::bold) ImGui::PushFont(Fonts::bold);
+    ImGui::TextUnformatted("Adaptive Chunks");
+    if (Fonts::bold) ImGui::PopFont();
+
+    ImGui::Checkbox("Enable##adaptive_check", &m_adaptiveChunks);
+    if (m_adaptiveChunks)
+    {
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        ImGui::InputInt("##target_chunk_sec", &m_targetChunkSec, 30);
+        if (m_targetChunkSec < 10) m_targetChunkSec = 10;
+        ImGui::TextDisabled("Target seconds per chunk; chunk size is the starting guess");
+    }
+
+    ImGui::Separator();
+
     // --- Preview ---
     if (Fonts::bold) ImGui::PushFont(Fonts::bold);
     ImGui::TextUnformatted("Command Preview");
@@ -530,15 +574,18 @@ void JobDetailPanel::renderSubmission()
 
 void JobDetailPanel::renderDetail()
 {
-    // Find job by id — update cached copy when found, use stale copy on transient gaps
-    const auto& jobs = m_app->cachedJobs();
-    for (const auto& j : jobs)
+    // Find job by id — update cached copy when the snapshot changed, use stale copy on transient gaps
+    const auto& snapshot = m_app->jobSnapshot();
+    bool stale = !m_hasCachedDetailJob ||
+                 m_cachedDetailJob.manifest.job_id != m_detailJobId ||
+                 m_cachedDetailVersion != snapshot.version;
+    if (stale)
     {
-        if (j.manifest.job_id == m_detailJobId)
+        if (const auto* j = snapshot.find(m_detailJobId))
         {
-            m_cachedDetailJob = j;
+            m_cachedDetailJob = *j;
             m_hasCachedDetailJob = true;
-            break;
+            m_cachedDetailVersion = snapshot.version;
         }
     }
 
@@ -557,7 +604,7 @@ void JobDetailPanel::renderDetail()
     // Refresh cached frame state snapshot (keep last-known-good to avoid flicker)
     {
         auto snap = m_app->uiDataCache().getFrameStateSnapshot();
-        if (snap.jobId == m_detailJobId && !snap.frameStates.empty())
+        if (snap->jobId == m_detailJobId && !snap->empty())
             m_cachedFrameState = std::move(snap);
     }
 
@@ -603,6 +650,28 @@ void JobDetailPanel::renderDetail()
         ImGui::Text("Submitted at: %s", timeBuf);
     }
 
+    if (!manifest.depends_on.empty())
+    {
+        std::string deps;
+        for (const auto& dep : manifest.depends_on)
+        {
+            if (!deps.empty()) deps += ", ";
+            deps += dep.job_id + (dep.frames ? " (per frame)" : "");
+        }
+        ImGui::TextWrapped("Depends on: %s", deps.c_str());
+
+        // An upstream that ended without completing fails this job (see JobDependency)
+        for (const auto& dep : manifest.depends_on)
+        {
+            const auto* up = snapshot.find(dep.job_id);
+            if (up && (up->current_state == "cancelled" || up->current_state == "failed"))
+            {
+                ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Blocked on %s (%s)",
+                                   dep.job_id.c_str(), up->current_state.c_str());
+            }
+        }
+    }
+
     // --- Controls ---
     ImGui::Spacing();
     ImGui::SeparatorText("Controls");
@@ -648,6 +717,15 @@ void JobDetailPanel::renderDetail()
             openFolderInExplorer(std::filesystem::path(manifest.output_dir.value()));
     }
 
+    if (m_app->config().chunk_tracing)
+    {
+        ImGui::SameLine();
+        if (ImGui::Button("Export Trace"))
+            m_app->exportJobTrace(m_detailJobId);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Chrome trace of each chunk's path through the farm (Perfetto, chrome://tracing)");
+    }
+
     // --- Job Progress ---
     ImGui::Spacing();
     ImGui::SeparatorText("Progress");
@@ -656,7 +734,16 @@ void JobDetailPanel::renderDetail()
     // --- Frame Grid ---
     ImGui::Spacing();
     ImGui::SeparatorText("Frames");
-    renderFrameGrid(manifest);
+    auto& thumbs = m_app->thumbnailCache();
+    thumbs.beginFrame();
+    if (m_cachedFrameState && m_cachedFrameState->jobId == m_detailJobId)
+        thumbs.setJob(manifest, m_cachedFrameState->count(UIDataCache::FrameState::Completed));
+    if (thumbs.hasFrames())
+        ImGui::Checkbox("Thumbnails", &m_showThumbnails);
+    if (m_showThumbnails && thumbs.hasFrames())
+        renderThumbnailGrid(manifest);
+    else
+        renderFrameGrid(manifest);
 
     // --- Chunk Table ---
     ImGui::Spacing();
@@ -697,8 +784,18 @@ void JobDetailPanel::renderDetail()
 
     if (ImGui::CollapsingHeader("Job Settings"))
     {
-        ImGui::Text("Frame range: %d - %d", manifest.frame_start, manifest.frame_end);
-        ImGui::Text("Chunk size: %d", manifest.chunk_size);
+        if (manifest.tiles.enabled())
+            ImGui::Text("Frame %d in %d x %d tiles, then merged", manifest.tiles.frame,
+                        manifest.tiles.cols, manifest.tiles.rows);
+        else
+            ImGui::Text("Frame range: %d - %d", manifest.frame_start, manifest.frame_end);
+        if (manifest.tiles.enabled())
+            ImGui::Text("Chunk size: one tile");
+        else if (manifest.target_chunk_seconds.has_value())
+            ImGui::Text("Chunk size: adaptive (target %ds, start %d)",
+                        manifest.target_chunk_seconds.value(), manifest.chunk_size);
+        else
+            ImGui::Text("Chunk size: %d", manifest.chunk_size);
         ImGui::Text("Max retries: %d", manifest.max_retries);
         if (manifest.timeout_seconds.has_value())
             ImGui::Text("Timeout: %d seconds", manifest.timeout_seconds.value());
@@ -780,23 +877,20 @@ void JobDetailPanel::renderDetail()
 
 // ─── Job progress (from UIDataCache) ─────────────────────────────────────────
 
-void JobDetailPanel::renderJobProgress(const JobManifest& /*manifest*/)
+void JobDetailPanel::renderJobProgress(const JobManifest& manifest)
 {
-    const auto& fs = m_cachedFrameState;
-    if (fs.jobId != m_detailJobId || fs.frameStates.empty())
+    if (!m_cachedFrameState || m_cachedFrameState->jobId != m_detailJobId || m_cachedFrameState->empty())
     {
         ImGui::TextDisabled("No frame data");
         return;
     }
+    const auto& fs = *m_cachedFrameState;
 
-    int total = (int)fs.frameStates.size();
-    int completed = 0, rendering = 0, failed = 0;
-    for (const auto& [frame, state] : fs.frameStates)
-    {
-        if (state == "completed") ++completed;
-        else if (state == "rendering") ++rendering;
-        else if (state == "failed") ++failed;
-    }
+    using FrameState = UIDataCache::FrameState;
+    int total = fs.frameCount();
+    int completed = fs.count(FrameState::Completed);
+    int rendering = fs.count(FrameState::Rendering);
+    int failed = fs.count(FrameState::Failed);
 
     std::string summary = std::to_string(completed) + "/" + std::to_string(total) + " frames completed";
     if (rendering > 0)
@@ -807,76 +901,255 @@ void JobDetailPanel::renderJobProgress(const JobManifest& /*manifest*/)
 
     float fraction = total > 0 ? (float)completed / (float)total : 0.0f;
     ImGui::ProgressBar(fraction, ImVec2(-1, 0));
+
+    // Estimates from the farm's chunk metrics (this job's own once it has some)
+    auto estimates = m_app->uiDataCache().renderEstimates();
+    double perFrame = estimates->msPerFrame(manifest.job_id, manifest.template_id);
+    if (perFrame <= 0.0)
+        return;
+
+    int running = 0;
+    for (const auto& dc : fs.chunks)
+        if (dc.state == DispatchState::Assigned) ++running;
+
+    std::string line = formatDuration((int64_t)perFrame) + "/frame";
+    if (completed < total)
+    {
+        int64_t eta = estimates->remainingMs(manifest.job_id, manifest.template_id,
+                                             total - completed, running);
+        line = "ETA " + formatDuration(eta) + "  |  " + line;
+    }
+    auto jit = estimates->jobs.find(manifest.job_id);
+    if (jit != estimates->jobs.end() && jit->second.peakMb > 0)
+        line += "  |  peak " + std::to_string(jit->second.peakMb) + " MB";
+    ImGui::TextDisabled("%s", line.c_str());
 }
 
 // ─── Frame grid (from UIDataCache) ───────────────────────────────────────────
 
 void JobDetailPanel::renderFrameGrid(const JobManifest& manifest)
 {
-    const auto& fsSnap = m_cachedFrameState;
-    if (fsSnap.jobId != m_detailJobId || fsSnap.frameStates.empty())
+    if (!m_cachedFrameState || m_cachedFrameState->jobId != m_detailJobId || m_cachedFrameState->empty())
         return;
+    const auto& fsSnap = *m_cachedFrameState;
 
-    // Build indexed array from frame→state pairs
+    using FrameState = UIDataCache::FrameState;
     int totalFrames = manifest.frame_end - manifest.frame_start + 1;
-    struct FrameInfo { std::string state = "unclaimed"; };
-    std::vector<FrameInfo> frameInfos(totalFrames);
-    for (const auto& [frame, state] : fsSnap.frameStates)
-    {
-        int idx = frame - manifest.frame_start;
-        if (idx >= 0 && idx < totalFrames)
-            frameInfos[idx].state = state;
-    }
+    if (totalFrames <= 0)
+        return;
 
     float cellSize = 14.0f;
     float gap = 2.0f;
     float availWidth = ImGui::GetContentRegionAvail().x;
     int cols = (std::max)(1, (int)(availWidth / (cellSize + gap)));
 
+    // Level of detail: past MAX_GRID_ROWS rows each cell stands for a frame range
+    int framesPerCell = (std::max)(1, (totalFrames + cols * MAX_GRID_ROWS - 1) / (cols * MAX_GRID_ROWS));
+    int totalCells = (totalFrames + framesPerCell - 1) / framesPerCell;
+    int totalRows = (totalCells + cols - 1) / cols;
+    float step = cellSize + gap;
+
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImVec2 gridSize(cols * step, totalRows * step);
+
+    // One hit target for the whole grid; the cell under the mouse is worked out from it
+    ImGui::InvisibleButton("##framegrid", ImVec2((std::max)(gridSize.x, 1.0f), (std::max)(gridSize.y, 1.0f)));
+    int hoveredCell = -1;
+    if (ImGui::IsItemHovered())
+    {
+        ImVec2 mouse = ImGui::GetIO().MousePos;
+        int col = (int)((mouse.x - origin.x) / step);
+        int row = (int)((mouse.y - origin.y) / step);
+        int cell = row * cols + col;
+        if (col >= 0 && col < cols && row >= 0 && cell < totalCells)
+            hoveredCell = cell;
+    }
 
-    for (int i = 0; i < totalFrames; ++i)
+    // Only the rows inside the clip rect are walked
+    ImVec2 clipMin = drawList->GetClipRectMin();
+    ImVec2 clipMax = drawList->GetClipRectMax();
+    int firstRow = (std::max)(0, (int)((clipMin.y - origin.y) / step));
+    int lastRow = (std::min)(totalRows - 1, (int)((clipMax.y - origin.y) / step));
+
+    // Runs are ascending, so one cursor serves every cell in order
+    const auto& runs = fsSnap.runs;
+    size_t runIdx = 0;
+    std::array<int, UIDataCache::FRAME_STATE_COUNT> hoveredCounts{};
+    for (int cell = firstRow * cols; cell <= (lastRow + 1) * cols - 1 && cell < totalCells; ++cell)
     {
-        int col = i % cols;
-        int row = i / cols;
-        float x = origin.x + col * (cellSize + gap);
-        float y = origin.y + row * (cellSize + gap);
+        int first = manifest.frame_start + cell * framesPerCell;
+        int last = (std::min)(first + framesPerCell - 1, manifest.frame_end);
+
+        // Frames no chunk covers count as unclaimed
+        std::array<int, UIDataCache::FRAME_STATE_COUNT> counts{};
+        int covered = 0;
+        while (runIdx < runs.size() && runs[runIdx].end < first)
+            ++runIdx;
+        for (size_t r = runIdx; r < runs.size() && runs[r].start <= last; ++r)
+        {
+            int n = (std::min)(runs[r].end, last) - (std::max)(runs[r].start, first) + 1;
+            counts[size_t(runs[r].state)] += n;
+            covered += n;
+        }
+        counts[size_t(FrameState::Unclaimed)] += (last - first + 1) - covered;
+        if (cell == hoveredCell)
+            hoveredCounts = counts;
 
+        // A cell goes green only once every frame in it is done
         ImU32 color;
-        const auto& st = frameInfos[i].state;
-        if (st == "rendering")       color = IM_COL32(77, 128, 230, 255);
-        else if (st == "completed")  color = IM_COL32(77, 204, 77, 255);
-        else if (st == "failed")     color = IM_COL32(230, 77, 77, 255);
-        else                         color = IM_COL32(64, 64, 64, 255);
+        if (counts[size_t(FrameState::Failed)] > 0)          color = IM_COL32(230, 77, 77, 255);
+        else if (counts[size_t(FrameState::Rendering)] > 0)  color = IM_COL32(77, 128, 230, 255);
+        else if (counts[size_t(FrameState::Unclaimed)] > 0)  color = IM_COL32(64, 64, 64, 255);
+        else                                                  color = IM_COL32(77, 204, 77, 255);
 
+        float x = origin.x + (cell % cols) * step;
+        float y = origin.y + (cell / cols) * step;
         drawList->AddRectFilled(ImVec2(x, y), ImVec2(x + cellSize, y + cellSize), color);
     }
 
+    if (hoveredCell >= 0)
+    {
+        int first = manifest.frame_start + hoveredCell * framesPerCell;
+        int last = (std::min)(first + framesPerCell - 1, manifest.frame_end);
+        if (first == last)
+        {
+            auto state = FrameState::Unclaimed;
+            for (size_t i = 0; i < hoveredCounts.size(); ++i)
+                if (hoveredCounts[i] > 0) state = FrameState(i);
+            ImGui::BeginTooltip();
+            ImGui::Text("Frame %d: %s", first, UIDataCache::frameStateName(state));
+            if (state == FrameState::Completed)
+                renderThumbnailTooltip(first);
+            ImGui::EndTooltip();
+        }
+        else
+        {
+            std::string tip = "Frames " + std::to_string(first) + "-" + std::to_string(last) + ":";
+            for (size_t i = 0; i < hoveredCounts.size(); ++i)
+            {
+                if (hoveredCounts[i] > 0)
+                    tip += "\n  " + std::to_string(hoveredCounts[i]) + " " + UIDataCache::frameStateName(FrameState(i));
+            }
+            ImGui::SetTooltip("%s", tip.c_str());
+        }
+    }
+
+    ImGui::SetCursorScreenPos(ImVec2(origin.x, origin.y + totalRows * step + 4.0f));
+}
+
+// ─── Thumbnails (from ThumbnailCache) ────────────────────────────────────────
+
+namespace {
+
+ImTextureID thumbTexture(const ThumbnailCache::Thumb& thumb)
+{
+    return (ImTextureID)(intptr_t)thumb.texture;
+}
+
+// Largest size with the thumbnail's aspect that fits in box
+ImVec2 fitThumb(const ThumbnailCache::Thumb& thumb, ImVec2 box)
+{
+    float scale = (std::min)(box.x / thumb.width, box.y / thumb.height);
+    return ImVec2(thumb.width * scale, thumb.height * scale);
+}
+
+} // namespace
+
+void JobDetailPanel::renderThumbnailTooltip(int frame)
+{
+    ThumbnailCache::Thumb thumb;
+    auto status = m_app->thumbnailCache().get(frame, thumb);
+    if (status == ThumbnailCache::Status::Ready)
+        ImGui::Image(thumbTexture(thumb), ImVec2((float)thumb.width, (float)thumb.height));
+    else if (status == ThumbnailCache::Status::Pending)
+        ImGui::TextDisabled("Loading preview...");
+}
+
+void JobDetailPanel::renderThumbnailGrid(const JobManifest& manifest)
+{
+    if (!m_cachedFrameState || m_cachedFrameState->jobId != m_detailJobId || m_cachedFrameState->empty())
+        return;
+    const auto& runs = m_cachedFrameState->runs;
+    auto& thumbs = m_app->thumbnailCache();
+
+    using FrameState = UIDataCache::FrameState;
+    int totalFrames = manifest.frame_end - manifest.frame_start + 1;
+    if (totalFrames <= 0)
+        return;
+
+    float cellW = THUMB_CELL_WIDTH;
+    float cellH = cellW * 9.0f / 16.0f;
+    float gap = 4.0f;
+    float stepX = cellW + gap, stepY = cellH + gap;
+    int cols = (std::max)(1, (int)((ImGui::GetContentRegionAvail().x + gap) / stepX));
     int totalRows = (totalFrames + cols - 1) / cols;
 
-    ImGui::PushID("##framegrid");
-    for (int i = 0; i < totalFrames; ++i)
+    ImGui::BeginChild("##thumbgrid", ImVec2(0, (std::min)(totalRows * stepY, THUMB_GRID_HEIGHT)));
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+
+    ImGui::InvisibleButton("##thumbcells", ImVec2(cols * stepX, totalRows * stepY));
+    int hoveredFrame = -1;
+    if (ImGui::IsItemHovered())
     {
-        int col = i % cols;
-        int row = i / cols;
-        float x = origin.x + col * (cellSize + gap);
-        float y = origin.y + row * (cellSize + gap);
+        ImVec2 mouse = ImGui::GetIO().MousePos;
+        int col = (int)((mouse.x - origin.x) / stepX);
+        int row = (int)((mouse.y - origin.y) / stepY);
+        int cell = row * cols + col;
+        if (col >= 0 && col < cols && row >= 0 && cell < totalFrames)
+            hoveredFrame = manifest.frame_start + cell;
+    }
 
-        ImGui::SetCursorScreenPos(ImVec2(x, y));
-        ImGui::PushID(i);
-        ImGui::InvisibleButton("##cell", ImVec2(cellSize, cellSize));
+    // Only the rows in view are drawn, so only their frames get decoded
+    ImVec2 clipMin = drawList->GetClipRectMin();
+    ImVec2 clipMax = drawList->GetClipRectMax();
+    int firstRow = (std::max)(0, (int)((clipMin.y - origin.y) / stepY));
+    int lastRow = (std::min)(totalRows - 1, (int)((clipMax.y - origin.y) / stepY));
 
-        int frameNum = manifest.frame_start + i;
+    size_t runIdx = 0;
+    auto hoveredState = FrameState::Unclaimed;
+    char label[16];
+    for (int cell = firstRow * cols; cell <= (lastRow + 1) * cols - 1 && cell < totalFrames; ++cell)
+    {
+        int frame = manifest.frame_start + cell;
+        while (runIdx < runs.size() && runs[runIdx].end < frame)
+            ++runIdx;
+        auto state = (runIdx < runs.size() && runs[runIdx].start <= frame) ? runs[runIdx].state : FrameState::Unclaimed;
+        if (frame == hoveredFrame)
+            hoveredState = state;
+
+        ImVec2 p0(origin.x + (cell % cols) * stepX, origin.y + (cell / cols) * stepY);
+        ImVec2 p1(p0.x + cellW, p0.y + cellH);
+        drawList->AddRectFilled(p0, p1, IM_COL32(40, 40, 40, 255));
+
+        ThumbnailCache::Thumb thumb;
+        if (state == FrameState::Completed && thumbs.get(frame, thumb) == ThumbnailCache::Status::Ready)
+        {
+            ImVec2 size = fitThumb(thumb, ImVec2(cellW, cellH));
+            ImVec2 i0(p0.x + (cellW - size.x) * 0.5f, p0.y + (cellH - size.y) * 0.5f);
+            drawList->AddImage(thumbTexture(thumb), i0, ImVec2(i0.x + size.x, i0.y + size.y));
+        }
 
-        if (ImGui::IsItemHovered())
-            ImGui::SetTooltip("Frame %d: %s", frameNum, frameInfos[i].state.c_str());
+        if (state == FrameState::Failed)
+            drawList->AddRect(p0, p1, IM_COL32(230, 77, 77, 255), 0.0f, 0, 2.0f);
+        else if (state == FrameState::Rendering)
+            drawList->AddRect(p0, p1, IM_COL32(77, 128, 230, 255), 0.0f, 0, 2.0f);
 
-        ImGui::PopID();
+        snprintf(label, sizeof(label), "%d", frame);
+        drawList->AddText(ImVec2(p0.x + 3.0f, p0.y + 2.0f), IM_COL32(220, 220, 220, 200), label);
     }
-    ImGui::PopID();
 
-    ImGui::SetCursorScreenPos(ImVec2(origin.x, origin.y + totalRows * (cellSize + gap) + 4.0f));
+    if (hoveredFrame >= 0)
+    {
+        ImGui::BeginTooltip();
+        ImGui::Text("Frame %d: %s", hoveredFrame, UIDataCache::frameStateName(hoveredState));
+        if (hoveredState == FrameState::Completed)
+            renderThumbnailTooltip(hoveredFrame);
+        ImGui::EndTooltip();
+    }
+
+    ImGui::EndChild();
 }
 
 // ─── Chunk table (from UIDataCache) ──────────────────────────────────────────
@@ -884,29 +1157,70 @@ void JobDetailPanel::renderFrameGrid(const JobManifest& manifest)
 std::string JobDetailPanel::hostnameForNodeId(const std::string& nodeId) const
 {
     if (nodeId.empty()) return "";
-    auto nodes = m_app->heartbeatManager().getNodeSnapshot();
-    for (const auto& n : nodes)
-    {
-        if (n.heartbeat.node_id == nodeId)
-            return n.heartbeat.hostname;
-    }
+    auto it = m_hostnames.find(nodeId);
+    if (it != m_hostnames.end())
+        return it->second;
     return nodeId.substr(0, 8); // fallback: truncated node ID
 }
 
-void JobDetailPanel::renderChunkTable(const JobManifest& /*manifest*/)
+void JobDetailPanel::rebuildChunkRows(const JobManifest& manifest)
 {
-    const auto& fsSnap = m_cachedFrameState;
-    const auto& dispatchChunks = fsSnap.chunks;
+    const auto& dispatchChunks = m_cachedFrameState->chunks;
+    m_chunkRows.assign(dispatchChunks.size(), {});
 
-    if (fsSnap.jobId != m_detailJobId || dispatchChunks.empty())
+    char rangeBuf[32];
+    for (size_t i = 0; i < dispatchChunks.size(); ++i)
+    {
+        const auto& dc = dispatchChunks[i];
+        auto& row = m_chunkRows[i];
+
+        if (manifest.tiles.isMerge(dc.frame_start))
+            snprintf(rangeBuf, sizeof(rangeBuf), "merge");
+        else if (manifest.tiles.enabled())
+            snprintf(rangeBuf, sizeof(rangeBuf), "tile %d", dc.frame_start - 1);
+        else if (dc.frame_start == dc.frame_end)
+            snprintf(rangeBuf, sizeof(rangeBuf), "%d", dc.frame_start);
+        else
+            snprintf(rangeBuf, sizeof(rangeBuf), "%d-%d", dc.frame_start, dc.frame_end);
+        row.range = rangeBuf;
+
+        if (dc.state == DispatchState::Assigned)
+            row.state = "Rendering";
+        else if (dc.state == DispatchState::Completed)
+            row.state = "Completed";
+        else if (dc.state == DispatchState::Failed)
+            row.state = "Failed (" + std::to_string(dc.retry_count) + ")";
+        else
+            row.state = "Pending";
+    }
+    m_chunkRowsFor = m_cachedFrameState;
+}
+
+void JobDetailPanel::renderChunkTable(const JobManifest& manifest)
+{
+    if (!m_cachedFrameState || m_cachedFrameState->jobId != m_detailJobId || m_cachedFrameState->chunks.empty())
     {
         ImGui::TextDisabled("No dispatch data");
         return;
     }
+    const auto& dispatchChunks = m_cachedFrameState->chunks;
+    if (m_chunkRowsFor != m_cachedFrameState)
+        rebuildChunkRows(manifest);
+
+    auto nodeSnapshot = m_app->heartbeatManager().getNodeSnapshot();
+    if (m_hostnamesFor != nodeSnapshot)
+    {
+        m_hostnames.clear();
+        for (const auto& n : nodeSnapshot->nodes)
+            m_hostnames[n.heartbeat.node_id] = n.heartbeat.hostname;
+        m_hostnamesFor = std::move(nodeSnapshot);
+    }
 
     bool isCoordinator = m_app->isCoordinator();
+    auto& thumbs = m_app->thumbnailCache();
+    bool previews = m_showThumbnails && thumbs.hasFrames();
 
-    int numCols = isCoordinator ? 5 : 4;
+    int numCols = (isCoordinator ? 5 : 4) + (previews ? 1 : 0);
     if (!ImGui::BeginTable("##chunks", numCols,
             ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
             ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY,
@@ -914,6 +1228,8 @@ void JobDetailPanel::renderChunkTable(const JobManifest& /*manifest*/)
         return;
 
     ImGui::TableSetupColumn("Range", ImGuiTableColumnFlags_WidthFixed, 90.0f);
+    if (previews)
+        ImGui::TableSetupColumn("Preview", ImGuiTableColumnFlags_WidthFixed, 40.0f);
     ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_WidthFixed, 80.0f);
     ImGui::TableSetupColumn("Worker", ImGuiTableColumnFlags_WidthStretch);
     ImGui::TableSetupColumn("Elapsed", ImGuiTableColumnFlags_WidthFixed, 70.0f);
@@ -924,102 +1240,98 @@ void JobDetailPanel::renderChunkTable(const JobManifest& /*manifest*/)
     auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
 
-    for (int i = 0; i < (int)dispatchChunks.size(); ++i)
+    ImGuiListClipper clipper;
+    clipper.Begin((int)dispatchChunks.size());
+    while (clipper.Step())
     {
-        const auto& dc = dispatchChunks[i];
-        ImGui::PushID(i);
-        ImGui::TableNextRow();
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            const auto& dc = dispatchChunks[i];
+            const auto& row = m_chunkRows[i];
+            ImGui::PushID(i);
+            ImGui::TableNextRow();
 
-        // Range
-        ImGui::TableNextColumn();
-        char rangeBuf[32];
-        if (dc.frame_start == dc.frame_end)
-            snprintf(rangeBuf, sizeof(rangeBuf), "%d", dc.frame_start);
-        else
-            snprintf(rangeBuf, sizeof(rangeBuf), "%d-%d", dc.frame_start, dc.frame_end);
-        ImGui::TextUnformatted(rangeBuf);
+            // Range
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(row.range.c_str());
 
-        // State (color-coded)
-        ImGui::TableNextColumn();
-        {
-            ImVec4 stateColor(0.5f, 0.5f, 0.5f, 1.0f); // pending = gray
-            std::string stateLabel = "Pending";
-            if (dc.state == "assigned")
+            // Preview: the chunk's last frame, once it's done
+            if (previews)
             {
-                stateColor = ImVec4(0.3f, 0.5f, 0.9f, 1.0f);
-                stateLabel = "Rendering";
+                ImGui::TableNextColumn();
+                ThumbnailCache::Thumb thumb;
+                if (dc.state == DispatchState::Completed &&
+                    thumbs.get(dc.frame_end, thumb) == ThumbnailCache::Status::Ready)
+                {
+                    ImGui::Image(thumbTexture(thumb), fitThumb(thumb, ImVec2(36.0f, ImGui::GetTextLineHeight())));
+                    if (ImGui::IsItemHovered())
+                    {
+                        ImGui::BeginTooltip();
+                        ImGui::Text("Frame %d", dc.frame_end);
+                        renderThumbnailTooltip(dc.frame_end);
+                        ImGui::EndTooltip();
+                    }
+                }
             }
-            else if (dc.state == "completed")
+
+            // State (color-coded)
+            ImGui::TableNextColumn();
             {
-                stateColor = ImVec4(0.3f, 0.8f, 0.3f, 1.0f);
-                stateLabel = "Completed";
+                ImVec4 stateColor(0.5f, 0.5f, 0.5f, 1.0f); // pending = gray
+                if (dc.state == DispatchState::Assigned)
+                    stateColor = ImVec4(0.3f, 0.5f, 0.9f, 1.0f);
+                else if (dc.state == DispatchState::Completed)
+                    stateColor = ImVec4(0.3f, 0.8f, 0.3f, 1.0f);
+                else if (dc.state == DispatchState::Failed)
+                    stateColor = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
+                ImGui::TextColored(stateColor, "%s", row.state.c_str());
             }
-            else if (dc.state == "failed")
+
+            // Worker (hostname)
+            ImGui::TableNextColumn();
+            if (!dc.assigned_to.empty())
             {
-                stateColor = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
-                stateLabel = "Failed (" + std::to_string(dc.retry_count) + ")";
+                std::string hostname = hostnameForNodeId(dc.assigned_to);
+                ImGui::TextUnformatted(hostname.c_str());
             }
-            ImGui::TextColored(stateColor, "%s", stateLabel.c_str());
-        }
-
-        // Worker (hostname)
-        ImGui::TableNextColumn();
-        if (!dc.assigned_to.empty())
-        {
-            std::string hostname = hostnameForNodeId(dc.assigned_to);
-            ImGui::TextUnformatted(hostname.c_str());
-        }
-        else
-        {
-            ImGui::TextDisabled("--");
-        }
-
-        // Elapsed
-        ImGui::TableNextColumn();
-        if (dc.state == "assigned" && dc.assigned_at_ms > 0)
-        {
-            int64_t elapsedMs = nowMs - dc.assigned_at_ms;
-            int secs = (int)(elapsedMs / 1000);
-            if (secs >= 3600)
-                ImGui::Text("%dh%02dm", secs / 3600, (secs % 3600) / 60);
-            else if (secs >= 60)
-                ImGui::Text("%dm%02ds", secs / 60, secs % 60);
-            else
-                ImGui::Text("%ds", secs);
-        }
-        else if (dc.state == "completed" && dc.completed_at_ms > 0 && dc.assigned_at_ms > 0)
-        {
-            int64_t elapsedMs = dc.completed_at_ms - dc.assigned_at_ms;
-            int secs = (int)(elapsedMs / 1000);
-            if (secs >= 3600)
-                ImGui::Text("%dh%02dm", secs / 3600, (secs % 3600) / 60);
-            else if (secs >= 60)
-                ImGui::Text("%dm%02ds", secs / 60, secs % 60);
             else
-                ImGui::Text("%ds", secs);
-        }
-        else
-        {
-            ImGui::TextDisabled("--");
-        }
+            {
+                ImGui::TextDisabled("--");
+            }
 
-        // Action buttons (coordinator only)
-        if (isCoordinator)
-        {
+            // Elapsed
             ImGui::TableNextColumn();
-            if (dc.state == "assigned")
+            if (dc.state == DispatchState::Assigned && dc.assigned_at_ms > 0)
             {
-                if (ImGui::SmallButton("Reassign"))
-                    m_app->reassignChunk(m_detailJobId, dc.frame_start, dc.frame_end);
+                ImGui::TextUnformatted(formatDuration(nowMs - dc.assigned_at_ms).c_str());
             }
-            else if (dc.state == "failed")
+            else if (dc.state == DispatchState::Completed && dc.completed_at_ms > 0 && dc.assigned_at_ms > 0)
             {
-                if (ImGui::SmallButton("Retry"))
-                    m_app->retryFailedChunk(m_detailJobId, dc.frame_start, dc.frame_end);
+                ImGui::TextUnformatted(formatDuration(dc.completed_at_ms - dc.assigned_at_ms).c_str());
+            }
+            else
+            {
+                ImGui::TextDisabled("--");
             }
-        }
 
-        ImGui::PopID();
+            // Action buttons (coordinator only)
+            if (isCoordinator)
+            {
+                ImGui::TableNextColumn();
+                if (dc.state == DispatchState::Assigned)
+                {
+                    if (ImGui::SmallButton("Reassign"))
+                        m_app->reassignChunk(m_detailJobId, dc.frame_start, dc.frame_end);
+                }
+                else if (dc.state == DispatchState::Failed)
+                {
+                    if (ImGui::SmallButton("Retry"))
+                        m_app->retryFailedChunk(m_detailJobId, dc.frame_start, dc.frame_end);
+                }
+            }
+
+            ImGui::PopID();
+        }
     }
 
     ImGui::EndTable();
@@ -1099,6 +1411,14 @@ void JobDetailPanel::onTemplateSelected(int idx)
         m_hasTimeout = false;
         m_timeout = 0;
     }
+    m_adaptiveChunks = tmpl.job_defaults.target_chunk_seconds.has_value();
+    m_targetChunkSec = tmpl.job_defaults.target_chunk_seconds.value_or(180);
+    m_tileSplit = false;
+    if (tmpl.tiles.cols > 0 && tmpl.tiles.rows > 0)
+    {
+        m_tileCols = tmpl.tiles.cols;
+        m_tileRows = tmpl.tiles.rows;
+    }
 }
 
 void JobDetailPanel::resolveOutputPatterns(const JobTemplate& tmpl)
@@ -1227,9 +1547,11 @@ void JobDetailPanel::doSubmit()
     auto jobsDir = m_app->farmPath() / "jobs";
 
     // Validate
+    bool tiled = m_tileSplit && tmpl.tiles.supported() && m_tileCols * m_tileRows > 1;
+    int frameEnd = tiled ? m_frameStart : m_frameEnd;
     auto errors = TemplateManager::validateSubmission(
         tmpl, flagValues, cmdPath, jobName,
-        m_frameStart, m_frameEnd, m_chunkSize, jobsDir);
+        m_frameStart, frameEnd, m_chunkSize, jobsDir);
 
     if (!errors.empty())
     {
@@ -1251,9 +1573,12 @@ void JobDetailPanel::doSubmit()
 
     auto manifest = m_app->templateManager().bakeManifest(
         tmpl, flagValues, cmdPath, slug,
-        m_frameStart, m_frameEnd, m_chunkSize,
+        m_frameStart, frameEnd, m_chunkSize,
         m_maxRetries, timeout,
         m_app->identity().nodeId(), os);
+    manifest.target_chunk_seconds = m_adaptiveChunks ? std::optional<int>(m_targetChunkSec) : std::nullopt;
+    if (tiled)
+        TemplateManager::applyTileSplit(manifest, m_tileCols, m_tileRows);
 
     // Submit
     auto result = m_app->jobManager().submitJob(m_app->farmPath(), manifest, m_priority);
@@ -3,12 +3,15 @@
 #include "core/job_types.h"
 #include "monitor/ui_data_cache.h"
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace SR {
 
 class MonitorApp; // forward
+struct NodeSnapshot;
 
 class JobDetailPanel
 {
@@ -43,13 +46,18 @@ private:
     int m_frameStart = 1, m_frameEnd = 250, m_chunkSize = 1;
     int m_priority = 50, m_maxRetries = 3, m_timeout = 0;
     bool m_hasTimeout = false;
+    bool m_adaptiveChunks = false;
+    int m_targetChunkSec = 180;
+    bool m_tileSplit = false;       // templates with a merge only
+    int m_tileCols = 4, m_tileRows = 4;
     std::vector<std::string> m_errors;
 
     // --- Detail state ---
     std::string m_detailJobId;
     JobInfo m_cachedDetailJob;      // last-known-good for flicker prevention
     bool m_hasCachedDetailJob = false;
-    UIDataCache::FrameStateSnapshot m_cachedFrameState; // last-known-good frame data
+    uint64_t m_cachedDetailVersion = 0;  // job snapshot version m_cachedDetailJob came from
+    UIDataCache::FrameStateSnapshotPtr m_cachedFrameState;  // last-known-good frame data (null = none)
     bool m_pendingCancel = false;
     bool m_pendingRequeue = false;
     bool m_pendingDelete = false;
@@ -64,9 +72,30 @@ private:
     // Phase 8: frame grid + progress (data from UIDataCache)
     void renderJobProgress(const JobManifest& manifest);
     void renderFrameGrid(const JobManifest& manifest);
+    static constexpr int MAX_GRID_ROWS = 24;    // beyond this, cells cover several frames
+
+    // Thumbnail grid: one cell per frame in a scrolling child; only cells in
+    // view ask ThumbnailCache for their image
+    bool m_showThumbnails = false;
+    void renderThumbnailGrid(const JobManifest& manifest);
+    void renderThumbnailTooltip(int frame);     // inside an open tooltip
+    static constexpr float THUMB_CELL_WIDTH = 112.0f;
+    static constexpr float THUMB_GRID_HEIGHT = 400.0f;
+
+    // Chunk table: row text is built once per frame-state snapshot and
+    // hostnames once per node snapshot; only the rows in view are drawn
+    struct ChunkRow
+    {
+        std::string range;
+        std::string state;
+    };
+    std::vector<ChunkRow> m_chunkRows;
+    UIDataCache::FrameStateSnapshotPtr m_chunkRowsFor;
+    std::unordered_map<std::string, std::string> m_hostnames;  // node_id -> hostname
+    std::shared_ptr<const NodeSnapshot> m_hostnamesFor;
 
-    // Chunk table
     void renderChunkTable(const JobManifest& manifest);
+    void rebuildChunkRows(const JobManifest& manifest);
     std::string hostnameForNodeId(const std::string& nodeId) const;
 };
 
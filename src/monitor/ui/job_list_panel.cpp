@@ -4,6 +4,7 @@
 #include "monitor/ui_data_cache.h"
 
 #include <imgui.h>
+#include <algorithm>
 #include <ctime>
 #include <cstring>
 
@@ -19,6 +20,84 @@ static bool isDeletableState(const std::string& state)
     return state == "completed" || state == "cancelled" || state == "failed";
 }
 
+static bool isCancellableState(const std::string& state)
+{
+    return state == "active" || state == "paused";
+}
+
+static std::string formatTimestamp(int64_t ms)
+{
+    if (ms <= 0)
+        return {};
+    time_t secs = static_cast<time_t>(ms / 1000);
+    struct tm tmBuf;
+    #ifdef _WIN32
+    localtime_s(&tmBuf, &secs);
+    #else
+    localtime_r(&secs, &tmBuf);
+    #endif
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", &tmBuf);
+    return buf;
+}
+
+void JobListPanel::rebuildRows(const JobSnapshot& snapshot)
+{
+    const auto& jobs = snapshot.jobs;
+    m_rows.assign(jobs.size(), {});
+    m_rowSelected.assign(jobs.size(), 0);
+    m_totalActive = 0;
+
+    char buf[64];
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const auto& job = jobs[i];
+        auto& row = m_rows[i];
+
+        if (job.manifest.tiles.enabled())
+            snprintf(buf, sizeof(buf), "%d (%dx%d tiles)", job.manifest.tiles.frame,
+                     job.manifest.tiles.cols, job.manifest.tiles.rows);
+        else
+            snprintf(buf, sizeof(buf), "%d-%d", job.manifest.frame_start, job.manifest.frame_end);
+        row.frames = buf;
+        row.submitted = formatTimestamp(job.manifest.submitted_at_ms);
+
+        if (isCancellableState(job.current_state))
+            ++m_totalActive;
+    }
+
+    // Carry the selection over; ids of jobs that are gone drop out
+    for (auto it = m_selectedJobIds.begin(); it != m_selectedJobIds.end(); )
+    {
+        auto idx = snapshot.index.find(*it);
+        if (idx == snapshot.index.end())
+        {
+            it = m_selectedJobIds.erase(it);
+            continue;
+        }
+        m_rowSelected[idx->second] = 1;
+        ++it;
+    }
+
+    m_rowsVersion = snapshot.version;
+}
+
+void JobListPanel::setSelected(const JobSnapshot& snapshot, int row, bool on)
+{
+    const auto& jobId = snapshot.jobs[row].manifest.job_id;
+    m_rowSelected[row] = on ? 1 : 0;
+    if (on)
+        m_selectedJobIds.insert(jobId);
+    else
+        m_selectedJobIds.erase(jobId);
+}
+
+void JobListPanel::clearSelection()
+{
+    m_selectedJobIds.clear();
+    std::fill(m_rowSelected.begin(), m_rowSelected.end(), char(0));
+}
+
 void JobListPanel::render()
 {
     if (!visible) return;
@@ -34,27 +113,30 @@ void JobListPanel::render()
         }
 
         // Get progress from UIDataCache (zero FS I/O)
-        auto progressMap = m_app->uiDataCache().getProgressSnapshot();
+        auto progressSnap = m_app->uiDataCache().getProgressSnapshot();
+        const auto& progressMap = progressSnap->jobs;
+        auto estimates = m_app->uiDataCache().renderEstimates();
 
         // New Job button
         if (ImGui::Button("New Job"))
             m_app->requestSubmissionMode();
 
         // Toolbar: bulk action buttons
-        const auto& jobs = m_app->cachedJobs();
+        const auto& snapshot = m_app->jobSnapshot();
+        const auto& jobs = snapshot.jobs;
+        if (snapshot.version != m_rowsVersion || m_rows.size() != jobs.size())
+            rebuildRows(snapshot);
+
         int deletableCount = 0;
         int cancellableCount = 0;
         for (const auto& id : m_selectedJobIds)
         {
-            for (const auto& j : jobs)
-            {
-                if (j.manifest.job_id != id) continue;
-                if (isDeletableState(j.current_state))
-                    ++deletableCount;
-                else if (j.current_state == "active" || j.current_state == "paused")
-                    ++cancellableCount;
-                break;
-            }
+            const auto* j = snapshot.find(id);
+            if (!j) continue;
+            if (isDeletableState(j->current_state))
+                ++deletableCount;
+            else if (isCancellableState(j->current_state))
+                ++cancellableCount;
         }
         if (cancellableCount > 0)
         {
@@ -74,12 +156,7 @@ void JobListPanel::render()
         }
 
         // Cancel All panic button — visible whenever any job is active/paused
-        int totalActive = 0;
-        for (const auto& j : jobs)
-        {
-            if (j.current_state == "active" || j.current_state == "paused")
-                ++totalActive;
-        }
+        int totalActive = m_totalActive;
         if (totalActive > 0)
         {
             ImGui::SameLine();
@@ -90,10 +167,18 @@ void JobListPanel::render()
         ImGui::SameLine();
         ImGui::TextDisabled("(%d jobs)", (int)jobs.size());
 
+        ImGui::SameLine();
+        if (ImGui::Checkbox("Archived", &m_showArchive) && m_showArchive)
+            m_app->archiveManager().refresh();
+
         ImGui::Separator();
 
         // Job table
-        if (jobs.empty())
+        if (m_showArchive)
+        {
+            renderArchive();
+        }
+        else if (jobs.empty())
         {
             ImGui::TextDisabled("No jobs submitted yet.");
         }
@@ -106,12 +191,13 @@ void JobListPanel::render()
                 ImGuiTableFlags_BordersInnerV |
                 ImGuiTableFlags_ScrollY;
 
-            if (ImGui::BeginTable("##JobTable", 7, tableFlags))
+            if (ImGui::BeginTable("##JobTable", 8, tableFlags))
             {
                 ImGui::TableSetupColumn("Name",      ImGuiTableColumnFlags_WidthStretch, 2.0f);
                 ImGui::TableSetupColumn("Template",   ImGuiTableColumnFlags_WidthStretch, 1.5f);
                 ImGui::TableSetupColumn("State",      ImGuiTableColumnFlags_WidthFixed, 70.0f);
                 ImGui::TableSetupColumn("Progress",   ImGuiTableColumnFlags_WidthStretch, 3.0f);
+                ImGui::TableSetupColumn("ETA",        ImGuiTableColumnFlags_WidthFixed, 60.0f);
                 ImGui::TableSetupColumn("Priority",   ImGuiTableColumnFlags_WidthFixed, 55.0f);
                 ImGui::TableSetupColumn("Frames",     ImGuiTableColumnFlags_WidthFixed, 80.0f);
                 ImGui::TableSetupColumn("Submitted",  ImGuiTableColumnFlags_WidthFixed, 120.0f);
@@ -120,151 +206,161 @@ void JobListPanel::render()
 
                 const ImU32 highlightColor = ImGui::GetColorU32(ImVec4(0.3f, 0.5f, 0.8f, 0.35f));
 
-                for (int i = 0; i < (int)jobs.size(); ++i)
+                // Only the rows in view are submitted; everything they need is
+                // indexed by row, so the cost doesn't grow with the job count
+                ImGuiListClipper clipper;
+                clipper.Begin((int)jobs.size());
+                while (clipper.Step())
                 {
-                    const auto& job = jobs[i];
-                    const auto& jobId = job.manifest.job_id;
-                    bool inMultiSelect = m_selectedJobIds.count(jobId) > 0;
-
-                    ImGui::PushID(i);
-                    ImGui::TableNextRow();
-
-                    // Row highlight for multi-selected rows
-                    if (inMultiSelect)
-                        ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, highlightColor);
-
-                    // Name (selectable full row)
-                    ImGui::TableNextColumn();
-                    bool isDetailSelected = (m_app->selectedJobId() == jobId);
-                    if (ImGui::Selectable(jobId.c_str(), isDetailSelected || inMultiSelect,
-                                          ImGuiSelectableFlags_SpanAllColumns))
+                    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
                     {
-                        bool ctrl = ImGui::GetIO().KeyCtrl;
-                        bool shift = ImGui::GetIO().KeyShift;
+                        const auto& job = jobs[i];
+                        const auto& jobId = job.manifest.job_id;
+                        const auto& row = m_rows[i];
+                        bool inMultiSelect = m_rowSelected[i] != 0;
+
+                        ImGui::PushID(i);
+                        ImGui::TableNextRow();
+
+                        // Row highlight for multi-selected rows
+                        if (inMultiSelect)
+                            ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, highlightColor);
+
+                        // Name (selectable full row)
+                        ImGui::TableNextColumn();
+                        bool isDetailSelected = (m_app->selectedJobId() == jobId);
+                        if (ImGui::Selectable(jobId.c_str(), isDetailSelected || inMultiSelect,
+                                              ImGuiSelectableFlags_SpanAllColumns))
+                        {
+                            bool ctrl = ImGui::GetIO().KeyCtrl;
+                            bool shift = ImGui::GetIO().KeyShift;
 
-                        if (shift && m_lastClickedIndex >= 0 && m_lastClickedIndex < (int)jobs.size())
+                            // Anchor by id: its row moves when priorities change
+                            auto anchor = snapshot.index.find(m_lastClickedJobId);
+                            if (shift && anchor != snapshot.index.end())
+                            {
+                                // Shift+click: select range
+                                int lo = (std::min)((int)anchor->second, i);
+                                int hi = (std::max)((int)anchor->second, i);
+                                if (!ctrl) clearSelection();
+                                for (int r = lo; r <= hi; ++r)
+                                    setSelected(snapshot, r, true);
+                            }
+                            else if (ctrl)
+                            {
+                                // Ctrl+click: toggle
+                                setSelected(snapshot, i, !inMultiSelect);
+                            }
+                            else
+                            {
+                                // Plain click: single select
+                                clearSelection();
+                                setSelected(snapshot, i, true);
+                            }
+
+                            m_lastClickedJobId = jobId;
+                            m_app->selectJob(jobId);
+                        }
+
+                        // Right-click context menu (active/paused jobs only)
+                        if (isCancellableState(job.current_state))
                         {
-                            // Shift+click: select range
-                            int lo = (std::min)(m_lastClickedIndex, i);
-                            int hi = (std::max)(m_lastClickedIndex, i);
-                            if (!ctrl) m_selectedJobIds.clear();
-                            for (int r = lo; r <= hi; ++r)
-                                m_selectedJobIds.insert(jobs[r].manifest.job_id);
+                            if (ImGui::BeginPopupContextItem("##JobCtx"))
+                            {
+                                if (job.current_state == "active")
+                                {
+                                    if (ImGui::MenuItem("Pause"))
+                                        m_app->pauseJob(jobId);
+                                    if (ImGui::MenuItem("Cancel"))
+                                        m_app->cancelJob(jobId);
+                                }
+                                else
+                                {
+                                    if (ImGui::MenuItem("Resume"))
+                                        m_app->resumeJob(jobId);
+                                    if (ImGui::MenuItem("Cancel"))
+                                        m_app->cancelJob(jobId);
+                                }
+                                ImGui::EndPopup();
+                            }
                         }
-                        else if (ctrl)
+
+                        // Template
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(job.manifest.template_id.c_str());
+
+                        // State (colored)
+                        ImGui::TableNextColumn();
+                        ImVec4 stateColor(1, 1, 1, 1);
+                        if (job.current_state == "active")
+                            stateColor = ImVec4(0.3f, 0.5f, 0.9f, 1.0f);
+                        else if (job.current_state == "paused")
+                            stateColor = ImVec4(1.0f, 0.85f, 0.0f, 1.0f);
+                        else if (job.current_state == "cancelled")
+                            stateColor = ImVec4(0.6f, 0.6f, 0.6f, 1.0f);
+                        else if (job.current_state == "completed")
+                            stateColor = ImVec4(0.3f, 0.8f, 0.3f, 1.0f);
+                        else if (job.current_state == "failed")
+                            stateColor = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
+                        ImGui::TextColored(stateColor, "%s", job.current_state.c_str());
+
+                        // Progress
+                        ImGui::TableNextColumn();
+                        auto progIt = progressMap.find(jobId);
+                        if (progIt != progressMap.end() && progIt->second.total > 0)
                         {
-                            // Ctrl+click: toggle
-                            if (inMultiSelect)
-                                m_selectedJobIds.erase(jobId);
-                            else
-                                m_selectedJobIds.insert(jobId);
+                            float frac = (float)progIt->second.completed / (float)progIt->second.total;
+                            float avail = ImGui::GetContentRegionAvail().x;
+                            char label[32];
+                            snprintf(label, sizeof(label), "%d/%d", progIt->second.completed, progIt->second.total);
+                            float labelW = ImGui::CalcTextSize(label).x + ImGui::GetStyle().ItemSpacing.x;
+                            float barW = avail - labelW;
+                            if (barW < 40.0f) barW = 40.0f;
+                            float barH = ImGui::GetTextLineHeight() - 2.0f;
+                            float cellY = ImGui::GetCursorPosY();
+                            float barOffset = (ImGui::GetTextLineHeight() - barH) * 0.5f;
+                            ImGui::SetCursorPosY(cellY + barOffset);
+                            ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(ImGui::GetStyle().FramePadding.x, 0.0f));
+                            ImGui::ProgressBar(frac, ImVec2(barW, barH), "");
+                            ImGui::PopStyleVar();
+                            ImGui::SameLine();
+                            ImGui::SetCursorPosY(cellY);
+                            ImGui::TextUnformatted(label);
                         }
                         else
                         {
-                            // Plain click: single select
-                            m_selectedJobIds.clear();
-                            m_selectedJobIds.insert(jobId);
+                            ImGui::TextDisabled("--");
                         }
 
-                        m_lastClickedIndex = i;
-                        m_app->selectJob(jobId);
-                    }
-
-                    // Right-click context menu (active/paused jobs only)
-                    if (job.current_state == "active" || job.current_state == "paused")
-                    {
-                        if (ImGui::BeginPopupContextItem("##JobCtx"))
+                        // ETA (active jobs with a measured or template rate)
+                        ImGui::TableNextColumn();
+                        int64_t etaMs = -1;
+                        if (job.current_state == "active" && progIt != progressMap.end())
                         {
-                            if (job.current_state == "active")
-                            {
-                                if (ImGui::MenuItem("Pause"))
-                                    m_app->pauseJob(jobId);
-                                if (ImGui::MenuItem("Cancel"))
-                                    m_app->cancelJob(jobId);
-                            }
-                            else
-                            {
-                                if (ImGui::MenuItem("Resume"))
-                                    m_app->resumeJob(jobId);
-                                if (ImGui::MenuItem("Cancel"))
-                                    m_app->cancelJob(jobId);
-                            }
-                            ImGui::EndPopup();
+                            const auto& prog = progIt->second;
+                            etaMs = estimates->remainingMs(jobId, job.manifest.template_id,
+                                                           prog.total - prog.completed, prog.renderingChunks);
                         }
-                    }
+                        if (etaMs > 0)
+                            ImGui::TextUnformatted(formatDuration(etaMs).c_str());
+                        else
+                            ImGui::TextDisabled("--");
 
-                    // Template
-                    ImGui::TableNextColumn();
-                    ImGui::TextUnformatted(job.manifest.template_id.c_str());
-
-                    // State (colored)
-                    ImGui::TableNextColumn();
-                    ImVec4 stateColor(1, 1, 1, 1);
-                    if (job.current_state == "active")
-                        stateColor = ImVec4(0.3f, 0.5f, 0.9f, 1.0f);
-                    else if (job.current_state == "paused")
-                        stateColor = ImVec4(1.0f, 0.85f, 0.0f, 1.0f);
-                    else if (job.current_state == "cancelled")
-                        stateColor = ImVec4(0.6f, 0.6f, 0.6f, 1.0f);
-                    else if (job.current_state == "completed")
-                        stateColor = ImVec4(0.3f, 0.8f, 0.3f, 1.0f);
-                    else if (job.current_state == "failed")
-                        stateColor = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
-                    ImGui::TextColored(stateColor, "%s", job.current_state.c_str());
-
-                    // Progress
-                    ImGui::TableNextColumn();
-                    auto progIt = progressMap.find(jobId);
-                    if (progIt != progressMap.end() && progIt->second.total > 0)
-                    {
-                        float frac = (float)progIt->second.completed / (float)progIt->second.total;
-                        float avail = ImGui::GetContentRegionAvail().x;
-                        char label[32];
-                        snprintf(label, sizeof(label), "%d/%d", progIt->second.completed, progIt->second.total);
-                        float labelW = ImGui::CalcTextSize(label).x + ImGui::GetStyle().ItemSpacing.x;
-                        float barW = avail - labelW;
-                        if (barW < 40.0f) barW = 40.0f;
-                        float barH = ImGui::GetTextLineHeight() - 2.0f;
-                        float cellY = ImGui::GetCursorPosY();
-                        float barOffset = (ImGui::GetTextLineHeight() - barH) * 0.5f;
-                        ImGui::SetCursorPosY(cellY + barOffset);
-                        ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(ImGui::GetStyle().FramePadding.x, 0.0f));
-                        ImGui::ProgressBar(frac, ImVec2(barW, barH), "");
-                        ImGui::PopStyleVar();
-                        ImGui::SameLine();
-                        ImGui::SetCursorPosY(cellY);
-                        ImGui::TextUnformatted(label);
-                    }
-                    else
-                    {
-                        ImGui::TextDisabled("--");
-                    }
+                        // Priority
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%d", job.current_priority);
 
-                    // Priority
-                    ImGui::TableNextColumn();
-                    ImGui::Text("%d", job.current_priority);
+                        // Frames
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(row.frames.c_str());
 
-                    // Frames
-                    ImGui::TableNextColumn();
-                    ImGui::Text("%d-%d", job.manifest.frame_start, job.manifest.frame_end);
+                        // Submitted (formatted timestamp)
+                        ImGui::TableNextColumn();
+                        if (!row.submitted.empty())
+                            ImGui::TextUnformatted(row.submitted.c_str());
 
-                    // Submitted (formatted timestamp)
-                    ImGui::TableNextColumn();
-                    if (job.manifest.submitted_at_ms > 0)
-                    {
-                        time_t secs = static_cast<time_t>(job.manifest.submitted_at_ms / 1000);
-                        struct tm tmBuf;
-                        #ifdef _WIN32
-                        localtime_s(&tmBuf, &secs);
-                        #else
-                        localtime_r(&secs, &tmBuf);
-                        #endif
-                        char timeBuf[32];
-                        std::strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M", &tmBuf);
-                        ImGui::TextUnformatted(timeBuf);
+                        ImGui::PopID();
                     }
-
-                    ImGui::PopID();
                 }
                 ImGui::EndTable();
             }
@@ -287,15 +383,9 @@ void JobListPanel::render()
             {
                 for (const auto& id : m_selectedJobIds)
                 {
-                    for (const auto& j : jobs)
-                    {
-                        if (j.manifest.job_id == id &&
-                            (j.current_state == "active" || j.current_state == "paused"))
-                        {
-                            m_app->cancelJob(id);
-                            break;
-                        }
-                    }
+                    const auto* j = snapshot.find(id);
+                    if (j && isCancellableState(j->current_state))
+                        m_app->cancelJob(id);
                 }
                 ImGui::CloseCurrentPopup();
             }
@@ -326,7 +416,7 @@ void JobListPanel::render()
             {
                 for (const auto& j : jobs)
                 {
-                    if (j.current_state == "active" || j.current_state == "paused")
+                    if (isCancellableState(j.current_state))
                         m_app->cancelJob(j.manifest.job_id);
                 }
                 ImGui::CloseCurrentPopup();
@@ -352,17 +442,12 @@ void JobListPanel::render()
             int bulkDeletable = 0, bulkSkipped = 0;
             for (const auto& id : m_selectedJobIds)
             {
-                for (const auto& j : jobs)
-                {
-                    if (j.manifest.job_id == id)
-                    {
-                        if (isDeletableState(j.current_state))
-                            ++bulkDeletable;
-                        else
-                            ++bulkSkipped;
-                        break;
-                    }
-                }
+                const auto* j = snapshot.find(id);
+                if (!j) continue;
+                if (isDeletableState(j->current_state))
+                    ++bulkDeletable;
+                else
+                    ++bulkSkipped;
             }
 
             ImGui::Text("Delete %d job%s permanently? This cannot be undone.",
@@ -379,18 +464,19 @@ void JobListPanel::render()
                 std::vector<std::string> toRemove;
                 for (const auto& id : m_selectedJobIds)
                 {
-                    for (const auto& j : jobs)
+                    const auto* j = snapshot.find(id);
+                    if (j && isDeletableState(j->current_state))
                     {
-                        if (j.manifest.job_id == id && isDeletableState(j.current_state))
-                        {
-                            m_app->deleteJob(id);
-                            toRemove.push_back(id);
-                            break;
-                        }
+                        m_app->deleteJob(id);
+                        toRemove.push_back(id);
                     }
                 }
                 for (const auto& id : toRemove)
+                {
                     m_selectedJobIds.erase(id);
+                    if (auto it = snapshot.index.find(id); it != snapshot.index.end())
+                        m_rowSelected[it->second] = 0;
+                }
 
                 ImGui::CloseCurrentPopup();
             }
@@ -404,4 +490,110 @@ void JobListPanel::render()
     ImGui::End();
 }
 
+void JobListPanel::renderArchive()
+{
+    auto archive = m_app->archiveManager().getSnapshot();
+    if (!archive->loaded)
+    {
+        ImGui::TextDisabled("Reading archive index...");
+        return;
+    }
+    const auto& records = archive->records;
+    if (records.empty())
+    {
+        ImGui::TextDisabled("No archived jobs.");
+        if (ImGui::Button("Refresh"))
+            m_app->archiveManager().refresh();
+        return;
+    }
+
+    int pages = ((int)records.size() + ARCHIVE_PAGE_SIZE - 1) / ARCHIVE_PAGE_SIZE;
+    m_archivePage = std::clamp(m_archivePage, 0, pages - 1);
+
+    ImGui::BeginDisabled(m_archivePage == 0);
+    if (ImGui::ArrowButton("##ArchivePrev", ImGuiDir_Left))
+        --m_archivePage;
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    ImGui::Text("Page %d / %d", m_archivePage + 1, pages);
+    ImGui::SameLine();
+    ImGui::BeginDisabled(m_archivePage >= pages - 1);
+    if (ImGui::ArrowButton("##ArchiveNext", ImGuiDir_Right))
+        ++m_archivePage;
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    ImGui::TextDisabled("(%d archived)", (int)records.size());
+    ImGui::SameLine();
+    if (ImGui::Button("Refresh"))
+        m_app->archiveManager().refresh();
+
+    int first = m_archivePage * ARCHIVE_PAGE_SIZE;
+    int count = (std::min)(ARCHIVE_PAGE_SIZE, (int)records.size() - first);
+    if (archive->version != m_archiveRowsVersion || m_archivePage != m_archiveRowsPage)
+    {
+        m_archiveRows.assign(count, {});
+        char buf[64];
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& rec = records[first + i];
+            auto& row = m_archiveRows[i];
+            if (rec.failed > 0)
+                snprintf(buf, sizeof(buf), "%d/%d (%d failed)", rec.completed, rec.frames, rec.failed);
+            else
+                snprintf(buf, sizeof(buf), "%d/%d", rec.completed, rec.frames);
+            row.frames = buf;
+            row.submitted = formatTimestamp(rec.submitted_at_ms);
+            row.finished = formatTimestamp(rec.finished_at_ms);
+        }
+        m_archiveRowsVersion = archive->version;
+        m_archiveRowsPage = m_archivePage;
+    }
+
+    ImGuiTableFlags tableFlags =
+        ImGuiTableFlags_Resizable |
+        ImGuiTableFlags_RowBg |
+        ImGuiTableFlags_BordersOuter |
+        ImGuiTableFlags_BordersInnerV |
+        ImGuiTableFlags_ScrollY;
+
+    if (ImGui::BeginTable("##ArchiveTable", 7, tableFlags))
+    {
+        ImGui::TableSetupColumn("Name",      ImGuiTableColumnFlags_WidthStretch, 2.0f);
+        ImGui::TableSetupColumn("Template",   ImGuiTableColumnFlags_WidthStretch, 1.5f);
+        ImGui::TableSetupColumn("State",      ImGuiTableColumnFlags_WidthFixed, 70.0f);
+        ImGui::TableSetupColumn("Frames",     ImGuiTableColumnFlags_WidthFixed, 120.0f);
+        ImGui::TableSetupColumn("Submitted",  ImGuiTableColumnFlags_WidthFixed, 120.0f);
+        ImGui::TableSetupColumn("Finished",   ImGuiTableColumnFlags_WidthFixed, 120.0f);
+        ImGui::TableSetupColumn("Output",     ImGuiTableColumnFlags_WidthStretch, 2.0f);
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableHeadersRow();
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& rec = records[first + i];
+            const auto& row = m_archiveRows[i];
+            ImGui::TableNextRow();
+
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(rec.job_id.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(rec.template_id.c_str());
+            ImGui::TableNextColumn();
+            if (rec.state == "completed")
+                ImGui::TextColored(ImVec4(0.3f, 0.8f, 0.3f, 1.0f), "%s", rec.state.c_str());
+            else
+                ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "%s", rec.state.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(row.frames.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(row.submitted.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(row.finished.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(rec.output_dir.c_str());
+        }
+        ImGui::EndTable();
+    }
+}
+
 } // namespace SR
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <set>
+#include <vector>
 
 namespace SR {
 
 class MonitorApp; // forward
+struct JobSnapshot;
 
 class JobListPanel
 {
@@ -17,12 +20,45 @@ public:
 private:
     MonitorApp* m_app = nullptr;
 
-    // Multi-select
+    // Per-row text that only changes with the job list, rebuilt when the
+    // job snapshot version moves; drawn rows just index into it
+    struct Row
+    {
+        std::string frames;
+        std::string submitted;
+    };
+    std::vector<Row> m_rows;
+    uint64_t m_rowsVersion = 0;
+    int m_totalActive = 0;          // active + paused
+    void rebuildRows(const JobSnapshot& snapshot);
+
+    // Multi-select: the ids survive reordering, m_rowSelected mirrors them
+    // by row of the current snapshot
     std::set<std::string> m_selectedJobIds;
-    int m_lastClickedIndex = -1;
+    std::vector<char> m_rowSelected;
+    std::string m_lastClickedJobId;
+    void setSelected(const JobSnapshot& snapshot, int row, bool on);
+    void clearSelection();
+
     bool m_pendingBulkDelete = false;
     bool m_pendingBulkCancel = false;
     bool m_pendingCancelAll = false;
+
+    // Archived jobs, paged from ArchiveManager's copy of the archive index.
+    // Row text is built for the page in view only.
+    void renderArchive();
+    bool m_showArchive = false;
+    int m_archivePage = 0;
+    struct ArchiveRow
+    {
+        std::string frames;
+        std::string submitted;
+        std::string finished;
+    };
+    std::vector<ArchiveRow> m_archiveRows;
+    uint64_t m_archiveRowsVersion = 0;
+    int m_archiveRowsPage = -1;
+    static constexpr int ARCHIVE_PAGE_SIZE = 100;
 };
 
 } // namespace SR
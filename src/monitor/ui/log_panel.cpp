@@ -33,7 +33,8 @@ void LogPanel::render()
         // Update peer list from heartbeat manager
         if (m_app->isFarmRunning())
         {
-            auto nodes = m_app->heartbeatManager().getNodeSnapshot();
+            auto nodeSnapshot = m_app->heartbeatManager().getNodeSnapshot();
+            const auto& nodes = nodeSnapshot->nodes;
             m_peerNodeIds.clear();
             m_peerHostnames.clear();
             for (const auto& n : nodes)
@@ -131,63 +132,12 @@ void LogPanel::render()
             else if (m_filterIdx == 0)
             {
                 // This Node — local in-memory buffer
-                auto entries = MonitorLog::instance().getEntries();
-                for (const auto& e : entries)
-                {
-                    ImVec4 color(0.7f, 0.7f, 0.7f, 1.0f); // default gray
-                    if (e.level == "INFO")
-                        color = ImVec4(0.7f, 0.9f, 0.7f, 1.0f);
-                    else if (e.level == "WARN")
-                        color = ImVec4(1.0f, 0.85f, 0.0f, 1.0f);
-                    else if (e.level == "ERROR")
-                        color = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
-
-                    // Format: HH:MM:SS LEVEL [cat] message
-                    // Extract time from timestamp
-                    time_t secs = static_cast<time_t>(e.timestamp_ms / 1000);
-                    struct tm tmBuf;
-#ifdef _WIN32
-                    localtime_s(&tmBuf, &secs);
-#else
-                    localtime_r(&secs, &tmBuf);
-#endif
-                    char timeBuf[16];
-                    std::snprintf(timeBuf, sizeof(timeBuf), "%02d:%02d:%02d",
-                                  tmBuf.tm_hour, tmBuf.tm_min, tmBuf.tm_sec);
-
-                    std::string line = std::string(timeBuf) + " " +
-                        e.level + "  [" + e.category + "] " + e.message;
-
-                    ImGui::TextColored(color, "%s", line.c_str());
-                }
+                renderLocalLines(false);
             }
             else if (m_filterIdx == 1)
             {
                 // All Nodes — local + read peers' files
-                auto entries = MonitorLog::instance().getEntries();
-
-                // Show local entries
-                for (const auto& e : entries)
-                {
-                    ImVec4 color(0.7f, 0.9f, 0.7f, 1.0f);
-                    if (e.level == "WARN") color = ImVec4(1.0f, 0.85f, 0.0f, 1.0f);
-                    else if (e.level == "ERROR") color = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
-
-                    time_t secs = static_cast<time_t>(e.timestamp_ms / 1000);
-                    struct tm tmBuf;
-#ifdef _WIN32
-                    localtime_s(&tmBuf, &secs);
-#else
-                    localtime_r(&secs, &tmBuf);
-#endif
-                    char timeBuf[16];
-                    std::snprintf(timeBuf, sizeof(timeBuf), "%02d:%02d:%02d",
-                                  tmBuf.tm_hour, tmBuf.tm_min, tmBuf.tm_sec);
-
-                    ImGui::TextColored(color, "[local] %s %s  [%s] %s",
-                                       timeBuf, e.level.c_str(),
-                                       e.category.c_str(), e.message.c_str());
-                }
+                renderLocalLines(true);
 
                 // Read + show peer log files (from UIDataCache bg thread)
                 if (m_app->isFarmRunning())
@@ -197,16 +147,7 @@ void LogPanel::render()
                     auto remoteSnap = m_app->uiDataCache().getRemoteLogSnapshot();
 
                     ImGui::Separator();
-                    for (const auto& line : remoteSnap.lines)
-                    {
-                        ImVec4 color(0.5f, 0.6f, 0.7f, 1.0f);
-                        if (line.find("WARN") != std::string::npos)
-                            color = ImVec4(0.8f, 0.7f, 0.0f, 1.0f);
-                        else if (line.find("ERROR") != std::string::npos)
-                            color = ImVec4(0.8f, 0.3f, 0.3f, 1.0f);
-
-                        ImGui::TextColored(color, "%s", line.c_str());
-                    }
+                    renderRemoteLines(remoteSnap.lines, true);
                 }
             }
             else
@@ -220,19 +161,7 @@ void LogPanel::render()
                         "peer:" + m_peerNodeIds[peerIdx],
                         {m_peerNodeIds[peerIdx]});
                     auto remoteSnap = m_app->uiDataCache().getRemoteLogSnapshot();
-
-                    for (const auto& line : remoteSnap.lines)
-                    {
-                        ImVec4 color(0.7f, 0.7f, 0.7f, 1.0f);
-                        if (line.find("WARN") != std::string::npos)
-                            color = ImVec4(1.0f, 0.85f, 0.0f, 1.0f);
-                        else if (line.find("ERROR") != std::string::npos)
-                            color = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
-                        else if (line.find("INFO") != std::string::npos)
-                            color = ImVec4(0.7f, 0.9f, 0.7f, 1.0f);
-
-                        ImGui::TextColored(color, "%s", line.c_str());
-                    }
+                    renderRemoteLines(remoteSnap.lines, false);
                 }
                 else
                 {
@@ -291,6 +220,91 @@ void LogPanel::render()
     ImGui::End();
 }
 
+// ─── Line views ──────────────────────────────────────────────────────────────
+
+void LogPanel::refreshLocalLines()
+{
+    auto delta = MonitorLog::instance().readSince(m_localCursor);
+    if (delta.reset)
+        m_localLines.clear();
+    if (delta.entries.empty())
+        return;
+
+    for (auto& e : delta.entries)
+    {
+        // Format: HH:MM:SS LEVEL  [cat] message
+        time_t secs = static_cast<time_t>(e.timestamp_ms / 1000);
+        struct tm tmBuf;
+#ifdef _WIN32
+        localtime_s(&tmBuf, &secs);
+#else
+        localtime_r(&secs, &tmBuf);
+#endif
+        char timeBuf[16];
+        std::snprintf(timeBuf, sizeof(timeBuf), "%02d:%02d:%02d",
+                      tmBuf.tm_hour, tmBuf.tm_min, tmBuf.tm_sec);
+
+        auto& line = m_localLines.emplace_back();
+        line.text = std::string(timeBuf) + " " +
+            e.level + "  [" + e.category + "] " + e.message;
+        line.level = std::move(e.level);
+    }
+
+    // Same window as the ring itself
+    while (m_localLines.size() > MonitorLog::MAX_ENTRIES)
+        m_localLines.pop_front();
+}
+
+void LogPanel::renderLocalLines(bool tagged)
+{
+    refreshLocalLines();
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)m_localLines.size());
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            const auto& line = m_localLines[i];
+            // Unknown levels: gray here, green in the All Nodes view
+            ImVec4 color = tagged ? ImVec4(0.7f, 0.9f, 0.7f, 1.0f) : ImVec4(0.7f, 0.7f, 0.7f, 1.0f);
+            if (line.level == "INFO")
+                color = ImVec4(0.7f, 0.9f, 0.7f, 1.0f);
+            else if (line.level == "WARN")
+                color = ImVec4(1.0f, 0.85f, 0.0f, 1.0f);
+            else if (line.level == "ERROR")
+                color = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
+
+            if (tagged)
+                ImGui::TextColored(color, "[local] %s", line.text.c_str());
+            else
+                ImGui::TextColored(color, "%s", line.text.c_str());
+        }
+    }
+}
+
+void LogPanel::renderRemoteLines(const std::vector<std::string>& lines, bool dim)
+{
+    ImGuiListClipper clipper;
+    clipper.Begin((int)lines.size());
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            const auto& line = lines[i];
+            ImVec4 color = dim ? ImVec4(0.5f, 0.6f, 0.7f, 1.0f) : ImVec4(0.7f, 0.7f, 0.7f, 1.0f);
+            if (line.find("WARN") != std::string::npos)
+                color = dim ? ImVec4(0.8f, 0.7f, 0.0f, 1.0f) : ImVec4(1.0f, 0.85f, 0.0f, 1.0f);
+            else if (line.find("ERROR") != std::string::npos)
+                color = dim ? ImVec4(0.8f, 0.3f, 0.3f, 1.0f) : ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
+            else if (!dim && line.find("INFO") != std::string::npos)
+                color = ImVec4(0.7f, 0.9f, 0.7f, 1.0f);
+
+            ImGui::TextColored(color, "%s", line.c_str());
+        }
+    }
+}
+
 // ─── Task output (DCC stdout, from UIDataCache bg thread) ────────────────────
 
 void LogPanel::renderTaskOutput()
@@ -310,12 +324,18 @@ void LogPanel::renderTaskOutput()
         return;
     }
 
-    for (const auto& tol : snap.lines)
+    ImGuiListClipper clipper;
+    clipper.Begin((int)snap.lines.size());
+    while (clipper.Step())
     {
-        if (tol.isHeader)
-            ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "%s", tol.text.c_str());
-        else
-            ImGui::TextUnformatted(tol.text.c_str());
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            const auto& tol = snap.lines[i];
+            if (tol.isHeader)
+                ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "%s", tol.text.c_str());
+            else
+                ImGui::TextUnformatted(tol.text.c_str());
+        }
     }
 }
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "core/monitor_log.h"
+
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -26,6 +29,19 @@ private:
     std::vector<std::string> m_peerNodeIds;
     std::vector<std::string> m_peerHostnames;
 
+    // This node's entries, each formatted once as it arrives through
+    // MonitorLog::readSince(); only the lines in view are drawn
+    struct LocalLine
+    {
+        std::string text;       // "HH:MM:SS LEVEL  [cat] message"
+        std::string level;
+    };
+    std::deque<LocalLine> m_localLines;
+    MonitorLog::Cursor m_localCursor;
+    void refreshLocalLines();
+    void renderLocalLines(bool tagged);
+    void renderRemoteLines(const std::vector<std::string>& lines, bool dim);
+
     void renderTaskOutput();
 
     bool m_autoScroll = true;
@@ -45,7 +45,8 @@ void NodePanel::render()
 
 void NodePanel::renderLocalNode()
 {
-    auto nodes = m_app->heartbeatManager().getNodeSnapshot();
+    auto nodeSnapshot = m_app->heartbeatManager().getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
 
     // Find local node
     const NodeInfo* local = nullptr;
@@ -82,6 +83,11 @@ void NodePanel::renderLocalNode()
         ImGui::TextColored(ImVec4(0.3f, 0.5f, 0.9f, 1.0f), "[Rendering]");
     else
         ImGui::TextColored(ImVec4(0.3f, 0.9f, 0.3f, 1.0f), "[Idle]");
+    if (hb.render_slots > 1)
+    {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%d/%d slots free", hb.free_slots, hb.render_slots);
+    }
 
     // Role badges on their own line
     if (hb.is_coordinator)
@@ -98,6 +104,14 @@ void NodePanel::renderLocalNode()
     if (hb.cpu_cores > 0)
         ImGui::Text("CPU: %d cores  |  RAM: %llu GB", hb.cpu_cores,
                      static_cast<unsigned long long>(hb.ram_gb));
+    if (hb.load.cpu_pct >= 0)
+    {
+        if (hb.load.gpu_pct >= 0)
+            ImGui::Text("Load: CPU %d%%  |  %u MB free  |  GPU %d%%  |  %u MB VRAM free",
+                        hb.load.cpu_pct, hb.load.ram_free_mb, hb.load.gpu_pct, hb.load.vram_free_mb);
+        else
+            ImGui::Text("Load: CPU %d%%  |  %u MB free", hb.load.cpu_pct, hb.load.ram_free_mb);
+    }
 
     // Clock skew warning
     if (m_app->heartbeatManager().hasLocalClockSkew())
@@ -134,7 +148,8 @@ void NodePanel::renderLocalNode()
 
 void NodePanel::renderPeerList()
 {
-    auto nodes = m_app->heartbeatManager().getNodeSnapshot();
+    auto nodeSnapshot = m_app->heartbeatManager().getNodeSnapshot();
+    const auto& nodes = nodeSnapshot->nodes;
 
     // Separate peers from local
     std::vector<const NodeInfo*> peers;
@@ -179,7 +194,11 @@ void NodePanel::renderPeerList()
         ImGui::PushID(hb.node_id.c_str());
 
         // Status indicator
-        if (peer->isDead)
+        if (peer->isParked())
+        {
+            ImGui::TextColored(ImVec4(0.5f, 0.6f, 0.8f, 1.0f), "[Sleeping]");
+        }
+        else if (peer->isDead)
         {
             ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "[Dead]");
         }
@@ -195,6 +214,11 @@ void NodePanel::renderPeerList()
         {
             ImGui::TextColored(ImVec4(0.3f, 0.9f, 0.3f, 1.0f), "[Idle]");
         }
+        if (!peer->isDead && hb.render_slots > 1)
+        {
+            ImGui::SameLine();
+            ImGui::TextDisabled("%d/%d", hb.free_slots, hb.render_slots);
+        }
 
         ImGui::SameLine();
 
@@ -205,15 +229,32 @@ void NodePanel::renderPeerList()
             ImGui::TextUnformatted(hb.hostname.c_str());
 
         // Role badges on their own line
-        if (hb.is_coordinator || peer->hasUdpContact)
         {
+            bool badge = false;
+            auto nextBadge = [&badge]() {
+                if (badge) ImGui::SameLine();
+                badge = true;
+            };
             if (hb.is_coordinator)
             {
+                nextBadge();
                 ImGui::TextColored(ImVec4(1.0f, 0.84f, 0.0f, 1.0f), "[Coordinator]");
-                if (peer->hasUdpContact) ImGui::SameLine();
+            }
+            else if (hb.is_standby)
+            {
+                nextBadge();
+                ImGui::TextColored(ImVec4(0.8f, 0.7f, 0.3f, 1.0f), "[Standby]");
             }
             if (peer->hasUdpContact)
+            {
+                nextBadge();
                 ImGui::TextColored(ImVec4(0.5f, 0.8f, 1.0f, 1.0f), "[UDP]");
+            }
+            if (peer->lastKnown)
+            {
+                nextBadge();
+                ImGui::TextDisabled("(last known)");
+            }
         }
 
         // Hardware summary + version
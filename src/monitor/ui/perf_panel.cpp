@@ -0,0 +1,159 @@
+#include "monitor/ui/perf_panel.h"
+#include "monitor/monitor_app.h"
+#include "core/monitor_log.h"
+#include "core/perf_counters.h"
+#include "core/platform.h"
+#include "core/read_cache.h"
+
+#include <imgui.h>
+#include <cstdio>
+#include <ctime>
+
+namespace SR {
+
+namespace {
+
+std::string formatBytes(double bytes)
+{
+    char buf[32];
+    if (bytes >= 1024.0 * 1024.0)
+        snprintf(buf, sizeof(buf), "%.1f MB", bytes / (1024.0 * 1024.0));
+    else if (bytes >= 1024.0)
+        snprintf(buf, sizeof(buf), "%.1f KB", bytes / 1024.0);
+    else
+        snprintf(buf, sizeof(buf), "%.0f B", bytes);
+    return buf;
+}
+
+} // namespace
+
+void PerfPanel::init(MonitorApp* app)
+{
+    m_app = app;
+}
+
+void PerfPanel::render()
+{
+    if (!visible) return;
+
+    ImGui::SetNextWindowSize(ImVec2(560, 420), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Performance", &visible, ImGuiWindowFlags_NoDocking))
+    {
+        ImGui::End();
+        return;
+    }
+
+    auto report = PerfCounters::instance().report();
+
+    // Frame time (ImGui build + GL submit, without the swap)
+    for (const auto& p : report.probes)
+    {
+        if (p.name != "ui.frame")
+            continue;
+        ImGui::Text("Frame: %.2f ms (p50 %.2f, p99 %.2f, max %.2f)",
+                    p.stats.lastMs, p.stats.p50Ms, p.stats.p99Ms, p.stats.maxMs);
+    }
+
+    // Farm file traffic (AtomicFileIO)
+    ImGui::Text("Farm reads:  %.1f/s, %s/s  (%llu total)",
+                report.readsPerSec, formatBytes(report.readBytesPerSec).c_str(),
+                (unsigned long long)report.reads);
+    ImGui::Text("Farm writes: %.1f/s, %s/s  (%llu total)",
+                report.writesPerSec, formatBytes(report.writeBytesPerSec).c_str(),
+                (unsigned long long)report.writes);
+
+    auto cache = ReadCache::instance().stats();
+    uint64_t lookups = cache.hits + cache.misses;
+    ImGui::Text("Read cache: %.0f%% hits, %zu entries, %s",
+                lookups > 0 ? 100.0 * double(cache.hits) / double(lookups) : 0.0,
+                cache.entries, formatBytes(double(cache.bytes)).c_str());
+
+    ImGui::Separator();
+
+    ImGuiTableFlags tableFlags =
+        ImGuiTableFlags_RowBg |
+        ImGuiTableFlags_BordersOuter |
+        ImGuiTableFlags_BordersInnerV |
+        ImGuiTableFlags_ScrollY;
+    float footerHeight = ImGui::GetFrameHeightWithSpacing();
+    if (ImGui::BeginTable("##perf", 6, tableFlags, ImVec2(0, -footerHeight)))
+    {
+        ImGui::TableSetupColumn("Probe", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+        ImGui::TableSetupColumn("Last",  ImGuiTableColumnFlags_WidthFixed, 60.0f);
+        ImGui::TableSetupColumn("p50",   ImGuiTableColumnFlags_WidthFixed, 60.0f);
+        ImGui::TableSetupColumn("p99",   ImGuiTableColumnFlags_WidthFixed, 60.0f);
+        ImGui::TableSetupColumn("Max",   ImGuiTableColumnFlags_WidthFixed, 60.0f);
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableHeadersRow();
+
+        for (const auto& p : report.probes)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(p.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)p.stats.count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", p.stats.lastMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", p.stats.p50Ms);
+            ImGui::TableNextColumn();
+            // Slow tails stand out
+            if (p.stats.p99Ms >= 100.0)
+                ImGui::TextColored(ImVec4(1.0f, 0.85f, 0.0f, 1.0f), "%.2f", p.stats.p99Ms);
+            else
+                ImGui::Text("%.2f", p.stats.p99Ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", p.stats.maxMs);
+        }
+        ImGui::EndTable();
+    }
+
+    // Footer
+    if (ImGui::Button("Save Report"))
+        saveReport();
+    if (!m_lastReport.empty())
+    {
+        ImGui::SameLine();
+        if (ImGui::Button("Open Folder"))
+            openFolderInExplorer(m_lastReport.parent_path());
+        ImGui::SameLine();
+        ImGui::TextDisabled("%s", m_lastReport.filename().string().c_str());
+    }
+
+    ImGui::End();
+}
+
+void PerfPanel::saveReport()
+{
+    auto dir = getAppDataDir() / "perf";
+    if (!ensureDir(dir))
+    {
+        MonitorLog::instance().error("farm", "Cannot create " + dir.string());
+        return;
+    }
+
+    time_t now = std::time(nullptr);
+    struct tm tmBuf;
+#ifdef _WIN32
+    localtime_s(&tmBuf, &now);
+#else
+    localtime_r(&now, &tmBuf);
+#endif
+    char name[48];
+    std::strftime(name, sizeof(name), "perf_%Y%m%d_%H%M%S.txt", &tmBuf);
+
+    auto path = dir / name;
+    if (PerfCounters::instance().writeReport(path))
+    {
+        m_lastReport = path;
+        MonitorLog::instance().info("farm", "Performance report saved to " + path.string());
+    }
+    else
+    {
+        MonitorLog::instance().error("farm", "Failed to write " + path.string());
+    }
+}
+
+} // namespace SR
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <filesystem>
+
+namespace SR {
+
+class MonitorApp; // forward
+
+// Floating window with the PerfCounters probes (per-subsystem p50/p99),
+// farm file traffic and read-cache hit rate; off until picked in View.
+class PerfPanel
+{
+public:
+    void init(MonitorApp* app);
+    void render();
+    bool visible = false;
+
+private:
+    void saveReport();
+
+    MonitorApp* m_app = nullptr;
+    std::filesystem::path m_lastReport;
+};
+
+} // namespace SR
@@ -17,6 +17,11 @@
 
 namespace SR {
 
+// Config::render_priority values and their labels; "" = per template
+static const char* RENDER_PRIORITIES[] = { "", "idle", "below_normal", "normal", "above_normal", "high" };
+static const char* RENDER_PRIORITY_LABELS[] = { "Template default", "Idle", "Below normal", "Normal",
+                                                "Above normal", "High" };
+
 void SettingsPanel::init(MonitorApp* app)
 {
     m_app = app;
@@ -43,11 +48,52 @@ void SettingsPanel::loadFromConfig()
     m_tagsBuf[sizeof(m_tagsBuf) - 1] = '\0';
 
     m_isCoordinator = cfg.is_coordinator;
+    m_standbyCoordinator = cfg.standby_coordinator;
+    m_coordinatorShard = cfg.coordinator_shard;
+    m_prefetchDepth = cfg.prefetch_depth;
+    m_schedulingPolicy = static_cast<int>(cfg.scheduling_policy);
+    m_jobAffinity = cfg.job_affinity;
+    m_preemptWaitS = cfg.preemption.wait_s;
+    m_preemptGap = cfg.preemption.min_priority_gap;
+    m_wakeOnLan = cfg.power.wake_on_lan;
+    m_idleSleepMin = cfg.power.idle_sleep_min;
+    m_allowRemoteSleep = cfg.allow_remote_sleep;
+    m_archiveAfterDays = cfg.archive_after_days;
     m_autoStartAgent = cfg.auto_start_agent;
+    m_renderSlots = renderSlotCount(cfg);
+    for (int i = 0; i < MAX_RENDER_SLOTS; ++i)
+    {
+        RenderSlotPin pin;
+        if (i < static_cast<int>(cfg.render_slot_pins.size()))
+            pin = cfg.render_slot_pins[i];
+        std::strncpy(m_slotEnvBufs[i], pin.env.c_str(), sizeof(m_slotEnvBufs[i]) - 1);
+        m_slotEnvBufs[i][sizeof(m_slotEnvBufs[i]) - 1] = '\0';
+        std::strncpy(m_slotCpuBufs[i], pin.cpu_set.c_str(), sizeof(m_slotCpuBufs[i]) - 1);
+        m_slotCpuBufs[i][sizeof(m_slotCpuBufs[i]) - 1] = '\0';
+        m_slotNuma[i] = pin.numa_node;
+    }
+    m_renderPriority = 0;
+    for (int i = 0; i < IM_ARRAYSIZE(RENDER_PRIORITIES); ++i)
+    {
+        if (cfg.render_priority == RENDER_PRIORITIES[i])
+            m_renderPriority = i;
+    }
+    m_stdoutCompress = cfg.stdout_compress;
+    m_stdoutStageLocal = cfg.stdout_stage_local;
+    m_inputCacheEnabled = cfg.input_cache_enabled;
+    m_inputCacheGb = cfg.input_cache_gb;
+    m_outputStaging = cfg.output_staging;
     m_udpEnabled = cfg.udp_enabled;
     m_udpPort = static_cast<int>(cfg.udp_port);
+    m_tcpLinkEnabled = cfg.tcp_link_enabled;
+    m_tcpPort = static_cast<int>(cfg.tcp_port);
+    std::strncpy(m_metricsPathBuf, cfg.metrics_export_path.c_str(), sizeof(m_metricsPathBuf) - 1);
+    m_metricsPathBuf[sizeof(m_metricsPathBuf) - 1] = '\0';
+    m_metricsIntervalSec = cfg.metrics_export_interval_sec;
+    m_chunkTracing = cfg.chunk_tracing;
     m_showNotifications = cfg.show_notifications;
     m_fontScale = cfg.font_scale;
+    m_lowPowerUi = cfg.low_power_ui;
 
     m_heartbeatMs = static_cast<int>(cfg.timing.heartbeat_interval_ms);
     m_scanMs = static_cast<int>(cfg.timing.scan_interval_ms);
@@ -77,11 +123,41 @@ void SettingsPanel::applyToConfig()
     }
 
     cfg.is_coordinator = m_isCoordinator;
+    cfg.standby_coordinator = m_standbyCoordinator;
+    cfg.coordinator_shard = m_coordinatorShard;
+    cfg.prefetch_depth = m_prefetchDepth;
+    cfg.scheduling_policy = static_cast<SchedulingPolicy>(m_schedulingPolicy);
+    cfg.job_affinity = m_jobAffinity;
+    cfg.preemption.wait_s = m_preemptWaitS;
+    cfg.preemption.min_priority_gap = m_preemptGap;
+    cfg.power.wake_on_lan = m_wakeOnLan;
+    cfg.power.idle_sleep_min = m_idleSleepMin;
+    cfg.allow_remote_sleep = m_allowRemoteSleep;
+    cfg.archive_after_days = m_archiveAfterDays;
     cfg.auto_start_agent = m_autoStartAgent;
+    cfg.render_slots = m_renderSlots;
+    cfg.render_slot_pins.clear();
+    for (int i = 0; i < m_renderSlots; ++i)
+        cfg.render_slot_pins.push_back({m_slotEnvBufs[i], m_slotCpuBufs[i], m_slotNuma[i]});
+    // Drop trailing unpinned slots
+    while (!cfg.render_slot_pins.empty() && cfg.render_slot_pins.back().empty())
+        cfg.render_slot_pins.pop_back();
+    cfg.render_priority = RENDER_PRIORITIES[m_renderPriority];
+    cfg.stdout_compress = m_stdoutCompress;
+    cfg.stdout_stage_local = m_stdoutStageLocal;
+    cfg.input_cache_enabled = m_inputCacheEnabled;
+    cfg.input_cache_gb = m_inputCacheGb;
+    cfg.output_staging = m_outputStaging;
     cfg.udp_enabled = m_udpEnabled;
     cfg.udp_port = static_cast<uint16_t>(m_udpPort);
+    cfg.tcp_link_enabled = m_tcpLinkEnabled;
+    cfg.tcp_port = static_cast<uint16_t>(m_tcpPort);
+    cfg.metrics_export_path = m_metricsPathBuf;
+    cfg.metrics_export_interval_sec = m_metricsIntervalSec;
+    cfg.chunk_tracing = m_chunkTracing;
     cfg.show_notifications = m_showNotifications;
     cfg.font_scale = m_fontScale;
+    cfg.low_power_ui = m_lowPowerUi;
 
     if (cfg.timing_preset == TimingPreset::Custom)
     {
@@ -287,7 +363,61 @@ void SettingsPanel::render()
     {
         ImGui::Checkbox("This node is the coordinator", &m_isCoordinator);
         ImGui::TextDisabled("The coordinator dispatches work to all nodes.");
-        ImGui::TextDisabled("Only one node on the farm should be coordinator.");
+        ImGui::TextDisabled("Only one node on the farm should be coordinator,");
+        ImGui::TextDisabled("unless every coordinator is a shard.");
+
+        if (!m_isCoordinator) ImGui::BeginDisabled();
+        ImGui::Checkbox("Shard coordinator", &m_coordinatorShard);
+        if (!m_isCoordinator) ImGui::EndDisabled();
+        ImGui::TextDisabled("Shards split jobs and workers between them, lending idle workers.");
+
+        if (m_isCoordinator) ImGui::BeginDisabled();
+        ImGui::Checkbox("Standby coordinator", &m_standbyCoordinator);
+        if (m_isCoordinator) ImGui::EndDisabled();
+        ImGui::TextDisabled("Takes over dispatch if the coordinator stops responding.");
+
+        ImGui::Spacing();
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("Prefetch depth", &m_prefetchDepth, 1);
+        if (m_prefetchDepth < 0) m_prefetchDepth = 0;
+        if (m_prefetchDepth > 8) m_prefetchDepth = 8;
+        ImGui::TextDisabled("Chunks queued on each worker behind the one it is rendering.");
+
+        ImGui::Spacing();
+        const char* policies[] = { "Priority (FIFO)", "Fair share (per job)", "Fair share (per submitter)" };
+        ImGui::SetNextItemWidth(220);
+        ImGui::Combo("Scheduling", &m_schedulingPolicy, policies, IM_ARRAYSIZE(policies));
+        ImGui::TextDisabled("Fair share spreads workers across jobs of equal priority.");
+
+        ImGui::Checkbox("Job affinity", &m_jobAffinity);
+        ImGui::TextDisabled("Workers keep pulling chunks from the job whose scene is already loaded.");
+
+        ImGui::Spacing();
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("Preempt after (s)", &m_preemptWaitS, 30);
+        if (m_preemptWaitS < 0) m_preemptWaitS = 0;
+        if (m_preemptWaitS > 86400) m_preemptWaitS = 86400;
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("Preempt priority gap", &m_preemptGap, 5);
+        if (m_preemptGap < 1) m_preemptGap = 1;
+        if (m_preemptGap > 100) m_preemptGap = 100;
+        ImGui::TextDisabled("Waiting work this much higher in priority aborts running chunks (0 s = off).");
+
+        ImGui::Spacing();
+        ImGui::Checkbox("Wake sleeping nodes (Wake-on-LAN)", &m_wakeOnLan);
+        ImGui::TextDisabled("Sent when queued chunks outnumber what the awake nodes can take.");
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("Sleep idle nodes after (min)", &m_idleSleepMin, 5);
+        if (m_idleSleepMin < 0) m_idleSleepMin = 0;
+        if (m_idleSleepMin > 1440) m_idleSleepMin = 1440;
+        ImGui::TextDisabled("Only nodes that allow remote sleep, once nothing is queued (0 = never).");
+
+        ImGui::Spacing();
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("Archive after (days)", &m_archiveAfterDays, 1);
+        if (m_archiveAfterDays < 0) m_archiveAfterDays = 0;
+        if (m_archiveAfterDays > 3650) m_archiveAfterDays = 3650;
+        ImGui::TextDisabled("Completed and cancelled jobs move to the farm's archive/ (0 = never).");
         ImGui::Separator();
     }
 
@@ -328,55 +458,112 @@ void SettingsPanel::render()
     // --- Agent ---
     if (ImGui::CollapsingHeader("Agent", ImGuiTreeNodeFlags_DefaultOpen))
     {
-        auto& supervisor = m_app->agentSupervisor();
-        bool connected = supervisor.isAgentConnected();
-        bool running = supervisor.isAgentRunning();
-
-        // Status
-        if (connected)
+        for (size_t slot = 0; slot < m_app->agentCount(); ++slot)
         {
-            ImGui::TextColored(ImVec4(0.3f, 0.9f, 0.3f, 1.0f), "Connected");
-            ImGui::SameLine();
-            ImGui::TextDisabled("(PID %u, %s)", supervisor.agentPid(),
-                supervisor.agentState().empty() ? "unknown" : supervisor.agentState().c_str());
-        }
-        else if (running)
-        {
-            ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.3f, 1.0f), "Starting...");
-            ImGui::SameLine();
-            ImGui::TextDisabled("(PID %u)", supervisor.agentPid());
-        }
-        else
-        {
-            ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "Disconnected");
-        }
-
-        ImGui::Spacing();
+            ImGui::PushID(static_cast<int>(slot));
+            if (m_app->agentCount() > 1)
+            {
+                ImGui::Text("Slot %d", static_cast<int>(slot));
+                ImGui::SameLine();
+            }
+            auto& supervisor = m_app->agentSupervisor(slot);
+            bool connected = supervisor.isAgentConnected();
+            bool running = supervisor.isAgentRunning();
 
-        // Controls
-        if (!running)
-        {
-            if (ImGui::Button("Start Agent"))
+            // Status
+            if (connected)
             {
-                supervisor.spawnAgent();
+                ImGui::TextColored(ImVec4(0.3f, 0.9f, 0.3f, 1.0f), "Connected");
+                ImGui::SameLine();
+                ImGui::TextDisabled("(PID %u, %s)", supervisor.agentPid(),
+                    supervisor.agentState().empty() ? "unknown" : supervisor.agentState().c_str());
             }
-        }
-        else
-        {
-            if (ImGui::Button("Stop Agent"))
+            else if (running)
             {
-                supervisor.shutdownAgent();
+                ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.3f, 1.0f), "Starting...");
+                ImGui::SameLine();
+                ImGui::TextDisabled("(PID %u)", supervisor.agentPid());
             }
-            ImGui::SameLine();
-            if (ImGui::Button("Restart Agent"))
+            else
+            {
+                ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "Disconnected");
+            }
+
+            ImGui::Spacing();
+
+            // Controls
+            if (!running)
+            {
+                if (ImGui::Button("Start Agent"))
+                {
+                    supervisor.spawnAgent();
+                }
+            }
+            else
             {
-                supervisor.shutdownAgent();
-                supervisor.spawnAgent();
+                if (ImGui::Button("Stop Agent"))
+                {
+                    supervisor.shutdownAgent();
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Restart Agent"))
+                {
+                    supervisor.shutdownAgent();
+                    supervisor.spawnAgent();
+                }
             }
+            ImGui::PopID();
         }
 
         ImGui::Spacing();
         ImGui::Checkbox("Auto-start agent", &m_autoStartAgent);
+        ImGui::Checkbox("Allow remote sleep", &m_allowRemoteSleep);
+        ImGui::TextDisabled("The coordinator may suspend this machine when idle and wake it over the LAN.");
+
+        ImGui::SetNextItemWidth(120);
+        ImGui::InputInt("Render slots", &m_renderSlots, 1);
+        if (m_renderSlots < 1) m_renderSlots = 1;
+        if (m_renderSlots > MAX_RENDER_SLOTS) m_renderSlots = MAX_RENDER_SLOTS;
+        ImGui::TextDisabled("Chunks this node renders at once, one agent each. Takes effect on restart.");
+        for (int i = 0; i < m_renderSlots; ++i)
+        {
+            ImGui::PushID(i);
+            ImGui::Text("Slot %d", i);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(220);
+            ImGui::InputTextWithHint("##env", "CUDA_VISIBLE_DEVICES=0", m_slotEnvBufs[i], sizeof(m_slotEnvBufs[i]));
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(120);
+            ImGui::InputTextWithHint("##cpus", "CPUs e.g. 0-15", m_slotCpuBufs[i], sizeof(m_slotCpuBufs[i]));
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(90);
+            ImGui::InputInt("NUMA##numa", &m_slotNuma[i], 1);
+            if (m_slotNuma[i] < -1) m_slotNuma[i] = -1;
+            ImGui::PopID();
+        }
+        if (m_renderSlots > 1)
+            ImGui::TextDisabled("Environment is NAME=value;... CPU sets cover the first 64 logical processors.");
+        ImGui::TextDisabled("NUMA -1 leaves render placement to the job template.");
+
+        ImGui::SetNextItemWidth(160);
+        ImGui::Combo("Render priority", &m_renderPriority, RENDER_PRIORITY_LABELS, IM_ARRAYSIZE(RENDER_PRIORITY_LABELS));
+        ImGui::TextDisabled("Process priority class for renders on this node; overrides the template.");
+
+        ImGui::Checkbox("Compress render logs", &m_stdoutCompress);
+        ImGui::Checkbox("Stage render logs locally", &m_stdoutStageLocal);
+        ImGui::TextDisabled("Uploads each log when its chunk ends. Task output is not live meanwhile.");
+
+        ImGui::Checkbox("Cache job inputs locally", &m_inputCacheEnabled);
+        if (m_inputCacheEnabled)
+        {
+            ImGui::SetNextItemWidth(120);
+            ImGui::InputInt("Input cache (GB)", &m_inputCacheGb, 5);
+            if (m_inputCacheGb < 1) m_inputCacheGb = 1;
+        }
+        ImGui::TextDisabled("Copies scene/project files to this node before rendering. Linked assets stay on the share.");
+
+        ImGui::Checkbox("Stage render output locally", &m_outputStaging);
+        ImGui::TextDisabled("Frames upload in the background; a chunk completes once its frames are on the share.");
         ImGui::Separator();
     }
 
@@ -395,11 +582,45 @@ void SettingsPanel::render()
             if (m_udpPort < 1024) m_udpPort = 1024;
             if (m_udpPort > 65535) m_udpPort = 65535;
         }
+
+        ImGui::Spacing();
+        ImGui::Checkbox("Direct TCP link to coordinator", &m_tcpLinkEnabled);
+        ImGui::TextDisabled("Keeps a connection open for millisecond dispatch, even where multicast is blocked.");
+        ImGui::TextDisabled("Not used with the Cloud FS timing preset.");
+
+        if (m_tcpLinkEnabled)
+        {
+            ImGui::Spacing();
+            ImGui::SetNextItemWidth(120);
+            ImGui::InputInt("Link port", &m_tcpPort, 0);
+            if (m_tcpPort < 1024) m_tcpPort = 1024;
+            if (m_tcpPort > 65535) m_tcpPort = 65535;
+        }
+
+        ImGui::Spacing();
+        ImGui::SetNextItemWidth(360);
+        ImGui::InputTextWithHint("Metrics export file", "C:\\metrics\\smallrender.prom",
+                                 m_metricsPathBuf, sizeof(m_metricsPathBuf));
+        if (m_metricsPathBuf[0] != '\0')
+        {
+            ImGui::SetNextItemWidth(120);
+            ImGui::InputInt("Export every (s)", &m_metricsIntervalSec, 5);
+            if (m_metricsIntervalSec < 1) m_metricsIntervalSec = 1;
+        }
+        ImGui::TextDisabled("A local path: Prometheus text for a textfile collector, or JSON if it ends in .json.");
+        ImGui::TextDisabled("Queue, chunk and turnaround figures come from the coordinator.");
+
+        ImGui::Spacing();
+        ImGui::Checkbox("Record chunk traces", &m_chunkTracing);
+        ImGui::TextDisabled("Times each hop from dispatch to the DCC's first frame; export from a job's panel.");
+        ImGui::TextDisabled("Enable on the coordinator and the workers to see the whole path.");
         ImGui::Separator();
     }
 
     // --- Notifications ---
     ImGui::Checkbox("Show notifications", &m_showNotifications);
+    ImGui::Checkbox("Low-power UI", &m_lowPowerUi);
+    ImGui::TextDisabled("Redraws only on input or farm changes, leaving the CPU and GPU to renders.");
 
     ImGui::EndChild(); // SettingsContent
 
@@ -409,16 +630,22 @@ void SettingsPanel::render()
     {
         std::string oldSyncRoot = m_savedSyncRoot;
         bool wasCoordinator = m_app->config().is_coordinator;
+        bool wasShard = m_app->config().coordinator_shard;
         bool wasUdpEnabled = m_app->config().udp_enabled;
         uint16_t oldUdpPort = m_app->config().udp_port;
+        bool wasTcpLink = tcpLinkActive(m_app->config());
+        uint16_t oldTcpPort = m_app->config().tcp_port;
         applyToConfig();
         m_app->saveConfig();
 
         auto& cfg = m_app->config();
         bool needsRestart = (cfg.sync_root != oldSyncRoot) ||
                             (cfg.is_coordinator != wasCoordinator) ||
+                            (cfg.coordinator_shard != wasShard) ||
                             (cfg.udp_enabled != wasUdpEnabled) ||
-                            (cfg.udp_port != oldUdpPort);
+                            (cfg.udp_port != oldUdpPort) ||
+                            (tcpLinkActive(cfg) != wasTcpLink) ||
+                            (cfg.tcp_port != oldTcpPort);
 
         if (needsRestart)
         {
@@ -431,10 +658,23 @@ void SettingsPanel::render()
             // Update live timing/tags
             m_app->heartbeatManager().updateTiming(cfg.timing);
             m_app->heartbeatManager().updateTags(cfg.tags);
-            if (cfg.is_coordinator)
+            m_app->renderCoordinator().setStdoutOptions(cfg.stdout_compress, cfg.stdout_stage_local);
+            m_app->renderCoordinator().setInputCacheOptions(cfg.input_cache_enabled, cfg.input_cache_dir, cfg.input_cache_gb);
+            m_app->renderCoordinator().setOutputStaging(cfg.output_staging, cfg.output_staging_dir);
+            m_app->renderCoordinator().setPlacementOptions(cfg.render_priority, slotNumaNodes(cfg));
+            m_app->heartbeatManager().setIsStandby(cfg.standby_coordinator && !m_app->isCoordinator());
+            m_app->applyMetricsExport();
+            m_app->applyArchiving();
+            m_app->applyChunkTracing();
+            m_app->applyPowerSettings();
+            if (m_app->isCoordinator())
             {
                 m_app->dispatchManager().updateTiming(cfg.timing);
                 m_app->dispatchManager().updateTags(cfg.tags);
+                m_app->dispatchManager().setPrefetchDepth(cfg.prefetch_depth);
+                m_app->dispatchManager().setSchedulingPolicy(cfg.scheduling_policy);
+                m_app->dispatchManager().setJobAffinity(cfg.job_affinity);
+                m_app->dispatchManager().setPreemption(cfg.preemption);
             }
         }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/config.h"
+
 #include <string>
 
 namespace SR {
@@ -21,11 +23,38 @@ private:
     int  m_timingPreset = 0;
     char m_tagsBuf[256] = {};
     bool m_isCoordinator = false;
+    bool m_standbyCoordinator = false;
+    bool m_coordinatorShard = false;
+    int  m_prefetchDepth = 1;
+    int  m_schedulingPolicy = 0;
+    bool m_jobAffinity = true;
+    int  m_preemptWaitS = 0;
+    int  m_preemptGap = 20;
+    bool m_wakeOnLan = false;
+    int  m_idleSleepMin = 0;
+    bool m_allowRemoteSleep = false;
+    int  m_archiveAfterDays = 14;
     bool m_autoStartAgent = true;
+    int  m_renderSlots = 1;
+    char m_slotEnvBufs[MAX_RENDER_SLOTS][256] = {};
+    char m_slotCpuBufs[MAX_RENDER_SLOTS][64] = {};
+    int  m_slotNuma[MAX_RENDER_SLOTS] = {};
+    int  m_renderPriority = 0;     // index into RENDER_PRIORITIES
+    bool m_stdoutCompress = true;
+    bool m_stdoutStageLocal = false;
+    bool m_inputCacheEnabled = false;
+    int  m_inputCacheGb = 50;
+    bool m_outputStaging = false;
     bool m_udpEnabled = true;
     int  m_udpPort = 4242;
+    bool m_tcpLinkEnabled = true;
+    int  m_tcpPort = 4243;
+    char m_metricsPathBuf[512] = {};
+    int  m_metricsIntervalSec = 15;
+    bool m_chunkTracing = false;
     bool m_showNotifications = true;
     float m_fontScale = 1.0f;
+    bool m_lowPowerUi = true;
 
     // Custom timing (editable when preset is Custom)
     int m_heartbeatMs = 5000;
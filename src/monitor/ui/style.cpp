@@ -15,6 +15,7 @@
 #include <GLFW/glfw3native.h>
 #endif
 
+#include <cstdio>
 #include <filesystem>
 #include <string>
 
@@ -252,4 +253,21 @@ bool panelHeader(const char* title, bool& visible)
     return closed;
 }
 
+// ---------------------------------------------------------------------------
+// Formatting
+// ---------------------------------------------------------------------------
+
+std::string formatDuration(int64_t ms)
+{
+    int64_t secs = ms > 0 ? ms / 1000 : 0;
+    char buf[32];
+    if (secs >= 3600)
+        snprintf(buf, sizeof(buf), "%dh%02dm", (int)(secs / 3600), (int)((secs % 3600) / 60));
+    else if (secs >= 60)
+        snprintf(buf, sizeof(buf), "%dm%02ds", (int)(secs / 60), (int)(secs % 60));
+    else
+        snprintf(buf, sizeof(buf), "%ds", (int)secs);
+    return buf;
+}
+
 } // namespace SR
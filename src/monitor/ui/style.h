@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
+
 struct GLFWwindow;
 struct ImFont;
 
@@ -28,4 +31,7 @@ void enableDarkTitleBar(GLFWwindow* window);
 // Returns true if close was clicked. Call after ImGui::Begin().
 bool panelHeader(const char* title, bool& visible);
 
+// Compact duration for tables: "2h05m", "4m30s", "45s"
+std::string formatDuration(int64_t ms);
+
 } // namespace SR
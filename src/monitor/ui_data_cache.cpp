@@ -1,6 +1,9 @@
 #include "monitor/ui_data_cache.h"
-#include "core/atomic_file_io.h"
+#include "core/dispatch_journal.h"
+#include "core/farm_storage.h"
 #include "core/monitor_log.h"
+#include "core/perf_counters.h"
+#include "monitor/stdout_writer.h"
 
 #include <algorithm>
 #include <filesystem>
@@ -14,6 +17,91 @@ namespace SR {
 
 namespace fs = std::filesystem;
 
+namespace {
+
+UIDataCache::JobProgress progressOf(const DispatchTable& dt)
+{
+    UIDataCache::JobProgress prog;
+    for (const auto& dc : dt.chunks)
+    {
+        int count = dc.frame_end - dc.frame_start + 1;
+        prog.total += count;
+        if (dc.state == DispatchState::Completed)
+            prog.completed += count;
+        else if (dc.state == DispatchState::Assigned)
+        {
+            prog.rendering += count;
+            ++prog.renderingChunks;
+        }
+        else if (dc.state == DispatchState::Failed)
+            prog.failed += count;
+    }
+    return prog;
+}
+
+UIDataCache::FrameState frameStateOf(DispatchState state)
+{
+    switch (state)
+    {
+    case DispatchState::Assigned:  return UIDataCache::FrameState::Rendering;
+    case DispatchState::Completed: return UIDataCache::FrameState::Completed;
+    case DispatchState::Failed:    return UIDataCache::FrameState::Failed;
+    default:                       return UIDataCache::FrameState::Unclaimed;
+    }
+}
+
+UIDataCache::FrameStateSnapshot frameStatesOf(const std::string& jobId, const DispatchTable& dt)
+{
+    UIDataCache::FrameStateSnapshot snap;
+    snap.jobId = jobId;
+    snap.chunks = dt.chunks;
+
+    // Runs are built in frame order; tables are normally in it already
+    std::vector<const DispatchChunk*> ordered;
+    ordered.reserve(dt.chunks.size());
+    for (const auto& dc : dt.chunks)
+        ordered.push_back(&dc);
+    auto byStart = [](const DispatchChunk* a, const DispatchChunk* b) { return a->frame_start < b->frame_start; };
+    if (!std::is_sorted(ordered.begin(), ordered.end(), byStart))
+        std::sort(ordered.begin(), ordered.end(), byStart);
+
+    for (const auto* dc : ordered)
+        snap.append(dc->frame_start, dc->frame_end, frameStateOf(dc->state));
+    return snap;
+}
+
+} // namespace
+
+const char* UIDataCache::frameStateName(FrameState state)
+{
+    switch (state)
+    {
+    case FrameState::Rendering: return "rendering";
+    case FrameState::Completed: return "completed";
+    case FrameState::Failed:    return "failed";
+    default:                    return "unclaimed";
+    }
+}
+
+int UIDataCache::FrameStateSnapshot::frameCount() const
+{
+    int total = 0;
+    for (int c : counts)
+        total += c;
+    return total;
+}
+
+void UIDataCache::FrameStateSnapshot::append(int start, int end, FrameState state)
+{
+    if (end < start)
+        return;
+    counts[size_t(state)] += end - start + 1;
+    if (!runs.empty() && runs.back().state == state && runs.back().end + 1 == start)
+        runs.back().end = end;
+    else
+        runs.push_back({start, end, state});
+}
+
 UIDataCache::~UIDataCache()
 {
     stop();
@@ -33,6 +121,9 @@ void UIDataCache::stop()
     m_running.store(false);
     if (m_thread.joinable())
         m_thread.join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_replica.clear();
 }
 
 // ─── Main thread setters ─────────────────────────────────────────────────────
@@ -51,6 +142,7 @@ void UIDataCache::setJobIds(const std::vector<std::string>& ids)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_jobIds = ids;
+    m_replica.retain({ids.begin(), ids.end()});
 }
 
 void UIDataCache::setLogRequest(const std::string& mode,
@@ -61,63 +153,113 @@ void UIDataCache::setLogRequest(const std::string& mode,
     m_logNodeIds = nodeIds;
 }
 
-void UIDataCache::setDispatchTables(const std::map<std::string, DispatchTable>& tables)
+void UIDataCache::mergeDispatchTables(std::map<std::string, DispatchTable> changed,
+                                      const std::vector<std::string>& released,
+                                      const std::map<std::string, JobProgress>& progress)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_coordinatorTables = tables;
     m_hasCoordinatorTables = true;
 
+    for (const auto& jobId : released)
+        m_coordinatorTables.erase(jobId);
+
     // Coordinator fast path: merge progress for coordinator-tracked jobs only
     // (non-coordinator jobs like completed ones are handled by bg thread from disk)
-    for (const auto& [jobId, dt] : tables)
+    for (const auto& [jobId, prog] : progress)
+        setProgress(jobId, prog);  // merge, not replace
+
+    // Frame states for the selected job, if its table is among the changed
+    bool selectedChanged = !m_selectedJobId.empty() && changed.count(m_selectedJobId);
+    for (auto& [jobId, dt] : changed)
+        m_coordinatorTables[jobId] = std::move(dt);
+    if (selectedChanged)
+        setFrameStates(frameStatesOf(m_selectedJobId, m_coordinatorTables[m_selectedJobId]));
+}
+
+void UIDataCache::setProgress(const std::string& jobId, const JobProgress& progress)
+{
+    auto [it, inserted] = m_progress.try_emplace(jobId, progress);
+    if (!inserted && it->second == progress)
+        return;
+    it->second = progress;
+    ++m_progressVersion;
+}
+
+void UIDataCache::setFrameStates(FrameStateSnapshot snap)
+{
+    m_frameStates = std::make_shared<const FrameStateSnapshot>(std::move(snap));
+}
+
+std::map<std::string, DispatchTable> UIDataCache::replicatedTables(
+    const std::vector<std::string>& jobIds) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<std::string, DispatchTable> tables;
+    for (const auto& jobId : jobIds)
     {
-        JobProgress prog;
-        for (const auto& dc : dt.chunks)
-        {
-            int count = dc.frame_end - dc.frame_start + 1;
-            prog.total += count;
-            if (dc.state == "completed")
-                prog.completed += count;
-            else if (dc.state == "assigned")
-                prog.rendering += count;
-            else if (dc.state == "failed")
-                prog.failed += count;
-        }
-        m_progress[jobId] = prog;  // merge, not replace
+        if (const auto* dt = m_replica.table(jobId))
+            tables[jobId] = *dt;
     }
+    return tables;
+}
 
-    // Frame states for selected job
-    if (!m_selectedJobId.empty())
+void UIDataCache::clearDispatchTables()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_coordinatorTables.clear();
+    m_hasCoordinatorTables = false;
+    m_replica.clear();
+}
+
+void UIDataCache::seedProgress(const std::map<std::string, JobProgress>& progress)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [jobId, p] : progress)
+        setProgress(jobId, p);
+}
+
+void UIDataCache::applyReplicaMessage(const nlohmann::json& msg)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_hasCoordinatorTables)
+        return;     // we are the source
+
+    for (const auto& jobId : m_replica.apply(msg))
     {
-        auto it = tables.find(m_selectedJobId);
-        if (it != tables.end())
+        if (const auto* dt = m_replica.table(jobId))
         {
-            FrameStateSnapshot snap;
-            snap.jobId = m_selectedJobId;
-            snap.chunks = it->second.chunks;
-            for (const auto& dc : it->second.chunks)
-            {
-                std::string state = "unclaimed";
-                if (dc.state == "assigned") state = "rendering";
-                else if (dc.state == "completed") state = "completed";
-                else if (dc.state == "failed") state = "failed";
-                for (int f = dc.frame_start; f <= dc.frame_end; ++f)
-                    snap.frameStates.push_back({f, state});
-            }
-            m_frameStates = std::move(snap);
+            setProgress(jobId, progressOf(*dt));
+            if (jobId == m_selectedJobId)
+                setFrameStates(frameStatesOf(jobId, *dt));
+        }
+        else if (const auto* dg = m_replica.digest(jobId, DispatchReplica::DIGEST_FRESH_MS))
+        {
+            // No per-chunk states in a digest: rendering chunks at the average chunk size
+            int running = dg->total > 0 ? int(int64_t(dg->rendering) * int64_t(dg->chunks) / dg->total) : 0;
+            if (dg->rendering > 0)
+                running = (std::max)(running, 1);
+            setProgress(jobId, {dg->completed, dg->total, dg->rendering, dg->failed, running});
         }
     }
 }
 
 // ─── Main thread getters ─────────────────────────────────────────────────────
 
-std::map<std::string, UIDataCache::JobProgress> UIDataCache::getProgressSnapshot() const
+UIDataCache::ProgressSnapshotPtr UIDataCache::getProgressSnapshot() const
 {
     std::lock_guard<std::mutex> lock(m_mutex);
-    return m_progress;
+    if (m_progressSnapshot->version != m_progressVersion)
+        m_progressSnapshot = std::make_shared<const ProgressSnapshot>(ProgressSnapshot{m_progressVersion, m_progress});
+    return m_progressSnapshot;
 }
 
-UIDataCache::FrameStateSnapshot UIDataCache::getFrameStateSnapshot() const
+RenderEstimatesPtr UIDataCache::renderEstimates() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_estimates;
+}
+
+UIDataCache::FrameStateSnapshotPtr UIDataCache::getFrameStateSnapshot() const
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     return m_frameStates;
@@ -156,6 +298,7 @@ void UIDataCache::threadFunc()
             scanFrameStates(wake);
             scanTaskOutput(wake);
             scanRemoteLogs();
+            scanMetrics();
         }
         catch (const std::exception& e)
         {
@@ -172,6 +315,7 @@ void UIDataCache::threadFunc()
 
 void UIDataCache::scanProgress()
 {
+    SR_PERF_SCOPE("uicache.progress");
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastProgressScan).count();
     if (elapsed < 5000) return;
@@ -181,6 +325,7 @@ void UIDataCache::scanProgress()
     std::vector<std::string> jobIds;
     bool hasCoordTables = false;
     std::set<std::string> coordJobIds;
+    std::set<std::string> replicatedJobIds;
     {
         std::lock_guard<std::mutex> lock(m_mutex);
         jobIds = m_jobIds;
@@ -190,53 +335,50 @@ void UIDataCache::scanProgress()
             for (const auto& [k, v] : m_coordinatorTables)
                 coordJobIds.insert(k);
         }
+        for (const auto& jobId : jobIds)
+        {
+            if (m_replica.table(jobId) || m_replica.digest(jobId, DispatchReplica::DIGEST_FRESH_MS))
+                replicatedJobIds.insert(jobId);
+        }
     }
 
-    std::map<std::string, JobProgress> diskProgress;
+    std::map<std::string, DispatchTable> diskTables;
 
     for (const auto& jobId : jobIds)
     {
-        // Skip coordinator-tracked jobs — main thread handles those in setDispatchTables()
+        // Skip coordinator-tracked jobs — main thread handles those in mergeDispatchTables()
         if (hasCoordTables && coordJobIds.count(jobId))
             continue;
 
-        // Read from disk for non-coordinator jobs (completed, pending, etc.)
-        auto dispatchPath = m_farmPath / "jobs" / jobId / "dispatch.json";
-        auto data = AtomicFileIO::safeReadJson(dispatchPath);
-        if (!data.has_value())
+        // Live over multicast — applyReplicaMessage() keeps these current
+        if (replicatedJobIds.count(jobId))
             continue;
 
-        try
-        {
-            DispatchTable dt = data.value().get<DispatchTable>();
-            JobProgress prog;
-            for (const auto& dc : dt.chunks)
-            {
-                int count = dc.frame_end - dc.frame_start + 1;
-                prog.total += count;
-                if (dc.state == "completed")
-                    prog.completed += count;
-                else if (dc.state == "assigned")
-                    prog.rendering += count;
-                else if (dc.state == "failed")
-                    prog.failed += count;
-            }
-            diskProgress[jobId] = prog;
-        }
-        catch (...) {}
+        // Read from disk for non-coordinator jobs (completed, pending, etc.)
+        auto loaded = DispatchJournal::load(m_farmPath / "jobs" / jobId);
+        if (!loaded.has_value())
+            continue;
+        diskTables[jobId] = std::move(loaded.value());
     }
 
     // Merge under lock: only update non-coordinator entries, never touch coordinator entries
     std::lock_guard<std::mutex> lock(m_mutex);
-    for (auto& [jobId, prog] : diskProgress)
-        m_progress[jobId] = prog;
+    for (const auto& [jobId, dt] : diskTables)
+    {
+        setProgress(jobId, progressOf(dt));
+        if (!hasCoordTables)
+            m_replica.seed(jobId, dt);
+    }
 
     // Prune entries for jobs that no longer exist in the job list
     std::set<std::string> jobIdSet(jobIds.begin(), jobIds.end());
     for (auto it = m_progress.begin(); it != m_progress.end(); )
     {
         if (jobIdSet.find(it->first) == jobIdSet.end())
+        {
             it = m_progress.erase(it);
+            ++m_progressVersion;
+        }
         else
             ++it;
     }
@@ -246,6 +388,7 @@ void UIDataCache::scanProgress()
 
 void UIDataCache::scanFrameStates(bool force)
 {
+    SR_PERF_SCOPE("uicache.frameStates");
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastFrameScan).count();
     if (!force && elapsed < 3000) return;
@@ -260,16 +403,33 @@ void UIDataCache::scanFrameStates(bool force)
         jobId = m_selectedJobId;
         hasCoordTables = m_hasCoordinatorTables;
         if (hasCoordTables && !jobId.empty())
-            jobIsCoordTracked = (m_coordinatorTables.find(jobId) != m_coordinatorTables.end());
+        {
+            auto it = m_coordinatorTables.find(jobId);
+            jobIsCoordTracked = it != m_coordinatorTables.end();
+
+            // Newly selected: its table may not change again for a while
+            if (jobIsCoordTracked && m_frameStates->jobId != jobId)
+                setFrameStates(frameStatesOf(jobId, it->second));
+        }
+
+        // Trusted multicast replica: the grid is kept live by applyReplicaMessage()
+        if (!jobIsCoordTracked && !jobId.empty())
+        {
+            if (const auto* dt = m_replica.table(jobId))
+            {
+                setFrameStates(frameStatesOf(jobId, *dt));
+                return;
+            }
+        }
     }
 
-    // Coordinator tracks this job → main thread handles it in setDispatchTables()
+    // Coordinator tracks this job → main thread handles it in mergeDispatchTables()
     if (jobIsCoordTracked) return;
 
     if (jobId.empty())
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_frameStates = {};
+        setFrameStates({});
         return;
     }
 
@@ -280,61 +440,60 @@ void UIDataCache::scanFrameStates(bool force)
     DispatchTable dt;
     bool gotTable = false;
 
-    auto dispatchPath = m_farmPath / "jobs" / jobId / "dispatch.json";
-    auto data = AtomicFileIO::safeReadJson(dispatchPath);
-    if (data.has_value())
+    // Snapshot + journal replay (coordinator appends deltas between compactions)
+    if (auto loaded = DispatchJournal::load(m_farmPath / "jobs" / jobId))
     {
-        try { dt = data.value().get<DispatchTable>(); gotTable = true; }
-        catch (...) {}
+        dt = std::move(loaded.value());
+        gotTable = true;
     }
 
     if (!gotTable)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_frameStates = snap;
+        setFrameStates(std::move(snap));
         return;
     }
 
-    snap.chunks = dt.chunks;
-
-    // Build frame state map
-    for (const auto& dc : dt.chunks)
+    if (!hasCoordTables)
     {
-        std::string state = "unclaimed";
-        if (dc.state == "assigned") state = "rendering";
-        else if (dc.state == "completed") state = "completed";
-        else if (dc.state == "failed") state = "failed";
-
-        for (int f = dc.frame_start; f <= dc.frame_end; ++f)
-            snap.frameStates.push_back({f, state});
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_replica.seed(jobId, dt);
     }
 
-    // Scan event files for per-frame completions within "assigned" chunks
-    std::error_code ec;
+    snap = frameStatesOf(jobId, dt);
+
+    // Per-frame completions within "assigned" chunks, from the nodes' event logs
+    auto& storage = FarmStorage::current();
     auto eventsBaseDir = m_farmPath / "jobs" / jobId / "events";
-    if (fs::is_directory(eventsBaseDir, ec))
+    if (m_eventScan.jobId != jobId)
+        m_eventScan = EventScan{jobId, {}, {}};
+
+    if (storage.isDirectory(eventsBaseDir))
     {
-        // Build set of frames currently assigned
-        std::set<int> assignedFrames;
-        for (const auto& dc : dt.chunks)
+        if (snap.count(FrameState::Rendering) > 0)
         {
-            if (dc.state == "assigned")
+            std::set<int> legacyFrames;
+            for (const auto& nodeEntry : storage.list(eventsBaseDir))
             {
-                for (int f = dc.frame_start; f <= dc.frame_end; ++f)
-                    assignedFrames.insert(f);
-            }
-        }
+                if (!nodeEntry.isDir) continue;
+                auto nodeDir = eventsBaseDir / nodeEntry.name;
 
-        if (!assignedFrames.empty())
-        {
-            std::set<int> completedFrames;
-            for (const auto& nodeDir : fs::directory_iterator(eventsBaseDir, ec))
-            {
-                if (!nodeDir.is_directory(ec)) continue;
-                for (const auto& entry : fs::directory_iterator(nodeDir.path(), ec))
+                // Segmented log: resume from this node's byte offset
+                if (EventLogReader::exists(nodeDir))
+                {
+                    auto& cursor = m_eventScan.cursors[nodeEntry.name];
+                    EventLogReader::readSince(nodeDir, cursor, [this](const nlohmann::json& ev) {
+                        if (ev.value("type", "") == "frame_finished")
+                            m_eventScan.finishedFrames.insert(ev.value("frame_start", 0));
+                    });
+                    continue;
+                }
+
+                // Legacy one-file-per-event layout (jobs started on older builds)
+                for (const auto& entry : storage.list(nodeDir))
                 {
-                    if (entry.path().extension() != ".json") continue;
-                    std::string stem = entry.path().stem().string();
+                    if (!entry.name.ends_with(".json")) continue;
+                    std::string stem = fs::path(entry.name).stem().string();
                     if (stem.find("_frame_finished_") == std::string::npos) continue;
 
                     auto pos = stem.find("_frame_finished_") + 16;
@@ -342,31 +501,42 @@ void UIDataCache::scanFrameStates(bool force)
                     if (dash == std::string::npos) continue;
                     try
                     {
-                        int frameNum = std::stoi(stem.substr(pos, dash - pos));
-                        if (assignedFrames.count(frameNum))
-                            completedFrames.insert(frameNum);
+                        legacyFrames.insert(std::stoi(stem.substr(pos, dash - pos)));
                     }
                     catch (...) {}
                 }
             }
 
-            // Upgrade assigned→completed for finished frames
-            for (auto& [frame, state] : snap.frameStates)
+            // Upgrade rendering→completed for finished frames (only rendering runs are split)
+            FrameStateSnapshot upgraded;
+            upgraded.jobId = std::move(snap.jobId);
+            upgraded.chunks = std::move(snap.chunks);
+            for (const auto& run : snap.runs)
             {
-                if (state == "rendering" && completedFrames.count(frame))
-                    state = "completed";
+                if (run.state != FrameState::Rendering)
+                {
+                    upgraded.append(run.start, run.end, run.state);
+                    continue;
+                }
+                for (int f = run.start; f <= run.end; ++f)
+                {
+                    bool finished = m_eventScan.finishedFrames.count(f) || legacyFrames.count(f);
+                    upgraded.append(f, f, finished ? FrameState::Completed : FrameState::Rendering);
+                }
             }
+            snap = std::move(upgraded);
         }
     }
 
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_frameStates = std::move(snap);
+    setFrameStates(std::move(snap));
 }
 
 // ─── Task output scanning ────────────────────────────────────────────────────
 
 void UIDataCache::scanTaskOutput(bool force)
 {
+    SR_PERF_SCOPE("uicache.taskOutput");
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastTaskOutputScan).count();
     if (!force && elapsed < 3000) return;
@@ -396,9 +566,11 @@ void UIDataCache::scanTaskOutput(bool force)
         std::string nodeId;
         std::string rangeStr;
         uint64_t timestamp_ms = 0;
+        int part = 0;
         fs::path path;
     };
     std::vector<LogFile> logFiles;
+    std::set<fs::path> compressed;  // finished logs; their plain copy may linger briefly
 
     if (fs::is_directory(stdoutDir, ec))
     {
@@ -411,34 +583,91 @@ void UIDataCache::scanTaskOutput(bool force)
             for (auto& fileEntry : fs::directory_iterator(nodeEntry.path(), ec2))
             {
                 if (!fileEntry.is_regular_file(ec2)) continue;
-                if (fileEntry.path().extension() != ".log") continue;
 
+                // {rangeStr}_{ts}[.pN].log[.gz]
                 std::string fname = fileEntry.path().filename().string();
+                bool gz = fname.size() > 3 && fname.compare(fname.size() - 3, 3, ".gz") == 0;
+                if (gz)
+                    fname.resize(fname.size() - 3);
+                if (fname.size() <= 4 || fname.compare(fname.size() - 4, 4, ".log") != 0)
+                    continue;
+                fname.resize(fname.size() - 4);
+
                 auto lastUnderscore = fname.rfind('_');
-                auto dotPos = fname.rfind('.');
-                if (lastUnderscore == std::string::npos || dotPos == std::string::npos)
+                if (lastUnderscore == std::string::npos)
                     continue;
 
                 std::string rangeStr = fname.substr(0, lastUnderscore);
-                std::string tsStr = fname.substr(lastUnderscore + 1, dotPos - lastUnderscore - 1);
+                std::string tsStr = fname.substr(lastUnderscore + 1);
+
+                int part = 0;
+                auto partPos = tsStr.find(".p");
+                if (partPos != std::string::npos)
+                {
+                    try { part = std::stoi(tsStr.substr(partPos + 2)); }
+                    catch (...) { continue; }
+                    tsStr.resize(partPos);
+                }
 
                 uint64_t ts = 0;
                 try { ts = std::stoull(tsStr); }
                 catch (...) { continue; }
 
-                logFiles.push_back({nodeId, rangeStr, ts, fileEntry.path()});
+                if (gz)
+                {
+                    auto plain = fileEntry.path();
+                    plain.replace_extension();
+                    compressed.insert(plain);
+                }
+                logFiles.push_back({nodeId, rangeStr, ts, part, fileEntry.path()});
             }
         }
     }
 
+    std::erase_if(logFiles, [&](const LogFile& lf) { return compressed.count(lf.path) > 0; });
+
     std::sort(logFiles.begin(), logFiles.end(),
               [](const LogFile& a, const LogFile& b) {
                   if (a.rangeStr != b.rangeStr) return a.rangeStr < b.rangeStr;
-                  return a.timestamp_ms < b.timestamp_ms;
+                  if (a.timestamp_ms != b.timestamp_ms) return a.timestamp_ms < b.timestamp_ms;
+                  return a.part < b.part;
               });
 
+    // Job switch: drop every cursor; otherwise forget logs that went away
+    if (jobId != m_tailJobId)
+    {
+        m_logTails.clear();
+        m_tailJobId = jobId;
+    }
+    std::set<fs::path> present;
+    for (const auto& lf : logFiles)
+        present.insert(lf.path);
+    std::erase_if(m_logTails, [&](const auto& kv) { return present.count(kv.first) == 0; });
+
+    auto emitTail = [&](const LogTail& tail) {
+        if (tail.dropped > 0)
+            snap.lines.push_back({"... " + std::to_string(tail.dropped) + " earlier lines not shown", false});
+        for (const auto& line : tail.lines)
+            snap.lines.push_back({line, false});
+        if (!tail.partial.empty())
+            snap.lines.push_back({tail.partial, false});
+    };
+
     for (const auto& lf : logFiles)
     {
+        auto& tail = m_logTails[lf.path];
+        readLogTail(lf.path, tail);
+
+        // Rotated parts continue the same log under one header
+        if (lf.part > 0)
+        {
+            if (!snap.lines.empty() && snap.lines.back().text.empty())
+                snap.lines.pop_back();
+            emitTail(tail);
+            snap.lines.push_back({"", false});
+            continue;
+        }
+
         time_t secs = static_cast<time_t>(lf.timestamp_ms / 1000);
         struct tm tmBuf;
 #ifdef _WIN32
@@ -452,12 +681,7 @@ void UIDataCache::scanTaskOutput(bool force)
 
         std::string header = lf.nodeId + "  |  f" + lf.rangeStr + "  |  " + timeBuf;
         snap.lines.push_back({header, true});
-
-        std::ifstream ifs(lf.path);
-        std::string line;
-        while (std::getline(ifs, line))
-            snap.lines.push_back({std::move(line), false});
-
+        emitTail(tail);
         snap.lines.push_back({"", false});
     }
 
@@ -465,10 +689,86 @@ void UIDataCache::scanTaskOutput(bool force)
     m_taskOutput = std::move(snap);
 }
 
+void UIDataCache::readLogTail(const fs::path& path, LogTail& tail)
+{
+    auto push = [&](std::string&& line) {
+        tail.lines.push_back(std::move(line));
+        if (tail.lines.size() > MAX_TAIL_LINES)
+        {
+            tail.lines.pop_front();
+            ++tail.dropped;
+        }
+    };
+
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    if (ec)
+        return;
+
+    // Finished (.gz) logs are written once; read whole, again only if the size moves
+    if (path.extension() == ".gz")
+    {
+        if (size == tail.offset)
+            return;
+        tail = {};
+        StdoutWriter::readLines(path, push);
+        tail.offset = size;
+        return;
+    }
+
+    if (size == tail.offset && !tail.head.empty())
+        return;
+
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open())
+        return;
+
+    // Shrunk or replaced: start over
+    bool restart = size < tail.offset;
+    if (!restart && !tail.head.empty())
+    {
+        std::string head(tail.head.size(), '\0');
+        ifs.read(head.data(), static_cast<std::streamsize>(head.size()));
+        restart = static_cast<size_t>(ifs.gcount()) != head.size() || head != tail.head;
+        ifs.clear();
+    }
+    if (restart)
+        tail = {};
+
+    if (size <= tail.offset)
+        return;
+
+    std::string data(size - tail.offset, '\0');
+    ifs.seekg(static_cast<std::streamoff>(tail.offset));
+    ifs.read(data.data(), static_cast<std::streamsize>(data.size()));
+    data.resize(static_cast<size_t>(ifs.gcount()));
+
+    if (tail.offset == 0)
+        tail.head = data.substr(0, TAIL_HEAD_BYTES);
+    tail.offset += data.size();
+
+    size_t start = 0;
+    while (true)
+    {
+        auto nl = data.find('\n', start);
+        if (nl == std::string::npos)
+            break;
+        std::string line = std::move(tail.partial);
+        tail.partial.clear();
+        line.append(data, start, nl - start);
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        push(std::move(line));
+        start = nl + 1;
+    }
+    tail.partial.append(data, start, std::string::npos);
+}
+
 // ─── Remote log scanning ─────────────────────────────────────────────────────
 
 void UIDataCache::scanRemoteLogs()
 {
+    SR_PERF_SCOPE("uicache.remoteLogs");
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastRemoteLogScan).count();
     if (elapsed < 5000) return;
@@ -509,4 +809,21 @@ void UIDataCache::scanRemoteLogs()
     m_remoteLogs = std::move(snap);
 }
 
+// ─── Render metrics ──────────────────────────────────────────────────────────
+
+void UIDataCache::scanMetrics()
+{
+    SR_PERF_SCOPE("uicache.metrics");
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastMetricsScan).count();
+    if (elapsed < METRICS_SCAN_MS) return;
+    m_lastMetricsScan = now;
+
+    m_metrics.refresh(m_farmPath / "metrics");
+    auto estimates = m_metrics.estimates();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_estimates = std::move(estimates);
+}
+
 } // namespace SR
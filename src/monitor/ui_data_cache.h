@@ -1,10 +1,18 @@
 #pragma once
 
 #include "core/job_types.h"
+#include "core/event_log.h"
+#include "core/render_metrics.h"
+#include "monitor/dispatch_replica.h"
 
+#include <array>
+#include <cstdint>
+#include <deque>
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <thread>
 #include <atomic>
@@ -30,20 +38,72 @@ public:
     void setLogRequest(const std::string& mode,
                        const std::vector<std::string>& nodeIds);
 
-    // Coordinator shortcut: inject dispatch tables (avoids disk read)
-    void setDispatchTables(const std::map<std::string, DispatchTable>& tables);
+    // Workers/viewers: dispatch delta or digest multicast by the coordinator
+    void applyReplicaMessage(const nlohmann::json& msg);
 
-    // Main thread reads snapshots
-    struct JobProgress { int completed = 0; int total = 0; int rendering = 0; int failed = 0; };
-    std::map<std::string, JobProgress> getProgressSnapshot() const;
+    // Standby takeover: copies of the replica tables a digest has verified
+    std::map<std::string, DispatchTable> replicatedTables(const std::vector<std::string>& jobIds) const;
+
+    // Coordinator stepped down: back to the replica stream and disk
+    void clearDispatchTables();
+
+    // Main thread reads snapshots. Each is immutable and only rebuilt after
+    // something in it changed, so polling them every frame copies nothing.
+    struct JobProgress
+    {
+        int completed = 0; int total = 0; int rendering = 0; int failed = 0; int renderingChunks = 0;
+        bool operator==(const JobProgress&) const = default;
+    };
+    struct ProgressSnapshot
+    {
+        uint64_t version = 0;
+        std::map<std::string, JobProgress> jobs;
+    };
+    using ProgressSnapshotPtr = std::shared_ptr<const ProgressSnapshot>;
+    ProgressSnapshotPtr getProgressSnapshot() const;
+
+    // Last-known progress from the farm index, shown until the first scan
+    // reads the dispatch tables
+    void seedProgress(const std::map<std::string, JobProgress>& progress);
+
+    // Coordinator shortcut: inject dispatch tables (avoids disk read). Only
+    // the tables that changed, with their progress already counted; the
+    // others are kept from earlier calls. Released tables (handed to another
+    // shard) go back to being read from disk.
+    void mergeDispatchTables(std::map<std::string, DispatchTable> changed,
+                             const std::vector<std::string>& released,
+                             const std::map<std::string, JobProgress>& progress);
+
+    // Throughput model built from every node's metrics file (never null).
+    // Also feeds the coordinator's node-speed model, so safe from any thread.
+    RenderEstimatesPtr renderEstimates() const;
+
+    enum class FrameState : uint8_t { Unclaimed, Rendering, Completed, Failed };
+    static constexpr size_t FRAME_STATE_COUNT = 4;
+    static const char* frameStateName(FrameState state);
+
+    // Consecutive frames in one state; a job is a handful of these, not one entry per frame
+    struct FrameRun
+    {
+        int start = 0;
+        int end = 0;    // inclusive
+        FrameState state = FrameState::Unclaimed;
+    };
 
     struct FrameStateSnapshot
     {
         std::string jobId;
-        std::vector<std::pair<int, std::string>> frameStates;  // frame → state string
+        std::vector<FrameRun> runs;                     // ascending, neighbours differ in state
+        std::array<int, FRAME_STATE_COUNT> counts{};    // frames per FrameState
         std::vector<DispatchChunk> chunks;
+
+        bool empty() const { return runs.empty(); }
+        int frameCount() const;
+        int count(FrameState state) const { return counts[size_t(state)]; }
+        void append(int start, int end, FrameState state);  // after the last run
     };
-    FrameStateSnapshot getFrameStateSnapshot() const;
+    using FrameStateSnapshotPtr = std::shared_ptr<const FrameStateSnapshot>;
+    FrameStateSnapshotPtr getFrameStateSnapshot() const;
 
     struct TaskOutputLine
     {
@@ -70,6 +130,9 @@ private:
     void scanFrameStates(bool force = false);
     void scanTaskOutput(bool force = false);
     void scanRemoteLogs();
+    void scanMetrics();
+    void setProgress(const std::string& jobId, const JobProgress& progress);   // caller holds m_mutex
+    void setFrameStates(FrameStateSnapshot snap);                              // caller holds m_mutex
 
     std::thread m_thread;
     std::atomic<bool> m_running{false};
@@ -83,21 +146,54 @@ private:
     std::vector<std::string> m_logNodeIds;
     bool m_hasCoordinatorTables = false;
     std::map<std::string, DispatchTable> m_coordinatorTables;
+    DispatchReplica m_replica;      // multicast copy; stands in for disk reads when valid
 
     // Output snapshots (written by bg thread under lock)
     std::map<std::string, JobProgress> m_progress;
-    FrameStateSnapshot m_frameStates;
+    uint64_t m_progressVersion = 0;     // bumped when an entry of m_progress changes
+    mutable ProgressSnapshotPtr m_progressSnapshot = std::make_shared<const ProgressSnapshot>();
+    FrameStateSnapshotPtr m_frameStates = std::make_shared<const FrameStateSnapshot>();
     TaskOutputSnapshot m_taskOutput;
     RemoteLogSnapshot m_remoteLogs;
+    RenderEstimatesPtr m_estimates = std::make_shared<RenderEstimates>();
 
     // Wake flag: set by main thread to break bg thread out of sleep early
     std::atomic<bool> m_wakeFlag{false};
 
+    // Selected job's event logs, read incrementally (bg thread only)
+    struct EventScan
+    {
+        std::string jobId;
+        std::map<std::string, EventLogCursor> cursors;  // nodeId -> position
+        std::set<int> finishedFrames;
+    };
+    EventScan m_eventScan;
+
+    // Selected job's stdout logs, tailed by byte offset (bg thread only)
+    struct LogTail
+    {
+        uint64_t offset = 0;            // bytes consumed (plain) / size read (.gz)
+        std::string head;               // first bytes, to spot a replaced file
+        std::string partial;            // trailing bytes without a newline yet
+        std::deque<std::string> lines;  // last MAX_TAIL_LINES lines
+        uint64_t dropped = 0;           // older lines no longer held
+    };
+    void readLogTail(const std::filesystem::path& path, LogTail& tail);
+    std::string m_tailJobId;
+    std::map<std::filesystem::path, LogTail> m_logTails;
+    static constexpr size_t MAX_TAIL_LINES = 5000;
+    static constexpr size_t TAIL_HEAD_BYTES = 64;
+
+    // Every node's chunk samples (bg thread only)
+    RenderMetrics m_metrics;
+    static constexpr int64_t METRICS_SCAN_MS = 15000;
+
     // Scan timers (bg thread only, no lock needed)
     std::chrono::steady_clock::time_point m_lastProgressScan{};
     std::chrono::steady_clock::time_point m_lastFrameScan{};
     std::chrono::steady_clock::time_point m_lastTaskOutputScan{};
     std::chrono::steady_clock::time_point m_lastRemoteLogScan{};
+    std::chrono::steady_clock::time_point m_lastMetricsScan{};
 };
 
 } // namespace SR
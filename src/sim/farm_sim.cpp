@@ -0,0 +1,673 @@
+// Deterministic farm simulator — drives DispatchManager with synthetic nodes
+// and jobs on a virtual clock, and reports utilization, chunk/job turnaround
+// and coordinator CPU per tick. Used to tune TimingConfig presets and to
+// check scheduler changes without real machines.
+//
+//   sr_farmsim --nodes 50 --jobs 200 --frames 50 --chunk 5 --policy 1
+
+#include "monitor/dispatch_manager.h"
+#include "core/config.h"
+#include "core/farm_storage.h"
+#include "core/render_metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace SR;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct SimOptions
+{
+    int nodes = 50;
+    int jobs = 200;
+    int frames = 50;                // average frames per job (each job gets 0.5x-1.5x)
+    int chunkSize = 5;
+    int targetChunkSec = 0;         // > 0 = adaptive chunk sizing
+    int tiles = 0;                  // > 1 = every job is one still split tiles x tiles
+    int stages = 1;                 // > 1 = jobs form chains, each stage depending on the last
+    bool stageFrames = true;        // chain dependencies are per frame (else whole job)
+    int urgentEvery = 0;            // > 0 = every Nth job is priority 100, the rest 10
+    int preemptSec = 0;             // PreemptionPolicy::wait_s (0 = off)
+    double msPerFrame = 30000.0;    // render time of one frame on a 1.0-speed node
+    double speedSpread = 0.5;       // node speed uniform in [1 - spread, 1 + spread]
+    double failRate = 0.01;         // chance a chunk fails (after half its render time)
+    int arrivalSec = 0;             // jobs arrive uniformly over this window
+    int tickMs = 1000;              // virtual time between dispatch cycles
+    int64_t maxSimMs = int64_t(30) * 24 * 3600 * 1000;
+    TimingPreset preset = TimingPreset::LocalNAS;
+    SchedulingPolicy policy = SchedulingPolicy::Priority;
+    bool affinity = true;
+    bool speedModel = true;         // feed completions to the node-speed model
+    int prefetch = 1;
+    bool diskFarm = false;          // farm in the temp dir instead of MemoryStorage
+    double ioMs = 0.0;              // LatencyStorage per-op latency (0 = no wrapper)
+    double ioJitterMs = 0.0;
+    uint32_t seed = 1;
+};
+
+struct SimChunk
+{
+    std::string jobId;
+    ChunkRange range;
+    int64_t assignedMs = 0;
+};
+
+struct SimNode
+{
+    std::string id;
+    double speed = 1.0;
+    std::deque<SimChunk> queue;     // front is rendering once activeEndMs > 0
+    int64_t activeStartMs = 0;
+    int64_t activeEndMs = 0;
+    bool activeFails = false;
+    int64_t busyMs = 0;
+};
+
+struct SimJob
+{
+    JobInfo info;
+    int64_t arriveMs = 0;
+    int64_t doneMs = 0;
+    int framesLeft = 0;
+    bool arrived = false;
+    std::set<std::pair<int, int>> completed;   // ranges already counted (speculative duplicates)
+};
+
+double percentile(std::vector<double> v, double p)
+{
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t i = (size_t)std::clamp(p * double(v.size() - 1), 0.0, double(v.size() - 1));
+    return v[i];
+}
+
+double mean(const std::vector<double>& v)
+{
+    if (v.empty()) return 0.0;
+    double sum = 0.0;
+    for (double x : v) sum += x;
+    return sum / double(v.size());
+}
+
+class FarmSim
+{
+public:
+    explicit FarmSim(const SimOptions& opt) : m_opt(opt), m_rng(opt.seed) {}
+
+    int run();
+
+private:
+    void buildFarm();
+    void publishJobs();
+    void onCommand(const std::string& target, const std::string& type,
+                   const std::string& jobId, int frameStart, int frameEnd);
+    void advanceNodes(int64_t untilMs);
+    void startNext(SimNode& node, int64_t atMs);
+    void finishChunk(SimNode& node);
+    NodeSnapshotPtr nodeSnapshot();
+    void report(int64_t wallMs) const;
+
+    SimOptions m_opt;
+    std::mt19937 m_rng;
+    int64_t m_now = 0;
+    fs::path m_farmPath;
+    std::shared_ptr<LatencyStorage> m_latency;
+    double m_tickIoMs = 0.0;        // injected latency during the current tick
+    std::vector<double> m_ioMsPerTick;
+
+    std::vector<SimNode> m_nodes;
+    std::vector<SimJob> m_jobs;
+    std::unordered_map<std::string, size_t> m_jobIndex;
+    JobSnapshotPtr m_snapshot = std::make_shared<const JobSnapshot>();
+    NodeSnapshotPtr m_nodeSnapshot = std::make_shared<const NodeSnapshot>();
+    uint64_t m_snapshotVersion = 0;
+    bool m_jobsChanged = false;
+
+    DispatchManager m_dispatch;
+    std::vector<CommandManager::Action> m_reports;   // delivered on the next tick
+    RenderMetrics m_renderMetrics;                  // what the nodes' metrics files would hold
+
+    // Metrics
+    std::vector<double> m_tickUs;
+    std::vector<double> m_chunkTurnaroundSec;
+    int m_assigns = 0;
+    int m_aborts = 0;
+    int m_failures = 0;
+};
+
+void FarmSim::buildFarm()
+{
+    std::uniform_real_distribution<double> speed(1.0 - m_opt.speedSpread, 1.0 + m_opt.speedSpread);
+    for (int i = 0; i < m_opt.nodes; ++i)
+    {
+        SimNode node;
+        node.id = "sim-node-" + std::to_string(i);
+        node.speed = (std::max)(0.05, speed(m_rng));
+        m_nodes.push_back(std::move(node));
+    }
+
+    std::uniform_real_distribution<double> size(0.5, 1.5);
+    std::uniform_int_distribution<int> arrive(0, (std::max)(0, m_opt.arrivalSec));
+    for (int i = 0; i < m_opt.jobs; ++i)
+    {
+        SimJob job;
+        auto& m = job.info.manifest;
+        m.job_id = "sim-job-" + std::to_string(i);
+        m.submitted_by = "sim-user-" + std::to_string(i % 4);
+        m.template_id = "sim";
+        m.cmd["windows"] = "render.exe";
+        m.cmd["linux"] = "render";
+        m.cmd["macos"] = "render";
+        m.frame_start = 1;
+        m.frame_end = (std::max)(1, (int)std::lround(m_opt.frames * size(m_rng)));
+        m.chunk_size = m_opt.chunkSize;
+        if (m_opt.targetChunkSec > 0)
+            m.target_chunk_seconds = m_opt.targetChunkSec;
+        if (m_opt.tiles > 1)
+        {
+            // As TemplateManager::applyTileSplit: one unit per tile plus the merge
+            m.tiles.cols = m.tiles.rows = m_opt.tiles;
+            m.tiles.merge_args = {"merge"};
+            m.frame_end = m.tiles.mergeUnit();
+            m.chunk_size = 1;
+            m.target_chunk_seconds.reset();
+        }
+
+        job.arriveMs = m_opt.arrivalSec > 0 ? int64_t(arrive(m_rng)) * 1000 : 0;
+        if (m_opt.urgentEvery > 0)
+            job.info.current_priority = (i % m_opt.urgentEvery == m_opt.urgentEvery - 1) ? 100 : 10;
+
+        // Later stages of a chain: the same frames, submitted with the first
+        if (m_opt.stages > 1 && i % m_opt.stages != 0)
+        {
+            const auto& prev = m_jobs.back();
+            m.frame_end = prev.info.manifest.frame_end;
+            job.arriveMs = prev.arriveMs;
+            m.depends_on.push_back({prev.info.manifest.job_id, m_opt.stageFrames});
+        }
+        job.framesLeft = m.frame_end - m.frame_start + 1;
+        m.submitted_at_ms = job.arriveMs;
+
+        m_jobIndex[m.job_id] = m_jobs.size();
+        m_jobs.push_back(std::move(job));
+    }
+
+    // Same order JobManager publishes: priority desc, then submission time
+    std::stable_sort(m_jobs.begin(), m_jobs.end(), [](const SimJob& a, const SimJob& b)
+    {
+        if (a.info.current_priority != b.info.current_priority)
+            return a.info.current_priority > b.info.current_priority;
+        return a.arriveMs < b.arriveMs;
+    });
+    m_jobIndex.clear();
+    for (size_t i = 0; i < m_jobs.size(); ++i)
+        m_jobIndex[m_jobs[i].info.manifest.job_id] = i;
+}
+
+void FarmSim::publishJobs()
+{
+    auto snap = std::make_shared<JobSnapshot>();
+    snap->version = ++m_snapshotVersion;
+    for (const auto& job : m_jobs)
+    {
+        if (!job.arrived) continue;
+        snap->index[job.info.manifest.job_id] = snap->jobs.size();
+        snap->jobs.push_back(job.info);
+    }
+    m_snapshot = std::move(snap);
+    m_jobsChanged = false;
+}
+
+void FarmSim::onCommand(const std::string& target, const std::string& type,
+                        const std::string& jobId, int frameStart, int frameEnd)
+{
+    auto it = std::find_if(m_nodes.begin(), m_nodes.end(),
+        [&](const SimNode& n) { return n.id == target; });
+    if (it == m_nodes.end()) return;
+    auto& node = *it;
+    ChunkRange range{frameStart, frameEnd};
+
+    if (type == "assign_chunk")
+    {
+        node.queue.push_back({jobId, range, m_now});
+        ++m_assigns;
+    }
+    else if (type == "abort_chunk")
+    {
+        for (size_t i = 0; i < node.queue.size(); ++i)
+        {
+            if (node.queue[i].jobId != jobId || !(node.queue[i].range == range))
+                continue;
+            if (i == 0 && node.activeEndMs > 0)
+            {
+                node.busyMs += m_now - node.activeStartMs;
+                node.activeEndMs = 0;
+            }
+            node.queue.erase(node.queue.begin() + i);
+            ++m_aborts;
+            break;
+        }
+    }
+}
+
+void FarmSim::startNext(SimNode& node, int64_t atMs)
+{
+    if (node.queue.empty() || node.activeEndMs > 0)
+        return;
+
+    const auto& chunk = node.queue.front();
+    int frames = chunk.range.frame_end - chunk.range.frame_start + 1;
+    std::uniform_real_distribution<double> jitter(0.9, 1.1);
+    std::uniform_real_distribution<double> roll(0.0, 1.0);
+
+    double durMs = m_opt.msPerFrame * frames / node.speed * jitter(m_rng);
+    const auto& tiles = m_jobs[m_jobIndex[chunk.jobId]].info.manifest.tiles;
+    if (tiles.enabled())    // a tile is its share of the still; the merge a few percent
+        durMs *= tiles.isMerge(chunk.range.frame_start) ? 0.02 : 1.0 / tiles.count();
+    node.activeFails = roll(m_rng) < m_opt.failRate;
+    if (node.activeFails)
+        durMs *= 0.5;
+    node.activeStartMs = atMs;
+    node.activeEndMs = atMs + (std::max)(int64_t(1), (int64_t)durMs);
+}
+
+void FarmSim::finishChunk(SimNode& node)
+{
+    auto chunk = node.queue.front();
+    node.queue.pop_front();
+    node.busyMs += node.activeEndMs - node.activeStartMs;
+
+    CommandManager::Action action;
+    action.type = node.activeFails ? "chunk_failed" : "chunk_completed";
+    action.jobId = chunk.jobId;
+    action.frameStart = chunk.range.frame_start;
+    action.frameEnd = chunk.range.frame_end;
+    action.fromNodeId = node.id;
+
+    // A failure lands halfway through: the first half of the frames finished
+    ChunkRange done = chunk.range;
+    if (node.activeFails)
+    {
+        int frames = chunk.range.frame_end - chunk.range.frame_start + 1;
+        done.frame_end = chunk.range.frame_start + frames / 2 - 1;
+        std::set<int> doneFrames;
+        for (int f = done.frame_start; f <= done.frame_end; ++f)
+            doneFrames.insert(f);
+        action.framesDone = formatFrameSet(doneFrames);
+    }
+    m_reports.push_back(action);
+
+    if (node.activeFails)
+    {
+        ++m_failures;
+    }
+    else
+    {
+        m_chunkTurnaroundSec.push_back(double(node.activeEndMs - chunk.assignedMs) / 1000.0);
+        const auto& manifest = m_jobs[m_jobIndex[chunk.jobId]].info.manifest;
+        if (!manifest.tiles.isMerge(chunk.range.frame_start))
+        {
+            ChunkMetric metric;
+            metric.timestamp_ms = node.activeEndMs;
+            metric.node_id = node.id;
+            metric.job_id = chunk.jobId;
+            metric.template_id = manifest.template_id;
+            metric.frames = chunk.range.frame_end - chunk.range.frame_start + 1;
+            metric.wall_ms = node.activeEndMs - node.activeStartMs;
+            metric.tile = manifest.tiles.enabled();
+            m_renderMetrics.add(metric);
+        }
+    }
+
+    if (done.frame_end >= done.frame_start)
+    {
+        auto& job = m_jobs[m_jobIndex[chunk.jobId]];
+        if (job.completed.insert({done.frame_start, done.frame_end}).second)
+        {
+            job.framesLeft -= done.frame_end - done.frame_start + 1;
+            if (job.framesLeft <= 0 && job.doneMs == 0)
+            {
+                job.doneMs = node.activeEndMs;
+                job.info.current_state = "completed";
+                m_jobsChanged = true;
+            }
+        }
+    }
+
+    node.activeEndMs = 0;
+}
+
+void FarmSim::advanceNodes(int64_t untilMs)
+{
+    for (auto& node : m_nodes)
+    {
+        // Chunks assigned this tick start now; a fast node can finish several
+        // short chunks (and start its prefetched ones) before the next tick
+        startNext(node, m_now);
+        while (node.activeEndMs > 0 && node.activeEndMs <= untilMs)
+        {
+            int64_t endMs = node.activeEndMs;
+            finishChunk(node);
+            startNext(node, endMs);
+        }
+    }
+}
+
+NodeSnapshotPtr FarmSim::nodeSnapshot()
+{
+    std::vector<NodeInfo> nodes;
+    nodes.reserve(m_nodes.size());
+    for (const auto& n : m_nodes)
+    {
+        NodeInfo info;
+        info.heartbeat.node_id = n.id;
+        info.heartbeat.os = "linux";
+        info.heartbeat.node_state = "active";
+        info.heartbeat.render_state = n.activeEndMs > 0 ? "rendering" : "idle";
+        info.heartbeat.free_slots = n.activeEndMs > 0 ? 0 : 1;
+        if (n.activeEndMs > 0)
+            info.heartbeat.active_job = n.queue.front().jobId;
+        info.isDead = false;
+        info.reclaimEligible = false;
+        nodes.push_back(std::move(info));
+    }
+
+    // A new version only when a node changed, as HeartbeatManager publishes
+    const auto& prev = m_nodeSnapshot->nodes;
+    bool same = prev.size() == nodes.size() &&
+        std::equal(nodes.begin(), nodes.end(), prev.begin(), [](const NodeInfo& a, const NodeInfo& b)
+        {
+            return a.heartbeat.node_id == b.heartbeat.node_id &&
+                   a.heartbeat.render_state == b.heartbeat.render_state &&
+                   a.heartbeat.free_slots == b.heartbeat.free_slots &&
+                   a.heartbeat.active_job == b.heartbeat.active_job;
+        });
+    if (!same)
+    {
+        auto snap = std::make_shared<NodeSnapshot>();
+        snap->version = m_nodeSnapshot->version + 1;
+        snap->nodes = std::move(nodes);
+        m_nodeSnapshot = std::move(snap);
+    }
+    return m_nodeSnapshot;
+}
+
+int FarmSim::run()
+{
+    // MonitorLog echoes every line to stdout — silence it while the sim runs
+    std::ostringstream sink;
+    auto* coutBuf = std::cout.rdbuf(sink.rdbuf());
+
+    buildFarm();
+
+    // The latency wrapper charges the virtual clock's tick instead of sleeping
+    std::shared_ptr<FarmStorage> storage;
+    if (m_opt.diskFarm)
+        storage = std::make_shared<LocalStorage>();
+    else
+        storage = std::make_shared<MemoryStorage>();
+    if (m_opt.ioMs > 0.0 || m_opt.ioJitterMs > 0.0)
+    {
+        m_latency = std::make_shared<LatencyStorage>(storage,
+            LatencyStorage::Profile{m_opt.ioMs, m_opt.ioMs, m_opt.ioMs, m_opt.ioJitterMs});
+        m_latency->setDelayFn([this](double ms) { m_tickIoMs += ms; });
+        storage = m_latency;
+    }
+    FarmStorage::install(storage);
+
+    m_farmPath = fs::temp_directory_path() / ("sr_farmsim_" + std::to_string(m_opt.seed));
+    storage->removeAll(m_farmPath);
+    storage->createDirectories(m_farmPath / "jobs");
+    for (const auto& job : m_jobs)
+        storage->createDirectories(m_farmPath / "jobs" / job.info.manifest.job_id);
+
+    m_dispatch.setThreaded(false);
+    m_dispatch.setClock([this]() { return m_now; });
+    m_dispatch.setPrefetchDepth(m_opt.prefetch);
+    m_dispatch.setSchedulingPolicy(m_opt.policy);
+    m_dispatch.setJobAffinity(m_opt.affinity);
+    PreemptionPolicy preemption;
+    preemption.wait_s = m_opt.preemptSec;
+    m_dispatch.setPreemption(preemption);
+    if (m_opt.speedModel)
+        m_dispatch.setRenderEstimates([this]() { return m_renderMetrics.estimates(); });
+    m_dispatch.setCommandSender(
+        [this](const std::string& target, const std::string& type, const std::string& jobId,
+               const std::string&, int frameStart, int frameEnd, const std::string&)
+        {
+            onCommand(target, type, jobId, frameStart, frameEnd);
+        });
+    m_dispatch.start(m_farmPath, "sim-coordinator", "linux", timingForPreset(m_opt.preset), {},
+        [this]() { return nodeSnapshot(); },
+        [this]() { return m_snapshot; });
+
+    auto wallStart = std::chrono::steady_clock::now();
+    size_t jobsDone = 0;
+    int idleTicks = 0;
+    m_now = 0;
+
+    while (jobsDone < m_jobs.size() && m_now < m_opt.maxSimMs)
+    {
+        for (auto& job : m_jobs)
+        {
+            if (!job.arrived && job.arriveMs <= m_now)
+            {
+                job.arrived = true;
+                m_jobsChanged = true;
+            }
+        }
+        if (m_jobsChanged)
+            publishJobs();
+
+        for (const auto& action : m_reports)
+            m_dispatch.processAction(action);
+        m_reports.clear();
+
+        m_tickIoMs = 0.0;
+        auto t0 = std::chrono::steady_clock::now();
+        m_dispatch.tick();
+        auto t1 = std::chrono::steady_clock::now();
+        m_tickUs.push_back(double(std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count()));
+        if (m_latency)
+            m_ioMsPerTick.push_back(m_tickIoMs);
+
+        advanceNodes(m_now + m_opt.tickMs);
+        m_now += m_opt.tickMs;
+
+        jobsDone = (size_t)std::count_if(m_jobs.begin(), m_jobs.end(),
+            [](const SimJob& j) { return j.doneMs > 0; });
+
+        // Stop if the farm has nothing in flight for a long stretch (exhausted retries)
+        bool anyWork = std::any_of(m_nodes.begin(), m_nodes.end(),
+            [](const SimNode& n) { return !n.queue.empty(); });
+        bool allArrived = std::all_of(m_jobs.begin(), m_jobs.end(),
+            [](const SimJob& j) { return j.arrived; });
+        idleTicks = (anyWork || !allArrived || !m_reports.empty()) ? 0 : idleTicks + 1;
+        if (idleTicks > 600)
+            break;
+    }
+
+    auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - wallStart).count();
+
+    m_dispatch.stop();
+    std::cout.rdbuf(coutBuf);
+    storage->removeAll(m_farmPath);
+
+    report(wallMs);
+    return jobsDone == m_jobs.size() ? 0 : 1;
+}
+
+void FarmSim::report(int64_t wallMs) const
+{
+    int64_t busy = 0;
+    for (const auto& n : m_nodes) busy += n.busyMs;
+    double util = m_now > 0 ? double(busy) / (double(m_now) * double(m_nodes.size())) : 0.0;
+
+    std::vector<double> jobTurnaround;
+    std::vector<double> urgentTurnaround;
+    size_t done = 0;
+    for (const auto& j : m_jobs)
+    {
+        if (j.doneMs == 0) continue;
+        ++done;
+        jobTurnaround.push_back(double(j.doneMs - j.arriveMs) / 1000.0);
+        if (m_opt.urgentEvery > 0 && j.info.current_priority == 100)
+            urgentTurnaround.push_back(jobTurnaround.back());
+    }
+
+    // Chain head's arrival to last stage's completion
+    std::vector<double> chainTurnaround;
+    for (int c = 0; m_opt.stages > 1 && c + m_opt.stages <= m_opt.jobs; c += m_opt.stages)
+    {
+        const auto& head = m_jobs[m_jobIndex.at("sim-job-" + std::to_string(c))];
+        const auto& tail = m_jobs[m_jobIndex.at("sim-job-" + std::to_string(c + m_opt.stages - 1))];
+        if (tail.doneMs > 0)
+            chainTurnaround.push_back(double(tail.doneMs - head.arriveMs) / 1000.0);
+    }
+
+    std::cout << "farm:        " << m_opt.nodes << " nodes, " << m_opt.jobs << " jobs, ~"
+              << m_opt.frames << " frames/job, chunk " << m_opt.chunkSize
+              << (m_opt.targetChunkSec > 0 ? " (adaptive " + std::to_string(m_opt.targetChunkSec) + "s)" : "")
+              << ", seed " << m_opt.seed << "\n";
+    std::cout << "policy:      " << schedulingPolicyName(m_opt.policy)
+              << ", affinity " << (m_opt.affinity ? "on" : "off")
+              << ", prefetch " << m_opt.prefetch
+              << ", timing " << timingPresetName(m_opt.preset) << "\n";
+    std::cout << "completed:   " << done << "/" << m_jobs.size() << " jobs in "
+              << double(m_now) / 3600000.0 << " h simulated (" << wallMs << " ms wall)\n";
+    std::cout << "utilization: " << util * 100.0 << " %\n";
+    std::cout << "assignments: " << m_assigns << " (" << m_aborts << " aborted, "
+              << m_failures << " failed)\n";
+    std::cout << "chunk turnaround s:  mean " << mean(m_chunkTurnaroundSec)
+              << "  p50 " << percentile(m_chunkTurnaroundSec, 0.5)
+              << "  p95 " << percentile(m_chunkTurnaroundSec, 0.95) << "\n";
+    std::cout << "job turnaround s:    mean " << mean(jobTurnaround)
+              << "  p50 " << percentile(jobTurnaround, 0.5)
+              << "  p95 " << percentile(jobTurnaround, 0.95) << "\n";
+    if (m_opt.urgentEvery > 0)
+        std::cout << "urgent turnaround s: mean " << mean(urgentTurnaround)
+                  << "  p50 " << percentile(urgentTurnaround, 0.5)
+                  << "  p95 " << percentile(urgentTurnaround, 0.95)
+                  << "  (preempt " << (m_opt.preemptSec > 0 ? "after " + std::to_string(m_opt.preemptSec) + "s" : "off")
+                  << ")\n";
+    if (m_opt.stages > 1)
+        std::cout << "chain turnaround s:  mean " << mean(chainTurnaround)
+                  << "  p50 " << percentile(chainTurnaround, 0.5)
+                  << "  p95 " << percentile(chainTurnaround, 0.95)
+                  << "  (" << m_opt.stages << " stages, "
+                  << (m_opt.stageFrames ? "per frame" : "whole job") << ")\n";
+    std::cout << "coordinator us/tick: mean " << mean(m_tickUs)
+              << "  p99 " << percentile(m_tickUs, 0.99)
+              << "  max " << percentile(m_tickUs, 1.0)
+              << "  (" << m_tickUs.size() << " ticks)" << std::endl;
+    if (m_latency)
+    {
+        std::cout << "coordinator I/O ms/tick: mean " << mean(m_ioMsPerTick)
+                  << "  p99 " << percentile(m_ioMsPerTick, 0.99)
+                  << "  max " << percentile(m_ioMsPerTick, 1.0)
+                  << "  (" << m_opt.ioMs << " ms/op + " << m_opt.ioJitterMs << " jitter)\n";
+        std::cout << "storage ops:";
+        for (int op = 0; op < int(LatencyStorage::Op::Count); ++op)
+        {
+            auto o = static_cast<LatencyStorage::Op>(op);
+            std::cout << " " << LatencyStorage::opName(o) << " " << m_latency->count(o);
+        }
+        std::cout << std::endl;
+    }
+}
+
+void printUsage()
+{
+    std::cerr <<
+        "usage: sr_farmsim [options]\n"
+        "  --nodes N          worker count (50)\n"
+        "  --jobs N           job count (200)\n"
+        "  --frames N         average frames per job (50)\n"
+        "  --chunk N          chunk size (5)\n"
+        "  --target-sec N     adaptive chunk target seconds (off)\n"
+        "  --tiles N          jobs are stills split N x N, then merged (off)\n"
+        "  --stages N         jobs form chains of N stages, each depending on the last (1)\n"
+        "  --whole-job-deps   chain stages wait for the whole upstream job, not per frame\n"
+        "  --urgent N         every Nth job is priority 100, the rest 10 (off)\n"
+        "  --preempt-sec N    preempt lower priority chunks after N s waiting (off)\n"
+        "  --ms-per-frame N   render time per frame at speed 1.0 (30000)\n"
+        "  --speed-spread F   node speed spread around 1.0 (0.5)\n"
+        "  --fail-rate F      per-chunk failure probability (0.01)\n"
+        "  --arrival-sec N    spread job arrivals over N seconds (0)\n"
+        "  --tick-ms N        virtual ms per dispatch cycle (1000)\n"
+        "  --preset N         timing preset: 0 Local/NAS, 1 Cloud FS (0)\n"
+        "  --policy N         0 priority, 1 fair share, 2 fair share per submitter (0)\n"
+        "  --no-affinity      disable job affinity\n"
+        "  --no-speed-model   ignore measured node speeds when placing work\n"
+        "  --prefetch N       prefetch depth (1)\n"
+        "  --disk             keep the farm in the temp dir (default: in memory)\n"
+        "  --io-ms F          inject F ms latency per storage op, charged per tick (off)\n"
+        "  --io-jitter-ms F   extra uniform 0..F ms per op (0)\n"
+        "  --seed N           RNG seed (1)\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    SimOptions opt;
+    for (int i = 1; i < argc; ++i)
+    {
+        auto is = [&](const char* flag) { return std::strcmp(argv[i], flag) == 0 && i + 1 < argc; };
+
+        if (is("--nodes"))              opt.nodes = std::atoi(argv[++i]);
+        else if (is("--jobs"))          opt.jobs = std::atoi(argv[++i]);
+        else if (is("--frames"))        opt.frames = std::atoi(argv[++i]);
+        else if (is("--chunk"))         opt.chunkSize = (std::max)(1, std::atoi(argv[++i]));
+        else if (is("--target-sec"))    opt.targetChunkSec = std::atoi(argv[++i]);
+        else if (is("--tiles"))         opt.tiles = std::clamp(std::atoi(argv[++i]), 0, 16);
+        else if (is("--stages"))        opt.stages = (std::max)(1, std::atoi(argv[++i]));
+        else if (is("--urgent"))        opt.urgentEvery = (std::max)(0, std::atoi(argv[++i]));
+        else if (is("--preempt-sec"))   opt.preemptSec = (std::max)(0, std::atoi(argv[++i]));
+        else if (is("--ms-per-frame"))  opt.msPerFrame = std::atof(argv[++i]);
+        else if (is("--speed-spread"))  opt.speedSpread = std::clamp(std::atof(argv[++i]), 0.0, 0.95);
+        else if (is("--fail-rate"))     opt.failRate = std::clamp(std::atof(argv[++i]), 0.0, 1.0);
+        else if (is("--arrival-sec"))   opt.arrivalSec = std::atoi(argv[++i]);
+        else if (is("--tick-ms"))       opt.tickMs = (std::max)(1, std::atoi(argv[++i]));
+        else if (is("--preset"))        opt.preset = static_cast<TimingPreset>(std::clamp(std::atoi(argv[++i]), 0, 1));
+        else if (is("--policy"))        opt.policy = static_cast<SchedulingPolicy>(std::clamp(std::atoi(argv[++i]), 0, 2));
+        else if (is("--prefetch"))      opt.prefetch = (std::max)(0, std::atoi(argv[++i]));
+        else if (is("--io-ms"))         opt.ioMs = (std::max)(0.0, std::atof(argv[++i]));
+        else if (is("--io-jitter-ms"))  opt.ioJitterMs = (std::max)(0.0, std::atof(argv[++i]));
+        else if (is("--seed"))          opt.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--no-affinity") == 0)
+            opt.affinity = false;
+        else if (std::strcmp(argv[i], "--no-speed-model") == 0)
+            opt.speedModel = false;
+        else if (std::strcmp(argv[i], "--whole-job-deps") == 0)
+            opt.stageFrames = false;
+        else if (std::strcmp(argv[i], "--disk") == 0)
+            opt.diskFarm = true;
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (opt.nodes <= 0 || opt.jobs <= 0 || opt.frames <= 0)
+    {
+        printUsage();
+        return 2;
+    }
+
+    FarmSim sim(opt);
+    return sim.run();
+}